@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "libuptiny/base64.h"
+extern "C" {
+#include "libuptiny/utils.h"
+}
+
+namespace {
+
+// the lengths of key IDs and signatures, SHA-512 digests and a larger blob
+const int kLengths[] = {32, 64, 1024};
+
+std::vector<uint8_t> sample(size_t len) {
+  std::vector<uint8_t> data(len);
+  for (size_t i = 0; i < len; ++i) {
+    data[i] = static_cast<uint8_t>(i * 151 + 17);
+  }
+  return data;
+}
+
+void BM_hex2bin(benchmark::State& state) {
+  static const char digits[] = "0123456789abcdef";
+  std::vector<uint8_t> bin = sample(static_cast<size_t>(state.range(0)));
+  std::string hex;
+  for (uint8_t b : bin) {
+    hex.push_back(digits[b >> 4]);
+    hex.push_back(digits[b & 0x0f]);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(hex2bin(hex.c_str(), static_cast<int>(hex.length()), bin.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(hex.length()));
+}
+
+void BM_base64_decode(benchmark::State& state) {
+  std::vector<uint8_t> bin = sample(static_cast<size_t>(state.range(0)));
+  std::string b64(BASE64_ENCODED_BUF_SIZE(bin.size()), '\0');
+  base64_encode(bin.data(), bin.size(), &b64[0]);
+  b64.resize(b64.length() - 1);
+  bin.resize(BASE64_DECODED_BUF_SIZE(b64.length()));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(base64_decode(b64.c_str(), static_cast<uint32_t>(b64.length()), bin.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(b64.length()));
+}
+
+void lengths(benchmark::internal::Benchmark* b) {
+  for (int len : kLengths) {
+    b->Arg(len);
+  }
+}
+
+BENCHMARK(BM_hex2bin)->Apply(lengths);
+BENCHMARK(BM_base64_decode)->Apply(lengths);
+
+}  // namespace
@@ -0,0 +1,152 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <vector>
+
+#include "edsign.h"
+#include "f25519.h"
+#include "sha512.h"
+
+namespace {
+
+// a key and a signature over len bytes of message
+struct Signed {
+  explicit Signed(size_t len, uint8_t seed = 1) : message(len, static_cast<uint8_t>('a' + seed)) {
+    uint8_t secret[EDSIGN_SECRET_KEY_SIZE];
+    memset(secret, seed, sizeof(secret));
+    edsign_sec_to_pub(pub, secret);
+    edsign_sign(signature, pub, secret, message.data(), message.size());
+    edsign_unpack_pub(unpacked, pub);
+  }
+
+  std::vector<uint8_t> message;
+  uint8_t pub[EDSIGN_PUBLIC_KEY_SIZE];
+  uint8_t unpacked[EDSIGN_UNPACKED_PUB_SIZE];
+  uint8_t signature[EDSIGN_SIGNATURE_SIZE];
+};
+
+// feeds the message the way crypto_verify_feed() does
+void hash_message(struct sha512_state* s, const Signed& sig) {
+  const uint8_t* msg = sig.message.data();
+  size_t len = sig.message.size();
+  size_t first = SHA512_BLOCK_SIZE - 64;
+
+  if (len < first) {
+    edsign_verify_hash_init(s, sig.signature, sig.pub, msg, len);
+    return;
+  }
+  edsign_verify_hash_init(s, sig.signature, sig.pub, msg, first);
+  size_t pos = first;
+  for (; len - pos >= SHA512_BLOCK_SIZE; pos += SHA512_BLOCK_SIZE) {
+    edsign_verify_block(s, msg + pos);
+  }
+  edsign_verify_hash_final(s, msg + pos, len);
+}
+
+void BM_f25519_mul(benchmark::State& state) {
+  uint8_t a[F25519_SIZE];
+  uint8_t b[F25519_SIZE];
+  for (int i = 0; i < F25519_SIZE; ++i) {
+    a[i] = static_cast<uint8_t>(i * 7 + 3);
+    b[i] = static_cast<uint8_t>(i * 13 + 5);
+  }
+  a[F25519_SIZE - 1] &= 0x7f;
+  b[F25519_SIZE - 1] &= 0x7f;
+  for (auto _ : state) {
+    f25519_mul(a, a, b);
+    benchmark::DoNotOptimize(a);
+  }
+}
+BENCHMARK(BM_f25519_mul);
+
+void BM_sha512_block(benchmark::State& state) {
+  struct sha512_state s;
+  uint8_t block[SHA512_BLOCK_SIZE];
+  memset(block, 'x', sizeof(block));
+  sha512_init(&s);
+  for (auto _ : state) {
+    sha512_block(&s, block);
+    benchmark::DoNotOptimize(s);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * SHA512_BLOCK_SIZE);
+}
+BENCHMARK(BM_sha512_block);
+
+// the same block into several states, as for the signatures over one message, against one sha512_block() each
+void BM_sha512_block_multi(benchmark::State& state) {
+  auto num = static_cast<unsigned int>(state.range(0));
+  std::vector<struct sha512_state> states(num);
+  std::vector<struct sha512_state*> ptrs(num);
+  uint8_t block[SHA512_BLOCK_SIZE];
+  memset(block, 'x', sizeof(block));
+  for (unsigned int i = 0; i < num; ++i) {
+    sha512_init(&states[i]);
+    ptrs[i] = &states[i];
+  }
+  for (auto _ : state) {
+    if (state.range(1) != 0) {
+      sha512_block_multi(ptrs.data(), num, block);
+    } else {
+      for (unsigned int i = 0; i < num; ++i) {
+        sha512_block(ptrs[i], block);
+      }
+    }
+    benchmark::DoNotOptimize(states.data());
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * SHA512_BLOCK_SIZE);
+}
+BENCHMARK(BM_sha512_block_multi)->ArgNames({"states", "multi"})->ArgsProduct({{1, 2, 3, 4, 8}, {0, 1}});
+
+// init/block/final as one signature check over a message of the given length
+void BM_edsign_verify(benchmark::State& state) {
+  Signed sig(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    struct sha512_state s;
+    hash_message(&s, sig);
+    if (edsign_verify_hashed(&s, sig.signature, sig.pub, nullptr) == 0) {
+      state.SkipWithError("signature rejected");
+      break;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_edsign_verify)->Arg(32)->Arg(1024)->Arg(64 * 1024);
+
+// the curve arithmetic alone, with the key unpacked once (CRYPTO_KEY_CACHE) or on every check
+void BM_edsign_verify_hashed(benchmark::State& state) {
+  Signed sig(32);
+  struct sha512_state s;
+  const uint8_t* unpacked = (state.range(0) != 0) ? sig.unpacked : nullptr;
+  hash_message(&s, sig);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(edsign_verify_hashed(&s, sig.signature, sig.pub, unpacked));
+  }
+}
+BENCHMARK(BM_edsign_verify_hashed)->ArgName("unpacked")->Arg(0)->Arg(1);
+
+#if ED25519_BATCH_MAX > 0
+// several hashed signatures in one check, per signature
+void BM_edsign_verify_batch(benchmark::State& state) {
+  auto num = static_cast<unsigned int>(state.range(0));
+  std::vector<Signed> sigs;
+  std::vector<struct sha512_state> states(num);
+  std::vector<struct edsign_batch_item> items(num);
+  for (unsigned int i = 0; i < num; ++i) {
+    sigs.emplace_back(32, static_cast<uint8_t>(i + 1));
+  }
+  for (unsigned int i = 0; i < num; ++i) {
+    items[i].s = &states[i];
+    items[i].signature = sigs[i].signature;
+    items[i].pub = sigs[i].pub;
+    items[i].unpacked = sigs[i].unpacked;
+    hash_message(&states[i], sigs[i]);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(edsign_verify_batch(items.data(), num));
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * num);
+}
+BENCHMARK(BM_edsign_verify_batch)->DenseRange(1, ED25519_BATCH_MAX);
+#endif
+
+}  // namespace
@@ -0,0 +1,47 @@
+// Writes synthetic signed targets metadata and its keys for verify_targets:
+//
+//   uptiny_gen_targets <ecus> <signatures> <signed.json> <keyfile>
+//
+// e.g. uptiny_gen_targets 1000 2 signed.json keys && verify_targets signed.json keys 2 0 ecu_00999 synthetic-hw
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include "targets_generator.h"
+
+int main(int argc, char** argv) {
+  if (argc != 5) {
+    fprintf(stderr, "Usage: %s <ecus> <signatures> <signed.json> <keyfile>\n", argv[0]);
+    return 2;
+  }
+  long num_ecus = strtol(argv[1], nullptr, 10);
+  long num_signatures = strtol(argv[2], nullptr, 10);
+  if (num_ecus < 1 || num_ecus > SYNTHETIC_MAX_ECUS || num_signatures < 1 ||
+      num_signatures > SYNTHETIC_MAX_SIGNATURES) {
+    fprintf(stderr, "1 to %d ECUs and 1 to %d signatures\n", SYNTHETIC_MAX_ECUS, SYNTHETIC_MAX_SIGNATURES);
+    return 2;
+  }
+
+  SyntheticTargets targets =
+      generate_targets(static_cast<unsigned int>(num_ecus), static_cast<unsigned int>(num_signatures));
+  std::ofstream metadata(argv[3]);
+  metadata << targets.metadata << "\n";
+  std::ofstream keyfile(argv[4]);
+  for (const SyntheticPub& pub : targets.keys) {
+    char hex[2 * EDSIGN_PUBLIC_KEY_SIZE + 1];
+    for (size_t i = 0; i < pub.size(); ++i) {
+      snprintf(hex + 2 * i, 3, "%02x", pub[i]);
+    }
+    keyfile << hex << ":" << hex << "\n";
+  }
+  metadata.close();
+  keyfile.close();
+  if (!metadata || !keyfile) {
+    perror("uptiny_gen_targets");
+    return 2;
+  }
+  printf("%zu bytes, the target of the last ECU is %s\n", targets.metadata.length(),
+         synthetic_ecuid(static_cast<unsigned int>(num_ecus - 1)).c_str());
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libuptiny/common_data_api.h"
+#include "libuptiny/crypto_common.h"
+#include "libuptiny/state_api.h"
+#include "libuptiny/targets.h"
+#include "targets_generator.h"
+
+namespace {
+
+// Synthetic metadata with the keys it is signed with, the target looked for is the one of the last ECU
+struct Prepared {
+  SyntheticTargets targets;
+  crypto_key_t keys[SYNTHETIC_MAX_SIGNATURES];
+  uptane_root_t root;
+  std::string ecuid;
+};
+
+Prepared* current;
+uptane_targets_t installed;
+
+const Prepared& prepare(unsigned int num_ecus, unsigned int num_signatures) {
+  static std::map<std::pair<unsigned int, unsigned int>, std::unique_ptr<Prepared>> cache;
+  std::unique_ptr<Prepared>& prepared = cache[std::make_pair(num_ecus, num_signatures)];
+
+  if (!prepared) {
+    prepared.reset(new Prepared);
+    prepared->targets = generate_targets(num_ecus, num_signatures);
+    memset(&prepared->root, 0, sizeof(prepared->root));
+    for (unsigned int i = 0; i < num_signatures; ++i) {
+      crypto_key_t* key = &prepared->keys[i];
+      key->key_type = CRYPTO_ALG_ED25519;
+      memcpy(key->keyid, prepared->targets.keys[i].data(), CRYPTO_KEYID_LEN);
+      memcpy(key->keyval, prepared->targets.keys[i].data(), CRYPTO_KEYVAL_LEN);
+      crypto_key_prepare(key);
+      prepared->root.targets_keys[i] = key;
+      key_index_insert(prepared->root.targets_keys, static_cast<int>(i));
+    }
+    prepared->root.targets_keys_num = static_cast<int>(num_signatures);
+    prepared->root.targets_threshold = static_cast<int>(num_signatures);
+    prepared->ecuid = synthetic_ecuid(num_ecus - 1);
+  }
+  current = prepared.get();
+  return *prepared;
+}
+
+// The "signatures" array is parsed as a whole along with the start of the signed part, which takes some ten tokens a
+// signature. The 50 tokens of libuptiny-demo are too few for more than two
+#define BENCH_TOKENS (10 * SYNTHETIC_MAX_SIGNATURES + 24)
+
+// Verification contexts for every signature, on an ECU crypto_ctx_pool has fewer
+class VerifyCtxs {
+ public:
+  VerifyCtxs() {
+    size_t stride = (crypto_verify_ctx_size() + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+    storage_.resize(SYNTHETIC_MAX_SIGNATURES * stride);
+    for (unsigned int i = 0; i < SYNTHETIC_MAX_SIGNATURES; ++i) {
+      ctxs_[i] = reinterpret_cast<crypto_verify_ctx_t*>(&storage_[i * stride]);
+      crypto_verify_set_block(ctxs_[i], block_);
+    }
+  }
+  crypto_verify_ctx_t* const* get() const { return ctxs_; }
+
+ private:
+  std::vector<std::max_align_t> storage_;
+  crypto_verify_ctx_t* ctxs_[SYNTHETIC_MAX_SIGNATURES];
+  uint8_t block_[CRYPTO_VERIFY_BLOCK_LEN];  // shared like that of crypto_ctx_pool
+};
+
+// Feeds the metadata in chunks like verify_targets
+uint16_t verify(const std::string& metadata, size_t chunk_size, bool trust_signatures) {
+  static uptane_targets_ctx_t ctx;
+  static jsmntok_t tokens[BENCH_TOKENS];
+  static crypto_key_and_signature_t signatures[SYNTHETIC_MAX_SIGNATURES];
+  static VerifyCtxs verify_ctxs;
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+  size_t offset = 0;
+  size_t avail = 0;
+
+  uptane_targets_ctx_setup(&ctx, tokens, BENCH_TOKENS, signatures, SYNTHETIC_MAX_SIGNATURES,
+                           verify_ctxs.get(), SYNTHETIC_MAX_SIGNATURES, &hash_context, NULL);
+  uptane_targets_ctx_init(&ctx);
+  if (trust_signatures) {
+    uptane_targets_ctx_trust_signatures(&ctx);
+  }
+  while (result == RESULT_IN_PROGRESS && (avail < metadata.length() || offset < avail)) {
+    avail = std::min(avail + chunk_size, metadata.length());
+    int consumed = uptane_targets_ctx_feed(&ctx, metadata.data() + offset, static_cast<jsmnint_t>(avail - offset),
+                                           &targets, &result);
+    if (consumed < 0 || (avail == metadata.length() && consumed == 0)) {
+      break;
+    }
+    offset += static_cast<size_t>(consumed);
+  }
+  while (uptane_targets_ctx_busy(&ctx)) {
+  }
+  return result;
+}
+
+// arguments: ECUs, signatures, chunk size
+void targets_feed(benchmark::State& state, bool trust_signatures) {
+  const Prepared& prepared =
+      prepare(static_cast<unsigned int>(state.range(0)), static_cast<unsigned int>(state.range(1)));
+  auto chunk_size = static_cast<size_t>(state.range(2));
+
+  for (auto _ : state) {
+    uint16_t result = verify(prepared.targets.metadata, chunk_size, trust_signatures);
+    if (result != RESULT_END_FOUND) {
+      state.SkipWithError(("result " + std::to_string(result)).c_str());
+      break;
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          static_cast<int64_t>(prepared.targets.metadata.length()));
+  state.counters["bytes"] = static_cast<double>(prepared.targets.metadata.length());
+}
+
+// the whole verification of the director targets, as on an ECU
+void BM_targets_feed(benchmark::State& state) { targets_feed(state, false); }
+
+// without the signature checks, the cost of the parser alone
+void BM_targets_parse(benchmark::State& state) { targets_feed(state, true); }
+
+void targets_args(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"ecus", "sigs", "chunk"});
+  b->ArgsProduct({{1, 10, 100, 1000, SYNTHETIC_MAX_ECUS}, {1, 2, 4, SYNTHETIC_MAX_SIGNATURES}, {64, 512, 4096}});
+  b->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_targets_feed)->Apply(targets_args);
+BENCHMARK(BM_targets_parse)->Apply(targets_args);
+
+}  // namespace
+
+extern "C" {
+uptane_root_t* state_get_root(void) { return &current->root; }
+uptane_targets_t* state_get_targets(void) { return &installed; }
+const char* state_get_ecuid(void) { return current->ecuid.c_str(); }
+size_t state_get_ecuid_len(void) { return current->ecuid.length(); }
+const char* state_get_hwid(void) { return SYNTHETIC_HWID; }
+size_t state_get_hwid_len(void) { return strlen(SYNTHETIC_HWID); }
+crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA512; }
+void state_set_attack(uptane_attack_t attack) { (void)attack; }
+}
@@ -0,0 +1,87 @@
+#include "targets_generator.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "libuptiny/base64.h"
+
+namespace {
+
+void append_hex(std::string* out, const uint8_t* data, size_t len) {
+  static const char digits[] = "0123456789abcdef";
+  for (size_t i = 0; i < len; ++i) {
+    out->push_back(digits[data[i] >> 4]);
+    out->push_back(digits[data[i] & 0x0f]);
+  }
+}
+
+// hex digits that look like a digest, the same for the same seed
+void append_fake_digest(std::string* out, uint32_t seed, size_t len) {
+  std::vector<uint8_t> digest(len);
+  for (size_t i = 0; i < len; ++i) {
+    seed = seed * 1664525U + 1013904223U;
+    digest[i] = static_cast<uint8_t>(seed >> 24);
+  }
+  append_hex(out, digest.data(), len);
+}
+
+void append_target(std::string* out, unsigned int ecu) {
+  char name[32];
+  snprintf(name, sizeof(name), "firmware_%05u.bin", ecu);
+  *out += "\"";
+  *out += name;
+  *out += "\":{\"custom\":{\"ecuIdentifiers\":{\"" + synthetic_ecuid(ecu) + "\":{\"hardwareId\":\"" SYNTHETIC_HWID
+          "\"}}},\"hashes\":{\"sha256\":\"";
+  append_fake_digest(out, 2 * ecu, 32);
+  *out += "\",\"sha512\":\"";
+  append_fake_digest(out, 2 * ecu + 1, 64);
+  *out += "\"},\"length\":" + std::to_string(1024 + ecu) + "}";
+}
+
+}  // namespace
+
+std::string synthetic_ecuid(unsigned int ecu) {
+  char ecuid[16];
+  snprintf(ecuid, sizeof(ecuid), "ecu_%05u", ecu);
+  return ecuid;
+}
+
+SyntheticTargets generate_targets(unsigned int num_ecus, unsigned int num_signatures) {
+  SyntheticTargets res;
+
+  // the zero-padded target names keep the targets sorted like canonical JSON needs
+  std::string signed_part = "{\"_type\":\"Targets\",\"expires\":\"3021-07-13T01:02:03Z\",\"targets\":{";
+  for (unsigned int ecu = 0; ecu < num_ecus; ++ecu) {
+    if (ecu > 0) {
+      signed_part += ",";
+    }
+    append_target(&signed_part, ecu);
+  }
+  signed_part += "},\"version\":2}";
+
+  res.metadata = "{\"signatures\":[";
+  for (unsigned int i = 0; i < num_signatures; ++i) {
+    uint8_t secret[EDSIGN_SECRET_KEY_SIZE];
+    uint8_t signature[EDSIGN_SIGNATURE_SIZE];
+    char signature_b64[BASE64_ENCODED_BUF_SIZE(EDSIGN_SIGNATURE_SIZE)];
+    SyntheticPub pub;
+
+    memset(secret, static_cast<int>(0xa0 + i), sizeof(secret));
+    edsign_sec_to_pub(pub.data(), secret);
+    edsign_sign(signature, pub.data(), secret, reinterpret_cast<const uint8_t*>(signed_part.data()),
+                signed_part.length());
+    base64_encode(signature, sizeof(signature), signature_b64);
+    res.keys.push_back(pub);
+
+    if (i > 0) {
+      res.metadata += ",";
+    }
+    res.metadata += "{\"keyid\":\"";
+    append_hex(&res.metadata, pub.data(), pub.size());
+    res.metadata += "\",\"method\":\"ed25519\",\"sig\":\"";
+    res.metadata += signature_b64;
+    res.metadata += "\"}";
+  }
+  res.metadata += "],\"signed\":" + signed_part + "}";
+  return res;
+}
@@ -0,0 +1,31 @@
+#ifndef UPTINY_BENCHMARKS_TARGETS_GENERATOR_H
+#define UPTINY_BENCHMARKS_TARGETS_GENERATOR_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "edsign.h"
+
+#define SYNTHETIC_MAX_ECUS 5000
+#define SYNTHETIC_MAX_SIGNATURES 8
+#define SYNTHETIC_HWID "synthetic-hw"
+
+typedef std::array<uint8_t, EDSIGN_PUBLIC_KEY_SIZE> SyntheticPub;
+
+// Director targets metadata with a target for each of num_ecus ECUs, signed by num_signatures keys, in canonical JSON
+// like the one aktualizr sends. The key ID of each key is its public key.
+struct SyntheticTargets {
+  std::string metadata;
+  std::vector<SyntheticPub> keys;
+};
+
+// ID of the ECU ecu, from 0 to num_ecus - 1. All of them have the hardware ID SYNTHETIC_HWID and the same length, the
+// targets are in the order of their ECUs.
+std::string synthetic_ecuid(unsigned int ecu);
+
+// The keys are derived from their index, so the same arguments give the same metadata
+SyntheticTargets generate_targets(unsigned int num_ecus, unsigned int num_signatures);
+
+#endif  // UPTINY_BENCHMARKS_TARGETS_GENERATOR_H
@@ -0,0 +1,356 @@
+#include "worst_case.h"
+
+#include <string.h>
+
+#include "libuptiny/base64.h"
+#include "libuptiny/common_data_api.h"
+#include "libuptiny/crypto_common.h"
+#include "libuptiny/pool.h"
+#include "libuptiny/root.h"
+#include "libuptiny/targets.h"
+
+// public keys of the secret keys filled with the bytes 0xb0 to 0xbf, the key IDs are the same bytes
+static const uint8_t worst_case_pubs[WORST_CASE_KEYS][CRYPTO_KEYVAL_LEN] = {
+    {0x70, 0x5f, 0xba, 0xc0, 0x1f, 0x55, 0x19, 0x89, 0x9f, 0x43, 0x7b, 0xc4, 0x2e, 0x40, 0x25, 0x5a,
+     0xe9, 0xab, 0x54, 0xbf, 0xf0, 0x0d, 0xe3, 0x43, 0x3a, 0xf7, 0xd6, 0x87, 0xd9, 0xe7, 0x1a, 0xd5},
+    {0x47, 0x21, 0xb5, 0xb6, 0x32, 0x27, 0x2e, 0x65, 0xa6, 0x8d, 0xda, 0x7a, 0xc2, 0x5b, 0x41, 0x85,
+     0xf8, 0xb0, 0x19, 0x16, 0xdb, 0x18, 0x5c, 0x14, 0x28, 0x7d, 0xb9, 0x2e, 0x2b, 0x77, 0x0f, 0xae},
+    {0x55, 0x15, 0x4f, 0x42, 0x06, 0x5e, 0xa5, 0xa1, 0xbe, 0xa0, 0x54, 0x63, 0x82, 0x6b, 0xe2, 0x68,
+     0x4e, 0xb9, 0x2d, 0xf9, 0x2c, 0x10, 0x00, 0x27, 0xaa, 0xba, 0xae, 0x57, 0xca, 0x55, 0x42, 0x07},
+    {0x59, 0x12, 0xda, 0xc0, 0x20, 0xdc, 0xda, 0xba, 0x76, 0x7c, 0xec, 0xa6, 0x42, 0x43, 0xe8, 0x45,
+     0x17, 0x62, 0x15, 0xc4, 0x85, 0xe4, 0x18, 0xe5, 0x0f, 0x80, 0x20, 0x5d, 0x81, 0x21, 0x8a, 0x91},
+    {0x52, 0xbc, 0xd4, 0xc6, 0x8a, 0x8a, 0x09, 0xd9, 0x8c, 0xd9, 0xd1, 0x8d, 0x8a, 0x6f, 0xa3, 0xe8,
+     0xe9, 0x35, 0x59, 0x54, 0xec, 0xb0, 0x1e, 0x2a, 0xdf, 0xbf, 0xba, 0x5c, 0xef, 0xae, 0x4e, 0x79},
+    {0x91, 0xea, 0x2d, 0xb8, 0x26, 0x00, 0x39, 0x04, 0x9b, 0xd3, 0xb1, 0x6d, 0xb0, 0xf4, 0x27, 0x55,
+     0x86, 0x1e, 0x7d, 0x23, 0x8f, 0x4c, 0x78, 0xd0, 0x64, 0xd9, 0xa2, 0x20, 0x1a, 0x2e, 0x13, 0x50},
+    {0x80, 0x54, 0x40, 0xee, 0x48, 0x05, 0x1f, 0xc8, 0x2e, 0xa6, 0x4d, 0x90, 0x5a, 0xca, 0xbf, 0xf0,
+     0xd2, 0x17, 0x80, 0xf7, 0xfc, 0xab, 0xa6, 0x90, 0x0e, 0x0e, 0x41, 0x38, 0x7b, 0x1d, 0x4a, 0x57},
+    {0x7b, 0x24, 0x2f, 0x97, 0x78, 0xbb, 0xf9, 0xd1, 0xba, 0xa3, 0x8a, 0x80, 0x26, 0x26, 0x8b, 0xe5,
+     0x56, 0x6d, 0xff, 0x34, 0x1e, 0x59, 0xbb, 0x37, 0x98, 0xdb, 0x47, 0x1c, 0x4c, 0xb2, 0x82, 0xfa},
+    {0x46, 0xfd, 0x48, 0x5b, 0x64, 0x6d, 0x60, 0x6a, 0x61, 0x10, 0x23, 0x53, 0x1e, 0x28, 0x10, 0xdc,
+     0xe1, 0x90, 0x77, 0x82, 0x94, 0xbf, 0xfc, 0xf2, 0x1b, 0x44, 0x6e, 0xc7, 0xbb, 0x04, 0x2b, 0x01},
+    {0x25, 0x91, 0x45, 0xad, 0x26, 0x55, 0x21, 0x9b, 0x76, 0x83, 0x76, 0x76, 0xba, 0x31, 0xb9, 0x77,
+     0x90, 0x35, 0xff, 0xaa, 0x88, 0xc4, 0x57, 0xa5, 0x95, 0xd2, 0x2e, 0x4a, 0x37, 0x45, 0x27, 0xc2},
+    {0xca, 0x7d, 0x75, 0xb4, 0xea, 0x1d, 0x5a, 0x86, 0x1a, 0xa5, 0x83, 0x84, 0x06, 0x78, 0x2d, 0xfc,
+     0x62, 0xcd, 0xee, 0x7b, 0x05, 0x9a, 0x33, 0x4f, 0x0d, 0xa1, 0x53, 0xd5, 0x93, 0x86, 0xa0, 0x9a},
+    {0x7d, 0x59, 0xc5, 0x62, 0x3d, 0xd4, 0x0a, 0x74, 0xaa, 0x4d, 0x5a, 0x32, 0xac, 0x64, 0x5d, 0x3b,
+     0x3f, 0x95, 0xda, 0xea, 0xe4, 0xc2, 0x2b, 0xe2, 0x54, 0x76, 0xdd, 0x6a, 0x48, 0x6f, 0x73, 0x82},
+    {0x02, 0x0d, 0xac, 0xf8, 0x4f, 0x44, 0x70, 0xae, 0xfa, 0x78, 0x55, 0x51, 0xda, 0x56, 0x7c, 0x1e,
+     0x50, 0xe7, 0xb4, 0x43, 0x32, 0xc3, 0xa2, 0xf7, 0x0b, 0xe1, 0x0d, 0x2c, 0xd7, 0x8c, 0xac, 0x8e},
+    {0x62, 0x3e, 0x77, 0x0b, 0x17, 0x19, 0x76, 0x0c, 0xff, 0xd2, 0xaf, 0xf3, 0x95, 0x5e, 0xe5, 0x28,
+     0x43, 0xc9, 0x72, 0x5d, 0x0e, 0x99, 0x18, 0x26, 0xd5, 0x0b, 0x8a, 0x50, 0x12, 0x36, 0x8e, 0x70},
+    {0x95, 0x3a, 0x13, 0xf9, 0xce, 0x9e, 0xa6, 0x2b, 0x68, 0xcf, 0x46, 0x76, 0xde, 0x78, 0x51, 0xd4,
+     0x9c, 0xe1, 0xcb, 0x55, 0x64, 0x2d, 0x4f, 0x42, 0x5e, 0xb2, 0x71, 0xd4, 0x71, 0xe3, 0xb0, 0x34},
+    {0x52, 0xa5, 0x39, 0x49, 0x4e, 0x3e, 0xad, 0x2f, 0xb4, 0xa9, 0x54, 0xf4, 0x78, 0xbe, 0x0b, 0x55,
+     0x18, 0x09, 0x7a, 0x3b, 0x77, 0xe9, 0x38, 0x3c, 0x13, 0x2d, 0x8f, 0xae, 0x6c, 0x27, 0x2c, 0x96},
+};
+
+static crypto_key_t keys[WORST_CASE_KEYS];
+static uptane_root_t root;
+static bool root_ready;
+
+static inline unsigned int min_uint(unsigned int a, unsigned int b) { return (a < b) ? a : b; }
+
+static inline bool is_root_case(worst_case_t c) { return c <= WORST_ROOT_NESTED; }
+
+// keys of the current root and, for a root case, of the new one
+static inline unsigned int num_keys(void) { return min_uint(ROOT_MAX_KEYS, WORST_CASE_KEYS); }
+
+static unsigned int num_signatures(worst_case_t c) {
+  switch (c) {
+    case WORST_ROOT_SIGNATURES:
+      // by keys in both roots, so that they are checked at once on the first pass. A root has up to
+      // ROOT_MAX_KEYS - 1 keys, from the key pool
+      return min_uint(min_uint(signature_pool_size, crypto_ctx_pool_size),
+                      min_uint(num_keys(), min_uint(ROOT_MAX_KEYS - 1, UPTINY_KEY_POOL_SIZE)));
+    case WORST_TARGETS_SIGNATURES:
+      return min_uint(min_uint(signature_pool_size, crypto_ctx_pool_size), num_keys());
+    default:
+      return 1;
+  }
+}
+
+static unsigned int num_new_keys(worst_case_t c) {
+  if (c == WORST_ROOT_KEYS) {
+    return min_uint(num_keys(), min_uint(ROOT_MAX_KEYS - 1, UPTINY_KEY_POOL_SIZE));
+  }
+  return num_signatures(c);
+}
+
+const char *worst_case_name(worst_case_t c) {
+  static const char *const names[WORST_CASES] = {
+      "root_signatures", "root_keys", "root_nested", "targets_signatures", "targets_nested", "targets_decoys",
+  };
+  return (c < WORST_CASES) ? names[c] : "unknown";
+}
+
+uptane_root_t *worst_case_root(void) {
+  if (!root_ready) {
+    memset(&root, 0, sizeof(root));
+    root.version = 1;
+    for (unsigned int i = 0; i < num_keys(); ++i) {
+      keys[i].key_type = CRYPTO_ALG_ED25519;
+      memcpy(keys[i].keyid, worst_case_pubs[i], CRYPTO_KEYID_LEN);
+      memcpy(keys[i].keyval, worst_case_pubs[i], CRYPTO_KEYVAL_LEN);
+      crypto_key_prepare(&keys[i]);
+      root.root_keys[i] = &keys[i];
+      key_index_insert(root.root_keys, (int)i);
+      root.targets_keys[i] = &keys[i];
+      key_index_insert(root.targets_keys, (int)i);
+    }
+    root.root_keys_num = (int32_t)num_keys();
+    root.targets_keys_num = (int32_t)num_keys();
+    root_ready = true;
+  }
+  return &root;
+}
+
+// The message is written in full every time, only the bytes in [from, from + size) are kept
+typedef struct {
+  char *buf;
+  size_t from;
+  size_t size;
+  size_t pos;
+} writer_t;
+
+static void put(writer_t *w, const char *data, size_t len) {
+  if (w->pos < w->from + w->size && w->pos + len > w->from) {
+    size_t begin = (w->pos > w->from) ? w->pos : w->from;
+    size_t end = (w->pos + len < w->from + w->size) ? w->pos + len : w->from + w->size;
+    memcpy(w->buf + (begin - w->from), data + (begin - w->pos), end - begin);
+  }
+  w->pos += len;
+}
+
+static void put_str(writer_t *w, const char *s) { put(w, s, strlen(s)); }
+
+static void put_repeat(writer_t *w, char c, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    put(w, &c, 1);
+  }
+}
+
+static void put_uint(writer_t *w, unsigned int value) {
+  char digits[10];
+  int n = 0;
+
+  do {
+    digits[sizeof(digits) - 1 - n++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value > 0);
+  put(w, digits + sizeof(digits) - n, (size_t)n);
+}
+
+static void put_hex(writer_t *w, const uint8_t *data, size_t len) {
+  static const char hex[] = "0123456789abcdef";
+  for (size_t i = 0; i < len; ++i) {
+    put(w, &hex[data[i] >> 4], 1);
+    put(w, &hex[data[i] & 0x0f], 1);
+  }
+}
+
+static void put_keyid(writer_t *w, unsigned int key) {
+  put_str(w, "\"");
+  put_hex(w, worst_case_pubs[key], CRYPTO_KEYID_LEN);
+  put_str(w, "\"");
+}
+
+// a signature by key that doesn't verify. S is kept below the group order, so the check can't stop early
+static void put_signatures(writer_t *w, worst_case_t c) {
+  uint8_t sig[64];
+  char sig_base64[BASE64_ENCODED_BUF_SIZE(64)];
+
+  put_str(w, "\"signatures\":[");
+  for (unsigned int i = 0; i < num_signatures(c); ++i) {
+    for (unsigned int j = 0; j < sizeof(sig); ++j) {
+      sig[j] = (uint8_t)(0x5a ^ (i * 29 + j * 7));
+    }
+    sig[sizeof(sig) - 1] &= 0x0f;
+    base64_encode(sig, sizeof(sig), sig_base64);
+    put_str(w, (i > 0) ? ",{\"keyid\":" : "{\"keyid\":");
+    put_keyid(w, i);
+    put_str(w, ",\"method\":\"ed25519\",\"sig\":\"");
+    put_str(w, sig_base64);
+    put_str(w, "\"}");
+  }
+  put_str(w, "],");
+}
+
+static void put_nested(writer_t *w, const char *name) {
+  put_str(w, name);
+  put_repeat(w, '[', WORST_CASE_DEPTH);
+  put_repeat(w, ']', WORST_CASE_DEPTH);
+  put_str(w, ",");
+}
+
+static void put_role(writer_t *w, const char *name, unsigned int keys_num) {
+  put_str(w, name);
+  put_str(w, "{\"keyids\":[");
+  for (unsigned int i = 0; i < keys_num; ++i) {
+    if (i > 0) {
+      put_str(w, ",");
+    }
+    put_keyid(w, i);
+  }
+  put_str(w, "],\"threshold\":");
+  put_uint(w, keys_num);
+  put_str(w, "}");
+}
+
+static void put_root(writer_t *w, worst_case_t c) {
+  unsigned int keys_num = num_new_keys(c);
+
+  put_str(w, "{");
+  put_signatures(w, c);
+  put_str(w, "\"signed\":{\"_type\":\"Root\",");
+  if (c == WORST_ROOT_NESTED) {
+    put_nested(w, "\"custom\":");
+  }
+  put_str(w, "\"expires\":\"3021-07-13T01:02:03Z\",\"keys\":{");
+  for (unsigned int i = 0; i < keys_num; ++i) {
+    if (i > 0) {
+      put_str(w, ",");
+    }
+    put_keyid(w, i);
+    put_str(w, ":{\"keytype\":\"ED25519\",\"keyval\":{\"public\":\"");
+    put_hex(w, worst_case_pubs[i], CRYPTO_KEYVAL_LEN);
+    put_str(w, "\"}}");
+  }
+  put_str(w, "},\"roles\":{");
+  put_role(w, "\"root\":", keys_num);
+  put_role(w, ",\"snapshot\":", keys_num);
+  put_role(w, ",\"targets\":", keys_num);
+  put_role(w, ",\"timestamp\":", keys_num);
+  put_str(w, "},\"version\":2}}");
+}
+
+// a target for another ECU whose ID begins with the one of this ECU
+static void put_decoy(writer_t *w, unsigned int decoy) {
+  char name[] = "\"decoy_00000\":{\"custom\":{\"ecuIdentifiers\":{\"";
+
+  for (int i = 11; i > 6; --i) {
+    name[i] = (char)('0' + decoy % 10);
+    decoy /= 10;
+  }
+  put_str(w, name);
+  put(w, state_get_ecuid(), state_get_ecuid_len());
+  put_str(w, ".decoy\":{\"hardwareId\":\"");
+  put(w, state_get_hwid(), state_get_hwid_len());
+  put_str(w, "\"}},\"primitives\":[0");
+  for (unsigned int i = 1; i < token_pool_size / 4; ++i) {
+    put_str(w, ",0");
+  }
+  put_str(w, "]},\"length\":0}");
+}
+
+static void put_targets(writer_t *w, worst_case_t c) {
+  put_str(w, "{");
+  put_signatures(w, c);
+  put_str(w, "\"signed\":{\"_type\":\"Targets\",");
+  if (c == WORST_TARGETS_NESTED) {
+    put_nested(w, "\"custom\":");
+  }
+  put_str(w, "\"expires\":\"3021-07-13T01:02:03Z\",\"targets\":{");
+  for (unsigned int i = 0; c == WORST_TARGETS_DECOYS && i < WORST_CASE_DECOYS; ++i) {
+    if (i > 0) {
+      put_str(w, ",");
+    }
+    put_decoy(w, i);
+  }
+  put_str(w, "},\"version\":2}}");
+}
+
+size_t worst_case_generate(worst_case_t c, char *buf, size_t from, size_t size) {
+  writer_t w = {buf, from, size, 0};
+
+  if (is_root_case(c)) {
+    put_root(&w, c);
+  } else {
+    put_targets(&w, c);
+  }
+  return w.pos;
+}
+
+static uptane_targets_ctx_t targets_ctx;
+
+static int feed(worst_case_t c, const char *message, jsmnint_t len, uint16_t *result) {
+  static uptane_root_t new_root;
+  static uptane_targets_t targets;
+
+  if (is_root_case(c)) {
+    return uptane_parse_root_feed(message, len, &new_root, result);
+  }
+  return uptane_targets_ctx_feed(&targets_ctx, message, len, &targets, result);
+}
+
+bool worst_case_run(worst_case_t c, char *window, size_t window_size, size_t chunk, size_t first_chunk,
+                    worst_case_clock_t clock, worst_case_run_t *run) {
+  size_t len = worst_case_generate(c, window, 0, window_size);
+  size_t window_from = 0;  // the window holds the message from here on
+  size_t offset = 0;
+  size_t avail = 0;
+  uint16_t result = RESULT_IN_PROGRESS;  // the same as ROOT_RESULT_IN_PROGRESS
+  uptane_root_t *current = worst_case_root();
+
+  memset(run, 0, sizeof(*run));
+  if (first_chunk == 0) {
+    return false;
+  }
+  // every signature is needed
+  current->root_threshold = (int32_t)num_signatures(c);
+  current->targets_threshold = (int32_t)num_signatures(c);
+  if (is_root_case(c)) {
+    free_all_crypto_keys();
+    uptane_parse_root_init();
+  } else {
+    uptane_targets_ctx_setup(&targets_ctx, token_pool, token_pool_size, signature_pool, signature_pool_size,
+                             crypto_ctx_pool, crypto_ctx_pool_size, &hash_context, current);
+    uptane_targets_ctx_init(&targets_ctx);
+  }
+
+  while (result == RESULT_IN_PROGRESS) {
+    avail = (avail == 0) ? first_chunk : avail + chunk;
+    if (avail > len) {
+      avail = len;
+    }
+    if (avail - offset > window_size) {
+      return false;
+    }
+    if (offset < window_from || avail > window_from + window_size) {
+      window_from = offset;
+      worst_case_generate(c, window, window_from, window_size);
+    }
+
+#ifdef UPTANE_POOL_STATS
+    uint32_t tokens = uptane_pool_peaks.tokens_parsed;
+#endif
+    uint32_t start = clock();
+    int consumed = feed(c, window + (offset - window_from), (jsmnint_t)(avail - offset), &result);
+    uint32_t ticks = clock() - start;
+#ifdef UPTANE_POOL_STATS
+    run->tokens += uptane_pool_peaks.tokens_parsed - tokens;
+#endif
+    run->bytes_fed += (uint32_t)(avail - offset);
+    ++run->feeds;
+    if (ticks > run->max_ticks) {
+      run->max_ticks = ticks;
+      run->max_ticks_at = (uint32_t)offset;
+    }
+
+    if (consumed < 0 || (avail == len && consumed == 0)) {
+      break;
+    }
+    offset += (size_t)consumed;
+    if (result == ROOT_RESULT_FEED_AGAIN && is_root_case(c)) {
+      // the second pass starts over
+      result = RESULT_IN_PROGRESS;
+      offset = 0;
+      avail = 0;
+    }
+  }
+
+  while (is_root_case(c) ? uptane_parse_root_busy() : uptane_targets_ctx_busy(&targets_ctx)) {
+  }
+  run->result = result;
+  return result == (is_root_case(c) ? ROOT_RESULT_SIGNATURES_FAILED : RESULT_SIGNATURES_FAILED);
+}
@@ -0,0 +1,76 @@
+#ifndef UPTINY_BENCHMARKS_WORST_CASE_H
+#define UPTINY_BENCHMARKS_WORST_CASE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libuptiny/state_api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hostile metadata that keeps uptane_parse_root_feed() and uptane_targets_ctx_feed() busy as long as the pools of
+// common_data_api.h allow, to bound the time a feed can take on an ECU. Every case is well-formed, and signed by keys
+// of the current root with signatures that don't verify: the whole message is parsed and every signature is checked
+// before the feed fails with ROOT_RESULT_SIGNATURES_FAILED or RESULT_SIGNATURES_FAILED, the most an attacker without
+// the keys gets. Shared by uptiny_worst_case on the host and kea128_bench.elf, so it is plain C and the messages are
+// made a window at a time rather than held whole.
+typedef enum {
+  WORST_ROOT_SIGNATURES,     // as many signatures as the first pass checks at once, by keys in both roots
+  WORST_ROOT_KEYS,           // ROOT_MAX_KEYS - 1 keys, the most a root may have, listed by all four roles
+  WORST_ROOT_NESTED,         // a member of "signed" root.c doesn't know, WORST_CASE_DEPTH arrays deep
+  WORST_TARGETS_SIGNATURES,  // as many signatures as the pools take
+  WORST_TARGETS_NESTED,      // the same for targets, as a "custom" of "signed"
+  WORST_TARGETS_DECOYS,      // WORST_CASE_DECOYS targets for other ECUs that mention this one, so that the pre-scan
+                             // can't skip them, each with token_pool_size / 4 primitives to tokenize
+  WORST_CASES
+} worst_case_t;
+
+#ifndef WORST_CASE_DEPTH
+#define WORST_CASE_DEPTH 2048
+#endif
+
+#ifndef WORST_CASE_DECOYS
+#define WORST_CASE_DECOYS 64
+#endif
+
+// Keys the cases are signed with, the current root has them all. ROOT_MAX_KEYS can't be used beyond these
+#define WORST_CASE_KEYS 16
+
+// Ticks of a free-running clock, e.g. core cycles. Only the difference of two readings is used
+typedef uint32_t (*worst_case_clock_t)(void);
+
+typedef struct {
+  uint16_t result;        // of the last feed
+  uint32_t feeds;         // calls of the feed, the last one included
+  uint32_t max_ticks;     // of the slowest call
+  uint32_t max_ticks_at;  // offset in the message of the part that call got
+  uint32_t bytes_fed;     // the unconsumed tails fed again included
+  uint32_t tokens;        // made by jsmn_parse() in all, only counted with UPTANE_POOL_STATS
+} worst_case_run_t;
+
+const char *worst_case_name(worst_case_t c);
+
+// The current root the cases are made for: state_get_root() has to return it while they are fed. Set up by
+// worst_case_run()
+uptane_root_t *worst_case_root(void);
+
+// Writes the bytes [from, from + size) of the message of case c, as far as there are any, to buf. Returns the length of
+// the whole message
+size_t worst_case_generate(worst_case_t c, char *buf, size_t from, size_t size);
+
+// Feeds the message of case c like verify_targets does, from a parser set up anew: the first part is first_chunk
+// bytes, each following part has chunk bytes more, after the unconsumed tail of the one before. The message is made
+// in window, window_size bytes, which has to hold the largest part fed. Only the feed calls are timed with clock.
+// Returns true if the whole message has been parsed and the signatures failed, false if the feed gave up earlier or the
+// window was too small.
+bool worst_case_run(worst_case_t c, char *window, size_t window_size, size_t chunk, size_t first_chunk,
+                    worst_case_clock_t clock, worst_case_run_t *run);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // UPTINY_BENCHMARKS_WORST_CASE_H
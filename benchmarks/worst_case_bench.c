@@ -0,0 +1,223 @@
+// Worst-case feed times of the root and targets parsers on hostile metadata (see worst_case.h):
+//
+//   uptiny_worst_case [--chunk <bytes>]... [--repeat <n>] [--baseline <file>] [--tolerance <percent>] [--tokens-only]
+//
+// Every case is fed in chunks of 64 and 1024 bytes, or of the sizes given with --chunk, and with the first chunk of
+// each size from 1 byte to a whole chunk, so that the chunk boundaries fall on every offset of the message. A line of
+// CSV per case and chunk size gives the slowest feed call in ns, where in the message it began and with which first
+// chunk, and the most tokens jsmn made and bytes were fed in one run, the unconsumed tails fed again included. Averages
+// hide what an attacker is after, so only the maxima are kept.
+//
+// Each run is repeated n times (3 by default) and its slowest call taken from the fastest repetition, which leaves out
+// the time the host was doing something else.
+//
+// With --baseline the results are compared with an earlier output: more tokens or bytes fed, or a slowest call
+// more than the tolerance (20 % by default) slower, is reported as a regression and the exit status is 1. The token
+// counts don't depend on the host, --tokens-only only compares them, e.g. for a test. Cases whose length differs from
+// the baseline are of another configuration and not compared. Exits with 2 on bad arguments or if a case didn't run
+// to its end.
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "libuptiny/state_api.h"
+#include "worst_case.h"
+
+#define MAX_CHUNK_SIZES 8
+
+static uptane_targets_t installed;
+
+uptane_root_t *state_get_root(void) { return worst_case_root(); }
+uptane_targets_t *state_get_targets(void) { return &installed; }
+const char *state_get_ecuid(void) { return "worst_case_ecu"; }
+size_t state_get_ecuid_len(void) { return strlen("worst_case_ecu"); }
+const char *state_get_hwid(void) { return "worst_case_hw"; }
+size_t state_get_hwid_len(void) { return strlen("worst_case_hw"); }
+crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA512; }
+void state_set_root(const uptane_root_t *root) { (void)root; }
+void state_set_attack(uptane_attack_t attack) { (void)attack; }
+
+static uint32_t nanoseconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+}
+
+// the worst of a case in chunks of one size
+typedef struct {
+  const char *name;
+  size_t chunk;
+  size_t len;
+  uint32_t max_ns;
+  uint32_t max_ns_at;
+  size_t max_ns_first;
+  uint32_t tokens;
+  uint32_t bytes_fed;
+} worst_t;
+
+static bool measure(worst_case_t c, size_t chunk, long repeat, char *window, size_t window_size, worst_t *worst) {
+  worst_case_run_t run;
+
+  memset(worst, 0, sizeof(*worst));
+  worst->name = worst_case_name(c);
+  worst->chunk = chunk;
+  worst->len = worst_case_generate(c, NULL, 0, 0);
+  for (size_t first = 1; first <= chunk; ++first) {
+    uint32_t fastest = UINT32_MAX;
+    uint32_t fastest_at = 0;
+
+    for (long i = 0; i < repeat; ++i) {
+      if (!worst_case_run(c, window, window_size, chunk, first, nanoseconds, &run)) {
+        fprintf(stderr, "%s: stopped with result 0x%04x after %u feeds, first chunk %zu of %zu\n", worst->name,
+                run.result, (unsigned int)run.feeds, first, chunk);
+        return false;
+      }
+      if (run.max_ticks < fastest) {
+        fastest = run.max_ticks;
+        fastest_at = run.max_ticks_at;
+      }
+    }
+    if (fastest > worst->max_ns) {
+      worst->max_ns = fastest;
+      worst->max_ns_at = fastest_at;
+      worst->max_ns_first = first;
+    }
+    if (run.tokens > worst->tokens) {
+      worst->tokens = run.tokens;
+    }
+    if (run.bytes_fed > worst->bytes_fed) {
+      worst->bytes_fed = run.bytes_fed;
+    }
+  }
+  return true;
+}
+
+static void print_worst(const worst_t *worst) {
+  printf("%s,%zu,%zu,%u,%u,%zu,%u,%.4f,%u\n", worst->name, worst->chunk, worst->len, (unsigned int)worst->max_ns,
+         (unsigned int)worst->max_ns_at, worst->max_ns_first, (unsigned int)worst->tokens,
+         (double)worst->tokens / (double)worst->len, (unsigned int)worst->bytes_fed);
+}
+
+// compares with the line of the same case and chunk size in the baseline, returns false on a regression
+static bool compare(FILE *baseline, const worst_t *worst, double tolerance, bool tokens_only) {
+  char line[256];
+  char name[64];
+  size_t chunk;
+  size_t len;
+  unsigned int max_ns;
+  unsigned int tokens;
+  unsigned int bytes_fed;
+  bool ok = true;
+
+  rewind(baseline);
+  while (fgets(line, sizeof(line), baseline) != NULL) {
+    if (sscanf(line, "%63[^,],%zu,%zu,%u,%*u,%*u,%u,%*f,%u", name, &chunk, &len, &max_ns, &tokens, &bytes_fed) != 6 ||
+        strcmp(name, worst->name) != 0 || chunk != worst->chunk || len != worst->len) {
+      continue;
+    }
+    if (worst->tokens > tokens) {
+      fprintf(stderr, "regression: %s in chunks of %zu makes %u tokens, %u before\n", name, chunk,
+              (unsigned int)worst->tokens, tokens);
+      ok = false;
+    }
+    if (worst->bytes_fed > bytes_fed) {
+      fprintf(stderr, "regression: %s in chunks of %zu is fed %u bytes, %u before\n", name, chunk,
+              (unsigned int)worst->bytes_fed, bytes_fed);
+      ok = false;
+    }
+    if (!tokens_only && worst->max_ns > max_ns * (1.0 + tolerance / 100.0)) {
+      fprintf(stderr, "regression: %s in chunks of %zu takes %u ns in one feed, %u before\n", name, chunk,
+              (unsigned int)worst->max_ns, max_ns);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+int main(int argc, char **argv) {
+  size_t chunks[MAX_CHUNK_SIZES] = {64, 1024};
+  size_t num_chunks = 0;
+  long repeat = 3;
+  const char *baseline_path = NULL;
+  double tolerance = 20.0;
+  bool tokens_only = false;
+  int arg = 1;
+
+  for (; arg < argc; ++arg) {
+    if (strcmp(argv[arg], "--tokens-only") == 0) {
+      tokens_only = true;
+    } else if (arg + 1 >= argc) {
+      break;
+    } else if (strcmp(argv[arg], "--chunk") == 0 && num_chunks < MAX_CHUNK_SIZES) {
+      chunks[num_chunks++] = strtoul(argv[++arg], NULL, 10);
+    } else if (strcmp(argv[arg], "--repeat") == 0) {
+      repeat = strtol(argv[++arg], NULL, 10);
+    } else if (strcmp(argv[arg], "--baseline") == 0) {
+      baseline_path = argv[++arg];
+    } else if (strcmp(argv[arg], "--tolerance") == 0) {
+      tolerance = strtod(argv[++arg], NULL);
+    } else {
+      break;
+    }
+  }
+  if (num_chunks == 0) {
+    num_chunks = 2;
+  }
+  bool bad_chunk = false;
+  for (size_t i = 0; i < num_chunks; ++i) {
+    bad_chunk = bad_chunk || chunks[i] == 0 || chunks[i] > 16384;
+  }
+  if (arg < argc || bad_chunk || repeat <= 0 || tolerance < 0) {
+    fprintf(stderr,
+            "Usage: %s [--chunk <bytes>]... [--repeat <n>] [--baseline <file>] [--tolerance <percent>] "
+            "[--tokens-only]\n",
+            argv[0]);
+    return 2;
+  }
+
+  FILE *baseline = NULL;
+  if (baseline_path != NULL) {
+    baseline = fopen(baseline_path, "r");
+    if (baseline == NULL) {
+      perror(baseline_path);
+      return 2;
+    }
+  }
+
+  // the window holds the longest message, so that it is made only once a run
+  size_t window_size = 0;
+  for (int c = 0; c < WORST_CASES; ++c) {
+    size_t len = worst_case_generate((worst_case_t)c, NULL, 0, 0);
+    window_size = (len > window_size) ? len : window_size;
+  }
+  char *window = malloc(window_size);
+  if (window == NULL) {
+    perror("uptiny_worst_case");
+    return 2;
+  }
+
+  bool ok = true;
+  printf("case,chunk,bytes,max_ns,max_ns_at,first_chunk,tokens,tokens_per_byte,bytes_fed\n");
+  for (int c = 0; c < WORST_CASES; ++c) {
+    for (size_t i = 0; i < num_chunks; ++i) {
+      worst_t worst;
+      if (!measure((worst_case_t)c, chunks[i], repeat, window, window_size, &worst)) {
+        free(window);
+        return 2;
+      }
+      print_worst(&worst);
+      fflush(stdout);
+      if (baseline != NULL && !compare(baseline, &worst, tolerance, tokens_only)) {
+        ok = false;
+      }
+    }
+  }
+  free(window);
+  if (baseline != NULL) {
+    fclose(baseline);
+  }
+  return ok ? 0 : 1;
+}
@@ -5,6 +5,7 @@
  */
 
 #include "ed25519.h"
+#include "scratch.h"
 
 /* Base point is (numbers wrapped):
  *
@@ -108,9 +109,9 @@ void ed25519_pack(uint8_t *c, const uint8_t *x, const uint8_t *y)
 uint8_t ed25519_try_unpack(uint8_t *x, uint8_t *y, const uint8_t *comp)
 {
 	const int parity = comp[31] >> 7;
-	static uint8_t a[F25519_SIZE];
-	static uint8_t b[F25519_SIZE];
-	static uint8_t c[F25519_SIZE];
+	ED25519_SCRATCH uint8_t a[F25519_SIZE];
+	ED25519_SCRATCH uint8_t b[F25519_SIZE];
+	ED25519_SCRATCH uint8_t c[F25519_SIZE];
 
 	/* Unpack y */
 	f25519_copy(y, comp);
@@ -176,14 +177,14 @@ void ed25519_add(struct ed25519_pt *r,
 	 * compute T3 = E H
 	 * compute Z3 = F G
 	 */
-	static uint8_t a[F25519_SIZE];
-	static uint8_t b[F25519_SIZE];
-	static uint8_t c[F25519_SIZE];
-	static uint8_t d[F25519_SIZE];
-	static uint8_t e[F25519_SIZE];
-	static uint8_t f[F25519_SIZE];
-	static uint8_t g[F25519_SIZE];
-	static uint8_t h[F25519_SIZE];
+	ED25519_SCRATCH uint8_t a[F25519_SIZE];
+	ED25519_SCRATCH uint8_t b[F25519_SIZE];
+	ED25519_SCRATCH uint8_t c[F25519_SIZE];
+	ED25519_SCRATCH uint8_t d[F25519_SIZE];
+	ED25519_SCRATCH uint8_t e[F25519_SIZE];
+	ED25519_SCRATCH uint8_t f[F25519_SIZE];
+	ED25519_SCRATCH uint8_t g[F25519_SIZE];
+	ED25519_SCRATCH uint8_t h[F25519_SIZE];
 
 	/* A = (Y1-X1)(Y2-X2) */
 	f25519_sub(c, p1->y, p1->x);
@@ -247,13 +248,13 @@ void ed25519_double(struct ed25519_pt *r, const struct ed25519_pt *p)
 	 * compute T3 = E H
 	 * compute Z3 = F G
 	 */
-	static uint8_t a[F25519_SIZE];
-	static uint8_t b[F25519_SIZE];
-	static uint8_t c[F25519_SIZE];
-	static uint8_t e[F25519_SIZE];
-	static uint8_t f[F25519_SIZE];
-	static uint8_t g[F25519_SIZE];
-	static uint8_t h[F25519_SIZE];
+	ED25519_SCRATCH uint8_t a[F25519_SIZE];
+	ED25519_SCRATCH uint8_t b[F25519_SIZE];
+	ED25519_SCRATCH uint8_t c[F25519_SIZE];
+	ED25519_SCRATCH uint8_t e[F25519_SIZE];
+	ED25519_SCRATCH uint8_t f[F25519_SIZE];
+	ED25519_SCRATCH uint8_t g[F25519_SIZE];
+	ED25519_SCRATCH uint8_t h[F25519_SIZE];
 
 	/* A = X1^2 */
 	f25519_mul__distinct(a, p->x, p->x);
@@ -298,14 +299,14 @@ void ed25519_double(struct ed25519_pt *r, const struct ed25519_pt *p)
 void ed25519_smult(struct ed25519_pt *r_out, const struct ed25519_pt *p,
 		   const uint8_t *e)
 {
-	static struct ed25519_pt r;
+	ED25519_SCRATCH struct ed25519_pt r;
 	int i;
 
 	ed25519_copy(&r, &ed25519_neutral);
 
 	for (i = 255; i >= 0; i--) {
 		const uint8_t bit = (e[i >> 3] >> (i & 7)) & 1;
-		static struct ed25519_pt s;
+		ED25519_SCRATCH struct ed25519_pt s;
 
 		ed25519_double(&r, &r);
 		ed25519_add(&s, &r, p);
@@ -318,3 +319,242 @@ void ed25519_smult(struct ed25519_pt *r_out, const struct ed25519_pt *p,
 
 	ed25519_copy(r_out, &r);
 }
+
+#if ED25519_BASE_COMB_TEETH
+#define COMB_SPACING \
+	((ED25519_EXPONENT_SIZE * 8 + ED25519_BASE_COMB_TEETH - 1) / \
+	 ED25519_BASE_COMB_TEETH)
+
+/* Entry i is the sum of 2^(j*COMB_SPACING)B over the bits j set in i,
+ * as affine x, y and t = xy.
+ */
+extern const uint8_t ed25519_base_comb[1 << ED25519_BASE_COMB_TEETH][3][F25519_SIZE];
+
+void ed25519_smult_base(struct ed25519_pt *r_out, const uint8_t *e)
+{
+	ED25519_SCRATCH struct ed25519_pt r;
+	ED25519_SCRATCH struct ed25519_pt s;
+	int i;
+
+	ed25519_copy(&r, &ed25519_neutral);
+	f25519_load(s.z, 1);
+
+	for (i = COMB_SPACING - 1; i >= 0; i--) {
+		unsigned int idx = 0;
+		unsigned int j;
+
+		for (j = 0; j < ED25519_BASE_COMB_TEETH; j++) {
+			const unsigned int bit = i + j * COMB_SPACING;
+
+			if (bit < ED25519_EXPONENT_SIZE * 8)
+				idx |= ((e[bit >> 3] >> (bit & 7)) & 1) << j;
+		}
+
+		/* Scan the whole table so that the access pattern doesn't
+		 * depend on the exponent.
+		 */
+		for (j = 0; j < (1 << ED25519_BASE_COMB_TEETH); j++) {
+			const uint8_t hit = (((j ^ idx) - 1) >> 8) & 1;
+
+			f25519_select(s.x, s.x, ed25519_base_comb[j][0], hit);
+			f25519_select(s.y, s.y, ed25519_base_comb[j][1], hit);
+			f25519_select(s.t, s.t, ed25519_base_comb[j][2], hit);
+		}
+
+		ed25519_double(&r, &r);
+		ed25519_add(&r, &r, &s);
+	}
+
+	ed25519_copy(r_out, &r);
+}
+#else
+void ed25519_smult_base(struct ed25519_pt *r, const uint8_t *e)
+{
+	ed25519_smult(r, &ed25519_base, e);
+}
+#endif
+
+/* Recode an exponent into width-w NAF: digits are zero or odd, less
+ * than 2^(w-1) in magnitude, and any nonzero digit is followed by at
+ * least w-1 zeros.
+ */
+static void wnaf(int8_t *naf, const uint8_t *e)
+{
+	uint8_t k[ED25519_EXPONENT_SIZE + 1];
+	int i;
+
+	memcpy(k, e, ED25519_EXPONENT_SIZE);
+	k[ED25519_EXPONENT_SIZE] = 0;
+
+	for (i = 0; i < ED25519_WNAF_DIGITS; i++) {
+		int d = 0;
+		int j;
+
+		if (k[0] & 1) {
+			uint16_t c;
+
+			d = k[0] & ((1 << ED25519_WNAF_WIDTH) - 1);
+			if (d >= (1 << (ED25519_WNAF_WIDTH - 1)))
+				d -= 1 << ED25519_WNAF_WIDTH;
+
+			/* k -= d */
+			if (d > 0) {
+				c = k[0] - d;
+				k[0] = c;
+				for (j = 1; (c >> 8) && j < sizeof(k); j++) {
+					c = k[j] - 1;
+					k[j] = c;
+				}
+			} else {
+				c = k[0] - d;
+				k[0] = c;
+				for (j = 1; (c >> 8) && j < sizeof(k); j++) {
+					c = k[j] + 1;
+					k[j] = c;
+				}
+			}
+		}
+
+		naf[i] = d;
+
+		for (j = 0; j + 1 < sizeof(k); j++)
+			k[j] = (k[j] >> 1) | (k[j + 1] << 7);
+		k[j] >>= 1;
+	}
+}
+
+/* Fill t with p, 3p, 5p, ... */
+static void odd_multiples(struct ed25519_pt *t, const struct ed25519_pt *p)
+{
+	ED25519_SCRATCH struct ed25519_pt p2;
+	int i;
+
+	ed25519_copy(&t[0], p);
+	ed25519_double(&p2, p);
+
+	for (i = 1; i < ED25519_WNAF_TABLE_SIZE; i++)
+		ed25519_add(&t[i], &t[i - 1], &p2);
+}
+
+static void add_digit(struct ed25519_pt *r, const struct ed25519_pt *t,
+		      int8_t d)
+{
+	ED25519_SCRATCH struct ed25519_pt n;
+
+	if (d > 0) {
+		ed25519_add(r, r, &t[d >> 1]);
+	} else if (d < 0) {
+		/* -(x, y, t, z) = (-x, y, -t, z) */
+		ed25519_copy(&n, &t[(-d) >> 1]);
+		f25519_neg(n.x, n.x);
+		f25519_neg(n.t, n.t);
+		ed25519_add(r, r, &n);
+	}
+}
+
+void ed25519_wnaf_prepare(struct ed25519_wnaf *w, const uint8_t *e,
+			  const struct ed25519_pt *p)
+{
+	wnaf(w->naf, e);
+	odd_multiples(w->t, p);
+}
+
+int ed25519_wnaf_top(const struct ed25519_wnaf *w, unsigned int n)
+{
+	unsigned int j;
+	int i;
+
+	for (i = ED25519_WNAF_DIGITS - 1; i >= 0; i--)
+		for (j = 0; j < n; j++)
+			if (w[j].naf[i])
+				return i;
+
+	return -1;
+}
+
+void ed25519_multi_smult_digit(struct ed25519_pt *r,
+			       const struct ed25519_wnaf *w, unsigned int n,
+			       int i)
+{
+	unsigned int j;
+
+	ed25519_double(r, r);
+	for (j = 0; j < n; j++)
+		add_digit(r, w[j].t, w[j].naf[i]);
+}
+
+/* r = sum(e[j]*p[j]) with the tables in w. r may be one of the points. */
+static void multi_smult_tables(struct ed25519_pt *r,
+			       const uint8_t *const *e,
+			       const struct ed25519_pt *const *p,
+			       unsigned int n, struct ed25519_wnaf *w)
+{
+	unsigned int j;
+	int i;
+
+	for (j = 0; j < n; j++)
+		ed25519_wnaf_prepare(&w[j], e[j], p[j]);
+
+	ed25519_copy(r, &ed25519_neutral);
+
+	/* Skip leading zero digits */
+	for (i = ed25519_wnaf_top(w, n); i >= 0; i--)
+		ed25519_multi_smult_digit(r, w, n, i);
+}
+
+void ed25519_multi_smult(struct ed25519_pt *r,
+			 const uint8_t *const *e,
+			 const struct ed25519_pt *const *p, unsigned int n)
+{
+	static struct ed25519_wnaf w[ED25519_MSM_MAX];
+	ED25519_SCRATCH struct ed25519_pt sum;
+	ED25519_SCRATCH struct ed25519_pt part;
+	unsigned int m;
+
+	if (n <= ED25519_MSM_MAX) {
+		multi_smult_tables(r, e, p, n, w);
+		return;
+	}
+
+	/* More points than tables: sum them a table's worth at a time.
+	 * r may be one of the points, so it is written last.
+	 */
+	ed25519_copy(&sum, &ed25519_neutral);
+	while (n > 0) {
+		m = (n > ED25519_MSM_MAX) ? ED25519_MSM_MAX : n;
+		multi_smult_tables(&part, e, p, m, w);
+		ed25519_add(&sum, &sum, &part);
+		e += m;
+		p += m;
+		n -= m;
+	}
+	ed25519_copy(r, &sum);
+}
+
+void ed25519_double_smult(struct ed25519_pt *r,
+			  const uint8_t *e1, const struct ed25519_pt *p1,
+			  const uint8_t *e2, const struct ed25519_pt *p2)
+{
+	const uint8_t *e[2];
+	const struct ed25519_pt *p[2];
+
+	e[0] = e1;
+	e[1] = e2;
+	p[0] = p1;
+	p[1] = p2;
+	ed25519_multi_smult(r, e, p, 2);
+}
+
+void ed25519_double_smult_ws(struct ed25519_wnaf *w, struct ed25519_pt *r,
+			     const uint8_t *e1, const struct ed25519_pt *p1,
+			     const uint8_t *e2, const struct ed25519_pt *p2)
+{
+	const uint8_t *e[2];
+	const struct ed25519_pt *p[2];
+
+	e[0] = e1;
+	e[1] = e2;
+	p[0] = p1;
+	p[1] = p2;
+	multi_smult_tables(r, e, p, 2, w);
+}
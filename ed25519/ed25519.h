@@ -9,6 +9,10 @@
 
 #include "f25519.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* This is not the Ed25519 signature system. Rather, we're implementing
  * basic operations on the twisted Edwards curve over (Z mod 2^255-19):
  *
@@ -79,4 +83,85 @@ void ed25519_double(struct ed25519_pt *r, const struct ed25519_pt *a);
 void ed25519_smult(struct ed25519_pt *r, const struct ed25519_pt *a,
 		   const uint8_t *e);
 
+/* Compute r = e*B for the base point B. With ED25519_BASE_COMB_TEETH
+ * set to 4, 5 or 6 this uses a fixed-base comb over a const table of
+ * 2^teeth points (1.5, 3 or 6 kB of flash, see ed25519_base_table.c),
+ * which needs about 256/teeth doublings and additions instead of 256 of
+ * each. Every step scans the whole table to stay constant-time, so
+ * beyond 4 teeth the returns diminish. With 0 (the default) this is the
+ * same as ed25519_smult().
+ */
+#ifndef ED25519_BASE_COMB_TEETH
+#define ED25519_BASE_COMB_TEETH	0
+#endif
+
+void ed25519_smult_base(struct ed25519_pt *r, const uint8_t *e);
+
+/* Compute r = e1*p1 + e2*p2 with interleaved width-w NAF expansions of
+ * both exponents. Roughly half the work of two calls to
+ * ed25519_smult(), but the timing depends on the exponents and points:
+ * only use it on public data, as in signature verification.
+ *
+ * Each point needs a table of 2^(w-2) odd multiples in RAM.
+ */
+#ifndef ED25519_WNAF_WIDTH
+#define ED25519_WNAF_WIDTH	3
+#endif
+
+void ed25519_double_smult(struct ed25519_pt *r,
+			  const uint8_t *e1, const struct ed25519_pt *p1,
+			  const uint8_t *e2, const struct ed25519_pt *p2);
+
+/* Digits of an exponent and odd multiples of its point */
+#define ED25519_WNAF_DIGITS	(ED25519_EXPONENT_SIZE * 8 + 1)
+#define ED25519_WNAF_TABLE_SIZE	(1 << (ED25519_WNAF_WIDTH - 2))
+
+struct ed25519_wnaf {
+	struct ed25519_pt	t[ED25519_WNAF_TABLE_SIZE];
+	int8_t			naf[ED25519_WNAF_DIGITS];
+};
+
+/* The steps of ed25519_multi_smult(), for callers that spread it over
+ * time. Prepare w[j] for each e[j] and p[j], set r to the neutral point
+ * and call ed25519_multi_smult_digit() for each i from
+ * ed25519_wnaf_top() down to 0. A step costs a doubling and at most n
+ * additions.
+ */
+void ed25519_wnaf_prepare(struct ed25519_wnaf *w, const uint8_t *e,
+			  const struct ed25519_pt *p);
+int ed25519_wnaf_top(const struct ed25519_wnaf *w, unsigned int n);
+void ed25519_multi_smult_digit(struct ed25519_pt *r,
+			       const struct ed25519_wnaf *w, unsigned int n,
+			       int i);
+
+/* The same as ed25519_double_smult(), which shares static tables with
+ * ed25519_multi_smult(), but with the tables in w[0] and w[1].
+ */
+void ed25519_double_smult_ws(struct ed25519_wnaf *w, struct ed25519_pt *r,
+			     const uint8_t *e1, const struct ed25519_pt *p1,
+			     const uint8_t *e2, const struct ed25519_pt *p2);
+
+/* Signatures that edsign_verify_batch() can check at once. Zero
+ * disables batch verification. Every signature adds two points to the
+ * multi-scalar multiplication below, and with them RAM for their tables.
+ */
+#ifndef ED25519_BATCH_MAX
+#define ED25519_BATCH_MAX	0
+#endif
+
+#define ED25519_MSM_MAX \
+	(ED25519_BATCH_MAX > 0 ? 2 * ED25519_BATCH_MAX + 1 : 2)
+
+/* Variable-time r = sum(e[i]*p[i]), in the same way as
+ * ed25519_double_smult(). Up to ED25519_MSM_MAX points are done in one
+ * pass, more are done in passes of that many and added up.
+ */
+void ed25519_multi_smult(struct ed25519_pt *r,
+			 const uint8_t *const *e,
+			 const struct ed25519_pt *const *p, unsigned int n);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
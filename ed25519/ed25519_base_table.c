@@ -0,0 +1,915 @@
+/* Fixed-base comb tables for ed25519_smult_base()
+ *
+ * Generated by gen_base_table.py, do not edit.
+ *
+ * This file is in the public domain.
+ */
+
+#include "ed25519.h"
+
+#if ED25519_BASE_COMB_TEETH == 4
+const uint8_t ed25519_base_comb[1 << ED25519_BASE_COMB_TEETH][3][F25519_SIZE] = {
+	{
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
+	},
+	{
+		{0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+		 0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21},
+		{0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+		 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66},
+		{0xa3, 0xdd, 0xb7, 0xa5, 0xb3, 0x8a, 0xde, 0x6d, 0xf5, 0x52, 0x51, 0x77, 0x80, 0x9f, 0xf0, 0x20,
+		 0x7d, 0xe3, 0xab, 0x64, 0x8e, 0x4e, 0xea, 0x66, 0x65, 0x76, 0x8b, 0xd7, 0x0f, 0x5f, 0x87, 0x67}
+	},
+	{
+		{0x02, 0xa2, 0xed, 0xf4, 0x8f, 0x6b, 0x0b, 0x3e, 0xeb, 0x35, 0x1a, 0xd5, 0x7e, 0xdb, 0x78, 0x00,
+		 0x96, 0x8a, 0xa0, 0xb4, 0xcf, 0x60, 0x4b, 0xd4, 0xd5, 0xf9, 0x2d, 0xbf, 0x88, 0xbd, 0x22, 0x62},
+		{0x13, 0x53, 0xe4, 0x82, 0x57, 0xfa, 0x1e, 0x8f, 0x06, 0x2b, 0x90, 0xba, 0x08, 0xb6, 0x10, 0x54,
+		 0x4f, 0x7c, 0x1b, 0x26, 0xed, 0xda, 0x6b, 0xdd, 0x25, 0xd0, 0x4e, 0xea, 0x42, 0xbb, 0x25, 0x03},
+		{0x59, 0x08, 0x74, 0xb6, 0xe9, 0x92, 0xfd, 0x2d, 0x86, 0xbf, 0xc4, 0x9c, 0x0e, 0xbe, 0x0a, 0x3b,
+		 0x60, 0x45, 0x09, 0x40, 0xe6, 0x80, 0x99, 0xc7, 0x0a, 0xae, 0xd3, 0xc7, 0xe2, 0x09, 0x8b, 0x62}
+	},
+	{
+		{0xa2, 0xfb, 0xcc, 0x61, 0x67, 0x06, 0x70, 0x1a, 0xc4, 0x78, 0x3a, 0xff, 0x32, 0x62, 0xdd, 0x2c,
+		 0xab, 0x50, 0x19, 0x3b, 0xf2, 0x9b, 0x7d, 0xb8, 0xfd, 0x4f, 0x29, 0x9c, 0xa7, 0x91, 0xba, 0x0e},
+		{0x46, 0x5e, 0x51, 0xfe, 0x1d, 0xbf, 0xe5, 0xe5, 0x9b, 0x95, 0x0d, 0x67, 0xf8, 0xd1, 0xb5, 0x5a,
+		 0xa1, 0x93, 0x2c, 0xc3, 0xde, 0x0e, 0x97, 0x85, 0x2d, 0x7f, 0xea, 0xab, 0x3e, 0x47, 0x30, 0x18},
+		{0x70, 0xfb, 0xdf, 0x82, 0xf6, 0x46, 0xd3, 0xfd, 0xb5, 0x32, 0xfd, 0x3f, 0x96, 0x09, 0xa1, 0x69,
+		 0x25, 0x25, 0x11, 0xa2, 0xd9, 0xb8, 0x52, 0x07, 0xf3, 0x0a, 0x40, 0xce, 0x13, 0x11, 0xcd, 0x38}
+	},
+	{
+		{0x24, 0xe8, 0xb7, 0x60, 0xae, 0x47, 0x80, 0xfc, 0xe5, 0x23, 0xe7, 0xc2, 0xc9, 0x85, 0xe6, 0x98,
+		 0xa0, 0x29, 0x4e, 0xe1, 0x84, 0x39, 0x2d, 0x95, 0x2c, 0xf3, 0x45, 0x3c, 0xff, 0xaf, 0x27, 0x4c},
+		{0x6b, 0xa6, 0xf5, 0x4b, 0x11, 0xbd, 0xba, 0x5b, 0x9e, 0xc4, 0xa4, 0x51, 0x1e, 0xbe, 0xd0, 0x90,
+		 0x3a, 0x9c, 0xc2, 0x26, 0xb6, 0x1e, 0xf1, 0x95, 0x7d, 0xc8, 0x6d, 0x52, 0xe6, 0x99, 0x2c, 0x5f},
+		{0x8a, 0x33, 0xf1, 0x46, 0xc9, 0x31, 0xe7, 0xe9, 0xa9, 0xad, 0x63, 0x66, 0x82, 0x64, 0x78, 0x14,
+		 0x6a, 0x4b, 0x92, 0x07, 0x00, 0x56, 0xe1, 0xd4, 0x2f, 0x60, 0xf4, 0x0b, 0xfd, 0x64, 0xa1, 0x05}
+	},
+	{
+		{0x9a, 0x96, 0x0c, 0x68, 0x29, 0xfd, 0xe2, 0xfb, 0xe6, 0xbc, 0xec, 0x31, 0x08, 0xec, 0xe6, 0xb0,
+		 0x53, 0x60, 0xc3, 0x8c, 0xbe, 0xc1, 0xb3, 0x8a, 0x8f, 0xe4, 0x88, 0x2b, 0x55, 0xe5, 0x64, 0x6e},
+		{0x9b, 0xd0, 0xaf, 0x7b, 0x64, 0x2a, 0x35, 0x25, 0x10, 0x52, 0xc5, 0x9e, 0x58, 0x11, 0x39, 0x36,
+		 0x45, 0x51, 0xb8, 0x39, 0x93, 0xfc, 0x9d, 0x6a, 0xbe, 0x58, 0xcb, 0xa4, 0x0f, 0x51, 0x3c, 0x38},
+		{0xa9, 0x83, 0x46, 0x81, 0xbc, 0xb0, 0x38, 0xa1, 0x60, 0x8d, 0x3b, 0x78, 0x78, 0x52, 0xfe, 0x43,
+		 0x91, 0x35, 0xb9, 0xa9, 0xb8, 0x2e, 0xbf, 0x57, 0xf9, 0xd8, 0x04, 0x51, 0xf8, 0x61, 0x5c, 0x47}
+	},
+	{
+		{0x05, 0xca, 0xab, 0x43, 0x63, 0x0e, 0xf3, 0x8b, 0x41, 0xa6, 0xf8, 0x9b, 0x53, 0x70, 0x80, 0x53,
+		 0x86, 0x5e, 0x8f, 0xe3, 0xc3, 0x0d, 0x18, 0xc8, 0x4b, 0x34, 0x1f, 0xd8, 0x1d, 0xbc, 0xf2, 0x6d},
+		{0x34, 0x3a, 0xbe, 0xdf, 0xd9, 0xf6, 0xf3, 0x89, 0xa1, 0xe1, 0x94, 0x9f, 0x5d, 0x4c, 0x5d, 0xe9,
+		 0xa1, 0x49, 0x92, 0xef, 0x0e, 0x53, 0x81, 0x89, 0x58, 0x87, 0xa6, 0x37, 0xf1, 0xdd, 0x62, 0x60},
+		{0xb2, 0xf8, 0x25, 0x5a, 0x7b, 0xd8, 0xce, 0x93, 0x92, 0xfc, 0x48, 0xd8, 0xd0, 0x88, 0xe5, 0xf7,
+		 0xec, 0x19, 0xf7, 0xbe, 0xe8, 0x70, 0xd7, 0xe6, 0x8a, 0xcb, 0xb2, 0x25, 0x26, 0x02, 0x7c, 0x50}
+	},
+	{
+		{0x63, 0x5a, 0x9d, 0x1b, 0x8c, 0xc6, 0x7d, 0x52, 0xea, 0x70, 0x09, 0x6a, 0xe1, 0x32, 0xf3, 0x73,
+		 0x21, 0x1f, 0x07, 0x7b, 0x7c, 0x9b, 0x49, 0xd8, 0xc0, 0xf3, 0x25, 0x72, 0x6f, 0x9d, 0xed, 0x31},
+		{0x67, 0x36, 0x36, 0x54, 0x40, 0x92, 0x71, 0xe6, 0x11, 0x28, 0x11, 0xad, 0x93, 0x32, 0x85, 0x7b,
+		 0x3e, 0xb7, 0x3b, 0x49, 0x13, 0x1c, 0x07, 0xb0, 0x2e, 0x93, 0xaa, 0xfd, 0xfd, 0x28, 0x47, 0x3d},
+		{0x39, 0xfb, 0x65, 0x28, 0xde, 0xcd, 0x3b, 0x70, 0x32, 0x42, 0xf4, 0xe8, 0x37, 0x47, 0x57, 0x0f,
+		 0xb7, 0x8f, 0xaf, 0x0b, 0xc5, 0x85, 0xb4, 0xc1, 0xc4, 0xa5, 0x2e, 0x8e, 0xaf, 0x2b, 0x60, 0x4e}
+	},
+	{
+		{0x8d, 0xd2, 0xda, 0xc7, 0x44, 0xd6, 0x7a, 0xdb, 0x26, 0x7d, 0x1d, 0xb8, 0xe1, 0xde, 0x9d, 0x7a,
+		 0x7d, 0x17, 0x7e, 0x1c, 0x37, 0x04, 0x8d, 0x2d, 0x7c, 0x5e, 0x18, 0x38, 0x1e, 0xaf, 0xc7, 0x1b},
+		{0x33, 0x48, 0x31, 0x00, 0x59, 0xf6, 0xf2, 0xca, 0x0f, 0x27, 0x1b, 0x63, 0x12, 0x7e, 0x02, 0x1d,
+		 0x49, 0xc0, 0x5d, 0x79, 0x87, 0xef, 0x5e, 0x7a, 0x2f, 0x1f, 0x66, 0x55, 0xd8, 0x09, 0xd9, 0x61},
+		{0xc7, 0xc2, 0x36, 0x66, 0x21, 0x45, 0xb8, 0x51, 0xf8, 0x7e, 0xde, 0x56, 0x36, 0xf2, 0xb8, 0x9b,
+		 0xbd, 0x0f, 0x1f, 0x4b, 0xde, 0x64, 0xb6, 0xcc, 0x44, 0xfa, 0xb8, 0x54, 0x80, 0x0b, 0x34, 0x1a}
+	},
+	{
+		{0x38, 0x68, 0xb0, 0x07, 0xa3, 0xfc, 0xcc, 0x85, 0x10, 0x7f, 0x4c, 0x65, 0x65, 0xb3, 0xfa, 0xfa,
+		 0xa5, 0x53, 0x6f, 0xdb, 0x74, 0x4c, 0x56, 0x46, 0x03, 0xe2, 0xd5, 0x7a, 0x29, 0x1c, 0xc6, 0x02},
+		{0xbc, 0x59, 0xf2, 0x04, 0x75, 0x63, 0xc0, 0x84, 0x2f, 0x60, 0x1c, 0x67, 0x76, 0xfd, 0x63, 0x86,
+		 0xf3, 0xfa, 0xbf, 0xdc, 0xd2, 0x2d, 0x90, 0x91, 0xbd, 0x33, 0xa9, 0xe5, 0x66, 0x0c, 0xda, 0x42},
+		{0x25, 0xd5, 0x62, 0x0c, 0x3a, 0x9d, 0xa3, 0x10, 0xa4, 0x1c, 0x0a, 0xd2, 0x20, 0x86, 0xda, 0x18,
+		 0x1c, 0x4f, 0xe1, 0x61, 0xbd, 0xe5, 0x75, 0x37, 0x47, 0x7a, 0x2a, 0xfe, 0x39, 0xb1, 0x00, 0x10}
+	},
+	{
+		{0x27, 0xca, 0xf4, 0x66, 0xc2, 0xec, 0x92, 0x14, 0x57, 0x06, 0x63, 0xd0, 0x4d, 0x15, 0x06, 0xeb,
+		 0x69, 0x58, 0x4f, 0x77, 0xc5, 0x8b, 0xc7, 0xf0, 0x8e, 0xed, 0x64, 0xa0, 0xb3, 0x3c, 0x66, 0x71},
+		{0xc6, 0x2d, 0xda, 0x0a, 0x0d, 0xfe, 0x70, 0x27, 0x64, 0xf8, 0x27, 0xfa, 0xf6, 0x5f, 0x30, 0xa5,
+		 0x0d, 0x6c, 0xda, 0xf2, 0x62, 0x5e, 0x78, 0x47, 0xd3, 0x66, 0x00, 0x1c, 0xfd, 0x56, 0x1f, 0x5d},
+		{0xf5, 0x46, 0x72, 0x85, 0x49, 0x6b, 0xaa, 0x5d, 0xb7, 0x5f, 0xdc, 0x35, 0x73, 0xf3, 0xed, 0xbb,
+		 0xf9, 0x41, 0x09, 0xbc, 0xe6, 0x84, 0xe3, 0x6f, 0xec, 0xa2, 0x39, 0xda, 0x4d, 0x66, 0x6c, 0x49}
+	},
+	{
+		{0x3f, 0x6f, 0xf4, 0x4c, 0xd8, 0xfd, 0x0e, 0x27, 0xc9, 0x5c, 0x2b, 0xbc, 0xc0, 0xa4, 0xe7, 0x23,
+		 0x29, 0x02, 0x9f, 0x31, 0xd6, 0xe9, 0xd7, 0x96, 0xf4, 0xe0, 0x5e, 0x0b, 0x0e, 0x13, 0xee, 0x3c},
+		{0x09, 0xed, 0xf2, 0x3d, 0x76, 0x91, 0xc3, 0xa4, 0x97, 0xae, 0xd4, 0x87, 0xd0, 0x5d, 0xf6, 0x18,
+		 0x47, 0x1f, 0x1d, 0x67, 0xf2, 0xcf, 0x63, 0xa0, 0x91, 0x27, 0xf8, 0x93, 0x45, 0x75, 0x23, 0x3f},
+		{0x98, 0x28, 0x93, 0x7c, 0x93, 0x43, 0x14, 0x8a, 0x2b, 0x5b, 0x14, 0x80, 0xc5, 0xf6, 0x68, 0xe3,
+		 0xe9, 0xe6, 0xe7, 0x2c, 0xc6, 0x5b, 0x7f, 0x43, 0x9a, 0x3f, 0x1c, 0x39, 0x6c, 0xf6, 0x08, 0x75}
+	},
+	{
+		{0xd1, 0xf1, 0xad, 0x23, 0xdd, 0x64, 0x93, 0x96, 0x41, 0x70, 0x7f, 0xf7, 0xf5, 0xa9, 0x89, 0xa2,
+		 0x34, 0xb0, 0x8d, 0x1b, 0xae, 0x19, 0x15, 0x49, 0x58, 0x23, 0x6d, 0x87, 0x15, 0x4f, 0x81, 0x76},
+		{0xfb, 0x23, 0xb5, 0xea, 0xcf, 0xac, 0x54, 0x8d, 0x4e, 0x42, 0x2f, 0xeb, 0x0f, 0x63, 0xdb, 0x68,
+		 0x37, 0xa8, 0xcf, 0x8b, 0xab, 0xf5, 0xa4, 0x6e, 0x96, 0x2a, 0xb2, 0xd6, 0xbe, 0x9e, 0xbd, 0x0d},
+		{0x75, 0x3b, 0xc5, 0xfd, 0x39, 0x49, 0xaf, 0x7c, 0xf1, 0x9c, 0x93, 0xd4, 0xd4, 0x2a, 0x95, 0x74,
+		 0x32, 0x34, 0x61, 0x8e, 0x37, 0x89, 0x1c, 0x23, 0x8e, 0x01, 0x47, 0x4d, 0xa8, 0xe5, 0x24, 0x3e}
+	},
+	{
+		{0xb4, 0x42, 0xa9, 0xcf, 0x01, 0x83, 0x8a, 0x17, 0x47, 0x76, 0xc4, 0xc6, 0x83, 0x04, 0x95, 0x0b,
+		 0xfc, 0x11, 0xc9, 0x62, 0xb8, 0x0c, 0x76, 0x84, 0xd9, 0xb9, 0x37, 0xfa, 0xfc, 0x7c, 0xc2, 0x6d},
+		{0x58, 0x3e, 0xb3, 0x04, 0xbb, 0x8c, 0x8f, 0x48, 0xbc, 0x91, 0x27, 0xcc, 0xf9, 0xb7, 0x22, 0x19,
+		 0x83, 0x2e, 0x09, 0xb5, 0x72, 0xd9, 0x54, 0x1c, 0x4d, 0xa1, 0xea, 0x0b, 0xf1, 0xc6, 0x08, 0x72},
+		{0x6b, 0x0b, 0xa2, 0x40, 0xda, 0x8e, 0x94, 0xf6, 0x00, 0x55, 0x42, 0x14, 0x2f, 0x86, 0x77, 0xb8,
+		 0x1b, 0x1f, 0xda, 0x68, 0xd8, 0x21, 0xad, 0x88, 0xfa, 0x33, 0xeb, 0x31, 0xc1, 0x37, 0xbc, 0x56}
+	},
+	{
+		{0x46, 0x87, 0x7a, 0x6e, 0x80, 0x56, 0x0a, 0x8a, 0xc0, 0xdd, 0x11, 0x6b, 0xd6, 0xdd, 0x47, 0xdf,
+		 0x10, 0xd9, 0xd8, 0xea, 0x7c, 0xb0, 0x8f, 0x03, 0x00, 0x2e, 0xc1, 0x8f, 0x44, 0xa8, 0xd3, 0x30},
+		{0x06, 0x89, 0xa2, 0xf9, 0x34, 0xad, 0xdc, 0x03, 0x85, 0xed, 0x51, 0xa7, 0x82, 0x9c, 0xe7, 0x5d,
+		 0x52, 0x93, 0x0c, 0x32, 0x9a, 0x5b, 0xe1, 0xaa, 0xca, 0xb8, 0x02, 0x6d, 0x3a, 0xd4, 0xb1, 0x3a},
+		{0x06, 0x01, 0x08, 0x6d, 0x4b, 0x1c, 0xd9, 0x53, 0x91, 0xc2, 0x05, 0x55, 0xad, 0xe8, 0xeb, 0x2d,
+		 0x64, 0x11, 0x80, 0x11, 0x93, 0xd7, 0x40, 0x38, 0x11, 0xf1, 0x06, 0x82, 0xcb, 0xd2, 0xe2, 0x4e}
+	},
+	{
+		{0xf0, 0x5f, 0xbe, 0xb5, 0x0d, 0x10, 0x6b, 0x38, 0x32, 0xac, 0x76, 0x80, 0xbd, 0xca, 0x94, 0x71,
+		 0x7a, 0xf2, 0xc9, 0x35, 0x2a, 0xde, 0x9f, 0x42, 0x49, 0x18, 0x01, 0xab, 0xbc, 0xef, 0x7c, 0x64},
+		{0x3f, 0x58, 0x3d, 0x92, 0x59, 0xdb, 0x13, 0xdb, 0x58, 0x6e, 0x0a, 0xe0, 0xb7, 0x91, 0x4a, 0x08,
+		 0x20, 0xd6, 0x2e, 0x3c, 0x45, 0xc9, 0x8b, 0x17, 0x79, 0xe7, 0xc7, 0x90, 0x99, 0x3a, 0x18, 0x25},
+		{0xef, 0x9f, 0xec, 0xd8, 0xd9, 0x43, 0x89, 0x78, 0xa2, 0x27, 0x4b, 0x05, 0x3b, 0x7d, 0xc2, 0x30,
+		 0x1a, 0x62, 0x18, 0x53, 0xb9, 0x47, 0x91, 0xf8, 0x0a, 0x09, 0x4c, 0x5f, 0x7a, 0xe2, 0x10, 0x04}
+	}
+};
+#elif ED25519_BASE_COMB_TEETH == 5
+const uint8_t ed25519_base_comb[1 << ED25519_BASE_COMB_TEETH][3][F25519_SIZE] = {
+	{
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
+	},
+	{
+		{0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+		 0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21},
+		{0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+		 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66},
+		{0xa3, 0xdd, 0xb7, 0xa5, 0xb3, 0x8a, 0xde, 0x6d, 0xf5, 0x52, 0x51, 0x77, 0x80, 0x9f, 0xf0, 0x20,
+		 0x7d, 0xe3, 0xab, 0x64, 0x8e, 0x4e, 0xea, 0x66, 0x65, 0x76, 0x8b, 0xd7, 0x0f, 0x5f, 0x87, 0x67}
+	},
+	{
+		{0xa4, 0xeb, 0x04, 0xa4, 0x8c, 0x8f, 0x71, 0x27, 0x95, 0x85, 0x5d, 0x55, 0x4b, 0xb1, 0x26, 0x26,
+		 0xc8, 0xae, 0x6a, 0x7d, 0xa2, 0x21, 0xca, 0xce, 0x38, 0xab, 0x0f, 0xd0, 0xd5, 0x2b, 0x6b, 0x00},
+		{0xe5, 0x67, 0x0c, 0xf1, 0x3a, 0x9a, 0xea, 0x09, 0x39, 0xef, 0xd1, 0x30, 0xbc, 0x33, 0xba, 0xb1,
+		 0x6a, 0xc5, 0x27, 0x08, 0x7f, 0x54, 0x80, 0x3d, 0xab, 0xf6, 0x15, 0x7a, 0xc2, 0x40, 0x73, 0x72},
+		{0xc2, 0xc1, 0xae, 0xb7, 0x5f, 0xbc, 0x20, 0xf1, 0x0d, 0xbe, 0xea, 0xa2, 0x8e, 0x4d, 0x1b, 0x98,
+		 0x18, 0x39, 0xfd, 0x5b, 0xd4, 0x25, 0xfa, 0x4a, 0x30, 0x89, 0x87, 0x05, 0x89, 0x85, 0x69, 0x53}
+	},
+	{
+		{0x2b, 0xe1, 0xcd, 0x06, 0xc2, 0x84, 0xf3, 0x9f, 0x6b, 0x97, 0xa0, 0x71, 0xdf, 0xc1, 0xc3, 0xd5,
+		 0x84, 0x36, 0x11, 0x0f, 0xd7, 0x45, 0xaa, 0x8d, 0x03, 0x57, 0x9d, 0xa5, 0x19, 0x1e, 0x49, 0x76},
+		{0x62, 0xf5, 0x8b, 0xb3, 0x7f, 0xd8, 0xa0, 0x38, 0x35, 0xc7, 0x39, 0xf2, 0x80, 0x02, 0xaf, 0x9e,
+		 0x94, 0x37, 0xac, 0xea, 0x96, 0xf3, 0xde, 0xd6, 0x10, 0x4e, 0xc6, 0xf0, 0x28, 0x83, 0x70, 0x2e},
+		{0x9c, 0xa4, 0xcc, 0x6c, 0xe9, 0xd7, 0xc8, 0x81, 0x67, 0xb8, 0xa7, 0x6e, 0x69, 0x2b, 0xb5, 0xf6,
+		 0xcf, 0xed, 0x68, 0x66, 0xcc, 0x5b, 0xa0, 0xaf, 0x6b, 0x44, 0xea, 0xb0, 0xf3, 0x77, 0x08, 0x1d}
+	},
+	{
+		{0x0f, 0xa9, 0xd5, 0x01, 0xaa, 0x48, 0x4f, 0x28, 0x66, 0x32, 0x1a, 0xba, 0x7c, 0xea, 0x11, 0x80,
+		 0x17, 0x18, 0x9b, 0x56, 0x88, 0x25, 0x06, 0x69, 0x12, 0x2c, 0xea, 0x56, 0x69, 0x41, 0x24, 0x19},
+		{0xde, 0x21, 0xf0, 0xda, 0x8a, 0xfb, 0xb1, 0xb8, 0xcd, 0xc8, 0x6a, 0x82, 0x19, 0x73, 0xdb, 0xc7,
+		 0xcf, 0x88, 0xeb, 0x96, 0xee, 0x6f, 0xfb, 0x06, 0xd2, 0xcd, 0x7d, 0x7b, 0x12, 0x28, 0x8e, 0x0c},
+		{0x85, 0x1f, 0xe4, 0x14, 0x2c, 0x7c, 0x50, 0xc1, 0x8b, 0x08, 0xc2, 0x1b, 0xd2, 0x6c, 0xaf, 0x06,
+		 0xed, 0x64, 0x00, 0xdb, 0x30, 0xee, 0xed, 0xc6, 0xea, 0xdb, 0xde, 0x42, 0x73, 0xd6, 0x3f, 0x54}
+	},
+	{
+		{0xbb, 0x66, 0x67, 0x42, 0xf3, 0x33, 0xa5, 0x0d, 0x96, 0xc9, 0x52, 0x36, 0x41, 0x24, 0xaf, 0x83,
+		 0x40, 0xbe, 0xee, 0xbd, 0xe5, 0x1a, 0xde, 0xf9, 0xd5, 0xd8, 0xda, 0xff, 0xe1, 0x0f, 0x26, 0x2f},
+		{0x81, 0x15, 0x99, 0x8e, 0x36, 0x78, 0xb1, 0xe5, 0xf3, 0x0c, 0xa6, 0xb5, 0x58, 0xff, 0x7e, 0x2f,
+		 0x94, 0x45, 0xf8, 0xae, 0xf1, 0xf5, 0xd3, 0x45, 0x69, 0x27, 0x86, 0x3f, 0xb9, 0x8f, 0x6a, 0x69},
+		{0x93, 0x01, 0x16, 0x27, 0xd4, 0xde, 0xb0, 0xdf, 0x5a, 0x1e, 0xdf, 0xec, 0xa6, 0x66, 0x24, 0xfd,
+		 0xa2, 0x57, 0x1c, 0x45, 0xc9, 0xe4, 0x7d, 0xe0, 0x17, 0x0e, 0xab, 0xed, 0x1c, 0x16, 0x95, 0x19}
+	},
+	{
+		{0xef, 0x48, 0x61, 0x2f, 0xbd, 0xb3, 0x0b, 0x79, 0x4e, 0xc4, 0xb6, 0x82, 0xbd, 0x55, 0x76, 0xd7,
+		 0xfd, 0xc3, 0x6d, 0x47, 0xc4, 0x20, 0xb0, 0x48, 0x14, 0x0f, 0x1a, 0x21, 0xb1, 0xed, 0x4f, 0x60},
+		{0xaa, 0x88, 0x80, 0xcb, 0x00, 0x88, 0x37, 0x26, 0x0b, 0x9e, 0x69, 0xd2, 0x57, 0x6e, 0x4e, 0xbc,
+		 0xbe, 0xf9, 0xe3, 0xeb, 0x64, 0x28, 0x1f, 0x5d, 0x4c, 0x38, 0x77, 0xc7, 0xff, 0x75, 0x68, 0x54},
+		{0x98, 0x7f, 0x3e, 0x72, 0x7d, 0xc0, 0x43, 0x72, 0xd6, 0x19, 0x49, 0x26, 0x46, 0x76, 0xd4, 0xe0,
+		 0xd5, 0x85, 0x06, 0xca, 0xb4, 0x90, 0x3f, 0x19, 0x8a, 0x57, 0xdd, 0x4e, 0x1f, 0x99, 0xb9, 0x18}
+	},
+	{
+		{0x90, 0x36, 0xd4, 0x7e, 0x83, 0xc3, 0xb9, 0x29, 0xd6, 0xaa, 0x2e, 0xff, 0x56, 0x27, 0x68, 0xe7,
+		 0x8e, 0xb7, 0x2c, 0x5b, 0xc6, 0x94, 0xca, 0x3d, 0x89, 0xbf, 0x8e, 0x66, 0x40, 0xdd, 0xbc, 0x78},
+		{0xf9, 0xb2, 0xb5, 0x26, 0xad, 0x74, 0xe4, 0x5b, 0x8d, 0xc5, 0xfa, 0x49, 0xf5, 0x27, 0x15, 0xb0,
+		 0x78, 0x50, 0xea, 0xea, 0xbf, 0x7c, 0xcc, 0xc5, 0x5e, 0xae, 0xbb, 0x90, 0x2a, 0x97, 0xe8, 0x3b},
+		{0xa9, 0x3d, 0x39, 0x2d, 0x94, 0x20, 0xc5, 0x69, 0x29, 0x67, 0xa0, 0x30, 0x78, 0x97, 0xe1, 0x29,
+		 0x38, 0x81, 0x3b, 0x00, 0x06, 0xa0, 0x42, 0xd6, 0x1c, 0xe5, 0xcd, 0xad, 0xec, 0x47, 0xfe, 0x5d}
+	},
+	{
+		{0x46, 0xca, 0xa7, 0x55, 0x7b, 0x79, 0xf3, 0xca, 0x5a, 0x65, 0xf6, 0xed, 0x50, 0x14, 0x7b, 0xe4,
+		 0xc4, 0x2a, 0x65, 0x9e, 0xe2, 0xf9, 0xca, 0xa7, 0x22, 0x26, 0x53, 0xcb, 0x21, 0x5b, 0xa7, 0x31},
+		{0x90, 0xd7, 0xc5, 0x26, 0x08, 0xbd, 0xb0, 0x53, 0x63, 0x58, 0xc3, 0x31, 0x5e, 0x75, 0x46, 0x15,
+		 0x91, 0xa6, 0xf8, 0x2f, 0x1a, 0x08, 0x65, 0x88, 0x2f, 0x98, 0x04, 0xf1, 0x7c, 0x6e, 0x00, 0x77},
+		{0x25, 0xd8, 0xfc, 0x5f, 0x78, 0x77, 0x96, 0x51, 0xb3, 0xb8, 0x8e, 0xe9, 0x60, 0x2b, 0x82, 0xc3,
+		 0xe6, 0x83, 0x5f, 0xd1, 0xb7, 0xe3, 0xca, 0x29, 0x40, 0x49, 0x93, 0x9e, 0x7b, 0xc1, 0xee, 0x2d}
+	},
+	{
+		{0x59, 0xab, 0xe7, 0x84, 0x96, 0x61, 0x95, 0x29, 0x4f, 0xf3, 0xa6, 0x98, 0x01, 0x5e, 0x0e, 0x1a,
+		 0x63, 0x5e, 0xf5, 0x79, 0xed, 0xcd, 0x9d, 0xdb, 0xb1, 0x05, 0x35, 0xe5, 0xdf, 0xdd, 0xed, 0x6d},
+		{0x9e, 0x2e, 0xcf, 0x73, 0x25, 0x05, 0xf9, 0x8e, 0x49, 0x6d, 0x04, 0x56, 0x41, 0x63, 0xfb, 0xf9,
+		 0xb5, 0x62, 0x91, 0x89, 0xb8, 0xf6, 0xc3, 0x7e, 0x48, 0xd4, 0x22, 0x58, 0x85, 0x72, 0x83, 0x1b},
+		{0xb8, 0x81, 0xa2, 0xdf, 0xa2, 0xfb, 0xe4, 0x63, 0xd1, 0x65, 0xa2, 0xf2, 0x2c, 0xae, 0xb7, 0x79,
+		 0x61, 0xde, 0x0a, 0x81, 0xc7, 0x6d, 0x49, 0x29, 0xca, 0xb5, 0x96, 0x76, 0x1b, 0x0b, 0xea, 0x22}
+	},
+	{
+		{0xd0, 0x5f, 0x83, 0x11, 0x7b, 0x4f, 0x51, 0x1e, 0x58, 0x54, 0x9d, 0x95, 0xf2, 0xfa, 0x46, 0xe1,
+		 0x3a, 0x60, 0xe2, 0x30, 0xf5, 0xba, 0x56, 0xd7, 0xc5, 0x89, 0x09, 0x06, 0xf4, 0x0c, 0x74, 0x30},
+		{0x2a, 0xc4, 0x36, 0x71, 0xc0, 0x9a, 0x6d, 0x99, 0xac, 0xf6, 0x10, 0x18, 0xfa, 0x08, 0xbe, 0xc5,
+		 0xa9, 0x08, 0x4d, 0xb8, 0x4e, 0xe7, 0x99, 0x25, 0xb5, 0x3f, 0x13, 0x56, 0x4f, 0xfc, 0xaa, 0x2e},
+		{0xfd, 0xdd, 0x15, 0xe8, 0x5f, 0x3a, 0x44, 0x2a, 0xc6, 0x57, 0xcb, 0xc6, 0x7b, 0x34, 0xec, 0xcc,
+		 0x4d, 0xc5, 0x35, 0xf4, 0x37, 0xcd, 0xa0, 0xca, 0xb0, 0x42, 0x6c, 0x42, 0x61, 0x45, 0x05, 0x59}
+	},
+	{
+		{0x6c, 0xa0, 0xb5, 0x44, 0x29, 0x84, 0xff, 0x82, 0xab, 0x49, 0x22, 0x41, 0x45, 0xe9, 0xa9, 0xad,
+		 0x94, 0x91, 0x79, 0xcb, 0x14, 0x50, 0x7a, 0x14, 0xa7, 0x5f, 0x3e, 0x64, 0x2f, 0xb7, 0x2d, 0x5e},
+		{0xe8, 0x2a, 0x91, 0xb1, 0x01, 0x9a, 0x7d, 0xd2, 0xd1, 0x37, 0xf0, 0x2e, 0xbf, 0xdd, 0x1f, 0x47,
+		 0x64, 0xca, 0x09, 0x2a, 0x9e, 0x70, 0xfc, 0x82, 0x36, 0x26, 0x46, 0xeb, 0xce, 0xc7, 0xdb, 0x1d},
+		{0x1b, 0x51, 0xc3, 0xad, 0x91, 0x53, 0xb2, 0x5d, 0x34, 0x36, 0x56, 0xb0, 0x8d, 0xfe, 0x9b, 0x47,
+		 0x27, 0xf3, 0xad, 0x32, 0x74, 0x1e, 0x16, 0x28, 0x87, 0x6e, 0x5b, 0x1d, 0x61, 0x2c, 0x4d, 0x6d}
+	},
+	{
+		{0x8e, 0x83, 0xbf, 0x25, 0x4a, 0xce, 0x55, 0x85, 0x14, 0x6c, 0xf5, 0xc2, 0xd9, 0x99, 0xce, 0x4f,
+		 0xc6, 0x58, 0xee, 0xd7, 0x62, 0x3c, 0x99, 0x26, 0x21, 0x63, 0xae, 0xc5, 0xe3, 0x7a, 0x37, 0x3f},
+		{0x30, 0x7c, 0xef, 0xa9, 0x60, 0xd4, 0x2c, 0x2b, 0x8c, 0xce, 0x0e, 0x54, 0x66, 0x87, 0xd2, 0xaa,
+		 0xea, 0xc0, 0x8c, 0x09, 0xe7, 0xfb, 0xc0, 0x15, 0xb2, 0x17, 0x66, 0xc0, 0x24, 0x20, 0xab, 0x73},
+		{0xcd, 0x8b, 0x8c, 0x24, 0x08, 0x6d, 0xba, 0xfd, 0x78, 0x0a, 0xf8, 0x96, 0x5c, 0x6a, 0x0f, 0x04,
+		 0x01, 0xe2, 0xd8, 0x33, 0xd7, 0x94, 0x89, 0x63, 0x33, 0x5e, 0x15, 0x3a, 0xa1, 0xff, 0x74, 0x38}
+	},
+	{
+		{0xe8, 0x6a, 0xf6, 0xb4, 0x61, 0x0f, 0x2d, 0xbc, 0x63, 0xc1, 0xec, 0x49, 0x1f, 0x91, 0xf2, 0x41,
+		 0xed, 0xed, 0x7c, 0x5d, 0xdb, 0x4e, 0x08, 0x11, 0x57, 0x57, 0x0b, 0xd9, 0x1d, 0x7a, 0xfc, 0x23},
+		{0x6b, 0x97, 0x64, 0xa4, 0xfd, 0xa8, 0x9f, 0x74, 0xb4, 0x92, 0xda, 0xb6, 0x8c, 0xc2, 0x3e, 0x4a,
+		 0xe8, 0xa9, 0xd7, 0xfa, 0x31, 0x01, 0x0a, 0x35, 0xca, 0x39, 0xdb, 0x53, 0xe8, 0xd0, 0x42, 0x62},
+		{0x83, 0xbd, 0x16, 0x88, 0xbc, 0x0d, 0xc7, 0xf1, 0xa8, 0xe9, 0x40, 0x4a, 0x4f, 0x29, 0x6b, 0xb5,
+		 0x5b, 0x00, 0x35, 0x0e, 0x79, 0x08, 0x1c, 0x1c, 0x71, 0x81, 0xe8, 0x92, 0x0f, 0xaa, 0xf1, 0x59}
+	},
+	{
+		{0x7d, 0x26, 0x7d, 0xa7, 0xb0, 0xd9, 0x78, 0x87, 0x2e, 0xdb, 0x6c, 0x63, 0xbc, 0xac, 0x2f, 0xe4,
+		 0xbd, 0xd0, 0x90, 0xa3, 0x99, 0x28, 0x7a, 0x9c, 0xe6, 0x11, 0xb5, 0x71, 0xd3, 0x15, 0x7c, 0x7b},
+		{0xc1, 0x7e, 0x9c, 0x72, 0x00, 0xb3, 0xac, 0x5d, 0xc0, 0xae, 0x56, 0x9b, 0x07, 0x4d, 0x99, 0x83,
+		 0x87, 0xfc, 0xf5, 0x5f, 0xc5, 0x48, 0x80, 0x89, 0xa6, 0x49, 0x93, 0x6b, 0xc4, 0x19, 0x13, 0x17},
+		{0x47, 0x76, 0x8f, 0x92, 0x75, 0x2d, 0xdd, 0x82, 0xd0, 0xd7, 0xe4, 0x46, 0x0f, 0x77, 0xc3, 0xa0,
+		 0xfe, 0x7b, 0x7d, 0x8c, 0x00, 0x7f, 0xc0, 0xd2, 0x93, 0xd9, 0x42, 0x80, 0x61, 0xfe, 0x2c, 0x7d}
+	},
+	{
+		{0x31, 0x9f, 0xa5, 0x2f, 0xed, 0x72, 0xdb, 0x3f, 0x37, 0xf0, 0xb8, 0x5e, 0x52, 0x5f, 0x23, 0xf2,
+		 0x7f, 0x72, 0xbe, 0x54, 0x2a, 0x5d, 0x54, 0xf1, 0x2e, 0x13, 0xc6, 0x7f, 0xb2, 0x34, 0x5e, 0x3f},
+		{0x8a, 0x07, 0x9a, 0x53, 0xa0, 0x73, 0x16, 0xec, 0xc1, 0x43, 0xc8, 0x0e, 0x01, 0xc0, 0x56, 0x4f,
+		 0x10, 0xf3, 0x0c, 0xd4, 0x0d, 0x26, 0xd5, 0x15, 0x74, 0x7a, 0x91, 0x76, 0x3a, 0xe8, 0xeb, 0x7c},
+		{0xb5, 0x3f, 0x54, 0xc3, 0x0c, 0xa7, 0x8b, 0x4a, 0xb8, 0x49, 0xf8, 0xc2, 0xe8, 0xc8, 0x78, 0xf0,
+		 0xa1, 0xd4, 0xd8, 0x39, 0x75, 0x89, 0x43, 0xcd, 0x45, 0x4a, 0x0c, 0x6b, 0x74, 0xb5, 0x89, 0x24}
+	},
+	{
+		{0xdb, 0xfa, 0x9b, 0x2c, 0xd4, 0x23, 0x67, 0x2c, 0x8a, 0x63, 0x6c, 0x07, 0x26, 0x48, 0x4f, 0xc2,
+		 0x03, 0xd2, 0x53, 0x20, 0x28, 0xed, 0x65, 0x71, 0x47, 0xa9, 0x16, 0x16, 0x12, 0xbc, 0x28, 0x33},
+		{0x39, 0xc0, 0xfa, 0xfa, 0xcd, 0x33, 0x43, 0xc7, 0x97, 0x76, 0x9b, 0x93, 0x91, 0x72, 0xeb, 0xc5,
+		 0x18, 0x67, 0x4c, 0x11, 0xf0, 0xf4, 0xe5, 0x73, 0xb2, 0x5c, 0x1b, 0xc2, 0x26, 0x3f, 0xbf, 0x2b},
+		{0xb1, 0x5d, 0x40, 0x5f, 0x2b, 0xf3, 0x8f, 0x03, 0x7b, 0xdb, 0x6d, 0xf4, 0x7c, 0xcc, 0xff, 0x46,
+		 0xf0, 0x66, 0x46, 0x73, 0xd4, 0x43, 0x17, 0x52, 0x54, 0x6d, 0xa5, 0xdc, 0xc9, 0xfb, 0xe3, 0x52}
+	},
+	{
+		{0xdc, 0xf2, 0xc3, 0xc8, 0x62, 0x72, 0x50, 0xb4, 0xab, 0xfc, 0x27, 0xe5, 0xb4, 0x5b, 0xa4, 0xf2,
+		 0xe7, 0x5e, 0x38, 0xe4, 0x04, 0x4f, 0xa6, 0x53, 0xb0, 0x21, 0x21, 0xc3, 0xa3, 0x79, 0x8e, 0x3a},
+		{0x0a, 0x1a, 0x90, 0x33, 0xf4, 0x9a, 0x94, 0xa8, 0xdb, 0x23, 0x58, 0x55, 0xf2, 0x7f, 0xd5, 0xaa,
+		 0xbe, 0xac, 0x6c, 0x94, 0xad, 0xbd, 0xea, 0x27, 0xc5, 0xdf, 0xcd, 0x78, 0xdc, 0x45, 0x44, 0x23},
+		{0x43, 0x3f, 0xd6, 0x1a, 0xcb, 0xdf, 0xa3, 0x68, 0xad, 0xa7, 0xe1, 0xb9, 0x2b, 0x68, 0xe9, 0x5e,
+		 0x50, 0xda, 0xf1, 0x9a, 0x73, 0x25, 0x3b, 0x7b, 0xde, 0x50, 0xe8, 0x48, 0xcf, 0xfc, 0x92, 0x56}
+	},
+	{
+		{0xeb, 0xc6, 0xc6, 0x94, 0xd9, 0x48, 0xca, 0x9b, 0xd4, 0xdc, 0x6f, 0x25, 0x96, 0x76, 0x84, 0xc0,
+		 0xa4, 0x8f, 0xfb, 0x0e, 0xb6, 0xb2, 0xfc, 0x3c, 0x0d, 0x57, 0x6f, 0x8d, 0x41, 0xee, 0xd0, 0x46},
+		{0xf5, 0x84, 0xf5, 0x80, 0xdf, 0xfd, 0x13, 0x2d, 0x2e, 0xcc, 0x3e, 0x3c, 0xb0, 0x1a, 0xd5, 0x83,
+		 0x66, 0x02, 0x0c, 0xd0, 0xf2, 0xa9, 0x8a, 0x36, 0xf6, 0xb9, 0x4c, 0x34, 0x8b, 0x3c, 0xad, 0x73},
+		{0x34, 0x46, 0x0e, 0x2e, 0x57, 0xf9, 0x59, 0xd0, 0x6c, 0x3b, 0x25, 0x46, 0x81, 0x39, 0xaa, 0x66,
+		 0xe5, 0x4b, 0xc7, 0x74, 0xfe, 0xfd, 0x83, 0xdc, 0x3e, 0x2e, 0xff, 0x5e, 0x1d, 0x2a, 0xdc, 0x03}
+	},
+	{
+		{0xa4, 0x8a, 0xa5, 0x94, 0xa2, 0xe9, 0xdb, 0x0c, 0xa7, 0x21, 0xfe, 0xea, 0x3f, 0x1e, 0xbe, 0x1e,
+		 0xd9, 0x4a, 0xb8, 0xe8, 0x23, 0x43, 0x28, 0x9a, 0xbe, 0x4b, 0x19, 0x9a, 0xb2, 0x17, 0x57, 0x6b},
+		{0xf3, 0x43, 0x9e, 0xd7, 0x38, 0x7b, 0x41, 0xbc, 0xe5, 0x31, 0xd4, 0x3e, 0xd7, 0x46, 0x23, 0x6f,
+		 0xd0, 0x0e, 0x0e, 0x4b, 0xbf, 0x44, 0xc3, 0x82, 0x56, 0x13, 0x14, 0x15, 0x2a, 0x57, 0x40, 0x3e},
+		{0x1f, 0xde, 0x72, 0x63, 0x04, 0x2a, 0x3f, 0xf0, 0x27, 0xe1, 0xd9, 0x7e, 0xf5, 0x09, 0xf8, 0xcc,
+		 0x22, 0x24, 0x47, 0xa4, 0x61, 0xa6, 0x4b, 0x86, 0xd1, 0xc7, 0x2f, 0x94, 0x8c, 0xd5, 0x51, 0x2c}
+	},
+	{
+		{0xc0, 0x3b, 0x12, 0xfc, 0x76, 0xe5, 0x07, 0x58, 0xa3, 0xb2, 0x38, 0xec, 0x15, 0xb7, 0xd0, 0xa9,
+		 0x4a, 0x5e, 0xe7, 0x11, 0x9b, 0x60, 0xf2, 0xd9, 0x9b, 0x38, 0x01, 0xf6, 0xa1, 0x69, 0xc7, 0x75},
+		{0x2f, 0xbd, 0x4a, 0x75, 0xd9, 0xca, 0xcd, 0xfc, 0x37, 0x8e, 0x67, 0x65, 0x80, 0x1a, 0xad, 0xdd,
+		 0xc8, 0x9f, 0xc6, 0x99, 0xa3, 0x6d, 0x75, 0x40, 0x8f, 0xe8, 0x6e, 0x8f, 0x79, 0x2b, 0x58, 0x11},
+		{0x89, 0x9d, 0xc4, 0x9f, 0x34, 0xf7, 0x45, 0xb6, 0x78, 0xc8, 0xe9, 0xdf, 0x37, 0xac, 0xf1, 0xda,
+		 0xd7, 0x40, 0xf8, 0xa4, 0xe5, 0x4b, 0xa3, 0xe1, 0x7d, 0x5d, 0xef, 0x62, 0x4c, 0x08, 0x3b, 0x30}
+	},
+	{
+		{0x50, 0xec, 0xd3, 0xa6, 0xd7, 0x68, 0x67, 0x57, 0xb0, 0xa8, 0x44, 0xa6, 0x82, 0x6f, 0x6f, 0x74,
+		 0x61, 0x40, 0x4b, 0x22, 0xf8, 0xf0, 0x88, 0x1b, 0x14, 0xfc, 0x28, 0xd8, 0x40, 0x0d, 0x8e, 0x65},
+		{0x22, 0xf8, 0x1d, 0x52, 0x37, 0xa1, 0x63, 0xba, 0xb4, 0x07, 0x2d, 0x25, 0x2f, 0xbd, 0x50, 0x2d,
+		 0xfc, 0xbd, 0x43, 0x16, 0x84, 0xb9, 0xdb, 0x65, 0xc5, 0xd9, 0xe2, 0x5e, 0x70, 0xd2, 0x63, 0x76},
+		{0x2a, 0x33, 0x64, 0x4a, 0xe5, 0xb5, 0x36, 0xd1, 0x37, 0x93, 0xda, 0x61, 0xc1, 0xf4, 0xfa, 0x42,
+		 0xb5, 0xa2, 0x69, 0x81, 0x77, 0x97, 0xc0, 0x8f, 0xf5, 0xdd, 0x71, 0xb4, 0x2b, 0x1c, 0x8a, 0x5b}
+	},
+	{
+		{0xfb, 0x94, 0x4f, 0xa2, 0x66, 0x49, 0x1d, 0x0b, 0xda, 0xc5, 0x29, 0x84, 0x8f, 0x31, 0x6c, 0x27,
+		 0x7f, 0xc7, 0xa7, 0x28, 0x74, 0x6f, 0xe2, 0xad, 0xf8, 0xd5, 0x62, 0x23, 0x84, 0x22, 0x3b, 0x15},
+		{0xa8, 0x44, 0x79, 0xc5, 0x24, 0xd8, 0xbe, 0x52, 0x32, 0xc6, 0x9a, 0x4f, 0xfd, 0xc1, 0xa8, 0x34,
+		 0xc5, 0x5c, 0x71, 0x01, 0xb9, 0x51, 0xc8, 0x52, 0xa5, 0x7a, 0xbf, 0x94, 0x87, 0x8d, 0x82, 0x4a},
+		{0x28, 0x9f, 0x52, 0x4f, 0x6d, 0xd4, 0x6f, 0xeb, 0x14, 0x1c, 0xc8, 0xb0, 0xf6, 0xa0, 0x05, 0x78,
+		 0xc6, 0x46, 0xc6, 0x51, 0xa5, 0x69, 0xf7, 0xf0, 0xae, 0xbc, 0x9b, 0x41, 0x4a, 0x1f, 0x14, 0x71}
+	},
+	{
+		{0x77, 0x35, 0xa9, 0x03, 0xb3, 0x24, 0xfe, 0xa5, 0xc9, 0xc7, 0xa4, 0xd7, 0x67, 0x8d, 0x94, 0x1c,
+		 0xb8, 0xd9, 0x1e, 0x6a, 0x6a, 0xb3, 0xe1, 0xeb, 0x82, 0xf8, 0xbc, 0xd0, 0x7f, 0x56, 0xf9, 0x51},
+		{0xc6, 0x48, 0x65, 0x64, 0x28, 0xe2, 0xa9, 0x2f, 0xc3, 0xdd, 0xbd, 0x00, 0xf9, 0xe8, 0x05, 0xf8,
+		 0x2e, 0x8b, 0xf8, 0x02, 0x32, 0x6b, 0xcb, 0x5a, 0xc2, 0x07, 0xd3, 0xa9, 0x1d, 0xd5, 0x10, 0x4f},
+		{0x33, 0x53, 0xfb, 0xc9, 0xd6, 0x97, 0x94, 0x6f, 0x48, 0x55, 0xa8, 0x2f, 0x92, 0x21, 0x6d, 0x10,
+		 0xb2, 0x6b, 0xea, 0x02, 0x1c, 0x71, 0x30, 0x16, 0x3d, 0x98, 0xdb, 0x7a, 0xfc, 0xff, 0x2e, 0x79}
+	},
+	{
+		{0x97, 0xf4, 0x89, 0x26, 0x5f, 0xa6, 0xd1, 0x44, 0xba, 0x0e, 0xcd, 0x97, 0xb3, 0xfa, 0xce, 0xd3,
+		 0x22, 0x25, 0x2e, 0x0a, 0xd9, 0x61, 0x38, 0x08, 0x65, 0xb4, 0x95, 0xfd, 0xca, 0x2e, 0xc1, 0x44},
+		{0x7e, 0x67, 0x6c, 0x0e, 0x87, 0x55, 0x37, 0xc9, 0xca, 0x59, 0x5b, 0x4b, 0xc9, 0xf7, 0x50, 0xd5,
+		 0x79, 0xbd, 0x8b, 0x71, 0xb0, 0x47, 0x40, 0x63, 0xbd, 0x51, 0xb0, 0x22, 0xde, 0x71, 0xb1, 0x02},
+		{0xf3, 0x81, 0xa0, 0xe4, 0x56, 0x0e, 0x06, 0x4c, 0xb8, 0x33, 0x0d, 0xa2, 0x51, 0xea, 0x23, 0x7d,
+		 0xe7, 0x5e, 0x55, 0x4f, 0x32, 0x6a, 0x54, 0xd4, 0x8d, 0x54, 0x83, 0x02, 0xf4, 0x74, 0x5a, 0x1e}
+	},
+	{
+		{0x34, 0xf4, 0x44, 0xf0, 0x00, 0xe7, 0x01, 0x25, 0xa2, 0x14, 0x47, 0x56, 0xd6, 0x6e, 0xc9, 0x66,
+		 0xd1, 0x18, 0x0b, 0xb9, 0x33, 0xdd, 0xde, 0x05, 0xfb, 0xaa, 0x63, 0xa9, 0xed, 0xaf, 0x76, 0x75},
+		{0x58, 0x40, 0x69, 0x14, 0x2b, 0x99, 0xdb, 0xc6, 0x46, 0xa0, 0xf9, 0x65, 0x0e, 0xee, 0x48, 0x52,
+		 0xfb, 0x2a, 0x65, 0x45, 0x55, 0xe5, 0x24, 0xcc, 0xda, 0x0a, 0x83, 0x77, 0x1d, 0x23, 0x76, 0x47},
+		{0x07, 0xf3, 0x7c, 0x2a, 0xab, 0xaf, 0x1e, 0x19, 0x43, 0x45, 0x59, 0x16, 0x79, 0x8a, 0xbb, 0x43,
+		 0xb2, 0x9f, 0xa2, 0x6d, 0xe2, 0xad, 0xa4, 0x13, 0x93, 0xbd, 0xa8, 0xb0, 0x95, 0xcc, 0x89, 0x0e}
+	},
+	{
+		{0xfb, 0x23, 0xd7, 0xab, 0x16, 0x5c, 0xc6, 0x59, 0xdf, 0x45, 0xff, 0xc2, 0xeb, 0x95, 0x7d, 0x85,
+		 0x8a, 0xc7, 0x1f, 0xb2, 0xd5, 0xb0, 0x05, 0xee, 0x47, 0x9b, 0xdb, 0x70, 0xe8, 0xe8, 0xd6, 0x5b},
+		{0xd4, 0xb8, 0x60, 0xc0, 0xd1, 0x24, 0xc6, 0xbd, 0x23, 0x7c, 0x99, 0x3d, 0x93, 0xc1, 0x0d, 0x5b,
+		 0xcd, 0x67, 0x79, 0x11, 0xa2, 0x36, 0x5b, 0xa4, 0xab, 0x6c, 0xdc, 0x17, 0x2f, 0x28, 0x3b, 0x72},
+		{0x0e, 0x25, 0xce, 0xf7, 0x21, 0x22, 0x5b, 0x5c, 0xbf, 0x44, 0x66, 0xf7, 0xd9, 0x94, 0xcf, 0x92,
+		 0xdd, 0x74, 0x00, 0x22, 0xe7, 0x9d, 0x0a, 0xf7, 0x68, 0x87, 0xf8, 0xaa, 0xce, 0xae, 0x5e, 0x2e}
+	},
+	{
+		{0x5d, 0xce, 0x52, 0xbb, 0x94, 0x9f, 0xad, 0xdd, 0x08, 0x4e, 0x0e, 0x2e, 0xdd, 0x42, 0xa0, 0x29,
+		 0xfb, 0xf5, 0xd3, 0xb2, 0xb7, 0xc5, 0x88, 0x45, 0x97, 0x39, 0x4e, 0x10, 0xd6, 0x48, 0xca, 0x5d},
+		{0x34, 0x8a, 0x96, 0x7e, 0x76, 0xc9, 0xdf, 0xc4, 0xf8, 0xa4, 0x18, 0x0d, 0x05, 0x1c, 0x65, 0x3a,
+		 0x88, 0x5d, 0x5d, 0x1d, 0x89, 0x64, 0xdc, 0x83, 0xcd, 0x73, 0x84, 0x51, 0x42, 0x9c, 0x30, 0x23},
+		{0x4d, 0x90, 0xc3, 0xc1, 0x86, 0x66, 0x68, 0xf7, 0xc9, 0x5b, 0x03, 0x37, 0xe0, 0xbd, 0xdc, 0xcb,
+		 0xa8, 0x2e, 0x31, 0x68, 0xbe, 0x11, 0x71, 0x02, 0xef, 0xd8, 0x11, 0xf1, 0xd2, 0x5a, 0x71, 0x77}
+	},
+	{
+		{0xff, 0xc7, 0x68, 0x89, 0xea, 0xc8, 0x00, 0x9f, 0x4b, 0x50, 0xe3, 0xbd, 0x11, 0xe0, 0x02, 0xda,
+		 0x91, 0x14, 0xec, 0x3d, 0x1a, 0xa9, 0x7b, 0x0d, 0xd1, 0x16, 0x81, 0x0f, 0xe1, 0x0d, 0x77, 0x0a},
+		{0x45, 0xec, 0x88, 0x56, 0xf4, 0x1c, 0x3f, 0xa8, 0xdc, 0x8c, 0x7c, 0x9a, 0x54, 0xd1, 0x5c, 0xc0,
+		 0x4c, 0x6b, 0xb9, 0x27, 0xe4, 0x72, 0x3a, 0x04, 0xce, 0x23, 0x12, 0x82, 0x87, 0x8e, 0x32, 0x66},
+		{0xb3, 0x46, 0x60, 0xc3, 0xff, 0x21, 0xd5, 0xbe, 0x3f, 0x33, 0x59, 0xd4, 0x59, 0xc9, 0xe5, 0xa6,
+		 0x56, 0xc0, 0xa1, 0xf0, 0x73, 0x18, 0x7d, 0x10, 0x46, 0xcd, 0xde, 0x83, 0x13, 0x8b, 0x93, 0x6b}
+	},
+	{
+		{0x76, 0xa3, 0xa3, 0x30, 0x4a, 0xe0, 0x55, 0x99, 0x38, 0xa3, 0x84, 0x64, 0x20, 0xe3, 0xbe, 0x91,
+		 0xca, 0x6b, 0x85, 0xdb, 0x21, 0xe6, 0xd3, 0xd2, 0x56, 0x5f, 0x26, 0xb5, 0xa1, 0xc8, 0x55, 0x01},
+		{0x3f, 0x86, 0xc3, 0xcb, 0xe7, 0x4d, 0x2b, 0x61, 0x37, 0x6e, 0xca, 0xff, 0x73, 0x3d, 0x53, 0x1c,
+		 0x4e, 0xb3, 0x55, 0x9d, 0x26, 0xf0, 0xbb, 0x2e, 0x1a, 0xc9, 0x87, 0x3b, 0x53, 0x58, 0x6c, 0x53},
+		{0xe1, 0xeb, 0x29, 0x46, 0xff, 0xe9, 0xc2, 0x7b, 0x54, 0xdf, 0xb2, 0x2c, 0x72, 0xa9, 0x27, 0x59,
+		 0x1e, 0xa3, 0x15, 0x73, 0xf1, 0x68, 0x66, 0x24, 0x24, 0x0f, 0x75, 0x4b, 0xb2, 0xcf, 0x70, 0x5e}
+	},
+	{
+		{0x8c, 0xd5, 0xab, 0xc8, 0xe4, 0x0c, 0x5e, 0x2f, 0x51, 0xb6, 0x85, 0x9d, 0xf1, 0x6e, 0xf5, 0x4f,
+		 0xe6, 0xd8, 0xd7, 0xa9, 0xed, 0xb0, 0x26, 0x4a, 0xba, 0x53, 0xe3, 0xd4, 0xf4, 0x08, 0x3d, 0x44},
+		{0xd5, 0xb2, 0xa2, 0x10, 0x5d, 0xd9, 0x88, 0x81, 0x61, 0x7d, 0x19, 0xb6, 0x95, 0x8c, 0x69, 0xfd,
+		 0x53, 0xfb, 0x9d, 0x36, 0x8c, 0x6f, 0xd1, 0xc3, 0x19, 0x9a, 0x7a, 0x1b, 0xf9, 0x12, 0x44, 0x32},
+		{0x18, 0xe7, 0xa4, 0x6a, 0x92, 0xa4, 0xda, 0xce, 0x62, 0x5c, 0x68, 0x17, 0x5e, 0xee, 0xae, 0xd5,
+		 0xeb, 0x2b, 0xab, 0x84, 0x7e, 0xa2, 0x76, 0x33, 0x5a, 0xff, 0x11, 0xf2, 0x8f, 0x1d, 0xcb, 0x72}
+	},
+	{
+		{0x82, 0x45, 0xce, 0xc5, 0xa2, 0xa1, 0x7b, 0xe9, 0x0a, 0xbf, 0xa6, 0x29, 0x5a, 0xda, 0x09, 0xdf,
+		 0xd4, 0x9a, 0x4c, 0x1b, 0x3e, 0xa2, 0xab, 0x31, 0x34, 0x46, 0x96, 0xc0, 0x54, 0x77, 0xf2, 0x59},
+		{0xbf, 0x22, 0xed, 0x1c, 0x1a, 0xa5, 0xbc, 0x71, 0x2a, 0x06, 0x84, 0x5c, 0x26, 0x8e, 0x4c, 0xec,
+		 0x5e, 0xb1, 0x8e, 0x68, 0x14, 0x8d, 0x64, 0x74, 0xc2, 0x0e, 0x18, 0xa0, 0x30, 0x5b, 0xb0, 0x19},
+		{0x11, 0x4b, 0x2a, 0x78, 0x58, 0x74, 0xee, 0x1c, 0xc9, 0x86, 0xbd, 0x5d, 0x75, 0x4f, 0x2c, 0x41,
+		 0x46, 0x26, 0x39, 0x84, 0x34, 0x5b, 0xda, 0xfd, 0x1b, 0xee, 0xf0, 0x4e, 0x30, 0x15, 0xe5, 0x66}
+	}
+};
+#elif ED25519_BASE_COMB_TEETH == 6
+const uint8_t ed25519_base_comb[1 << ED25519_BASE_COMB_TEETH][3][F25519_SIZE] = {
+	{
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+		{0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}
+	},
+	{
+		{0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+		 0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21},
+		{0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66,
+		 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66},
+		{0xa3, 0xdd, 0xb7, 0xa5, 0xb3, 0x8a, 0xde, 0x6d, 0xf5, 0x52, 0x51, 0x77, 0x80, 0x9f, 0xf0, 0x20,
+		 0x7d, 0xe3, 0xab, 0x64, 0x8e, 0x4e, 0xea, 0x66, 0x65, 0x76, 0x8b, 0xd7, 0x0f, 0x5f, 0x87, 0x67}
+	},
+	{
+		{0x34, 0x5c, 0x13, 0xfb, 0xc0, 0xe3, 0x78, 0x2b, 0x54, 0x58, 0x22, 0x9b, 0x76, 0x81, 0x7f, 0x93,
+		 0x9c, 0x25, 0x3c, 0xd2, 0xe9, 0x96, 0x21, 0x26, 0x08, 0xf5, 0xed, 0x95, 0x11, 0xae, 0x04, 0x5a},
+		{0xb9, 0xe8, 0xc5, 0x12, 0x97, 0x1f, 0x83, 0xfe, 0x3e, 0x94, 0x99, 0xd4, 0x2d, 0xf9, 0x52, 0x59,
+		 0x5c, 0x82, 0xa6, 0xf0, 0x75, 0x7e, 0xe8, 0xec, 0xcc, 0xac, 0x18, 0x21, 0x09, 0x67, 0x66, 0x67},
+		{0xb1, 0x76, 0xaf, 0x60, 0x38, 0x2d, 0xf4, 0x62, 0xfb, 0x20, 0x65, 0xc1, 0x88, 0x3d, 0xcd, 0x89,
+		 0x6b, 0x92, 0x6a, 0x1a, 0xfa, 0x2e, 0x79, 0x0d, 0xa4, 0xf8, 0x74, 0xc9, 0x37, 0x41, 0x71, 0x3c}
+	},
+	{
+		{0x9b, 0xac, 0xfb, 0xd9, 0xa9, 0x01, 0x4a, 0x76, 0xe6, 0x5b, 0xa1, 0x74, 0xd7, 0x0c, 0x1c, 0xdd,
+		 0x05, 0x03, 0x9b, 0x5c, 0x6d, 0x54, 0xd9, 0x94, 0x62, 0x30, 0x47, 0x88, 0xf9, 0x39, 0xc8, 0x0b},
+		{0x9f, 0x97, 0x77, 0x7f, 0x6a, 0x87, 0x2a, 0xe0, 0xba, 0x66, 0xc9, 0x05, 0xec, 0x29, 0x89, 0x14,
+		 0x4a, 0xeb, 0x9b, 0xb2, 0x29, 0x86, 0x86, 0x7e, 0xf3, 0xbf, 0x15, 0xe6, 0x40, 0xc3, 0x07, 0x5a},
+		{0x46, 0xb0, 0xc5, 0x5f, 0xcb, 0x07, 0xac, 0x81, 0xee, 0x26, 0x32, 0x5d, 0xaa, 0x55, 0x9d, 0xd3,
+		 0x45, 0x68, 0xfe, 0xe4, 0x87, 0x2c, 0x4b, 0x05, 0x90, 0xa2, 0x99, 0x4f, 0xf3, 0x59, 0x2d, 0x73}
+	},
+	{
+		{0xbd, 0x00, 0xb9, 0x04, 0x7d, 0x35, 0xfc, 0xeb, 0xd0, 0x0b, 0x05, 0x32, 0x52, 0x7a, 0x89, 0x24,
+		 0x75, 0x50, 0xe1, 0x63, 0x02, 0x82, 0x8e, 0xe7, 0x85, 0x0c, 0xf2, 0x56, 0x44, 0x37, 0x83, 0x25},
+		{0x8f, 0xa1, 0xce, 0xcb, 0x60, 0xda, 0x12, 0x02, 0x1e, 0x29, 0x39, 0x2a, 0x03, 0xb7, 0xeb, 0x77,
+		 0x40, 0xea, 0xc9, 0x2b, 0x2c, 0xd5, 0x7d, 0x7e, 0x2c, 0xc7, 0x5a, 0xfd, 0xff, 0xc4, 0xd1, 0x62},
+		{0x4f, 0x83, 0x6c, 0x39, 0x7d, 0x3a, 0x64, 0xf5, 0x66, 0x26, 0x98, 0xaf, 0x23, 0x08, 0x0b, 0x2e,
+		 0xbb, 0xa7, 0x94, 0xa3, 0x23, 0xf7, 0xbf, 0x4b, 0x80, 0x7c, 0xc2, 0x69, 0x01, 0x05, 0xaf, 0x18}
+	},
+	{
+		{0x31, 0x11, 0x21, 0x85, 0x10, 0x06, 0x47, 0xe1, 0xba, 0x36, 0x0c, 0x2f, 0x97, 0xc5, 0xcd, 0xbe,
+		 0x10, 0xcc, 0x0a, 0x7b, 0x3a, 0xe2, 0xf5, 0xac, 0xc3, 0x7a, 0xeb, 0x7d, 0xe3, 0x91, 0xa8, 0x1e},
+		{0x4b, 0x9f, 0x7d, 0x61, 0xb5, 0xb9, 0xb3, 0x32, 0xd3, 0xd6, 0x15, 0xaf, 0x31, 0x0c, 0x01, 0x94,
+		 0xf1, 0x08, 0x58, 0xb6, 0x36, 0x2c, 0x98, 0xf0, 0xec, 0x5b, 0x15, 0x27, 0x77, 0x7c, 0x25, 0x54},
+		{0x18, 0xaf, 0x10, 0x15, 0xd5, 0xfd, 0xdd, 0x9f, 0x0d, 0x12, 0x8d, 0x6e, 0xff, 0xa3, 0x37, 0x9e,
+		 0xca, 0x53, 0x00, 0x6a, 0x74, 0x02, 0xb6, 0x1c, 0xcb, 0xe4, 0x68, 0x13, 0x48, 0x7b, 0xb8, 0x1d}
+	},
+	{
+		{0x64, 0x59, 0xb0, 0xae, 0xc9, 0xec, 0x9b, 0xd1, 0xe2, 0x37, 0x9d, 0x7b, 0x54, 0x59, 0x50, 0xeb,
+		 0x1d, 0x16, 0xe8, 0x37, 0x92, 0x03, 0xb2, 0xbb, 0x9d, 0xc1, 0xa3, 0xaa, 0x30, 0x13, 0x09, 0x5f},
+		{0xee, 0x1d, 0x24, 0x74, 0xa0, 0x94, 0xad, 0x80, 0xfe, 0xfb, 0xbc, 0x70, 0xaf, 0xe3, 0xb8, 0x3d,
+		 0xdc, 0xa2, 0x90, 0xfd, 0xe8, 0xb8, 0xfc, 0xf8, 0xd3, 0x2b, 0x9e, 0x61, 0x3d, 0xe3, 0x7f, 0x28},
+		{0xbf, 0x16, 0x3f, 0xcf, 0xdd, 0x70, 0xea, 0x86, 0xe5, 0x23, 0xf4, 0x84, 0x60, 0xbf, 0x30, 0xdd,
+		 0xb7, 0x59, 0x56, 0xba, 0xe5, 0xf7, 0x83, 0x06, 0x0f, 0x1c, 0xb9, 0x50, 0x02, 0xd8, 0xb7, 0x5a}
+	},
+	{
+		{0xeb, 0x8a, 0xda, 0xda, 0x17, 0x29, 0x26, 0x91, 0xcc, 0x3a, 0xe4, 0x6c, 0x3f, 0x48, 0x4c, 0xd8,
+		 0x7e, 0x1d, 0x49, 0xd9, 0xf4, 0x39, 0x08, 0x0b, 0x2f, 0x07, 0x3d, 0x74, 0x33, 0x0e, 0x77, 0x7e},
+		{0xc3, 0x83, 0x1a, 0x60, 0xe5, 0xde, 0x2d, 0x25, 0x05, 0xb0, 0x6f, 0x51, 0x5e, 0x27, 0xea, 0xea,
+		 0xca, 0xbe, 0x53, 0x5f, 0x82, 0xf7, 0x10, 0x28, 0xaf, 0x09, 0xef, 0xa4, 0xb5, 0xfc, 0xa1, 0x28},
+		{0x02, 0x45, 0x95, 0xd2, 0x9b, 0x95, 0x99, 0xeb, 0x96, 0x9f, 0xba, 0xf8, 0xe6, 0xa3, 0x30, 0x82,
+		 0xa1, 0xfd, 0xd4, 0x90, 0xe4, 0x34, 0x96, 0xea, 0xcb, 0x22, 0x00, 0x04, 0x96, 0x7b, 0x13, 0x49}
+	},
+	{
+		{0x85, 0xe0, 0x24, 0x32, 0xb4, 0xd1, 0xef, 0xfc, 0x69, 0xa2, 0xbf, 0x8f, 0x72, 0x2c, 0x95, 0xf6,
+		 0xe4, 0x6e, 0x7d, 0x90, 0xf7, 0x57, 0x81, 0xa0, 0xf7, 0xda, 0xef, 0x33, 0x07, 0xe3, 0x6b, 0x78},
+		{0x36, 0x27, 0x3e, 0xc6, 0x12, 0x07, 0xab, 0x4e, 0xbe, 0x69, 0x9d, 0xb3, 0xbe, 0x08, 0x7c, 0x2a,
+		 0x47, 0x08, 0xfd, 0xd4, 0xcd, 0x0e, 0x27, 0x34, 0x5b, 0x98, 0x34, 0x2f, 0x77, 0x5f, 0x3a, 0x65},
+		{0xc8, 0x64, 0x9f, 0x71, 0x17, 0xe8, 0xc4, 0x00, 0x6e, 0xbd, 0xba, 0x57, 0x55, 0xee, 0xc4, 0x96,
+		 0xec, 0xd8, 0xd3, 0x5b, 0x9a, 0x66, 0x90, 0x0d, 0x8b, 0x3e, 0x31, 0x4d, 0xd3, 0x3e, 0xc7, 0x12}
+	},
+	{
+		{0x08, 0x0b, 0xae, 0x2f, 0x73, 0x1b, 0x55, 0xc3, 0x48, 0xb5, 0xd4, 0x30, 0x4e, 0xbf, 0x3e, 0xd7,
+		 0x76, 0xf2, 0x5b, 0x21, 0x6f, 0x1d, 0x67, 0x55, 0x60, 0x52, 0xa8, 0x4d, 0xe4, 0xc6, 0xec, 0x65},
+		{0x2e, 0xac, 0xf0, 0x09, 0x06, 0xaa, 0x07, 0x49, 0xfd, 0x3d, 0x44, 0x13, 0x89, 0xd6, 0x18, 0xa0,
+		 0xc4, 0xc7, 0x49, 0xde, 0x1f, 0xe4, 0x3e, 0x75, 0xa2, 0xb3, 0x40, 0x58, 0x27, 0x0b, 0x66, 0x37},
+		{0xae, 0x75, 0xc2, 0x2b, 0x5b, 0xa8, 0xcc, 0x5f, 0xbf, 0x81, 0x81, 0x9b, 0xd9, 0x81, 0xe6, 0x25,
+		 0x24, 0x62, 0x27, 0x83, 0x8a, 0x2b, 0x7b, 0xa8, 0x46, 0x41, 0x81, 0xee, 0x17, 0x72, 0x1e, 0x1e}
+	},
+	{
+		{0x4a, 0xa0, 0x9b, 0x7a, 0x1a, 0xd8, 0x23, 0xa0, 0xd0, 0x04, 0x76, 0xb1, 0xe6, 0xa7, 0x52, 0x65,
+		 0x4f, 0x00, 0x3d, 0x74, 0x08, 0x41, 0xa4, 0x5d, 0x45, 0x59, 0xfb, 0xb1, 0x2e, 0x62, 0xc9, 0x53},
+		{0x20, 0xcd, 0xd1, 0x56, 0xe0, 0x1d, 0xe0, 0x8f, 0xec, 0x68, 0x4c, 0x17, 0x0f, 0x91, 0x2d, 0xea,
+		 0x62, 0xbe, 0x64, 0x02, 0x48, 0xd9, 0xce, 0x94, 0x33, 0xd2, 0x92, 0x88, 0xef, 0xd1, 0x7d, 0x27},
+		{0x06, 0xf3, 0xcd, 0xcc, 0x39, 0x76, 0xaf, 0x71, 0x58, 0x0c, 0x98, 0x5f, 0x10, 0x9c, 0x24, 0x6e,
+		 0x15, 0x0e, 0x01, 0x87, 0x4c, 0x15, 0x98, 0xc5, 0xb1, 0x5b, 0x7c, 0x6d, 0x49, 0x66, 0x74, 0x50}
+	},
+	{
+		{0x10, 0x5f, 0xbd, 0x53, 0x5c, 0x78, 0x07, 0x8e, 0x4a, 0xb2, 0xd3, 0x68, 0xff, 0x39, 0x34, 0xf5,
+		 0xff, 0x39, 0x4e, 0x05, 0x52, 0x77, 0x58, 0x38, 0x05, 0x26, 0x00, 0xc7, 0x2a, 0x9f, 0xa5, 0x64},
+		{0x75, 0x43, 0xd2, 0xfc, 0x5e, 0x08, 0x46, 0xc4, 0x11, 0x58, 0x7b, 0x04, 0xa4, 0x32, 0xe3, 0x63,
+		 0xfe, 0x7d, 0xbd, 0x3b, 0x75, 0xae, 0x6b, 0x64, 0xf8, 0xd4, 0xbf, 0x98, 0x57, 0xbe, 0x67, 0x63},
+		{0xf5, 0x30, 0x03, 0xe9, 0x4d, 0x13, 0x30, 0xb9, 0xba, 0x8e, 0x7c, 0x26, 0x63, 0xa7, 0xf8, 0x7b,
+		 0xd6, 0x60, 0x7e, 0xe4, 0x55, 0xa3, 0xf2, 0xac, 0x30, 0x7b, 0x06, 0x93, 0x56, 0x0e, 0x26, 0x65}
+	},
+	{
+		{0xf1, 0x92, 0xe7, 0x74, 0x84, 0x58, 0x9e, 0x3b, 0xc3, 0x51, 0x39, 0xa1, 0xc6, 0x64, 0xa6, 0x43,
+		 0x5a, 0x64, 0xa0, 0x87, 0x3f, 0x7b, 0xda, 0xff, 0xd6, 0xdf, 0x1a, 0x10, 0x23, 0xe6, 0x81, 0x4d},
+		{0x0c, 0x2e, 0xdc, 0x1c, 0xc4, 0x40, 0xb2, 0x67, 0xc7, 0x51, 0xdc, 0xf5, 0xa9, 0xeb, 0x16, 0x39,
+		 0xfd, 0x05, 0x11, 0x3a, 0x10, 0x51, 0x9e, 0x38, 0x66, 0x1f, 0x6b, 0x5c, 0x25, 0xcd, 0x69, 0x60},
+		{0x46, 0x95, 0xea, 0x26, 0xd9, 0x57, 0xb8, 0xad, 0x73, 0x65, 0xdd, 0x5d, 0xb8, 0xf4, 0xb7, 0xb2,
+		 0x0a, 0xa1, 0xfd, 0x6f, 0xe6, 0x29, 0xe4, 0x15, 0x7b, 0x19, 0x8c, 0xb0, 0x58, 0x23, 0xe1, 0x05}
+	},
+	{
+		{0x60, 0x84, 0x0c, 0x2d, 0x05, 0xcf, 0x4d, 0xf8, 0xf6, 0x0d, 0x01, 0x33, 0xfd, 0x31, 0x32, 0x5c,
+		 0x47, 0x14, 0x97, 0x76, 0xcb, 0x4c, 0x8d, 0x7f, 0x53, 0x1e, 0xbb, 0x4b, 0x7b, 0x60, 0xe9, 0x64},
+		{0x2a, 0xa0, 0x52, 0xc3, 0xeb, 0x46, 0x7b, 0xd8, 0x9b, 0xb7, 0xbb, 0x58, 0x08, 0x2c, 0x4b, 0x4d,
+		 0xbd, 0x45, 0x76, 0x67, 0xbc, 0x1e, 0x15, 0x7f, 0xcc, 0x80, 0x8f, 0x9a, 0xfa, 0x04, 0xbe, 0x3f},
+		{0xa4, 0xcd, 0xbd, 0x9f, 0x36, 0x62, 0xc8, 0x19, 0x57, 0x46, 0x41, 0xdd, 0x6b, 0x30, 0x3b, 0xe2,
+		 0xef, 0x5f, 0xa5, 0x46, 0x74, 0xb9, 0xf7, 0x81, 0xd2, 0xcb, 0x41, 0x85, 0x11, 0x64, 0xb6, 0x5d}
+	},
+	{
+		{0x5d, 0xbd, 0x5b, 0x97, 0x69, 0x75, 0x36, 0xfe, 0x4a, 0xba, 0x16, 0xff, 0xae, 0xf3, 0x65, 0xb3,
+		 0x63, 0xd1, 0x49, 0x5f, 0x30, 0x2f, 0x2e, 0xd4, 0x59, 0xca, 0x1e, 0x7a, 0x1e, 0xe5, 0xb7, 0x15},
+		{0xf0, 0x48, 0xad, 0x5a, 0x3c, 0x07, 0x07, 0xbc, 0x7d, 0x77, 0xc3, 0xd1, 0x26, 0xd0, 0xf2, 0xf6,
+		 0x53, 0x2d, 0xdf, 0xe8, 0x0d, 0x2d, 0xf5, 0x65, 0x99, 0x77, 0xd9, 0xa7, 0x4d, 0x62, 0xf8, 0x3b},
+		{0xcb, 0x61, 0x65, 0x34, 0xb1, 0xdc, 0x53, 0x8d, 0xb6, 0x09, 0x7d, 0x7f, 0x8a, 0x26, 0xf8, 0xd9,
+		 0xdb, 0xfc, 0xff, 0x1e, 0x0a, 0xca, 0xf6, 0xb5, 0xd0, 0xec, 0x04, 0x89, 0xd3, 0x8d, 0x98, 0x2c}
+	},
+	{
+		{0x61, 0x02, 0x58, 0x3c, 0xde, 0xb0, 0xc4, 0xbd, 0xb7, 0x57, 0x86, 0xcc, 0xa6, 0x7c, 0x87, 0x05,
+		 0x3e, 0x86, 0xfa, 0xaf, 0xcb, 0x59, 0x90, 0xb0, 0x37, 0x65, 0x42, 0xbe, 0xa8, 0xfb, 0xc1, 0x57},
+		{0x7e, 0x70, 0x22, 0x19, 0x1c, 0xc4, 0x7e, 0x31, 0xf0, 0x62, 0x03, 0x7c, 0x93, 0x7e, 0xfc, 0xda,
+		 0x0b, 0x81, 0x18, 0xbe, 0x09, 0x8e, 0xf8, 0x33, 0xb8, 0xaf, 0x56, 0x43, 0xeb, 0xcf, 0x2b, 0x50},
+		{0xc1, 0xce, 0xd6, 0x3b, 0x87, 0x91, 0x82, 0x4c, 0x45, 0x52, 0x40, 0xe9, 0xa6, 0xe9, 0x24, 0xff,
+		 0x9d, 0xc1, 0x2c, 0x14, 0xa6, 0xfb, 0x70, 0x7e, 0x59, 0x24, 0xf6, 0x16, 0x5b, 0x3a, 0xe3, 0x76}
+	},
+	{
+		{0x7b, 0xaa, 0x70, 0x0a, 0x4b, 0xfb, 0xf5, 0xbf, 0x80, 0xc5, 0xcf, 0x08, 0x7a, 0xdd, 0xa1, 0xf4,
+		 0x9d, 0x54, 0x50, 0x53, 0x23, 0x77, 0x23, 0xf5, 0x34, 0xa5, 0x22, 0xd1, 0x0d, 0x96, 0x2e, 0x47},
+		{0xcc, 0xb7, 0x32, 0x89, 0x57, 0xd0, 0x98, 0x75, 0xe4, 0x37, 0x99, 0xa9, 0xe8, 0xba, 0xed, 0xba,
+		 0xeb, 0xc7, 0x4f, 0x15, 0x76, 0x07, 0x0c, 0x4c, 0xef, 0x9f, 0x52, 0xfc, 0x04, 0x5d, 0x58, 0x10},
+		{0x60, 0x14, 0x98, 0x8e, 0x15, 0x04, 0x29, 0x13, 0xa5, 0xc8, 0xf8, 0x21, 0xb2, 0x9d, 0x2d, 0xa9,
+		 0xc9, 0xdc, 0xe5, 0x74, 0x66, 0x3d, 0x13, 0xc6, 0xcc, 0x57, 0x2b, 0xd0, 0x4d, 0x71, 0x14, 0x10}
+	},
+	{
+		{0x40, 0x7f, 0x50, 0x07, 0x6f, 0x6d, 0x55, 0x05, 0x0e, 0x23, 0x67, 0x1e, 0xd6, 0x95, 0xc4, 0x51,
+		 0xa1, 0xb2, 0x6a, 0xfe, 0xf8, 0x43, 0x70, 0x92, 0x13, 0x64, 0x66, 0x19, 0xe1, 0xc5, 0xd0, 0x45},
+		{0xf9, 0x5a, 0xbd, 0x0b, 0xf7, 0x8f, 0x2d, 0x7f, 0x91, 0x52, 0xf4, 0x83, 0x41, 0x68, 0x70, 0x6d,
+		 0x7e, 0x18, 0x50, 0x92, 0x5c, 0x3c, 0x13, 0x6b, 0x50, 0x55, 0xb2, 0xde, 0x7a, 0x97, 0xc3, 0x58},
+		{0x98, 0x25, 0xe4, 0x87, 0x8c, 0x8a, 0x74, 0x3c, 0x0c, 0x6b, 0x51, 0xc9, 0xa6, 0x9e, 0xa5, 0x9e,
+		 0x03, 0x79, 0xd0, 0x69, 0x6c, 0xb8, 0xc6, 0xae, 0x76, 0xff, 0xb5, 0x31, 0xe9, 0xee, 0xd8, 0x05}
+	},
+	{
+		{0x68, 0x57, 0x39, 0xa2, 0xa3, 0x97, 0x57, 0xe3, 0x21, 0xe4, 0x35, 0x2e, 0x8f, 0x39, 0x90, 0x79,
+		 0x75, 0x2f, 0xe8, 0x9a, 0x89, 0x78, 0xda, 0xa2, 0x7a, 0x9f, 0x35, 0x8d, 0xe6, 0x59, 0xe9, 0x39},
+		{0xde, 0xca, 0xd0, 0xf2, 0xd9, 0xc6, 0xc8, 0x25, 0x78, 0x0b, 0x6d, 0x8b, 0xb0, 0x14, 0xce, 0x94,
+		 0x88, 0x5c, 0xf2, 0xa3, 0x00, 0x65, 0xdc, 0x20, 0xf8, 0x85, 0xbb, 0x4f, 0xf1, 0xff, 0xb9, 0x41},
+		{0x16, 0xf9, 0x5d, 0x10, 0x5f, 0x84, 0x23, 0xaf, 0x7a, 0x13, 0xc7, 0x91, 0x68, 0x32, 0x44, 0xe4,
+		 0x10, 0xa5, 0x96, 0x09, 0xe0, 0x5e, 0x1a, 0x7c, 0x55, 0xc4, 0x71, 0x86, 0x05, 0xac, 0xbd, 0x7d}
+	},
+	{
+		{0x63, 0x9a, 0xea, 0xff, 0x88, 0xdf, 0xdb, 0xc1, 0xfe, 0xf0, 0x5f, 0xd7, 0xe4, 0x0f, 0xa8, 0x53,
+		 0xf7, 0x80, 0xa5, 0xfe, 0x47, 0x84, 0x0d, 0x62, 0x02, 0x3f, 0x4d, 0x99, 0xcd, 0x25, 0x19, 0x2a},
+		{0x68, 0xa1, 0x6d, 0xf9, 0x48, 0x84, 0x35, 0x78, 0x38, 0x12, 0x88, 0x73, 0x72, 0xff, 0x81, 0xe6,
+		 0xc4, 0xf8, 0x6e, 0x3c, 0xd5, 0xca, 0xe4, 0x56, 0x58, 0x59, 0x02, 0x08, 0x7a, 0xf8, 0x3c, 0x6a},
+		{0x18, 0x2d, 0x51, 0x61, 0xf9, 0xa8, 0xf6, 0x20, 0x3e, 0x8c, 0xed, 0xc1, 0x56, 0xe3, 0x74, 0xe6,
+		 0xf4, 0xae, 0xc6, 0x27, 0x4f, 0xc6, 0x5a, 0xf1, 0x40, 0xde, 0xef, 0xb6, 0xe7, 0x20, 0xda, 0x1d}
+	},
+	{
+		{0xd4, 0xc1, 0x0b, 0x14, 0x89, 0x41, 0xba, 0x55, 0x6a, 0x40, 0x6a, 0x46, 0xbe, 0xa2, 0xcd, 0x9c,
+		 0x9a, 0xcf, 0xcd, 0x7f, 0x3b, 0xd7, 0xb2, 0x93, 0xaf, 0x7e, 0x36, 0x78, 0x24, 0x9b, 0xc6, 0x67},
+		{0xe4, 0xaa, 0x4b, 0x3a, 0x4a, 0x64, 0x8b, 0x31, 0x75, 0x3a, 0x7b, 0xd2, 0xd3, 0x2c, 0x02, 0xbe,
+		 0x41, 0xe3, 0x14, 0x3f, 0x0e, 0xcf, 0x49, 0x4c, 0xfc, 0x79, 0x79, 0xde, 0xf5, 0x25, 0x3c, 0x13},
+		{0x51, 0xf0, 0x48, 0x01, 0xdd, 0xfd, 0xbe, 0x3f, 0xf3, 0xd2, 0x77, 0xbe, 0xda, 0xef, 0xa7, 0xc7,
+		 0xc1, 0x09, 0x2e, 0x77, 0xe0, 0xab, 0x3d, 0xd0, 0x19, 0x20, 0x23, 0x29, 0x86, 0xeb, 0xa0, 0x27}
+	},
+	{
+		{0xe3, 0x18, 0x41, 0x36, 0x3c, 0xee, 0x51, 0xc0, 0x8a, 0x2b, 0x3b, 0x16, 0xbd, 0xbd, 0xd5, 0x73,
+		 0xa3, 0x55, 0x2e, 0x27, 0x89, 0xdf, 0x83, 0x3a, 0x66, 0x9b, 0x35, 0x4b, 0xc9, 0xe9, 0x2c, 0x29},
+		{0x56, 0x58, 0x02, 0xfe, 0xa6, 0x54, 0xf3, 0xe0, 0x67, 0x3d, 0x36, 0x91, 0x2b, 0x66, 0x27, 0x2c,
+		 0xe3, 0xf2, 0xd0, 0xbe, 0x0d, 0x95, 0x4b, 0xcb, 0xe2, 0x46, 0x7e, 0x21, 0x4e, 0x8d, 0x02, 0x44},
+		{0xd6, 0x75, 0x4a, 0xc5, 0xd7, 0x10, 0xe9, 0xe7, 0x4a, 0x0a, 0x55, 0x93, 0xe7, 0x74, 0x3a, 0x15,
+		 0xf7, 0xee, 0x5d, 0xac, 0xc1, 0x6c, 0x03, 0x87, 0xba, 0x97, 0x29, 0x31, 0x10, 0x73, 0x69, 0x70}
+	},
+	{
+		{0x39, 0x34, 0x48, 0x08, 0xff, 0x7d, 0xc4, 0xd3, 0xd5, 0x29, 0xcf, 0x17, 0xa0, 0x85, 0x44, 0x73,
+		 0x06, 0x5d, 0x92, 0xce, 0xb4, 0x8c, 0xec, 0x45, 0x80, 0x0b, 0xd9, 0x6d, 0xc2, 0x40, 0xc3, 0x68},
+		{0xcb, 0x4a, 0x89, 0x77, 0x94, 0xc5, 0x8f, 0x17, 0xc7, 0x9b, 0x0b, 0xe5, 0x9d, 0xf2, 0xab, 0x1a,
+		 0x54, 0x3e, 0x45, 0x05, 0x39, 0x7a, 0x2e, 0x95, 0xac, 0x66, 0x87, 0x0e, 0x32, 0x80, 0xb2, 0x62},
+		{0x38, 0x77, 0xc6, 0x50, 0x58, 0x79, 0xc2, 0x07, 0x09, 0x2e, 0x43, 0x01, 0xb8, 0x17, 0xcb, 0xe1,
+		 0xfd, 0xfa, 0xf9, 0x80, 0xe9, 0x64, 0x40, 0x86, 0x7f, 0x79, 0xaf, 0xcb, 0xec, 0xca, 0x4a, 0x18}
+	},
+	{
+		{0xe4, 0xca, 0xa0, 0xb3, 0x86, 0x55, 0x21, 0x48, 0xe7, 0xf1, 0xd6, 0x5a, 0x76, 0x46, 0x72, 0x3c,
+		 0xd8, 0x46, 0x94, 0x78, 0xae, 0xa3, 0xed, 0x5f, 0xfd, 0x47, 0x6e, 0xde, 0x13, 0x36, 0x47, 0x6d},
+		{0x2c, 0xcb, 0xb9, 0x54, 0x22, 0x55, 0x80, 0x9e, 0xd8, 0xaa, 0xd7, 0x07, 0x0f, 0x9c, 0xcd, 0x36,
+		 0xf1, 0x86, 0x44, 0x36, 0xe8, 0xd6, 0x48, 0x21, 0x67, 0x3f, 0x28, 0x45, 0x60, 0xf2, 0xfd, 0x12},
+		{0x3e, 0x95, 0x7b, 0x7b, 0x9d, 0x4a, 0xcd, 0xb8, 0x6f, 0x40, 0x8c, 0xbf, 0x30, 0x8f, 0x58, 0x19,
+		 0x7c, 0x1b, 0xcf, 0x88, 0x36, 0xac, 0x76, 0xe8, 0x1c, 0x43, 0x62, 0x80, 0x8f, 0x07, 0x88, 0x63}
+	},
+	{
+		{0x3d, 0xbc, 0x4d, 0x09, 0x24, 0x27, 0xb7, 0x6f, 0xd9, 0xe3, 0x64, 0x72, 0x59, 0x7c, 0x54, 0x35,
+		 0xa1, 0x82, 0x65, 0x16, 0x60, 0x7d, 0x26, 0x20, 0x04, 0x77, 0xf6, 0x42, 0xc7, 0x99, 0xb9, 0x1f},
+		{0xac, 0x06, 0xee, 0x2f, 0xf7, 0xd0, 0xe2, 0xc6, 0x47, 0x0a, 0xa3, 0x81, 0x40, 0x4f, 0x8b, 0xef,
+		 0x2b, 0xb6, 0xe8, 0x05, 0x83, 0x08, 0xde, 0xed, 0xa4, 0xa7, 0xde, 0x46, 0xb7, 0xc0, 0x47, 0x62},
+		{0x61, 0x56, 0xbc, 0x8a, 0x2f, 0x68, 0x54, 0xaf, 0x7c, 0x22, 0x70, 0x1e, 0x5f, 0x2d, 0x3f, 0xa5,
+		 0x27, 0x7f, 0xbe, 0x9f, 0x49, 0xfd, 0x3d, 0xac, 0xed, 0xe1, 0x98, 0xf4, 0x79, 0xf9, 0xab, 0x0e}
+	},
+	{
+		{0x91, 0x4b, 0x7d, 0x92, 0x81, 0x1c, 0x5a, 0x9c, 0x02, 0x57, 0x38, 0x07, 0x88, 0x81, 0xdc, 0x88,
+		 0xc5, 0xec, 0x10, 0x7e, 0x50, 0x29, 0xec, 0x7a, 0x4e, 0xa8, 0x55, 0x39, 0x43, 0xed, 0xde, 0x57},
+		{0xa2, 0xc2, 0x76, 0x02, 0xfd, 0xb6, 0xf5, 0x98, 0x9c, 0x08, 0x2a, 0xb0, 0x31, 0x65, 0x66, 0xfe,
+		 0xa9, 0xdd, 0x44, 0xca, 0x44, 0x7e, 0x24, 0xcd, 0xdb, 0x3c, 0x0c, 0xef, 0x40, 0x5c, 0xa4, 0x36},
+		{0xaa, 0x0f, 0x95, 0xac, 0xda, 0x8d, 0xf7, 0xdb, 0x97, 0xba, 0x85, 0x42, 0x91, 0xe6, 0x56, 0x6c,
+		 0xcd, 0xc5, 0x6b, 0xad, 0x81, 0x48, 0xa4, 0x99, 0x5e, 0xe0, 0xef, 0xaf, 0xa3, 0xe8, 0x34, 0x3c}
+	},
+	{
+		{0x11, 0x91, 0x8d, 0x27, 0xab, 0x69, 0xd8, 0x80, 0xff, 0x06, 0xdb, 0xdd, 0xe0, 0x8d, 0x30, 0x3e,
+		 0xd3, 0xa1, 0x28, 0x44, 0xa7, 0x1d, 0x75, 0x54, 0x42, 0xc9, 0xa7, 0x85, 0xd5, 0x52, 0x01, 0x51},
+		{0x4f, 0x11, 0x28, 0xbe, 0x62, 0xc1, 0x97, 0x53, 0x2f, 0xb5, 0xce, 0xde, 0x8c, 0x11, 0xb0, 0x87,
+		 0x08, 0x95, 0xd5, 0x07, 0x05, 0xca, 0x50, 0x99, 0x27, 0x05, 0xfe, 0x22, 0x92, 0x36, 0x1c, 0x31},
+		{0xd8, 0x20, 0x99, 0x91, 0xfb, 0x21, 0x7e, 0xbf, 0xde, 0xf2, 0x8d, 0x4f, 0xb0, 0x14, 0x6b, 0x79,
+		 0xc3, 0x23, 0x6d, 0x53, 0xc7, 0x59, 0xee, 0x6d, 0xfb, 0x6e, 0x82, 0x51, 0x59, 0x95, 0xd1, 0x73}
+	},
+	{
+		{0x1d, 0x87, 0x1a, 0x3e, 0x6a, 0xa8, 0x30, 0xc4, 0x32, 0x78, 0x99, 0xc5, 0xc1, 0xc3, 0x6a, 0xa7,
+		 0x87, 0x3b, 0xcb, 0x82, 0xe4, 0x23, 0x32, 0xd2, 0x57, 0x1b, 0x5b, 0x84, 0xe4, 0xcf, 0xab, 0x79},
+		{0x76, 0xf6, 0xf0, 0x35, 0x6d, 0xf0, 0x50, 0x70, 0xb2, 0xcd, 0xd7, 0xb3, 0xf1, 0xc9, 0x26, 0x27,
+		 0xef, 0x33, 0xd5, 0xde, 0x72, 0xe5, 0x98, 0xfc, 0x39, 0xc7, 0x48, 0x04, 0x42, 0x46, 0x44, 0x5a},
+		{0xf3, 0x27, 0xd8, 0x35, 0xb5, 0xbd, 0xf3, 0x63, 0x22, 0xe5, 0xcb, 0x94, 0x34, 0x3e, 0x2d, 0xf5,
+		 0x9e, 0x33, 0xf5, 0x9f, 0x00, 0x94, 0xf1, 0xe4, 0xc5, 0x37, 0x89, 0xdd, 0x90, 0xce, 0xd9, 0x67}
+	},
+	{
+		{0x7b, 0x8c, 0xe1, 0x4d, 0x7c, 0x84, 0xe4, 0x65, 0x00, 0xbe, 0xde, 0xc9, 0xaa, 0x43, 0x7a, 0x2f,
+		 0xa8, 0xff, 0x4f, 0xbc, 0xec, 0x9c, 0xf4, 0x97, 0x8b, 0xa6, 0xa8, 0xd7, 0x0d, 0x0b, 0xe6, 0x58},
+		{0x63, 0x88, 0xa2, 0x9c, 0x30, 0x9e, 0xe4, 0x0b, 0x62, 0xc1, 0xa4, 0xd5, 0x06, 0xaa, 0x5b, 0xc4,
+		 0x55, 0x0c, 0x83, 0xe5, 0x0b, 0xa3, 0xf6, 0x89, 0x90, 0xba, 0xa3, 0x16, 0xa8, 0xeb, 0x69, 0x44},
+		{0x9c, 0x43, 0x8c, 0xbe, 0xb4, 0x28, 0x44, 0x84, 0x6f, 0xc1, 0xd8, 0x20, 0xa1, 0x87, 0x76, 0x88,
+		 0x63, 0xde, 0xdd, 0xba, 0xe0, 0x95, 0x77, 0x98, 0x73, 0xdf, 0x55, 0x2f, 0x1d, 0x48, 0x64, 0x30}
+	},
+	{
+		{0x88, 0x1a, 0x40, 0x20, 0x49, 0x9d, 0xd1, 0x36, 0x90, 0x00, 0xc1, 0x68, 0xf5, 0x89, 0xec, 0x3b,
+		 0x36, 0x33, 0xb7, 0xb6, 0x4b, 0x81, 0x16, 0x7e, 0x68, 0x56, 0x4c, 0x48, 0x16, 0x5b, 0xd4, 0x05},
+		{0x2e, 0x1a, 0x1a, 0xca, 0x24, 0xeb, 0xf5, 0x7a, 0xed, 0x58, 0xe5, 0xf3, 0x41, 0xb9, 0x40, 0xdc,
+		 0xb2, 0x1d, 0x94, 0x27, 0xa3, 0xa2, 0x18, 0xb8, 0x2e, 0x60, 0x27, 0x13, 0xe0, 0x8c, 0xb6, 0x27},
+		{0x2c, 0x40, 0xcf, 0x59, 0x94, 0xf2, 0x8e, 0x8d, 0x4c, 0xfa, 0x07, 0xf8, 0x39, 0x08, 0x72, 0xd4,
+		 0x15, 0xa6, 0xc0, 0x94, 0x87, 0x14, 0x43, 0x56, 0x8a, 0x98, 0xbe, 0xa5, 0x85, 0x8d, 0xd2, 0x59}
+	},
+	{
+		{0xd6, 0x26, 0x17, 0xa9, 0x78, 0x70, 0xd3, 0x7f, 0x60, 0x33, 0x91, 0x3a, 0xaf, 0xf9, 0x32, 0xda,
+		 0x76, 0x84, 0x02, 0x0d, 0x4c, 0x6d, 0xdb, 0x82, 0xf2, 0xb6, 0xbb, 0xa8, 0x69, 0x4c, 0x55, 0x13},
+		{0xa8, 0xbd, 0x27, 0x1d, 0x2e, 0x0b, 0xf5, 0x0e, 0xab, 0xf0, 0xf3, 0xc8, 0xf0, 0x07, 0xe6, 0x7d,
+		 0xef, 0xe2, 0xb9, 0x85, 0xf0, 0xe9, 0xbb, 0x83, 0x07, 0xe0, 0x34, 0xfb, 0x85, 0x4d, 0x05, 0x06},
+		{0x70, 0x07, 0xec, 0xc5, 0x91, 0x8e, 0xe7, 0xcf, 0x31, 0x9b, 0x4d, 0x55, 0x23, 0x28, 0x94, 0x57,
+		 0xfc, 0x39, 0x5f, 0x24, 0x14, 0x75, 0x96, 0x84, 0x23, 0x56, 0xcb, 0xfc, 0x2a, 0x30, 0xa7, 0x0f}
+	},
+	{
+		{0xb1, 0x54, 0x05, 0xf1, 0xa8, 0x71, 0xdf, 0xb3, 0x5e, 0x90, 0xa7, 0xb5, 0x2c, 0x2d, 0x99, 0x23,
+		 0xaf, 0xcf, 0x9c, 0xfe, 0x15, 0xbb, 0x89, 0xc9, 0xee, 0xe6, 0x88, 0x45, 0xa7, 0x65, 0x35, 0x40},
+		{0x31, 0x78, 0xa3, 0x36, 0xd6, 0xac, 0xc4, 0xf5, 0x44, 0x88, 0x9d, 0xcb, 0xde, 0x6b, 0x27, 0x1f,
+		 0x51, 0x80, 0x67, 0xf9, 0x25, 0xbf, 0x65, 0x86, 0xdb, 0xcf, 0x30, 0x54, 0x4b, 0xf5, 0xa0, 0x4b},
+		{0x6a, 0x4e, 0x71, 0xa0, 0x5c, 0xa2, 0xa1, 0xc3, 0x08, 0xbd, 0xb0, 0x56, 0x7a, 0x51, 0xe9, 0x10,
+		 0xbf, 0x62, 0xf0, 0x18, 0xe0, 0xe7, 0xb0, 0x1f, 0x54, 0x25, 0x70, 0xc9, 0xb3, 0x75, 0x88, 0x44}
+	},
+	{
+		{0xe0, 0x67, 0xe9, 0x7b, 0xdb, 0x96, 0x5c, 0xb0, 0x32, 0xd0, 0x59, 0x31, 0x90, 0xdc, 0x92, 0x97,
+		 0xac, 0x09, 0x38, 0x31, 0x0f, 0x7e, 0xd6, 0x5d, 0xd0, 0x06, 0xb6, 0x1f, 0xea, 0xf0, 0x5b, 0x07},
+		{0x81, 0x9f, 0xc7, 0xde, 0x6b, 0x41, 0x22, 0x35, 0x14, 0x67, 0x77, 0x3e, 0x90, 0x81, 0xb0, 0xd9,
+		 0x85, 0x4c, 0xca, 0x9b, 0x3f, 0x04, 0x59, 0xd6, 0xaa, 0x17, 0xc3, 0x88, 0x34, 0x37, 0xba, 0x43},
+		{0xb2, 0x0b, 0x09, 0x5c, 0x41, 0x87, 0x13, 0xa6, 0xd4, 0x6e, 0x62, 0x81, 0xf7, 0x1f, 0xc5, 0xa1,
+		 0x9e, 0x74, 0xc5, 0x9f, 0xfb, 0xef, 0x7f, 0x02, 0xc5, 0xbe, 0x9f, 0xc4, 0x6f, 0x37, 0xb7, 0x0c}
+	},
+	{
+		{0x34, 0x3b, 0xdc, 0x2d, 0x20, 0xca, 0xbd, 0x18, 0xff, 0xa0, 0xc8, 0x3c, 0x9d, 0xcb, 0x0a, 0xec,
+		 0xbd, 0x6e, 0x71, 0x2d, 0x11, 0xcc, 0x2f, 0xec, 0x97, 0x9b, 0xfb, 0x7b, 0xaa, 0xf1, 0xe1, 0x5e},
+		{0x7e, 0xc0, 0xd0, 0x02, 0xd0, 0xff, 0x09, 0x76, 0x13, 0x25, 0xb7, 0x87, 0x96, 0x0c, 0x2f, 0x3d,
+		 0xd2, 0x66, 0xf7, 0xfd, 0x47, 0x48, 0x1d, 0xdd, 0xaa, 0x85, 0x21, 0x75, 0x61, 0xcd, 0x29, 0x0f},
+		{0x88, 0xb0, 0x61, 0x29, 0xa6, 0xc7, 0xff, 0x9f, 0x85, 0xfe, 0xd9, 0x40, 0x00, 0x7e, 0xca, 0x39,
+		 0x26, 0x38, 0x57, 0xdb, 0x66, 0xe2, 0x93, 0xb4, 0x13, 0x8b, 0x73, 0x7b, 0xde, 0x45, 0x76, 0x04}
+	},
+	{
+		{0x28, 0xba, 0x8c, 0x82, 0xc6, 0x09, 0xaa, 0xcc, 0xa0, 0x03, 0xc1, 0x37, 0x49, 0xd8, 0xfe, 0x6a,
+		 0x01, 0x43, 0x56, 0x09, 0x97, 0xb4, 0xb8, 0x86, 0x7b, 0xca, 0x2a, 0xcc, 0x12, 0xcc, 0x80, 0x7b},
+		{0x84, 0x0a, 0xac, 0xd0, 0x34, 0x5f, 0xff, 0xaa, 0x2d, 0x52, 0x38, 0xce, 0x81, 0x13, 0xfd, 0x21,
+		 0x45, 0x7f, 0xdc, 0x72, 0x59, 0x27, 0x1f, 0xa6, 0xe6, 0xc3, 0xb2, 0x88, 0x62, 0x03, 0xbf, 0x37},
+		{0xe5, 0xe1, 0x31, 0x5c, 0x78, 0x97, 0xfd, 0x23, 0x98, 0x13, 0x40, 0xf7, 0x59, 0x28, 0x1f, 0x1d,
+		 0x3f, 0x5e, 0xe4, 0xc0, 0xad, 0x6e, 0x1c, 0x7e, 0xa3, 0x21, 0x6b, 0x2a, 0x1d, 0x90, 0xc5, 0x0e}
+	},
+	{
+		{0xdb, 0xf3, 0x65, 0xad, 0x65, 0xf5, 0x9b, 0x9e, 0xfa, 0xe0, 0x32, 0x73, 0xe5, 0xa3, 0x56, 0x15,
+		 0x01, 0x95, 0xd4, 0xfa, 0xb1, 0x96, 0x9e, 0xd7, 0x66, 0x85, 0x71, 0x4d, 0xba, 0x20, 0x63, 0x4e},
+		{0x80, 0xb9, 0x63, 0x25, 0xe7, 0x27, 0x8f, 0x59, 0x5e, 0xb1, 0x28, 0x21, 0x6c, 0x76, 0xee, 0x77,
+		 0x78, 0xd4, 0x25, 0xe3, 0x72, 0xea, 0xb7, 0x7f, 0xd8, 0x22, 0xe2, 0xf9, 0x7c, 0x4e, 0x6e, 0x08},
+		{0x82, 0xbc, 0x95, 0xc6, 0x1e, 0x20, 0x34, 0xca, 0x0f, 0x22, 0x2e, 0xd4, 0xe3, 0x68, 0x5d, 0xb1,
+		 0xd8, 0xf2, 0x44, 0x10, 0xa9, 0xd0, 0x45, 0x38, 0xfe, 0xb0, 0xf3, 0x06, 0x8b, 0xe5, 0xc0, 0x00}
+	},
+	{
+		{0xf6, 0x38, 0x87, 0x95, 0xaa, 0x9d, 0xa7, 0xaf, 0x21, 0x8d, 0x86, 0xe3, 0xa0, 0xf7, 0x22, 0xd6,
+		 0x39, 0x4e, 0xe2, 0xb8, 0xf3, 0xb9, 0x24, 0x64, 0x91, 0x31, 0x3e, 0x44, 0x6c, 0xcb, 0x1f, 0x7e},
+		{0x94, 0xae, 0x97, 0xb6, 0xd3, 0x9c, 0xbe, 0xdd, 0x2a, 0xd5, 0xb5, 0x10, 0x84, 0x73, 0x77, 0x0e,
+		 0x7d, 0x29, 0x47, 0x7e, 0x10, 0x75, 0x3e, 0xef, 0x55, 0x49, 0x81, 0xf3, 0xee, 0x78, 0xcc, 0x54},
+		{0x87, 0x5a, 0xc7, 0xea, 0x8e, 0xac, 0x88, 0xe9, 0xc8, 0x7c, 0xa6, 0xe8, 0xca, 0x0b, 0x5e, 0x66,
+		 0x64, 0xa5, 0x81, 0xea, 0x68, 0x37, 0x31, 0xe7, 0xab, 0xcb, 0x2d, 0xc7, 0x7b, 0xc3, 0xce, 0x36}
+	},
+	{
+		{0x99, 0xe7, 0xc5, 0x0f, 0xe0, 0xa7, 0xde, 0xca, 0xaf, 0x96, 0x5f, 0x31, 0xfd, 0x61, 0x9c, 0x8d,
+		 0x21, 0x46, 0x65, 0x8e, 0xe6, 0x43, 0xf4, 0x08, 0x2f, 0xe2, 0x64, 0xc2, 0x23, 0xcf, 0xb2, 0x6f},
+		{0x08, 0xfe, 0xf2, 0x40, 0xd4, 0x17, 0x8f, 0xf3, 0x7f, 0x17, 0x0f, 0xaf, 0xf2, 0x81, 0x99, 0xc9,
+		 0x71, 0x0c, 0xa2, 0xb6, 0xd4, 0xd2, 0xca, 0x04, 0x68, 0x08, 0xab, 0x3e, 0x95, 0x8d, 0xff, 0x03},
+		{0x02, 0xfd, 0x0f, 0xa2, 0x13, 0xfd, 0xca, 0xa4, 0xd3, 0xf4, 0x04, 0x16, 0xc7, 0x0f, 0x20, 0x42,
+		 0x4d, 0x70, 0x95, 0xc9, 0xd4, 0x51, 0x4d, 0xc0, 0x46, 0x83, 0x35, 0xaf, 0xdc, 0x4a, 0xd1, 0x10}
+	},
+	{
+		{0x10, 0x37, 0x88, 0xf1, 0x9c, 0x3d, 0xe9, 0xc1, 0xe5, 0xe7, 0xa3, 0x50, 0x74, 0x1c, 0xbf, 0x53,
+		 0x49, 0x29, 0x08, 0x14, 0x33, 0x79, 0xbe, 0xbd, 0xdc, 0x52, 0x5c, 0x50, 0xbb, 0xfd, 0x41, 0x16},
+		{0x3f, 0x2b, 0x08, 0x5f, 0xe4, 0x32, 0x21, 0x83, 0x63, 0xaa, 0x3a, 0x3c, 0x77, 0x92, 0xc7, 0x78,
+		 0x81, 0x47, 0x4d, 0x50, 0x98, 0xe3, 0x81, 0xe2, 0x29, 0x5c, 0x9d, 0x42, 0x0a, 0x0d, 0xfd, 0x50},
+		{0x3f, 0x82, 0xcb, 0x0e, 0x59, 0xc4, 0xe2, 0x1f, 0x06, 0x99, 0xe8, 0x92, 0x1d, 0x44, 0x35, 0x13,
+		 0x8b, 0xe8, 0x85, 0x0f, 0x32, 0x40, 0x8e, 0x18, 0x6b, 0x17, 0x1e, 0x25, 0x89, 0xbd, 0x50, 0x6d}
+	},
+	{
+		{0xdb, 0x96, 0x92, 0x96, 0x7e, 0x88, 0x31, 0xf0, 0xbe, 0xd4, 0x71, 0x81, 0xb2, 0x8e, 0xd2, 0xae,
+		 0x75, 0x31, 0x1d, 0x76, 0xe3, 0x7c, 0xb7, 0xd0, 0x81, 0x45, 0x39, 0xf9, 0xec, 0xf4, 0x08, 0x7d},
+		{0x5e, 0x4d, 0x5b, 0xe1, 0x53, 0x40, 0x65, 0x2b, 0xd0, 0x6d, 0x55, 0xd0, 0xbc, 0xd0, 0x63, 0xf7,
+		 0x63, 0x52, 0x85, 0xaa, 0x2d, 0xa6, 0x87, 0xf2, 0x41, 0xc1, 0x54, 0x1f, 0xc2, 0x01, 0x03, 0x26},
+		{0x7d, 0x4c, 0xb3, 0x3e, 0x8b, 0xff, 0x11, 0xbc, 0x89, 0xac, 0xcd, 0x99, 0x67, 0x17, 0x2a, 0xbe,
+		 0x0d, 0x3e, 0x12, 0x3f, 0x6c, 0xe3, 0xfa, 0x7d, 0xc3, 0x27, 0x48, 0x6f, 0x22, 0xe8, 0x8c, 0x0c}
+	},
+	{
+		{0x69, 0x68, 0x1f, 0xf1, 0xef, 0xf0, 0xed, 0x89, 0x4e, 0x60, 0x68, 0x46, 0x5c, 0x93, 0x11, 0x62,
+		 0xad, 0xe4, 0x1a, 0x2d, 0x67, 0x2c, 0x5c, 0x2b, 0x6d, 0x3d, 0x59, 0x31, 0xeb, 0xce, 0xc7, 0x18},
+		{0xa4, 0x28, 0xc6, 0x04, 0x77, 0x47, 0x90, 0xd7, 0x22, 0xc8, 0xe2, 0x64, 0x8a, 0x61, 0x07, 0xda,
+		 0xca, 0xd6, 0x10, 0x43, 0x93, 0x23, 0x46, 0x57, 0x10, 0x29, 0xb5, 0x38, 0x57, 0x91, 0xec, 0x1a},
+		{0xba, 0x20, 0xa4, 0xd1, 0xfe, 0x9c, 0xf6, 0xac, 0x27, 0xcd, 0xd6, 0x9f, 0x28, 0xdd, 0xed, 0xb1,
+		 0xfb, 0xe8, 0x85, 0xca, 0x6f, 0x95, 0xa7, 0xff, 0xfa, 0x77, 0x59, 0x00, 0x3d, 0xcd, 0x94, 0x2c}
+	},
+	{
+		{0x58, 0xc0, 0xc6, 0xf1, 0x24, 0x31, 0x87, 0x54, 0x98, 0x42, 0x06, 0x44, 0x8c, 0x81, 0xbb, 0x25,
+		 0xea, 0x62, 0xe6, 0x6f, 0xf5, 0x59, 0xf8, 0xac, 0x7f, 0x38, 0x1c, 0xc9, 0x19, 0x3f, 0xd7, 0x07},
+		{0xfe, 0x34, 0x92, 0x96, 0x8d, 0xc4, 0x7a, 0xb5, 0x98, 0xec, 0x12, 0x58, 0x1b, 0xde, 0x73, 0x5f,
+		 0x83, 0x2e, 0x95, 0x97, 0x63, 0x84, 0xff, 0x9c, 0x47, 0x34, 0xe2, 0x41, 0xdc, 0x2d, 0xff, 0x5d},
+		{0xb5, 0xa9, 0xb3, 0x83, 0xac, 0x67, 0x77, 0x5c, 0xec, 0xac, 0x55, 0x93, 0x05, 0xcf, 0xef, 0x22,
+		 0xdc, 0x50, 0xc1, 0x5e, 0x4e, 0x45, 0x59, 0x2b, 0x03, 0x2c, 0x19, 0xc1, 0x56, 0x98, 0x62, 0x21}
+	},
+	{
+		{0xa1, 0x68, 0x2c, 0x8b, 0xe3, 0x06, 0x61, 0x04, 0x9e, 0xde, 0x4b, 0x73, 0x2b, 0x98, 0xd1, 0xf8,
+		 0xf2, 0x10, 0x92, 0x8e, 0xc7, 0x75, 0x2f, 0xdd, 0x9f, 0x5d, 0x91, 0x32, 0xd2, 0x77, 0x84, 0x56},
+		{0x91, 0x58, 0xeb, 0xc5, 0x14, 0xe7, 0x1d, 0xc3, 0x0b, 0x3c, 0xc5, 0xfa, 0x01, 0x57, 0x3a, 0xdc,
+		 0x4c, 0x87, 0x1e, 0x15, 0xd6, 0xef, 0xc1, 0xf0, 0xb3, 0xec, 0xf8, 0xe5, 0x9d, 0x92, 0xfa, 0x4c},
+		{0xb6, 0x0b, 0x72, 0x5b, 0x5c, 0xa2, 0x04, 0x5f, 0x2e, 0x78, 0x6a, 0x88, 0x8e, 0x70, 0x24, 0x3a,
+		 0x11, 0xbe, 0x55, 0xb0, 0x45, 0xee, 0x49, 0x98, 0xd8, 0xda, 0x37, 0xd0, 0xa7, 0xb1, 0x85, 0x7c}
+	},
+	{
+		{0x95, 0xa4, 0xb8, 0xdb, 0xde, 0xb9, 0xad, 0xce, 0xe2, 0x46, 0x60, 0x2a, 0x97, 0x4e, 0x1f, 0xa5,
+		 0x05, 0xc8, 0x35, 0xe3, 0x7d, 0x15, 0x30, 0xe6, 0xce, 0xd9, 0xea, 0xee, 0xc2, 0xc1, 0x8a, 0x60},
+		{0xcf, 0x72, 0xa4, 0x86, 0x9b, 0x02, 0xbe, 0x8e, 0x38, 0x69, 0x65, 0x27, 0x61, 0xf4, 0x96, 0x8c,
+		 0x77, 0x27, 0x17, 0x54, 0x9a, 0x99, 0x7c, 0xd1, 0xfe, 0x8b, 0x52, 0xf8, 0x05, 0x83, 0xf6, 0x34},
+		{0x4b, 0x32, 0x38, 0xfd, 0xde, 0xc4, 0x07, 0x83, 0x54, 0x56, 0x95, 0x95, 0x97, 0xf7, 0x5f, 0xd4,
+		 0xb5, 0xb2, 0x76, 0x62, 0x00, 0x63, 0xa5, 0xec, 0xc8, 0x5c, 0xe5, 0x14, 0xd5, 0x92, 0x35, 0x01}
+	},
+	{
+		{0x1f, 0xa9, 0x43, 0x22, 0xa1, 0x12, 0x81, 0x7c, 0x98, 0x5f, 0x2b, 0x42, 0xa9, 0x5f, 0xe5, 0x5b,
+		 0x07, 0xfb, 0x4f, 0xb5, 0x61, 0x59, 0x02, 0xaa, 0x8a, 0xa3, 0x7c, 0xa7, 0x75, 0xf5, 0x89, 0x45},
+		{0x1f, 0x87, 0x10, 0x57, 0x35, 0x36, 0x6c, 0xfc, 0x69, 0xf8, 0xf3, 0x4a, 0xb5, 0xe1, 0x9b, 0x3c,
+		 0x47, 0x63, 0x2e, 0x3a, 0x47, 0xa9, 0x17, 0x72, 0x6c, 0x2e, 0x16, 0xe3, 0x5c, 0xc1, 0x7d, 0x51},
+		{0x20, 0x2b, 0xb2, 0x32, 0x2f, 0xe7, 0x38, 0x63, 0xf6, 0x74, 0x98, 0xb9, 0x01, 0x7e, 0x8d, 0x27,
+		 0x84, 0x42, 0xd4, 0xf6, 0x6a, 0x7f, 0x3e, 0xcc, 0x4e, 0x26, 0x80, 0x24, 0x59, 0xe2, 0xe6, 0x26}
+	},
+	{
+		{0xc8, 0x0d, 0xec, 0x8a, 0xf3, 0x60, 0x66, 0xc9, 0x50, 0xae, 0xa0, 0xe3, 0xfe, 0x2b, 0x1b, 0xc9,
+		 0x4f, 0xd8, 0x71, 0x2f, 0x92, 0x0d, 0x2d, 0x94, 0xcc, 0x63, 0xde, 0xb1, 0x43, 0x41, 0xe4, 0x3a},
+		{0x11, 0x9e, 0x4a, 0x5e, 0x57, 0x6c, 0x80, 0x21, 0x78, 0x76, 0xee, 0xbd, 0x57, 0xfc, 0x77, 0x03,
+		 0x39, 0x81, 0xff, 0xe2, 0x81, 0x55, 0xf0, 0x7b, 0x8f, 0x96, 0x3f, 0x54, 0xf8, 0xa4, 0x2e, 0x7a},
+		{0x32, 0x6a, 0x37, 0x40, 0x04, 0xa6, 0x27, 0xd0, 0xaf, 0xb0, 0xae, 0x20, 0x02, 0x37, 0x61, 0xb1,
+		 0xa8, 0xb9, 0x12, 0xd8, 0x5d, 0x36, 0xda, 0x61, 0x9f, 0xbd, 0xa9, 0x26, 0x97, 0xd5, 0x37, 0x1e}
+	},
+	{
+		{0xb0, 0x98, 0x04, 0x5c, 0x4c, 0xdf, 0x32, 0xcc, 0x22, 0x75, 0xf7, 0x46, 0x1c, 0x09, 0xa1, 0x24,
+		 0x34, 0x60, 0xac, 0xad, 0x41, 0x11, 0xdf, 0x7e, 0xdd, 0x25, 0x88, 0x26, 0x97, 0x81, 0xd3, 0x16},
+		{0x4d, 0xf1, 0x1c, 0xe5, 0x26, 0xf8, 0x88, 0x16, 0x4d, 0xef, 0x33, 0x3a, 0xa9, 0x76, 0x62, 0x87,
+		 0x5a, 0xe0, 0xcf, 0xce, 0xd3, 0x4d, 0xa0, 0x38, 0x1c, 0xff, 0xf2, 0x2c, 0x27, 0xcf, 0xf9, 0x19},
+		{0x0b, 0x9f, 0x4c, 0xb0, 0x46, 0x1f, 0x79, 0x2f, 0x3c, 0x37, 0xa9, 0x2c, 0x56, 0x1a, 0x53, 0x8b,
+		 0xfb, 0x35, 0xe3, 0x42, 0xef, 0xd5, 0xd6, 0x00, 0x9c, 0x9b, 0x2b, 0x50, 0xdc, 0x0b, 0xa6, 0x6f}
+	},
+	{
+		{0x1e, 0x91, 0x1c, 0x56, 0x2b, 0x9f, 0x6f, 0x5b, 0xaa, 0xce, 0xf6, 0xd6, 0xc6, 0xe8, 0xeb, 0x3a,
+		 0x2a, 0x0a, 0x21, 0xbb, 0x3c, 0x46, 0xdd, 0xb9, 0x20, 0xd0, 0x95, 0x1f, 0x57, 0x6e, 0x66, 0x36},
+		{0xe5, 0xce, 0x47, 0x66, 0x9b, 0xbc, 0x1e, 0xcf, 0xe3, 0x3a, 0xea, 0x02, 0xcf, 0x96, 0x94, 0x7a,
+		 0xfa, 0xe2, 0x3b, 0x69, 0xd6, 0x25, 0x6b, 0xfd, 0xdc, 0x82, 0xa7, 0x28, 0x06, 0x0c, 0xa9, 0x7f},
+		{0x77, 0xf7, 0x35, 0x5f, 0x73, 0xae, 0x93, 0xfa, 0xf2, 0x0f, 0x13, 0x0c, 0xf7, 0x25, 0x4e, 0x35,
+		 0xe0, 0xdb, 0xac, 0x4b, 0xcb, 0xef, 0x02, 0x5a, 0x2b, 0x50, 0x72, 0xdf, 0x4c, 0xa2, 0x57, 0x3c}
+	},
+	{
+		{0x73, 0x11, 0x02, 0xbe, 0x20, 0x5a, 0xb6, 0x57, 0xb8, 0xa8, 0x12, 0x88, 0x33, 0x9e, 0xa0, 0x32,
+		 0x7b, 0xb2, 0x78, 0xf6, 0x4e, 0x0a, 0x96, 0xca, 0xf4, 0xb2, 0x8b, 0x8b, 0xfe, 0x9d, 0xc1, 0x5a},
+		{0x5d, 0xbc, 0xbc, 0x79, 0x72, 0x81, 0x71, 0x4f, 0x5c, 0xd9, 0xa6, 0xda, 0x53, 0xd5, 0xc1, 0xc2,
+		 0x90, 0x27, 0x8f, 0x4a, 0x3a, 0x4a, 0x6d, 0x51, 0x33, 0xaf, 0xc7, 0xa3, 0x41, 0xab, 0xbd, 0x3f},
+		{0xac, 0x5a, 0x42, 0x7b, 0xe9, 0xa8, 0x58, 0xbf, 0xc4, 0xa7, 0x8d, 0x27, 0xc4, 0x99, 0x35, 0xd5,
+		 0x1e, 0x89, 0x75, 0xc3, 0xff, 0x4f, 0xc9, 0x88, 0xfe, 0xac, 0x9f, 0x09, 0x36, 0x47, 0xcb, 0x08}
+	},
+	{
+		{0x12, 0xb6, 0x0f, 0xf6, 0xb9, 0xb2, 0xc3, 0x70, 0x34, 0xb7, 0x4e, 0x56, 0xff, 0x1b, 0x66, 0xe1,
+		 0x1b, 0xb2, 0x13, 0x59, 0xae, 0x37, 0xd8, 0x75, 0x51, 0x20, 0xce, 0x1e, 0xad, 0xde, 0x85, 0x07},
+		{0x19, 0xdf, 0x07, 0x79, 0x3b, 0x69, 0x39, 0x04, 0x0f, 0xfe, 0xa3, 0xf6, 0xc5, 0x1d, 0xe2, 0x01,
+		 0x2e, 0x60, 0x74, 0x9b, 0x11, 0xc2, 0x7f, 0x08, 0x39, 0x22, 0x75, 0x43, 0x9d, 0x28, 0x4c, 0x25},
+		{0xe5, 0xb7, 0x49, 0xed, 0x17, 0x41, 0xdd, 0x32, 0xe9, 0xcb, 0xe1, 0xda, 0xa0, 0xbe, 0xbf, 0xcc,
+		 0xf9, 0xe1, 0x59, 0x5e, 0x62, 0xe5, 0x47, 0xe6, 0x51, 0x43, 0x71, 0xcd, 0x41, 0x1f, 0x9c, 0x09}
+	},
+	{
+		{0x9b, 0xed, 0x10, 0xd5, 0xf4, 0x75, 0x6b, 0x0e, 0xb7, 0x78, 0x38, 0xea, 0xcc, 0x52, 0x44, 0x46,
+		 0x62, 0x97, 0x90, 0x81, 0xaa, 0xc5, 0x9b, 0x05, 0xa4, 0x3b, 0x7e, 0x31, 0x19, 0xbd, 0x05, 0x2b},
+		{0xe7, 0xc9, 0x61, 0xc1, 0x53, 0x0f, 0xc3, 0x7f, 0x43, 0xb5, 0x5e, 0x80, 0x9c, 0xdb, 0xa7, 0xe6,
+		 0x68, 0x92, 0x04, 0x51, 0xe0, 0x17, 0x2f, 0xc2, 0x49, 0xd0, 0x34, 0x39, 0x2b, 0xfa, 0x3d, 0x4c},
+		{0xf4, 0x4c, 0x0f, 0x2d, 0x24, 0xdb, 0xda, 0x27, 0x45, 0xe9, 0xa4, 0x16, 0x62, 0x30, 0x58, 0x27,
+		 0x39, 0xe5, 0x58, 0x8b, 0x65, 0x0e, 0x6a, 0x5c, 0x00, 0x74, 0x60, 0xb8, 0x39, 0x23, 0xdd, 0x23}
+	},
+	{
+		{0xbb, 0x86, 0xb8, 0x45, 0x31, 0x9f, 0x4e, 0x8e, 0x8e, 0x16, 0x6c, 0x77, 0xd2, 0x3c, 0x12, 0xad,
+		 0xc4, 0xd6, 0x1d, 0xe1, 0xe1, 0xba, 0x2f, 0x38, 0x19, 0x49, 0xdf, 0xfa, 0x95, 0x8d, 0xbf, 0x5d},
+		{0xf3, 0xe9, 0x60, 0xb1, 0x8c, 0x0e, 0x83, 0xc8, 0xff, 0x40, 0x8d, 0x58, 0xe6, 0xb3, 0xa0, 0x91,
+		 0xed, 0x74, 0x3f, 0x4c, 0xdc, 0x47, 0xe1, 0x1a, 0x75, 0x50, 0xb4, 0x22, 0x00, 0x13, 0xbf, 0x0e},
+		{0x21, 0x39, 0x6e, 0x0d, 0x22, 0x8f, 0x5e, 0x5a, 0xb4, 0xc6, 0xce, 0x71, 0x4a, 0xbd, 0xcd, 0x9f,
+		 0xe0, 0xa2, 0x87, 0x45, 0x90, 0x3f, 0x19, 0x58, 0x67, 0xc1, 0x4c, 0x37, 0x47, 0x4f, 0x2d, 0x0a}
+	},
+	{
+		{0x7a, 0x4e, 0xc0, 0x97, 0x5d, 0xa2, 0xc0, 0x7c, 0x1b, 0x6d, 0x17, 0x4e, 0x43, 0xaf, 0xf8, 0x23,
+		 0x2c, 0xbd, 0xa2, 0x71, 0x8f, 0x19, 0x3b, 0xcd, 0x5e, 0x91, 0xde, 0xee, 0x6b, 0xd1, 0x2e, 0x3b},
+		{0x55, 0xed, 0xcf, 0x9b, 0x65, 0xc2, 0xc7, 0x3e, 0x84, 0x36, 0xef, 0x45, 0xb3, 0xf9, 0x6a, 0xe3,
+		 0x32, 0xa9, 0xd3, 0x8e, 0xcf, 0xf0, 0xc9, 0x4a, 0x8d, 0x19, 0xa0, 0x66, 0x36, 0xae, 0x98, 0x07},
+		{0x0c, 0x69, 0x71, 0xb5, 0x5c, 0x79, 0x24, 0x66, 0x51, 0x07, 0x96, 0x26, 0xf5, 0xd1, 0xb4, 0xfa,
+		 0xac, 0x1d, 0x1b, 0x33, 0x10, 0xfb, 0x34, 0xad, 0xf9, 0x59, 0x2a, 0xa9, 0xf1, 0x81, 0xff, 0x7b}
+	},
+	{
+		{0x3a, 0x39, 0x32, 0xa6, 0xe5, 0x97, 0x5e, 0xf8, 0x64, 0xe6, 0x4a, 0xf0, 0x03, 0x57, 0xbf, 0xd3,
+		 0x3a, 0xae, 0x90, 0x96, 0x7f, 0x12, 0xa6, 0x49, 0x6f, 0x04, 0x9f, 0xd1, 0x48, 0x5a, 0x31, 0x7d},
+		{0x39, 0x97, 0x1b, 0x78, 0x2b, 0x25, 0x91, 0xb8, 0x61, 0xec, 0x99, 0x83, 0xe7, 0x2f, 0xe5, 0x9d,
+		 0xc9, 0x0e, 0x83, 0x5a, 0x72, 0x59, 0x18, 0x5a, 0x40, 0x99, 0xb3, 0xbc, 0xff, 0x38, 0x5e, 0x77},
+		{0xac, 0x56, 0x8c, 0x73, 0x94, 0xa3, 0x07, 0x95, 0xf5, 0x16, 0xa8, 0x3c, 0xf7, 0x65, 0x5c, 0x50,
+		 0x10, 0x93, 0x2b, 0x8e, 0xe6, 0x4a, 0x7b, 0x16, 0xcc, 0x9d, 0x7a, 0x46, 0x19, 0xda, 0xac, 0x77}
+	},
+	{
+		{0x20, 0x8f, 0x6a, 0x6d, 0x53, 0xe8, 0x18, 0xfc, 0x5d, 0xfc, 0x66, 0x5a, 0x35, 0x4a, 0x48, 0x55,
+		 0x77, 0x02, 0xbe, 0x58, 0xac, 0x7d, 0xae, 0x61, 0xb0, 0x53, 0x03, 0x11, 0x30, 0x69, 0xb4, 0x09},
+		{0xe0, 0xa5, 0xf4, 0x91, 0xfb, 0xbd, 0x2b, 0xcb, 0x7b, 0xd3, 0xbf, 0x04, 0x0d, 0xf8, 0x01, 0xa8,
+		 0xea, 0x3a, 0x20, 0x5c, 0x48, 0x5e, 0xf7, 0x6e, 0x21, 0x5c, 0x3d, 0xe8, 0x39, 0x22, 0x14, 0x12},
+		{0x3d, 0xfd, 0x41, 0x30, 0x79, 0x58, 0x81, 0x12, 0x7b, 0x02, 0xa2, 0xfd, 0x61, 0xe5, 0x5b, 0xc3,
+		 0x2c, 0x18, 0x3c, 0x63, 0xc2, 0x68, 0x7e, 0x60, 0x9b, 0x8d, 0x8f, 0x2a, 0xf3, 0xa9, 0xcd, 0x48}
+	},
+	{
+		{0xb6, 0x65, 0xe3, 0x02, 0x31, 0xf5, 0xd1, 0x1b, 0x3f, 0xf9, 0x3e, 0xc9, 0x3b, 0x02, 0x1b, 0xbc,
+		 0xa4, 0xdc, 0x69, 0x53, 0x71, 0x13, 0xd9, 0xce, 0xd3, 0xe3, 0x15, 0xb9, 0x18, 0x4f, 0x16, 0x52},
+		{0xe8, 0x28, 0x42, 0x32, 0xcf, 0x55, 0x17, 0x0e, 0xbb, 0x70, 0x7a, 0x70, 0xf3, 0xae, 0xcb, 0x5c,
+		 0x40, 0xe0, 0xb5, 0xbd, 0xcc, 0xa2, 0xdd, 0x4f, 0x9c, 0xde, 0x44, 0x10, 0xd4, 0x31, 0x7a, 0x58},
+		{0x2f, 0xfe, 0x45, 0x36, 0x6b, 0x05, 0xba, 0xaf, 0x79, 0x5f, 0x84, 0x5f, 0x8c, 0xb6, 0x86, 0x93,
+		 0x61, 0x7b, 0xf0, 0x1b, 0xd8, 0xb2, 0x23, 0xfc, 0xa7, 0x70, 0x78, 0x20, 0x43, 0xf7, 0xef, 0x67}
+	},
+	{
+		{0x9a, 0xe4, 0xb1, 0x11, 0xb0, 0x1a, 0x9e, 0xc6, 0xd9, 0x8e, 0x29, 0x15, 0xec, 0x0b, 0x80, 0xaf,
+		 0x76, 0xad, 0x92, 0x0d, 0xe0, 0x2b, 0x0a, 0xc2, 0xa4, 0x87, 0x65, 0x97, 0xd3, 0xa5, 0xfd, 0x41},
+		{0xb0, 0x31, 0xc5, 0xd0, 0xa0, 0xc7, 0x49, 0xb0, 0x10, 0xb5, 0x55, 0xf0, 0xdd, 0x42, 0x3f, 0x0c,
+		 0x96, 0xdf, 0x56, 0xdf, 0xd9, 0xbe, 0x48, 0xdd, 0xbc, 0x42, 0x42, 0xc1, 0xa9, 0x31, 0xff, 0x40},
+		{0x1c, 0xcd, 0x01, 0xdd, 0x74, 0x54, 0xb6, 0xca, 0xa8, 0x5c, 0xa9, 0x25, 0xa5, 0x5d, 0xfd, 0x35,
+		 0x5a, 0xfc, 0xc9, 0x97, 0xa8, 0x15, 0x5e, 0xcd, 0xf0, 0x0c, 0xbb, 0x76, 0x90, 0xde, 0xe6, 0x51}
+	},
+	{
+		{0xc2, 0x46, 0xd2, 0xf8, 0xd9, 0x8e, 0xf0, 0xc1, 0xf6, 0x25, 0xa9, 0x5e, 0x56, 0x7f, 0xd2, 0xad,
+		 0x75, 0x55, 0x20, 0x4e, 0xba, 0xe3, 0x18, 0x08, 0x8d, 0xa4, 0xfd, 0xc1, 0x90, 0x7d, 0xeb, 0x01},
+		{0x5b, 0x71, 0xf3, 0x83, 0xd1, 0x09, 0x0d, 0xf4, 0x83, 0xde, 0x1a, 0xad, 0x56, 0x58, 0xe2, 0x79,
+		 0xcb, 0x17, 0x79, 0x1c, 0x7e, 0xcc, 0xe3, 0x22, 0xb0, 0x89, 0x1f, 0x72, 0xe5, 0xff, 0xf5, 0x6e},
+		{0x6e, 0xe9, 0x86, 0x46, 0x33, 0x3d, 0x56, 0x64, 0xbc, 0x93, 0xf2, 0xed, 0xd5, 0x28, 0x7b, 0x1f,
+		 0xe9, 0x87, 0x50, 0x73, 0x1d, 0x90, 0x2e, 0x6f, 0x77, 0x44, 0xa0, 0xc9, 0x69, 0x7d, 0x45, 0x03}
+	},
+	{
+		{0x71, 0xf2, 0x22, 0xf6, 0x97, 0xe1, 0x7f, 0x3b, 0x3b, 0x66, 0x71, 0x65, 0x5b, 0x22, 0x6a, 0x2c,
+		 0xf7, 0x56, 0x5d, 0x6e, 0x98, 0x02, 0x92, 0x8d, 0x14, 0x9e, 0x0c, 0x77, 0x15, 0x5d, 0x27, 0x4f},
+		{0xd5, 0xf4, 0x9a, 0x72, 0xbe, 0xb2, 0x64, 0x6e, 0x7f, 0xc2, 0x19, 0x0b, 0x3f, 0xd8, 0x6a, 0x1b,
+		 0xf3, 0xbc, 0x5c, 0xb6, 0x48, 0x66, 0x4d, 0x22, 0xbf, 0x26, 0x4e, 0x96, 0xab, 0x04, 0x33, 0x5f},
+		{0xc8, 0x19, 0x4c, 0x91, 0xb1, 0xfd, 0x1a, 0x9f, 0x98, 0xfc, 0x09, 0x98, 0x6e, 0xa4, 0x5c, 0x36,
+		 0x2e, 0xef, 0xe2, 0x57, 0x71, 0x4b, 0x9c, 0x30, 0x8e, 0xcf, 0x5c, 0x35, 0x34, 0x8a, 0xd3, 0x48}
+	},
+	{
+		{0xad, 0xd8, 0x50, 0x22, 0x65, 0x91, 0xd9, 0x83, 0x2b, 0xbd, 0x33, 0xee, 0xd3, 0x62, 0xe8, 0xcb,
+		 0xa3, 0x32, 0xa3, 0x4b, 0xd6, 0x5a, 0xef, 0x79, 0xe9, 0x27, 0xa9, 0x13, 0x1a, 0x8a, 0xf7, 0x2f},
+		{0xee, 0x92, 0x2b, 0x76, 0x27, 0x23, 0x8d, 0x41, 0xad, 0xe4, 0x72, 0xf3, 0xcd, 0x0e, 0xfd, 0x02,
+		 0x4c, 0x68, 0x8f, 0xd3, 0x1a, 0x70, 0x04, 0xf5, 0x43, 0x79, 0x8e, 0xeb, 0x31, 0xf6, 0x59, 0x5c},
+		{0x74, 0x7c, 0x13, 0xe9, 0xec, 0x9a, 0x52, 0x6a, 0x82, 0x98, 0x3a, 0x55, 0x1d, 0x96, 0x3f, 0x50,
+		 0xf2, 0xd3, 0x15, 0x49, 0x8e, 0x89, 0x26, 0xed, 0x34, 0x4e, 0x9d, 0xc8, 0xe4, 0xa1, 0x4c, 0x0a}
+	},
+	{
+		{0xdd, 0xfc, 0xa5, 0x04, 0x3b, 0xe9, 0xe2, 0xef, 0x2b, 0x36, 0x8a, 0x32, 0x84, 0x4d, 0x65, 0x58,
+		 0xc5, 0x40, 0x0c, 0xd8, 0xec, 0x1a, 0x22, 0xf9, 0x2c, 0x18, 0x7a, 0x3c, 0xb6, 0x24, 0xa9, 0x77},
+		{0x1b, 0xba, 0xf2, 0xba, 0x30, 0xe2, 0x06, 0x84, 0xbb, 0x5e, 0xc9, 0x98, 0xe7, 0x30, 0x27, 0x36,
+		 0xec, 0xeb, 0xf1, 0x55, 0x2b, 0x2f, 0xf1, 0xc1, 0x8e, 0x6e, 0x43, 0x0e, 0x3e, 0x05, 0x97, 0x56},
+		{0xf5, 0x71, 0x0f, 0x67, 0xac, 0x49, 0x15, 0x3e, 0x40, 0xf3, 0x21, 0x99, 0x45, 0x18, 0x32, 0xe0,
+		 0x78, 0x36, 0xf9, 0xcc, 0xb9, 0x71, 0x68, 0x58, 0x50, 0xa3, 0xa1, 0x37, 0xc3, 0x3c, 0xdf, 0x74}
+	},
+	{
+		{0x8c, 0x79, 0x49, 0xa7, 0x87, 0x3a, 0x93, 0x72, 0x9a, 0xf5, 0x83, 0xa8, 0xc9, 0xf5, 0xa4, 0x38,
+		 0x06, 0x73, 0x79, 0x3a, 0xff, 0x34, 0xd8, 0x25, 0x00, 0xcb, 0x8d, 0x06, 0xf1, 0xee, 0x91, 0x62},
+		{0x4c, 0x8e, 0x10, 0x02, 0x54, 0x2b, 0xc7, 0xab, 0x09, 0xf1, 0x82, 0x0c, 0xa0, 0xfb, 0xec, 0xc7,
+		 0xb7, 0x92, 0x7b, 0xe3, 0xdc, 0x92, 0xfc, 0xf6, 0xcf, 0x7f, 0xc9, 0x95, 0xb6, 0x78, 0xae, 0x08},
+		{0x18, 0xb6, 0x0c, 0xfc, 0x0a, 0xdb, 0xc2, 0x58, 0x79, 0xee, 0xe9, 0x91, 0x6b, 0x2f, 0x67, 0x8c,
+		 0x7c, 0x3b, 0xd3, 0x12, 0x8a, 0xc1, 0x35, 0x48, 0x80, 0xc7, 0xf1, 0x8b, 0xa1, 0x86, 0xa8, 0x52}
+	},
+	{
+		{0x99, 0xaf, 0xd7, 0xd4, 0x78, 0x81, 0xdc, 0x60, 0xf0, 0x0f, 0x8e, 0x03, 0xac, 0x1c, 0x6c, 0x99,
+		 0x73, 0x14, 0x83, 0xf7, 0x6b, 0x9b, 0xcf, 0xea, 0xd4, 0x03, 0xe7, 0xa4, 0x2e, 0x37, 0xbe, 0x7f},
+		{0x3b, 0xe6, 0x0c, 0x32, 0x8a, 0x90, 0x0d, 0x32, 0x2c, 0xa7, 0x80, 0x37, 0x4f, 0x08, 0x02, 0x4c,
+		 0xc6, 0x0b, 0xea, 0x41, 0x0d, 0x59, 0x04, 0xa8, 0xe6, 0x4e, 0xce, 0x46, 0x26, 0xe6, 0x4e, 0x53},
+		{0x85, 0xe7, 0x91, 0x9d, 0x17, 0x85, 0x06, 0x49, 0x0c, 0x81, 0xcf, 0xd3, 0xdc, 0xa6, 0x2e, 0xce,
+		 0x9f, 0x9b, 0x70, 0x15, 0x36, 0xc4, 0x8b, 0x1d, 0xef, 0x52, 0x3b, 0xab, 0x5c, 0x0b, 0x11, 0x26}
+	},
+	{
+		{0xa1, 0x6e, 0xc6, 0xe9, 0x6a, 0xa9, 0xd5, 0xc0, 0xc8, 0xfa, 0x07, 0xbe, 0x22, 0x57, 0xf8, 0x9c,
+		 0x5f, 0xd1, 0x75, 0x5d, 0xdd, 0x76, 0xad, 0xc0, 0x96, 0xe4, 0x90, 0x99, 0x6e, 0xc9, 0xda, 0x17},
+		{0x1c, 0x57, 0x45, 0x1e, 0xf9, 0x2b, 0xb2, 0x95, 0xd8, 0xfe, 0x5f, 0x1d, 0xc5, 0xc6, 0x84, 0xbd,
+		 0x58, 0x55, 0x9d, 0xc2, 0x36, 0x4e, 0xe9, 0x56, 0x27, 0x43, 0x3d, 0x4d, 0x32, 0x4c, 0x93, 0x65},
+		{0x02, 0xe4, 0x8b, 0x4e, 0x00, 0xf8, 0x5a, 0x5f, 0x47, 0x54, 0x9e, 0xdc, 0xee, 0x04, 0xbe, 0x29,
+		 0x86, 0xd4, 0xc0, 0x07, 0x16, 0x29, 0x11, 0x36, 0x78, 0xc0, 0x87, 0xf5, 0xde, 0x91, 0xe8, 0x4b}
+	}
+};
+#endif
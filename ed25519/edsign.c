@@ -8,6 +8,7 @@
 #include "sha512.h"
 #include "fprime.h"
 #include "edsign.h"
+#include "scratch.h"
 
 #define EXPANDED_SIZE		64
 
@@ -30,18 +31,35 @@ static void expand_key(uint8_t *expanded, const uint8_t *secret)
 
 static uint8_t upp(struct ed25519_pt *p, const uint8_t *packed)
 {
-	static uint8_t x[F25519_SIZE];
-	static uint8_t y[F25519_SIZE];
+	ED25519_SCRATCH uint8_t x[F25519_SIZE];
+	ED25519_SCRATCH uint8_t y[F25519_SIZE];
 	uint8_t ok = ed25519_try_unpack(x, y, packed);
 
 	ed25519_project(p, x, y);
 	return ok;
 }
 
+/* Unpack -A, from the cache left by edsign_unpack_pub if there is one */
+static uint8_t upp_neg_pub(struct ed25519_pt *p, const uint8_t *pub,
+			   const uint8_t *unpacked)
+{
+	uint8_t ok = 1;
+
+	if (unpacked) {
+		ed25519_project(p, unpacked, unpacked + F25519_SIZE);
+	} else {
+		ok = upp(p, pub);
+		f25519_neg(p->x, p->x);
+		f25519_neg(p->t, p->t);
+	}
+
+	return ok;
+}
+
 static void pp(uint8_t *packed, const struct ed25519_pt *p)
 {
-	static uint8_t x[F25519_SIZE];
-	static uint8_t y[F25519_SIZE];
+	ED25519_SCRATCH uint8_t x[F25519_SIZE];
+	ED25519_SCRATCH uint8_t y[F25519_SIZE];
 
 	ed25519_unproject(x, y, p);
 	ed25519_pack(packed, x, y);
@@ -51,7 +69,7 @@ static void sm_pack(uint8_t *r, const uint8_t *k)
 {
 	static struct ed25519_pt p;
 
-	ed25519_smult(&p, &ed25519_base, k);
+	ed25519_smult_base(&p, k);
 	pp(r, &p);
 }
 
@@ -80,7 +98,7 @@ static void hash_message_prefix_init(struct sha512_state *s, uint8_t *block,
 static void hash_message_init(struct sha512_state *s, const uint8_t *r,
 			      const uint8_t *a, const uint8_t *m, size_t len)
 {
-	static uint8_t block[SHA512_BLOCK_SIZE];
+	ED25519_SCRATCH uint8_t block[SHA512_BLOCK_SIZE];
 
 
 	memcpy(block, r, 32);
@@ -97,9 +115,9 @@ static void hash_message_final(struct sha512_state *s, const uint8_t *m, size_t
 	sha512_final(s, m, total_len);
 }
 
-static void hash_message_finalize(struct sha512_state *s, uint8_t* z)
+static void hash_message_finalize(const struct sha512_state *s, uint8_t* z)
 {
-	static uint8_t hash[SHA512_HASH_SIZE];
+	ED25519_SCRATCH uint8_t hash[SHA512_HASH_SIZE];
 
 	sha512_get(s, hash, 0, SHA512_HASH_SIZE);
 	fprime_from_bytes(z, hash, SHA512_HASH_SIZE, ed25519_order);
@@ -110,12 +128,12 @@ static void hash_with_prefix(uint8_t *out_fp, uint8_t *init_block, int prefix_si
 	static struct sha512_state s;
 	size_t i;
 
-	if(len <= SHA512_BLOCK_SIZE - prefix_size) {
+	if(len < SHA512_BLOCK_SIZE - prefix_size) {
 		hash_message_prefix_init(&s, init_block, prefix_size, message, len);
 		hash_message_finalize(&s, out_fp);
 	} else {
 		hash_message_prefix_init(&s, init_block, prefix_size, message, SHA512_BLOCK_SIZE - prefix_size);
-		for(i = SHA512_BLOCK_SIZE - prefix_size; i < len - SHA512_BLOCK_SIZE; i += SHA512_BLOCK_SIZE)
+		for(i = SHA512_BLOCK_SIZE - prefix_size; i + SHA512_BLOCK_SIZE <= len; i += SHA512_BLOCK_SIZE)
 			hash_message_block(&s, message+i);
 		hash_message_final(&s, message+i, len+prefix_size);
 		hash_message_finalize(&s, out_fp);
@@ -163,32 +181,204 @@ void edsign_sign(uint8_t *signature, const uint8_t *pub,
 	memcpy(signature + 32, s, 32);
 }
 
-static uint8_t edsign_verify_finalize(struct sha512_state* s, const uint8_t *signature,
-				      const uint8_t *pub, const uint8_t *message)
+void edsign_sign_nonce_prefix(uint8_t *block, const uint8_t *secret)
 {
-        (void) message;
+	static uint8_t expanded[EXPANDED_SIZE];
 
-	static struct ed25519_pt p;
-	static struct ed25519_pt q;
-	static uint8_t lhs[F25519_SIZE];
-	static uint8_t rhs[F25519_SIZE];
+	expand_key(expanded, secret);
+	memcpy(block, expanded + 32, EDSIGN_NONCE_PREFIX_SIZE);
+}
+
+void edsign_sign_nonce(uint8_t *signature, uint8_t *k,
+		       const struct sha512_state *s)
+{
+	/* R = kB */
+	hash_message_finalize(s, k);
+	sm_pack(signature, k);
+}
+
+void edsign_sign_hash_prefix(uint8_t *block, const uint8_t *signature,
+			     const uint8_t *pub)
+{
+	memcpy(block, signature, 32);
+	memcpy(block + 32, pub, 32);
+}
+
+void edsign_sign_finish(uint8_t *signature, const uint8_t *secret,
+			const uint8_t *k, const struct sha512_state *s)
+{
+	static uint8_t expanded[EXPANDED_SIZE];
+	static uint8_t e[FPRIME_SIZE];
 	static uint8_t z[FPRIME_SIZE];
-	uint8_t ok = 1;
+	static uint8_t sc[FPRIME_SIZE];
 
+	expand_key(expanded, secret);
 	hash_message_finalize(s, z);
+	fprime_from_bytes(e, expanded, 32, ed25519_order);
+
+	/* s = ze + k */
+	fprime_mul(sc, z, e, ed25519_order);
+	fprime_add(sc, k, ed25519_order);
+	memcpy(signature + 32, sc, 32);
+}
+
+/* The state of the verification in progress. A step is bounded by one
+ * square root or inversion, or by one digit of the multiplication.
+ */
+enum {
+	JOB_IDLE,
+	JOB_SINGLE_SETUP,
+	JOB_BATCH_SETUP,
+	JOB_TABLES,
+	JOB_DIGITS
+};
 
-	/* sB = (ze + k)B = ... */
-	sm_pack(lhs, signature + 32);
+static struct ed25519_wnaf job_wnaf[ED25519_MSM_MAX];
+static struct ed25519_pt job_pts[ED25519_MSM_MAX - 1];
+static uint8_t job_scalars[ED25519_MSM_MAX][FPRIME_SIZE];
+static const uint8_t *job_e[ED25519_MSM_MAX];
+static const struct ed25519_pt *job_p[ED25519_MSM_MAX];
+static struct ed25519_pt job_r;
+
+static struct {
+	const struct sha512_state	*s;
+	const uint8_t			*signature;
+	const uint8_t			*pub;
+	const uint8_t			*unpacked;
+	const struct edsign_batch_item	*items;
+	unsigned int			num;
+	unsigned int			npoints;
+	int				step;
+	uint8_t				phase;
+	uint8_t				ok;
+} job;
+
+/* S has to be reduced. S + l passes the check as well as S does, which
+ * would make a second valid signature of every signature, RFC 8032 and
+ * the cofactorless check both reject it. S is public, variable time is
+ * fine.
+ */
+static uint8_t canonical_s(const uint8_t *s)
+{
+	int i;
+
+	for (i = FPRIME_SIZE - 1; i >= 0; i--)
+		if (s[i] != ed25519_order[i])
+			return s[i] < ed25519_order[i];
 
-	/* ... = zA + R */
-	ok &= upp(&p, pub);
-	ed25519_smult(&p, &p, z);
-	ok &= upp(&q, signature);
-	ed25519_add(&p, &p, &q);
-	pp(rhs, &p);
+	return 0;
+}
+
+void edsign_verify_start(const struct sha512_state *s, const uint8_t *signature,
+			 const uint8_t *pub, const uint8_t *unpacked)
+{
+	job.s = s;
+	job.signature = signature;
+	job.pub = pub;
+	job.unpacked = unpacked;
+	job.items = NULL;
+	job.phase = JOB_SINGLE_SETUP;
+	job.ok = canonical_s(signature + 32);
+
+	/* sB - zA = (ze + k)B - zA = kB = R. Everything here is public,
+	 * so use the faster variable-time double multiplication.
+	 */
+	job_e[0] = signature + 32;
+	job_p[0] = &ed25519_base;
+	job_e[1] = job_scalars[1];
+	job_p[1] = &job_pts[0];
+	job.npoints = 2;
+}
+
+static void single_setup(void)
+{
+	hash_message_finalize(job.s, job_scalars[1]);
+	job.ok &= upp_neg_pub(&job_pts[0], job.pub, job.unpacked);
+
+	job.phase = JOB_TABLES;
+	job.step = 0;
+}
+
+static uint8_t single_finish(void)
+{
+	static uint8_t lhs[F25519_SIZE];
+
+	pp(lhs, &job_r);
 
 	/* Equal? */
-	return ok & f25519_eq(lhs, rhs);
+	return job.ok & f25519_eq(lhs, job.signature);
+}
+
+#if ED25519_BATCH_MAX > 0
+static void batch_setup(void);
+static uint8_t batch_finish(void);
+#endif
+
+int edsign_verify_step(void)
+{
+	switch (job.phase) {
+	case JOB_SINGLE_SETUP:
+		single_setup();
+		break;
+
+#if ED25519_BATCH_MAX > 0
+	case JOB_BATCH_SETUP:
+		batch_setup();
+		break;
+#endif
+
+	case JOB_TABLES:
+		if (!job.ok) {
+			job.phase = JOB_IDLE;
+			return 0;
+		}
+
+		ed25519_wnaf_prepare(&job_wnaf[job.step], job_e[job.step],
+				     job_p[job.step]);
+		if (++job.step < job.npoints)
+			break;
+
+		ed25519_copy(&job_r, &ed25519_neutral);
+		job.step = ed25519_wnaf_top(job_wnaf, job.npoints);
+		job.phase = JOB_DIGITS;
+		break;
+
+	case JOB_DIGITS:
+		if (job.step >= 0) {
+			ed25519_multi_smult_digit(&job_r, job_wnaf,
+						  job.npoints, job.step--);
+			break;
+		}
+
+		job.phase = JOB_IDLE;
+#if ED25519_BATCH_MAX > 0
+		if (job.items)
+			return batch_finish();
+#endif
+		return single_finish();
+
+	default:
+		return 0;
+	}
+
+	return EDSIGN_STEP_PENDING;
+}
+
+static uint8_t job_run(void)
+{
+	int r;
+
+	while ((r = edsign_verify_step()) == EDSIGN_STEP_PENDING)
+		;
+
+	return r;
+}
+
+static uint8_t edsign_verify_finalize(const struct sha512_state* s, const uint8_t *signature,
+				      const uint8_t *pub, const uint8_t *unpacked)
+{
+	edsign_verify_start(s, signature, pub, unpacked);
+	return job_run();
 }
 
 uint8_t edsign_verify_init(struct sha512_state* s, const uint8_t *signature,
@@ -197,7 +387,7 @@ uint8_t edsign_verify_init(struct sha512_state* s, const uint8_t *signature,
 	hash_message_init(s, signature, pub, message, len);
 
 	if(len < SHA512_BLOCK_SIZE - 64)
-		return edsign_verify_finalize(s, signature, pub, message);
+		return edsign_verify_finalize(s, signature, pub, NULL);
 	return 0;
 }
 
@@ -206,10 +396,217 @@ void edsign_verify_block(struct sha512_state* s, const uint8_t *message)
 	hash_message_block(s, message);
 }
 
+void edsign_verify_block_multi(struct sha512_state* const* s, unsigned int n,
+			       const uint8_t *message)
+{
+	sha512_block_multi(s, n, message);
+}
+
 uint8_t edsign_verify_final(struct sha512_state* s, const uint8_t *signature,
 		            const uint8_t *pub, const uint8_t *message, size_t total_len)
 {
 	hash_message_final(s, message, total_len+64); 
-	return edsign_verify_finalize(s, signature, pub, message);
+	return edsign_verify_finalize(s, signature, pub, NULL);
 }
 
+void edsign_verify_hash_init(struct sha512_state* s, const uint8_t *signature,
+			     const uint8_t *pub, const uint8_t *message, size_t len)
+{
+	hash_message_init(s, signature, pub, message, len);
+}
+
+void edsign_verify_hash_final(struct sha512_state* s, const uint8_t *message,
+			      size_t total_len)
+{
+	hash_message_final(s, message, total_len+64);
+}
+
+uint8_t edsign_verify_hashed(const struct sha512_state* s, const uint8_t *signature,
+			     const uint8_t *pub, const uint8_t *unpacked)
+{
+	return edsign_verify_finalize(s, signature, pub, unpacked);
+}
+
+uint8_t edsign_verify_hashed_ws(struct edsign_verify_ws *ws,
+				const struct sha512_state *s,
+				const uint8_t *signature, const uint8_t *pub,
+				const uint8_t *unpacked)
+{
+	uint8_t ok = canonical_s(signature + 32);
+
+	hash_message_finalize(s, ws->z);
+
+	/* The same as a job, in the workspace */
+	ok &= upp_neg_pub(&ws->p, pub, unpacked);
+	ed25519_double_smult_ws(ws->wnaf, &ws->p, signature + 32,
+				&ed25519_base, ws->z, &ws->p);
+	pp(ws->lhs, &ws->p);
+
+	return ok & f25519_eq(ws->lhs, signature);
+}
+
+uint8_t edsign_unpack_pub(uint8_t *unpacked, const uint8_t *pub)
+{
+	ED25519_SCRATCH uint8_t x[F25519_SIZE];
+	uint8_t ok = ed25519_try_unpack(x, unpacked + F25519_SIZE, pub);
+
+	/* Verification needs -A, store that */
+	f25519_neg(unpacked, x);
+	return ok;
+}
+
+#if ED25519_BATCH_MAX > 0
+/* The single-signature check compares the packed sB - zA with R, so it
+ * rejects R encodings that ed25519_try_unpack() would still accept:
+ * y >= p, or "negative" zero x. Reject them here too.
+ */
+static uint8_t canonical_r(const uint8_t *r, const struct ed25519_pt *p)
+{
+	ED25519_SCRATCH uint8_t x[F25519_SIZE];
+	uint8_t high = r[31] & 0x7f;
+	int i;
+
+	for (i = 1; i < 31; i++)
+		high &= r[i];
+
+	if (high == 0x7f && r[0] >= 0xed)
+		return 0;
+
+	f25519_copy(x, p->x);
+	f25519_normalize(x);
+	return !((r[31] >> 7) && f25519_eq(x, f25519_zero));
+}
+
+/* Check sum(w_i s_i)B - sum(w_i R_i) - sum(w_i z_i A_i) = 0, where the
+ * 128-bit weights w_i are derived by hashing the whole batch.
+ */
+static struct sha512_state batch_seed;
+
+uint8_t edsign_verify_batch_start(const struct edsign_batch_item *items,
+				  unsigned int num)
+{
+	static uint8_t block[SHA512_BLOCK_SIZE];
+	unsigned int i;
+
+	if (num == 0 || num > ED25519_BATCH_MAX)
+		return 0;
+
+	/* Weights are bound to every signature, key and message */
+	sha512_init(&batch_seed);
+	for (i = 0; i < num; i++) {
+		memcpy(block, items[i].signature, 64);
+		sha512_get(items[i].s, block + 64, 0, SHA512_HASH_SIZE);
+		sha512_block(&batch_seed, block);
+	}
+
+	memset(job_scalars[0], 0, FPRIME_SIZE);
+	job_e[0] = job_scalars[0];
+	job_p[0] = &ed25519_base;
+
+	for (i = 1; i <= 2 * num; i++) {
+		job_e[i] = job_scalars[i];
+		job_p[i] = &job_pts[i - 1];
+	}
+
+	job.items = items;
+	job.num = num;
+	job.npoints = 2 * num + 1;
+	job.step = 0;
+	job.phase = JOB_BATCH_SETUP;
+	job.ok = 1;
+	return 1;
+}
+
+/* Even steps set up w_i, w_i z_i and -R_i, odd ones -A_i */
+static void batch_setup(void)
+{
+	static struct sha512_state s;
+	static uint8_t tmp[FPRIME_SIZE];
+	static uint8_t ws[FPRIME_SIZE];
+	const unsigned int i = job.step >> 1;
+	const struct edsign_batch_item *item = &job.items[i];
+
+	if (job.step & 1) {
+		job.ok &= upp_neg_pub(&job_pts[2 * i + 1], item->pub,
+				      item->unpacked);
+	} else {
+		uint8_t *w = job_scalars[2 * i + 1];
+		uint8_t *wz = job_scalars[2 * i + 2];
+		struct ed25519_pt *r = &job_pts[2 * i];
+		uint8_t last = i;
+
+		/* w_i: odd, so that it is never zero */
+		memcpy(&s, &batch_seed, sizeof(s));
+		sha512_final(&s, &last, job.num * SHA512_BLOCK_SIZE + 1);
+		memset(w, 0, FPRIME_SIZE);
+		sha512_get(&s, w, 0, 16);
+		w[0] |= 1;
+
+		/* w_i z_i */
+		hash_message_finalize(item->s, tmp);
+		fprime_mul(wz, w, tmp, ed25519_order);
+
+		/* sum += w_i s_i */
+		job.ok &= canonical_s(item->signature + 32);
+		fprime_from_bytes(tmp, item->signature + 32, 32,
+				  ed25519_order);
+		fprime_mul(ws, w, tmp, ed25519_order);
+		fprime_add(job_scalars[0], ws, ed25519_order);
+
+		/* -R_i */
+		job.ok &= upp(r, item->signature);
+		job.ok &= canonical_r(item->signature, r);
+		f25519_neg(r->x, r->x);
+		f25519_neg(r->t, r->t);
+	}
+
+	if (++job.step == 2 * job.num) {
+		job.phase = JOB_TABLES;
+		job.step = 0;
+	}
+}
+
+static uint8_t batch_finish(void)
+{
+	static uint8_t tmp[F25519_SIZE];
+	uint8_t ok = job.ok;
+
+	/* Neutral point: x = 0, y = z */
+	f25519_copy(tmp, job_r.x);
+	f25519_normalize(tmp);
+	ok &= f25519_eq(tmp, f25519_zero);
+
+	f25519_sub(tmp, job_r.y, job_r.z);
+	f25519_normalize(tmp);
+	ok &= f25519_eq(tmp, f25519_zero);
+
+	return ok;
+}
+
+uint8_t edsign_verify_batch(const struct edsign_batch_item *items,
+			    unsigned int num)
+{
+	if (!edsign_verify_batch_start(items, num))
+		return 0;
+
+	return job_run();
+}
+#else
+uint8_t edsign_verify_batch_start(const struct edsign_batch_item *items,
+				  unsigned int num)
+{
+	(void) items;
+	(void) num;
+
+	return 0;
+}
+
+uint8_t edsign_verify_batch(const struct edsign_batch_item *items,
+			    unsigned int num)
+{
+	(void) items;
+	(void) num;
+
+	return 0;
+}
+#endif
@@ -9,6 +9,8 @@
 
 #include <stdint.h>
 #include "sha512.h"
+#include "ed25519.h"
+#include "fprime.h"
 
 /* This is the Ed25519 signature system, as described in:
  *
@@ -51,11 +53,38 @@ void edsign_sign(uint8_t *signature, const uint8_t *pub,
 		 const uint8_t *secret,
 		 const uint8_t *message, size_t len);
 
+/* Signing a message that is fed in pieces, for callers that don't keep
+ * it in one buffer. The message is hashed twice, so it has to be fed
+ * twice, both times with the caller's own SHA512 state:
+ *
+ *   - start the first hash with the EDSIGN_NONCE_PREFIX_SIZE bytes
+ *     written by edsign_sign_nonce_prefix() and the message after them,
+ *     then edsign_sign_nonce() gives the nonce k and the first half of
+ *     the signature;
+ *   - start the second hash with the EDSIGN_HASH_PREFIX_SIZE bytes
+ *     written by edsign_sign_hash_prefix() and the message after them,
+ *     then edsign_sign_finish() completes the signature.
+ *
+ * The result is the same as the one of edsign_sign(). k is secret.
+ */
+#define EDSIGN_NONCE_PREFIX_SIZE	32
+#define EDSIGN_HASH_PREFIX_SIZE		64
+#define EDSIGN_NONCE_SIZE		32
+
+void edsign_sign_nonce_prefix(uint8_t *block, const uint8_t *secret);
+void edsign_sign_nonce(uint8_t *signature, uint8_t *k,
+		       const struct sha512_state *s);
+void edsign_sign_hash_prefix(uint8_t *block, const uint8_t *signature,
+			     const uint8_t *pub);
+void edsign_sign_finish(uint8_t *signature, const uint8_t *secret,
+			const uint8_t *k, const struct sha512_state *s);
+
 /* start verification. Len should be not larger than SHA512_BLOCK_SIZE - 64 bytes of data
  *   If len is less that that, then it's considered to be the whole message, otherwise
  *   edsign_verify_block and edsign_verify_finalize should be called to verify the rest
  *   of the message. When used to verify the whole message, non-zero return indicates
  *   success, otherwise it should be ignored.
+ *   All the checks below reject a signature with S >= l, like RFC 8032 does.
  */
 uint8_t edsign_verify_init(struct sha512_state* s, const uint8_t *signature,
 			const uint8_t *pub, const uint8_t *message, size_t len);
@@ -63,12 +92,107 @@ uint8_t edsign_verify_init(struct sha512_state* s, const uint8_t *signature,
 /* add block of size SHA512_BLOCK_SIZE to stream */
 void edsign_verify_block(struct sha512_state* s, const uint8_t *message);
 
+/* add the same block to the streams of n signatures over one message, see
+   sha512_block_multi() */
+void edsign_verify_block_multi(struct sha512_state* const* s, unsigned int n,
+			       const uint8_t *message);
+
 /* add last block and return result. message points to the last block, not the whole message
     Non-zero indicates success */
 uint8_t edsign_verify_final(struct sha512_state* s, const uint8_t *signature,
 			       const uint8_t* pub, const uint8_t *message,
 			       size_t total_len);
 
+/* The same as edsign_verify_init and edsign_verify_final, but they only
+ * hash the message. Once the hash is complete (after
+ * edsign_verify_hash_init with len < SHA512_BLOCK_SIZE - 64, or after
+ * edsign_verify_hash_final otherwise), check the signature with
+ * edsign_verify_hashed or edsign_verify_batch.
+ */
+void edsign_verify_hash_init(struct sha512_state* s, const uint8_t *signature,
+			     const uint8_t *pub, const uint8_t *message, size_t len);
+void edsign_verify_hash_final(struct sha512_state* s, const uint8_t *message,
+			      size_t total_len);
+
+/* Decompressing a public key costs a square root. Callers that verify
+ * many signatures with the same key can unpack it once and pass the
+ * result to edsign_verify_hashed and edsign_verify_batch, or NULL to
+ * have the key unpacked on every check. Non-zero return indicates that
+ * pub is a valid point; only such keys may be passed on.
+ */
+#define EDSIGN_UNPACKED_PUB_SIZE	64
+
+uint8_t edsign_unpack_pub(uint8_t *unpacked, const uint8_t *pub);
+
+/* Check a single signature. Non-zero indicates success */
+uint8_t edsign_verify_hashed(const struct sha512_state* s, const uint8_t *signature,
+			     const uint8_t *pub, const uint8_t *unpacked);
+
+/* edsign_verify_init(), edsign_verify_final() and edsign_verify_hashed()
+ * keep their points in static storage, so only one of them can run at a
+ * time. edsign_verify_hashed_ws() does the same check as
+ * edsign_verify_hashed() in a workspace of EDSIGN_VERIFY_WS_SIZE bytes
+ * supplied by the caller, which may live in any RAM region. Built with
+ * ED25519_REENTRANT (see scratch.h), any number of threads can hash
+ * with edsign_verify_hash_init(), edsign_verify_block() and
+ * edsign_verify_hash_final() and check with this function at once, as
+ * long as each has its own state and workspace.
+ */
+struct edsign_verify_ws {
+	struct ed25519_wnaf	wnaf[2];
+	struct ed25519_pt	p;
+	uint8_t			lhs[F25519_SIZE];
+	uint8_t			z[FPRIME_SIZE];
+};
+
+#define EDSIGN_VERIFY_WS_SIZE		sizeof(struct edsign_verify_ws)
+
+uint8_t edsign_verify_hashed_ws(struct edsign_verify_ws *ws,
+				const struct sha512_state *s,
+				const uint8_t *signature, const uint8_t *pub,
+				const uint8_t *unpacked);
+
+/* Check up to ED25519_BATCH_MAX signatures at once, which is cheaper
+ * than checking them one by one. Non-zero means that all of them are
+ * valid. Zero means that at least one is not, or that num is out of
+ * range, and the caller should check them with edsign_verify_hashed to
+ * find out which.
+ *
+ * Like other batch verifiers it may not detect a small-order component
+ * added to R. That only yields variants of signatures made by the owner
+ * of the key for the same message, which edsign_verify_hashed rejects.
+ */
+struct edsign_batch_item {
+	const struct sha512_state	*s;
+	const uint8_t			*signature;
+	const uint8_t			*pub;
+	const uint8_t			*unpacked;	/* may be NULL */
+};
+
+uint8_t edsign_verify_batch(const struct edsign_batch_item *items,
+			    unsigned int num);
+
+/* Resumable verification, for callers that can't block for a whole
+ * check. Start checking one signature with edsign_verify_start(), or a
+ * batch with edsign_verify_batch_start(), which returns zero if num is
+ * out of range. Then call edsign_verify_step() until it returns
+ * something else than EDSIGN_STEP_PENDING: non-zero means success, as
+ * for edsign_verify_hashed() and edsign_verify_batch(). A step costs at
+ * most about one inversion or square root, or one doubling and a few
+ * additions, and a check takes some 260 of them.
+ *
+ * The states, signatures and keys must stay untouched until the check
+ * is over. Only one check can be in progress, and it shares storage
+ * with the other verification functions that take no workspace.
+ */
+#define EDSIGN_STEP_PENDING		(-1)
+
+void edsign_verify_start(const struct sha512_state *s, const uint8_t *signature,
+			 const uint8_t *pub, const uint8_t *unpacked);
+uint8_t edsign_verify_batch_start(const struct edsign_batch_item *items,
+				  unsigned int num);
+int edsign_verify_step(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,7 @@
  */
 
 #include "f25519.h"
+#include "scratch.h"
 
 const uint8_t f25519_zero[F25519_SIZE] = {0};
 const uint8_t f25519_one[F25519_SIZE] = {1};
@@ -154,6 +155,7 @@ void f25519_neg(uint8_t *r, const uint8_t *a)
 	}
 }
 
+#ifndef F25519_MUL_LIMB16
 void f25519_mul__distinct(uint8_t *r, const uint8_t *a, const uint8_t *b)
 {
 	uint32_t c = 0;
@@ -182,6 +184,7 @@ void f25519_mul__distinct(uint8_t *r, const uint8_t *a, const uint8_t *b)
 		c >>= 8;
 	}
 }
+#endif
 
 void f25519_mul(uint8_t *r, const uint8_t *a, const uint8_t *b)
 {
@@ -213,54 +216,65 @@ void f25519_mul_c(uint8_t *r, const uint8_t *a, uint32_t b)
 	}
 }
 
+/* Compute r = a^(2^n) * m, using s for temporary storage. r may be the
+ * same as a, but must differ from m and s.
+ */
+static void sqr_n_mul(uint8_t *r, const uint8_t *a, int n,
+		      const uint8_t *m, uint8_t *s)
+{
+	int i;
+
+	f25519_mul__distinct(s, a, a);
+	for (i = 1; i < n; i++) {
+		f25519_mul__distinct(r, s, s);
+		f25519_copy(s, r);
+	}
+
+	f25519_mul__distinct(r, s, m);
+}
+
+/* Raise x to the power of 2^250-1, and also return x^11, which both
+ * exponentiations below need. Rather than the plain binary chain, which
+ * costs a multiplication for every bit, this is the usual addition chain
+ * of 249 squarings and 10 multiplications.
+ */
+static void exp2250(uint8_t *r, uint8_t *x11, const uint8_t *x)
+{
+	ED25519_SCRATCH uint8_t a[F25519_SIZE];
+	ED25519_SCRATCH uint8_t b[F25519_SIZE];
+	ED25519_SCRATCH uint8_t c[F25519_SIZE];
+	ED25519_SCRATCH uint8_t d[F25519_SIZE];
+	ED25519_SCRATCH uint8_t s[F25519_SIZE];
+
+	f25519_mul__distinct(a, x, x);			/* 2 */
+	sqr_n_mul(c, a, 2, x, s);			/* 9 */
+	f25519_mul__distinct(x11, c, a);		/* 11 */
+	f25519_mul__distinct(a, x11, x11);		/* 22 */
+	f25519_mul__distinct(b, a, c);			/* 2^5-1 */
+
+	sqr_n_mul(c, b, 5, b, s);			/* 2^10-1 */
+	sqr_n_mul(b, c, 10, c, s);			/* 2^20-1 */
+	sqr_n_mul(d, b, 20, b, s);			/* 2^40-1 */
+	sqr_n_mul(b, d, 10, c, s);			/* 2^50-1 */
+	sqr_n_mul(c, b, 50, b, s);			/* 2^100-1 */
+	sqr_n_mul(d, c, 100, c, s);			/* 2^200-1 */
+	sqr_n_mul(r, d, 50, b, s);			/* 2^250-1 */
+}
+
 void f25519_inv__distinct(uint8_t *r, const uint8_t *x)
 {
 	uint8_t s[F25519_SIZE];
-	int i;
+	uint8_t x11[F25519_SIZE];
 
 	/* This is a prime field, so by Fermat's little theorem:
 	 *
 	 *     x^(p-1) = 1 mod p
 	 *
 	 * Therefore, raise to (p-2) = 2^255-21 to get a multiplicative
-	 * inverse.
-	 *
-	 * This is a 255-bit binary number with the digits:
-	 *
-	 *     11111111... 01011
-	 *
-	 * We compute the result by the usual binary chain, but
-	 * alternate between keeping the accumulator in r and s, so as
-	 * to avoid copying temporaries.
+	 * inverse. That is (2^250-1) * 2^5 + 11.
 	 */
-
-	/* 1 1 */
-	f25519_mul__distinct(s, x, x);
-	f25519_mul__distinct(r, s, x);
-
-	/* 1 x 248 */
-	for (i = 0; i < 248; i++) {
-		f25519_mul__distinct(s, r, r);
-		f25519_mul__distinct(r, s, x);
-	}
-
-	/* 0 */
-	f25519_mul__distinct(s, r, r);
-
-	/* 1 */
-	f25519_mul__distinct(r, s, s);
-	f25519_mul__distinct(s, r, x);
-
-	/* 0 */
-	f25519_mul__distinct(r, s, s);
-
-	/* 1 */
-	f25519_mul__distinct(s, r, r);
-	f25519_mul__distinct(r, s, x);
-
-	/* 1 */
-	f25519_mul__distinct(s, r, r);
-	f25519_mul__distinct(r, s, x);
+	exp2250(r, x11, x);
+	sqr_n_mul(r, r, 5, x11, s);
 }
 
 void f25519_inv(uint8_t *r, const uint8_t *x)
@@ -271,42 +285,23 @@ void f25519_inv(uint8_t *r, const uint8_t *x)
 	f25519_copy(r, tmp);
 }
 
-/* Raise x to the power of (p-5)/8 = 2^252-3, using s for temporary
- * storage.
+/* Raise x to the power of (p-5)/8 = 2^252-3 = (2^250-1) * 2^2 + 1,
+ * using s for temporary storage.
  */
 static void exp2523(uint8_t *r, const uint8_t *x, uint8_t *s)
 {
-	int i;
-
-	/* This number is a 252-bit number with the binary expansion:
-	 *
-	 *     111111... 01
-	 */
-
-	/* 1 1 */
-	f25519_mul__distinct(r, x, x);
-	f25519_mul__distinct(s, r, x);
-
-	/* 1 x 248 */
-	for (i = 0; i < 248; i++) {
-		f25519_mul__distinct(r, s, s);
-		f25519_mul__distinct(s, r, x);
-	}
-
-	/* 0 */
-	f25519_mul__distinct(r, s, s);
+	uint8_t x11[F25519_SIZE];
 
-	/* 1 */
-	f25519_mul__distinct(s, r, r);
-	f25519_mul__distinct(r, s, x);
+	exp2250(r, x11, x);
+	sqr_n_mul(r, r, 2, x, s);
 }
 
 void f25519_sqrt(uint8_t *r, const uint8_t *a)
 {
-	static uint8_t v[F25519_SIZE];
-	static uint8_t i[F25519_SIZE];
-	static uint8_t x[F25519_SIZE];
-	static uint8_t y[F25519_SIZE];
+	ED25519_SCRATCH uint8_t v[F25519_SIZE];
+	ED25519_SCRATCH uint8_t i[F25519_SIZE];
+	ED25519_SCRATCH uint8_t x[F25519_SIZE];
+	ED25519_SCRATCH uint8_t y[F25519_SIZE];
 
 	/* v = (2a)^((p-5)/8) [x = 2a] */
 	f25519_mul_c(x, a, 2);
@@ -10,6 +10,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "scratch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Field elements are represented as little-endian byte strings. All
  * operations have timings which are independent of input data, so they
  * can be safely used for cryptography.
@@ -63,9 +69,15 @@ void f25519_neg(uint8_t *r, const uint8_t *a);
 
 /* Multiply two field points. The __distinct variant is used when r is
  * known to be in a different location to a and b.
+ *
+ * The default implementation works on single bytes and is the smallest.
+ * Defining F25519_MUL_LIMB16 replaces it with the one in
+ * f25519_limb16.c, which uses 16-bit limbs and is several times faster
+ * on cores with a 32x32->32 multiplier.
  */
 void f25519_mul(uint8_t *r, const uint8_t *a, const uint8_t *b);
-void f25519_mul__distinct(uint8_t *r, const uint8_t *a, const uint8_t *b);
+ED25519_HOT void f25519_mul__distinct(uint8_t *r, const uint8_t *a,
+				  const uint8_t *b);
 
 /* Multiply a point by a small constant. The two pointers are not
  * required to be distinct.
@@ -89,4 +101,8 @@ void f25519_inv__distinct(uint8_t *r, const uint8_t *x);
  */
 void f25519_sqrt(uint8_t *r, const uint8_t *x);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
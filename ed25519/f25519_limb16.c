@@ -0,0 +1,124 @@
+/* Arithmetic mod p = 2^255-19, 16-bit limb multiplication backend
+ *
+ * This file is in the public domain.
+ */
+
+#include "f25519.h"
+
+#ifdef F25519_MUL_LIMB16
+
+/* Field elements keep their little-endian byte string representation at
+ * the API boundary, but multiplication is done on 16 limbs of 16 bits
+ * each. Every partial product then fits the 32x32->32 multiplier of
+ * small cores like the Cortex-M0+, and there are 256 of them instead of
+ * the 1024 done by the byte-wise code. The product is built a row at a
+ * time: a product of two limbs plus a limb of the result and a carry is
+ * below 2^32, so the inner loops have fixed bounds and no 64-bit
+ * arithmetic.
+ */
+#define LIMBS		(F25519_SIZE / 2)
+
+ED25519_HOT static void load_limbs(uint32_t *l, const uint8_t *x)
+{
+	int i;
+
+	for (i = 0; i < LIMBS; i++)
+		l[i] = ((uint32_t)x[2 * i]) | (((uint32_t)x[2 * i + 1]) << 8);
+}
+
+/* Take a 512-bit product in t, 16 bits per word, and reduce it to an
+ * element < 2p
+ */
+ED25519_HOT static void reduce_store(uint8_t *r, uint32_t *t)
+{
+	uint32_t c = 0;
+	int i;
+
+	/* Reduce with 2^256 = 38 mod p */
+	for (i = 0; i < LIMBS; i++) {
+		c += t[i] + t[i + LIMBS] * 38;
+		t[i] = c & 0xffff;
+		c >>= 16;
+	}
+
+	/* Reduce what is left above 2^255 with 2^255 = 19 mod p */
+	c = ((c << 1) | (t[LIMBS - 1] >> 15)) * 19;
+	t[LIMBS - 1] &= 0x7fff;
+
+	for (i = 0; i < LIMBS; i++) {
+		c += t[i];
+		r[2 * i] = c;
+		r[2 * i + 1] = c >> 8;
+		c >>= 16;
+	}
+}
+
+ED25519_HOT static void sqr__distinct(uint8_t *r, const uint8_t *a)
+{
+	uint32_t x[LIMBS];
+	uint32_t t[LIMBS * 2];
+	uint32_t c;
+	int i, j;
+
+	load_limbs(x, a);
+	memset(t, 0, sizeof(t));
+
+	/* Each cross product appears twice, count it once */
+	for (i = 0; i < LIMBS - 1; i++) {
+		c = 0;
+		for (j = i + 1; j < LIMBS; j++) {
+			c += x[i] * x[j] + t[i + j];
+			t[i + j] = c & 0xffff;
+			c >>= 16;
+		}
+		t[i + LIMBS] = c;
+	}
+
+	/* Double them and add the squares */
+	c = 0;
+	for (i = 0; i < LIMBS; i++) {
+		uint32_t sq = x[i] * x[i];
+
+		c += (t[2 * i] << 1) + (sq & 0xffff);
+		t[2 * i] = c & 0xffff;
+		c >>= 16;
+		c += (t[2 * i + 1] << 1) + (sq >> 16);
+		t[2 * i + 1] = c & 0xffff;
+		c >>= 16;
+	}
+
+	reduce_store(r, t);
+}
+
+void f25519_mul__distinct(uint8_t *r, const uint8_t *a, const uint8_t *b)
+{
+	uint32_t x[LIMBS];
+	uint32_t y[LIMBS];
+	uint32_t t[LIMBS * 2];
+	uint32_t c;
+	int i, j;
+
+	/* Exponentiation chains are mostly squarings */
+	if (a == b) {
+		sqr__distinct(r, a);
+		return;
+	}
+
+	load_limbs(x, a);
+	load_limbs(y, b);
+	memset(t, 0, sizeof(t[0]) * LIMBS);
+
+	for (i = 0; i < LIMBS; i++) {
+		c = 0;
+		for (j = 0; j < LIMBS; j++) {
+			c += x[i] * y[j] + t[i + j];
+			t[i + j] = c & 0xffff;
+			c >>= 16;
+		}
+		t[i + LIMBS] = c;
+	}
+
+	reduce_store(r, t);
+}
+
+#endif
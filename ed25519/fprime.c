@@ -70,6 +70,96 @@ static void shift_n_bits(uint8_t *x, int n)
 	}
 }
 
+/* Multiplication and reduction modulo the ed25519 group order
+ *
+ *     l = 2^252 + 27742317777372353535851937790883648493
+ *
+ * is done on 16-bit limbs with Barrett reduction (HAC 14.42), instead
+ * of bit by bit. That is most of the field arithmetic done by edsign,
+ * and every product fits a 32x32->32 multiplier. Other moduli take the
+ * generic path.
+ */
+#define LIMBS		(FPRIME_SIZE / 2)
+
+static const uint8_t order_l[FPRIME_SIZE] = {
+	0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+	0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+static const uint16_t l_limbs[LIMBS] = {
+	0xd3ed, 0x5cf5, 0x631a, 0x5812, 0x9cd6, 0xa2f7, 0xf9de, 0x14de,
+	0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x1000
+};
+
+/* mu = floor(2^512 / l) */
+static const uint16_t l_mu[LIMBS + 1] = {
+	0x131b, 0x0a2c, 0xe5a3, 0xed9c, 0x29a7, 0x0863, 0x215d, 0x2106,
+	0xffeb, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff, 0xffff,
+	0x000f
+};
+
+static inline int is_order_l(const uint8_t *modulus)
+{
+	return !memcmp(modulus, order_l, FPRIME_SIZE);
+}
+
+/* Reduce a 512-bit number x, given as little-endian limbs */
+static void barrett_l(uint8_t *r, const uint16_t *x)
+{
+	const uint16_t *q1 = x + LIMBS - 1;
+	uint16_t q3[LIMBS + 1];
+	uint64_t c = 0;
+	uint32_t b = 0;
+	int i, k;
+
+	/* q3 = floor(q1 * mu / b^(k+1)), where q1 = floor(x / b^(k-1)) */
+	for (k = 0; k < 2 * LIMBS + 1; k++) {
+		int j = (k < LIMBS + 1) ? k : LIMBS;
+
+		for (i = k - j; j >= 0 && i < LIMBS + 1; i++, j--)
+			c += ((uint32_t)q1[i]) * ((uint32_t)l_mu[j]);
+
+		if (k >= LIMBS + 1)
+			q3[k - LIMBS - 1] = c;
+		c >>= 16;
+	}
+	q3[LIMBS] = c;
+
+	/* r = (x - q3 * l) mod b^(k+1), which is less than 3l */
+	c = 0;
+	for (k = 0; k < LIMBS + 1; k++) {
+		uint32_t d;
+
+		for (i = 0; i <= k; i++)
+			if (k - i < LIMBS)
+				c += ((uint32_t)q3[i]) * ((uint32_t)l_limbs[k - i]);
+
+		d = ((uint32_t)x[k]) - (c & 0xffff) - b;
+		b = (d >> 16) & 1;
+		c >>= 16;
+
+		/* The top limb is zero, r fits in FPRIME_SIZE bytes */
+		if (k < LIMBS) {
+			r[2 * k] = d;
+			r[2 * k + 1] = d >> 8;
+		}
+	}
+
+	raw_try_sub(r, order_l);
+	raw_try_sub(r, order_l);
+}
+
+static void load_limbs(uint16_t *l, const uint8_t *x, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < LIMBS * 2; i++)
+		l[i] = ((2 * i < len) ? x[2 * i] : 0) |
+			((2 * i + 1 < len) ? (((uint16_t)x[2 * i + 1]) << 8) : 0);
+}
+
 static inline int min_int(int a, int b)
 {
 	return a < b ? a : b;
@@ -85,6 +175,14 @@ void fprime_from_bytes(uint8_t *n,
 	const int rbits = (len << 3) - preload_total;
 	int i;
 
+	if (len <= FPRIME_SIZE * 2 && is_order_l(modulus)) {
+		uint16_t t[LIMBS * 2];
+
+		load_limbs(t, x, len);
+		barrett_l(n, t);
+		return;
+	}
+
 	memset(n, 0, FPRIME_SIZE);
 
 	for (i = 0; i < preload_bytes; i++)
@@ -126,6 +224,31 @@ void fprime_mul(uint8_t *r, const uint8_t *a, const uint8_t *b,
 {
 	int i;
 
+	if (is_order_l(modulus)) {
+		uint16_t x[LIMBS * 2];
+		uint16_t y[LIMBS * 2];
+		uint16_t t[LIMBS * 2];
+		uint64_t c = 0;
+		int k;
+
+		load_limbs(x, a, FPRIME_SIZE);
+		load_limbs(y, b, FPRIME_SIZE);
+
+		for (k = 0; k < LIMBS * 2 - 1; k++) {
+			int j = (k < LIMBS) ? k : LIMBS - 1;
+
+			for (i = k - j; j >= 0 && i < LIMBS; i++, j--)
+				c += ((uint32_t)x[i]) * ((uint32_t)y[j]);
+
+			t[k] = c;
+			c >>= 16;
+		}
+		t[LIMBS * 2 - 1] = c;
+
+		barrett_l(r, t);
+		return;
+	}
+
 	memset(r, 0, FPRIME_SIZE);
 
 	for (i = prime_msb(modulus); i >= 0; i--) {
@@ -10,6 +10,10 @@
 #include <stdint.h>
 #include <string.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* Maximum size of a field element (or a prime). Field elements are
  * always manipulated and stored in normalized form, with 0 <= x < p.
  * You can use normalize() to convert a denormalized bitstring to normal
@@ -48,5 +52,7 @@ void fprime_add(uint8_t *r, const uint8_t *a, const uint8_t *modulus);
 void fprime_mul(uint8_t *r, const uint8_t *a, const uint8_t *b,
 		const uint8_t *modulus);
 
-
+#ifdef __cplusplus
+}
+#endif
 #endif
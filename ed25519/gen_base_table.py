@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Generate ed25519_base_table.c: fixed-base comb tables for ed25519_smult_base().
+
+For a comb with t teeth and d = ceil(256 / t) bits per tooth, entry i of the
+table is sum(bit_j(i) * 2^(j*d) * B) for j < t, stored as affine x, y and
+t = x*y. Entry 0 is the neutral point.
+
+Usage: gen_base_table.py > ed25519_base_table.c
+"""
+
+P = 2**255 - 19
+D = (-121665 * pow(121666, P - 2, P)) % P
+BASE = (15112221349535400772501151409588531511454012693041857206046113283949847762202,
+        46316835694926478169428394003475163141307993866256225615783033603165251855960)
+TEETH = (4, 5, 6)
+
+
+def add(p1, p2):
+    x1, y1 = p1
+    x2, y2 = p2
+    k = D * x1 * x2 * y1 * y2 % P
+    x3 = (x1 * y2 + y1 * x2) * pow(1 + k, P - 2, P) % P
+    y3 = (y1 * y2 + x1 * x2) * pow(1 - k, P - 2, P) % P
+    return x3, y3
+
+
+def mult(e, p):
+    r = (0, 1)
+    while e:
+        if e & 1:
+            r = add(r, p)
+        p = add(p, p)
+        e >>= 1
+    return r
+
+
+def fe(v):
+    b = v.to_bytes(32, 'little')
+    return '\t\t{' + ', '.join('0x%02x' % c for c in b[:16]) + ',\n\t\t ' + \
+        ', '.join('0x%02x' % c for c in b[16:]) + '}'
+
+
+def table(teeth):
+    d = -(-256 // teeth)
+    spokes = [mult(1 << (j * d), BASE) for j in range(teeth)]
+    out = []
+    for i in range(1 << teeth):
+        pt = (0, 1)
+        for j in range(teeth):
+            if i & (1 << j):
+                pt = add(pt, spokes[j])
+        out.append(pt)
+    return out
+
+
+def main():
+    print('/* Fixed-base comb tables for ed25519_smult_base()')
+    print(' *')
+    print(' * Generated by gen_base_table.py, do not edit.')
+    print(' *')
+    print(' * This file is in the public domain.')
+    print(' */')
+    print()
+    print('#include "ed25519.h"')
+    print()
+    for i, teeth in enumerate(TEETH):
+        print('#%s ED25519_BASE_COMB_TEETH == %d' % ('if' if i == 0 else 'elif', teeth))
+        print('const uint8_t ed25519_base_comb[1 << ED25519_BASE_COMB_TEETH][3][F25519_SIZE] = {')
+        rows = []
+        for x, y in table(teeth):
+            rows.append('\t{\n' + ',\n'.join(fe(v) for v in (x, y, x * y % P)) + '\n\t}')
+        print(',\n'.join(rows))
+        print('};')
+    print('#endif')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,35 @@
+/* Storage class of temporaries, placement of the hottest code
+ *
+ * This file is in the public domain.
+ */
+
+#ifndef SCRATCH_H_
+#define SCRATCH_H_
+
+/* The field, curve and hash functions keep their temporaries in static
+ * storage by default, which keeps them off small stacks but lets only
+ * one computation run at a time. Define ED25519_REENTRANT to put them
+ * on the stack instead (a few hundred bytes at most). Together with the
+ * workspace passed to edsign_verify_hashed_ws(), this allows several
+ * threads to hash and verify at once.
+ */
+#ifdef ED25519_REENTRANT
+#define ED25519_SCRATCH
+#else
+#define ED25519_SCRATCH		static
+#endif
+
+/* f25519_mul__distinct and sha512_block, with the helpers they call, take
+ * most of the time of a signature check. Define ED25519_RAMFUNC to put
+ * them into section .ramfunc, which a target copies into RAM at startup
+ * if its flash has wait states (see machine/kea128/SKEAZ_flash.ld). The
+ * helpers are those of the limb16 and word32 backends, meant for such
+ * targets. The calls are long, as RAM may be out of branch range of flash.
+ */
+#ifdef ED25519_RAMFUNC
+#define ED25519_HOT		__attribute__((section(".ramfunc"), long_call, noinline))
+#else
+#define ED25519_HOT
+#endif
+
+#endif
@@ -0,0 +1,148 @@
+/* SHA256
+ *
+ * This file is in the public domain.
+ */
+
+#include "sha256.h"
+#include "scratch.h"
+
+const struct sha256_state sha256_initial_state = { {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+} };
+
+static const uint32_t round_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static inline uint32_t load32(const uint8_t *x)
+{
+	return ((uint32_t)x[0] << 24) | ((uint32_t)x[1] << 16) |
+		((uint32_t)x[2] << 8) | x[3];
+}
+
+static inline void store32(uint8_t *x, uint32_t v)
+{
+	x[0] = v >> 24;
+	x[1] = v >> 16;
+	x[2] = v >> 8;
+	x[3] = v;
+}
+
+static inline void store64(uint8_t *x, uint64_t v)
+{
+	store32(x, v >> 32);
+	store32(x + 4, v);
+}
+
+#define ROT(x, n)	(((x) >> (n)) | ((x) << (32 - (n))))
+
+/* w[j] becomes w[j + 16] */
+#define SCHEDULE(j) do {						\
+		const uint32_t w15 = w[((j) + 1) & 15];			\
+		const uint32_t w2 = w[((j) + 14) & 15];			\
+									\
+		w[(j) & 15] += (ROT(w15, 7) ^ ROT(w15, 18) ^ (w15 >> 3)) + \
+			(ROT(w2, 17) ^ ROT(w2, 19) ^ (w2 >> 10)) +	\
+			w[((j) + 9) & 15];				\
+	} while (0)
+
+/* One round, updating d and h in place of shuffling all eight */
+#define ROUND(a, b, c, d, e, f, g, h, j) do {				\
+		uint32_t t1;						\
+									\
+		if ((j) >= 16)						\
+			SCHEDULE(j);					\
+									\
+		t1 = v[h] + (ROT(v[e], 6) ^ ROT(v[e], 11) ^ ROT(v[e], 25)) + \
+			(v[g] ^ (v[e] & (v[f] ^ v[g]))) +		\
+			round_k[j] + w[(j) & 15];			\
+		v[d] += t1;						\
+		v[h] = t1 + (ROT(v[a], 2) ^ ROT(v[a], 13) ^ ROT(v[a], 22)) + \
+			((v[a] & v[b]) | (v[c] & (v[a] | v[b])));	\
+	} while (0)
+
+void sha256_block(struct sha256_state *s, const uint8_t *blk)
+{
+	ED25519_SCRATCH uint32_t w[16];
+	ED25519_SCRATCH uint32_t v[8];
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = load32(blk);
+		blk += 4;
+	}
+
+	/* Load state */
+	for (i = 0; i < 8; i++)
+		v[i] = s->h[i];
+
+	for (i = 0; i < 64; i += 8) {
+		ROUND(0, 1, 2, 3, 4, 5, 6, 7, i);
+		ROUND(7, 0, 1, 2, 3, 4, 5, 6, i + 1);
+		ROUND(6, 7, 0, 1, 2, 3, 4, 5, i + 2);
+		ROUND(5, 6, 7, 0, 1, 2, 3, 4, i + 3);
+		ROUND(4, 5, 6, 7, 0, 1, 2, 3, i + 4);
+		ROUND(3, 4, 5, 6, 7, 0, 1, 2, i + 5);
+		ROUND(2, 3, 4, 5, 6, 7, 0, 1, i + 6);
+		ROUND(1, 2, 3, 4, 5, 6, 7, 0, i + 7);
+	}
+
+	/* Store state */
+	for (i = 0; i < 8; i++)
+		s->h[i] += v[i];
+}
+
+void sha256_final(struct sha256_state *s, const uint8_t *blk,
+		  size_t total_size)
+{
+	ED25519_SCRATCH uint8_t temp[SHA256_BLOCK_SIZE];
+	const size_t last_size = total_size & (SHA256_BLOCK_SIZE - 1);
+
+	memset(temp, 0, sizeof(temp));
+
+	if (last_size)
+		memcpy(temp, blk, last_size);
+	temp[last_size] = 0x80;
+
+	if (last_size > 55) {
+		sha256_block(s, temp);
+		memset(temp, 0, sizeof(temp));
+	}
+
+	store64(temp + SHA256_BLOCK_SIZE - 8, (uint64_t)total_size << 3);
+	sha256_block(s, temp);
+}
+
+void sha256_get(const struct sha256_state *s, uint8_t *hash,
+		unsigned int offset, unsigned int len)
+{
+	uint8_t tmp[SHA256_HASH_SIZE];
+	int i;
+
+	if (offset > SHA256_HASH_SIZE)
+		return;
+
+	if (len > SHA256_HASH_SIZE - offset)
+		len = SHA256_HASH_SIZE - offset;
+
+	for (i = 0; i < 8; i++)
+		store32(tmp + i * 4, s->h[i]);
+
+	memcpy(hash, tmp + offset, len);
+}
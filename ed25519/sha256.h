@@ -0,0 +1,56 @@
+/* SHA256
+ *
+ * This file is in the public domain.
+ */
+
+#ifndef SHA256_H_
+#define SHA256_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* SHA256 state, with the same interface as SHA512 in sha512.h. The
+ * arithmetic is all on 32-bit words, so it costs a 32-bit core about
+ * half as much per byte as SHA512.
+ */
+struct sha256_state {
+	uint32_t	h[8];
+};
+
+/* Initial state */
+extern const struct sha256_state sha256_initial_state;
+
+/* Set up a new context */
+static inline void sha256_init(struct sha256_state *s)
+{
+	memcpy(s, &sha256_initial_state, sizeof(*s));
+}
+
+/* Feed a full block in */
+#define SHA256_BLOCK_SIZE	64
+
+void sha256_block(struct sha256_state *s, const uint8_t *blk);
+
+/* Feed the last partial block in. The total stream size must be
+ * specified. The size of the block given is assumed to be (total_size %
+ * SHA256_BLOCK_SIZE). This might be zero, but you still need to call
+ * this function to terminate the stream.
+ */
+void sha256_final(struct sha256_state *s, const uint8_t *blk,
+		  size_t total_size);
+
+/* Fetch a slice of the hash result. */
+#define SHA256_HASH_SIZE	32
+
+void sha256_get(const struct sha256_state *s, uint8_t *hash,
+		unsigned int offset, unsigned int len);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
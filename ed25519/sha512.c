@@ -5,6 +5,7 @@
  */
 
 #include "sha512.h"
+#include "scratch.h"
 
 const struct sha512_state sha512_initial_state = { {
 	0x6a09e667f3bcc908LL, 0xbb67ae8584caa73bLL,
@@ -13,7 +14,8 @@ const struct sha512_state sha512_initial_state = { {
 	0x1f83d9abfb41bd6bLL, 0x5be0cd19137e2179LL,
 } };
 
-static const uint64_t round_k[80] = {
+/* Round constants, shared with the other compression backends */
+const uint64_t sha512_round_k[80] = {
 	0x428a2f98d728ae22LL, 0x7137449123ef65cdLL,
 	0xb5c0fbcfec4d3b2fLL, 0xe9b5dba58189dbbcLL,
 	0x3956c25bf348b538LL, 0x59f111f1b605d019LL,
@@ -92,6 +94,7 @@ static inline void store64(uint8_t *x, uint64_t v)
 	*(x--) = v;
 }
 
+#ifndef SHA512_BLOCK_WORD32
 static inline uint64_t rot64(uint64_t x, int bits)
 {
 	return (x >> bits) | (x << (64 - bits));
@@ -99,8 +102,8 @@ static inline uint64_t rot64(uint64_t x, int bits)
 
 void sha512_block(struct sha512_state *s, const uint8_t *blk)
 {
-	static uint64_t w[16];
-	static uint64_t a, b, c, d, e, f, g, h;
+	ED25519_SCRATCH uint64_t w[16];
+	ED25519_SCRATCH uint64_t a, b, c, d, e, f, g, h;
 	int i;
 
 	for (i = 0; i < 16; i++) {
@@ -119,20 +122,20 @@ void sha512_block(struct sha512_state *s, const uint8_t *blk)
 	h = s->h[7];
 
 	for (i = 0; i < 80; i++) {
-		static uint64_t wi;
-		static uint64_t wi15;
-		static uint64_t wi2;
-		static uint64_t wi7;
-		static uint64_t s0;
-		static uint64_t s1;
+		ED25519_SCRATCH uint64_t wi;
+		ED25519_SCRATCH uint64_t wi15;
+		ED25519_SCRATCH uint64_t wi2;
+		ED25519_SCRATCH uint64_t wi7;
+		ED25519_SCRATCH uint64_t s0;
+		ED25519_SCRATCH uint64_t s1;
 
 		/* Round calculations */
-		static uint64_t S0;
-		static uint64_t S1;
-		static uint64_t ch;
-		static uint64_t temp1;
-		static uint64_t maj;
-		static uint64_t temp2;
+		ED25519_SCRATCH uint64_t S0;
+		ED25519_SCRATCH uint64_t S1;
+		ED25519_SCRATCH uint64_t ch;
+		ED25519_SCRATCH uint64_t temp1;
+		ED25519_SCRATCH uint64_t maj;
+		ED25519_SCRATCH uint64_t temp2;
 
 		/* Compute value of w[i + 16]. w[wrap(i)] is currently w[i] */
 		wi = w[i & 15];
@@ -148,7 +151,7 @@ void sha512_block(struct sha512_state *s, const uint8_t *blk)
 		S0 = rot64(a, 28) ^ rot64(a, 34) ^ rot64(a, 39);
 		S1 = rot64(e, 14) ^ rot64(e, 18) ^ rot64(e, 41);
 		ch = (e & f) ^ ((~e) & g);
-		temp1 = h + S1 + ch + round_k[i] + wi;
+		temp1 = h + S1 + ch + sha512_round_k[i] + wi;
 		maj = (a & b) ^ (a & c) ^ (b & c);
 		temp2 = S0 + maj;
 
@@ -177,10 +180,179 @@ void sha512_block(struct sha512_state *s, const uint8_t *blk)
 	s->h[7] += h;
 }
 
+/* w[i] plus its round constant, and w[wrap(i)] becomes w[i + 16] */
+static inline uint64_t schedule_wk(uint64_t *w, int i)
+{
+	const uint64_t wi = w[i & 15];
+	const uint64_t wi15 = w[(i + 1) & 15];
+	const uint64_t wi2 = w[(i + 14) & 15];
+
+	w[i & 15] = wi + w[(i + 9) & 15] +
+		(rot64(wi15, 1) ^ rot64(wi15, 8) ^ (wi15 >> 7)) +
+		(rot64(wi2, 19) ^ rot64(wi2, 61) ^ (wi2 >> 6));
+
+	return wi + sha512_round_k[i];
+}
+
+#ifdef __AVX2__
+#include <immintrin.h>
+
+/* Each of the eight working variables holds four states, one in each
+ * 64-bit lane. The round constant and the message word are the same in
+ * all of them.
+ */
+#define VROT(x, n)	_mm256_or_si256(_mm256_srli_epi64(x, n),	\
+					_mm256_slli_epi64(x, 64 - (n)))
+
+#define VROUND(a, b, c, d, e, f, g, h, i) do {				\
+		__m256i t1 = _mm256_add_epi64(v[h],			\
+			_mm256_set1_epi64x((long long)schedule_wk(w, i)));\
+		__m256i t2;						\
+									\
+		t1 = _mm256_add_epi64(t1, _mm256_xor_si256(		\
+			_mm256_xor_si256(VROT(v[e], 14), VROT(v[e], 18)),\
+			VROT(v[e], 41)));				\
+		t1 = _mm256_add_epi64(t1, _mm256_xor_si256(v[g],	\
+			_mm256_and_si256(v[e],				\
+				_mm256_xor_si256(v[f], v[g]))));	\
+		t2 = _mm256_xor_si256(					\
+			_mm256_xor_si256(VROT(v[a], 28), VROT(v[a], 34)),\
+			VROT(v[a], 39));				\
+		t2 = _mm256_add_epi64(t2, _mm256_or_si256(		\
+			_mm256_and_si256(v[a], v[b]),			\
+			_mm256_and_si256(v[c],				\
+				_mm256_or_si256(v[a], v[b]))));		\
+		v[d] = _mm256_add_epi64(v[d], t1);			\
+		v[h] = _mm256_add_epi64(t1, t2);			\
+	} while (0)
+
+/* Two to four states, the lanes of the missing ones are computed on a
+ * copy of the first and dropped
+ */
+static void sha512_block_lanes(struct sha512_state *const *s,
+			       unsigned int n, const uint8_t *blk)
+{
+	ED25519_SCRATCH uint64_t w[16];
+	ED25519_SCRATCH uint64_t out[4];
+	__m256i v[8];
+	const struct sha512_state *l1 = s[n > 1 ? 1 : 0];
+	const struct sha512_state *l2 = s[n > 2 ? 2 : 0];
+	const struct sha512_state *l3 = s[n > 3 ? 3 : 0];
+	unsigned int l;
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		w[i] = load64(blk);
+		blk += 8;
+	}
+
+	for (i = 0; i < 8; i++)
+		v[i] = _mm256_set_epi64x((long long)l3->h[i],
+					 (long long)l2->h[i],
+					 (long long)l1->h[i],
+					 (long long)s[0]->h[i]);
+
+	for (i = 0; i < 80; i += 8) {
+		VROUND(0, 1, 2, 3, 4, 5, 6, 7, i);
+		VROUND(7, 0, 1, 2, 3, 4, 5, 6, i + 1);
+		VROUND(6, 7, 0, 1, 2, 3, 4, 5, i + 2);
+		VROUND(5, 6, 7, 0, 1, 2, 3, 4, i + 3);
+		VROUND(4, 5, 6, 7, 0, 1, 2, 3, i + 4);
+		VROUND(3, 4, 5, 6, 7, 0, 1, 2, i + 5);
+		VROUND(2, 3, 4, 5, 6, 7, 0, 1, i + 6);
+		VROUND(1, 2, 3, 4, 5, 6, 7, 0, i + 7);
+	}
+
+	for (i = 0; i < 8; i++) {
+		_mm256_storeu_si256((__m256i *)out, v[i]);
+		for (l = 0; l < n; l++)
+			s[l]->h[i] += out[l];
+	}
+}
+#else
+/* One round of the working variables prefixed with x, d and h updated in
+ * place of shuffling all eight
+ */
+#define ROUND(x, a, b, c, d, e, f, g, h, wk) do {			\
+		const uint64_t t1 = x##h + (wk) +			\
+			(rot64(x##e, 14) ^ rot64(x##e, 18) ^		\
+			 rot64(x##e, 41)) +				\
+			(x##g ^ (x##e & (x##f ^ x##g)));		\
+									\
+		x##d += t1;						\
+		x##h = t1 +						\
+			(rot64(x##a, 28) ^ rot64(x##a, 34) ^		\
+			 rot64(x##a, 39)) +				\
+			((x##a & x##b) | (x##c & (x##a | x##b)));	\
+	} while (0)
+
+/* The same round of two states, which don't depend on each other */
+#define ROUND2(a, b, c, d, e, f, g, h, i) do {				\
+		const uint64_t wk = schedule_wk(w, i);			\
+									\
+		ROUND(x, a, b, c, d, e, f, g, h, wk);			\
+		ROUND(y, a, b, c, d, e, f, g, h, wk);			\
+	} while (0)
+
+/* Two states, n is always 2 */
+static void sha512_block_lanes(struct sha512_state *const *s,
+			       unsigned int n, const uint8_t *blk)
+{
+	ED25519_SCRATCH uint64_t w[16];
+	uint64_t x0, x1, x2, x3, x4, x5, x6, x7;
+	uint64_t y0, y1, y2, y3, y4, y5, y6, y7;
+	int i;
+
+	(void)n;
+	for (i = 0; i < 16; i++) {
+		w[i] = load64(blk);
+		blk += 8;
+	}
+
+	x0 = s[0]->h[0]; x1 = s[0]->h[1]; x2 = s[0]->h[2]; x3 = s[0]->h[3];
+	x4 = s[0]->h[4]; x5 = s[0]->h[5]; x6 = s[0]->h[6]; x7 = s[0]->h[7];
+	y0 = s[1]->h[0]; y1 = s[1]->h[1]; y2 = s[1]->h[2]; y3 = s[1]->h[3];
+	y4 = s[1]->h[4]; y5 = s[1]->h[5]; y6 = s[1]->h[6]; y7 = s[1]->h[7];
+
+	for (i = 0; i < 80; i += 8) {
+		ROUND2(0, 1, 2, 3, 4, 5, 6, 7, i);
+		ROUND2(7, 0, 1, 2, 3, 4, 5, 6, i + 1);
+		ROUND2(6, 7, 0, 1, 2, 3, 4, 5, i + 2);
+		ROUND2(5, 6, 7, 0, 1, 2, 3, 4, i + 3);
+		ROUND2(4, 5, 6, 7, 0, 1, 2, 3, i + 4);
+		ROUND2(3, 4, 5, 6, 7, 0, 1, 2, i + 5);
+		ROUND2(2, 3, 4, 5, 6, 7, 0, 1, i + 6);
+		ROUND2(1, 2, 3, 4, 5, 6, 7, 0, i + 7);
+	}
+
+	s[0]->h[0] += x0; s[0]->h[1] += x1; s[0]->h[2] += x2;
+	s[0]->h[3] += x3; s[0]->h[4] += x4; s[0]->h[5] += x5;
+	s[0]->h[6] += x6; s[0]->h[7] += x7;
+	s[1]->h[0] += y0; s[1]->h[1] += y1; s[1]->h[2] += y2;
+	s[1]->h[3] += y3; s[1]->h[4] += y4; s[1]->h[5] += y5;
+	s[1]->h[6] += y6; s[1]->h[7] += y7;
+}
+#endif
+
+void sha512_block_multi(struct sha512_state *const *s, unsigned int n,
+			const uint8_t *blk)
+{
+	while (n >= 2) {
+		const unsigned int k = (n < SHA512_LANES) ? n : SHA512_LANES;
+
+		sha512_block_lanes(s, k, blk);
+		s += k;
+		n -= k;
+	}
+	if (n > 0)
+		sha512_block(s[0], blk);
+}
+#endif
+
 void sha512_final(struct sha512_state *s, const uint8_t *blk,
 		  size_t total_size)
 {
-	static uint8_t temp[SHA512_BLOCK_SIZE];
+	ED25519_SCRATCH uint8_t temp[SHA512_BLOCK_SIZE];
 	const size_t last_size = total_size & (SHA512_BLOCK_SIZE - 1);
 
 	memset(temp, 0, sizeof(temp));
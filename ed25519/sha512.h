@@ -11,6 +11,8 @@
 #include <stddef.h>
 #include <string.h>
 
+#include "scratch.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,10 +36,30 @@ static inline void sha512_init(struct sha512_state *s)
 	memcpy(s, &sha512_initial_state, sizeof(*s));
 }
 
-/* Feed a full block in */
+/* Feed a full block in. The compression function is the generic one in
+ * sha512.c, or the 32-bit one in sha512_word32.c if SHA512_BLOCK_WORD32
+ * is defined.
+ */
 #define SHA512_BLOCK_SIZE	128
 
-void sha512_block(struct sha512_state *s, const uint8_t *blk);
+ED25519_HOT void sha512_block(struct sha512_state *s, const uint8_t *blk);
+
+/* Feed the same full block into n states, as when several signatures
+ * over one message are checked. The message schedule is computed once
+ * for a group of up to SHA512_LANES states, whose rounds then run side by
+ * side: in the four 64-bit lanes of an AVX2 register if the compiler
+ * targets AVX2, two at a time interleaved in the generic code, which
+ * keeps a superscalar core busy, and one after another in the word32
+ * code, which still saves the schedule of all but one of them.
+ */
+#if defined(SHA512_BLOCK_WORD32) || defined(__AVX2__)
+#define SHA512_LANES		4
+#else
+#define SHA512_LANES		2
+#endif
+
+void sha512_block_multi(struct sha512_state *const *s, unsigned int n,
+			const uint8_t *blk);
 
 /* Feed the last partial block in. The total stream size must be
  * specified. The size of the block given is assumed to be (total_size %
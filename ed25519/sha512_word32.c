@@ -0,0 +1,203 @@
+/* SHA512, 32-bit word compression backend
+ *
+ * This file is in the public domain.
+ */
+
+#include "sha512.h"
+#include "scratch.h"
+
+#ifdef SHA512_BLOCK_WORD32
+
+/* The generic code works on 64-bit words, which a 32-bit core like the
+ * Cortex-M0+ has to emulate with calls and spills for every rotation.
+ * Here each word is kept as a pair of 32-bit halves, so that every
+ * rotation is a handful of 32-bit shifts, and eight rounds are unrolled
+ * so that the working variables are never shuffled.
+ */
+extern const uint64_t sha512_round_k[80];
+
+/* Halves of a 64-bit right rotation by n, for 0 < n < 32. Rotating by
+ * 32 + n is the same with the halves swapped.
+ */
+#define RH(h, l, n)	(((h) >> (n)) | ((l) << (32 - (n))))
+#define RL(h, l, n)	(((l) >> (n)) | ((h) << (32 - (n))))
+
+/* (rh, rl) += (xh, xl) */
+#define ADD(rh, rl, xh, xl) do {				\
+		uint32_t _l = (rl) + (xl);			\
+		(rh) += (xh) + (_l < (xl));			\
+		(rl) = _l;					\
+	} while (0)
+
+ED25519_HOT static uint32_t load32(const uint8_t *x)
+{
+	return ((uint32_t)x[0] << 24) | ((uint32_t)x[1] << 16) |
+		((uint32_t)x[2] << 8) | x[3];
+}
+
+/* w[j] becomes w[j + 16] */
+ED25519_HOT static void schedule(uint32_t *wh, uint32_t *wl, int j)
+{
+	const uint32_t h15 = wh[(j + 1) & 15], l15 = wl[(j + 1) & 15];
+	const uint32_t h2 = wh[(j + 14) & 15], l2 = wl[(j + 14) & 15];
+	uint32_t sh, sl;
+
+	/* s0 = rot(w15, 1) ^ rot(w15, 8) ^ (w15 >> 7) */
+	sh = RH(h15, l15, 1) ^ RH(h15, l15, 8) ^ (h15 >> 7);
+	sl = RL(h15, l15, 1) ^ RL(h15, l15, 8) ^ RL(h15, l15, 7);
+	ADD(wh[j & 15], wl[j & 15], sh, sl);
+
+	/* s1 = rot(w2, 19) ^ rot(w2, 61) ^ (w2 >> 6) */
+	sh = RH(h2, l2, 19) ^ RL(h2, l2, 29) ^ (h2 >> 6);
+	sl = RL(h2, l2, 19) ^ RH(h2, l2, 29) ^ RL(h2, l2, 6);
+	ADD(wh[j & 15], wl[j & 15], sh, sl);
+
+	ADD(wh[j & 15], wl[j & 15], wh[(j + 9) & 15], wl[(j + 9) & 15]);
+}
+
+/* One round on the message word already in w, updating d and h in place
+ * of shuffling all eight
+ */
+#define ROUND_W(a, b, c, d, e, f, g, h, j) do {			\
+		uint32_t th = vh[h], tl = vl[h];			\
+		uint32_t xh, xl;					\
+									\
+		/* S1 = rot(e, 14) ^ rot(e, 18) ^ rot(e, 41) */		\
+		xh = RH(vh[e], vl[e], 14) ^ RH(vh[e], vl[e], 18) ^	\
+			RL(vh[e], vl[e], 9);				\
+		xl = RL(vh[e], vl[e], 14) ^ RL(vh[e], vl[e], 18) ^	\
+			RH(vh[e], vl[e], 9);				\
+		ADD(th, tl, xh, xl);					\
+									\
+		/* ch = (e & f) ^ (~e & g) */				\
+		xh = vh[g] ^ (vh[e] & (vh[f] ^ vh[g]));			\
+		xl = vl[g] ^ (vl[e] & (vl[f] ^ vl[g]));			\
+		ADD(th, tl, xh, xl);					\
+									\
+		ADD(th, tl, (uint32_t)(sha512_round_k[j] >> 32),	\
+		    (uint32_t)sha512_round_k[j]);			\
+		ADD(th, tl, wh[(j) & 15], wl[(j) & 15]);		\
+									\
+		/* e = d + temp1 */					\
+		ADD(vh[d], vl[d], th, tl);				\
+									\
+		/* S0 = rot(a, 28) ^ rot(a, 34) ^ rot(a, 39) */		\
+		xh = RH(vh[a], vl[a], 28) ^ RL(vh[a], vl[a], 2) ^	\
+			RL(vh[a], vl[a], 7);				\
+		xl = RL(vh[a], vl[a], 28) ^ RH(vh[a], vl[a], 2) ^	\
+			RH(vh[a], vl[a], 7);				\
+		ADD(th, tl, xh, xl);					\
+									\
+		/* maj = (a & b) | (c & (a | b)) */			\
+		xh = (vh[a] & vh[b]) | (vh[c] & (vh[a] | vh[b]));	\
+		xl = (vl[a] & vl[b]) | (vl[c] & (vl[a] | vl[b]));	\
+		ADD(th, tl, xh, xl);					\
+									\
+		/* a = temp1 + temp2 */					\
+		vh[h] = th;						\
+		vl[h] = tl;						\
+	} while (0)
+
+#define ROUND(a, b, c, d, e, f, g, h, j) do {				\
+		if ((j) >= 16)						\
+			schedule(wh, wl, j);				\
+		ROUND_W(a, b, c, d, e, f, g, h, j);			\
+	} while (0)
+
+void sha512_block(struct sha512_state *s, const uint8_t *blk)
+{
+	ED25519_SCRATCH uint32_t wh[16];
+	ED25519_SCRATCH uint32_t wl[16];
+	ED25519_SCRATCH uint32_t vh[8];
+	ED25519_SCRATCH uint32_t vl[8];
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		wh[i] = load32(blk);
+		wl[i] = load32(blk + 4);
+		blk += 8;
+	}
+
+	/* Load state */
+	for (i = 0; i < 8; i++) {
+		vh[i] = s->h[i] >> 32;
+		vl[i] = s->h[i];
+	}
+
+	for (i = 0; i < 80; i += 8) {
+		ROUND(0, 1, 2, 3, 4, 5, 6, 7, i);
+		ROUND(7, 0, 1, 2, 3, 4, 5, 6, i + 1);
+		ROUND(6, 7, 0, 1, 2, 3, 4, 5, i + 2);
+		ROUND(5, 6, 7, 0, 1, 2, 3, 4, i + 3);
+		ROUND(4, 5, 6, 7, 0, 1, 2, 3, i + 4);
+		ROUND(3, 4, 5, 6, 7, 0, 1, 2, i + 5);
+		ROUND(2, 3, 4, 5, 6, 7, 0, 1, i + 6);
+		ROUND(1, 2, 3, 4, 5, 6, 7, 0, i + 7);
+	}
+
+	/* Store state */
+	for (i = 0; i < 8; i++)
+		s->h[i] += ((uint64_t)vh[i] << 32) | vl[i];
+}
+
+/* The schedule of eight rounds is computed ahead, then the rounds are run
+ * on each state in turn
+ */
+void sha512_block_multi(struct sha512_state *const *s, unsigned int n,
+			const uint8_t *blk)
+{
+	ED25519_SCRATCH uint32_t wh[16];
+	ED25519_SCRATCH uint32_t wl[16];
+	ED25519_SCRATCH uint32_t lh[SHA512_LANES][8];
+	ED25519_SCRATCH uint32_t ll[SHA512_LANES][8];
+	uint32_t *vh;
+	uint32_t *vl;
+	unsigned int k;
+	unsigned int l;
+	int i;
+	int j;
+
+	for (; n > 1; s += k, n -= k) {
+		k = (n < SHA512_LANES) ? n : SHA512_LANES;
+
+		for (i = 0; i < 16; i++) {
+			wh[i] = load32(blk + 8 * i);
+			wl[i] = load32(blk + 8 * i + 4);
+		}
+
+		for (l = 0; l < k; l++) {
+			for (i = 0; i < 8; i++) {
+				lh[l][i] = s[l]->h[i] >> 32;
+				ll[l][i] = s[l]->h[i];
+			}
+		}
+
+		for (i = 0; i < 80; i += 8) {
+			for (j = i; i >= 16 && j < i + 8; j++)
+				schedule(wh, wl, j);
+
+			for (l = 0; l < k; l++) {
+				vh = lh[l];
+				vl = ll[l];
+				ROUND_W(0, 1, 2, 3, 4, 5, 6, 7, i);
+				ROUND_W(7, 0, 1, 2, 3, 4, 5, 6, i + 1);
+				ROUND_W(6, 7, 0, 1, 2, 3, 4, 5, i + 2);
+				ROUND_W(5, 6, 7, 0, 1, 2, 3, 4, i + 3);
+				ROUND_W(4, 5, 6, 7, 0, 1, 2, 3, i + 4);
+				ROUND_W(3, 4, 5, 6, 7, 0, 1, 2, i + 5);
+				ROUND_W(2, 3, 4, 5, 6, 7, 0, 1, i + 6);
+				ROUND_W(1, 2, 3, 4, 5, 6, 7, 0, i + 7);
+			}
+		}
+
+		for (l = 0; l < k; l++) {
+			for (i = 0; i < 8; i++)
+				s[l]->h[i] += ((uint64_t)lh[l][i] << 32) |
+					ll[l][i];
+		}
+	}
+	if (n > 0)
+		sha512_block(s[0], blk);
+}
+
+#endif
@@ -0,0 +1,275 @@
+// Verifies signed targets metadata the way an ECU does and measures how fast:
+//
+//   verify_targets [--chunk <bytes>] [--repeat <n>] [--verify parallel|buffered] [--max-bytes <n>] [--max-tokens <n>]
+//                  <signed.json> <keyfile> <threshold> <version> <ecuid> <hwid> [<sha512>]
+//
+// The file is mapped and fed to the parser in chunks (64 bytes by default), straight from the mapping. keyfile holds
+// the targets keys, one "<keyid>:<public key>" line each, in hex. version is the one installed, the metadata must not
+// be older. If sha512 is given, the target must have that hash. Exits with 0 if the metadata is valid and has a target
+// for the ECU, 1 if not and 2 on bad arguments.
+//
+// The signatures are checked in a context each, hashing alongside the parser, or with "--verify buffered" one after
+// another in a single context over the mapping (uptane_targets_ctx_signed_buffered).
+//
+// --max-bytes and --max-tokens set the budgets of uptane_targets_ctx_set_budget, over them the result is "too large".
+//
+// The metadata is verified repeat times, each time from scratch as new metadata would be. The throughput is given in
+// MB/s of metadata and in verifications per second. With a threshold of 0 no signature is checked, which leaves the
+// throughput of the parser alone. The token count is the most that were in use at once in the
+// token_pool of libuptiny-demo, which is sized like on an ECU. Built with UPTANE_STATS, the counters of
+// libuptiny/stats.h follow, per verification.
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "libuptiny/common_data_api.h"
+#include "libuptiny/crypto_common.h"
+#include "libuptiny/pool.h"
+#include "libuptiny/signatures.h"
+#include "libuptiny/state_api.h"
+#include "libuptiny/stats.h"
+#include "libuptiny/targets.h"
+#include "libuptiny/utils.h"
+
+static uptane_root_t root;
+static crypto_key_t keys[ROOT_MAX_KEYS];
+static uptane_targets_t installed;
+static const char *ecuid;
+static const char *hwid;
+static uint32_t max_bytes;
+static uint32_t max_tokens;
+
+uptane_root_t *state_get_root(void) { return &root; }
+uptane_targets_t *state_get_targets(void) { return &installed; }
+const char *state_get_ecuid(void) { return ecuid; }
+size_t state_get_ecuid_len(void) { return strlen(ecuid); }
+const char *state_get_hwid(void) { return hwid; }
+size_t state_get_hwid_len(void) { return strlen(hwid); }
+crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA512; }
+void state_set_attack(uptane_attack_t attack) { (void)attack; }
+
+static bool read_keys(const char *path) {
+  FILE *f = fopen(path, "r");
+  char line[256];
+
+  if (f == NULL) {
+    perror(path);
+    return false;
+  }
+  root.targets_keys_num = 0;
+  while (fgets(line, sizeof(line), f) != NULL) {
+    char *sep = strchr(line, ':');
+    size_t keyval_len;
+
+    if (sep == NULL) {
+      continue;
+    }
+    keyval_len = strcspn(sep + 1, "\r\n");
+    if (root.targets_keys_num >= ROOT_MAX_KEYS || sep - line != 2 * CRYPTO_KEYID_LEN ||
+        keyval_len != 2 * CRYPTO_KEYVAL_LEN) {
+      fprintf(stderr, "%s: invalid key: %s", path, line);
+      fclose(f);
+      return false;
+    }
+    crypto_key_t *key = &keys[root.targets_keys_num];
+    key->key_type = CRYPTO_ALG_ED25519;
+    if (!hex2bin(line, 2 * CRYPTO_KEYID_LEN, key->keyid) || !hex2bin(sep + 1, 2 * CRYPTO_KEYVAL_LEN, key->keyval)) {
+      fprintf(stderr, "%s: invalid key: %s", path, line);
+      fclose(f);
+      return false;
+    }
+    crypto_key_prepare(key);
+    // the keys are looked up by a binary search
+    root.targets_keys[root.targets_keys_num] = key;
+    if (!key_index_insert(root.targets_keys, root.targets_keys_num)) {
+      fprintf(stderr, "%s: duplicate key: %s", path, line);
+      fclose(f);
+      return false;
+    }
+    ++root.targets_keys_num;
+  }
+  fclose(f);
+  return root.targets_keys_num > 0;
+}
+
+static const char *result_name(uint16_t result) {
+  switch (result) {
+    case RESULT_END_FOUND:
+      return "target found";
+    case RESULT_END_NOT_FOUND:
+      return "no target for the ECU";
+    case RESULT_SIGNATURES_FAILED:
+      return "signatures failed";
+    case RESULT_VERSION_FAILED:
+      return "version failed";
+    case RESULT_WRONG_HW_ID:
+      return "wrong hardware ID";
+    case RESULT_OUT_OF_TOKENS:
+      return "out of tokens";
+    case RESULT_TOO_LARGE:
+      return "too large";
+    case RESULT_IN_PROGRESS:
+      return "metadata incomplete";
+    default:
+      return "error";
+  }
+}
+
+// feeds the whole metadata in chunks like a transport would deliver it
+static uint16_t verify(const char *data, size_t len, size_t chunk_size, bool buffered, uptane_targets_t *targets) {
+  static uptane_targets_ctx_t ctx;
+  uint16_t result = RESULT_IN_PROGRESS;
+  size_t offset = 0;
+  size_t avail = 0;
+
+  uptane_targets_ctx_setup(&ctx, token_pool, token_pool_size, signature_pool, signature_pool_size, crypto_ctx_pool,
+                           crypto_ctx_pool_size, &hash_context, NULL);
+  uptane_targets_ctx_init(&ctx);
+  uptane_targets_ctx_set_budget(&ctx, max_bytes, max_tokens);
+  if (buffered) {
+    uptane_targets_ctx_signed_buffered(&ctx);
+  }
+  while (result == RESULT_IN_PROGRESS) {
+    if (avail == len && avail == offset) {
+      break;
+    }
+    avail = (len - avail > chunk_size) ? avail + chunk_size : len;
+    int consumed = uptane_targets_ctx_feed(&ctx, data + offset, (jsmnint_t)(avail - offset), targets, &result);
+    if (consumed < 0) {
+      break;
+    }
+    offset += (size_t)consumed;
+    if (avail == len && consumed == 0) {
+      break;
+    }
+  }
+  while (uptane_targets_ctx_busy(&ctx)) {
+  }
+  return result;
+}
+
+static double seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+  size_t chunk_size = 64;
+  long repeat = 1;
+  bool buffered = false;
+  bool bad_verify = false;
+  int arg = 1;
+
+  for (; arg + 1 < argc && strncmp(argv[arg], "--", 2) == 0; arg += 2) {
+    if (strcmp(argv[arg], "--chunk") == 0) {
+      chunk_size = strtoul(argv[arg + 1], NULL, 10);
+    } else if (strcmp(argv[arg], "--repeat") == 0) {
+      repeat = strtol(argv[arg + 1], NULL, 10);
+    } else if (strcmp(argv[arg], "--verify") == 0) {
+      buffered = (strcmp(argv[arg + 1], "buffered") == 0);
+      bad_verify = !buffered && strcmp(argv[arg + 1], "parallel") != 0;
+    } else if (strcmp(argv[arg], "--max-bytes") == 0) {
+      max_bytes = (uint32_t)strtoul(argv[arg + 1], NULL, 10);
+    } else if (strcmp(argv[arg], "--max-tokens") == 0) {
+      max_tokens = (uint32_t)strtoul(argv[arg + 1], NULL, 10);
+    } else {
+      break;
+    }
+  }
+  // the unconsumed tail of a chunk is fed again with the next one
+  if (argc - arg < 6 || chunk_size == 0 || chunk_size > 16384 || repeat <= 0 || bad_verify) {
+    fprintf(stderr,
+            "Usage: %s [--chunk <bytes>] [--repeat <n>] [--verify parallel|buffered] [--max-bytes <n>] "
+            "[--max-tokens <n>] <signed.json> <keyfile> <threshold> <version> <ecuid> <hwid> [<sha512>]\n",
+            argv[0]);
+    return 2;
+  }
+  const char *path = argv[arg];
+  root.targets_threshold = atoi(argv[arg + 2]);
+  installed.version = atoi(argv[arg + 3]);
+  ecuid = argv[arg + 4];
+  hwid = argv[arg + 5];
+  const char *sha512 = (argc - arg > 6) ? argv[arg + 6] : NULL;
+  if (!read_keys(argv[arg + 1])) {
+    return 2;
+  }
+
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0) {
+    perror(path);
+    return 2;
+  }
+  size_t map_len = (size_t)st.st_size;
+  const char *data = mmap(NULL, map_len, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (data == MAP_FAILED) {
+    perror(path);
+    return 2;
+  }
+  // trailing whitespace, e.g. a newline, is not part of the metadata
+  size_t len = map_len;
+  while (len > 0 && strchr(" \t\r\n", data[len - 1]) != NULL) {
+    --len;
+  }
+
+  uptane_targets_t targets;
+  uint16_t result = RESULT_ERROR;
+  int signatures_checked = 0;
+#ifdef UPTANE_POOL_STATS
+  uptane_pool_reset_peaks();
+#endif
+#ifdef UPTANE_STATS
+  uptane_stats_reset();
+#endif
+  double start = seconds();
+  for (long i = 0; i < repeat; ++i) {
+    memset(&targets, 0, sizeof(targets));
+    result = verify(data, len, chunk_size, buffered, &targets);
+    signatures_checked += uptane_get_signatures_report()->num_checked;
+  }
+  double elapsed = seconds() - start;
+  munmap((void *)data, map_len);
+  close(fd);
+
+  bool valid = (result == RESULT_END_FOUND);
+  printf("result: %s\n", result_name(result));
+  if (valid) {
+    printf("target: %s, version %d, %u bytes\n", targets.name, targets.version, (unsigned int)targets.length);
+    for (int i = 0; sha512 != NULL && i <= targets.hashes_num; ++i) {
+      if (i == targets.hashes_num) {
+        printf("hash: no sha512 to compare\n");
+        valid = false;
+      } else if (targets.hashes[i].alg == CRYPTO_HASH_SHA512) {
+        valid = strlen(sha512) == 128 && hex_bin_cmp(sha512, 128, targets.hashes[i].hash) == 0;
+        printf("hash: %s\n", valid ? "matches" : "differs");
+        break;
+      }
+    }
+  }
+  printf("metadata: %zu bytes in chunks of %zu, verified %ld times\n", len, chunk_size, repeat);
+  printf("throughput: %.2f MB/s, %.1f verifications/s, %.1f signatures/s\n",
+         (double)len * (double)repeat / elapsed / 1e6, (double)repeat / elapsed, (double)signatures_checked / elapsed);
+#ifdef UPTANE_POOL_STATS
+  printf("peak tokens: %u of %d\n", uptane_pool_peaks.tokens, (int)token_pool_size);
+#endif
+#ifdef UPTANE_STATS
+  const uptane_stats_t *stats = uptane_stats_get();
+  printf("per verification: %u bytes fed, %u tokens, %u subtrees skipped, %u targets inspected\n",
+         (unsigned int)(stats->bytes_fed / repeat), (unsigned int)(stats->tokens / repeat),
+         (unsigned int)(stats->subtrees_skipped / repeat), (unsigned int)(stats->targets_inspected / repeat));
+  printf("per verification: %u hex and %u base64 characters decoded, %u signatures verified and %u skipped, "
+         "%u sha512 blocks\n",
+         (unsigned int)(stats->hex_decoded / repeat), (unsigned int)(stats->base64_decoded / repeat),
+         (unsigned int)(stats->signatures_verified / repeat), (unsigned int)(stats->signatures_skipped / repeat),
+         (unsigned int)(stats->sha512_blocks / repeat));
+#endif
+  return valid ? 0 : 1;
+}
@@ -1,61 +1,122 @@
 #include "libuptiny/common_data_api.h"
+#include "libuptiny/pool.h"
+#include "crypto_ctx.h"
 
+#include "ed25519/sha256.h"
 #include "ed25519/sha512.h"
 
-#define TOKEN_POOL_SIZE 50
+/* Pool sizes are set in uptiny_config.h */
+jsmntok_t token_pool[UPTINY_TOKEN_POOL_SIZE];
+const jsmnint_t token_pool_size = UPTINY_TOKEN_POOL_SIZE;
 
-jsmntok_t token_pool[TOKEN_POOL_SIZE];
-const int16_t token_pool_size = TOKEN_POOL_SIZE;
+crypto_key_and_signature_t signature_pool[UPTINY_SIGNATURE_POOL_SIZE];
+const unsigned int signature_pool_size = UPTINY_SIGNATURE_POOL_SIZE;
 
-#define SIGNATURE_POOL_SIZE 4
-crypto_key_and_signature_t signature_pool[SIGNATURE_POOL_SIZE];
-const unsigned int signature_pool_size = SIGNATURE_POOL_SIZE;
+crypto_hash_ctx_t hash_context;
+crypto_hash_ctx_t chunk_hash_context;
+crypto_sign_ctx_t sign_context;
 
-/* TODO: Duplicated from test_crypto.cc, something needs to be done about it */
-struct crypto_verify_ctx {
-  size_t bytes_fed;
-  uint8_t block[SHA512_BLOCK_SIZE];
-  struct sha512_state sha_state;
-  const uint8_t* signature;
-  const uint8_t* pub;
-};
+/* The contexts of the pool are fed the same message together, and share the partial block of it */
+static uint8_t crypto_ctx_pool_block[CRYPTO_VERIFY_BLOCK_LEN];
+#define POOL_CTX \
+  { .block = crypto_ctx_pool_block }
 
-struct crypto_hash_ctx {
-  size_t bytes_fed;
-  uint8_t block[SHA512_BLOCK_SIZE];
-  struct sha512_state sha_state;
+crypto_verify_ctx_t crypto_ctx_pool_data[UPTINY_CRYPTO_CTX_POOL_SIZE] = {
+    POOL_CTX,
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 1
+    POOL_CTX,
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 2
+    POOL_CTX,
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 3
+    POOL_CTX,
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 4
+    POOL_CTX,
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 5
+    POOL_CTX,
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 6
+    POOL_CTX,
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 7
+    POOL_CTX,
+#endif
 };
 
-crypto_hash_ctx_t hash_context;
-
-#define CRYPTO_CONTEXT_POOL_SIZE 4
-crypto_verify_ctx_t crypto_ctx_pool_data[CRYPTO_CONTEXT_POOL_SIZE];
 crypto_verify_ctx_t* crypto_ctx_pool[] = {
     &crypto_ctx_pool_data[0],
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 1
     &crypto_ctx_pool_data[1],
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 2
     &crypto_ctx_pool_data[2],
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 3
     &crypto_ctx_pool_data[3],
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 4
+    &crypto_ctx_pool_data[4],
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 5
+    &crypto_ctx_pool_data[5],
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 6
+    &crypto_ctx_pool_data[6],
+#endif
+#if UPTINY_CRYPTO_CTX_POOL_SIZE > 7
+    &crypto_ctx_pool_data[7],
+#endif
 };
 
-const unsigned int crypto_ctx_pool_size = CRYPTO_CONTEXT_POOL_SIZE;
+/* One initializer and one pointer of crypto_ctx_pool per context */
+typedef char crypto_ctx_pool_complete[(UPTINY_CRYPTO_CTX_POOL_SIZE >= 1 && UPTINY_CRYPTO_CTX_POOL_SIZE <= 8) ? 1 : -1];
 
-#define KEY_POOL_SIZE 16
-crypto_key_t key_pool[KEY_POOL_SIZE];
-uint32_t key_pool_mark = 0;
+const unsigned int crypto_ctx_pool_size = UPTINY_CRYPTO_CTX_POOL_SIZE;
+
+UPTANE_POOL(key_pool, crypto_key_t, UPTINY_KEY_POOL_SIZE);
+/* The generations of common_data_api.h as bits of key_pool blocks, a shared key is in both */
+static uint32_t stored_keys;
+static uint32_t candidate_keys;
 
 crypto_key_t* alloc_crypto_key(void) {
-  for (int i = 0; i < KEY_POOL_SIZE; ++i) {
-    if (!(key_pool_mark & (1 << i))) {
-      key_pool_mark |= (1 << i);
-      return &key_pool[i];
-    }
+  crypto_key_t* key = uptane_pool_alloc(&key_pool);
+  if (key != NULL) {
+    candidate_keys |= 1u << uptane_pool_index(&key_pool, key);
   }
-  return NULL;
+  UPTANE_POOL_PEAK(keys, key_pool.used);
+  return key;
 }
+
 void free_crypto_key(crypto_key_t* key) {
-  int idx = ((uint32_t)key - (uint32_t)&key_pool) / sizeof(crypto_key_t);
-  if (idx < KEY_POOL_SIZE) {
-    key_pool_mark &= ~(1 << idx);
+  int i = uptane_pool_index(&key_pool, key);
+
+  if (i < 0 || !(candidate_keys & (1u << i))) {
+    return;
+  }
+  candidate_keys &= ~(1u << i);
+  if (!(stored_keys & (1u << i))) {
+    uptane_pool_free(&key_pool, key);
   }
 }
-void free_all_crypto_keys(void) { key_pool_mark = 0; }
+
+void share_crypto_key(crypto_key_t* key) {
+  int i = uptane_pool_index(&key_pool, key);
+
+  if (i >= 0 && (stored_keys & (1u << i))) {
+    candidate_keys |= 1u << i;
+  }
+}
+
+void free_all_crypto_keys(void) {
+  uptane_pool_free_mask(&key_pool, candidate_keys & ~stored_keys);
+  candidate_keys = 0;
+}
+
+void commit_crypto_keys(void) {
+  uptane_pool_free_mask(&key_pool, stored_keys & ~candidate_keys);
+  stored_keys = candidate_keys;
+  candidate_keys = 0;
+}
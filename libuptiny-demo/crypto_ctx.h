@@ -0,0 +1,42 @@
+#ifndef LIBUPTINY_DEMO_CRYPTO_CTX_H_
+#define LIBUPTINY_DEMO_CRYPTO_CTX_H_
+
+/* The contexts of crypto_api.h as crypto.c implements them, common_data.c allocates the pools of them */
+
+#include "ed25519/edsign.h"
+#include "ed25519/sha256.h"
+#include "ed25519/sha512.h"
+#include "libuptiny/crypto_api.h"
+
+struct crypto_verify_ctx {
+  size_t bytes_fed;
+  uint8_t* block;  // the partial block of the message, may be shared, see crypto_verify_set_block()
+  struct sha512_state sha_state;
+  const uint8_t* signature;
+  const uint8_t* pub;
+  const uint8_t* unpacked;
+};
+
+struct crypto_hash_ctx {
+  crypto_hash_algorithm_t alg;
+  size_t bytes_fed;
+  uint8_t block[SHA512_BLOCK_SIZE];  // the larger block of the two
+  union {
+    struct sha512_state sha512;
+#if UPTINY_HASH_SHA256
+    struct sha256_state sha256;
+#endif
+  } state;
+};
+
+struct crypto_sign_ctx {
+  size_t bytes_fed;
+  uint8_t block[SHA512_BLOCK_SIZE];
+  struct sha512_state sha_state;
+  uint8_t k[EDSIGN_NONCE_SIZE];  // nonce, kept from the first pass to the second
+  int pass;
+  crypto_key_and_signature_t* sig;
+  const uint8_t* priv;
+};
+
+#endif  // LIBUPTINY_DEMO_CRYPTO_CTX_H_
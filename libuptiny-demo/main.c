@@ -1,7 +1,11 @@
 #include "can/conn/isotp.h"
+#include "msg.h"
 #include "periph/gpio.h"
+#include "thread.h"
 #include "xtimer.h"
 
+#include "libuptiny/chunks.h"
+#include "libuptiny/decompress.h"
 #include "libuptiny/firmware.h"
 #include "libuptiny/manifest.h"
 #include "libuptiny/root.h"
@@ -13,7 +17,34 @@
 #define LIBUPTINY_ISOTP_PRIMARY_CANID 0x7D8
 
 #define ISOTP_BUF_SIZE 1024
-char isotp_buf[ISOTP_BUF_SIZE];
+
+/* Messages are received by a thread of their own into one of UPTANE_CHUNK_BUFS buffers, and handed to the main thread
+ * in a RIOT message. While the main thread verifies one message, or hashes a chunk, the next one is already received
+ * into the other buffer. A buffer goes back to the receive thread in a message once it has been handled, so that they
+ * are taken in turn. The receive thread only waits for one if all of them are in use. */
+#define UPTANE_CHUNK_BUFS 2
+
+typedef struct {
+  int len;
+  char data[ISOTP_BUF_SIZE];
+} uptane_chunk_t;
+
+static uptane_chunk_t chunk_pool[UPTANE_CHUNK_BUFS];
+
+/* Each queue holds a message for every buffer, so neither thread blocks in msg_send() */
+static msg_t recv_queue[UPTANE_CHUNK_BUFS];
+static msg_t verify_queue[UPTANE_CHUNK_BUFS];
+
+/* The receive thread runs before the main one, reception doesn't wait for a signature check */
+#ifndef UPTANE_RECV_STACKSIZE
+#define UPTANE_RECV_STACKSIZE THREAD_STACKSIZE_DEFAULT
+#endif
+static char recv_stack[UPTANE_RECV_STACKSIZE];
+static kernel_pid_t recv_pid;
+static kernel_pid_t verify_pid;
+
+static conn_can_isotp_t conn_isotp;
+
 /* ISO/TP message format:
  * <1-byte message type> <payload>
  * Message types:
@@ -31,9 +62,74 @@ char isotp_buf[ISOTP_BUF_SIZE];
  *   - 0x07 - putTargets
  *   - 0x08 - putImageChunk
  *   - 0x48 - acknowledge/error on putImageChunk
+ *   - 0x09 - getResume
+ *   - 0x49 - resp to getResume
+ *   - 0x0A - getProgress
+ *   - 0x4A - resp to getProgress
+ *   - 0x0B - putTargetsPart
+ *   - 0x4B - acknowledge/error on putTargetsPart
+ *   - 0x0C - beginWindowedImage
+ *   - 0x4C - resp to beginWindowedImage
+ *   - 0x0D - putWindowedChunk
+ *   - 0x4D - acknowledge/error on putWindowedChunk
+ *   - 0x0E - putRootChain
+ *   - 0x4E - acknowledge/error on putRootChain
+ *   - 0x0F - getState
+ *   - 0x4F - resp to getState
+ *
+ * The resp to getRootVersion is the version in decimal.
+ *
+ * getState tells the primary what the ECU has, so that it sends only what is new. The resp is, numbers big endian:
+ * <0x4F> <4 bytes root version> <4 bytes targets version> <1 byte flags>
+ * <64 bytes SHA-512 of the "signed" object of the stored targets metadata>
+ * <1 byte hash algorithm of the installed image, 0x00 SHA-512, 0x01 SHA-256> <64 bytes hash, zero padded>
+ * Flag 0x01 is set if the digest of the targets metadata is known, 0x02 if an image is installed. The rest of a field
+ * whose flag isn't set is zero. The primary can skip putTargets if the digest is that of the "signed" object it would
+ * send, and the image transfer if the hash is that of the target.
+ *
+ * An ECU several root versions behind gets them all, N+1.root.json to N+k.root.json, one after the other as
+ * <0x0E> <flags: 0x01 first, 0x02 last, both for a chain of one> <root.json>
+ * Each root is checked against the one before it, and only the last one is stored. Each is acknowledged with
+ * <0x4E> <0x00 or 0xFE on error>
+ * After an error the chain has to be sent again from the first root, the stored one stays as it was.
+ *
+ * Targets metadata larger than a message goes in parts, each one fed to the parser as it comes in:
+ * <0x0B> <1 byte 0x00 begin, 0x01 continue or 0x02 end> <2 bytes sequence number, big endian> <payload>
+ * The begin part has sequence number 0, every next part one more. Each part is acknowledged with
+ * <0x4B> <0x00 or 0xFE on error> <2 bytes sequence number>
+ * After an error the metadata has to be sent again from the begin part. The end part completes it, the metadata is
+ * taken if the parser found its end.
  *
  * Format of putImageChunk message:
  * <0x08> <1 byte total number of chunks> <1 byte sequence number> <payload>
+ *
+ * The payload is the heatshrink compressed image if the target's custom metadata has "compression".
+ *
+ * An uncompressed transfer is checkpointed every UPTANE_CHECKPOINT_CHUNKS chunks. After it broke off, it continues
+ * with the chunk after the last checkpoint. Format of the resp to getResume:
+ * <0x49> <4 bytes number of image bytes received, big endian> <1 byte number of chunks received>
+ * Both are 0 if there is no checkpoint for the current target.
+ *
+ * A getResume resp also has <2 bytes number of chunks received, big endian> at the end, for windowed transfers.
+ *
+ * Windowed transfers don't wait for an acknowledgement after every chunk, up to a window of chunks can be on their way.
+ * They have 16 bit sequence numbers, chunks with a hash tree can't go that way. The transfer starts with
+ * <0x0C> <2 bytes total number of chunks> <1 byte window wanted> <2 bytes sequence number of the first chunk>
+ * The first chunk is 1, or the one after the checkpoint of getResume. The resp is
+ * <0x4C> <0x00 or 0xFE on error> <1 byte window granted, at most UPTANE_WINDOW_MAX>
+ * and the chunks follow as <0x0D> <2 bytes sequence number> <payload>. Acknowledgements are cumulative:
+ * <0x4D> <status> <2 bytes sequence number of the last chunk taken>
+ * comes after every half window, after the last chunk and when a chunk is missing. Status is 0x00, 0x01 if the chunks
+ * after the one acknowledged have to be sent again, or 0xFE if the transfer failed. Without an acknowledgement for a
+ * while, the primary sends the chunks after the last one acknowledged again.
+ *
+ * Format of the resp to getProgress, the numbers are big endian:
+ * <0x4A> <4 bytes number of image bytes received> <4 bytes length of the image>
+ * A putImageChunk that makes the image longer than the target is refused.
+ *
+ * If the target's custom metadata has "chunks", the payload is the audit path of the chunk followed by the chunk, see
+ * libuptiny/chunks.h. The sequence number is the chunk's index plus one, a chunk that fails verification aborts the
+ * transfer. Chunks of an uncompressed image can come in any order, the image is verified once all of them are there.
  */
 
 typedef enum {
@@ -51,154 +147,612 @@ typedef enum {
   UPTANE_PUT_TARGETS = 0x07,
   UPTANE_PUT_IMAGE_CHUNK = 0x08,
   UPTANE_PUT_IMAGE_CHUNK_ACK_ERR = 0x48,
+  UPTANE_GET_RESUME = 0x09,
+  UPTANE_GET_RESUME_RESP = 0x49,
+  UPTANE_GET_PROGRESS = 0x0A,
+  UPTANE_GET_PROGRESS_RESP = 0x4A,
+  UPTANE_PUT_TARGETS_PART = 0x0B,
+  UPTANE_PUT_TARGETS_PART_ACK_ERR = 0x4B,
+  UPTANE_BEGIN_WINDOWED_IMAGE = 0x0C,
+  UPTANE_BEGIN_WINDOWED_IMAGE_RESP = 0x4C,
+  UPTANE_PUT_WINDOWED_CHUNK = 0x0D,
+  UPTANE_PUT_WINDOWED_CHUNK_ACK_ERR = 0x4D,
+  UPTANE_PUT_ROOT_CHAIN = 0x0E,
+  UPTANE_PUT_ROOT_CHAIN_ACK_ERR = 0x4E,
+  UPTANE_GET_STATE = 0x0F,
+  UPTANE_GET_STATE_RESP = 0x4F,
 } uptane_isotp_message_type_t;
 
+#define UPTANE_TARGETS_PART_BEGIN 0x00
+#define UPTANE_TARGETS_PART_CONTINUE 0x01
+#define UPTANE_TARGETS_PART_END 0x02
+
+#define UPTANE_ROOT_CHAIN_FIRST 0x01
+#define UPTANE_ROOT_CHAIN_LAST 0x02
+
+#define UPTANE_STATE_TARGETS_DIGEST 0x01
+#define UPTANE_STATE_IMAGE_INSTALLED 0x02
+#define UPTANE_STATE_RESP_SIZE (1 + 4 + 4 + 1 + CRYPTO_MAX_HASH_LEN + 1 + CRYPTO_MAX_HASH_LEN)
+
+bool root_chain_in_progress = false;
+
 bool upload_in_progress = false;
+bool upload_compressed = false;
+bool upload_chunked = false;
 int upload_seqn = 0;
+uint32_t upload_offset = 0;
 
-int uptane_recv(void) {
-  int ret;
-  uptane_root_t in_root;
-  uptane_targets_t in_targets;
+#define UPTANE_CHECKPOINT_CHUNKS 8
 
-  state_init();
+/* Chunks of a windowed transfer that can be on their way, as many as the ISO-TP layer queues */
+#define UPTANE_WINDOW_MAX 8
 
-  struct isotp_options isotp_opt;
-  memset(&isotp_opt, 0, sizeof(isotp_opt));
+uint8_t upload_window = 0; /* 0 unless a windowed transfer is in progress */
+uint16_t upload_total = 0;
 
-  isotp_opt.rx_id = LIBUPTINY_ISOTP_SECONDARY_CANID;
-  isotp_opt.tx_id = LIBUPTINY_ISOTP_PRIMARY_CANID;
-  isotp_opt.flags |= CAN_ISOTP_TX_DONT_WAIT;
+bool targets_in_progress = false;
+uint16_t targets_seqn = 0;
 
-  conn_can_isotp_t conn_isotp;
-  memset(&conn_isotp, 0, sizeof(conn_isotp));
-  ret = conn_can_isotp_create(&conn_isotp, &isotp_opt, 0);
+/* Digest of the "signed" object of the stored targets, valid only if it came from the parser along with them */
+crypto_hash_t targets_digest;
+bool targets_digest_valid = false;
 
-  if (ret < 0) {
-    return ret;
+/* The end of the last part the parser hasn't consumed yet, it goes first in the next one. It holds the longest element
+ * that can straddle two parts. */
+#define TARGETS_TAIL_SIZE TARGETS_SEGMENT_CARRY_SIZE
+char targets_tail[TARGETS_TAIL_SIZE];
+size_t targets_tail_len = 0;
+
+/* Chunks of an image with a hash tree that are already there, the sequence number is one byte */
+uint8_t chunks_received[32];
+
+static bool hash_decompressed(const uint8_t* data, size_t len) {
+  if (!uptane_verify_firmware_feed(data, len)) {
+    return false;
+  }
+  /* data is in the decompression window, which the next output overwrites */
+  while (uptane_verify_firmware_busy()) {
   }
+  return true;
+}
 
-  ret = conn_can_isotp_bind(&conn_isotp);
-  if (ret < 0) {
-    return ret;
+/* Feeds a putTargetsPart to the parser after the tail of the previous one, keeps the new tail. False on error. */
+static bool targets_part(const char* data, size_t len, uptane_targets_t* out_targets, uint16_t* result) {
+  uptane_segment_t segments[2] = {{targets_tail, (jsmnint_t)targets_tail_len}, {data, (jsmnint_t)len}};
+  size_t total = targets_tail_len + len;
+
+  int consumed = uptane_parse_targets_feed_segments(segments, 2, out_targets, result);
+  if (consumed < 0 || *result > RESULT_END_NOT_FOUND || total - consumed > TARGETS_TAIL_SIZE) {
+    return false;
   }
-  for (;;) {
-    if ((ret = conn_can_isotp_recv(&conn_isotp, &isotp_buf, ISOTP_BUF_SIZE, 10000)) >= 0) {
-      switch (isotp_buf[0]) {
-        case UPTANE_GET_SERIAL: {
-          isotp_buf[0] = UPTANE_GET_SERIAL_RESP;
-          const char* ecu_serial = state_get_ecuid();
-          strncpy(isotp_buf + 1, ecu_serial, ISOTP_BUF_SIZE - 1);
-          conn_can_isotp_send(&conn_isotp, &isotp_buf, 1 + strlen(ecu_serial), CAN_ISOTP_TX_DONT_WAIT);
-          break;
-        }
-        case UPTANE_GET_HWID: {
-          isotp_buf[0] = UPTANE_GET_HWID_RESP;
-          const char* ecu_hwid = state_get_hwid();
-          strncpy(isotp_buf + 1, ecu_hwid, ISOTP_BUF_SIZE - 1);
-          conn_can_isotp_send(&conn_isotp, &isotp_buf, 1 + strlen(ecu_hwid), CAN_ISOTP_TX_DONT_WAIT);
-          break;
-        }
-        case UPTANE_GET_PKEY: {
-          const crypto_key_t* pub;
-          const uint8_t* priv;
-
-          state_get_device_key(&pub, &priv);
-          isotp_buf[0] = UPTANE_GET_PKEY_RESP;
-          memcpy(isotp_buf + 1, pub->keyval, CRYPTO_KEYVAL_LEN);
-          conn_can_isotp_send(&conn_isotp, &isotp_buf, 1 + CRYPTO_KEYVAL_LEN, CAN_ISOTP_TX_DONT_WAIT);
-          break;
-        }
-        case UPTANE_GET_ROOT_VER: {
-          uptane_root_t* root = state_get_root();
-          isotp_buf[0] = UPTANE_GET_ROOT_VER_RESP;
-          int2dec(root->version, isotp_buf + 1);
-          conn_can_isotp_send(&conn_isotp, &isotp_buf, 5, 0);
-          break;
-        }
-        case UPTANE_GET_MANIFEST: {
-          isotp_buf[0] = UPTANE_GET_MANIFEST_RESP;
-          strcpy(isotp_buf + 1, "{\"signatures\":");
-          strcpy(isotp_buf + 300, ",\"signed\":");
-          uptane_write_manifest(isotp_buf + 310, isotp_buf + 15);
-          size_t signatures_len = strlen(isotp_buf + 1);
-          size_t signed_len = strlen(isotp_buf + 300);
-          memmove(isotp_buf + 1 + signatures_len, isotp_buf + 300, signed_len);
-          isotp_buf[1 + signatures_len + signed_len] = '}';  // close top object
-          conn_can_isotp_send(&conn_isotp, &isotp_buf, 1 + signatures_len + signed_len + 1, CAN_ISOTP_TX_DONT_WAIT);
-          break;
+  /* the parts are hashed in place */
+  while (uptane_parse_targets_busy()) {
+  }
+  if ((size_t)consumed < targets_tail_len) {
+    memmove(targets_tail, targets_tail + consumed, targets_tail_len - consumed);
+    targets_tail_len -= consumed;
+    consumed = 0;
+  } else {
+    consumed -= targets_tail_len;
+    targets_tail_len = 0;
+  }
+  memcpy(targets_tail + targets_tail_len, data + consumed, len - consumed);
+  targets_tail_len += len - consumed;
+  return true;
+}
+
+static void targets_store(const uptane_targets_t* targets) {
+  state_set_targets(targets);
+  targets_digest_valid = uptane_parse_targets_signed_digest(&targets_digest);
+}
+
+static void put_be32(char* buf, uint32_t value) {
+  buf[0] = value >> 24;
+  buf[1] = value >> 16;
+  buf[2] = value >> 8;
+  buf[3] = value;
+}
+
+/* Writes the resp to getState to buf, returns its length */
+static size_t state_resp(char* buf) {
+  const uptane_installation_state_t* installed = state_get_installation_state();
+  bool image_installed = installed != NULL && installed->firmware_name[0] != '\0';
+
+  memset(buf, 0, UPTANE_STATE_RESP_SIZE);
+  buf[0] = UPTANE_GET_STATE_RESP;
+  put_be32(buf + 1, state_get_root()->version);
+  put_be32(buf + 5, state_get_targets()->version);
+  buf[9] = (targets_digest_valid ? UPTANE_STATE_TARGETS_DIGEST : 0) |
+           (image_installed ? UPTANE_STATE_IMAGE_INSTALLED : 0);
+  if (targets_digest_valid) {
+    memcpy(buf + 10, targets_digest.hash, CRYPTO_MAX_HASH_LEN);
+  }
+  if (image_installed) {
+    buf[10 + CRYPTO_MAX_HASH_LEN] = installed->firmware_hash.alg;
+    memcpy(buf + 11 + CRYPTO_MAX_HASH_LEN, installed->firmware_hash.hash,
+           crypto_get_hashlen(installed->firmware_hash.alg));
+  }
+  return UPTANE_STATE_RESP_SIZE;
+}
+
+static bool image_feed(const uint8_t* data, size_t len) {
+  if (upload_compressed) {
+    return uptane_decompress_feed(data, len, hash_decompressed);
+  }
+  return uptane_verify_firmware_feed(data, len);
+}
+
+/* After the last chunk, confirms the image if it is the target */
+static void image_finish(void) {
+  if ((!upload_compressed || uptane_decompress_finalize()) && uptane_verify_firmware_finalize()) {
+    uptane_firmware_confirm();
+  }
+}
+
+static void windowed_ack(conn_can_isotp_t* conn, char* isotp_buf, uint8_t status) {
+  isotp_buf[0] = UPTANE_PUT_WINDOWED_CHUNK_ACK_ERR;
+  isotp_buf[1] = status;
+  isotp_buf[2] = upload_seqn >> 8;
+  isotp_buf[3] = upload_seqn;
+  conn_can_isotp_send(conn, isotp_buf, 4, CAN_ISOTP_TX_DONT_WAIT);
+}
+
+static uptane_root_t in_root;
+static uptane_targets_t in_targets;
+
+/* Handles a message of ret bytes in isotp_buf, a response goes in the same buffer */
+static void uptane_handle(char* isotp_buf, int ret) {
+  switch (isotp_buf[0]) {
+    case UPTANE_GET_SERIAL: {
+      isotp_buf[0] = UPTANE_GET_SERIAL_RESP;
+      const char* ecu_serial = state_get_ecuid();
+      strncpy(isotp_buf + 1, ecu_serial, ISOTP_BUF_SIZE - 1);
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 1 + strlen(ecu_serial), CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+    case UPTANE_GET_HWID: {
+      isotp_buf[0] = UPTANE_GET_HWID_RESP;
+      const char* ecu_hwid = state_get_hwid();
+      strncpy(isotp_buf + 1, ecu_hwid, ISOTP_BUF_SIZE - 1);
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 1 + strlen(ecu_hwid), CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+    case UPTANE_GET_PKEY: {
+      const crypto_key_t* pub;
+      const uint8_t* priv;
+
+      state_get_device_key(&pub, &priv);
+      isotp_buf[0] = UPTANE_GET_PKEY_RESP;
+      memcpy(isotp_buf + 1, pub->keyval, CRYPTO_KEYVAL_LEN);
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 1 + CRYPTO_KEYVAL_LEN, CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+    case UPTANE_GET_ROOT_VER: {
+      uptane_root_t* root = state_get_root();
+      isotp_buf[0] = UPTANE_GET_ROOT_VER_RESP;
+      int2dec(root->version, isotp_buf + 1);
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 1 + strlen(isotp_buf + 1), 0);
+      break;
+    }
+    case UPTANE_GET_STATE:
+      conn_can_isotp_send(&conn_isotp, isotp_buf, state_resp(isotp_buf), CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    case UPTANE_GET_MANIFEST: {
+      size_t manifest_len;
+      const char* manifest = uptane_manifest(&manifest_len);
+      if (!manifest || manifest_len > ISOTP_BUF_SIZE - 1) {
+        break;
+      }
+      isotp_buf[0] = UPTANE_GET_MANIFEST_RESP;
+      memcpy(isotp_buf + 1, manifest, manifest_len);
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 1 + manifest_len, CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+
+    case UPTANE_PUT_ROOT:
+      if (root_chain_in_progress) {
+        uptane_root_chain_end(false);
+        root_chain_in_progress = false;
+      }
+      if (uptane_parse_root(isotp_buf + 1, ret - 1, &in_root)) {
+        state_set_root(&in_root);
+      } else {
+        state_set_attack(ATTACK_ROOT_THRESHOLD);
+      }
+      break;
+
+    case UPTANE_PUT_ROOT_CHAIN: {
+      bool ok = ret >= 2;
+
+      if (ok && (isotp_buf[1] & UPTANE_ROOT_CHAIN_FIRST)) {
+        if (root_chain_in_progress) {
+          uptane_root_chain_end(false);
         }
+        uptane_root_chain_begin();
+        root_chain_in_progress = true;
+      }
+      ok = ok && root_chain_in_progress;
+      if (ok && !uptane_parse_root(isotp_buf + 2, ret - 2, &in_root)) {
+        ok = false;
+        state_set_attack(ATTACK_ROOT_THRESHOLD);
+      }
+      ok = ok && uptane_root_chain_next(&in_root);
+      if (ok && (isotp_buf[1] & UPTANE_ROOT_CHAIN_LAST)) {
+        uptane_root_chain_end(true);
+        root_chain_in_progress = false;
+      }
+      if (!ok && root_chain_in_progress) {
+        uptane_root_chain_end(false);
+        root_chain_in_progress = false;
+      }
 
-        case UPTANE_PUT_ROOT:
-          if (uptane_parse_root(isotp_buf + 1, ret - 1, &in_root)) {
-            state_set_root(&in_root);
-          } else {
-            state_set_attack(ATTACK_ROOT_THRESHOLD);
-          }
-          break;
+      isotp_buf[0] = UPTANE_PUT_ROOT_CHAIN_ACK_ERR;
+      isotp_buf[1] = ok ? 0x00 : 0xFE;
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+
+    case UPTANE_PUT_TARGETS: {
+      uint16_t targets_result = 0x0000;
+      uptane_parse_targets_init();
+      uptane_parse_targets_feed(isotp_buf + 1, ret - 1, &in_targets, &targets_result);
+      if (targets_result == RESULT_END_FOUND) {
+        targets_store(&in_targets);
+      } else if (targets_result != RESULT_TOO_LARGE) {  // the parser has set ATTACK_TARGETS_LARGE
+        state_set_attack(ATTACK_TARGETS_THRESHOLD);
+      }
+      break;
+    }
+
+    case UPTANE_PUT_TARGETS_PART: {
+      uint16_t targets_result = RESULT_IN_PROGRESS;
+      bool ok = ret >= 4 && isotp_buf[1] <= UPTANE_TARGETS_PART_END;
+      uint16_t seqn = ok ? ((uint8_t)isotp_buf[2] << 8) | (uint8_t)isotp_buf[3] : 0;
 
-        case UPTANE_PUT_TARGETS: {
-          uint16_t targets_result = 0x0000;
+      if (ok && isotp_buf[1] == UPTANE_TARGETS_PART_BEGIN) {
+        ok = (seqn == 0);
+        if (ok) {
           uptane_parse_targets_init();
-          uptane_parse_targets_feed(isotp_buf + 1, ret - 1, &in_targets, &targets_result);
+          targets_tail_len = 0;
+          targets_in_progress = true;
+        }
+      } else if (ok) {
+        ok = targets_in_progress && seqn == (uint16_t)(targets_seqn + 1);
+      }
+
+      if (ok) {
+        targets_seqn = seqn;
+        if (!targets_part(isotp_buf + 4, ret - 4, &in_targets, &targets_result)) {
+          ok = false;
+          if (targets_result != RESULT_TOO_LARGE) {
+            state_set_attack(ATTACK_TARGETS_THRESHOLD);
+          }
+        } else if (isotp_buf[1] == UPTANE_TARGETS_PART_END) {
+          targets_in_progress = false;
           if (targets_result == RESULT_END_FOUND) {
-            state_set_targets(&in_targets);
+            targets_store(&in_targets);
           } else {
+            ok = false;
             state_set_attack(ATTACK_TARGETS_THRESHOLD);
           }
-          break;
         }
+      }
+      if (!ok) {
+        targets_in_progress = false;
+      }
 
-        case UPTANE_PUT_IMAGE_CHUNK:
-          if (ret < 3 || isotp_buf[2] > isotp_buf[1]) {
-            isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
-            isotp_buf[1] = 0xFE;
-            conn_can_isotp_send(&conn_isotp, &isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
-            upload_in_progress = false;
-            break;
-          }
+      while (uptane_parse_targets_busy()) {
+      }
+      isotp_buf[0] = UPTANE_PUT_TARGETS_PART_ACK_ERR;
+      isotp_buf[1] = ok ? 0x00 : 0xFE;
+      isotp_buf[2] = seqn >> 8;
+      isotp_buf[3] = seqn;
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 4, CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
 
-          if (!upload_in_progress) {
-            if (!uptane_verify_firmware_init()) {
-              isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
-              isotp_buf[1] = 0xFE;
-              conn_can_isotp_send(&conn_isotp, &isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
-              upload_in_progress = false;
-              break;
-            }
-            upload_in_progress = true;
-            upload_seqn = 0;
+    case UPTANE_PUT_IMAGE_CHUNK:
+      if (upload_window != 0) {  // a windowed transfer is given up
+        upload_in_progress = false;
+        upload_window = 0;
+      }
+      if (ret < 3 || isotp_buf[2] > isotp_buf[1]) {
+        isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
+        isotp_buf[1] = 0xFE;
+        conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+        upload_in_progress = false;
+        break;
+      }
+
+      if (!upload_in_progress) {
+        const uptane_transfer_checkpoint_t* checkpoint = uptane_firmware_checkpoint();
+        bool started;
+
+        upload_compressed = (state_get_targets()->compressed_length != 0);
+        upload_chunked = (uptane_chunks_num() != 0);
+        if (upload_chunked && uptane_chunks_num() != (uint8_t)isotp_buf[1]) {
+          started = false;
+        } else if (upload_chunked && !upload_compressed) {
+          started = uptane_verify_firmware_init();
+          upload_seqn = 0;
+          memset(chunks_received, 0, sizeof(chunks_received));
+        } else if (!upload_compressed && checkpoint != NULL && (uint8_t)isotp_buf[2] == checkpoint->chunks + 1) {
+          started = uptane_verify_firmware_resume();
+          upload_seqn = checkpoint->chunks;
+          upload_offset = checkpoint->offset;
+        } else {
+          started = uptane_verify_firmware_init();
+          upload_seqn = 0;
+          upload_offset = 0;
+          if (upload_compressed) {
+            uptane_decompress_init(state_get_targets()->length);
           }
+        }
+        if (!started) {
+          isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
+          isotp_buf[1] = 0xFE;
+          conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+          upload_in_progress = false;
+          break;
+        }
+        upload_in_progress = true;
+      }
 
-          if (isotp_buf[2] != upload_seqn + 1) {
-            isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
-            isotp_buf[1] = 0xFE;
-            conn_can_isotp_send(&conn_isotp, &isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
-            upload_in_progress = false;
-            break;
+      const uint8_t* data = (const uint8_t*)isotp_buf + 3;
+      size_t data_len = ret - 3;
+      if (upload_chunked) {
+        uint32_t index = (uint8_t)isotp_buf[2] - 1;
+        size_t path_len = uptane_chunk_path_len(index);
+        if (isotp_buf[2] == 0 || data_len < path_len ||
+            !uptane_verify_chunk(index, data + path_len, data_len - path_len, data)) {
+          isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
+          isotp_buf[1] = 0xFE;
+          conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+          upload_in_progress = false;
+          break;
+        }
+        data += path_len;
+        data_len -= path_len;
+
+        if (!upload_compressed) {
+          /* every chunk is verified against the signed root, so together they are the image */
+          if (!(chunks_received[index / 8] & (1 << (index % 8)))) {
+            chunks_received[index / 8] |= 1 << (index % 8);
+            ++upload_seqn;
           }
-          uptane_verify_firmware_feed((const uint8_t*)isotp_buf + 3, ret - 3);
-          if (isotp_buf[1] == isotp_buf[2]) {
-            upload_in_progress = 0;
-            if (uptane_verify_firmware_finalize()) {
-              uptane_firmware_confirm();
-            }
+          if (upload_seqn == (uint8_t)isotp_buf[1]) {
+            upload_in_progress = false;
+            uptane_firmware_confirm();
           }
-          ++upload_seqn;
           isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
           isotp_buf[1] = 0x00;
-          conn_can_isotp_send(&conn_isotp, &isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
-          break;
-        default:
+          conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
           break;
+        }
+      }
+
+      if (isotp_buf[2] != upload_seqn + 1) {
+        isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
+        isotp_buf[1] = 0xFE;
+        conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+        upload_in_progress = false;
+        break;
+      }
+      if (!image_feed(data, data_len)) {
+        isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
+        isotp_buf[1] = 0xFE;
+        conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+        upload_in_progress = false;
+        break;
+      }
+      upload_offset += data_len;
+      if (isotp_buf[1] == isotp_buf[2]) {
+        upload_in_progress = 0;
+        image_finish();
+      }
+      ++upload_seqn;
+      isotp_buf[0] = UPTANE_PUT_IMAGE_CHUNK_ACK_ERR;
+      isotp_buf[1] = 0x00;
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 2, CAN_ISOTP_TX_DONT_WAIT);
+
+      /* The next chunk is received into the other buffer while the chunk is hashed, this one goes back after it */
+      while (uptane_verify_firmware_busy()) {
+      }
+      if (upload_in_progress && !upload_compressed && !upload_chunked &&
+          upload_seqn % UPTANE_CHECKPOINT_CHUNKS == 0) {
+        uptane_verify_firmware_checkpoint(upload_offset, upload_seqn);
       }
+      break;
+
+    case UPTANE_BEGIN_WINDOWED_IMAGE: {
+      const uptane_transfer_checkpoint_t* checkpoint = uptane_firmware_checkpoint();
+      bool started = false;
+
+      upload_in_progress = false;
+      upload_window = 0;
+      if (ret >= 6 && uptane_chunks_num() == 0 && isotp_buf[3] != 0) {
+        uint16_t first = ((uint8_t)isotp_buf[4] << 8) | (uint8_t)isotp_buf[5];
+
+        upload_total = ((uint8_t)isotp_buf[1] << 8) | (uint8_t)isotp_buf[2];
+        upload_compressed = (state_get_targets()->compressed_length != 0);
+        upload_chunked = false;
+        if (first == 1) {
+          started = uptane_verify_firmware_init();
+          upload_seqn = 0;
+          upload_offset = 0;
+          if (upload_compressed) {
+            uptane_decompress_init(state_get_targets()->length);
+          }
+        } else if (!upload_compressed && checkpoint != NULL && first == checkpoint->chunks + 1) {
+          started = uptane_verify_firmware_resume();
+          upload_seqn = checkpoint->chunks;
+          upload_offset = checkpoint->offset;
+        }
+      }
+      if (started) {
+        upload_window = ((uint8_t)isotp_buf[3] < UPTANE_WINDOW_MAX) ? (uint8_t)isotp_buf[3] : UPTANE_WINDOW_MAX;
+        upload_in_progress = true;
+      }
+      isotp_buf[0] = UPTANE_BEGIN_WINDOWED_IMAGE_RESP;
+      isotp_buf[1] = started ? 0x00 : 0xFE;
+      isotp_buf[2] = upload_window;
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 3, CAN_ISOTP_TX_DONT_WAIT);
+      break;
     }
+
+    case UPTANE_PUT_WINDOWED_CHUNK: {
+      if (!upload_in_progress || upload_window == 0 || ret < 3) {
+        windowed_ack(&conn_isotp, isotp_buf, 0xFE);
+        break;
+      }
+      uint16_t seqn = ((uint8_t)isotp_buf[1] << 8) | (uint8_t)isotp_buf[2];
+      if (seqn <= upload_seqn) {
+        /* sent again after a gap, already taken. The last one may be repeated because its acknowledgement was lost. */
+        if (seqn == upload_seqn) {
+          windowed_ack(&conn_isotp, isotp_buf, 0x00);
+        }
+        break;
+      }
+      if (seqn != upload_seqn + 1) {
+        /* a chunk is missing, the following ones are dropped until it comes. Acknowledged once per gap. */
+        if (seqn == upload_seqn + 2) {
+          windowed_ack(&conn_isotp, isotp_buf, 0x01);
+        }
+        break;
+      }
+      if (!image_feed((const uint8_t*)isotp_buf + 3, ret - 3)) {
+        upload_in_progress = false;
+        upload_window = 0;
+        windowed_ack(&conn_isotp, isotp_buf, 0xFE);
+        break;
+      }
+      upload_offset += ret - 3;
+      ++upload_seqn;
+      /* The next chunks are received into the other buffer while the chunk is hashed, this one goes back after it */
+      while (uptane_verify_firmware_busy()) {
+      }
+      if (upload_seqn == upload_total) {
+        upload_in_progress = false;
+        upload_window = 0;
+        image_finish();
+        windowed_ack(&conn_isotp, isotp_buf, 0x00);
+        break;
+      }
+      if (!upload_compressed && upload_seqn % UPTANE_CHECKPOINT_CHUNKS == 0) {
+        uptane_verify_firmware_checkpoint(upload_offset, upload_seqn);
+      }
+      if (upload_seqn % ((upload_window + 1) / 2) == 0) {
+        windowed_ack(&conn_isotp, isotp_buf, 0x00);
+      }
+      break;
+    }
+
+    case UPTANE_GET_RESUME: {
+      const uptane_transfer_checkpoint_t* checkpoint = uptane_firmware_checkpoint();
+      uint32_t offset = checkpoint ? checkpoint->offset : 0;
+
+      isotp_buf[0] = UPTANE_GET_RESUME_RESP;
+      isotp_buf[1] = offset >> 24;
+      isotp_buf[2] = offset >> 16;
+      isotp_buf[3] = offset >> 8;
+      isotp_buf[4] = offset;
+      isotp_buf[5] = checkpoint ? checkpoint->chunks : 0;
+      isotp_buf[6] = checkpoint ? checkpoint->chunks >> 8 : 0;
+      isotp_buf[7] = checkpoint ? checkpoint->chunks : 0;
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 8, CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+
+    case UPTANE_GET_PROGRESS: {
+      uint32_t received = 0;
+      uint32_t expected = state_get_targets()->length;
+
+      if (upload_in_progress) {
+        uptane_verify_firmware_progress(&received, &expected);
+      }
+      isotp_buf[0] = UPTANE_GET_PROGRESS_RESP;
+      for (int i = 0; i < 4; ++i) {
+        isotp_buf[1 + i] = received >> (24 - 8 * i);
+        isotp_buf[5 + i] = expected >> (24 - 8 * i);
+      }
+      conn_can_isotp_send(&conn_isotp, isotp_buf, 9, CAN_ISOTP_TX_DONT_WAIT);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static void* uptane_recv(void* arg) {
+  unsigned int next = 0;
+  unsigned int in_flight = 0;
+  msg_t msg;
+
+  (void)arg;
+  msg_init_queue(recv_queue, UPTANE_CHUNK_BUFS);
+  for (;;) {
+    while (msg_try_receive(&msg) == 1) {
+      --in_flight;
+    }
+    /* the buffers come back in the order they were sent, the next one is the oldest */
+    if (in_flight == UPTANE_CHUNK_BUFS) {
+      msg_receive(&msg);
+      --in_flight;
+    }
+
+    uptane_chunk_t* chunk = &chunk_pool[next];
+    chunk->len = conn_can_isotp_recv(&conn_isotp, chunk->data, ISOTP_BUF_SIZE, 10000);
+    if (chunk->len < 0) {
+      continue;
+    }
+    msg.content.ptr = chunk;
+    msg_send(&msg, verify_pid);
+    ++in_flight;
+    next = (next + 1) % UPTANE_CHUNK_BUFS;
   }
+  return NULL;
+}
+
+static int uptane_connect(void) {
+  struct isotp_options isotp_opt;
+  int ret;
+
+  memset(&isotp_opt, 0, sizeof(isotp_opt));
+  isotp_opt.rx_id = LIBUPTINY_ISOTP_SECONDARY_CANID;
+  isotp_opt.tx_id = LIBUPTINY_ISOTP_PRIMARY_CANID;
+  isotp_opt.flags |= CAN_ISOTP_TX_DONT_WAIT;
+
+  memset(&conn_isotp, 0, sizeof(conn_isotp));
+  ret = conn_can_isotp_create(&conn_isotp, &isotp_opt, 0);
+  if (ret < 0) {
+    return ret;
+  }
+  return conn_can_isotp_bind(&conn_isotp);
 }
 
 int main(void) {
+  msg_t msg;
+
   xtimer_sleep(1);  // TODO: better way to wait till CAN gets initialized?
 
-  uptane_recv();
+  state_init();
+  if (uptane_connect() < 0) {
+    return 1;
+  }
+
+  verify_pid = thread_getpid();
+  msg_init_queue(verify_queue, UPTANE_CHUNK_BUFS);
+  recv_pid = thread_create(recv_stack, sizeof(recv_stack), THREAD_PRIORITY_MAIN - 1, THREAD_CREATE_STACKTEST,
+                           uptane_recv, NULL, "uptane_recv");
+  if (recv_pid < 0) {
+    return 1;
+  }
+
+  for (;;) {
+    msg_receive(&msg);
+    uptane_chunk_t* chunk = msg.content.ptr;
+    uptane_handle(chunk->data, chunk->len);
+    msg_send(&msg, recv_pid);
+  }
   return 0;
 }
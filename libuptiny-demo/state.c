@@ -1,4 +1,5 @@
 #include <string.h>
+#include "libuptiny/common_data_api.h"
 #include "libuptiny/state_api.h"
 
 uptane_root_t stored_root;
@@ -8,6 +9,9 @@ uptane_targets_t stored_targets;
 uptane_installation_state_t stored_installation_state;
 bool installation_state_present = false;
 
+uptane_transfer_checkpoint_t stored_checkpoint;
+bool checkpoint_present = false;
+
 const crypto_key_t device_public_key = {
     .key_type = CRYPTO_ALG_ED25519,
     .keyid = {0x13, 0xf6, 0x59, 0xbb, 0xe5, 0x9f, 0xdf, 0xfb, 0xed, 0xae, 0x16, 0xd9, 0x63, 0x69, 0xf4, 0x59,
@@ -52,15 +56,24 @@ void state_set_root(const uptane_root_t* root) {
   for (int i = 0; i < stored_root.targets_keys_num; ++i) {
     stored_root.targets_keys[i] = root->targets_keys[i];
   }
+  /* the pointers are kept, the keys of the root stay in the pool until the next one is stored */
+  commit_crypto_keys();
 }
 
 uptane_targets_t* state_get_targets(void) { return &stored_targets; }
 
 void state_set_targets(const uptane_targets_t* targets) { memcpy(&stored_targets, targets, sizeof(uptane_targets_t)); }
 
-const char* state_get_ecuid(void) { return "libuptiny_demo_secondary"; }
+static const char ecuid[] = "libuptiny_demo_secondary";
+static const char hwid[] = "libuptiny_demo";
+
+const char* state_get_ecuid(void) { return ecuid; }
+
+size_t state_get_ecuid_len(void) { return sizeof(ecuid) - 1; }
 
-const char* state_get_hwid(void) { return "libuptiny_demo"; }
+const char* state_get_hwid(void) { return hwid; }
+
+size_t state_get_hwid_len(void) { return sizeof(hwid) - 1; }
 
 void state_set_installation_state(const uptane_installation_state_t* state) {
   memcpy(&stored_installation_state, state, sizeof(uptane_installation_state_t));
@@ -75,7 +88,8 @@ uptane_installation_state_t* state_get_installation_state(void) {
   }
 }
 
-crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA512; }
+/* SHA-256 is about twice as fast as SHA-512 on a 32-bit core */
+crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA256; }
 
 void state_set_attack(uptane_attack_t attack) {
   if (!installation_state_present) {
@@ -84,6 +98,18 @@ void state_set_attack(uptane_attack_t attack) {
   stored_installation_state.attack = attack;
 }
 
+const uptane_transfer_checkpoint_t* state_get_transfer_checkpoint(void) {
+  return checkpoint_present ? &stored_checkpoint : NULL;
+}
+
+void state_set_transfer_checkpoint(const uptane_transfer_checkpoint_t* checkpoint) {
+  /* TODO: write to flash*/
+  checkpoint_present = (checkpoint != NULL);
+  if (checkpoint_present) {
+    memcpy(&stored_checkpoint, checkpoint, sizeof(uptane_transfer_checkpoint_t));
+  }
+}
+
 void state_get_device_key(const crypto_key_t** pub, const uint8_t** priv) {
   *pub = &device_public_key;
   *priv = device_private_key;
@@ -100,6 +126,8 @@ void state_init(void) {
   stored_root.expires.minute = 1;
   stored_root.expires.second = 1;
 
+  crypto_key_prepare(&server_public_key);
+
   stored_root.root_threshold = 1;
   stored_root.root_keys_num = 1;
   stored_root.root_keys[0] = &server_public_key;
@@ -0,0 +1,256 @@
+#include "fleet_verify.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "libuptiny/crypto_api.h"
+#include "libuptiny/json_common.h"
+#include "libuptiny/signatures.h"
+
+namespace {
+
+// A backend context of the size the backend reports
+template <typename T>
+class BackendCtx {
+ public:
+  explicit BackendCtx(size_t size)
+      : storage_((size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t)) {}
+  T* get() { return reinterpret_cast<T*>(storage_.data()); }
+
+ private:
+  std::vector<std::max_align_t> storage_;
+};
+
+// The metadata tokenized as a whole, with the parts every secondary shares
+struct Metadata {
+  const char* data;
+  jsmnint_t len;
+  std::vector<jsmntok_t> tokens;
+  jsmnint_t signatures_idx;  // "signatures" array
+  jsmnint_t begin_signed;    // the "signed" object
+  jsmnint_t end_signed;
+};
+
+// Secondaries trusting the same root, and the signatures of the metadata by its keys
+struct RootGroup {
+  uptane_root_t* root;
+  std::vector<unsigned int> secondaries;
+  std::vector<crypto_key_and_signature_t> signatures;
+  bool parsed;
+  std::atomic<int> num_valid{0};
+};
+
+// Runs the jobs on up to num_threads threads, the calling one included
+void run_jobs(const std::vector<std::function<void()>>& jobs, unsigned int num_threads) {
+  std::atomic<size_t> next{0};
+  auto worker = [&jobs, &next]() {
+    for (size_t i = next++; i < jobs.size(); i = next++) {
+      jobs[i]();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(static_cast<size_t>(num_threads), jobs.size()); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+bool tokenize(const char* data, size_t len, Metadata* meta) {
+  if (len == 0 || len >= static_cast<size_t>(std::numeric_limits<jsmnint_t>::max())) {
+    return false;
+  }
+  meta->data = data;
+  meta->len = static_cast<jsmnint_t>(len);
+  meta->tokens.resize(len / 2 + 1);  // a token takes two characters at least, with its separator
+
+  jsmn_parser parser;
+  jsmn_init(&parser);
+  if (jsmn_parse(&parser, data, meta->len, meta->tokens.data(), static_cast<jsmnint_t>(meta->tokens.size())) <= 0) {
+    return false;
+  }
+
+  const jsmntok_t* tokens = meta->tokens.data();
+  auto num_tokens = static_cast<jsmnint_t>(meta->tokens.size());
+  meta->signatures_idx = -1;
+  meta->begin_signed = meta->end_signed = -1;
+  if (tokens[0].type != JSMN_OBJECT) {
+    return false;
+  }
+  jsmnint_t idx = 1;
+  for (int i = 0; i < tokens[0].size; ++i) {
+    if (json_tok_lit_equal(tokens, data, idx, "signatures")) {
+      meta->signatures_idx = static_cast<jsmnint_t>(idx + 1);
+    } else if (json_tok_lit_equal(tokens, data, idx, "signed")) {
+      meta->begin_signed = tokens[idx + 1].start;
+      meta->end_signed = tokens[idx + 1].end;
+    }
+    idx = json_consume_recursive(tokens, num_tokens, static_cast<jsmnint_t>(idx + 1));
+  }
+  return meta->signatures_idx >= 0 && meta->begin_signed >= 0;
+}
+
+// Checks one signature over the signed part, unless the threshold has been met already
+void verify_signature(const Metadata& meta, RootGroup* group, unsigned int sig) {
+  if (group->num_valid >= group->root->targets_threshold) {
+    return;
+  }
+  BackendCtx<crypto_verify_ctx_t> ctx(crypto_verify_ctx_size());
+  uint8_t block[CRYPTO_VERIFY_BLOCK_LEN];  // its own, the other signatures are checked in other threads
+  crypto_verify_set_block(ctx.get(), block);
+  crypto_verify_init(ctx.get(), &group->signatures[sig]);
+  crypto_verify_feed(ctx.get(), reinterpret_cast<const uint8_t*>(meta.data) + meta.begin_signed,
+                     static_cast<size_t>(meta.end_signed - meta.begin_signed));
+  if (crypto_verify_result(ctx.get())) {
+    ++group->num_valid;
+  }
+}
+
+// Looks up the targets of up to TARGETS_MAX_ECUS secondaries with a context of its own
+uint16_t find_targets(const Metadata& meta, uptane_root_t* root, const uptane_ecu_t* ecus, unsigned int num,
+                      uptane_targets_t* targets, bool* found, uptane_targets_t* out_targets) {
+  std::vector<jsmntok_t> tokens(meta.tokens.size());
+  std::vector<crypto_key_and_signature_t> signatures(std::max(meta.tokens[meta.signatures_idx].size, jsmnint_t{1}));
+  BackendCtx<crypto_hash_ctx_t> hash(crypto_hash_ctx_size());
+  uptane_targets_ctx_t ctx;
+
+  uptane_targets_ctx_setup(&ctx, tokens.data(), static_cast<jsmnint_t>(tokens.size()), signatures.data(),
+                           static_cast<unsigned int>(signatures.size()), nullptr, 0, hash.get(), root);
+  uptane_targets_ctx_init_ecus(&ctx, ecus, num, targets, found);
+  uptane_targets_ctx_trust_signatures(&ctx);
+
+  std::memset(out_targets, 0, sizeof(*out_targets));
+  uint16_t result = RESULT_IN_PROGRESS;
+  jsmnint_t pos = 0;
+  while (result == RESULT_IN_PROGRESS && pos < meta.len) {
+    int consumed = uptane_targets_ctx_feed(&ctx, meta.data + pos, static_cast<jsmnint_t>(meta.len - pos),
+                                           out_targets, &result);
+    if (consumed <= 0) {
+      break;
+    }
+    pos = static_cast<jsmnint_t>(pos + consumed);
+  }
+  while (uptane_targets_ctx_busy(&ctx)) {
+  }
+  return (result == RESULT_IN_PROGRESS) ? static_cast<uint16_t>(RESULT_ERROR) : result;
+}
+
+// Sets the results of the secondaries in group[first, first + num)
+void find_group_targets(const Metadata& meta, const uptane_fleet_secondary_t* secondaries, const RootGroup& group,
+                        size_t first, unsigned int num, uptane_fleet_result_t* results) {
+  uptane_ecu_t ecus[TARGETS_MAX_ECUS];
+  uptane_targets_t targets[TARGETS_MAX_ECUS];
+  bool found[TARGETS_MAX_ECUS];
+  uptane_targets_t out_targets;
+
+  for (unsigned int i = 0; i < num; ++i) {
+    ecus[i] = secondaries[group.secondaries[first + i]].ecu;
+  }
+  uint16_t result = find_targets(meta, group.root, ecus, num, targets, found, &out_targets);
+
+  if (result != RESULT_END_FOUND && result != RESULT_END_NOT_FOUND && num > 1) {
+    // the result may be down to any of them
+    for (unsigned int i = 0; i < num; ++i) {
+      find_group_targets(meta, secondaries, group, first + i, 1, results);
+    }
+    return;
+  }
+  for (unsigned int i = 0; i < num; ++i) {
+    uptane_fleet_result_t* res = &results[group.secondaries[first + i]];
+    if (found[i] && result == RESULT_END_FOUND) {
+      res->result = RESULT_END_FOUND;
+      res->targets = targets[i];
+    } else {
+      res->result = (result == RESULT_END_FOUND) ? static_cast<uint16_t>(RESULT_END_NOT_FOUND) : result;
+      res->targets = out_targets;
+    }
+  }
+}
+
+}  // namespace
+
+bool uptane_fleet_verify_targets(const char* metadata, size_t len, const uptane_fleet_secondary_t* secondaries,
+                                 unsigned int num, uptane_fleet_result_t* results, unsigned int num_threads) {
+  if (metadata == nullptr || secondaries == nullptr || results == nullptr) {
+    return false;
+  }
+#ifdef ED25519_REENTRANT
+  if (num_threads == 0) {
+    num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+#else
+  num_threads = 1;
+#endif
+
+  for (unsigned int i = 0; i < num; ++i) {
+    std::memset(&results[i], 0, sizeof(results[i]));
+    results[i].result = RESULT_ERROR;
+  }
+  Metadata meta;
+  if (!tokenize(metadata, len, &meta)) {
+    return true;
+  }
+
+  std::map<uptane_root_t*, std::unique_ptr<RootGroup>> groups;
+  for (unsigned int i = 0; i < num; ++i) {
+    uptane_root_t* root = (secondaries[i].root != nullptr) ? secondaries[i].root : state_get_root();
+    std::unique_ptr<RootGroup>& group = groups[root];
+    if (!group) {
+      group.reset(new RootGroup);
+      group->root = root;
+    }
+    group->secondaries.push_back(i);
+  }
+
+  // split by signature
+  std::vector<std::function<void()>> jobs;
+  for (auto& entry : groups) {
+    RootGroup* group = entry.second.get();
+    jsmnint_t pos = meta.signatures_idx;
+    group->signatures.resize(std::max(meta.tokens[pos].size, jsmnint_t{1}));
+    int num_signatures = uptane_parse_signatures_in(meta.tokens.data(), static_cast<jsmnint_t>(meta.tokens.size()),
+                                                    ROLE_TARGETS, meta.data, &pos, group->signatures.data(),
+                                                    static_cast<unsigned int>(group->signatures.size()), group->root);
+    group->parsed = (num_signatures > 0);
+    for (int s = 0; group->parsed && s < num_signatures; ++s) {
+      jobs.emplace_back([&meta, group, s]() { verify_signature(meta, group, static_cast<unsigned int>(s)); });
+    }
+  }
+  run_jobs(jobs, num_threads);
+
+  // split by ECU, in groups small enough to keep every thread busy
+  jobs.clear();
+  for (auto& entry : groups) {
+    const RootGroup* group = entry.second.get();
+    if (!group->parsed) {
+      continue;
+    }
+    if (group->num_valid < group->root->targets_threshold) {
+      for (unsigned int i : group->secondaries) {
+        results[i].result = RESULT_SIGNATURES_FAILED;
+      }
+      continue;
+    }
+    size_t per_job = (group->secondaries.size() + num_threads - 1) / num_threads;
+    per_job = std::min(std::max(per_job, size_t{1}), size_t{TARGETS_MAX_ECUS});
+    for (size_t first = 0; first < group->secondaries.size(); first += per_job) {
+      auto n = static_cast<unsigned int>(std::min(per_job, group->secondaries.size() - first));
+      jobs.emplace_back([&meta, secondaries, group, first, n, results]() {
+        find_group_targets(meta, secondaries, *group, first, n, results);
+      });
+    }
+  }
+  run_jobs(jobs, num_threads);
+  return true;
+}
@@ -0,0 +1,45 @@
+#ifndef LIBUPTINY_PRIMARY_FLEET_VERIFY_H
+#define LIBUPTINY_PRIMARY_FLEET_VERIFY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "libuptiny/state_api.h"
+#include "libuptiny/targets.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A secondary the primary forwards targets metadata to */
+typedef struct {
+  uptane_ecu_t ecu;
+  uptane_root_t *root;  // the root the secondary trusts, NULL for state_get_root()
+} uptane_fleet_secondary_t;
+
+/* What the secondary is going to make of the metadata */
+typedef struct {
+  uint16_t result;           // targets_result_t, RESULT_END_FOUND if there is a target for the secondary
+  uptane_targets_t targets;  // the target, or only the version and expiration date with RESULT_END_NOT_FOUND
+} uptane_fleet_result_t;
+
+/* Verifies one targets metadata for num secondaries on up to num_threads threads, 0 for one per CPU, and sets
+ * results[i] for secondaries[i]. The signatures are checked once for every distinct root, one signature per thread at
+ * a time, then the targets are looked up for groups of secondaries on as many threads. A group that fails, e.g.
+ * because of a wrong hardware ID, is looked up again one secondary at a time, so that every secondary gets the result
+ * it would get on its own. The ECU IDs must be distinct.
+ *
+ * The metadata is parsed as a whole, so it can't be longer than jsmnint_t allows (see UPTINY_LARGE_OFFSETS). Only
+ * builds with ED25519_REENTRANT use more than one thread. Like on an ECU, the version is compared to
+ * state_get_targets(), which is called from the threads, as is state_get_supported_hash(). Returns false if an
+ * argument is invalid.
+ */
+bool uptane_fleet_verify_targets(const char *metadata, size_t len, const uptane_fleet_secondary_t *secondaries,
+                                 unsigned int num, uptane_fleet_result_t *results, unsigned int num_threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_PRIMARY_FLEET_VERIFY_H
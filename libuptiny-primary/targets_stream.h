@@ -0,0 +1,232 @@
+#ifndef LIBUPTINY_PRIMARY_TARGETS_STREAM_H
+#define LIBUPTINY_PRIMARY_TARGETS_STREAM_H
+
+// Header-only C++ wrapper of a targets context (uptane_targets_ctx_t) for a primary that streams metadata to its
+// secondaries from asynchronous I/O. Needs C++17, C++20 adds std::span and the coroutine parse_targets().
+
+#if __cplusplus < 201703L
+#error "libuptiny-primary/targets_stream.h needs C++17"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#include <exception>
+#include <utility>
+#define UPTINY_TARGETS_STREAM_COROUTINES
+#endif
+
+#include "libuptiny/targets.h"
+
+namespace uptiny {
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+using ByteSpan = std::span<const std::byte>;
+#else
+// The part of std::span<const std::byte> the stream uses
+class ByteSpan {
+ public:
+  constexpr ByteSpan() noexcept = default;
+  constexpr ByteSpan(const std::byte* data, std::size_t size) noexcept : data_(data), size_(size) {}
+  constexpr const std::byte* data() const noexcept { return data_; }
+  constexpr std::size_t size() const noexcept { return size_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+  constexpr ByteSpan subspan(std::size_t offset) const noexcept { return {data_ + offset, size_ - offset}; }
+
+ private:
+  const std::byte* data_{nullptr};
+  std::size_t size_{0};
+};
+#endif
+
+inline ByteSpan as_byte_span(std::string_view text) noexcept {
+  return {reinterpret_cast<const std::byte*>(text.data()), text.size()};
+}
+
+// Feeds one targets metadata to ctx in parts of any size, as they come. The unconsumed tail of a part is kept in a
+// buffer of CarrySize bytes inside the stream and fed again in front of the next part with
+// uptane_targets_ctx_feed_segments(), so the parts are parsed where they are and nothing is allocated. The tail is at
+// most an element of the metadata the parser waits to see whole, CarrySize must hold the longest one like
+// TARGETS_SEGMENT_CARRY_SIZE does; a longer one fails with RESULT_ERROR.
+//
+// ctx is set up and initialized by the caller, and is fed only by the stream until the result is known. Not for
+// uptane_targets_ctx_signed_buffered(). feed() returns once the part is no longer read, also by a background hash, so
+// the caller can reuse its buffer right away. Not thread-safe: the segment carry of the library is shared, so all
+// streams and segment feeds of a process are to be fed from one thread, e.g. the one running the event loop.
+template <std::size_t CarrySize = TARGETS_SEGMENT_CARRY_SIZE>
+class BasicTargetsStream {
+ public:
+  BasicTargetsStream(uptane_targets_ctx_t& ctx, uptane_targets_t& out) noexcept : ctx_(ctx), out_(out) {}
+  BasicTargetsStream(const BasicTargetsStream&) = delete;
+  BasicTargetsStream& operator=(const BasicTargetsStream&) = delete;
+
+  // Feeds the next part. Returns the result so far, RESULT_IN_PROGRESS until the end of the metadata is found. Bytes
+  // fed after that are ignored
+  std::uint16_t feed(ByteSpan part) noexcept {
+    while (!part.empty() && result_ == RESULT_IN_PROGRESS) {
+      std::size_t len = (part.size() < kMaxPart) ? part.size() : kMaxPart;
+      const char* data = reinterpret_cast<const char*>(part.data());
+      uptane_segment_t segments[2] = {{carry_, static_cast<jsmnint_t>(carry_len_)},
+                                      {data, static_cast<jsmnint_t>(len)}};
+      unsigned int first = (carry_len_ > 0) ? 0 : 1;
+
+      int consumed = uptane_targets_ctx_feed_segments(&ctx_, segments + first, 2 - first, &out_, &result_);
+      while (uptane_targets_ctx_busy(&ctx_)) {
+      }
+      if (consumed < 0) {
+        carry_len_ = 0;
+        break;
+      }
+      carry(data, len, static_cast<std::size_t>(consumed));
+      part = part.subspan(len);
+    }
+    return result_;
+  }
+
+  std::uint16_t feed(std::string_view part) noexcept { return feed(as_byte_span(part)); }
+
+  // The metadata ended, returns the result. RESULT_ERROR if the end of the metadata hasn't been found
+  std::uint16_t finish() noexcept {
+    if (result_ == RESULT_IN_PROGRESS) {
+      result_ = RESULT_ERROR;
+    }
+    carry_len_ = 0;
+    return result_;
+  }
+
+  std::uint16_t result() const noexcept { return result_; }
+  bool done() const noexcept { return result_ != RESULT_IN_PROGRESS; }
+  // bytes waiting for the next part
+  std::size_t carried() const noexcept { return carry_len_; }
+
+ private:
+  static_assert(CarrySize > 0 && CarrySize < static_cast<std::size_t>(std::numeric_limits<jsmnint_t>::max()) / 2,
+                "the carry and a part have to fit in jsmnint_t");
+  // longest part fed at once, a longer one is fed in several
+  static constexpr std::size_t kMaxPart = static_cast<std::size_t>(std::numeric_limits<jsmnint_t>::max()) - CarrySize;
+
+  // keeps what is left of the carry and data after consumed bytes of both
+  void carry(const char* data, std::size_t len, std::size_t consumed) noexcept {
+    std::size_t rest = carry_len_ + len - consumed;
+    if (rest > CarrySize) {
+      result_ = RESULT_ERROR;
+      carry_len_ = 0;
+      return;
+    }
+    if (consumed >= carry_len_) {
+      std::memcpy(carry_, data + (consumed - carry_len_), rest);
+    } else {
+      std::memmove(carry_, carry_ + consumed, carry_len_ - consumed);
+      std::memcpy(carry_ + (carry_len_ - consumed), data, len);
+    }
+    carry_len_ = rest;
+  }
+
+  uptane_targets_ctx_t& ctx_;
+  uptane_targets_t& out_;
+  std::uint16_t result_{RESULT_IN_PROGRESS};
+  std::size_t carry_len_{0};
+  char carry_[CarrySize];
+};
+
+using TargetsStream = BasicTargetsStream<>;
+
+#ifdef UPTINY_TARGETS_STREAM_COROUTINES
+// The coroutine of parse_targets(). It starts when awaited, or when resumed by a caller without coroutines of its
+// own, and gives the result of the stream
+class TargetsParse {
+ public:
+  struct promise_type {
+    std::uint16_t result{RESULT_ERROR};
+    std::exception_ptr exception;
+    std::coroutine_handle<> awaiting;
+
+    struct FinalAwaiter {
+      bool await_ready() const noexcept { return false; }
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+        std::coroutine_handle<> awaiting = handle.promise().awaiting;
+        return awaiting ? awaiting : std::noop_coroutine();
+      }
+      void await_resume() const noexcept {}
+    };
+
+    TargetsParse get_return_object() noexcept {
+      return TargetsParse(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void return_value(std::uint16_t value) noexcept { result = value; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+  };
+
+  TargetsParse(TargetsParse&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+  TargetsParse& operator=(TargetsParse&& other) noexcept {
+    if (this != &other) {
+      destroy();
+      handle_ = std::exchange(other.handle_, {});
+    }
+    return *this;
+  }
+  ~TargetsParse() { destroy(); }
+
+  bool await_ready() const noexcept { return handle_.done(); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+    handle_.promise().awaiting = awaiting;
+    return handle_;
+  }
+  // The result of the stream, or rethrows what the source threw
+  std::uint16_t await_resume() const {
+    if (handle_.promise().exception) {
+      std::rethrow_exception(handle_.promise().exception);
+    }
+    return handle_.promise().result;
+  }
+
+  // For a caller that isn't a coroutine: runs until the source suspends, or to the end
+  void resume() const {
+    if (!handle_.done()) {
+      handle_.resume();
+    }
+  }
+  bool done() const noexcept { return handle_.done(); }
+
+ private:
+  explicit TargetsParse(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+  void destroy() noexcept {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Streams metadata from source into stream. co_await source() gives the next part of the metadata, as anything
+// stream.feed() takes, and an empty one at its end, e.g. a read of a socket in the event loop. Each part is fed as
+// soon as it arrives, no thread waits for the next. The stream must outlive the coroutine, the source is moved into
+// it. Stops reading as soon as the result is known.
+template <std::size_t CarrySize, typename Source>
+TargetsParse parse_targets(BasicTargetsStream<CarrySize>& stream, Source source) {
+  while (!stream.done()) {
+    auto part = co_await source();
+    if (part.empty()) {
+      co_return stream.finish();
+    }
+    stream.feed(part);
+  }
+  co_return stream.result();
+}
+#endif
+
+}  // namespace uptiny
+
+#endif  // LIBUPTINY_PRIMARY_TARGETS_STREAM_H
@@ -1,7 +1,15 @@
 #include "base64.h"
+#include "stats.h"
+
+#include <stdbool.h>
 
 /* Bitfields are not used to be as cross-platform as possible */
 
+#ifdef UPTINY_CODEC_TABLES
+static const char b64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#define encode_6bit(sextet) (b64_alphabet[(sextet)])
+#else
 static inline char encode_6bit(uint8_t sextet) {
   if (sextet <= 25) {
     return (char)('A' + sextet);
@@ -15,6 +23,7 @@ static inline char encode_6bit(uint8_t sextet) {
     return (char)'/';
   }
 }
+#endif
 
 static inline void encode_triple(const uint8_t *msg, int padding, char *out) {
   out[0] = encode_6bit(msg[0] >> 2);
@@ -61,6 +70,29 @@ void base64_encode(const uint8_t *msg, size_t msg_len, char *out) {
 #define B64_SYM_EOL 0xFD
 #define B64_SYM_FAIL_MASK 0xC0
 
+#ifdef UPTINY_CODEC_TABLES
+// Value of every base64 symbol, B64_SYM_* for the rest
+static const uint8_t b64_values[256] = {
+    0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFE, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+#define decode_sym(symbol) (b64_values[(uint8_t)(symbol)])
+#else
 static inline uint8_t decode_sym(char symbol) {
   if (symbol >= 'A' && symbol <= 'Z') {
     return (uint8_t)(symbol - 'A');
@@ -80,6 +112,26 @@ static inline uint8_t decode_sym(char symbol) {
     return B64_SYM_OOR;
   }
 }
+#endif
+
+#ifdef UPTINY_CODEC_TABLES
+// Four symbols without padding, all of them checked at once. The caller makes sure all four are in the string.
+static inline bool decode_full_quadruple(const char *base64, uint8_t *out) {
+  uint8_t s0 = decode_sym(base64[0]);
+  uint8_t s1 = decode_sym(base64[1]);
+  uint8_t s2 = decode_sym(base64[2]);
+  uint8_t s3 = decode_sym(base64[3]);
+  if ((s0 | s1 | s2 | s3) & B64_SYM_FAIL_MASK) {
+    return false;
+  }
+
+  uint32_t bits = ((uint32_t)s0 << 18) | ((uint32_t)s1 << 12) | ((uint32_t)s2 << 6) | s3;
+  out[0] = (uint8_t)(bits >> 16);
+  out[1] = (uint8_t)(bits >> 8);
+  out[2] = (uint8_t)bits;
+  return true;
+}
+#endif
 
 // function can write arbitrary data to out[i>return_value-1 && i < 3]
 static inline int decode_quadruple(const char *base64, uint8_t *out) {
@@ -124,7 +176,14 @@ static inline int decode_quadruple(const char *base64, uint8_t *out) {
 
 int32_t base64_decode(const char *base64, uint32_t base64_len, uint8_t *out) {
   int32_t size = 0;
+  UPTANE_STATS_COUNT(base64_decoded, base64_len);
   for (uint32_t i = 0; i < base64_len; i += 4) {
+#ifdef UPTINY_CODEC_TABLES
+    if (base64_len - i >= 4 && decode_full_quadruple(base64 + i, out + size)) {
+      size += 3;
+      continue;
+    }
+#endif
     int res = decode_quadruple(base64 + i, out + size);
     if (res < 0) {
       return -1;
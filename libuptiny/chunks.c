@@ -0,0 +1,92 @@
+#include "chunks.h"
+#include "common_data_api.h"
+#include "crypto_api.h"
+#include "debug.h"
+#include "state_api.h"
+
+#include <string.h>
+
+static const uint8_t leaf_prefix = 0x00;
+static const uint8_t node_prefix = 0x01;
+
+// the length of the data as it is sent
+static uint32_t sent_length(const uptane_targets_t *targets) {
+  if (targets->compressed_length != 0) {
+    return targets->compressed_length;
+  }
+  if (targets->delta_length != 0) {
+    return targets->delta_length;
+  }
+  return targets->length;
+}
+
+uint32_t uptane_chunks_num(void) {
+  const uptane_targets_t *targets = state_get_targets();
+
+  if (!targets || targets->chunk_size == 0) {
+    return 0;
+  }
+  uint32_t len = sent_length(targets);
+  return len / targets->chunk_size + (len % targets->chunk_size != 0);
+}
+
+// A node has a sibling unless it is the last one on its level and has an even index, then it moves up as it is
+size_t uptane_chunk_path_len(uint32_t index) {
+  uint32_t num = uptane_chunks_num();
+
+  if (index >= num) {
+    return 0;
+  }
+  size_t res = 0;
+  for (uint32_t last = num - 1; last > 0; index >>= 1, last >>= 1) {
+    if ((index & 1) || index < last) {
+      ++res;
+    }
+  }
+  return res * crypto_get_hashlen(state_get_targets()->chunk_root.alg);
+}
+
+static void hash_node(crypto_hash_algorithm_t alg, const uint8_t *left, const uint8_t *right, crypto_hash_t *out) {
+  size_t hash_len = crypto_get_hashlen(alg);
+
+  crypto_hash_init(&chunk_hash_context, alg);
+  crypto_hash_feed(&chunk_hash_context, &node_prefix, 1);
+  crypto_hash_feed(&chunk_hash_context, left, hash_len);
+  crypto_hash_feed(&chunk_hash_context, right, hash_len);
+  crypto_hash_result(&chunk_hash_context, out);
+}
+
+bool uptane_verify_chunk(uint32_t index, const uint8_t *data, size_t len, const uint8_t *path) {
+  uint32_t num = uptane_chunks_num();
+
+  if (index >= num) {
+    DEBUG_PRINTF("Chunk %u out of %u\n", (unsigned int)index, (unsigned int)num);
+    return false;
+  }
+  const uptane_targets_t *targets = state_get_targets();
+  size_t expected_len = (index == num - 1) ? sent_length(targets) - index * targets->chunk_size : targets->chunk_size;
+  if (len != expected_len) {
+    DEBUG_PRINTF("Chunk %u is %u bytes instead of %u\n", (unsigned int)index, (unsigned int)len,
+                 (unsigned int)expected_len);
+    return false;
+  }
+
+  crypto_hash_algorithm_t alg = targets->chunk_root.alg;
+  size_t hash_len = crypto_get_hashlen(alg);
+  crypto_hash_t node;
+  crypto_hash_init(&chunk_hash_context, alg);
+  crypto_hash_feed(&chunk_hash_context, &leaf_prefix, 1);
+  crypto_hash_feed(&chunk_hash_context, data, len);
+  crypto_hash_result(&chunk_hash_context, &node);
+
+  for (uint32_t last = num - 1; last > 0; index >>= 1, last >>= 1) {
+    if (index & 1) {
+      hash_node(alg, path, node.hash, &node);
+      path += hash_len;
+    } else if (index < last) {
+      hash_node(alg, node.hash, path, &node);
+      path += hash_len;
+    }
+  }
+  return !memcmp(node.hash, targets->chunk_root.hash, hash_len);
+}
@@ -0,0 +1,33 @@
+#ifndef LIBUPTINY_CHUNKS_H_
+#define LIBUPTINY_CHUNKS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A target with "chunks" in its custom metadata is sent in chunks of chunk_size bytes, the last one may be shorter.
+ * The chunks are the leaves of a hash tree as in RFC 6962, with the algorithm of chunk_root:
+ *
+ *   leaf = H(0x00 || chunk), node = H(0x01 || left || right)
+ *
+ * The left subtree of n leaves has the largest power of two smaller than n of them. What is chunked is the data as it
+ * is sent, the compressed one or the delta if the target has them. Every chunk comes with its audit path, the hashes
+ * of the siblings from the leaf up, so that it is verified on its own before it is used, in any order.
+ * utils/makechunks.py builds the tree.
+ */
+
+/* Number of chunks of the current target, 0 if it has no hash tree */
+uint32_t uptane_chunks_num(void);
+/* Length of the audit path of chunk index in bytes */
+size_t uptane_chunk_path_len(uint32_t index);
+/* True if data of len bytes is chunk index of the current target, path is its audit path */
+bool uptane_verify_chunk(uint32_t index, const uint8_t *data, size_t len, const uint8_t *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_CHUNKS_H_
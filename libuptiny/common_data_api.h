@@ -9,7 +9,7 @@ extern "C" {
 #endif
 
 extern jsmntok_t token_pool[];
-extern const int16_t token_pool_size;
+extern const jsmnint_t token_pool_size;
 
 extern crypto_key_and_signature_t signature_pool[];
 extern const unsigned int signature_pool_size;
@@ -17,11 +17,26 @@ extern const unsigned int signature_pool_size;
 extern crypto_verify_ctx_t* crypto_ctx_pool[];
 extern const unsigned int crypto_ctx_pool_size;
 
+/* Keys of roots come in two generations. The stored generation holds the keys of the stored root and is never freed
+ * while that root is stored, so the pointers in it and the points crypto_key_prepare() unpacked stay valid. The
+ * candidate generation holds the keys of a root being parsed: alloc_crypto_key allocates in it, free_crypto_key and
+ * free_all_crypto_keys free only from it, and share_crypto_key adds a key of the stored generation to it without a
+ * copy, for a key both roots have. commit_crypto_keys is called by a state_set_root that keeps the pointers: it frees
+ * the stored keys the candidate root doesn't share and makes the candidate generation the stored one, with an empty
+ * candidate generation after it. Keys that are not from the allocator, e.g. static ones, are ignored by all of them.
+ */
 crypto_key_t* alloc_crypto_key(void);
 void free_crypto_key(crypto_key_t* key);
+void share_crypto_key(crypto_key_t* key);
 void free_all_crypto_keys(void);
+void commit_crypto_keys(void);
 
 extern crypto_hash_ctx_t hash_context;
+/* Hashes the chunks of a target with a hash tree while hash_context may hash the image */
+extern crypto_hash_ctx_t chunk_hash_context;
+
+/* Signs the manifest */
+extern crypto_sign_ctx_t sign_context;
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,19 @@
+#ifndef LIBUPTINY_CRC32_H_
+#define LIBUPTINY_CRC32_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* CRC-32 as in zlib and Ethernet. Start with crc 0 and pass the result on to continue with more data. A platform with
+ * a CRC engine can provide this function instead of building crc32.c.
+ */
+uint32_t uptane_crc32(uint32_t crc, const uint8_t *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_CRC32_H_
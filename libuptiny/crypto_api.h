@@ -5,6 +5,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include "uptiny_config.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -13,8 +15,9 @@ extern "C" {
 #define CRYPTO_KEYVAL_LEN 32        /* public key length, 32 for ed25519 */
 #define CRYPTO_MAX_SIGNATURE_LEN 64 /* enough to hold ed25519 signature */
 #define CRYPTO_MAX_HASH_LEN 64      /* enough to hold sha512 hash */
+#define CRYPTO_KEYCACHE_LEN 64      /* unpacked public key, x and y for ed25519 */
 
-typedef enum { CRYPTO_HASH_UNKNOWN = -1, CRYPTO_HASH_SHA512 = 0 } crypto_hash_algorithm_t;
+typedef enum { CRYPTO_HASH_UNKNOWN = -1, CRYPTO_HASH_SHA512 = 0, CRYPTO_HASH_SHA256 = 1 } crypto_hash_algorithm_t;
 typedef struct {
   crypto_hash_algorithm_t alg;
   uint8_t hash[CRYPTO_MAX_HASH_LEN];
@@ -25,6 +28,11 @@ typedef struct {
   crypto_algorithm_t key_type;
   uint8_t keyid[CRYPTO_KEYID_LEN];
   uint8_t keyval[CRYPTO_KEYVAL_LEN];
+#ifdef CRYPTO_KEY_CACHE
+  /* keyval in the form the backend verifies with, filled by crypto_key_prepare() */
+  bool cached;
+  uint8_t cache[CRYPTO_KEYCACHE_LEN];
+#endif
 } crypto_key_t;
 
 typedef struct {
@@ -34,15 +42,96 @@ typedef struct {
 
 typedef struct crypto_verify_ctx crypto_verify_ctx_t;
 typedef struct crypto_hash_ctx crypto_hash_ctx_t;
+typedef struct crypto_sign_ctx crypto_sign_ctx_t;
+
+/* Call once keyval is set and before the key is used for verification. With CRYPTO_KEY_CACHE, the public key is
+ * decompressed here once instead of in every crypto_verify_result().
+ */
+void crypto_key_prepare(crypto_key_t* key);
+
+/* A verify context keeps the bytes of the message it has yet to hash in a block buffer of CRYPTO_VERIFY_BLOCK_LEN
+ * bytes, given to it once with crypto_verify_set_block() before its first crypto_verify_init(). The context itself
+ * holds the hash state and the count of bytes fed, which places R and A before the message. Contexts that are always
+ * fed the same message from its start, like those of crypto_ctx_pool with crypto_verify_feed_multi_start(), have the
+ * same bytes buffered and share one buffer, so the message is copied once rather than once per context. A context fed
+ * anything else on its own needs a buffer of its own. The buffer has to stay untouched until the results of all the
+ * contexts sharing it are known.
+ */
+#define CRYPTO_VERIFY_BLOCK_LEN 128 /* SHA-512 block */
+void crypto_verify_set_block(crypto_verify_ctx_t* ctx, uint8_t* block);
 
 void crypto_verify_init(crypto_verify_ctx_t* ctx, crypto_key_and_signature_t* sig);
 void crypto_verify_feed(crypto_verify_ctx_t* ctx, const uint8_t* data, size_t len);
 bool crypto_verify_result(crypto_verify_ctx_t* ctx);
 
-void crypto_hash_init(crypto_hash_ctx_t* ctx);
+/* Finish several verifications at once. The implementation may check the signatures as a batch and fall back to
+ * checking them one by one if the batch fails. If valid is not NULL, valid[i] is set to the result for ctx[i].
+ * Returns the number of valid signatures.
+ */
+int crypto_verify_result_batch(crypto_verify_ctx_t* const* ctx, unsigned int num, bool* valid);
+
+/* Finish verifications until threshold signatures are found valid, or until threshold can't be reached with the rest.
+ * Number of signatures actually checked is written to num_checked. Returns the number of valid signatures found.
+ */
+int crypto_verify_result_threshold(crypto_verify_ctx_t* const* ctx, unsigned int num, int threshold,
+                                   unsigned int* num_checked);
+
+/* Built with ED25519_REENTRANT, the software backends can run crypto_verify_init, crypto_verify_feed and
+ * crypto_verify_result, and the hash functions, in several threads at once, each on contexts of its own. The batch
+ * and threshold functions keep their state in static storage either way.
+ */
+
+/* Sizes of the contexts, for callers that allocate them at run time instead of in common_data. A verify context needs
+ * a block buffer too, see crypto_verify_set_block().
+ */
+size_t crypto_verify_ctx_size(void);
+size_t crypto_hash_ctx_size(void);
+
+void crypto_hash_init(crypto_hash_ctx_t* ctx, crypto_hash_algorithm_t alg);
 void crypto_hash_feed(crypto_hash_ctx_t* ctx, const uint8_t* data, size_t len);
 void crypto_hash_result(crypto_hash_ctx_t* ctx, crypto_hash_t* hash);
 
+/* A hash in progress as plain bytes, to persist it and continue hashing after a reset. It can only be restored by the
+ * backend that saved it, and no operation may be in progress on the context when it is saved.
+ */
+#define CRYPTO_HASH_CHECKPOINT_LEN 208 /* enough for the state and the partial block of sha512 */
+typedef struct {
+  uint8_t data[CRYPTO_HASH_CHECKPOINT_LEN];
+} crypto_hash_checkpoint_t;
+
+void crypto_hash_save(const crypto_hash_ctx_t* ctx, crypto_hash_checkpoint_t* checkpoint);
+void crypto_hash_restore(crypto_hash_ctx_t* ctx, const crypto_hash_checkpoint_t* checkpoint);
+
+/* Asynchronous operations, for backends that offload to a hardware engine completing by interrupt. A *_start function
+ * returns CRYPTO_OP_IN_PROGRESS if the operation goes on in the background. Until the matching poll function returns
+ * CRYPTO_OP_DONE, the data must stay untouched and the context must not be used otherwise. Poll may sleep until the
+ * engine's next interrupt. Software backends do all the work in *_start. The synchronous functions above wait for
+ * completion.
+ */
+typedef enum { CRYPTO_OP_DONE = 0, CRYPTO_OP_IN_PROGRESS = 1 } crypto_op_status_t;
+
+crypto_op_status_t crypto_hash_feed_start(crypto_hash_ctx_t* ctx, const uint8_t* data, size_t len);
+crypto_op_status_t crypto_hash_poll(crypto_hash_ctx_t* ctx);
+
+crypto_op_status_t crypto_verify_feed_start(crypto_verify_ctx_t* ctx, const uint8_t* data, size_t len);
+/* Same as crypto_verify_feed_start on each of num contexts that have been fed the same amount so far, as those of the
+ * signatures over one message are. Software backends hash every block into all of them at once, which costs little
+ * more than one, and copy the partial blocks once to a buffer the contexts share. Each context is polled on its own.
+ */
+crypto_op_status_t crypto_verify_feed_multi_start(crypto_verify_ctx_t* const* ctx, unsigned int num,
+                                                  const uint8_t* data, size_t len);
+crypto_op_status_t crypto_verify_poll(crypto_verify_ctx_t* ctx);
+
+/* Same as crypto_verify_result_threshold, only one can be in progress at a time. Software backends check signatures in
+ * crypto_verify_result_step, which does at most budget steps and returns CRYPTO_OP_IN_PROGRESS while there are more.
+ * A step is bounded by a field inversion or square root, or one digit of a scalar multiplication, and a signature
+ * takes some 260 of them, so that a main loop can keep its other work going while metadata is verified. Poll does a
+ * few steps on its own. Hardware backends return from step as from poll.
+ */
+crypto_op_status_t crypto_verify_result_start(crypto_verify_ctx_t* const* ctx, unsigned int num, int threshold);
+crypto_op_status_t crypto_verify_result_step(unsigned int budget);
+crypto_op_status_t crypto_verify_result_poll(int* num_valid, unsigned int* num_checked);
+
 crypto_algorithm_t crypto_str_to_keytype(const char* keytype, size_t len);
 size_t crypto_get_keylen(crypto_algorithm_t alg);
 size_t crypto_get_siglen(crypto_algorithm_t alg);
@@ -51,6 +140,15 @@ crypto_hash_algorithm_t crypto_str_to_hashtype(const char* hashtype, size_t len)
 size_t crypto_get_hashlen(crypto_hash_algorithm_t alg);
 
 void crypto_sign_data(const char* data, size_t len, crypto_key_and_signature_t* out_sig, const uint8_t* private_key);
+
+/* Signing data fed in pieces, for callers that don't keep it in one buffer. The backend may need the data more than
+ * once, ed25519 hashes it twice: as long as crypto_sign_result() returns false, the same data has to be fed again from
+ * the start. Once it returns true, out_sig->sig holds the signature. out_sig and private_key must stay in place until
+ * then.
+ */
+void crypto_sign_init(crypto_sign_ctx_t* ctx, crypto_key_and_signature_t* out_sig, const uint8_t* private_key);
+void crypto_sign_feed(crypto_sign_ctx_t* ctx, const uint8_t* data, size_t len);
+bool crypto_sign_result(crypto_sign_ctx_t* ctx);
 #ifdef __cplusplus
 }
 #endif
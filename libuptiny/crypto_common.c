@@ -2,17 +2,68 @@
 #include "debug.h"
 #include "utils.h"
 
+#include <string.h>
+
+static int keyid_cmp(const uint8_t* keyid, const crypto_key_t* key) {
+  return memcmp(keyid, key->keyid, CRYPTO_KEYID_LEN);
+}
+
+crypto_key_t* find_key_bin(const uint8_t* keyid, crypto_key_t** keys, int num_keys) {
+  int lo = 0;
+  int hi = num_keys;
+
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    int cmp = keyid_cmp(keyid, keys[mid]);
+    if (cmp == 0) {
+      return keys[mid];
+    } else if (cmp < 0) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return NULL;
+}
+
 crypto_key_t* find_key(const char* key_id, int len, crypto_key_t** keys, int num_keys) {
-  if (len != (CRYPTO_KEYID_LEN * 2)) {
+  uint8_t keyid[CRYPTO_KEYID_LEN];
+
+  if (len != (CRYPTO_KEYID_LEN * 2) || !hex2bin(key_id, len, keyid)) {
     return NULL;
   }
 
-  for (int i = 0; i < num_keys; i++) {
-    if (hex_bin_cmp(key_id, len, keys[i]->keyid) == 0) {
-      return keys[i];
-    }
+  crypto_key_t* key = find_key_bin(keyid, keys, num_keys);
+  if (key == NULL) {
+    DEBUG_PRINTF("Key not found: %.*s\n", len, key_id);
+  }
+  return key;
+}
+
+bool key_index_insert(crypto_key_t** keys, int num_keys) {
+  crypto_key_t* key = keys[num_keys];
+
+  if (find_key_bin(key->keyid, keys, num_keys) != NULL) {
+    return false;
   }
 
-  DEBUG_PRINTF("Key not found: %.*s\n", len, key_id);
-  return NULL;
+  int i = num_keys;
+  while (i > 0 && keyid_cmp(key->keyid, keys[i - 1]) < 0) {
+    keys[i] = keys[i - 1];
+    --i;
+  }
+  keys[i] = key;
+  return true;
+}
+
+void crypto_hash_wait(crypto_hash_ctx_t* ctx) {
+  while (crypto_hash_poll(ctx) != CRYPTO_OP_DONE) {
+  }
+}
+
+void crypto_verify_wait(crypto_verify_ctx_t* const* ctx, unsigned int num) {
+  for (unsigned int i = 0; i < num; i++) {
+    while (crypto_verify_poll(ctx[i]) != CRYPTO_OP_DONE) {
+    }
+  }
 }
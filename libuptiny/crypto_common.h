@@ -3,6 +3,23 @@
 
 #include "crypto_api.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Key lists handed to find_key are sorted by binary key ID. find_key decodes the hex ID once and binary searches */
 crypto_key_t* find_key(const char* key_id, int len, crypto_key_t** keys, int num_keys);
+crypto_key_t* find_key_bin(const uint8_t* keyid, crypto_key_t** keys, int num_keys);
+
+/* Move keys[num_keys] into its sorted position among the first num_keys entries. Returns false and leaves keys
+ * untouched if the key ID is already present */
+bool key_index_insert(crypto_key_t** keys, int num_keys);
+
+/* Wait for asynchronous operations to complete */
+void crypto_hash_wait(crypto_hash_ctx_t* ctx);
+void crypto_verify_wait(crypto_verify_ctx_t* const* ctx, unsigned int num);
 
+#ifdef __cplusplus
+}
+#endif
 #endif  // LIBUPTINY_CRYPTO_COMMON_H_
@@ -0,0 +1,126 @@
+#include "decompress.h"
+#include "debug.h"
+
+#include <string.h>
+
+#define WINDOW_SIZE (1U << HEATSHRINK_WINDOW_BITS)
+#define WINDOW_MASK (WINDOW_SIZE - 1)
+
+typedef enum {
+  DECOMPRESS_TAG,
+  DECOMPRESS_LITERAL,
+  DECOMPRESS_INDEX,
+  DECOMPRESS_COUNT,
+} decompress_step_t;
+
+static const int step_bits[] = {1, 8, HEATSHRINK_WINDOW_BITS, HEATSHRINK_LOOKAHEAD_BITS};
+
+static uint8_t window[WINDOW_SIZE];
+static unsigned int window_head;     // where the next output byte goes
+static unsigned int window_flushed;  // the first byte not given to output yet
+static uint32_t out_left;
+
+static uint32_t bits;  // input bits not used yet are the lowest bits_num
+static int bits_num;
+static decompress_step_t step;
+static unsigned int backref_offset;
+static bool decompress_failed;
+
+void uptane_decompress_init(uint32_t out_len) {
+  memset(window, 0, sizeof(window));
+  window_head = 0;
+  window_flushed = 0;
+  out_left = out_len;
+
+  bits = 0;
+  bits_num = 0;
+  step = DECOMPRESS_TAG;
+  decompress_failed = false;
+}
+
+static inline bool decompress_fail(void) {
+  decompress_failed = true;
+  return false;
+}
+
+static inline bool flush(uptane_decompress_output_t output) {
+  bool res = (window_head == window_flushed) || output(window + window_flushed, window_head - window_flushed);
+  window_flushed = window_head;
+  return res;
+}
+
+// output is only called on whole runs of the window, the window is flushed before it wraps around
+static inline bool put_byte(uint8_t c, uptane_decompress_output_t output) {
+  window[window_head++] = c;
+  --out_left;
+  if (window_head == WINDOW_SIZE) {
+    if (!flush(output)) {
+      return false;
+    }
+    window_head = 0;
+    window_flushed = 0;
+  }
+  return true;
+}
+
+bool uptane_decompress_feed(const uint8_t *data, size_t len, uptane_decompress_output_t output) {
+  if (decompress_failed) {
+    return false;
+  }
+
+  size_t i = 0;
+  for (;;) {
+    if (out_left == 0) {
+      // only the padding of the last byte may follow
+      if (i < len) {
+        DEBUG_PRINTF("Data after the end of the compressed image\n");
+        return decompress_fail();
+      }
+      return flush(output) || decompress_fail();
+    }
+
+    int need = step_bits[step];
+    if (bits_num < need) {
+      if (i == len) {
+        return flush(output) || decompress_fail();
+      }
+      bits = (bits << 8) | data[i++];
+      bits_num += 8;
+    }
+    bits_num -= need;
+    unsigned int value = (unsigned int)(bits >> bits_num) & ((1U << need) - 1);
+
+    switch (step) {
+      case DECOMPRESS_TAG:
+        step = value ? DECOMPRESS_LITERAL : DECOMPRESS_INDEX;
+        break;
+
+      case DECOMPRESS_LITERAL:
+        if (!put_byte((uint8_t)value, output)) {
+          return decompress_fail();
+        }
+        step = DECOMPRESS_TAG;
+        break;
+
+      case DECOMPRESS_INDEX:
+        backref_offset = value + 1;
+        step = DECOMPRESS_COUNT;
+        break;
+
+      case DECOMPRESS_COUNT:
+        if (value + 1 > out_left) {
+          DEBUG_PRINTF("Compressed image is longer than expected\n");
+          return decompress_fail();
+        }
+        for (unsigned int count = value + 1; count > 0; --count) {
+          if (!put_byte(window[(window_head - backref_offset) & WINDOW_MASK], output)) {
+            return decompress_fail();
+          }
+        }
+        step = DECOMPRESS_TAG;
+        break;
+    }
+  }
+}
+
+bool uptane_decompress_finalize(void) { return !decompress_failed && out_left == 0; }
@@ -0,0 +1,37 @@
+#ifndef LIBUPTINY_DECOMPRESS_H_
+#define LIBUPTINY_DECOMPRESS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Streaming heatshrink (LZSS) decoder, the data is what `heatshrink -e -w 8 -l 4` writes: a stream of bits, most
+ * significant first, with
+ *
+ *   1 LLLLLLLL     the literal byte L
+ *   0 IIIIIIII CCCC  copy C+1 bytes starting I+1 bytes back in the output
+ *
+ * padded with zeros to a whole byte. The window, the output that can still be copied from, is all zeros at the start.
+ * utils/compress.py creates compressed images. */
+#define HEATSHRINK_WINDOW_BITS 8
+#define HEATSHRINK_LOOKAHEAD_BITS 4
+
+/* Receives the output in order. The data points into the window, it is only valid until the function returns. */
+typedef bool (*uptane_decompress_output_t)(const uint8_t *data, size_t len);
+
+/* out_len is the length of the decompressed data */
+void uptane_decompress_init(uint32_t out_len);
+/* False if the data is malformed or output fails, the rest of the data is refused then. Everything that the data
+ * decompresses to is given to output before this returns. */
+bool uptane_decompress_feed(const uint8_t *data, size_t len, uptane_decompress_output_t output);
+/* True if exactly out_len bytes were decompressed */
+bool uptane_decompress_finalize(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_DECOMPRESS_H_
@@ -0,0 +1,97 @@
+#include "delta.h"
+#include "debug.h"
+
+#define DELTA_OP_COPY 0x80
+#define DELTA_COPY_HEAD_LEN 5
+#define DELTA_INSERT_HEAD_LEN 2
+
+static const uint8_t *delta_base;
+static uint32_t delta_base_len;
+static uint32_t delta_image_len;
+static bool delta_in_place;
+
+static uint32_t out_pos;      // bytes of the image rebuilt so far
+static uint32_t insert_left;  // bytes of the current insert still to come
+static uint8_t op_head[DELTA_COPY_HEAD_LEN];
+static int op_head_len;  // bytes of the next operation's head received so far
+static bool delta_failed;
+
+void uptane_delta_init(const uint8_t *base, uint32_t base_len, uint32_t image_len, bool in_place) {
+  delta_base = base;
+  delta_base_len = base_len;
+  delta_image_len = image_len;
+  delta_in_place = in_place;
+
+  out_pos = 0;
+  insert_left = 0;
+  op_head_len = 0;
+  delta_failed = false;
+}
+
+static inline bool delta_fail(void) {
+  delta_failed = true;
+  return false;
+}
+
+// runs the operation whose head is complete, an insert only starts
+static inline bool start_op(uptane_delta_output_t output) {
+  uint32_t op_len = ((uint32_t)(op_head[0] & ~DELTA_OP_COPY) << 8) | op_head[1];
+
+  op_head_len = 0;
+  if (op_len == 0 || op_len > delta_image_len - out_pos) {
+    DEBUG_PRINTF("Invalid delta operation length %u at %u\n", (unsigned int)op_len, (unsigned int)out_pos);
+    return false;
+  }
+
+  if (!(op_head[0] & DELTA_OP_COPY)) {
+    insert_left = op_len;
+    return true;
+  }
+
+  uint32_t offset = ((uint32_t)op_head[2] << 16) | ((uint32_t)op_head[3] << 8) | op_head[4];
+  if (offset > delta_base_len || op_len > delta_base_len - offset) {
+    DEBUG_PRINTF("Delta copies from outside of the base: %u+%u\n", (unsigned int)offset, (unsigned int)op_len);
+    return false;
+  }
+  if (delta_in_place && offset < out_pos) {
+    DEBUG_PRINTF("Delta copies from %u, already overwritten at %u\n", (unsigned int)offset, (unsigned int)out_pos);
+    return false;
+  }
+
+  if (!output(delta_base + offset, op_len)) {
+    return false;
+  }
+  out_pos += op_len;
+  return true;
+}
+
+bool uptane_delta_feed(const uint8_t *data, size_t len, uptane_delta_output_t output) {
+  if (delta_failed) {
+    return false;
+  }
+
+  size_t i = 0;
+  while (i < len) {
+    if (insert_left > 0) {
+      size_t n = (len - i < insert_left) ? len - i : insert_left;
+      if (!output(data + i, n)) {
+        return delta_fail();
+      }
+      i += n;
+      insert_left -= (uint32_t)n;
+      out_pos += (uint32_t)n;
+      continue;
+    }
+
+    op_head[op_head_len++] = data[i++];
+    int head_len = (op_head[0] & DELTA_OP_COPY) ? DELTA_COPY_HEAD_LEN : DELTA_INSERT_HEAD_LEN;
+    if (op_head_len == head_len && !start_op(output)) {
+      return delta_fail();
+    }
+  }
+  return true;
+}
+
+bool uptane_delta_finalize(void) {
+  return !delta_failed && op_head_len == 0 && insert_left == 0 && out_pos == delta_image_len;
+}
@@ -0,0 +1,37 @@
+#ifndef LIBUPTINY_DELTA_H_
+#define LIBUPTINY_DELTA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A delta rebuilds an image from the installed one (the base) as a sequence of operations, the numbers are big
+ * endian:
+ *
+ *   0b1LLLLLLL LLLLLLLL OOOOOOOO OOOOOOOO OOOOOOOO  copy L bytes of the base starting at offset O
+ *   0b0LLLLLLL LLLLLLLL <L bytes>                   insert the L bytes that follow
+ *
+ * L is 1 to 32767. utils/makedelta.py creates deltas.
+ */
+#define DELTA_MAX_OP_LEN 0x7FFF
+
+/* Receives the rebuilt image in order. The data points into the base or into the delta given to uptane_delta_feed. */
+typedef bool (*uptane_delta_output_t)(const uint8_t *data, size_t len);
+
+/* image_len is the length of the rebuilt image. With in_place set the image replaces the base while it is rebuilt, so
+ * copies may only read the base at or after the offset they are written to.
+ */
+void uptane_delta_init(const uint8_t *base, uint32_t base_len, uint32_t image_len, bool in_place);
+/* False if the delta is malformed or output fails, the rest of the delta is refused then */
+bool uptane_delta_feed(const uint8_t *data, size_t len, uptane_delta_output_t output);
+/* True if the delta ended after an operation and rebuilt exactly image_len bytes */
+bool uptane_delta_finalize(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_DELTA_H_
@@ -1,12 +1,20 @@
 #include "firmware.h"
 #include "common_data_api.h"
 #include "crypto_api.h"
+#include "crypto_common.h"
+#include "crc32.h"
+#include "debug.h"
 #include "state_api.h"
+#include "stats.h"
 
 #include <string.h>
 
 const crypto_hash_t *expected_hash;
 bool firmware_updated = true;
+static uint32_t image_crc;  // of the image fed so far
+static uint32_t image_fed;
+static uint32_t image_expected;
+static bool image_too_large;
 
 bool uptane_firmware_updated(void) {
   bool res = firmware_updated;
@@ -14,6 +22,18 @@ bool uptane_firmware_updated(void) {
   return res;
 }
 
+/* The preferred hash if the metadata lists it, any other it lists otherwise. Unknown ones are dropped by the parser. */
+static const crypto_hash_t *target_hash(const uptane_targets_t *targets) {
+  const crypto_hash_t *res = NULL;
+  crypto_hash_algorithm_t alg = state_get_supported_hash();
+  for (int i = 0; i < targets->hashes_num; ++i) {
+    if (targets->hashes[i].alg == alg || res == NULL) {
+      res = &targets->hashes[i];
+    }
+  }
+  return res;
+}
+
 bool uptane_verify_firmware_init(void) {
   const uptane_targets_t *targets = state_get_targets();
 
@@ -22,32 +42,68 @@ bool uptane_verify_firmware_init(void) {
   }
   const uptane_installation_state_t *state = state_get_installation_state();
 
-  expected_hash = NULL;
-  crypto_hash_algorithm_t alg = state_get_supported_hash();
-  for (int i = 0; i < targets->hashes_num; ++i) {
-    if (targets->hashes[i].alg == alg) {
-      expected_hash = &targets->hashes[i];
-    }
-  }
-
+  expected_hash = target_hash(targets);
   if (expected_hash == NULL) {
     return false;
   }
 
   if (state) {
-    if (!memcmp(expected_hash->hash, state->firmware_hash.hash, crypto_get_hashlen(alg))) {
-      return false;  // expected hash matches what is already installed, no update
+    for (int i = 0; i < targets->hashes_num; ++i) {
+      if (targets->hashes[i].alg == state->firmware_hash.alg &&
+          !memcmp(targets->hashes[i].hash, state->firmware_hash.hash, crypto_get_hashlen(state->firmware_hash.alg))) {
+        return false;  // expected hash matches what is already installed, no update
+      }
+    }
+  }
+
+  if (targets->delta_length != 0) {
+    // a delta only rebuilds the image from the base it was made against
+    if (!state || state->firmware_hash.alg != targets->delta_base.alg ||
+        memcmp(state->firmware_hash.hash, targets->delta_base.hash, crypto_get_hashlen(targets->delta_base.alg))) {
+      return false;
     }
   }
-  crypto_hash_init(&hash_context);
+  crypto_hash_init(&hash_context, expected_hash->alg);
+  image_crc = 0;
+  image_fed = 0;
+  image_expected = targets->length;
+  image_too_large = false;
+  UPTANE_STATS_STAGE(UPTANE_STAGE_IMAGE_BEGIN);
+  return true;
+}
+
+bool uptane_verify_firmware_feed(const uint8_t *data, size_t len) {
+  if (image_too_large || len > image_expected - image_fed) {
+    if (!image_too_large) {
+      DEBUG_PRINTF("Image is longer than the %u bytes of the target\n", (unsigned int)image_expected);
+      state_set_attack(ATTACK_IMAGE_LARGE);
+    }
+    image_too_large = true;
+    return false;
+  }
+  crypto_hash_wait(&hash_context);
+  crypto_hash_feed_start(&hash_context, data, len);
+  image_crc = uptane_crc32(image_crc, data, len);
+  image_fed += (uint32_t)len;
   return true;
 }
 
-void uptane_verify_firmware_feed(const uint8_t *data, size_t len) { crypto_hash_feed(&hash_context, data, len); }
+void uptane_verify_firmware_progress(uint32_t *received, uint32_t *expected) {
+  *received = image_fed;
+  *expected = image_expected;
+}
+
+bool uptane_verify_firmware_busy(void) { return crypto_hash_poll(&hash_context) != CRYPTO_OP_DONE; }
 
 bool uptane_verify_firmware_finalize(void) {
   crypto_hash_t computed_hash;
+
+  crypto_hash_wait(&hash_context);
   crypto_hash_result(&hash_context, &computed_hash);
+  UPTANE_STATS_STAGE(UPTANE_STAGE_IMAGE_END);
+  if (image_too_large || image_fed != image_expected) {
+    return false;
+  }
   return !memcmp(computed_hash.hash, expected_hash->hash, crypto_get_hashlen(expected_hash->alg));
 }
 
@@ -63,8 +119,77 @@ void uptane_firmware_confirm(void) {
   new_state.firmware_name[TARGETS_MAX_NAME_LENGTH] = '\0';
   new_state.firmware_hash = *expected_hash;
   new_state.firmware_length = targets->length;
+  new_state.image_crc = image_crc;
   new_state.attack = ATTACK_NONE;
 
   state_set_installation_state(&new_state);
+  state_set_transfer_checkpoint(NULL);
   firmware_updated = true;
 }
+
+void uptane_verify_firmware_checkpoint(uint32_t offset, uint32_t chunks) {
+  uptane_transfer_checkpoint_t checkpoint;
+
+  crypto_hash_wait(&hash_context);
+  checkpoint.target_hash = *expected_hash;
+  checkpoint.offset = offset;
+  checkpoint.chunks = chunks;
+  checkpoint.image_fed = image_fed;
+  checkpoint.image_crc = image_crc;
+  crypto_hash_save(&hash_context, &checkpoint.image_hash);
+  state_set_transfer_checkpoint(&checkpoint);
+}
+
+const uptane_transfer_checkpoint_t *uptane_firmware_checkpoint(void) {
+  const uptane_targets_t *targets = state_get_targets();
+  const uptane_transfer_checkpoint_t *checkpoint = state_get_transfer_checkpoint();
+
+  if (!targets || !checkpoint) {
+    return NULL;
+  }
+  const crypto_hash_t *hash = target_hash(targets);
+  if (!hash || hash->alg != checkpoint->target_hash.alg ||
+      memcmp(hash->hash, checkpoint->target_hash.hash, crypto_get_hashlen(hash->alg))) {
+    return NULL;
+  }
+  return checkpoint;
+}
+
+bool uptane_verify_firmware_resume(void) {
+  const uptane_transfer_checkpoint_t *checkpoint = uptane_firmware_checkpoint();
+
+  if (!checkpoint || !uptane_verify_firmware_init()) {
+    return false;
+  }
+  crypto_hash_restore(&hash_context, &checkpoint->image_hash);
+  image_fed = checkpoint->image_fed;
+  image_crc = checkpoint->image_crc;
+  return true;
+}
+
+bool uptane_verify_installed_image(const uint8_t *image) {
+  const uptane_installation_state_t *state = state_get_installation_state();
+
+  if (!state || state->firmware_name[0] == '\0') {
+    return true;
+  }
+  uint32_t crc = uptane_crc32(0, image, state->firmware_length);
+  if (crc == state->image_crc) {
+    return true;
+  }
+
+  DEBUG_PRINTF("CRC-32 of the installed image does not match, checking its hash\n");
+  crypto_hash_t computed_hash;
+  crypto_hash_init(&hash_context, state->firmware_hash.alg);
+  crypto_hash_feed(&hash_context, image, state->firmware_length);
+  crypto_hash_result(&hash_context, &computed_hash);
+  if (memcmp(computed_hash.hash, state->firmware_hash.hash, crypto_get_hashlen(state->firmware_hash.alg))) {
+    return false;
+  }
+
+  // the image is fine, it was confirmed without the CRC-32 of it
+  uptane_installation_state_t new_state = *state;
+  new_state.image_crc = crc;
+  state_set_installation_state(&new_state);
+  return true;
+}
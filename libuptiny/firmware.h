@@ -4,17 +4,40 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include "state_api.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 bool uptane_verify_firmware_init(void);
-void uptane_verify_firmware_feed(const uint8_t* data, size_t len);
+/* Data may still be hashed in the background when this returns, it must stay untouched until
+ * uptane_verify_firmware_busy returns false. False if the image gets longer than the target, this and all further
+ * data is refused then and the attack is recorded. */
+bool uptane_verify_firmware_feed(const uint8_t* data, size_t len);
+/* Bytes of the image fed so far and the length of the target */
+void uptane_verify_firmware_progress(uint32_t* received, uint32_t* expected);
+bool uptane_verify_firmware_busy(void);
 bool uptane_verify_firmware_finalize(void);
 void uptane_firmware_confirm(void);
 
+/* Checkpoints the transfer of the image after offset bytes of it in chunks were fed. A checkpoint is removed when the
+ * image is confirmed. */
+void uptane_verify_firmware_checkpoint(uint32_t offset, uint32_t chunks);
+/* The latest checkpoint of a transfer of the current target, NULL if there is none */
+const uptane_transfer_checkpoint_t* uptane_firmware_checkpoint(void);
+/* Like uptane_verify_firmware_init, with the hash carried on from uptane_firmware_checkpoint(). False if there is no
+ * checkpoint. */
+bool uptane_verify_firmware_resume(void);
+
 bool uptane_firmware_updated(void);
 
+/* Checks the installed image at boot, image points to its firmware_length bytes. The CRC-32 stored when it was
+ * confirmed is compared first, the full hash is only computed if that differs and the CRC-32 is refreshed if the hash
+ * matches. The CRC-32 is against corruption of the flash, the image was authenticated before it was confirmed. True if
+ * the image is intact or nothing is installed.
+ */
+bool uptane_verify_installed_image(const uint8_t* image);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,10 +1,78 @@
 #include "jsmn.h"
 
+#ifdef JSMN_SIMD
+#include "jsmn_simd.h"
+#endif
+
+#ifdef __GNUC__
+/**
+ * Strings and primitives are scanned four aligned bytes at a time for the
+ * bytes that end them, so that the long hashes and key IDs don't go
+ * through the checks of every character. The tests are the usual SWAR
+ * ones: each is nonzero if a byte of the word matches, and may also flag
+ * the bytes above the first match, which only ends the bulk scan early.
+ */
+typedef uint32_t __attribute__((__may_alias__)) jsmn_word_t;
+
+#define JSMN_ONES 0x01010101u
+#define JSMN_HIGHS 0x80808080u
+#define JSMN_HAS_ZERO(w) (((w) - JSMN_ONES) & ~(w) & JSMN_HIGHS)
+#define JSMN_HAS_BYTE(w, c) JSMN_HAS_ZERO((w) ^ (JSMN_ONES * (uint8_t)(c)))
+/* a byte below n, for n up to 128 */
+#define JSMN_HAS_LESS(w, n) (((w) - JSMN_ONES * (n)) & ~(w) & JSMN_HIGHS)
+/* a byte above n, for n up to 127 */
+#define JSMN_HAS_MORE(w, n) ((((w) + JSMN_ONES * (127 - (n))) | (w)) & JSMN_HIGHS)
+
+/**
+ * Skips the words of a string from pos on without a quote, backslash or
+ * NUL. Returns pos if it isn't aligned, the bytes up to the next aligned
+ * word go through the per-character path.
+ */
+static inline jsmnint_t jsmn_scan_string(const char *js, jsmnint_t pos,
+		jsmnint_t len) {
+#ifdef JSMN_SIMD
+	pos = jsmn_simd_scan_string(js, pos, len);
+#endif
+	while (pos + 4 < len && ((uintptr_t) (js + pos) & 3) == 0) {
+		jsmn_word_t w = *(const jsmn_word_t *) (js + pos);
+		if (JSMN_HAS_ZERO(w) | JSMN_HAS_BYTE(w, '\"') | JSMN_HAS_BYTE(w, '\\')) {
+			break;
+		}
+		pos += 4;
+	}
+	return pos;
+}
+
+/**
+ * Skips the words of a primitive from pos on without a byte that ends it
+ * or is invalid in it.
+ */
+static inline jsmnint_t jsmn_scan_primitive(const char *js, jsmnint_t pos,
+		jsmnint_t len) {
+	while (pos + 4 < len && ((uintptr_t) (js + pos) & 3) == 0) {
+		jsmn_word_t w = *(const jsmn_word_t *) (js + pos);
+		if (JSMN_HAS_LESS(w, 0x21) | JSMN_HAS_MORE(w, 0x7e) | JSMN_HAS_BYTE(w, ',') |
+				JSMN_HAS_BYTE(w, ']') | JSMN_HAS_BYTE(w, '}')
+#ifndef JSMN_STRICT
+				| JSMN_HAS_BYTE(w, ':')
+#endif
+				) {
+			break;
+		}
+		pos += 4;
+	}
+	return pos;
+}
+#else
+#define jsmn_scan_string(js, pos, len) (pos)
+#define jsmn_scan_primitive(js, pos, len) (pos)
+#endif
+
 /**
  * Allocates a fresh unused token from the token pull.
  */
 static jsmntok_t *jsmn_alloc_token(jsmn_parser *parser,
-		jsmntok_t *tokens, int16_t num_tokens) {
+		jsmntok_t *tokens, jsmnint_t num_tokens) {
 	jsmntok_t *tok;
 	if (parser->toknext >= num_tokens) {
 		return NULL;
@@ -12,6 +80,7 @@ static jsmntok_t *jsmn_alloc_token(jsmn_parser *parser,
 	tok = &tokens[parser->toknext++];
 	tok->start = tok->end = -1;
 	tok->size = 0;
+	tok->next = -1;
 #ifdef JSMN_PARENT_LINKS
 	tok->parent = -1;
 #endif
@@ -22,7 +91,7 @@ static jsmntok_t *jsmn_alloc_token(jsmn_parser *parser,
  * Fills token type and boundaries.
  */
 static void jsmn_fill_token(jsmntok_t *token, jsmntype_t type,
-                            int16_t start, int16_t end) {
+                            jsmnint_t start, jsmnint_t end) {
 	token->type = type;
 	token->start = start;
 	token->end = end;
@@ -33,13 +102,15 @@ static void jsmn_fill_token(jsmntok_t *token, jsmntype_t type,
  * Fills next available token with JSON primitive.
  */
 static int jsmn_parse_primitive(jsmn_parser *parser, const char *js,
-		int16_t len, jsmntok_t *tokens, int16_t num_tokens) {
+		jsmnint_t len, jsmntok_t *tokens, jsmnint_t num_tokens) {
 	jsmntok_t *token;
-	int16_t start;
+	jsmnint_t start;
 
 	start = parser->pos;
 
-	for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
+	for (parser->pos = jsmn_scan_primitive(js, start, len);
+			parser->pos < len && js[parser->pos] != '\0';
+			parser->pos = jsmn_scan_primitive(js, (jsmnint_t) (parser->pos + 1), len)) {
 		switch (js[parser->pos]) {
 #ifndef JSMN_STRICT
 			/* In strict mode primitive must be followed by "," or "}" or "]" */
@@ -79,35 +150,44 @@ found:
 }
 
 /**
- * Fills next token with JSON string.
+ * Fills next token with the JSON string from start to the closing quote at
+ * parser->pos.
  */
-static int jsmn_parse_string(jsmn_parser *parser, const char *js,
-		int16_t len, jsmntok_t *tokens, int16_t num_tokens) {
+static int jsmn_close_string(jsmn_parser *parser, jsmntok_t *tokens,
+		jsmnint_t num_tokens, jsmnint_t start) {
 	jsmntok_t *token;
 
-	int16_t start = parser->pos;
+	if (tokens == NULL) {
+		return 0;
+	}
+	token = jsmn_alloc_token(parser, tokens, num_tokens);
+	if (token == NULL) {
+		parser->pos = start;
+		return JSMN_ERROR_NOMEM;
+	}
+	jsmn_fill_token(token, JSMN_STRING, (jsmnint_t) (start+1), parser->pos);
+#ifdef JSMN_PARENT_LINKS
+	token->parent = parser->toksuper;
+#endif
+	return 0;
+}
 
-	parser->pos++;
+/**
+ * Fills next token with JSON string.
+ */
+static int jsmn_parse_string(jsmn_parser *parser, const char *js,
+		jsmnint_t len, jsmntok_t *tokens, jsmnint_t num_tokens) {
+	jsmnint_t start = parser->pos;
 
 	/* Skip starting quote */
-	for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
+	for (parser->pos = jsmn_scan_string(js, (jsmnint_t) (start + 1), len);
+			parser->pos < len && js[parser->pos] != '\0';
+			parser->pos = jsmn_scan_string(js, (jsmnint_t) (parser->pos + 1), len)) {
 		char c = js[parser->pos];
 
 		/* Quote: end of string */
 		if (c == '\"') {
-			if (tokens == NULL) {
-				return 0;
-			}
-			token = jsmn_alloc_token(parser, tokens, num_tokens);
-			if (token == NULL) {
-				parser->pos = start;
-				return JSMN_ERROR_NOMEM;
-			}
-			jsmn_fill_token(token, JSMN_STRING, (int16_t) (start+1), parser->pos);
-#ifdef JSMN_PARENT_LINKS
-			token->parent = parser->toksuper;
-#endif
-			return 0;
+			return jsmn_close_string(parser, tokens, num_tokens, start);
 		}
 
 		/* Backslash: Quoted symbol expected */
@@ -148,17 +228,31 @@ static int jsmn_parse_string(jsmn_parser *parser, const char *js,
 /**
  * Parse JSON string and fill tokens.
  */
-int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
-		jsmntok_t *tokens, int16_t num_tokens) {
+int jsmn_parse(jsmn_parser *parser, const char *js, jsmnint_t len,
+		jsmntok_t *tokens, jsmnint_t num_tokens) {
 	int r;
 	int i;
 	jsmntok_t *token;
 	int count = parser->toknext;
+#ifdef JSMN_SIMD
+	jsmn_index_t index;
+	jsmnint_t start;
+	jsmnint_t end;
+
+	/* only the bytes of the structural index, whitespace and the inside of strings are skipped */
+	for (parser->pos = jsmn_index_begin(&index, js, len, parser->pos);
+			parser->pos < len && js[parser->pos] != '\0';
+			parser->pos = jsmn_index_next(&index, js, len, start, parser->pos)) {
+		char c;
+		jsmntype_t type;
 
+		start = parser->pos;
+#else
 	for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
 		char c;
 		jsmntype_t type;
 
+#endif
 		c = js[parser->pos];
 		switch (c) {
 			case '{': case '[':
@@ -177,7 +271,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
 				}
 				token->type = (c == '{' ? JSMN_OBJECT : JSMN_ARRAY);
 				token->start = parser->pos;
-				parser->toksuper = (int16_t) (parser->toknext - 1);
+				parser->toksuper = (jsmnint_t) (parser->toknext - 1);
 				break;
 			case '}': case ']':
 				if (tokens == NULL)
@@ -193,7 +287,8 @@ int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
 						if (token->type != type) {
 							return JSMN_ERROR_INVAL;
 						}
-						token->end = (int16_t) (parser->pos + 1);
+						token->end = (jsmnint_t) (parser->pos + 1);
+						token->next = parser->toknext;
 						parser->toksuper = token->parent;
 						break;
 					}
@@ -214,6 +309,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
 						}
 						parser->toksuper = -1;
 						token->end = parser->pos + 1;
+						token->next = parser->toknext;
 						break;
 					}
 				}
@@ -229,6 +325,15 @@ int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
 #endif
 				break;
 			case '\"':
+#ifdef JSMN_SIMD
+				/* the closing quote of a string without escapes is in the index */
+				end = jsmn_index_string_end(&index, js, len, start);
+				if (end >= 0) {
+					parser->pos = end;
+					r = jsmn_close_string(parser, tokens, num_tokens, start);
+					start = end;
+				} else
+#endif
 				r = jsmn_parse_string(parser, js, len, tokens, num_tokens);
 				if (r < 0) return r;
 				count++;
@@ -238,7 +343,7 @@ int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
 			case '\t' : case '\r' : case '\n' : case ' ':
 				break;
 			case ':':
-				parser->toksuper = (int16_t) (parser->toknext - 1);
+				parser->toksuper = (jsmnint_t) (parser->toknext - 1);
 				break;
 			case ',':
 				if (tokens != NULL && parser->toksuper != -1 &&
@@ -310,5 +415,54 @@ void jsmn_init(jsmn_parser *parser) {
 	parser->pos = 0;
 	parser->toknext = 0;
 	parser->toksuper = -1;
+	parser->skipdepth = 0;
+	parser->skipstate = JSMN_SKIP_PLAIN;
+}
+
+void jsmn_skip_init(jsmn_parser *parser) {
+	parser->skipdepth = 1;
+	parser->skipstate = JSMN_SKIP_PLAIN;
+}
+
+int jsmn_skip(jsmn_parser *parser, const char *js, jsmnint_t len) {
+#ifdef JSMN_SIMD
+	if (jsmn_simd_skip(parser, js, len) == 0) {
+		return 0;
+	}
+#endif
+	for (; parser->pos < len && js[parser->pos] != '\0'; parser->pos++) {
+		char c = js[parser->pos];
+
+		if (parser->skipstate == JSMN_SKIP_ESCAPE) {
+			parser->skipstate = JSMN_SKIP_STRING;
+			continue;
+		}
+		if (parser->skipstate == JSMN_SKIP_STRING) {
+			if (c == '\\') {
+				parser->skipstate = JSMN_SKIP_ESCAPE;
+			} else if (c == '\"') {
+				parser->skipstate = JSMN_SKIP_PLAIN;
+			} else {
+				parser->pos = (jsmnint_t) (jsmn_scan_string(js, (jsmnint_t) (parser->pos + 1), len) - 1);
+			}
+			continue;
+		}
+
+		switch (c) {
+			case '\"':
+				parser->skipstate = JSMN_SKIP_STRING;
+				break;
+			case '{': case '[':
+				parser->skipdepth++;
+				break;
+			case '}': case ']':
+				if (--parser->skipdepth == 0) {
+					parser->pos++;
+					return 0;
+				}
+				break;
+		}
+	}
+	return JSMN_ERROR_PART;
 }
 
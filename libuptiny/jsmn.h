@@ -8,6 +8,17 @@
 extern "C" {
 #endif
 
+/**
+ * Type of offsets into the JSON data and of token indices. Buffers are
+ * limited to 32 KB by default, UPTINY_LARGE_OFFSETS widens it for hosts
+ * that parse big metadata in one go.
+ */
+#ifdef UPTINY_LARGE_OFFSETS
+typedef int32_t jsmnint_t;
+#else
+typedef int16_t jsmnint_t;
+#endif
+
 /**
  * JSON type identifier. Basic types are:
  * 	o Object
@@ -37,25 +48,37 @@ enum jsmnerr {
  * type		type (object, array, string etc.)
  * start	start position in JSON data string
  * end		end position in JSON data string
+ * next		for an object or array, index of the token after its last
+ * 		descendant; set when it is closed, -1 before
  */
 typedef struct {
 	jsmntype_t type;
-	int16_t start;
-	int16_t end;
-	int16_t size;
+	jsmnint_t start;
+	jsmnint_t end;
+	jsmnint_t size;
 #ifdef JSMN_PARENT_LINKS
-	int16_t parent;
+	jsmnint_t parent;
 #endif
+	jsmnint_t next;
 } jsmntok_t;
 
+/* String state of jsmn_skip(), in jsmn_parser.skipstate */
+enum {
+	JSMN_SKIP_PLAIN = 0,
+	JSMN_SKIP_STRING = 1,
+	JSMN_SKIP_ESCAPE = 2
+};
+
 /**
  * JSON parser. Contains an array of token blocks available. Also stores
  * the string being parsed now and current position in that string
  */
 typedef struct {
-	int16_t pos; /* offset in the JSON string */
-	int16_t toknext; /* next token to allocate */
-	int16_t toksuper; /* superior token node, e.g parent object or array */
+	jsmnint_t pos; /* offset in the JSON string */
+	jsmnint_t toknext; /* next token to allocate */
+	jsmnint_t toksuper; /* superior token node, e.g parent object or array */
+	jsmnint_t skipdepth; /* bracket depth left to skip, 0 when not skipping */
+	uint8_t skipstate; /* string state of the skipped data */
 } jsmn_parser;
 
 /**
@@ -67,8 +90,19 @@ void jsmn_init(jsmn_parser *parser);
  * Run JSON parser. It parses a JSON data string into and array of tokens, each describing
  * a single JSON object.
  */
-int jsmn_parse(jsmn_parser *parser, const char *js, int16_t len,
-		jsmntok_t *tokens, int16_t num_tokens);
+int jsmn_parse(jsmn_parser *parser, const char *js, jsmnint_t len,
+		jsmntok_t *tokens, jsmnint_t num_tokens);
+
+/**
+ * Skip the rest of an object or array without allocating tokens. Call
+ * jsmn_skip_init() with parser->pos right after the opening bracket, then
+ * jsmn_skip() until it returns 0, at which point parser->pos is right after
+ * the matching closing bracket. JSMN_ERROR_PART means the data ran out; the
+ * bracket depth and string state are kept in the parser, so the next call
+ * picks up at the start of the next part. Skipped data is not validated.
+ */
+void jsmn_skip_init(jsmn_parser *parser);
+int jsmn_skip(jsmn_parser *parser, const char *js, jsmnint_t len);
 
 #ifdef __cplusplus
 }
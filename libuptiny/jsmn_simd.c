@@ -0,0 +1,294 @@
+#ifdef JSMN_SIMD
+
+#include <string.h>
+
+#include "jsmn_simd.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define JSMN_BLOCK_SIZE 64
+
+static const char jsmn_quote[1] = {'\"'};
+static const char jsmn_backslash[1] = {'\\'};
+static const char jsmn_nul[1] = {'\0'};
+static const char jsmn_space[4] = {' ', '\t', '\r', '\n'};
+static const char jsmn_string_ends[3] = {'\"', '\\', '\0'};
+static const char jsmn_breaks[2] = {'\\', '\0'};
+static const char jsmn_opening[2] = {'{', '['};
+static const char jsmn_closing[2] = {'}', ']'};
+
+/* 64 bytes of data, in the registers of the instruction set */
+typedef struct {
+#if defined(__AVX2__)
+	__m256i v[2];
+#elif defined(__SSE2__)
+	__m128i v[4];
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	uint8x16_t v[4];
+#else
+	uint8_t v[JSMN_BLOCK_SIZE];
+#endif
+} jsmn_block_t;
+
+static inline void jsmn_block_load(jsmn_block_t *b, const char *p) {
+#if defined(__AVX2__)
+	b->v[0] = _mm256_loadu_si256((const __m256i *) p);
+	b->v[1] = _mm256_loadu_si256((const __m256i *) (p + 32));
+#elif defined(__SSE2__)
+	int i;
+	for (i = 0; i < 4; i++) {
+		b->v[i] = _mm_loadu_si128((const __m128i *) (p + 16 * i));
+	}
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	int i;
+	for (i = 0; i < 4; i++) {
+		b->v[i] = vld1q_u8((const uint8_t *) p + 16 * i);
+	}
+#else
+	memcpy(b->v, p, JSMN_BLOCK_SIZE);
+#endif
+}
+
+/**
+ * Mask of the bytes of the block equal to one of the n characters of set.
+ */
+static inline uint64_t jsmn_block_match(const jsmn_block_t *b, const char *set, int n) {
+#if defined(__AVX2__)
+	__m256i m0 = _mm256_setzero_si256();
+	__m256i m1 = _mm256_setzero_si256();
+	int k;
+	for (k = 0; k < n; k++) {
+		__m256i c = _mm256_set1_epi8(set[k]);
+		m0 = _mm256_or_si256(m0, _mm256_cmpeq_epi8(b->v[0], c));
+		m1 = _mm256_or_si256(m1, _mm256_cmpeq_epi8(b->v[1], c));
+	}
+	return (uint64_t) (uint32_t) _mm256_movemask_epi8(m0) |
+			((uint64_t) (uint32_t) _mm256_movemask_epi8(m1) << 32);
+#elif defined(__SSE2__)
+	uint64_t mask = 0;
+	int i;
+	int k;
+	for (i = 0; i < 4; i++) {
+		__m128i m = _mm_setzero_si128();
+		for (k = 0; k < n; k++) {
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(b->v[i], _mm_set1_epi8(set[k])));
+		}
+		mask |= (uint64_t) (uint16_t) _mm_movemask_epi8(m) << (16 * i);
+	}
+	return mask;
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+	static const uint8_t weights[16] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+			0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
+	const uint8x16_t bits = vld1q_u8(weights);
+	uint8x16_t m[4];
+	uint8x16_t sum;
+	int i;
+	int k;
+	for (i = 0; i < 4; i++) {
+		m[i] = vdupq_n_u8(0);
+		for (k = 0; k < n; k++) {
+			m[i] = vorrq_u8(m[i], vceqq_u8(b->v[i], vdupq_n_u8((uint8_t) set[k])));
+		}
+		m[i] = vandq_u8(m[i], bits);
+	}
+	/* adding up pairs four times leaves the 8 bytes of the mask */
+	sum = vpaddq_u8(vpaddq_u8(m[0], m[1]), vpaddq_u8(m[2], m[3]));
+	sum = vpaddq_u8(sum, sum);
+	return vgetq_lane_u64(vreinterpretq_u64_u8(sum), 0);
+#else
+	uint64_t mask = 0;
+	int i;
+	int k;
+	for (i = 0; i < JSMN_BLOCK_SIZE; i++) {
+		for (k = 0; k < n; k++) {
+			if (b->v[i] == (uint8_t) set[k]) {
+				mask |= 1ULL << i;
+			}
+		}
+	}
+	return mask;
+#endif
+}
+
+/* bit i is the parity of the bits up to i, so inside a string after its opening quote */
+static inline uint64_t jsmn_prefix_xor(uint64_t x) {
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+static void jsmn_index_load(jsmn_index_t *index, const char *js, jsmnint_t len,
+		jsmnint_t pos, int in_string) {
+	jsmn_block_t b;
+	uint64_t space;
+	uint64_t strings;
+
+	index->base = pos;
+	if (pos >= len) {
+		index->events = 0;
+		index->quotes = 0;
+		index->breaks = 0;
+		return;
+	}
+	if (len - pos >= JSMN_BLOCK_SIZE) {
+		jsmn_block_load(&b, js + pos);
+	} else {
+		/* the tail, padded with whitespace */
+		char tail[JSMN_BLOCK_SIZE];
+		memset(tail, ' ', sizeof(tail));
+		memcpy(tail, js + pos, (size_t) (len - pos));
+		jsmn_block_load(&b, tail);
+	}
+
+	index->quotes = jsmn_block_match(&b, jsmn_quote, 1);
+	index->breaks = jsmn_block_match(&b, jsmn_breaks, 2);
+	space = jsmn_block_match(&b, jsmn_space, 4);
+	strings = jsmn_prefix_xor(index->quotes);
+	if (in_string) {
+		strings = ~strings;
+	}
+	index->in_string = (int) (strings >> 63);
+	/* 1 inside of strings and at closing quotes, 0 at opening ones */
+	strings ^= index->quotes;
+	index->events = ~space & ~strings;
+}
+
+jsmnint_t jsmn_index_begin(jsmn_index_t *index, const char *js, jsmnint_t len,
+		jsmnint_t pos) {
+	jsmn_index_load(index, js, len, pos, 0);
+	return jsmn_index_seek(index, js, len);
+}
+
+jsmnint_t jsmn_index_seek(jsmn_index_t *index, const char *js, jsmnint_t len) {
+	while (index->events == 0) {
+		if (len - index->base <= JSMN_BLOCK_SIZE) {
+			return len;
+		}
+		jsmn_index_load(index, js, len, (jsmnint_t) (index->base + JSMN_BLOCK_SIZE), index->in_string);
+	}
+	return (jsmnint_t) (index->base + __builtin_ctzll(index->events));
+}
+
+jsmnint_t jsmn_index_string_end(jsmn_index_t *index, const char *js,
+		jsmnint_t len, jsmnint_t start) {
+	uint64_t after = ~((2ULL << (start - index->base)) - 1);
+	uint64_t quote;
+
+	for (;;) {
+		quote = index->quotes & after;
+		if (quote != 0) {
+			quote &= -quote;
+			return (index->breaks & after & (quote - 1)) ? -1 :
+					(jsmnint_t) (index->base + __builtin_ctzll(quote));
+		}
+		if ((index->breaks & after) != 0 || len - index->base <= JSMN_BLOCK_SIZE) {
+			return -1;
+		}
+		jsmn_index_load(index, js, len, (jsmnint_t) (index->base + JSMN_BLOCK_SIZE), 1);
+		after = ~0ULL;
+	}
+}
+
+jsmnint_t jsmn_simd_scan_string(const char *js, jsmnint_t pos, jsmnint_t len) {
+	jsmn_block_t b;
+	uint64_t mask;
+
+	while (len - pos >= JSMN_BLOCK_SIZE) {
+		jsmn_block_load(&b, js + pos);
+		mask = jsmn_block_match(&b, jsmn_string_ends, 3);
+		if (mask != 0) {
+			return (jsmnint_t) (pos + __builtin_ctzll(mask));
+		}
+		pos = (jsmnint_t) (pos + JSMN_BLOCK_SIZE);
+	}
+	return pos;
+}
+
+/**
+ * Bits of the characters escaped by backslashes, from simdjson. *carry is
+ * set if the backslashes at the end of the block escape the first byte of
+ * the next one.
+ */
+static inline uint64_t jsmn_find_escaped(uint64_t backslash, int *carry) {
+	const uint64_t even_bits = 0x5555555555555555ULL;
+	uint64_t follows_escape = backslash << 1;
+	uint64_t odd_starts = backslash & ~even_bits & ~follows_escape;
+	uint64_t even_starts = odd_starts + backslash;
+
+	*carry = (even_starts < backslash);
+	return (even_bits ^ (even_starts << 1)) & follows_escape;
+}
+
+int jsmn_simd_skip(jsmn_parser *parser, const char *js, jsmnint_t len) {
+	jsmn_block_t b;
+	uint64_t backslash;
+	uint64_t escaped;
+	uint64_t strings;
+	uint64_t opening;
+	uint64_t closing;
+	uint64_t brackets;
+	int carry;
+
+	while (len - parser->pos >= JSMN_BLOCK_SIZE) {
+		if (parser->skipstate == JSMN_SKIP_ESCAPE) {
+			if (js[parser->pos] == '\0') {
+				return 1;
+			}
+			parser->skipstate = JSMN_SKIP_STRING;
+			parser->pos++;
+			continue;
+		}
+		jsmn_block_load(&b, js + parser->pos);
+		if (jsmn_block_match(&b, jsmn_nul, 1) != 0) {
+			return 1; /* NUL ends the data */
+		}
+		backslash = jsmn_block_match(&b, jsmn_backslash, 1);
+		escaped = jsmn_find_escaped(backslash, &carry);
+		strings = jsmn_prefix_xor(jsmn_block_match(&b, jsmn_quote, 1) & ~escaped);
+		if (parser->skipstate == JSMN_SKIP_STRING) {
+			strings = ~strings;
+		}
+		/* jsmn_skip() takes a backslash outside of strings as it is */
+		if ((backslash & ~strings) != 0) {
+			return 1;
+		}
+		opening = jsmn_block_match(&b, jsmn_opening, 2) & ~strings;
+		closing = jsmn_block_match(&b, jsmn_closing, 2) & ~strings;
+
+		if (__builtin_popcountll(closing) >= parser->skipdepth) {
+			for (brackets = opening | closing; brackets != 0; brackets &= brackets - 1) {
+				int bit = __builtin_ctzll(brackets);
+				if (opening & (1ULL << bit)) {
+					parser->skipdepth++;
+				} else if (--parser->skipdepth == 0) {
+					parser->pos = (jsmnint_t) (parser->pos + bit + 1);
+					parser->skipstate = JSMN_SKIP_PLAIN;
+					return 0;
+				}
+			}
+		} else {
+			parser->skipdepth = (jsmnint_t) (parser->skipdepth + __builtin_popcountll(opening) -
+					__builtin_popcountll(closing));
+		}
+
+		parser->pos = (jsmnint_t) (parser->pos + JSMN_BLOCK_SIZE);
+		if (carry) {
+			parser->skipstate = JSMN_SKIP_ESCAPE;
+		} else {
+			parser->skipstate = (strings >> 63) ? JSMN_SKIP_STRING : JSMN_SKIP_PLAIN;
+		}
+	}
+	return 1;
+}
+
+#endif /* JSMN_SIMD */
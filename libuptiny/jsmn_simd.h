@@ -0,0 +1,96 @@
+#ifndef __JSMN_SIMD_H_
+#define __JSMN_SIMD_H_
+
+#include "jsmn.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Structural index of JSON data for host builds (JSMN_SIMD), after the
+ * first stage of simdjson. Blocks of 64 bytes are classified with SSE2,
+ * AVX2 or NEON into bit masks of quotes, backslashes and whitespace, the
+ * strings are found with a prefix XOR of the quotes carried from block to
+ * block. jsmn_parse() goes from one byte of the index to the next instead
+ * of looking at every byte, takes the end of a string without escapes from
+ * the index, and produces the same tokens.
+ *
+ * The index starts at a position outside of any string, which is where
+ * jsmn_parse() is between tokens. The quotes are taken as they come,
+ * without escapes: a token that ends elsewhere than the index expects,
+ * like a string with an escaped quote or a primitive with a quote in it,
+ * has the index started again after it.
+ */
+typedef struct {
+	jsmnint_t base; /* offset of the block */
+	uint64_t events; /* bytes jsmn_parse() has to look at: all but whitespace and the inside and closing quote of strings */
+	uint64_t quotes;
+	uint64_t breaks; /* backslashes and NULs, which need the per-character path of strings */
+	int in_string; /* at the end of the block */
+} jsmn_index_t;
+
+/**
+ * Starts the index at pos and returns the offset of the first byte to look
+ * at, len if there is none.
+ */
+jsmnint_t jsmn_index_begin(jsmn_index_t *index, const char *js, jsmnint_t len,
+		jsmnint_t pos);
+
+/**
+ * Offset of the first byte to look at from the block on, len if there is
+ * none.
+ */
+jsmnint_t jsmn_index_seek(jsmn_index_t *index, const char *js, jsmnint_t len);
+
+/**
+ * Offset of the closing quote of the string that starts at start, -1 if
+ * there is a backslash or NUL before it or the data ends.
+ */
+jsmnint_t jsmn_index_string_end(jsmn_index_t *index, const char *js,
+		jsmnint_t len, jsmnint_t start);
+
+/**
+ * Offset of the next byte to look at after the token from start to pos.
+ * After a string taken from the index start is its closing quote.
+ */
+static inline jsmnint_t jsmn_index_next(jsmn_index_t *index, const char *js,
+		jsmnint_t len, jsmnint_t start, jsmnint_t pos) {
+	unsigned int off = (unsigned int) (pos - index->base);
+	uint64_t upto;
+	uint64_t taken;
+
+	/* also after the index was moved on looking for the end of a string with escapes */
+	if (off >= 63 || start < index->base) {
+		return jsmn_index_begin(index, js, len, (jsmnint_t) (pos + 1));
+	}
+	upto = (2ULL << off) - 1;
+	/* the quotes of the token other than its opening one */
+	taken = index->quotes & upto & ~((2ULL << (start - index->base)) - 1);
+	if (taken != ((js[start] == '\"' && start != pos) ? (1ULL << off) : 0)) {
+		return jsmn_index_begin(index, js, len, (jsmnint_t) (pos + 1));
+	}
+	index->events &= ~upto;
+	if (index->events == 0) {
+		return jsmn_index_seek(index, js, len);
+	}
+	return (jsmnint_t) (index->base + __builtin_ctzll(index->events));
+}
+
+/**
+ * Offset of the first quote, backslash or NUL from pos on, or of the last
+ * block of less than 64 bytes before len.
+ */
+jsmnint_t jsmn_simd_scan_string(const char *js, jsmnint_t pos, jsmnint_t len);
+
+/**
+ * jsmn_skip() over whole blocks. Returns 0 once the closing bracket is
+ * found, 1 to go on byte by byte from parser->pos.
+ */
+int jsmn_simd_skip(jsmn_parser *parser, const char *js, jsmnint_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __JSMN_SIMD_H_ */
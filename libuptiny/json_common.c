@@ -1,26 +1,27 @@
 #include "json_common.h"
 #include "jsmn.h"
 
-extern jsmntok_t token_pool[];
-extern const int16_t token_pool_size;
+jsmnint_t json_consume_recursive(const jsmntok_t* tokens, jsmnint_t num_tokens, jsmnint_t idx) {
+  if (tokens[idx].type != JSMN_OBJECT && tokens[idx].type != JSMN_ARRAY) {
+    return (jsmnint_t)(idx + 1);
+  }
 
-int16_t consume_recursive_json(int16_t idx) {
-  if (token_pool[idx].type != JSMN_OBJECT && token_pool[idx].type != JSMN_ARRAY) {
-    return (int16_t)(idx + 1);
+  // closed containers know where their subtree ends
+  if (tokens[idx].next >= 0) {
+    return tokens[idx].next;
   }
 
-  int end = token_pool[idx].end;
-  int16_t i;
+  int end = tokens[idx].end;
+  jsmnint_t i;
 
-  for (i = (int16_t)(idx + 1); i < token_pool_size; ++i) {
-    if (token_pool[i].start >= end) {
+  for (i = (jsmnint_t)(idx + 1); i < num_tokens; ++i) {
+    if (tokens[i].start >= end) {
       break;
     }
   }
   return i;
 }
 
-bool json_str_equal(const char* json, int16_t idx, const char* value) {
-  return ((long unsigned int)JSON_TOK_LEN(token_pool[idx]) == strlen(value) &&
-          strncmp(value, (json) + (token_pool[idx]).start, strlen(value)) == 0);
+bool json_str_equal(const char* json, jsmnint_t idx, const char* value) {
+  return json_strn_equal(json, idx, value, strlen(value));
 }
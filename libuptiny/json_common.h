@@ -4,18 +4,45 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include "jsmn.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// consumes a token in token_pool indexed by idx recursively, returns index immediately after the consumed token
-int16_t consume_recursive_json(int16_t idx);
+extern jsmntok_t token_pool[];
+extern const jsmnint_t token_pool_size;
+
+// consumes a token in tokens[0, num_tokens) indexed by idx recursively, returns index immediately after the consumed
+// token
+jsmnint_t json_consume_recursive(const jsmntok_t* tokens, jsmnint_t num_tokens, jsmnint_t idx);
+
+// same in token_pool
+static inline jsmnint_t consume_recursive_json(jsmnint_t idx) {
+  return json_consume_recursive(token_pool, token_pool_size, idx);
+}
 
 // token's length
 #define JSON_TOK_LEN(token) ((token).end - (token).start)
 
-// compare token with a string literal
-bool json_str_equal(const char* json, int16_t idx, const char* value);
+// compare token of tokens with a string of known length; the length check rejects most mismatches before any memory
+// access
+static inline bool json_tokn_equal(const jsmntok_t* tokens, const char* json, jsmnint_t idx, const char* value,
+                                   size_t len) {
+  return (size_t)JSON_TOK_LEN(tokens[idx]) == len && memcmp(value, json + tokens[idx].start, len) == 0;
+}
+
+// compare token of tokens with a string literal, its length is known at compile time
+#define json_tok_lit_equal(tokens, json, idx, literal) \
+  json_tokn_equal((tokens), (json), (idx), "" literal "", sizeof(literal) - 1)
+
+// same in token_pool
+static inline bool json_strn_equal(const char* json, jsmnint_t idx, const char* value, size_t len) {
+  return json_tokn_equal(token_pool, json, idx, value, len);
+}
+#define json_lit_equal(json, idx, literal) json_strn_equal((json), (idx), "" literal "", sizeof(literal) - 1)
+
+// compare token with a NUL-terminated string
+bool json_str_equal(const char* json, jsmnint_t idx, const char* value);
 
 #ifdef __cplusplus
 }
@@ -1,10 +1,13 @@
 #include "manifest.h"
 #include "base64.h"
+#include "common_data_api.h"
 #include "crypto_api.h"
 #include "firmware.h"
 #include "state_api.h"
+#include "stats.h"
 #include "utils.h"
 
+#include <stddef.h>
 #include <string.h>
 
 static const char* attack_to_string(uptane_attack_t attack) {
@@ -40,6 +43,10 @@ static const char* hash_alg_to_string(crypto_hash_algorithm_t alg) {
   switch (alg) {
     case CRYPTO_HASH_SHA512:
       return "sha512";
+#if UPTINY_HASH_SHA256
+    case CRYPTO_HASH_SHA256:
+      return "sha256";
+#endif
     default:
       return "Unknown";
   }
@@ -54,63 +61,352 @@ static const char* crypto_alg_to_method(crypto_algorithm_t alg) {
   }
 }
 
-void uptane_write_manifest(char* signed_part, char* signatures_part) {
-  /* All strings are either literals or taken from trusted environment, use 'unsafe' functions */
+/* The manifest is written as a list of pieces, each one a string or a field rendered as it is read, so any part of it
+ * can be written to a buffer of any size. */
+typedef enum { PIECE_STR, PIECE_HEX, PIECE_DEC, PIECE_BASE64 } piece_type_t;
+
+typedef struct {
+  piece_type_t type;
+  const void* data;  // string or bytes
+  size_t len;        // of the string or of the bytes, the number for PIECE_DEC
+} piece_t;
+
+#ifdef UPTANE_STATS
+/* "diagnostics":{"name":<counter>,...} after "attacks_detected", a name and a number for every counter. The signed part
+ * is verified as canonical JSON, so the names are sorted. */
+static const struct {
+  const char* name;
+  size_t offset;
+} stats_fields[] = {
+    {",\"diagnostics\":{\"base64_decoded\":", offsetof(uptane_stats_t, base64_decoded)},
+    {",\"bytes_fed\":", offsetof(uptane_stats_t, bytes_fed)},
+    {",\"hex_decoded\":", offsetof(uptane_stats_t, hex_decoded)},
+    {",\"key_cache_hits\":", offsetof(uptane_stats_t, key_cache_hits)},
+    {",\"sha512_blocks\":", offsetof(uptane_stats_t, sha512_blocks)},
+    {",\"signatures_skipped\":", offsetof(uptane_stats_t, signatures_skipped)},
+    {",\"signatures_verified\":", offsetof(uptane_stats_t, signatures_verified)},
+    {",\"subtrees_skipped\":", offsetof(uptane_stats_t, subtrees_skipped)},
+    {",\"targets_cache_hits\":", offsetof(uptane_stats_t, targets_cache_hits)},
+    {",\"targets_inspected\":", offsetof(uptane_stats_t, targets_inspected)},
+    {",\"tokens\":", offsetof(uptane_stats_t, tokens)},
+};
+#define STATS_PIECES (2 * sizeof(stats_fields) / sizeof(stats_fields[0]) + 1)
+#else
+#define STATS_PIECES 0
+#endif
+
+/* {"signatures":<pieces PIECE_SIGNATURES to PIECE_SIGNATURES_END>,"signed":<PIECE_SIGNED to PIECE_SIGNED_END>}. The
+ * diagnostics are pieces PIECE_STATS on, the pieces after them are numbered as if there were none. */
+enum {
+  PIECE_SIGNATURES = 1,
+  PIECE_SIGNATURES_END = 8,
+  PIECE_SIGNED = 9,
+  PIECE_STATS = 12,
+  PIECE_SIGNED_END = 24 + STATS_PIECES,
+  PIECE_COUNT = PIECE_SIGNED_END + 1
+};
+
+static void piece_str(piece_t* p, const char* str) {
+  p->type = PIECE_STR;
+  p->data = str;
+  p->len = strlen(str);
+}
+
+static void piece_bin(piece_t* p, piece_type_t type, const uint8_t* data, size_t len) {
+  p->type = type;
+  p->data = data;
+  p->len = len;
+}
+
+#ifdef UPTANE_STATS
+/* piece i of the diagnostics */
+static void stats_piece(const uptane_manifest_writer_t* w, unsigned int i, piece_t* p) {
+  if (i == STATS_PIECES - 1) {
+    piece_str(p, "}");
+  } else if (i % 2 == 0) {
+    piece_str(p, stats_fields[i / 2].name);
+  } else {
+    p->type = PIECE_DEC;
+    p->data = NULL;
+    p->len = *(const uint32_t*)((const uint8_t*)&w->stats + stats_fields[i / 2].offset);
+  }
+}
+#endif
+
+static void manifest_piece(const uptane_manifest_writer_t* w, unsigned int i, piece_t* p) {
+  const uptane_installation_state_t* state = w->state;
+
+#ifdef UPTANE_STATS
+  if (i >= PIECE_STATS && i < PIECE_STATS + STATS_PIECES) {
+    stats_piece(w, i - PIECE_STATS, p);
+    return;
+  }
+#endif
+  if (i >= PIECE_STATS) {
+    i -= STATS_PIECES;
+  }
+  switch (i) {
+    case 0:
+      piece_str(p, "{\"signatures\":");
+      break;
+    case 1:
+      piece_str(p, "[{\"keyid\":\"");
+      break;
+    case 2:
+      piece_bin(p, PIECE_HEX, w->sig.key->keyid, CRYPTO_KEYID_LEN);
+      break;
+    case 3:
+      piece_str(p, "\",\"method\":\"");
+      break;
+    case 4:
+      piece_str(p, crypto_alg_to_method(w->sig.key->key_type));
+      break;
+    case 5:
+      piece_str(p, "\",\"sig\":\"");
+      break;
+    case 6:
+      piece_bin(p, PIECE_BASE64, w->sig.sig, crypto_get_siglen(w->sig.key->key_type));
+      break;
+    case 7:
+      piece_str(p, "\"}]");
+      break;
+    case 8:
+      piece_str(p, ",\"signed\":");
+      break;
+    case 9:
+      piece_str(p, "{\"attacks_detected\":\"");
+      break;
+    case 10:
+      piece_str(p, (state) ? attack_to_string(state->attack) : "");
+      break;
+    case 11:
+      piece_str(p, "\"");
+      break;
+    case 12:
+      piece_str(p, ",\"ecu_serial\":\"");
+      break;
+    case 13:
+      piece_str(p, state_get_ecuid());
+      break;
+    case 14:
+      piece_str(p, "\",\"installed_image\":{\"fileinfo\":{\"hashes\":{\"");
+      break;
+    case 15:
+      piece_str(p, (state) ? hash_alg_to_string(state->firmware_hash.alg) : "nohash");
+      break;
+    case 16:
+      piece_str(p, "\":\"");
+      break;
+    case 17:
+      piece_bin(p, PIECE_HEX, (state) ? state->firmware_hash.hash : NULL,
+                (state) ? crypto_get_hashlen(state->firmware_hash.alg) : 0);
+      break;
+    case 18:
+      piece_str(p, "\"},\"length\":");
+      break;
+    case 19:
+      p->type = PIECE_DEC;
+      p->data = NULL;
+      p->len = (state) ? state->firmware_length : 0;
+      break;
+    case 20:
+      piece_str(p, "},\"filepath\":\"");
+      break;
+    case 21:
+      piece_str(p, (state) ? state->firmware_name : "noimage");
+      break;
+    case 22:
+      piece_str(p,
+                "\"},\"previous_timeserver_time\":\"1970-01-01T00:00:00Z\",\"timeserver_time\":\"1970-01-01T00:00:00Z\"");
+      break;
+    default:  // the ends of "signed" and of the manifest
+      piece_str(p, "}");
+      break;
+  }
+}
+
+static size_t piece_length(const piece_t* p) {
+  char dec[12];
+
+  switch (p->type) {
+    case PIECE_HEX:
+      return p->len * 2;
+    case PIECE_DEC:
+      int2dec((int32_t)p->len, dec);
+      return strlen(dec);
+    case PIECE_BASE64:
+      return 4 * ((p->len + 2) / 3);
+    default:
+      return p->len;
+  }
+}
+
+/* len characters of the piece from offset on. Fields are rendered a byte, a number or a base64 group at a time. */
+static void piece_read(const piece_t* p, size_t offset, char* out, size_t len) {
+  const uint8_t* data = (const uint8_t*)p->data;
+  char tmp[12];
+
+  switch (p->type) {
+    case PIECE_HEX:
+      for (; len > 0; offset++, out++, len--) {
+        bin2hex(&data[offset / 2], 1, tmp);
+        *out = tmp[offset % 2];
+      }
+      break;
+    case PIECE_DEC:
+      int2dec((int32_t)p->len, tmp);
+      memcpy(out, &tmp[offset], len);
+      break;
+    case PIECE_BASE64:
+      for (; len > 0; offset++, out++, len--) {
+        size_t group = (offset / 4) * 3;
+        base64_encode(&data[group], (p->len - group < 3) ? p->len - group : 3, tmp);
+        *out = tmp[offset % 4];
+      }
+      break;
+    default:
+      memcpy(out, (const char*)p->data + offset, len);
+      break;
+  }
+}
+
+static size_t pieces_length(const uptane_manifest_writer_t* w, unsigned int first, unsigned int end) {
+  size_t len = 0;
+  piece_t p;
+
+  for (; first < end; first++) {
+    manifest_piece(w, first, &p);
+    len += piece_length(&p);
+  }
+  return len;
+}
+
+static void writer_seek(uptane_manifest_writer_t* w, unsigned int first, unsigned int end) {
+  w->piece = first;
+  w->end = end;
+  w->offset = 0;
+}
+
+size_t uptane_manifest_writer_init(uptane_manifest_writer_t* w) {
+  const uint8_t* priv;
+  char chunk[32];
+  size_t len;
+
+  w->state = state_get_installation_state();
+#ifdef UPTANE_STATS
+  w->stats = *uptane_stats_get();
+#endif
+  state_get_device_key(&w->sig.key, &priv);
+
+  /* The signature is over the signed part only, which is written as often as the backend needs it */
+  crypto_sign_init(&sign_context, &w->sig, priv);
+  do {
+    writer_seek(w, PIECE_SIGNED, PIECE_SIGNED_END);
+    while ((len = uptane_manifest_writer_read(w, chunk, sizeof(chunk))) > 0) {
+      crypto_sign_feed(&sign_context, (const uint8_t*)chunk, len);
+    }
+  } while (!crypto_sign_result(&sign_context));
+
+  writer_seek(w, 0, PIECE_COUNT);
+  return pieces_length(w, 0, PIECE_COUNT);
+}
+
+size_t uptane_manifest_writer_read(uptane_manifest_writer_t* w, char* buf, size_t len) {
+  size_t written = 0;
+  piece_t p;
+
+  while (written < len && w->piece < w->end) {
+    manifest_piece(w, w->piece, &p);
+    size_t left = piece_length(&p) - w->offset;
+    size_t n = (left < len - written) ? left : len - written;
+
+    piece_read(&p, w->offset, buf + written, n);
+    written += n;
+    w->offset += n;
+    if (w->offset == piece_length(&p)) {
+      w->piece++;
+      w->offset = 0;
+    }
+  }
+  return written;
+}
+
+/* The cached manifest, see uptane_manifest() */
+static char manifest[UPTANE_MANIFEST_SIZE];
+static size_t manifest_len;
+static size_t signatures_offset;
+static size_t signatures_len;
+static size_t signed_offset;
+static size_t signed_len;
+
+/* What the cached manifest was built from */
+static bool manifest_valid;
+static bool manifest_state_present;
+static uptane_installation_state_t manifest_state;
+#ifdef UPTANE_STATS
+static uptane_stats_t manifest_stats;  // the diagnostics in it
+#endif
+
+static bool manifest_current(const uptane_installation_state_t* state) {
+  if (!manifest_valid || manifest_state_present != (state != NULL)) {
+    return false;
+  }
+#ifdef UPTANE_STATS
+  if (memcmp(uptane_stats_get(), &manifest_stats, sizeof(manifest_stats)) != 0) {
+    return false;
+  }
+#endif
+  return !state || !memcmp(state, &manifest_state, sizeof(manifest_state));
+}
+
+const char* uptane_manifest(size_t* len) {
+  uptane_manifest_writer_t w;
   uptane_installation_state_t* state = state_get_installation_state();
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcpy(signed_part, "{\"attacks_detected\":\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, (state) ? attack_to_string(state->attack) : "");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\",\"ecu_serial\":\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, state_get_ecuid());
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\",\"installed_image\":{\"fileinfo\":{\"hashes\":{\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, (state) ? hash_alg_to_string(state->firmware_hash.alg) : "nohash");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\":\"");
-  if (state) {
-    bin2hex(state->firmware_hash.hash, (int)crypto_get_hashlen(state->firmware_hash.alg),
-            signed_part + strlen(signed_part));
-  }
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\"},\"length\":");
-  int2dec((state) ? (int32_t)state->firmware_length : 0, signed_part + strlen(signed_part));
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "},\"filepath\":\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, (state) ? state->firmware_name : "noimage");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\"},\"previous_timeserver_time\":\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "1970-01-01T00:00:00Z");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\",\"timeserver_time\":\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "1970-01-01T00:00:00Z");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signed_part, "\"}");
-
-  static crypto_key_and_signature_t sig;
 
+  /* the image may be reinstalled with the same metadata */
   if (uptane_firmware_updated()) {
-    const uint8_t* priv;
-    state_get_device_key(&sig.key, &priv);
-
-    crypto_sign_data(signed_part, strlen(signed_part), &sig, priv);
-  }
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcpy(signatures_part, "[{\"keyid\":\"");
-  bin2hex(sig.key->keyid, CRYPTO_KEYID_LEN, signatures_part + strlen(signatures_part));
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signatures_part, "\",\"method\":\"");
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signatures_part, crypto_alg_to_method(sig.key->key_type));
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signatures_part, "\",\"sig\":\"");
-  base64_encode(sig.sig, crypto_get_siglen(sig.key->key_type), signatures_part + strlen(signatures_part));
-  // NOLINTNEXTLINE(clang-analyzer-security.insecureAPI.strcpy)
-  strcat(signatures_part, "\"}]");
+    manifest_valid = false;
+  }
+  if (manifest_current(state)) {
+    *len = manifest_len;
+    return manifest;
+  }
+
+  manifest_valid = false;
+  manifest_len = uptane_manifest_writer_init(&w);
+  if (manifest_len >= sizeof(manifest)) {
+    return NULL;
+  }
+  uptane_manifest_writer_read(&w, manifest, manifest_len);
+  manifest[manifest_len] = 0;
+
+  signatures_offset = pieces_length(&w, 0, PIECE_SIGNATURES);
+  signatures_len = pieces_length(&w, PIECE_SIGNATURES, PIECE_SIGNATURES_END);
+  signed_offset = pieces_length(&w, 0, PIECE_SIGNED);
+  signed_len = pieces_length(&w, PIECE_SIGNED, PIECE_SIGNED_END);
+
+  manifest_state_present = (state != NULL);
+  if (state) {
+    memcpy(&manifest_state, state, sizeof(manifest_state));
+  }
+#ifdef UPTANE_STATS
+  manifest_stats = w.stats;
+#endif
+  manifest_valid = true;
+  *len = manifest_len;
+  return manifest;
+}
+
+void uptane_write_manifest(char* signed_buf, char* signatures_buf) {
+  size_t len;
+
+  if (!uptane_manifest(&len)) {
+    signed_buf[0] = 0;
+    signatures_buf[0] = 0;
+    return;
+  }
+  memcpy(signed_buf, &manifest[signed_offset], signed_len);
+  signed_buf[signed_len] = 0;
+  memcpy(signatures_buf, &manifest[signatures_offset], signatures_len);
+  signatures_buf[signatures_len] = 0;
 }
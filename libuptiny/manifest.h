@@ -1,10 +1,52 @@
 #ifndef LIBUPTINY_MANIFEST_H
 #define LIBUPTINY_MANIFEST_H
 
+#include <stddef.h>
+
+#include "crypto_api.h"
+#include "state_api.h"
+#include "stats.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Room for the manifest, a little more than 600 bytes with the ECU serial and the image name, up to 370 more with the
+ * "diagnostics" of UPTANE_STATS */
+#ifndef UPTANE_MANIFEST_SIZE
+#ifdef UPTANE_STATS
+#define UPTANE_MANIFEST_SIZE 1536
+#else
+#define UPTANE_MANIFEST_SIZE 1024
+#endif
+#endif
+
+/* Writes the manifest in pieces of any size, e.g. straight into the frames that carry it, instead of building it in
+ * one buffer. The installation state must not change until the manifest is written. */
+typedef struct {
+  crypto_key_and_signature_t sig;
+  const uptane_installation_state_t* state;
+  unsigned int piece;
+  unsigned int end;
+  size_t offset;
+#ifdef UPTANE_STATS
+  uptane_stats_t stats;  // as they were when the manifest was signed
+#endif
+} uptane_manifest_writer_t;
+
+/* Signs the manifest, feeding the signed part to the backend as it is written, and starts writing from the beginning.
+ * Returns the length of the manifest. */
+size_t uptane_manifest_writer_init(uptane_manifest_writer_t* w);
+/* Writes the next bytes of the manifest, up to len of them, without a NUL. Returns the number written, less than len
+ * at the end of the manifest. */
+size_t uptane_manifest_writer_read(uptane_manifest_writer_t* w, char* buf, size_t len);
+
+/* The manifest, {"signatures":[...],"signed":{...}} with a NUL after it. It is built and signed once and kept until
+ * the installation state or the attack flag changes or an image is confirmed, so polling it is a copy. NULL if it
+ * doesn't fit in UPTANE_MANIFEST_SIZE. With UPTANE_STATS, "signed" has the counters of stats.h as "diagnostics", and
+ * it is built again once they change. */
+const char* uptane_manifest(size_t* len);
+/* The two parts of the manifest, each one with a NUL after it */
 void uptane_write_manifest(char* signed_part, char* signatures_part);
 
 #ifdef __cplusplus
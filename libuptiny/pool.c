@@ -0,0 +1,80 @@
+#include "pool.h"
+
+/* Index of the lowest set bit of a non-zero x: the bit alone times a de Bruijn sequence has a unique top five bits */
+static unsigned int lowest_bit(uint32_t x) {
+  static const uint8_t index[32] = {0,  1,  28, 2,  29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4,  8,
+                                    31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6,  11, 5,  10, 9};
+
+  return index[((x & (0u - x)) * 0x077CB531u) >> 27];
+}
+
+void* uptane_pool_alloc(uptane_pool_t* pool) {
+  unsigned int i;
+
+  if (!pool->free) {
+    return NULL;
+  }
+  i = lowest_bit(pool->free);
+  pool->free &= ~(1u << i);
+#ifdef UPTANE_POOL_STATS
+  if (++pool->used > pool->high_water) {
+    pool->high_water = pool->used;
+  }
+#endif
+  return pool->blocks + i * pool->block_size;
+}
+
+int uptane_pool_index(const uptane_pool_t* pool, const void* block) {
+  const uint8_t* b = (const uint8_t*)block;
+  size_t offset;
+
+  if (b < pool->blocks) {
+    return -1;
+  }
+  offset = (size_t)(b - pool->blocks);
+  if (offset % pool->block_size || offset / pool->block_size >= pool->num) {
+    return -1;
+  }
+  return (int)(offset / pool->block_size);
+}
+
+void uptane_pool_free(uptane_pool_t* pool, void* block) {
+  int i = uptane_pool_index(pool, block);
+
+  if (i < 0 || (pool->free & (1u << i))) {
+    return;
+  }
+  pool->free |= 1u << i;
+#ifdef UPTANE_POOL_STATS
+  pool->used--;
+#endif
+}
+
+void uptane_pool_free_mask(uptane_pool_t* pool, uint32_t mask) {
+  mask &= UPTANE_POOL_ALL(pool->num);
+#ifdef UPTANE_POOL_STATS
+  for (uint32_t in_use = mask & ~pool->free; in_use; in_use &= in_use - 1u) {
+    pool->used--;
+  }
+#endif
+  pool->free |= mask;
+}
+
+void uptane_pool_free_all(uptane_pool_t* pool) {
+  pool->free = UPTANE_POOL_ALL(pool->num);
+#ifdef UPTANE_POOL_STATS
+  pool->used = 0;
+#endif
+}
+
+#ifdef UPTANE_POOL_STATS
+uptane_pool_peaks_t uptane_pool_peaks;
+
+void uptane_pool_reset_peaks(void) {
+  uptane_pool_peaks.tokens = 0;
+  uptane_pool_peaks.signatures = 0;
+  uptane_pool_peaks.crypto_ctxs = 0;
+  uptane_pool_peaks.keys = 0;
+  uptane_pool_peaks.tokens_parsed = 0;
+}
+#endif
@@ -0,0 +1,90 @@
+#ifndef LIBUPTINY_POOL_H_
+#define LIBUPTINY_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Pools of up to UPTANE_POOL_MAX blocks of the same size. A bit per block tells if it is free, allocation takes the
+ * lowest free one and freeing finds the bit from the address, both without a loop. With UPTANE_POOL_STATS a pool also
+ * counts the blocks in use and the most there have been, to size it.
+ */
+#define UPTANE_POOL_MAX 32
+
+typedef struct {
+  uint32_t free;  // bit i is set if block i is free
+  uint8_t* blocks;
+  size_t block_size;
+  unsigned int num;
+#ifdef UPTANE_POOL_STATS
+  unsigned int used;
+  unsigned int high_water;
+#endif
+} uptane_pool_t;
+
+#ifdef UPTANE_POOL_STATS
+#define UPTANE_POOL_STATS_INIT , 0, 0
+#else
+#define UPTANE_POOL_STATS_INIT
+#endif
+
+/* Bits of num free blocks */
+#define UPTANE_POOL_ALL(num) (((num) >= UPTANE_POOL_MAX) ? 0xFFFFFFFFu : ((1u << (num)) - 1u))
+
+/* Defines the pool name with num blocks of type in name##_blocks, e.g. UPTANE_POOL(key_pool, crypto_key_t, 16); */
+#define UPTANE_POOL(name, type, num)                         \
+  type name##_blocks[((num) <= UPTANE_POOL_MAX) ? (num) : -1]; \
+  uptane_pool_t name = {UPTANE_POOL_ALL(num), (uint8_t*)name##_blocks, sizeof(type), (num) UPTANE_POOL_STATS_INIT}
+
+/* NULL if all blocks are in use */
+void* uptane_pool_alloc(uptane_pool_t* pool);
+/* Blocks that are not from the pool are ignored */
+void uptane_pool_free(uptane_pool_t* pool, void* block);
+void uptane_pool_free_all(uptane_pool_t* pool);
+/* Frees the blocks whose bits are set in mask at once, bit i for block i. Free blocks are ignored. */
+void uptane_pool_free_mask(uptane_pool_t* pool, uint32_t mask);
+/* Index of a block of the pool, to keep data about it elsewhere. -1 if it is not from the pool. */
+int uptane_pool_index(const uptane_pool_t* pool, const void* block);
+
+/* Most entries of the arrays in common_data_api.h the parsers have used at once since the last reset, to size the
+ * arrays, and the tokens jsmn_parse() has made in all, a measure of the parsing work. Only counted with
+ * UPTANE_POOL_STATS.
+ */
+typedef struct {
+  unsigned int tokens;         // of token_pool
+  unsigned int signatures;     // of signature_pool
+  unsigned int crypto_ctxs;    // of crypto_ctx_pool
+  unsigned int keys;           // allocated with alloc_crypto_key
+  unsigned int tokens_parsed;  // not a peak: tokens made again after the parser backs up count again
+} uptane_pool_peaks_t;
+
+#ifdef UPTANE_POOL_STATS
+extern uptane_pool_peaks_t uptane_pool_peaks;
+#define UPTANE_POOL_PEAK(field, n)                     \
+  do {                                                 \
+    if ((unsigned int)(n) > uptane_pool_peaks.field) { \
+      uptane_pool_peaks.field = (unsigned int)(n);     \
+    }                                                  \
+  } while (0)
+#define UPTANE_POOL_COUNT(field, n)               \
+  do {                                            \
+    uptane_pool_peaks.field += (unsigned int)(n); \
+  } while (0)
+void uptane_pool_reset_peaks(void);
+#else
+#define UPTANE_POOL_PEAK(field, n) \
+  do {                             \
+  } while (0)
+#define UPTANE_POOL_COUNT(field, n) \
+  do {                              \
+  } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_POOL_H_
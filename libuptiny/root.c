@@ -1,118 +1,833 @@
 #include "root.h"
 #include "common_data_api.h"
 #include "crypto_api.h"
+#include "crypto_common.h"
 #include "debug.h"
 #include "jsmn.h"
 #include "json_common.h"
+#include "pool.h"
 #include "root_signed.h"
 #include "signatures.h"
+#include "stats.h"
 
-bool uptane_parse_root(const char *metadata, int16_t len, uptane_root_t *out_root) {
-  int num_signatures = 0;
-  int16_t signatures_token = 0;
-  int16_t signed_begin = 0;
-  int16_t signed_end = 0;
+#include <string.h>
 
-  uptane_root_t *old_root = state_get_root();
-  jsmn_parser parser;
+/*
+ * State variables, initialized in uptane_parse_root_init()
+ */
+typedef enum {
+  ROOT_BEGIN,          // initial state, also at the start of the second pass
+  ROOT_IN_TOP,         // pointer in the top object (above "signatures" and "signed")
+  ROOT_IN_SIGNATURES,  // pointer in the "signatures" array
+  ROOT_IN_SIGNED,      // pointer in the "signed" object
+  ROOT_IN_KEYS,        // pointer in the "signed"."keys" object
+  ROOT_IN_ROLES,       // pointer in the "signed"."roles" object
+  ROOT_IN_IGNORED,     // pointer inside ignored object/array
+  ROOT_DONE,           // both passes are over
+  ROOT_IN_ERROR        // encountered an error, sink state
+} root_state_t;
 
-  jsmn_init(&parser);
+static root_state_t state;
+static root_state_t prev_state;  // state to return to from ROOT_IN_IGNORED
+static jsmn_parser skipper;      // bracket depth of the ignored object, kept between the calls
 
-  if (jsmn_parse(&parser, metadata, len, token_pool, token_pool_size) < 0) {
-    DEBUG_PRINTF("Preliminary parsing failed\n");
-    return false;
+static bool second_pass;      // checking the signatures by the keys of the new root
+static bool signed_found;     // "signed" object has been read in the current pass
+static bool skipping_signed;  // the ignored object is "signed", skipped on the second pass
+
+static unsigned int num_signatures;  // number of signatures read in the current pass, at signature_pool + sig_base
+static unsigned int sig_base;        // signatures checked on the first pass by keys in both roots, kept in front
+static int num_shared_valid;         // how many of them are valid
+static bool new_keys_done;           // the signatures by keys in both roots make the new threshold
+static crypto_hash_t signed_hash;    // hash of the "signed" object from the first pass
+
+static crypto_verify_ctx_t *verify_order[ROOT_MAX_KEYS];  // first pass contexts, by keys in both roots first
+
+static bool in_signed;         // if the "signed" object is being hashed
+static jsmnint_t tail_length;  // number of bytes fed, but not consumed on the last call. These are hashed already
+
+static uint32_t max_bytes;       // budget of a pass, see UPTINY_ROOT_MAX_BYTES
+static uint32_t bytes_consumed;  // in the current pass, before the current message part
+
+static bool buffered;            // uptane_parse_root_buffered(): signatures are checked one by one in one context
+static const char *signed_data;  // beginning of the "signed" object in the buffer, with buffered
+
+static bool chain_active;         // between uptane_root_chain_begin and uptane_root_chain_end
+static uptane_root_t chain_root;  // the last root of the chain, the next one is checked against it
+
+// the root a new one has to be signed by
+static uptane_root_t *previous_root(void) { return chain_active ? &chain_root : state_get_root(); }
+
+void uptane_parse_root_init(void) {
+  // keys of an earlier root that wasn't stored, those of a chain stay until it ends
+  if (!chain_active) {
+    free_all_crypto_keys();
   }
+  state = ROOT_BEGIN;
+  second_pass = false;
+  signed_found = false;
+  skipping_signed = false;
+  num_signatures = 0;
+  sig_base = 0;
+  num_shared_valid = 0;
+  new_keys_done = false;
+  in_signed = false;
+  tail_length = 0;
+  buffered = false;
+  max_bytes = UPTINY_ROOT_MAX_BYTES;
+  bytes_consumed = 0;
+  UPTANE_STATS_STAGE(UPTANE_STAGE_ROOT_BEGIN);
+}
 
-  if (token_pool[0].type != JSMN_OBJECT) {
-    DEBUG_PRINTF("Object expected\n");
-    return false;
+void uptane_parse_root_set_budget(uint32_t max) { max_bytes = max; }
+
+// contexts hashing the "signed" object alongside the parser, none with buffered
+static inline unsigned int num_hashing(void) { return buffered ? 0 : num_signatures; }
+
+static inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+// skips whitespace and the commas between elements
+static inline jsmnint_t skip_blanks(const char *message, jsmnint_t len, jsmnint_t pos) {
+  while (pos < len && (is_space(message[pos]) || message[pos] == ',')) {
+    ++pos;
+  }
+  return pos;
+}
+
+// position right after the string beginning at pos, -1 if the string doesn't end in this part of the message
+static jsmnint_t string_end(const char *message, jsmnint_t len, jsmnint_t pos) {
+  for (++pos; pos < len; ++pos) {
+    if (message[pos] == '\\') {
+      ++pos;
+    } else if (message[pos] == '"') {
+      return (jsmnint_t)(pos + 1);
+    }
   }
+  return -1;
+}
 
-  int16_t size = token_pool[0].size;
-  int16_t idx = 1;  // consume object token
-  for (int i = 0; i < size; ++i) {
-    if (json_str_equal(metadata, idx, "signatures")) {
-      ++idx;  // consume name token
-      signatures_token = idx;
-      num_signatures =
-          uptane_parse_signatures(ROLE_ROOT, metadata, &idx, signature_pool, signature_pool_size, old_root);
-      if (num_signatures <= 0) {
-        DEBUG_PRINTF("Failed to parse signatures : %d\n", num_signatures);
-        return false;
+// position right after the value beginning at pos, -1 if the value doesn't end in this part of the message. A
+// primitive only ends when the character after it is there
+static jsmnint_t value_end(const char *message, jsmnint_t len, jsmnint_t pos) {
+  switch (message[pos]) {
+    case '"':
+      return string_end(message, len, pos);
+    case '{':
+    case '[': {
+      jsmn_parser p;
+      jsmn_init(&p);
+      p.pos = (jsmnint_t)(pos + 1);
+      jsmn_skip_init(&p);
+      return (jsmn_skip(&p, message, len) == 0) ? p.pos : -1;
+    }
+    default:
+      for (; pos < len; ++pos) {
+        if (is_space(message[pos]) || message[pos] == ',' || message[pos] == '}' || message[pos] == ']') {
+          return pos;
+        }
       }
+      return -1;
+  }
+}
+
+typedef enum {
+  MEMBER_OK,
+  MEMBER_PART,   // the message ends before the value
+  MEMBER_ERROR,  // not a member of an object
+} member_result_t;
+
+// reads the '"name":' part of the object member at pos, sets *name_end to the position after the name and *value to
+// the beginning of the value
+static member_result_t read_member(const char *message, jsmnint_t len, jsmnint_t pos, jsmnint_t *name_end,
+                                   jsmnint_t *value) {
+  if (message[pos] != '"') {
+    DEBUG_PRINTF("Object member expected\n");
+    return MEMBER_ERROR;
+  }
+  jsmnint_t i = string_end(message, len, pos);
+  if (i < 0) {
+    return MEMBER_PART;
+  }
+  *name_end = i;
+
+  while (i < len && is_space(message[i])) {
+    ++i;
+  }
+  if (i >= len) {
+    return MEMBER_PART;
+  }
+  if (message[i] != ':') {
+    DEBUG_PRINTF("':' expected\n");
+    return MEMBER_ERROR;
+  }
+  ++i;
+  while (i < len && is_space(message[i])) {
+    ++i;
+  }
+  if (i >= len) {
+    return MEMBER_PART;
+  }
+  *value = i;
+  return MEMBER_OK;
+}
+
+// name of the member read by read_member
+static inline bool name_equal(const char *message, jsmnint_t pos, jsmnint_t name_end, const char *value, size_t len) {
+  return (size_t)(name_end - pos - 2) == len && memcmp(message + pos + 1, value, len) == 0;
+}
+#define name_lit_equal(message, pos, name_end, literal) \
+  name_equal((message), (pos), (name_end), "" literal "", sizeof(literal) - 1)
+
+// puts the tokens of message[begin, end) into token_pool, offsets are relative to begin
+static bool tokenize(const char *message, jsmnint_t begin, jsmnint_t end) {
+  jsmn_parser p;
+  int res;
+
+  jsmn_init(&p);
+  res = jsmn_parse(&p, message + begin, (jsmnint_t)(end - begin), token_pool, token_pool_size);
+  UPTANE_POOL_PEAK(tokens, p.toknext);
+  UPTANE_POOL_COUNT(tokens_parsed, p.toknext);
+  UPTANE_STATS_COUNT(tokens, p.toknext);
+  return res > 0;
+}
+
+// puts the tokens of a '"name": value' member with a string or primitive value into token_pool, offsets are relative to
+// begin. Strict jsmn won't take a primitive without seeing what follows it, so the two tokens are made here
+static void tokenize_scalar_member(const char *message, jsmnint_t begin, jsmnint_t name_end, jsmnint_t value,
+                                   jsmnint_t end) {
+  token_pool[0].type = JSMN_STRING;
+  token_pool[0].start = 1;
+  token_pool[0].end = (jsmnint_t)(name_end - begin - 1);
+  token_pool[0].size = 1;
+  token_pool[0].parent = -1;
+  token_pool[0].next = -1;
+
+  if (message[value] == '"') {
+    token_pool[1].type = JSMN_STRING;
+    token_pool[1].start = (jsmnint_t)(value - begin + 1);
+    token_pool[1].end = (jsmnint_t)(end - begin - 1);
+  } else {
+    token_pool[1].type = JSMN_PRIMITIVE;
+    token_pool[1].start = (jsmnint_t)(value - begin);
+    token_pool[1].end = (jsmnint_t)(end - begin);
+  }
+  token_pool[1].size = 0;
+  token_pool[1].parent = 0;
+  token_pool[1].next = -1;
+}
+
+// a root can't have more than ROOT_MAX_KEYS keys to sign it, so there is no use in more signatures
+static inline unsigned int max_signatures(void) {
+  unsigned int max = ROOT_MAX_KEYS;
+  if (!buffered && crypto_ctx_pool_size < max) {
+    max = crypto_ctx_pool_size;
+  }
+  if (signature_pool_size - sig_base < max) {
+    max = signature_pool_size - sig_base;
+  }
+  return max;
+}
+
+static void begin_signed(const char *data) {
+  signed_data = data;
+  UPTANE_POOL_PEAK(crypto_ctxs, buffered ? 1 : num_signatures);
+  for (unsigned int i = 0; i < num_hashing(); i++) {
+    crypto_verify_init(crypto_ctx_pool[i], &signature_pool[sig_base + i]);
+  }
+  crypto_hash_init(&hash_context, CRYPTO_HASH_SHA512);
+  in_signed = true;
+}
+
+static void hash_signed(const char *message, jsmnint_t begin, jsmnint_t end) {
+  if (num_hashing() > 0) {
+    crypto_verify_feed_multi_start(crypto_ctx_pool, num_hashing(), (const uint8_t *)message + begin,
+                                   (size_t)(end - begin));
+  }
+  crypto_hash_feed_start(&hash_context, (const uint8_t *)message + begin, (size_t)(end - begin));
+}
+
+// if the key of an old root signature is in the new root as well
+static bool key_in_new_root(const crypto_key_t *key, uptane_root_t *out_root) {
+  const crypto_key_t *new_key = find_key_bin(key->keyid, out_root->root_keys, out_root->root_keys_num);
+  return new_key != NULL && new_key->key_type == key->key_type &&
+         memcmp(new_key->keyval, key->keyval, CRYPTO_KEYVAL_LEN) == 0;
+}
+
+// if the key of a second pass signature has been counted on the first pass already. A key counts once, whatever it
+// signed: another signature by it, valid or not, must not add to num_shared_valid
+static bool signature_checked(const crypto_key_and_signature_t *sig) {
+  for (unsigned int i = 0; i < sig_base; i++) {
+    if (memcmp(signature_pool[i].key->keyid, sig->key->keyid, CRYPTO_KEYID_LEN) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// checks the first pass signatures. The ones by keys that stay in the new root are all checked and count towards both
+// thresholds, the rest only as long as the old threshold needs them. The former are moved to the front of
+// signature_pool for the second pass
+static uint16_t verify_first_pass(uptane_root_t *out_root, const char *signed_end) {
+  const uptane_root_t *old_root = previous_root();
+  unsigned int num_shared = 0;
+  unsigned int num_old = num_signatures;
+  int num_valid_signatures;
+
+  if (buffered) {
+    const uint8_t *data = (const uint8_t *)signed_data;
+    size_t len = (size_t)(signed_end - signed_data);
+
+    // the signatures themselves are put in order, by keys in both roots first
+    for (unsigned int i = 0; i < num_old;) {
+      if (key_in_new_root(signature_pool[i].key, out_root)) {
+        ++num_shared;
+        ++i;
+      } else {
+        crypto_key_and_signature_t sig = signature_pool[i];
+        signature_pool[i] = signature_pool[--num_old];
+        signature_pool[num_old] = sig;
+      }
+    }
+    num_shared_valid = 0;
+    for (unsigned int i = 0; i < num_shared; i++) {
+      num_shared_valid += uptane_verify_signatures_buffered(crypto_ctx_pool[0], &signature_pool[i], 1, 1, data, len);
+    }
+    num_valid_signatures = num_shared_valid;
+    if (num_valid_signatures < old_root->root_threshold) {
+      num_valid_signatures += uptane_verify_signatures_buffered(crypto_ctx_pool[0], &signature_pool[num_shared],
+                                                                num_signatures - num_shared,
+                                                                old_root->root_threshold - num_shared_valid, data, len);
+    } else {
+      UPTANE_STATS_COUNT(signatures_skipped, num_signatures - num_shared);
+    }
+  } else {
+    for (unsigned int i = 0; i < num_signatures; i++) {
+      if (key_in_new_root(signature_pool[i].key, out_root)) {
+        verify_order[num_shared++] = crypto_ctx_pool[i];
+      } else {
+        verify_order[--num_old] = crypto_ctx_pool[i];
+      }
+    }
+
+    crypto_verify_wait(verify_order, num_shared);
+    num_shared_valid = (num_shared > 0) ? crypto_verify_result_batch(verify_order, num_shared, NULL) : 0;
+    UPTANE_STATS_COUNT(signatures_verified, num_shared);
+
+    num_valid_signatures = num_shared_valid;
+    if (num_valid_signatures < old_root->root_threshold) {
+      num_valid_signatures += uptane_verify_signatures_ctx(verify_order + num_shared, num_signatures - num_shared,
+                                                          old_root->root_threshold - num_shared_valid);
+    } else {
+      UPTANE_STATS_COUNT(signatures_skipped, num_signatures - num_shared);
+    }
+  }
+  if (num_valid_signatures < old_root->root_threshold) {
+    DEBUG_PRINTF("Signature verification with old keys failed: only %d valid keys while threshold is %d\n",
+                 num_valid_signatures, old_root->root_threshold);
+    return ROOT_RESULT_SIGNATURES_FAILED;
+  }
+
+  // contexts are done with signature_pool
+  sig_base = 0;
+  for (unsigned int i = 0; i < num_signatures; i++) {
+    if (key_in_new_root(signature_pool[i].key, out_root)) {
+      signature_pool[sig_base++] = signature_pool[i];
+    }
+  }
+  new_keys_done = (num_shared_valid >= out_root->root_threshold);
+  return ROOT_RESULT_IN_PROGRESS;
+}
+
+// called once the whole "signed" object is hashed, signed_end is right after it. Returns ROOT_RESULT_IN_PROGRESS if the
+// checks of this pass succeed
+static uint16_t end_signed(uptane_root_t *out_root, const char *signed_end) {
+  const uptane_root_t *old_root = previous_root();
+  crypto_hash_t hash;
+
+  in_signed = false;
+  UPTANE_STATS_STAGE(UPTANE_STAGE_ROOT_SIGNED);
+  crypto_hash_wait(&hash_context);
+  crypto_hash_result(&hash_context, &hash);
+
+  if (!second_pass) {
+    signed_hash = hash;
+    uint16_t res = verify_first_pass(out_root, signed_end);
+    if (res != ROOT_RESULT_IN_PROGRESS) {
+      return res;
+    }
+    if (out_root->version < old_root->version) {
+      DEBUG_PRINTF("Root metadata downgrade attempt\n");
+      return ROOT_RESULT_VERSION_FAILED;
+    }
+    return ROOT_RESULT_IN_PROGRESS;
+  }
+
+  // the keys from the first pass only apply to the same "signed" object
+  if (memcmp(hash.hash, signed_hash.hash, crypto_get_hashlen(CRYPTO_HASH_SHA512)) != 0) {
+    DEBUG_PRINTF("Root metadata changed between the passes\n");
+    return ROOT_RESULT_SIGNATURES_FAILED;
+  }
+
+  int num_valid_signatures = num_shared_valid;
+  if (buffered) {
+    num_valid_signatures += uptane_verify_signatures_buffered(
+        crypto_ctx_pool[0], &signature_pool[sig_base], num_signatures, out_root->root_threshold - num_shared_valid,
+        (const uint8_t *)signed_data, (size_t)(signed_end - signed_data));
+  } else {
+    num_valid_signatures += uptane_verify_signatures_result(num_signatures, out_root->root_threshold - num_shared_valid);
+  }
+  if (num_valid_signatures < out_root->root_threshold) {
+    DEBUG_PRINTF("Signature verification with new keys failed: only %d valid keys while threshold is %d\n",
+                 num_valid_signatures, out_root->root_threshold);
+    return ROOT_RESULT_SIGNATURES_FAILED;
+  }
+  return ROOT_RESULT_IN_PROGRESS;
+}
+
+// starts skipping the object or array beginning at pos
+static inline void begin_ignored(jsmnint_t pos) {
+  skipper.pos = (jsmnint_t)(pos + 1);
+  jsmn_skip_init(&skipper);
+  UPTANE_STATS_COUNT(subtrees_skipped, 1);
+  prev_state = state;
+  state = ROOT_IN_IGNORED;
+}
+
+// skips the value of a member or element beginning at pos, returns the position after it or -1 if it doesn't end in
+// this part of the message
+static jsmnint_t skip_value(const char *message, jsmnint_t len, jsmnint_t pos) {
+  if (message[pos] == '{' || message[pos] == '[') {
+    begin_ignored(pos);
+    return (jsmnint_t)(pos + 1);
+  }
+  return value_end(message, len, pos);
+}
 
-    } else if (json_str_equal(metadata, idx, "signed")) {
-      ++idx;  // consume name token
-      signed_begin = token_pool[idx].start;
-      signed_end = token_pool[idx].end;
+int uptane_parse_root_feed(const char *message, jsmnint_t len, uptane_root_t *out_root, uint16_t *result) {
+  // The message is walked one element at a time. A signature, a key entry, a role or a field of "signed" is only
+  // tokenized when it is complete in this part of the message; everything else is consumed as it comes.
 
-      if (num_signatures <= 0) {
-        DEBUG_PRINTF("No signatures to verify root metadata signed object\n");
-        return false;
+  if (state == ROOT_IN_ERROR) {
+    *result = ROOT_RESULT_ERROR;
+    return -1;
+  }
+  if (state == ROOT_DONE) {
+    *result = ROOT_RESULT_END;
+    return 0;
+  }
+  UPTANE_STATS_COUNT(bytes_fed, len);
+
+  // Hashing of the previous part may still be going on
+  if (in_signed) {
+    crypto_verify_wait(crypto_ctx_pool, num_hashing());
+    crypto_hash_wait(&hash_context);
+  }
+
+  if (max_bytes > 0 && (uint32_t)len > max_bytes - bytes_consumed) {
+    DEBUG_PRINTF("Root metadata is over the budget of %u bytes\n", (unsigned int)max_bytes);
+    in_signed = false;
+    state = ROOT_IN_ERROR;
+    state_set_attack(ATTACK_ROOT_LARGE);
+    *result = ROOT_RESULT_TOO_LARGE;
+    return -1;
+  }
+
+  jsmnint_t hash_begin = tail_length;  // bytes before this are hashed already
+  uint16_t res = ROOT_RESULT_IN_PROGRESS;
+  jsmnint_t pos = 0;
+  bool part = false;
+
+  while (!part && res == ROOT_RESULT_IN_PROGRESS) {
+    if (state == ROOT_IN_IGNORED) {
+      skipper.pos = pos;
+      if (jsmn_skip(&skipper, message, len) != 0) {
+        pos = len;
+        break;
+      }
+      pos = skipper.pos;
+      state = prev_state;
+      if (skipping_signed) {
+        skipping_signed = false;
+        hash_signed(message, hash_begin, pos);
+        res = end_signed(out_root, message + pos);
       }
+      continue;
+    }
+
+    pos = skip_blanks(message, len, pos);
+    if (pos >= len) {
+      break;
+    }
+
+    jsmnint_t name_end = -1;
+    jsmnint_t value = -1;
+    jsmnint_t end = -1;
+    jsmnint_t idx = 0;
+    member_result_t member;
 
-      int num_valid_signatures = 0;
-      for (int j = 0; j < num_signatures; j++) {
-        crypto_verify_init(crypto_ctx_pool[j], &signature_pool[j]);
-        crypto_verify_feed(crypto_ctx_pool[j], (const uint8_t *)metadata + signed_begin,
-                           (size_t)(signed_end - signed_begin));
-        if (crypto_verify_result(crypto_ctx_pool[j])) {
-          ++num_valid_signatures;
+    switch (state) {
+      case ROOT_BEGIN:
+        if (message[pos] != '{') {
+          DEBUG_PRINTF("Object expected\n");
+          res = ROOT_RESULT_ERROR;
+          break;
+        }
+        ++pos;
+        state = ROOT_IN_TOP;
+        break;
+
+      case ROOT_IN_TOP:
+        if (message[pos] == '}') {
+          ++pos;
+          if (!signed_found) {
+            DEBUG_PRINTF("No signed found\n");
+            res = ROOT_RESULT_ERROR;
+          } else if (!second_pass && !new_keys_done) {
+            // start over to check the signatures by keys only the new root has
+            second_pass = true;
+            signed_found = false;
+            num_signatures = 0;
+            state = ROOT_BEGIN;
+            res = ROOT_RESULT_FEED_AGAIN;
+          } else {
+            state = ROOT_DONE;
+            res = ROOT_RESULT_END;
+            UPTANE_STATS_STAGE(UPTANE_STAGE_ROOT_END);
+          }
+          break;
+        }
+
+        member = read_member(message, len, pos, &name_end, &value);
+        if (member != MEMBER_OK) {
+          part = (member == MEMBER_PART);
+          res = part ? ROOT_RESULT_IN_PROGRESS : ROOT_RESULT_ERROR;
+          break;
+        }
+
+        if (name_lit_equal(message, pos, name_end, "signatures") && message[value] == '[') {
+          num_signatures = 0;
+          pos = (jsmnint_t)(value + 1);
+          state = ROOT_IN_SIGNATURES;
+        } else if (name_lit_equal(message, pos, name_end, "signed") && message[value] == '{') {
+          if (num_signatures == 0 && !second_pass) {
+            DEBUG_PRINTF("No signatures to verify root metadata signed object\n");
+            res = ROOT_RESULT_SIGNATURES_FAILED;
+            break;
+          }
+          signed_found = true;
+          begin_signed(message + value);
+          hash_begin = value;
+          if (second_pass) {
+            // parsed on the first pass already
+            begin_ignored(value);
+            skipping_signed = true;
+          } else {
+            state = ROOT_IN_SIGNED;
+          }
+          pos = (jsmnint_t)(value + 1);
         } else {
-          DEBUG_PRINTF("Signature verification with old keys failed for key %d\n", j);
+          DEBUG_PRINTF("Unknown field in root metadata: \"%.*s\"\n", name_end - pos - 2, message + pos + 1);
+          end = skip_value(message, len, value);
+          if (end < 0) {
+            part = true;
+          } else {
+            pos = end;
+          }
         }
-      }
+        break;
 
-      if (num_valid_signatures < old_root->root_threshold) {
-        DEBUG_PRINTF("Signature verification with old keys failed: only %d valid keys while threshold is %d\n",
-                     num_valid_signatures, old_root->root_threshold);
-        return false;
-      }
+      case ROOT_IN_SIGNATURES:
+        if (message[pos] == ']') {
+          ++pos;
+          state = ROOT_IN_TOP;
+          break;
+        }
+        end = value_end(message, len, pos);
+        if (end < 0) {
+          part = true;
+          break;
+        }
+        if (num_signatures >= max_signatures()) {
+          DEBUG_PRINTF("Too many signatures, only %u are used\n", num_signatures);
+        } else if (!tokenize(message, pos, end)) {
+          DEBUG_PRINTF("Failed to parse signature\n");
+          res = ROOT_RESULT_ERROR;
+          break;
+        } else {
+          crypto_key_and_signature_t *sig = &signature_pool[sig_base + num_signatures];
+          int parse_res = uptane_parse_signature(ROLE_ROOT, message + pos, &idx, sig, &signature_pool[sig_base],
+                                                 num_signatures, second_pass ? out_root : previous_root());
+          if (parse_res < 0) {
+            DEBUG_PRINTF("Failed to parse signature\n");
+            res = ROOT_RESULT_ERROR;
+            break;
+          }
+          if (parse_res > 0 && !(second_pass && signature_checked(sig))) {
+            ++num_signatures;
+            UPTANE_POOL_PEAK(signatures, sig_base + num_signatures);
+          }
+        }
+        pos = end;
+        break;
 
-      if (!uptane_parse_root_signed(metadata, &idx, out_root)) {
-        DEBUG_PRINTF("Failed to parse signed part of root metadata\n");
-        return false;
-      }
+      case ROOT_IN_SIGNED:
+        if (message[pos] == '}') {
+          ++pos;
+          state = ROOT_IN_TOP;
+          hash_signed(message, hash_begin, pos);
+          res = end_signed(out_root, message + pos);
+          break;
+        }
 
-      if (out_root->version < old_root->version) {
-        DEBUG_PRINTF("Root metadata downgrade attempt\n");
-        return false;
-      }
+        member = read_member(message, len, pos, &name_end, &value);
+        if (member != MEMBER_OK) {
+          part = (member == MEMBER_PART);
+          res = part ? ROOT_RESULT_IN_PROGRESS : ROOT_RESULT_ERROR;
+          break;
+        }
 
-      num_signatures = uptane_parse_signatures(ROLE_ROOT, metadata, &signatures_token, signature_pool,
-                                               signature_pool_size, out_root);
-      if (num_signatures <= 0) {
-        DEBUG_PRINTF("Failed to parse signatures with new root: %d\n", num_signatures);
-        return false;
-      }
+        if (name_lit_equal(message, pos, name_end, "keys") || name_lit_equal(message, pos, name_end, "roles")) {
+          if (message[value] != '{') {
+            DEBUG_PRINTF("Object expected\n");
+            res = ROOT_RESULT_ERROR;
+            break;
+          }
+          if (message[pos + 1] == 'k') {
+            uptane_root_signed_keys_begin();
+            state = ROOT_IN_KEYS;
+          } else {
+            uptane_root_signed_roles_begin();
+            state = ROOT_IN_ROLES;
+          }
+          pos = (jsmnint_t)(value + 1);
+        } else if (message[value] == '{' || message[value] == '[') {
+          DEBUG_PRINTF("Unknown field in a root metadata: \"%.*s\"\n", name_end - pos - 2, message + pos + 1);
+          begin_ignored(value);
+          pos = (jsmnint_t)(value + 1);
+        } else {
+          end = value_end(message, len, value);
+          if (end < 0) {
+            part = true;
+            break;
+          }
+          tokenize_scalar_member(message, pos, name_end, value, end);
+          if (!uptane_root_signed_member(message + pos, &idx, out_root)) {
+            res = ROOT_RESULT_ERROR;
+            break;
+          }
+          pos = end;
+        }
+        break;
+
+      case ROOT_IN_KEYS:
+      case ROOT_IN_ROLES:
+        if (message[pos] == '}') {
+          ++pos;
+          if (state == ROOT_IN_ROLES && !uptane_root_signed_roles_end()) {
+            DEBUG_PRINTF("Failed to parse roles\n");
+            res = ROOT_RESULT_ERROR;
+            break;
+          }
+          state = ROOT_IN_SIGNED;
+          break;
+        }
+
+        member = read_member(message, len, pos, &name_end, &value);
+        if (member != MEMBER_OK) {
+          part = (member == MEMBER_PART);
+          res = part ? ROOT_RESULT_IN_PROGRESS : ROOT_RESULT_ERROR;
+          break;
+        }
+
+        if (state == ROOT_IN_ROLES && !name_lit_equal(message, pos, name_end, "root") &&
+            !name_lit_equal(message, pos, name_end, "targets")) {
+          // ignore the other roles
+          end = skip_value(message, len, value);
+          if (end < 0) {
+            part = true;
+          } else {
+            pos = end;
+          }
+          break;
+        }
 
-      num_valid_signatures = 0;
-      for (int j = 0; j < num_signatures; j++) {
-        crypto_verify_init(crypto_ctx_pool[j], &signature_pool[j]);
-        crypto_verify_feed(crypto_ctx_pool[j], (const uint8_t *)metadata + signed_begin,
-                           (size_t)(signed_end - signed_begin));
-        if (crypto_verify_result(crypto_ctx_pool[j])) {
-          ++num_valid_signatures;
+        end = value_end(message, len, value);
+        if (end < 0) {
+          part = true;
+          break;
+        }
+        if (message[value] == '{' || message[value] == '[') {
+          if (!tokenize(message, pos, end)) {
+            DEBUG_PRINTF("Failed to parse \"%.*s\"\n", name_end - pos - 2, message + pos + 1);
+            res = ROOT_RESULT_ERROR;
+            break;
+          }
         } else {
-          DEBUG_PRINTF("Signature verification with new keys failed for key %d\n", j);
+          tokenize_scalar_member(message, pos, name_end, value, end);
         }
-      }
 
-      if (num_valid_signatures < out_root->root_threshold) {
-        DEBUG_PRINTF("Signature verification with new keys failed: only %d valid keys while threshold is %d\n",
-                     num_valid_signatures, out_root->root_threshold);
-        return false;
-      }
+        if (state == ROOT_IN_KEYS) {
+          if (!uptane_root_signed_key(message + pos, &idx)) {
+            res = ROOT_RESULT_ERROR;
+            break;
+          }
+        } else {
+          uptane_root_signed_role(message + pos, &idx, out_root);
+        }
+        pos = end;
+        break;
 
-      return true;  // success;
+      default:
+        res = ROOT_RESULT_ERROR;
+        break;
+    }
+  }
 
-    } else {
-      ++idx;  // consume name token
-      DEBUG_PRINTF("Unknown field in key object: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                   metadata + token_pool[idx].start);
-      idx = consume_recursive_json(idx);  // consume value
+  if (in_signed) {
+    // the rest of the part is hashed now, the unconsumed tail won't be hashed again on the next call
+    hash_signed(message, hash_begin, len);
+  }
+
+  switch (res) {
+    case ROOT_RESULT_IN_PROGRESS:
+      break;
+    case ROOT_RESULT_END:
+    case ROOT_RESULT_FEED_AGAIN:
+      tail_length = 0;
+      bytes_consumed = 0;
+      *result = res;
+      return (int)pos;
+    default:
+      in_signed = false;
+      state = ROOT_IN_ERROR;
+      *result = res;
+      return -1;
+  }
+
+  *result = ROOT_RESULT_IN_PROGRESS;
+  tail_length = (jsmnint_t)(len - pos);
+  bytes_consumed += (uint32_t)pos;
+  return (int)pos;
+}
+
+bool uptane_parse_root_busy(void) {
+  for (unsigned int i = 0; in_signed && i < num_hashing(); i++) {
+    if (crypto_verify_poll(crypto_ctx_pool[i]) != CRYPTO_OP_DONE) {
+      return true;
+    }
+  }
+  return in_signed && crypto_hash_poll(&hash_context) != CRYPTO_OP_DONE;
+}
+
+bool uptane_parse_root(const char *metadata, jsmnint_t len, uptane_root_t *out_root) {
+  uint16_t result = ROOT_RESULT_IN_PROGRESS;
+
+  uptane_parse_root_init();
+  uptane_parse_root_feed(metadata, len, out_root, &result);
+  if (result == ROOT_RESULT_FEED_AGAIN) {
+    uptane_parse_root_feed(metadata, len, out_root, &result);
+  }
+  return result == ROOT_RESULT_END;
+}
+
+bool uptane_parse_root_buffered(const char *metadata, jsmnint_t len, uptane_root_t *out_root) {
+  uint16_t result = ROOT_RESULT_IN_PROGRESS;
+
+  uptane_parse_root_init();
+  buffered = true;
+  uptane_parse_root_feed(metadata, len, out_root, &result);
+  if (result == ROOT_RESULT_FEED_AGAIN) {
+    uptane_parse_root_feed(metadata, len, out_root, &result);
+  }
+  buffered = false;
+  return result == ROOT_RESULT_END;
+}
+
+static bool root_has_key(const uptane_root_t *root, const crypto_key_t *key) {
+  for (int i = 0; i < root->root_keys_num; i++) {
+    if (root->root_keys[i] == key) {
+      return true;
+    }
+  }
+  for (int i = 0; i < root->targets_keys_num; i++) {
+    if (root->targets_keys[i] == key) {
+      return true;
     }
   }
-  DEBUG_PRINTF("No signed found\n");
   return false;
 }
+
+// frees the keys of the chain root that neither root has, the stored root's keys may not be from the pool at all
+static void free_chain_keys(const uptane_root_t *next) {
+  const uptane_root_t *stored = state_get_root();
+
+  for (int i = 0; i < chain_root.root_keys_num; i++) {
+    crypto_key_t *key = chain_root.root_keys[i];
+    if (!root_has_key(stored, key) && (next == NULL || !root_has_key(next, key))) {
+      free_crypto_key(key);
+    }
+  }
+  for (int i = 0; i < chain_root.targets_keys_num; i++) {
+    crypto_key_t *key = chain_root.targets_keys[i];
+    if (!root_has_key(stored, key) && (next == NULL || !root_has_key(next, key))) {
+      free_crypto_key(key);
+    }
+  }
+}
+
+void uptane_root_chain_begin(void) {
+  chain_root = *state_get_root();
+  chain_active = true;
+}
+
+bool uptane_root_chain_next(const uptane_root_t *root) {
+  if (!chain_active) {
+    return false;
+  }
+  if (root->version != chain_root.version + 1) {
+    DEBUG_PRINTF("Root version %d doesn't follow %d in the chain\n", root->version, chain_root.version);
+    return false;
+  }
+  free_chain_keys(root);
+  chain_root = *root;
+  return true;
+}
+
+bool uptane_root_chain_end(bool commit) {
+  bool stored = false;
+
+  if (!chain_active) {
+    return false;
+  }
+  chain_active = false;
+  if (commit && chain_root.version != state_get_root()->version) {
+    state_set_root(&chain_root);
+    stored = true;
+  } else {
+    free_chain_keys(NULL);
+  }
+  return stored;
+}
+
+// the key of root with the ID, type and value of key
+static crypto_key_t *same_key(uptane_root_t *root, const crypto_key_t *key) {
+  crypto_key_t *same = find_key_bin(key->keyid, root->root_keys, root->root_keys_num);
+
+  if (same == NULL) {
+    same = find_key_bin(key->keyid, root->targets_keys, root->targets_keys_num);
+  }
+  if (same == NULL || same->key_type != key->key_type || memcmp(same->keyval, key->keyval, CRYPTO_KEYVAL_LEN) != 0) {
+    return NULL;
+  }
+  return same;
+}
+
+crypto_key_t *uptane_root_chain_key(const crypto_key_t *key) {
+  return chain_active ? same_key(&chain_root, key) : NULL;
+}
+
+crypto_key_t *uptane_root_stored_key(const crypto_key_t *key) { return same_key(state_get_root(), key); }
+
+bool uptane_root_chain_owns(const crypto_key_t *key) {
+  return root_has_key(state_get_root(), key) || (chain_active && root_has_key(&chain_root, key));
+}
@@ -5,8 +5,63 @@
 extern "C" {
 #endif
 
+#include "jsmn.h"
 #include "state_api.h"
-bool uptane_parse_root(const char *metadata, int16_t len, uptane_root_t *out_root);
+
+typedef enum {
+  ROOT_RESULT_ERROR = 0xFFFF,
+  ROOT_RESULT_SIGNATURES_FAILED = 0xFFFD,
+  ROOT_RESULT_VERSION_FAILED = 0xFFFC,
+  ROOT_RESULT_TOO_LARGE = 0xFFFA,  // a pass is over the byte budget
+  ROOT_RESULT_IN_PROGRESS = 0x0000,
+  ROOT_RESULT_END = 0x0001,
+  ROOT_RESULT_FEED_AGAIN = 0x0002,
+} root_result_t;
+
+bool uptane_parse_root(const char *metadata, jsmnint_t len, uptane_root_t *out_root);
+
+/* Same, but the signatures are checked one after another over the "signed" object in the buffer, all in
+ * crypto_ctx_pool[0]. crypto_ctx_pool may then have a single context, and the signatures are only limited by
+ * signature_pool. Slower, as the signatures are neither hashed alongside the parser nor checked as a batch.
+ */
+bool uptane_parse_root_buffered(const char *metadata, jsmnint_t len, uptane_root_t *out_root);
+
+/* Chunked counterpart of uptane_parse_root, used like uptane_parse_targets_feed: the return value is the number of
+ * bytes consumed, the rest has to be fed again in front of the next chunk. Only one signature, key entry or role
+ * needs to fit in a chunk, bigger parts of the message are hashed and skipped as they come.
+ *
+ * The first pass checks the signatures by the current root keys and parses the signed object into out_root. Each
+ * signature is checked once: those by keys that stay in the new root count towards both thresholds. If they make the
+ * new threshold, the pass ends with ROOT_RESULT_END. Otherwise it ends with ROOT_RESULT_FEED_AGAIN, and the message
+ * has to be fed once more from the start to check the signatures by keys only the new root has, which ends with
+ * ROOT_RESULT_END. out_root may only be used after that.
+ *
+ * The keys of out_root are from the candidate generation of common_data_api.h, keys the stored root has too are
+ * shared with it. They stay valid until the next uptane_parse_root_init outside of a root chain frees the keys of a
+ * root that wasn't stored in the meantime, or state_set_root stores it.
+ */
+void uptane_parse_root_init(void);
+int uptane_parse_root_feed(const char *message, jsmnint_t len, uptane_root_t *out_root, uint16_t *result);
+
+/* Call after uptane_parse_root_init: replaces UPTINY_ROOT_MAX_BYTES, 0 for no limit. The feed fails with
+ * ROOT_RESULT_TOO_LARGE and sets ATTACK_ROOT_LARGE as soon as a message part reaches past max_bytes from the start of
+ * the message in the current pass.
+ */
+void uptane_parse_root_set_budget(uint32_t max_bytes);
+
+/* Same as uptane_parse_targets_busy */
+bool uptane_parse_root_busy(void);
+
+/* Root chain, for an ECU several root versions behind: N+1.root.json to N+k.root.json in one session, stored once.
+ * After uptane_root_chain_begin each root is parsed as usual, with any of the functions above, but checked against the
+ * root before it in the chain instead of the stored one, and added with uptane_root_chain_next, which takes only the
+ * next version. Keys that stay from one root to the next keep their crypto_key_t and aren't prepared again, those
+ * that are gone go back to the pool. uptane_root_chain_end stores the last root with state_set_root if commit is
+ * true and the chain has grown, and returns whether it did; otherwise the chain is dropped and the stored root stays.
+ */
+void uptane_root_chain_begin(void);
+bool uptane_root_chain_next(const uptane_root_t *root);
+bool uptane_root_chain_end(bool commit);
 
 #ifdef __cplusplus
 }
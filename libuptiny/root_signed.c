@@ -8,121 +8,154 @@
 
 static crypto_key_t *keys[ROOT_MAX_KEYS];
 static int num_keys = 0;
+static bool root_role_found = false;
+static bool targets_role_found = false;
 
 static inline bool parse_keyval(const char *keyval, int len, crypto_key_t *key) {
-  (void)keyval;
-  (void)len;
-  (void)key;
-
-  switch (key->key_type) {
-    case CRYPTO_ALG_ED25519:
-      return hex2bin(keyval, len, key->keyval);
-    default:
-      return false;
+  // ed25519 is the only algorithm, crypto_str_to_keytype() returns nothing else
+  return key->key_type == CRYPTO_ALG_ED25519 && len == CRYPTO_KEYVAL_LEN * 2 && hex2bin(keyval, len, key->keyval);
+}
+
+// the keys of a root chain stay with their roots
+static void release_key(crypto_key_t *key) {
+  if (!uptane_root_chain_owns(key)) {
+    free_crypto_key(key);
   }
 }
 
-static inline bool parse_keys(const char *metadata_str, int16_t *pos) {
-  int16_t idx = *pos;
+static void free_keys(void) {
+  for (int j = 0; j < num_keys; j++) {
+    release_key(keys[j]);
+  }
+  num_keys = 0;
+}
 
-  if (token_pool[idx].type != JSMN_OBJECT) {
-    DEBUG_PRINTF("Object expected\n");
+// parses a single "<key ID>": {...} member of the "keys" object
+static inline bool parse_key(const char *metadata_str, jsmnint_t *pos) {
+  jsmnint_t idx = *pos;
+  bool keytype_supported = false;
+  bool keyval_found = false;
+
+  keys[num_keys] = alloc_crypto_key();
+  if (keys[num_keys] == NULL) {
+    DEBUG_PRINTF("Couldn't allocate key\n");
     return false;
   }
-  int16_t size = token_pool[idx].size;
-  ++idx;  // consume object token
 
-  for (int16_t i = 0; i < size; ++i) {
-    bool keytype_supported = false;
-    bool keyval_found = false;
-
-    keys[num_keys] = alloc_crypto_key();
-    if (keys[num_keys] == NULL) {
-      DEBUG_PRINTF("Couldn't allocate key\n");
-      return false;
-    }
+  if (JSON_TOK_LEN(token_pool[idx]) != (2 * CRYPTO_KEYID_LEN)) {
+    DEBUG_PRINTF("Invalid key ID length\n");
+    *pos = consume_recursive_json((jsmnint_t)(idx + 1));  // consume key
+    free_crypto_key(keys[num_keys]);
+    return true;
+  }
 
-    if (JSON_TOK_LEN(token_pool[idx]) != (2 * CRYPTO_KEYID_LEN)) {
-      DEBUG_PRINTF("Invalid key ID length\n");
-      idx = consume_recursive_json((int16_t)(idx + 1));  // consume key
-      free_crypto_key(keys[num_keys]);
-      continue;
-    }
+  if (!hex2bin(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), keys[num_keys]->keyid)) {
+    DEBUG_PRINTF("Invalid key ID\n");
+    *pos = consume_recursive_json((jsmnint_t)(idx + 1));  // consume key
+    free_crypto_key(keys[num_keys]);
+    return true;
+  }
 
-    if (!hex2bin(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), keys[num_keys]->keyid)) {
-      DEBUG_PRINTF("Invalid key ID\n");
-      idx = consume_recursive_json((int16_t)(idx + 1));  // consume key
-      free_crypto_key(keys[num_keys]);
-      continue;
-    }
+  idx++;  // consume key ID
 
-    idx++;  // consume key ID
+  if (token_pool[idx].type != JSMN_OBJECT) {
+    DEBUG_PRINTF("Invalid key object\n");
+    *pos = consume_recursive_json(idx);  // consume key
+    free_crypto_key(keys[num_keys]);
+    return true;
+  }
 
-    if (token_pool[idx].type != JSMN_OBJECT) {
-      DEBUG_PRINTF("Invalid key object\n");
-      idx = consume_recursive_json(idx);  // consume key
-      free_crypto_key(keys[num_keys]);
-    }
+  jsmnint_t key_size = token_pool[idx].size;
+  ++idx;  // consume object token
 
-    int16_t key_size = token_pool[idx].size;
-    ++idx;  // consume object token
-
-    for (int16_t j = 0; j < key_size; ++j) {
-      if (json_str_equal(metadata_str, idx, "keytype")) {
-        ++idx;  // consume name token
-        keys[num_keys]->key_type =
-            crypto_str_to_keytype(metadata_str + token_pool[idx].start, (size_t)JSON_TOK_LEN(token_pool[idx]));
-        keytype_supported = (keys[num_keys]->key_type != CRYPTO_ALG_UNKNOWN);
-        ++idx;  // consume keytype
-      } else if (json_str_equal(metadata_str, idx, "keyval")) {
-        ++idx;  // consume name token
-        if (token_pool[idx].type != JSMN_OBJECT) {
-          DEBUG_PRINTF("Object expected\n");
-          continue;
-        }
-        ++idx;  // consume object token
-
-        int keyval_size = token_pool[idx].size;
-
-        for (int k = 0; k < keyval_size; ++k) {
-          if (json_str_equal(metadata_str, idx, "public")) {
-            ++idx;  // consume name token
-
-            keyval_found =
-                parse_keyval(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), keys[num_keys]);
-            ++idx;  // consume keyval
-          } else {
-            DEBUG_PRINTF("Unknown field in keyval object: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                         metadata_str + token_pool[idx].start);
-            ++idx;                              //  consume name token
-            idx = consume_recursive_json(idx);  // consume value
-          }
+  for (jsmnint_t j = 0; j < key_size; ++j) {
+    if (json_lit_equal(metadata_str, idx, "keytype")) {
+      ++idx;  // consume name token
+      keys[num_keys]->key_type =
+          crypto_str_to_keytype(metadata_str + token_pool[idx].start, (size_t)JSON_TOK_LEN(token_pool[idx]));
+      keytype_supported = (keys[num_keys]->key_type != CRYPTO_ALG_UNKNOWN);
+      ++idx;  // consume keytype
+    } else if (json_lit_equal(metadata_str, idx, "keyval")) {
+      ++idx;  // consume name token
+      if (token_pool[idx].type != JSMN_OBJECT) {
+        DEBUG_PRINTF("Object expected\n");
+        continue;
+      }
+      ++idx;  // consume object token
+
+      int keyval_size = token_pool[idx].size;
+
+      for (int k = 0; k < keyval_size; ++k) {
+        if (json_lit_equal(metadata_str, idx, "public")) {
+          ++idx;  // consume name token
+
+          keyval_found =
+              parse_keyval(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), keys[num_keys]);
+          ++idx;  // consume keyval
+        } else {
+          DEBUG_PRINTF("Unknown field in keyval object: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
+                       metadata_str + token_pool[idx].start);
+          ++idx;                              //  consume name token
+          idx = consume_recursive_json(idx);  // consume value
         }
-      } else {
-        ++idx;  //  consume name token
-        DEBUG_PRINTF("Unknown field in key object: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                     metadata_str + token_pool[idx].start);
-        idx = consume_recursive_json(idx);  // consume value
       }
+    } else {
+      ++idx;  //  consume name token
+      DEBUG_PRINTF("Unknown field in key object: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
+                   metadata_str + token_pool[idx].start);
+      idx = consume_recursive_json(idx);  // consume value
     }
+  }
 
-    if (keytype_supported && keyval_found) {
-      ++num_keys;
-      if (num_keys >= ROOT_MAX_KEYS) {
-        DEBUG_PRINTF("Too many keys in root.json");
-        return false;
-      }
-    } else {
+  *pos = idx;
+  if (keytype_supported && keyval_found) {
+    crypto_key_t *known = uptane_root_chain_key(keys[num_keys]);
+    if (known == NULL) {
+      known = uptane_root_stored_key(keys[num_keys]);
+    }
+    if (known != NULL) {
+      // prepared for the root before in the chain or the stored root already, neither moves while this one is parsed
       free_crypto_key(keys[num_keys]);
+      share_crypto_key(known);
+      keys[num_keys] = known;
+    } else {
+      crypto_key_prepare(keys[num_keys]);
+    }
+  }
+  if (keytype_supported && keyval_found && key_index_insert(keys, num_keys)) {
+    ++num_keys;
+    if (num_keys >= ROOT_MAX_KEYS) {
+      DEBUG_PRINTF("Too many keys in root.json");
+      return false;
+    }
+  } else {
+    release_key(keys[num_keys]);
+  }
+  return true;
+}
+
+static inline bool parse_keys(const char *metadata_str, jsmnint_t *pos) {
+  jsmnint_t idx = *pos;
+
+  if (token_pool[idx].type != JSMN_OBJECT) {
+    DEBUG_PRINTF("Object expected\n");
+    return false;
+  }
+  jsmnint_t size = token_pool[idx].size;
+  ++idx;  // consume object token
+
+  for (jsmnint_t i = 0; i < size; ++i) {
+    if (!parse_key(metadata_str, &idx)) {
+      return false;
     }
   }
   *pos = idx;
   return true;
 }
 
-static inline bool parse_role(const char *metadata_str, int16_t *pos, int32_t *threshold, int32_t *out_key_num,
+static inline bool parse_role(const char *metadata_str, jsmnint_t *pos, int32_t *threshold, int32_t *out_key_num,
                               crypto_key_t **out_keys) {
-  int16_t idx = *pos;
+  jsmnint_t idx = *pos;
   if (token_pool[idx].type != JSMN_OBJECT) {
     DEBUG_PRINTF("Object expected\n");
     return false;
@@ -134,7 +167,7 @@ static inline bool parse_role(const char *metadata_str, int16_t *pos, int32_t *t
   bool keyids_found = false;
 
   for (int i = 0; i < size; ++i) {
-    if (json_str_equal(metadata_str, idx, "threshold")) {
+    if (json_lit_equal(metadata_str, idx, "threshold")) {
       ++idx;  // consume name token
 
       int32_t thr;
@@ -143,7 +176,7 @@ static inline bool parse_role(const char *metadata_str, int16_t *pos, int32_t *t
         threshold_found = true;
       }
       ++idx;  // consume threshold token
-    } else if (json_str_equal(metadata_str, idx, "keyids")) {
+    } else if (json_lit_equal(metadata_str, idx, "keyids")) {
       ++idx;  // consume name token
       if (token_pool[idx].type != JSMN_ARRAY) {
         DEBUG_PRINTF("keyids is not an array\n");
@@ -159,7 +192,10 @@ static inline bool parse_role(const char *metadata_str, int16_t *pos, int32_t *t
         crypto_key_t *key =
             find_key(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), keys, num_keys);
         if (key) {
-          out_keys[keyids_num++] = key;
+          out_keys[keyids_num] = key;
+          if (key_index_insert(out_keys, keyids_num)) {
+            ++keyids_num;
+          }
         }
         ++idx;  // consume keyid
       }
@@ -173,39 +209,120 @@ static inline bool parse_role(const char *metadata_str, int16_t *pos, int32_t *t
   return threshold_found && keyids_found;
 }
 
-static inline bool parse_roles(const char *metadata_str, int16_t *pos, uptane_root_t *root) {
-  int16_t idx = *pos;
+void uptane_root_signed_roles_begin(void) {
+  root_role_found = false;
+  targets_role_found = false;
+}
+
+bool uptane_root_signed_roles_end(void) { return root_role_found && targets_role_found; }
+
+void uptane_root_signed_role(const char *metadata_str, jsmnint_t *pos, uptane_root_t *out_root) {
+  jsmnint_t idx = *pos;
+  if (json_lit_equal(metadata_str, idx, "root")) {
+    ++idx;  // consume name token
+    root_role_found =
+        parse_role(metadata_str, &idx, &out_root->root_threshold, &out_root->root_keys_num, out_root->root_keys);
+  } else if (json_lit_equal(metadata_str, idx, "targets")) {
+    ++idx;  // consume name token
+    targets_role_found = parse_role(metadata_str, &idx, &out_root->targets_threshold, &out_root->targets_keys_num,
+                                    out_root->targets_keys);
+  } else {
+    // ignore the other roles
+    ++idx;                              //  consume name token
+    idx = consume_recursive_json(idx);  // consume value
+  }
+  *pos = idx;
+}
+
+static inline bool parse_roles(const char *metadata_str, jsmnint_t *pos, uptane_root_t *root) {
+  jsmnint_t idx = *pos;
   if (token_pool[idx].type != JSMN_OBJECT) {
     DEBUG_PRINTF("Object expected\n");
     return false;
   }
-  int16_t size = token_pool[idx].size;
+  jsmnint_t size = token_pool[idx].size;
   ++idx;  // consume object token
 
-  bool root_found = false;
-  bool targets_found = false;
-
+  uptane_root_signed_roles_begin();
   for (int i = 0; i < size; ++i) {
-    if (json_str_equal(metadata_str, idx, "root")) {
-      ++idx;  // consume name token
-      root_found = parse_role(metadata_str, &idx, &root->root_threshold, &root->root_keys_num, root->root_keys);
-    } else if (json_str_equal(metadata_str, idx, "targets")) {
-      ++idx;  // consume name token
-      targets_found =
-          parse_role(metadata_str, &idx, &root->targets_threshold, &root->targets_keys_num, root->targets_keys);
-    } else {
-      // ignore the other roles
-      ++idx;                              //  consume name token
-      idx = consume_recursive_json(idx);  // consume value
+    uptane_root_signed_role(metadata_str, &idx, root);
+  }
+
+  *pos = idx;
+  return uptane_root_signed_roles_end();
+}
+
+void uptane_root_signed_keys_begin(void) { num_keys = 0; }
+
+bool uptane_root_signed_key(const char *metadata_str, jsmnint_t *pos) {
+  if (!parse_key(metadata_str, pos)) {
+    DEBUG_PRINTF("Failed to parse keys\n");
+    free_keys();
+    return false;
+  }
+  return true;
+}
+
+bool uptane_root_signed_member(const char *metadata_str, jsmnint_t *pos, uptane_root_t *out_root) {
+  jsmnint_t idx = *pos;
+  if (json_lit_equal(metadata_str, idx, "_type")) {
+    ++idx;  //  consume name token
+
+    if (!json_lit_equal(metadata_str, idx, "Root")) {
+      DEBUG_PRINTF("Wrong type of root metadata: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
+                   metadata_str + token_pool[idx].start);
+      return false;
+    }
+    ++idx;
+  } else if (json_lit_equal(metadata_str, idx, "expires")) {
+    ++idx;  //  consume name token
+
+    uptane_time_t expires;
+    if (!str2time(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &expires)) {
+      DEBUG_PRINTF("Invalid expiration date: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
+                   metadata_str + token_pool[idx].start);
+      return false;
+    }
+    out_root->expires = expires;
+    ++idx;
+  } else if (json_lit_equal(metadata_str, idx, "version")) {
+    ++idx;  //  consume name token
+    int32_t version_tmp;
+    if (!dec2int(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &version_tmp)) {
+      DEBUG_PRINTF("Invalid version: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]), metadata_str + token_pool[idx].start);
+      return false;
+    }
+    out_root->version = version_tmp;
+    ++idx;  // consume value token
+  } else if (json_lit_equal(metadata_str, idx, "keys")) {
+    ++idx;  //  consume name token
+    uptane_root_signed_keys_begin();
+    if (!parse_keys(metadata_str, &idx)) {
+      DEBUG_PRINTF("Failed to parse keys\n");
+
+      // clean-up after parse_keys
+      free_keys();
+      return false;
+    }
+  } else if (json_lit_equal(metadata_str, idx, "roles")) {
+    ++idx;  //  consume name token
+    if (!parse_roles(metadata_str, &idx, out_root)) {
+      DEBUG_PRINTF("Failed to parse roles\n");
+      return false;
     }
+  } else {
+    DEBUG_PRINTF("Unknown field in a root metadata: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
+                 metadata_str + token_pool[idx].start);
+    ++idx;                              //  consume name token
+    idx = consume_recursive_json(idx);  // consume value
   }
 
   *pos = idx;
-  return root_found && targets_found;
+  return true;
 }
 
-bool uptane_parse_root_signed(const char *metadata_str, int16_t *pos, uptane_root_t *out_root) {
-  int16_t idx = *pos;
+bool uptane_parse_root_signed(const char *metadata_str, jsmnint_t *pos, uptane_root_t *out_root) {
+  jsmnint_t idx = *pos;
   if (token_pool[idx].type != JSMN_OBJECT) {
     DEBUG_PRINTF("Object expected\n");
     return false;
@@ -213,59 +330,9 @@ bool uptane_parse_root_signed(const char *metadata_str, int16_t *pos, uptane_roo
   int size = token_pool[idx].size;
   ++idx;  // consume object token
 
-  for (int16_t i = 0; i < size; ++i) {
-    if (json_str_equal(metadata_str, idx, "_type")) {
-      ++idx;  //  consume name token
-
-      if (!json_str_equal(metadata_str, idx, "Root")) {
-        DEBUG_PRINTF("Wrong type of root metadata: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                     metadata_str + token_pool[idx].start);
-        return false;
-      }
-      ++idx;
-    } else if (json_str_equal(metadata_str, idx, "expires")) {
-      ++idx;  //  consume name token
-
-      uptane_time_t expires;
-      if (!str2time(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &expires)) {
-        DEBUG_PRINTF("Invalid expiration date: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                     metadata_str + token_pool[idx].start);
-        return false;
-      }
-      out_root->expires = expires;
-      ++idx;
-    } else if (json_str_equal(metadata_str, idx, "version")) {
-      ++idx;  //  consume name token
-      int32_t version_tmp;
-      if (!dec2int(metadata_str + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &version_tmp)) {
-        DEBUG_PRINTF("Invalid version: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                     metadata_str + token_pool[idx].start);
-        return false;
-      }
-      out_root->version = version_tmp;
-      ++idx;  // consume value token
-    } else if (json_str_equal(metadata_str, idx, "keys")) {
-      ++idx;  //  consume name token
-      if (!parse_keys(metadata_str, &idx)) {
-        DEBUG_PRINTF("Failed to parse keys\n");
-
-        // clean-up after parse_keys
-        for (int j = 0; j < num_keys; j++) {
-          free_crypto_key(keys[j]);
-        }
-        return false;
-      }
-    } else if (json_str_equal(metadata_str, idx, "roles")) {
-      ++idx;  //  consume name token
-      if (!parse_roles(metadata_str, &idx, out_root)) {
-        DEBUG_PRINTF("Failed to parse roles\n");
-        return false;
-      }
-    } else {
-      DEBUG_PRINTF("Unknown field in a root metadata: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                   metadata_str + token_pool[idx].start);
-      ++idx;                              //  consume name token
-      idx = consume_recursive_json(idx);  // consume value
+  for (jsmnint_t i = 0; i < size; ++i) {
+    if (!uptane_root_signed_member(metadata_str, &idx, out_root)) {
+      return false;
     }
   }
 
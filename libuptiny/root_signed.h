@@ -1,13 +1,38 @@
 #ifndef LIBUPTINY_ROOT_SIGNED_H
 #define LIBUPTINY_ROOT_SIGNED_H
 
+#include "jsmn.h"
 #include "state_api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-bool uptane_parse_root_signed(const char *metadata_str, int16_t *pos, uptane_root_t *out_root);
+bool uptane_parse_root_signed(const char *metadata_str, jsmnint_t *pos, uptane_root_t *out_root);
+
+/* Piecewise interface for parsers that never hold the whole signed object, see uptane_parse_root_feed. Each call gets
+ * the tokens of a single member of the respective object, starting with its name at *pos, and moves *pos past it.
+ *
+ * uptane_root_signed_member handles a member of the signed object itself. uptane_root_signed_key handles one entry
+ * of "keys", after uptane_root_signed_keys_begin; on failure all the keys read so far are freed.
+ * uptane_root_signed_role handles one entry of "roles", after uptane_root_signed_roles_begin;
+ * uptane_root_signed_roles_end tells if both "root" and "targets" were found valid.
+ */
+bool uptane_root_signed_member(const char *metadata_str, jsmnint_t *pos, uptane_root_t *out_root);
+void uptane_root_signed_keys_begin(void);
+bool uptane_root_signed_key(const char *metadata_str, jsmnint_t *pos);
+void uptane_root_signed_roles_begin(void);
+void uptane_root_signed_role(const char *metadata_str, jsmnint_t *pos, uptane_root_t *out_root);
+bool uptane_root_signed_roles_end(void);
+
+/* Keys of a root chain, see uptane_root_chain_begin. uptane_root_chain_key returns the key of the last root of the
+ * chain with the ID, type and value of key, NULL if there is none or no chain. uptane_root_stored_key does the same
+ * for the stored root, whose key is shared with share_crypto_key rather than prepared again. uptane_root_chain_owns
+ * tells if a key belongs to the stored root or a root of the chain, and must not be freed.
+ */
+crypto_key_t *uptane_root_chain_key(const crypto_key_t *key);
+crypto_key_t *uptane_root_stored_key(const crypto_key_t *key);
+bool uptane_root_chain_owns(const crypto_key_t *key);
 
 #ifdef __cplusplus
 }
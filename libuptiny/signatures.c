@@ -1,110 +1,154 @@
 #include "signatures.h"
 #include "base64.h"
+#include "common_data_api.h"
 #include "crypto_common.h"
 #include "debug.h"
 #include "jsmn.h"
 #include "json_common.h"
+#include "stats.h"
 #include "utils.h"
 
-extern jsmntok_t token_pool[];
-extern const unsigned int token_pool_size;
+// the keys a role's signatures may be made with
+typedef struct {
+  crypto_key_t **keys;
+  int num;
+  int threshold;
+} meta_keys_t;
 
-crypto_key_t **meta_keys;
-int meta_keys_num;
+// The signature is only decoded if it is by a known key none of the taken signatures is by, a repeated key would make
+// the threshold with one key and costs a verification for nothing
+static inline int parse_sig(const jsmntok_t *tokens, jsmnint_t num_tokens, const meta_keys_t *meta_keys,
+                            const char *json_sig, jsmnint_t *pos, crypto_key_and_signature_t *sig,
+                            const crypto_key_and_signature_t *taken, unsigned int num_taken) {
+  jsmnint_t idx = *pos;
 
-static inline int parse_sig(const char *json_sig, int16_t *pos, crypto_key_and_signature_t *sig) {
-  int16_t idx = *pos;
-
-  if (token_pool[idx].type != JSMN_OBJECT) {
+  if (tokens[idx].type != JSMN_OBJECT) {
     DEBUG_PRINTF("Object expected\n");
     return -1;
   }
-  int size = token_pool[idx].size;
+  int size = tokens[idx].size;
   ++idx;  // consume object token
 
-  bool key_found = false;
-  bool sig_found = false;
-  uint8_t sig_buf[CRYPTO_MAX_SIGNATURE_LEN + 2];  // '+2' because base64 operates in 3 byte granularity
+  const crypto_key_t *key = NULL;
+  jsmnint_t sig_idx = 0;  // token of the signature string, 0 if there is none
   for (int i = 0; i < size; ++i) {
-    if (json_str_equal(json_sig, idx, "keyid")) {
+    if (json_tok_lit_equal(tokens, json_sig, idx, "keyid")) {
       ++idx;  //  consume name token
-      if (token_pool[idx].type != JSMN_STRING) {
+      if (tokens[idx].type != JSMN_STRING) {
         DEBUG_PRINTF("Key ID is not a string\n");
-        idx = consume_recursive_json(idx);
+        idx = json_consume_recursive(tokens, num_tokens, idx);
       } else {
-        const crypto_key_t *key = find_key(json_sig + token_pool[idx].start,
-                                           token_pool[idx].end - token_pool[idx].start, meta_keys, meta_keys_num);
-        if (key) {
-          sig->key = key;
-          key_found = true;
-        }
+        key = find_key(json_sig + tokens[idx].start, tokens[idx].end - tokens[idx].start, meta_keys->keys,
+                       meta_keys->num);
         ++idx;  // consume key
       }
-    } else if (json_str_equal(json_sig, idx, "method")) {
+    } else if (json_tok_lit_equal(tokens, json_sig, idx, "method")) {
       // method is ignored for now
-      ++idx;                              //  consume name token
-      idx = consume_recursive_json(idx);  // consume value
-    } else if (json_str_equal(json_sig, idx, "sig")) {
+      ++idx;                                                  //  consume name token
+      idx = json_consume_recursive(tokens, num_tokens, idx);  // consume value
+    } else if (json_tok_lit_equal(tokens, json_sig, idx, "sig")) {
       ++idx;  //  consume name token
-      if (token_pool[idx].type != JSMN_STRING) {
+      if (tokens[idx].type != JSMN_STRING) {
         DEBUG_PRINTF("Signature is not a string\n");
-        idx = consume_recursive_json(idx);
+        idx = json_consume_recursive(tokens, num_tokens, idx);
       } else {
-        int b64_len = JSON_TOK_LEN(token_pool[idx]);
-        if (b64_len > 0 && BASE64_DECODED_BUF_SIZE(b64_len) <= CRYPTO_MAX_SIGNATURE_LEN + 2) {
-          if (CRYPTO_MAX_SIGNATURE_LEN ==
-              base64_decode(json_sig + token_pool[idx].start, (unsigned int)b64_len, sig_buf)) {
-            memcpy(sig->sig, sig_buf, CRYPTO_MAX_SIGNATURE_LEN);
-            sig_found = true;
-          } else {
-            DEBUG_PRINTF("Unexpected signature size\n");
-          }
-        } else {
-          DEBUG_PRINTF("Signature is too large\n");
-        }
+        sig_idx = idx;
         ++idx;  // consume signature
       }
     } else {
-      DEBUG_PRINTF("Unknown field in a signature: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                   json_sig + token_pool[idx].start);
-      ++idx;                              //  consume name token
-      idx = consume_recursive_json(idx);  // consume value
+      DEBUG_PRINTF("Unknown field in a signature: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]), json_sig + tokens[idx].start);
+      ++idx;                                                  //  consume name token
+      idx = json_consume_recursive(tokens, num_tokens, idx);  // consume value
     }
   }
 
   *pos = idx;
-  return (sig_found && key_found);
+  if (!key || !sig_idx) {
+    return 0;
+  }
+  if (uptane_signatures_have_key(taken, num_taken, key)) {
+    DEBUG_PRINTF("Another signature by the same key, ignored\n");
+    return 0;
+  }
+
+  uint8_t sig_buf[CRYPTO_MAX_SIGNATURE_LEN + 2];  // '+2' because base64 operates in 3 byte granularity
+  int b64_len = JSON_TOK_LEN(tokens[sig_idx]);
+  if (b64_len <= 0 || BASE64_DECODED_BUF_SIZE(b64_len) > CRYPTO_MAX_SIGNATURE_LEN + 2) {
+    DEBUG_PRINTF("Signature is too large\n");
+    return 0;
+  }
+  if (CRYPTO_MAX_SIGNATURE_LEN != base64_decode(json_sig + tokens[sig_idx].start, (unsigned int)b64_len, sig_buf)) {
+    DEBUG_PRINTF("Unexpected signature size\n");
+    return 0;
+  }
+  sig->key = key;
+  memcpy(sig->sig, sig_buf, CRYPTO_MAX_SIGNATURE_LEN);
+  return 1;
 }
 
-int uptane_parse_signatures(uptane_role_t role, const char *signatures, int16_t *pos,
-                            crypto_key_and_signature_t *output, unsigned int max_sigs, uptane_root_t *in_root) {
+bool uptane_signatures_have_key(const crypto_key_and_signature_t *sigs, unsigned int num_sigs, const crypto_key_t *key) {
+  for (unsigned int i = 0; i < num_sigs; ++i) {
+    if (sigs[i].key == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline meta_keys_t role_keys(uptane_role_t role, uptane_root_t *in_root) {
+  meta_keys_t meta_keys;
+
   if (role == ROLE_ROOT) {
-    meta_keys = in_root->root_keys;
-    meta_keys_num = in_root->root_keys_num;
+    meta_keys.keys = in_root->root_keys;
+    meta_keys.num = in_root->root_keys_num;
+    meta_keys.threshold = in_root->root_threshold;
   } else {  // ROLE_TARGETS
-    meta_keys = in_root->targets_keys;
-    meta_keys_num = in_root->targets_keys_num;
+    meta_keys.keys = in_root->targets_keys;
+    meta_keys.num = in_root->targets_keys_num;
+    meta_keys.threshold = in_root->targets_threshold;
   }
+  return meta_keys;
+}
+
+int uptane_parse_signature(uptane_role_t role, const char *signature, jsmnint_t *pos, crypto_key_and_signature_t *output,
+                           const crypto_key_and_signature_t *taken, unsigned int num_taken, uptane_root_t *in_root) {
+  meta_keys_t meta_keys = role_keys(role, in_root);
+  return parse_sig(token_pool, token_pool_size, &meta_keys, signature, pos, output, taken, num_taken);
+}
+
+int uptane_parse_signatures(uptane_role_t role, const char *signatures, jsmnint_t *pos,
+                            crypto_key_and_signature_t *output, unsigned int max_sigs, uptane_root_t *in_root) {
+  return uptane_parse_signatures_in(token_pool, token_pool_size, role, signatures, pos, output, max_sigs, in_root);
+}
+
+int uptane_parse_signatures_in(const jsmntok_t *tokens, jsmnint_t num_tokens, uptane_role_t role,
+                               const char *signatures, jsmnint_t *pos, crypto_key_and_signature_t *output,
+                               unsigned int max_sigs, uptane_root_t *in_root) {
+  meta_keys_t meta_keys = role_keys(role, in_root);
 
-  int16_t token_idx = *pos;
-  if (token_pool[token_idx].type != JSMN_ARRAY) {
+  jsmnint_t token_idx = *pos;
+  if (tokens[token_idx].type != JSMN_ARRAY) {
     DEBUG_PRINTF("Array expected\n");
     return -1;
   }
-  int array_size = token_pool[token_idx].size;
+  int array_size = tokens[token_idx].size;
   ++token_idx;  // Consume array token
 
   unsigned int sigs_read = 0;
+  unsigned int wanted = uptane_signatures_wanted(meta_keys.threshold);
+  if (max_sigs > wanted) {
+    max_sigs = wanted;
+  }
 
   for (int i = 0; i < array_size; ++i) {
     if (sigs_read >= max_sigs) {
-      *pos = token_idx;
-      DEBUG_PRINTF("Too many, signatures, only %d are used\n", sigs_read);
-      return (int)sigs_read;
+      DEBUG_PRINTF("Enough signatures, %d more are skipped\n", array_size - i);
+      token_idx = json_consume_recursive(tokens, num_tokens, token_idx);
+      continue;
     }
 
     DEBUG_PRINTF("Parse signature at %d\n", token_idx);
-    int res = parse_sig(signatures, &token_idx, output + sigs_read);
+    int res = parse_sig(tokens, num_tokens, &meta_keys, signatures, &token_idx, output + sigs_read, output, sigs_read);
     if (res < 0) {
       return -1;
     } else if (res != 0) {
@@ -114,3 +158,82 @@ int uptane_parse_signatures(uptane_role_t role, const char *signatures, int16_t
   *pos = token_idx;
   return (int)sigs_read;
 }
+
+static uptane_signatures_report_t signatures_report;
+static void (*verify_yield)(void);
+
+void uptane_set_verify_yield(void (*yield)(void)) { verify_yield = yield; }
+
+int uptane_verify_signatures_result(unsigned int num_signatures, int threshold) {
+  return uptane_verify_signatures_ctx(crypto_ctx_pool, num_signatures, threshold);
+}
+
+int uptane_verify_signatures_ctx(crypto_verify_ctx_t *const *ctx, unsigned int num_signatures, int threshold) {
+  unsigned int num_checked;
+  int num_valid;
+
+  crypto_verify_wait(ctx, num_signatures);
+  crypto_verify_result_start(ctx, num_signatures, threshold);
+  while (crypto_verify_result_step(UPTANE_VERIFY_SLICE) != CRYPTO_OP_DONE) {
+    if (verify_yield) {
+      verify_yield();
+    }
+  }
+  while (crypto_verify_result_poll(&num_valid, &num_checked) != CRYPTO_OP_DONE) {
+  }
+
+  signatures_report.num_signatures = (int)num_signatures;
+  signatures_report.num_checked = (int)num_checked;
+  UPTANE_STATS_COUNT(signatures_verified, num_checked);
+  UPTANE_STATS_COUNT(signatures_skipped, num_signatures - num_checked);
+  signatures_report.num_valid = num_valid;
+  signatures_report.threshold = threshold;
+
+  if (num_checked < num_signatures) {
+    DEBUG_PRINTF("Checked %u of %u signatures, %d valid with threshold of %d\n", num_checked, num_signatures,
+                 num_valid, threshold);
+  }
+  return num_valid;
+}
+
+// finishes the verification in ctx in slices like uptane_verify_signatures_ctx, true if the signature is valid
+static bool verify_one(crypto_verify_ctx_t *ctx) {
+  unsigned int num_checked;
+  int num_valid;
+
+  crypto_verify_result_start(&ctx, 1, 1);
+  while (crypto_verify_result_step(UPTANE_VERIFY_SLICE) != CRYPTO_OP_DONE) {
+    if (verify_yield) {
+      verify_yield();
+    }
+  }
+  while (crypto_verify_result_poll(&num_valid, &num_checked) != CRYPTO_OP_DONE) {
+  }
+  return num_valid == 1;
+}
+
+int uptane_verify_signatures_buffered(crypto_verify_ctx_t *ctx, crypto_key_and_signature_t *sigs,
+                                      unsigned int num_signatures, int threshold, const uint8_t *data, size_t len) {
+  unsigned int num_checked = 0;
+  int num_valid = 0;
+
+  while (num_checked < num_signatures && num_valid < threshold &&
+         num_valid + (int)(num_signatures - num_checked) >= threshold) {
+    crypto_verify_init(ctx, &sigs[num_checked]);
+    crypto_verify_feed(ctx, data, len);
+    if (verify_one(ctx)) {
+      ++num_valid;
+    }
+    ++num_checked;
+  }
+
+  signatures_report.num_signatures = (int)num_signatures;
+  signatures_report.num_checked = (int)num_checked;
+  UPTANE_STATS_COUNT(signatures_verified, num_checked);
+  UPTANE_STATS_COUNT(signatures_skipped, num_signatures - num_checked);
+  signatures_report.num_valid = num_valid;
+  signatures_report.threshold = threshold;
+  return num_valid;
+}
+
+const uptane_signatures_report_t *uptane_get_signatures_report(void) { return &signatures_report; }
@@ -2,15 +2,76 @@
 #define LIBUPTINY_SIGNATURES_H
 
 #include "crypto_api.h"
+#include "jsmn.h"
 #include "state_api.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-int uptane_parse_signatures(uptane_role_t role, const char *signatures, int16_t *pos,
+/* Signatures are taken in the order they come, at most one by each key of the role and no more than the threshold (at
+ * least one) and UPTANE_SIGNATURES_EXTRA, the spares for signatures that turn out to be invalid. The rest are skipped
+ * without being decoded, so the signatures that get verified are bounded by the keys in the root however many the
+ * metadata repeats.
+ */
+#ifndef UPTANE_SIGNATURES_EXTRA
+#define UPTANE_SIGNATURES_EXTRA 1
+#endif
+
+static inline unsigned int uptane_signatures_wanted(int threshold) {
+  return ((threshold > 1) ? (unsigned int)threshold : 1u) + UPTANE_SIGNATURES_EXTRA;
+}
+
+/* If one of the num_sigs signatures at sigs is by key. Keys are compared by address, the entries of the root's key
+ * arrays are unique. */
+bool uptane_signatures_have_key(const crypto_key_and_signature_t *sigs, unsigned int num_sigs, const crypto_key_t *key);
+
+int uptane_parse_signatures(uptane_role_t role, const char *signatures, jsmnint_t *pos,
                             crypto_key_and_signature_t *output, unsigned int max_sigs, uptane_root_t *in_root);
 
+/* Same with the tokens in tokens[0, num_tokens) instead of token_pool */
+int uptane_parse_signatures_in(const jsmntok_t *tokens, jsmnint_t num_tokens, uptane_role_t role,
+                               const char *signatures, jsmnint_t *pos, crypto_key_and_signature_t *output,
+                               unsigned int max_sigs, uptane_root_t *in_root);
+
+/* Parse the single signature object at *pos. Returns 1 if it is by a known key of the role that none of the num_taken
+ * signatures at taken is by, 0 if it is not usable and -1 on malformed input. */
+int uptane_parse_signature(uptane_role_t role, const char *signature, jsmnint_t *pos, crypto_key_and_signature_t *output,
+                           const crypto_key_and_signature_t *taken, unsigned int num_taken, uptane_root_t *in_root);
+
+/* Outcome of the last signature threshold check, for diagnostics */
+typedef struct {
+  int num_signatures;  // signatures by known keys
+  int num_checked;     // signatures actually verified before the threshold was met or became unreachable
+  int num_valid;
+  int threshold;
+} uptane_signatures_report_t;
+
+/* Finish verification of the first num_signatures contexts in crypto_ctx_pool, stopping as soon as the threshold is
+ * met or can no longer be met. Returns the number of valid signatures found.
+ */
+int uptane_verify_signatures_result(unsigned int num_signatures, int threshold);
+/* Same for an arbitrary list of contexts */
+int uptane_verify_signatures_ctx(crypto_verify_ctx_t *const *ctx, unsigned int num_signatures, int threshold);
+const uptane_signatures_report_t *uptane_get_signatures_report(void);
+
+/* Same for signed data that is in memory as a whole: the signatures are checked one after another, each hashing data
+ * in ctx, instead of in a context per signature hashing alongside the parser. Uses one context in place of as many as
+ * there are signatures, for devices short of RAM rather than of time.
+ */
+int uptane_verify_signatures_buffered(crypto_verify_ctx_t *ctx, crypto_key_and_signature_t *sigs,
+                                      unsigned int num_signatures, int threshold, const uint8_t *data, size_t len);
+
+/* Signatures are checked in slices of UPTANE_VERIFY_SLICE steps of crypto_verify_result_step. The hook set here is
+ * called between slices, so that a cooperative main loop can keep servicing the bus while uptane_parse_root or
+ * uptane_parse_targets_feed checks signatures. It must not call back into libuptiny. NULL removes it.
+ */
+#ifndef UPTANE_VERIFY_SLICE
+#define UPTANE_VERIFY_SLICE 16
+#endif
+
+void uptane_set_verify_yield(void (*yield)(void));
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,33 @@
+#include "stack_peak.h"
+
+/* Painting starts this far below the frame of uptane_stack_paint(), which is about where the frames of the operation
+ * start, to leave alone its own locals */
+#define STACK_PAINT_GUARD 64
+
+static volatile uint8_t* stack_top;
+static size_t stack_size;
+
+/* Not inlined, so that the frame is the callee's, and not checked by AddressSanitizer, as it goes below the stack
+ * pointer */
+#define STACK_NO_SANITIZE __attribute__((noinline, no_sanitize_address))
+
+STACK_NO_SANITIZE void uptane_stack_paint(size_t size) {
+  volatile uint8_t* p;
+
+  stack_top = (volatile uint8_t*)__builtin_frame_address(0) - STACK_PAINT_GUARD;
+  stack_size = size;
+  for (p = stack_top - size; p < stack_top; ++p) {
+    *p = UPTANE_STACK_PATTERN;
+  }
+}
+
+STACK_NO_SANITIZE size_t uptane_stack_peak(void) {
+  volatile uint8_t* p;
+
+  for (p = stack_top - stack_size; p < stack_top; ++p) {
+    if (*p != UPTANE_STACK_PATTERN) {
+      return (size_t)(stack_top - p);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef LIBUPTINY_STACK_PEAK_H_
+#define LIBUPTINY_STACK_PEAK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Stack high-water mark of an operation, to size the stack of an ECU. uptane_stack_paint() fills size bytes below the
+ * frame of its caller with UPTANE_STACK_PATTERN, the operation is then called from the same function, and
+ * uptane_stack_peak() tells how deep into the painted bytes it has reached:
+ *
+ *   uptane_stack_paint(4096);
+ *   uptane_parse_root(metadata, len, &root);
+ *   peak = uptane_stack_peak();
+ *
+ * The stack has to grow down and have size bytes to spare below the caller. The result is exact up to the few words of
+ * the paint call itself, and may come out short by the bytes at the very bottom that happen to hold the pattern.
+ */
+#define UPTANE_STACK_PATTERN 0xA5u
+
+void uptane_stack_paint(size_t size);
+/* Bytes of stack used since the paint, 0 if the painted bytes are untouched, size if all of them have been used and the
+ * operation may have gone deeper */
+size_t uptane_stack_peak(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_STACK_PEAK_H_
@@ -14,8 +14,7 @@ extern "C" {
 
 typedef enum { ROLE_ROOT, ROLE_TARGETS } uptane_role_t;
 
-#define ROOT_MAX_KEYS 16
-
+/* root_keys and targets_keys are kept sorted by key ID, see find_key() */
 typedef struct {
   int32_t version;
   uptane_time_t expires;
@@ -27,8 +26,12 @@ typedef struct {
   crypto_key_t* targets_keys[ROOT_MAX_KEYS];
 } uptane_root_t;
 
+#if UPTINY_TARGETS_ONE_HASH
+#define TARGETS_MAX_HASHES 1
+#else
 #define TARGETS_MAX_HASHES 2
-#define TARGETS_MAX_NAME_LENGTH 63
+#endif
+#define TARGETS_MAX_PARTITION_LENGTH 15
 /* Does not represent the whole targets metadata, only what's needed for this ECU */
 typedef struct {
   int version;
@@ -37,6 +40,20 @@ typedef struct {
   int hashes_num;
   crypto_hash_t hashes[TARGETS_MAX_HASHES];
   uint32_t length;
+  /* Non-zero if the target is a delta of that many bytes against the installed image with hash delta_base. hashes
+   * and length are the ones of the image it rebuilds. */
+  uint32_t delta_length;
+  crypto_hash_t delta_base;
+  /* Non-zero if the target is sent compressed with heatshrink, as that many bytes. They decompress to the delta if
+   * there is one, to the image otherwise. */
+  uint32_t compressed_length;
+  /* Non-zero if the target is sent in chunks of that many bytes, each one verified against the hash tree with root
+   * chunk_root before it is used, see chunks.h */
+  uint32_t chunk_size;
+  crypto_hash_t chunk_root;
+  /* The "partition" of the target's custom, empty if it has none. Tells the images of an ECU apart, see
+   * uptane_targets_ctx_init_images() */
+  char partition[TARGETS_MAX_PARTITION_LENGTH + 1];
 } uptane_targets_t;
 
 typedef enum {
@@ -57,9 +74,20 @@ typedef struct {
   char firmware_name[TARGETS_MAX_NAME_LENGTH + 1];
   crypto_hash_t firmware_hash;
   uint32_t firmware_length;
+  uint32_t image_crc; /* CRC-32 of the installed image, checked at boot instead of the hash */
   uptane_attack_t attack;
 } uptane_installation_state_t;
 
+/* Where an interrupted image transfer can continue */
+typedef struct {
+  crypto_hash_t target_hash; /* identifies the target, it is the one the image is checked with */
+  uint32_t offset;           /* bytes received */
+  uint32_t chunks;           /* chunks received, for transports that number them */
+  uint32_t image_fed;        /* bytes of the image hashed, the same as offset unless it is sent encoded */
+  uint32_t image_crc;        /* of the bytes hashed */
+  crypto_hash_checkpoint_t image_hash;
+} uptane_transfer_checkpoint_t;
+
 void state_init(void);
 uptane_root_t* state_get_root(void);
 void state_set_root(const uptane_root_t* root);
@@ -71,10 +99,18 @@ uptane_installation_state_t* state_get_installation_state(void);
 void state_set_installation_state(const uptane_installation_state_t* state);
 void state_set_attack(uptane_attack_t attack);
 
+/* NULL if there is no checkpoint, setting NULL removes it. Should survive a reset like the installation state. */
+const uptane_transfer_checkpoint_t* state_get_transfer_checkpoint(void);
+void state_set_transfer_checkpoint(const uptane_transfer_checkpoint_t* checkpoint);
+
 const char* state_get_ecuid(void);
 const char* state_get_hwid(void);
+/* Lengths of the strings above, so that the parser doesn't measure them for every target */
+size_t state_get_ecuid_len(void);
+size_t state_get_hwid_len(void);
 void state_get_device_key(const crypto_key_t** pub, const uint8_t** priv);
 
+/* Hash to check images with when the metadata lists it */
 crypto_hash_algorithm_t state_get_supported_hash(void);
 
 #ifdef __cplusplus
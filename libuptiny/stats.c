@@ -0,0 +1,11 @@
+#include "stats.h"
+
+#include <string.h>
+
+#ifdef UPTANE_STATS
+uptane_stats_t uptane_stats;
+
+const uptane_stats_t* uptane_stats_get(void) { return &uptane_stats; }
+
+void uptane_stats_reset(void) { memset(&uptane_stats, 0, sizeof(uptane_stats)); }
+#endif
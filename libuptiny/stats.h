@@ -0,0 +1,67 @@
+#ifndef LIBUPTINY_STATS_H_
+#define LIBUPTINY_STATS_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The work of the parsers and verifiers since the last reset, to see where the time of a verification goes. Counted
+ * with UPTANE_STATS, and reported in the manifest under "diagnostics". The counters wrap around.
+ */
+typedef struct {
+  uint32_t bytes_fed;            // to the root and targets feeds, the unconsumed tails fed again included
+  uint32_t tokens;               // made by jsmn_parse()
+  uint32_t subtrees_skipped;     // objects and arrays skipped without tokenizing them, targets for other ECUs included
+  uint32_t targets_inspected;    // targets looked at, whether for this ECU or not
+  uint32_t hex_decoded;          // hex characters decoded
+  uint32_t base64_decoded;       // base64 characters decoded
+  uint32_t signatures_verified;  // checked by the crypto backend
+  uint32_t signatures_skipped;   // not checked: the threshold was decided without them, or the targets were cached
+  uint32_t sha512_blocks;        // of the hashes the crypto backend finished, those of signatures included
+  uint32_t key_cache_hits;       // verifications with a key decompressed by crypto_key_prepare(), CRYPTO_KEY_CACHE
+  uint32_t targets_cache_hits;   // targets metadata whose signatures weren't checked again, UPTINY_TARGETS_CACHE
+} uptane_stats_t;
+
+/* Boundaries of the stages of an update. With UPTANE_STATS_STAGES the platform provides uptane_stats_stage(), which
+ * is called at each one, e.g. to take a timestamp. */
+#define UPTANE_STAGE_ROOT_BEGIN 0      // uptane_parse_root_init()
+#define UPTANE_STAGE_ROOT_SIGNED 1     // the signed part of root metadata is hashed, on each pass, signatures come next
+#define UPTANE_STAGE_ROOT_END 2        // root metadata verified
+#define UPTANE_STAGE_TARGETS_BEGIN 3   // a targets context initialized
+#define UPTANE_STAGE_TARGETS_SIGNED 4  // the same for targets metadata
+#define UPTANE_STAGE_TARGETS_END 5     // the end of targets metadata found, its signatures are checked by then
+#define UPTANE_STAGE_IMAGE_BEGIN 6     // uptane_verify_firmware_init()
+#define UPTANE_STAGE_IMAGE_END 7       // uptane_verify_firmware_finalize()
+#define UPTANE_STAGES 8
+
+#ifdef UPTANE_STATS
+extern uptane_stats_t uptane_stats;
+#define UPTANE_STATS_COUNT(field, n)     \
+  do {                                   \
+    uptane_stats.field += (uint32_t)(n); \
+  } while (0)
+/* The counters as they are */
+const uptane_stats_t* uptane_stats_get(void);
+void uptane_stats_reset(void);
+#else
+#define UPTANE_STATS_COUNT(field, n) \
+  do {                               \
+  } while (0)
+#endif
+
+#ifdef UPTANE_STATS_STAGES
+void uptane_stats_stage(uint8_t stage);
+#define UPTANE_STATS_STAGE(stage) uptane_stats_stage(stage)
+#else
+#define UPTANE_STATS_STAGE(stage) \
+  do {                            \
+  } while (0)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_STATS_H_
@@ -2,69 +2,161 @@
 
 #include "common_data_api.h"
 #include "crypto_api.h"
+#include "crypto_common.h"
 #include "debug.h"
 #include "json_common.h"
+#include "pool.h"
 #include "signatures.h"
 #include "state_api.h"
+#include "stats.h"
+#include "trace.h"
 #include "utils.h"
 
-/*
- * State variables, initialized in uptane_parse_targets_init()
- */
-static jsmn_parser parser;             // jsmn parser
-static int16_t token_pos;              // current position in jsmn token array
-static int16_t ignored_top_token_pos;  // position of ignored object token in jsmn token array
-static int16_t signed_top_token_pos;   // position of "signed" object token in jsmn token array
-static int16_t targets_top_token_pos;  // position of "signed"."targets" object token in jsmn token array
+// the context of the functions without one, set up with the pools of common_data_api.h on first use
+static uptane_targets_ctx_t default_ctx;
+
+static uptane_targets_ctx_t *default_context(void) {
+  if (default_ctx.tokens == NULL) {
+    default_ctx.tokens = token_pool;
+    default_ctx.num_tokens = token_pool_size;
+    default_ctx.signatures = signature_pool;
+    default_ctx.max_signatures = signature_pool_size;
+    default_ctx.verify_ctxs = crypto_ctx_pool;
+    default_ctx.num_verify_ctxs = crypto_ctx_pool_size;
+    default_ctx.hash = &hash_context;
+  }
+  return &default_ctx;
+}
 
-typedef enum {
-  TARGETS_BEGIN,          // initial state
-  TARGETS_IN_TOP,         // pointer in the top object (above "signatures" and "signed")
-  TARGETS_IN_SIGNATURES,  // pointer in the "signatures" object
-  TARGETS_BEFORE_SIGNED,  // pointer consumed "signed" object name and waits for the object
-  TARGETS_IN_SIGNED,      // pointer in the "signed" object
-  TARGETS_IN_IGNORED,     // pointer inside ignored object/array
-  TARGETS_IN_TARGETS,     // pointer inside "signed"."targets" object
-  TARGETS_IN_ERROR        // encountered an error, sink state
-} parsing_state_t;
+static inline uptane_root_t *root_of(const uptane_targets_ctx_t *ctx) {
+  return (ctx->root != NULL) ? ctx->root : state_get_root();
+}
 
-static parsing_state_t state;
-static parsing_state_t prev_state;  // state to return to from TARGETS_IN_IGNORED
+static inline jsmnint_t consume(const uptane_targets_ctx_t *ctx, jsmnint_t idx) {
+  return json_consume_recursive(ctx->tokens, ctx->num_tokens, idx);
+}
 
-static bool target_found;  // found a target for this ECU
+static void init_parser(uptane_targets_ctx_t *ctx) {
+  jsmn_init(&ctx->parser);
+  jsmn_init(&ctx->pending_scan);
+  ctx->token_pos = 0;
+  ctx->ignored_top_token_pos = 0;
+  ctx->signed_top_token_pos = -1;
+  ctx->targets_top_token_pos = -1;
+  ctx->targets_top_token_pos = -1;
+  ctx->found_mask = 0;
+  ctx->images = NULL;
+  ctx->signed_elems_read = 0;
+  ctx->targets_elems_read = 0;
+  ctx->num_signatures = 0;
+  ctx->num_verifying = 0;
+  ctx->state = TARGETS_BEGIN;
+
+  ctx->begin_signed = ctx->end_signed = -1;
+
+  ctx->in_signed = false;
+  ctx->signatures_trusted = false;
+  ctx->signed_buffered = false;
+  ctx->signed_data = NULL;
+  ctx->tail_length = 0;
+  ctx->max_bytes = UPTINY_TARGETS_MAX_BYTES;
+  ctx->max_tokens = UPTINY_TARGETS_MAX_TOKENS;
+  ctx->bytes_consumed = 0;
+  ctx->tokens_used = 0;
+#ifdef UPTINY_TARGETS_CACHE
+  ctx->cache_candidate = false;
+#endif
+}
 
-static int signed_elems_read;   // number of elements of "signed" object already read
-static int targets_elems_read;  // number of elements of "signed".targets object already read
+static void use_own_ecu(uptane_targets_ctx_t *ctx) {
+  ctx->own_ecu.ecuid = state_get_ecuid();
+  ctx->own_ecu.ecuid_len = state_get_ecuid_len();
+  ctx->own_ecu.hwid = state_get_hwid();
+  ctx->own_ecu.hwid_len = state_get_hwid_len();
+  ctx->ecus = &ctx->own_ecu;
+  ctx->num_ecus = 1;
+  ctx->ecu_targets = NULL;
+  ctx->ecu_found = NULL;
+}
 
-/*
- * Values to be returned via getters
- */
-static unsigned int num_signatures;  // number of signatures read
-static int16_t begin_signed;         // position in incoming message part where signed object begins
-static int16_t end_signed;           // position in incoming message part where signed object ends
-
-bool in_signed;  // if the signature verification is in progress. Different from 'state == TARGETS_IN_SIGNED' in that
-                 // the state machine operates independently of signature verification and the two values can be out of
-                 // sync for a short time.
-static int16_t tail_length;  // number of bytes fed, but not consumed on the last call. Used for signature verification
-
-void uptane_parse_targets_init(void) {
-  jsmn_init(&parser);
-  token_pos = 0;
-  ignored_top_token_pos = 0;
-  signed_top_token_pos = -1;
-  targets_top_token_pos = -1;
-  targets_top_token_pos = -1;
-  target_found = false;
-  signed_elems_read = 0;
-  targets_elems_read = 0;
-  num_signatures = 0;
-  state = TARGETS_BEGIN;
-
-  begin_signed = end_signed = -1;
-
-  in_signed = false;
-  tail_length = 0;
+void uptane_targets_ctx_setup(uptane_targets_ctx_t *ctx, jsmntok_t *tokens, jsmnint_t num_tokens,
+                              crypto_key_and_signature_t *signatures, unsigned int max_signatures,
+                              crypto_verify_ctx_t *const *verify_ctxs, unsigned int num_verify_ctxs,
+                              crypto_hash_ctx_t *hash, uptane_root_t *root) {
+  ctx->tokens = tokens;
+  ctx->num_tokens = num_tokens;
+  ctx->signatures = signatures;
+  ctx->max_signatures = max_signatures;
+  ctx->verify_ctxs = verify_ctxs;
+  ctx->num_verify_ctxs = num_verify_ctxs;
+  ctx->hash = hash;
+  ctx->root = root;
+#ifdef UPTINY_TARGETS_CACHE
+  ctx->verified_cache.valid = false;
+#endif
+  init_parser(ctx);
+  ctx->ecus = NULL;  // own ECU on the first feed
+}
+
+void uptane_targets_ctx_init(uptane_targets_ctx_t *ctx) {
+  init_parser(ctx);
+  use_own_ecu(ctx);
+  UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_BEGIN);
+}
+
+bool uptane_targets_ctx_init_ecus(uptane_targets_ctx_t *ctx, const uptane_ecu_t *ecu_list, unsigned int num,
+                                  uptane_targets_t *targets, bool *found) {
+  if (num == 0 || num > TARGETS_MAX_ECUS) {
+    DEBUG_PRINTF("Invalid number of ECUs: %u\n", num);
+    return false;
+  }
+  init_parser(ctx);
+  ctx->ecus = ecu_list;
+  ctx->num_ecus = num;
+  ctx->ecu_targets = targets;
+  ctx->ecu_found = found;
+  for (unsigned int i = 0; i < num; ++i) {
+    found[i] = false;
+  }
+  UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_BEGIN);
+  return true;
+}
+
+void uptane_parse_targets_init(void) { uptane_targets_ctx_init(default_context()); }
+
+bool uptane_parse_targets_init_ecus(const uptane_ecu_t *ecu_list, unsigned int num, uptane_targets_t *targets,
+                                    bool *found) {
+  return uptane_targets_ctx_init_ecus(default_context(), ecu_list, num, targets, found);
+}
+
+bool uptane_targets_ctx_init_images(uptane_targets_ctx_t *ctx, uptane_targets_t *images, unsigned int max_images,
+                                    unsigned int *num_images) {
+  if (max_images == 0) {
+    DEBUG_PRINTF("No room for images\n");
+    return false;
+  }
+  init_parser(ctx);
+  use_own_ecu(ctx);
+  ctx->images = images;
+  ctx->max_images = max_images;
+  ctx->num_images = num_images;
+  *num_images = 0;
+  UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_BEGIN);
+  return true;
+}
+
+bool uptane_parse_targets_init_images(uptane_targets_t *images, unsigned int max_images, unsigned int *num_images) {
+  return uptane_targets_ctx_init_images(default_context(), images, max_images, num_images);
+}
+
+// index of the ECU whose serial is the string token at idx, or -1
+static inline int find_ecu(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t idx) {
+  for (unsigned int i = 0; i < ctx->num_ecus; ++i) {
+    if (json_tokn_equal(ctx->tokens, message, idx, ctx->ecus[i].ecuid, ctx->ecus[i].ecuid_len)) {
+      return (int)i;
+    }
+  }
+  return -1;
 }
 
 typedef enum {
@@ -74,231 +166,722 @@ typedef enum {
   PARSE_TARGET_WRONG_HW_ID,
 } parse_target_result_t;
 
-static inline parse_target_result_t parse_target(const char *message, int16_t *pos, uptane_targets_t *target) {
-  int16_t idx = *pos;
+// "delta": {"from": {alg: hash, ...}, "length": N}. *hash_token gets the token of the base hash, the one of the
+// supported algorithm if it is listed. It is decoded once the target is known to be ours.
+static inline bool parse_delta(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t *pos, uptane_targets_t *target,
+                               jsmnint_t *hash_token) {
+  jsmntok_t *tokens = ctx->tokens;
+  jsmnint_t idx = *pos;
+
+  if (tokens[idx].type != JSMN_OBJECT) {
+    DEBUG_PRINTF("Object expected\n");
+    return false;
+  }
+  int size = tokens[idx].size;
+  ++idx;  // consume object token
 
-  bool target_for_me = false;
+  crypto_hash_algorithm_t supported = state_get_supported_hash();
+  for (int i = 0; i < size; ++i) {
+    if (json_tok_lit_equal(tokens, message, idx, "from")) {
+      ++idx;  // consume name token
+      if (tokens[idx].type != JSMN_OBJECT) {
+        DEBUG_PRINTF("Object expected\n");
+        return false;
+      }
+      int from_size = tokens[idx].size;
+      ++idx;  // consume object token
 
-  if (token_pool[idx].type != JSMN_STRING) {
-    DEBUG_PRINTF("String expected\n");
-    return PARSE_TARGET_ERROR;
+      for (int j = 0; j < from_size; ++j) {
+        crypto_hash_algorithm_t alg =
+            crypto_str_to_hashtype(message + tokens[idx].start, (size_t)JSON_TOK_LEN(tokens[idx]));
+        ++idx;  // consume algorithm token
+        if (alg != CRYPTO_HASH_UNKNOWN && tokens[idx].type == JSMN_STRING &&
+            (size_t)JSON_TOK_LEN(tokens[idx]) == crypto_get_hashlen(alg) * 2 &&
+            (*hash_token == 0 || alg == supported)) {
+          target->delta_base.alg = alg;
+          *hash_token = idx;
+        }
+        idx = consume(ctx, idx);
+      }
+    } else if (json_tok_lit_equal(tokens, message, idx, "length")) {
+      ++idx;  // consume name token
+      int32_t length;
+      if (!dec2int(message + tokens[idx].start, JSON_TOK_LEN(tokens[idx]), &length) || length <= 0) {
+        DEBUG_PRINTF("Invalid delta length: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]),
+                     message + tokens[idx].start);
+        return false;
+      }
+      target->delta_length = (uint32_t)length;
+      ++idx;  // consume length token
+    } else {
+      DEBUG_PRINTF("Unknown field in a delta: %.*s\n", JSON_TOK_LEN(tokens[idx]), message + tokens[idx].start);
+      ++idx;  // consume name token
+      idx = consume(ctx, idx);
+    }
   }
 
-  int target_name_length = JSON_TOK_LEN(token_pool[idx]);
-  if (target_name_length > TARGETS_MAX_NAME_LENGTH || target_name_length <= 0) {
-    return PARSE_TARGET_ERROR;
+  if (target->delta_length == 0 || *hash_token == 0) {
+    DEBUG_PRINTF("Delta without length or base hash\n");
+    return false;
   }
+  *pos = idx;
+  return true;
+}
 
-  memcpy(target->name, message + token_pool[idx].start, (size_t)target_name_length);
-  ++idx;  // consume target name token
+// "compression": {"method": "heatshrink", "length": N}
+static inline bool parse_compression(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t *pos,
+                                     uptane_targets_t *target) {
+  jsmntok_t *tokens = ctx->tokens;
+  jsmnint_t idx = *pos;
 
-  if (token_pool[idx].type != JSMN_OBJECT) {
+  if (tokens[idx].type != JSMN_OBJECT) {
     DEBUG_PRINTF("Object expected\n");
-    return PARSE_TARGET_ERROR;
+    return false;
+  }
+  int size = tokens[idx].size;
+  ++idx;  // consume object token
+
+  bool method_found = false;
+  for (int i = 0; i < size; ++i) {
+    if (json_tok_lit_equal(tokens, message, idx, "method")) {
+      ++idx;  // consume name token
+      if (!json_tok_lit_equal(tokens, message, idx, "heatshrink")) {
+        DEBUG_PRINTF("Unsupported compression: %.*s\n", JSON_TOK_LEN(tokens[idx]), message + tokens[idx].start);
+        return false;
+      }
+      method_found = true;
+      ++idx;  // consume method token
+    } else if (json_tok_lit_equal(tokens, message, idx, "length")) {
+      ++idx;  // consume name token
+      int32_t length;
+      if (!dec2int(message + tokens[idx].start, JSON_TOK_LEN(tokens[idx]), &length) || length <= 0) {
+        DEBUG_PRINTF("Invalid compressed length: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]),
+                     message + tokens[idx].start);
+        return false;
+      }
+      target->compressed_length = (uint32_t)length;
+      ++idx;  // consume length token
+    } else {
+      DEBUG_PRINTF("Unknown field in a compression: %.*s\n", JSON_TOK_LEN(tokens[idx]),
+                   message + tokens[idx].start);
+      ++idx;  // consume name token
+      idx = consume(ctx, idx);
+    }
+  }
+
+  if (!method_found || target->compressed_length == 0) {
+    DEBUG_PRINTF("Compression without method or length\n");
+    return false;
+  }
+  *pos = idx;
+  return true;
+}
+
+// "chunks": {"size": N, "root": {alg: hash}}. *root_token gets the token of the root hash, like in parse_delta.
+static inline bool parse_chunks(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t *pos,
+                                uptane_targets_t *target, jsmnint_t *root_token) {
+  jsmntok_t *tokens = ctx->tokens;
+  jsmnint_t idx = *pos;
+
+  if (tokens[idx].type != JSMN_OBJECT) {
+    DEBUG_PRINTF("Object expected\n");
+    return false;
+  }
+  int size = tokens[idx].size;
+  ++idx;  // consume object token
+
+  crypto_hash_algorithm_t supported = state_get_supported_hash();
+  for (int i = 0; i < size; ++i) {
+    if (json_tok_lit_equal(tokens, message, idx, "root")) {
+      ++idx;  // consume name token
+      if (tokens[idx].type != JSMN_OBJECT) {
+        DEBUG_PRINTF("Object expected\n");
+        return false;
+      }
+      int root_size = tokens[idx].size;
+      ++idx;  // consume object token
+
+      for (int j = 0; j < root_size; ++j) {
+        crypto_hash_algorithm_t alg =
+            crypto_str_to_hashtype(message + tokens[idx].start, (size_t)JSON_TOK_LEN(tokens[idx]));
+        ++idx;  // consume algorithm token
+        if (alg != CRYPTO_HASH_UNKNOWN && tokens[idx].type == JSMN_STRING &&
+            (size_t)JSON_TOK_LEN(tokens[idx]) == crypto_get_hashlen(alg) * 2 &&
+            (*root_token == 0 || alg == supported)) {
+          target->chunk_root.alg = alg;
+          *root_token = idx;
+        }
+        idx = consume(ctx, idx);
+      }
+    } else if (json_tok_lit_equal(tokens, message, idx, "size")) {
+      ++idx;  // consume name token
+      int32_t chunk_size;
+      if (!dec2int(message + tokens[idx].start, JSON_TOK_LEN(tokens[idx]), &chunk_size) || chunk_size <= 0) {
+        DEBUG_PRINTF("Invalid chunk size: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]),
+                     message + tokens[idx].start);
+        return false;
+      }
+      target->chunk_size = (uint32_t)chunk_size;
+      ++idx;  // consume size token
+    } else {
+      DEBUG_PRINTF("Unknown field in chunks: %.*s\n", JSON_TOK_LEN(tokens[idx]), message + tokens[idx].start);
+      ++idx;  // consume name token
+      idx = consume(ctx, idx);
+    }
   }
-  int size = token_pool[idx].size;
+
+  if (target->chunk_size == 0 || *root_token == 0) {
+    DEBUG_PRINTF("Chunks without size or root hash\n");
+    return false;
+  }
+  *pos = idx;
+  return true;
+}
+
+// *for_ecus gets a bit for each of our ECUs in "custom"."ecuIdentifiers" of the target object at idx. Nothing else of
+// the target is looked at, a target for other ECUs is dropped like one the raw pre-scan skips
+static inline parse_target_result_t target_ecus(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t idx,
+                                                uint32_t *for_ecus) {
+  jsmntok_t *tokens = ctx->tokens;
+
+  *for_ecus = 0;
+  int size = tokens[idx].size;
   ++idx;  // consume object token
 
   for (int i = 0; i < size; ++i) {
-    if (json_str_equal(message, idx, "custom")) {
+    if (!json_tok_lit_equal(tokens, message, idx, "custom")) {
       ++idx;  // consume name token
-      if (token_pool[idx].type != JSMN_OBJECT) {
+      idx = consume(ctx, idx);
+      continue;
+    }
+    ++idx;  // consume name token
+    if (tokens[idx].type != JSMN_OBJECT) {
+      DEBUG_PRINTF("Object expected\n");
+      return PARSE_TARGET_ERROR;
+    }
+    int custom_size = tokens[idx].size;
+    ++idx;  // consume object token
+
+    for (int j = 0; j < custom_size; ++j) {
+      if (!json_tok_lit_equal(tokens, message, idx, "ecuIdentifiers")) {
+        ++idx;  // consume name token
+        idx = consume(ctx, idx);
+        continue;
+      }
+      ++idx;  // consume name token
+      if (tokens[idx].type != JSMN_OBJECT) {
         DEBUG_PRINTF("Object expected\n");
         return PARSE_TARGET_ERROR;
       }
-      int custom_size = token_pool[idx].size;
+      int ecu_identifiers_size = tokens[idx].size;
+      ++idx;  // consume object token
+
+      for (int k = 0; k < ecu_identifiers_size; ++k) {
+        int ecu = find_ecu(ctx, message, idx);
+        ++idx;  // consume ECU ID token
+        if (tokens[idx].type != JSMN_OBJECT) {
+          DEBUG_PRINTF("Object expected\n");
+          return PARSE_TARGET_ERROR;
+        }
+        int hw_id_size = tokens[idx].size;
+        ++idx;  // consume object token
+
+        for (int l = 0; l < hw_id_size; ++l) {
+          if (json_tok_lit_equal(tokens, message, idx, "hardwareId")) {
+            ++idx;  // consume name token
+            if (ecu >= 0 && !json_tokn_equal(tokens, message, idx, ctx->ecus[ecu].hwid, ctx->ecus[ecu].hwid_len)) {
+              DEBUG_PRINTF("Invalid hardware identifier: %.*s\n", JSON_TOK_LEN(tokens[idx]),
+                           message + tokens[idx].start);
+              return PARSE_TARGET_WRONG_HW_ID;
+            }
+            ++idx;  // consume HW ID token
+          } else {
+            DEBUG_PRINTF("Unknown field in a ecuIdentifier's object: %.*s\n", JSON_TOK_LEN(tokens[idx]),
+                         message + tokens[idx].start);
+            ++idx;  // consume name token
+            idx = consume(ctx, idx);
+          }
+        }
+        if (ecu >= 0) {
+          *for_ecus |= (uint32_t)1 << ecu;
+        }
+      }
+    }
+  }
+  return (*for_ecus != 0) ? PARSE_TARGET_FORME : PARSE_TARGET_NOTFORME;
+}
+
+// fills target from the target at *pos, which is for one of our ECUs. target is the output itself, there's no copy
+static inline parse_target_result_t parse_target(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t *pos,
+                                                 uptane_targets_t *target) {
+  jsmntok_t *tokens = ctx->tokens;
+  jsmnint_t idx = *pos;
+
+  jsmnint_t hash_tokens[TARGETS_MAX_HASHES];
+  jsmnint_t delta_hash_token = 0;
+  jsmnint_t chunk_root_token = 0;
+
+  int target_name_length = JSON_TOK_LEN(tokens[idx]);
+  if (target_name_length <= 0) {
+    return PARSE_TARGET_ERROR;
+  }
+  if (target_name_length > TARGETS_MAX_NAME_LENGTH) {
+#if UPTINY_TARGETS_NAME_TRUNCATE
+    target_name_length = TARGETS_MAX_NAME_LENGTH;
+#else
+    return PARSE_TARGET_ERROR;
+#endif
+  }
+
+  memcpy(target->name, message + tokens[idx].start, (size_t)target_name_length);
+  target->name[target_name_length] = '\0';
+  target->hashes_num = 0;
+  target->delta_length = 0;
+  target->compressed_length = 0;
+  target->chunk_size = 0;
+  target->partition[0] = '\0';
+  ++idx;  // consume target name token
+
+  int size = tokens[idx].size;
+  ++idx;  // consume object token, target_ecus() has checked the type
+
+  for (int i = 0; i < size; ++i) {
+    if (json_tok_lit_equal(tokens, message, idx, "custom")) {
+      ++idx;  // consume name token
+      int custom_size = tokens[idx].size;
       ++idx;  // consume object token
 
       for (int j = 0; j < custom_size; ++j) {
-        if (json_str_equal(message, idx, "ecuIdentifiers")) {
+        if (json_tok_lit_equal(tokens, message, idx, "ecuIdentifiers")) {
+          ++idx;  // consume name token, target_ecus() has read the value
+          idx = consume(ctx, idx);
+        } else if (json_tok_lit_equal(tokens, message, idx, "delta")) {
           ++idx;  // consume name token
-          if (token_pool[idx].type != JSMN_OBJECT) {
-            DEBUG_PRINTF("Object expected\n");
+          if (!parse_delta(ctx, message, &idx, target, &delta_hash_token)) {
             return PARSE_TARGET_ERROR;
           }
-          int ecu_identifiers_size = token_pool[idx].size;
-          ++idx;  // consume object token
-
-          for (int k = 0; k < ecu_identifiers_size; ++k) {
-            bool is_for_me = json_str_equal(message, idx, state_get_ecuid());
-            ++idx;  // consume ECU ID token
-            if (token_pool[idx].type != JSMN_OBJECT) {
-              DEBUG_PRINTF("Object expected\n");
-              return PARSE_TARGET_ERROR;
-            }
-            int hw_id_size = token_pool[idx].size;
-            ++idx;  // consume object token
-
-            for (int l = 0; l < hw_id_size; ++l) {
-              if (json_str_equal(message, idx, "hardwareId")) {
-                ++idx;  // consume name token
-                if (is_for_me && !json_str_equal(message, idx, state_get_hwid())) {
-                  DEBUG_PRINTF("Invalid hardware identifier: %.*s\n", JSON_TOK_LEN(token_pool[idx]),
-                               message + token_pool[idx].start);
-                  return PARSE_TARGET_WRONG_HW_ID;
-                }
-                ++idx;  // consume HW ID token
-              } else {
-                DEBUG_PRINTF("Unknown field in a ecuIdentifier's object: %.*s\n", JSON_TOK_LEN(token_pool[idx]),
-                             message + token_pool[idx].start);
-                ++idx;  // consume name token
-                idx = consume_recursive_json(idx);
-              }
-            }
-            if (is_for_me) {
-              target_for_me = true;
-            }
+        } else if (json_tok_lit_equal(tokens, message, idx, "compression")) {
+          ++idx;  // consume name token
+          if (!parse_compression(ctx, message, &idx, target)) {
+            return PARSE_TARGET_ERROR;
           }
-
+        } else if (json_tok_lit_equal(tokens, message, idx, "chunks")) {
+          ++idx;  // consume name token
+          if (!parse_chunks(ctx, message, &idx, target, &chunk_root_token)) {
+            return PARSE_TARGET_ERROR;
+          }
+        } else if (json_tok_lit_equal(tokens, message, idx, "partition")) {
+          ++idx;  // consume name token
+          int partition_length = JSON_TOK_LEN(tokens[idx]);
+          if (tokens[idx].type != JSMN_STRING || partition_length > TARGETS_MAX_PARTITION_LENGTH) {
+            DEBUG_PRINTF("Invalid partition: %.*s\n", JSON_TOK_LEN(tokens[idx]), message + tokens[idx].start);
+            return PARSE_TARGET_ERROR;
+          }
+          memcpy(target->partition, message + tokens[idx].start, (size_t)partition_length);
+          target->partition[partition_length] = '\0';
+          ++idx;  // consume partition token
         } else {
-          DEBUG_PRINTF("Unknown field in a target's custom: %.*s\n", JSON_TOK_LEN(token_pool[idx]),
-                       message + token_pool[idx].start);
+          DEBUG_PRINTF("Unknown field in a target's custom: %.*s\n", JSON_TOK_LEN(tokens[idx]),
+                       message + tokens[idx].start);
           ++idx;  // consume name token
-          idx = consume_recursive_json(idx);
+          idx = consume(ctx, idx);
         }
       }
-    } else if (json_str_equal(message, idx, "hashes")) {
+    } else if (json_tok_lit_equal(tokens, message, idx, "hashes")) {
       ++idx;  // consume name token
-      if (token_pool[idx].type != JSMN_OBJECT) {
+      if (tokens[idx].type != JSMN_OBJECT) {
         DEBUG_PRINTF("Object expected\n");
         return PARSE_TARGET_ERROR;
       }
-      int hashes_size = token_pool[idx].size;
+      int hashes_size = tokens[idx].size;
       ++idx;  // consume object token
 
       int hash_idx = 0;
       for (int j = 0; j < hashes_size; ++j) {
         crypto_hash_algorithm_t alg =
-            crypto_str_to_hashtype(message + token_pool[idx].start,
-                                   (size_t)JSON_TOK_LEN(token_pool[idx]));  // trust jsmn_parse to keep lengths >= 0
+            crypto_str_to_hashtype(message + tokens[idx].start,
+                                   (size_t)JSON_TOK_LEN(tokens[idx]));  // trust jsmn_parse to keep lengths >= 0
         ++idx;                                                              // consume algorithm token
         if (alg == CRYPTO_HASH_UNKNOWN) {
-          DEBUG_PRINTF("Unknown hash algorithm: %.*s\n", JSON_TOK_LEN(token_pool[idx - 1]),
-                       message + token_pool[idx - 1].start);
-          idx = consume_recursive_json(idx);
+          DEBUG_PRINTF("Unknown hash algorithm: %.*s\n", JSON_TOK_LEN(tokens[idx - 1]),
+                       message + tokens[idx - 1].start);
+          idx = consume(ctx, idx);
           continue;
         }
 
+#if UPTINY_TARGETS_ONE_HASH
+        // the one kept is the one the image is checked with: the supported hash if listed, the first one otherwise
+        if (hash_idx > 0 && alg == state_get_supported_hash() && target->hashes[0].alg != alg) {
+          hash_idx = 0;
+        }
+#endif
         if (hash_idx >= TARGETS_MAX_HASHES) {
           DEBUG_PRINTF("Too many hashes\n");
+          idx = consume(ctx, idx);
           continue;
         }
 
-        if ((size_t)JSON_TOK_LEN(token_pool[idx]) != crypto_get_hashlen(alg) * 2) {
-          DEBUG_PRINTF("Invalid hash length: %d when %d expected\n", JSON_TOK_LEN(token_pool[idx]),
+        if ((size_t)JSON_TOK_LEN(tokens[idx]) != crypto_get_hashlen(alg) * 2) {
+          DEBUG_PRINTF("Invalid hash length: %d when %d expected\n", JSON_TOK_LEN(tokens[idx]),
                        crypto_get_hashlen(alg));
           return PARSE_TARGET_ERROR;
         }
 
         target->hashes[hash_idx].alg = alg;
-        if (!hex2bin(message + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), target->hashes[hash_idx].hash)) {
-          DEBUG_PRINTF("Failed to parse hash\n");
-          return PARSE_TARGET_ERROR;
-        }
-        ++idx;  // consume hash token
+        hash_tokens[hash_idx] = idx;  // decoded at the end, once the ones kept are known
+        ++idx;                        // consume hash token
         ++hash_idx;
       }
       target->hashes_num = hash_idx;
 
-    } else if (json_str_equal(message, idx, "length")) {
+    } else if (json_tok_lit_equal(tokens, message, idx, "length")) {
       ++idx;  // consume name token
       int32_t length;
-      if (!dec2int(message + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &length) || length < 0) {
-        DEBUG_PRINTF("Invalid target length: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                     message + token_pool[idx].start);
+      if (!dec2int(message + tokens[idx].start, JSON_TOK_LEN(tokens[idx]), &length) || length < 0) {
+        DEBUG_PRINTF("Invalid target length: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]),
+                     message + tokens[idx].start);
         return PARSE_TARGET_ERROR;
       }
       target->length = (uint32_t)length;
       ++idx;  // consume length token
     } else {
-      DEBUG_PRINTF("Unknown field in a target: %.*s\n", (JSON_TOK_LEN(token_pool[idx])),
-                   message + token_pool[idx].start);
+      DEBUG_PRINTF("Unknown field in a target: %.*s\n", (JSON_TOK_LEN(tokens[idx])),
+                   message + tokens[idx].start);
       ++idx;  // consume name token
-      idx = consume_recursive_json(idx);
+      idx = consume(ctx, idx);
     }
   }
 
   *pos = idx;
-  return (target_for_me) ? PARSE_TARGET_FORME : PARSE_TARGET_NOTFORME;
+
+  for (int i = 0; i < target->hashes_num; ++i) {
+    const jsmntok_t *hash_token = &tokens[hash_tokens[i]];
+    if (!hex2bin(message + hash_token->start, JSON_TOK_LEN(*hash_token), target->hashes[i].hash)) {
+      DEBUG_PRINTF("Failed to parse hash\n");
+      return PARSE_TARGET_ERROR;
+    }
+  }
+  if (delta_hash_token != 0 && !hex2bin(message + tokens[delta_hash_token].start,
+                                        JSON_TOK_LEN(tokens[delta_hash_token]), target->delta_base.hash)) {
+    DEBUG_PRINTF("Failed to parse delta base hash\n");
+    return PARSE_TARGET_ERROR;
+  }
+  if (chunk_root_token != 0 && !hex2bin(message + tokens[chunk_root_token].start,
+                                        JSON_TOK_LEN(tokens[chunk_root_token]), target->chunk_root.hash)) {
+    DEBUG_PRINTF("Failed to parse chunk root hash\n");
+    return PARSE_TARGET_ERROR;
+  }
+  return PARSE_TARGET_FORME;
+}
+
+// skips 'non-tokens' like ':', ',', '}', ']' that are already processed and shouldn't be given to the parser again
+static inline jsmnint_t skip_separators(const char *message, jsmnint_t len, jsmnint_t res) {
+  for (; res < len; ++res) {
+    switch (message[res]) {
+      case ':':
+      case ',':
+      case '}':
+      case ']':
+        break;
+      default:
+        return res;
+    }
+  }
+  return res;
 }
 
 // calculates number of characters consumed by uptane_parse_targets_feed when some tokens were consumed
 //  idx > 0 in this case
-static inline int16_t consumed_chars_newtoken(const char *message, int16_t len, int16_t idx) {
-  if (token_pool[idx - 1].end > 0) {
+static inline jsmnint_t consumed_chars_newtoken(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len,
+                                                jsmnint_t idx) {
+  jsmntok_t *tokens = ctx->tokens;
+
+  if (tokens[idx - 1].end > 0) {
     // last token was primitive or string. If it was a string, we've got a closing quote to consume. In any case,
-    // there can be 'non-tokens' like ':', ',', '}', ']' that are already processed and shouldn't be given to the
-    // parser again
-    int16_t res = token_pool[idx - 1].end;
-    if (token_pool[idx - 1].type == JSMN_STRING && message[res] == '"') {
+    // there can be 'non-tokens' that have been processed already
+    jsmnint_t res = tokens[idx - 1].end;
+    if (tokens[idx - 1].type == JSMN_STRING && message[res] == '"') {
       ++res;
     }
-    for (; res < len; ++res) {
-      switch (message[res]) {
-        case ':':
-        case ',':
-        case '}':
-        case ']':
-          break;
-        default:
-          return res;
-      }
-    }
-    return res;
+    return skip_separators(message, len, res);
   } else {
     // NOLINTNEXTLINE(misc-misplaced-widening-cast)
-    return (int16_t)(token_pool[idx - 1].start + 1);  // start should not be negative if jsmn_parse works correctly
+    return (jsmnint_t)(tokens[idx - 1].start + 1);  // start should not be negative if jsmn_parse works correctly
   }
 }
 
 // calculates the number of characters consumed by uptane_parse_targets_feed when no tokens were consumed (but some
 // non-token characters may need to be eaten anyway)
-static inline int16_t consumed_chars_nonewtoken(const char *message, int16_t len) {
-  int16_t res = 0;
-  if (token_pos > 0) {
-    for (; res < len; ++res) {
-      switch (message[res]) {
-        case ':':
-        case ',':
-        case '}':
-        case ']':
-          break;
-        default:
-          return res;
-      }
-    }
-  }
-  return res;
+static inline jsmnint_t consumed_chars_nonewtoken(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len) {
+  return (ctx->token_pos > 0) ? skip_separators(message, len, 0) : 0;
+}
+
+// tokenizes the message part from parser.pos on into the tokens of ctx
+static void tokenize(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len) {
+#if defined(UPTANE_POOL_STATS) || defined(UPTANE_STATS)
+  jsmnint_t toknext = ctx->parser.toknext;
+#endif
+  ctx->tokens_exhausted = (jsmn_parse(&ctx->parser, message, len, ctx->tokens, ctx->num_tokens) == JSMN_ERROR_NOMEM);
+  UPTANE_POOL_PEAK(tokens, ctx->parser.toknext);
+  UPTANE_POOL_COUNT(tokens_parsed, ctx->parser.toknext - toknext);
+  UPTANE_STATS_COUNT(tokens, ctx->parser.toknext - toknext);
 }
 
 // prepare jsmn parser to a new jsmn_parse round. It might be in a broken state because some characters were fed to
 // jsmn_parse, but not really consumed by uptane_parse_targets_feed
-static void prepare_primary_parser(void) {
-  parser.pos = 0;
-  parser.toknext = token_pos;
+static void prepare_primary_parser(uptane_targets_ctx_t *ctx) {
+  jsmntok_t *tokens = ctx->tokens;
+
+  ctx->parser.pos = 0;
+  ctx->parser.toknext = ctx->token_pos;
 
   // rewind toksuper. toksuper can be either container (JSMN_OBJECT/JSMN_ARRAY) or a string.
-  parser.toksuper = -1;
+  ctx->parser.toksuper = -1;
   //   If the last token is an identifier string, i.e. a string whose direct parent is an object, set it as toksuper
-  if (token_pos > 0) {
-    if (token_pool[token_pos - 1].type == JSMN_STRING &&
-        token_pool[token_pool[token_pos - 1].parent].type == JSMN_OBJECT) {
-      parser.toksuper = (int16_t)(token_pos - 1);  // token_pos >= 1
+  if (ctx->token_pos > 0) {
+    if (tokens[ctx->token_pos - 1].type == JSMN_STRING &&
+        tokens[tokens[ctx->token_pos - 1].parent].type == JSMN_OBJECT) {
+      ctx->parser.toksuper = (jsmnint_t)(ctx->token_pos - 1);  // token_pos >= 1
     } else {
-      int16_t i = (int16_t)(token_pos - 1);  // token_pos >= 1
+      jsmnint_t i = (jsmnint_t)(ctx->token_pos - 1);  // token_pos >= 1
       while (i >= 0 &&
-             ((token_pool[i].type != JSMN_OBJECT && token_pool[i].type != JSMN_ARRAY) || token_pool[i].end >= 0)) {
-        i = token_pool[i].parent;
+             ((tokens[i].type != JSMN_OBJECT && tokens[i].type != JSMN_ARRAY) || tokens[i].end >= 0)) {
+        i = tokens[i].parent;
       }
-      parser.toksuper = i;
+      ctx->parser.toksuper = i;
     }
   }
 }
 
-/*
- * @return number of consumed characters. The rest of the message should be presented to the parser on the next call
- */
-int uptane_parse_targets_feed(const char *message, int16_t len, uptane_targets_t *out_targets, uint16_t *result) {
+// drop the tokens jsmn_parse has made from 'first' on, so that the data they describe can be skipped instead. The
+// containers that are still open at that point count the dropped tokens as elements and may have seen their closing
+// brackets already, undo that too
+static void drop_tokens(uptane_targets_ctx_t *ctx, jsmnint_t first, jsmnint_t open) {
+  jsmntok_t *tokens = ctx->tokens;
+
+  for (jsmnint_t i = first; i < ctx->parser.toknext; ++i) {
+    jsmnint_t parent = tokens[i].parent;
+    if (parent >= 0 && parent < first) {
+      --tokens[parent].size;
+    }
+  }
+  for (jsmnint_t i = open; i >= 0; i = tokens[i].parent) {
+    if (tokens[i].type == JSMN_OBJECT || tokens[i].type == JSMN_ARRAY) {
+      tokens[i].end = -1;
+      tokens[i].next = -1;
+    }
+  }
+  ctx->parser.toknext = first;
+}
+
+// close a skipped object or array at parser.pos and tokenize the rest of the message part
+static void parse_after_container(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len, jsmnint_t container) {
+  ctx->tokens[container].end = ctx->parser.pos;
+  ctx->tokens[container].next = ctx->parser.toknext;
+  ctx->parser.toksuper = ctx->tokens[container].parent;
+  tokenize(ctx, message, len);
+}
+
+// skip the contents of the ignored object or array without tokenizing them. Returns false if the object continues in
+// the next message part, the parser then stays in skip mode
+static bool skip_ignored(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len) {
+  jsmntok_t *tokens = ctx->tokens;
+
+  drop_tokens(ctx, (jsmnint_t)(ctx->ignored_top_token_pos + 1), tokens[ctx->ignored_top_token_pos].parent);
+  if (tokens[ctx->ignored_top_token_pos].end >= 0) {
+    ctx->parser.pos = tokens[ctx->ignored_top_token_pos].end;
+  } else {
+    ctx->parser.pos = (jsmnint_t)(tokens[ctx->ignored_top_token_pos].start + 1);
+    jsmn_skip_init(&ctx->parser);
+    if (jsmn_skip(&ctx->parser, message, len) < 0) {
+      return false;
+    }
+  }
+  parse_after_container(ctx, message, len, ctx->ignored_top_token_pos);
+  ctx->state = ctx->prev_state;
+  return true;
+}
+
+// position right after the end of the object or array starting at 'start', or -1 if it's not complete in this part
+static jsmnint_t find_container_end(const char *message, jsmnint_t len, jsmnint_t start) {
+  jsmn_parser scan;
+  scan.pos = (jsmnint_t)(start + 1);
+  jsmn_skip_init(&scan);
+  return (jsmn_skip(&scan, message, len) == 0) ? scan.pos : -1;
+}
+
+// where parse_target() writes a target for for_ecus: the next image, the target of the first of the ECUs or
+// out_targets. NULL if there's no room or an ECU has a target already
+static uptane_targets_t *target_slot(uptane_targets_ctx_t *ctx, uint32_t for_ecus, uptane_targets_t *out_targets) {
+  if (ctx->images != NULL) {
+    if (*ctx->num_images >= ctx->max_images) {
+      DEBUG_PRINTF("Too many images for this ECU\n");
+      return NULL;
+    }
+    return &ctx->images[*ctx->num_images];
+  }
+  if ((ctx->found_mask & for_ecus) != 0) {
+    DEBUG_PRINTF("Multiple targets for this ECU\n");
+    return NULL;
+  }
+  if (ctx->ecu_targets == NULL) {
+    return out_targets;
+  }
+  unsigned int first = 0;
+  while ((for_ecus & ((uint32_t)1 << first)) == 0) {
+    ++first;
+  }
+  return &ctx->ecu_targets[first];
+}
+
+// records the target parse_target() wrote to its slot, copies it for the other ECUs it is for
+static bool target_found(uptane_targets_ctx_t *ctx, const uptane_targets_t *target, uint32_t for_ecus) {
+  if (ctx->images != NULL) {
+    for (unsigned int i = 0; i < *ctx->num_images; ++i) {
+      if (strcmp(ctx->images[i].partition, target->partition) == 0) {
+        DEBUG_PRINTF("Multiple targets for partition \"%s\"\n", target->partition);
+        return false;
+      }
+    }
+    ++*ctx->num_images;
+    ctx->found_mask = 1;
+    return true;
+  }
+
+  ctx->found_mask |= for_ecus;
+  for (unsigned int i = 0; ctx->ecu_targets != NULL && i < ctx->num_ecus; ++i) {
+    if ((for_ecus & ((uint32_t)1 << i)) == 0) {
+      continue;
+    }
+    if (&ctx->ecu_targets[i] != target) {
+      ctx->ecu_targets[i] = *target;
+    }
+    ctx->ecu_found[i] = true;
+  }
+  return true;
+}
+
+// a target can only be ours if its raw text has one of our ECU serials as a string
+static bool target_may_be_for_me(uptane_targets_ctx_t *ctx, const char *target, jsmnint_t len) {
+  for (unsigned int e = 0; e < ctx->num_ecus; ++e) {
+    const char *ecuid = ctx->ecus[e].ecuid;
+    jsmnint_t ecuid_len = (jsmnint_t)ctx->ecus[e].ecuid_len;
+
+    for (jsmnint_t i = 0; i + ecuid_len + 1 < len; ++i) {
+      if (target[i] == '"' && target[i + ecuid_len + 1] == '"' &&
+          memcmp(target + i + 1, ecuid, (size_t)ecuid_len) == 0) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+#ifdef UPTINY_TARGETS_CACHE
+// digests the key IDs and signatures just parsed, returns true if they are the ones of the cached metadata
+static bool signatures_cached(uptane_targets_ctx_t *ctx) {
+  crypto_hash_init(ctx->hash, CRYPTO_HASH_SHA512);
+  for (unsigned int i = 0; i < ctx->num_signatures; i++) {
+    crypto_hash_feed(ctx->hash, ctx->signatures[i].key->keyid, CRYPTO_KEYID_LEN);
+    crypto_hash_feed(ctx->hash, ctx->signatures[i].sig, CRYPTO_MAX_SIGNATURE_LEN);
+  }
+  crypto_hash_result(ctx->hash, &ctx->signatures_digest);
+
+  return ctx->verified_cache.valid && ctx->verified_cache.root_version == root_of(ctx)->version &&
+         memcmp(ctx->verified_cache.signatures_digest.hash, ctx->signatures_digest.hash, CRYPTO_MAX_HASH_LEN) == 0;
+}
+#endif
+
+static void begin_signed_hashing(uptane_targets_ctx_t *ctx, const char *message) {
+  ctx->signed_data = message + ctx->begin_signed;
+  ctx->num_verifying = (ctx->signatures_trusted || ctx->signed_buffered) ? 0 : ctx->num_signatures;
+#ifdef UPTINY_TARGETS_CACHE
+  if (ctx->cache_candidate) {
+    ctx->num_verifying = 0;
+  }
+  crypto_hash_init(ctx->hash, CRYPTO_HASH_SHA512);
+#endif
+  UPTANE_POOL_PEAK(crypto_ctxs, ctx->signed_buffered ? 1 : ctx->num_verifying);
+  for (unsigned int i = 0; i < ctx->num_verifying; i++) {
+    crypto_verify_init(ctx->verify_ctxs[i], &ctx->signatures[i]);
+  }
+  ctx->in_signed = true;
+}
+
+static void hash_signed(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t begin, jsmnint_t end) {
+  if (ctx->num_verifying > 0) {
+    crypto_verify_feed_multi_start(ctx->verify_ctxs, ctx->num_verifying, (const uint8_t *)message + begin,
+                                   (size_t)(end - begin));
+  }
+#ifdef UPTINY_TARGETS_CACHE
+  crypto_hash_feed_start(ctx->hash, (const uint8_t *)message + begin, (size_t)(end - begin));
+#endif
+}
+
+// wait until the background hashing of the previous message part stops reading it
+static inline void wait_signed_hashing(uptane_targets_ctx_t *ctx) {
+  if (ctx->in_signed) {
+    crypto_verify_wait(ctx->verify_ctxs, ctx->num_verifying);
+#ifdef UPTINY_TARGETS_CACHE
+    crypto_hash_wait(ctx->hash);
+#endif
+  }
+}
+
+// called once the whole signed part is hashed, it ends right before signed_end. Returns the number of valid signatures
+static int verify_signed(uptane_targets_ctx_t *ctx, const char *signed_end) {
+  int threshold = root_of(ctx)->targets_threshold;
+
+  ctx->in_signed = false;
+  UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_SIGNED);
+#ifdef UPTINY_TARGETS_CACHE
+  crypto_hash_t signed_digest;
+  crypto_hash_wait(ctx->hash);
+  crypto_hash_result(ctx->hash, &signed_digest);
+  if (ctx->cache_candidate) {
+    UPTANE_STATS_COUNT(targets_cache_hits, 1);
+    UPTANE_STATS_COUNT(signatures_skipped, ctx->num_signatures);
+    return (memcmp(ctx->verified_cache.signed_digest.hash, signed_digest.hash, CRYPTO_MAX_HASH_LEN) == 0) ? threshold
+                                                                                                          : 0;
+  }
+#endif
+
+  if (ctx->signatures_trusted) {
+    UPTANE_STATS_COUNT(signatures_skipped, ctx->num_signatures);
+    return threshold;
+  }
+
+  int num_valid;
+  if (ctx->signed_buffered) {
+    num_valid = uptane_verify_signatures_buffered(ctx->verify_ctxs[0], ctx->signatures, ctx->num_signatures, threshold,
+                                                  (const uint8_t *)ctx->signed_data,
+                                                  (size_t)(signed_end - ctx->signed_data));
+  } else {
+    num_valid = uptane_verify_signatures_ctx(ctx->verify_ctxs, ctx->num_signatures, threshold);
+  }
+#ifdef UPTINY_TARGETS_CACHE
+  if (num_valid >= threshold) {
+    ctx->verified_cache.valid = true;
+    ctx->verified_cache.root_version = root_of(ctx)->version;
+    ctx->verified_cache.signatures_digest = ctx->signatures_digest;
+    ctx->verified_cache.signed_digest = signed_digest;
+  }
+#endif
+  return num_valid;
+}
+
+// the message part isn't hashed, the attack is reported right away
+static int over_budget(uptane_targets_ctx_t *ctx, uint16_t *result) {
+  ctx->state = TARGETS_IN_ERROR;
+  state_set_attack(ATTACK_TARGETS_LARGE);
+  *result = RESULT_TOO_LARGE;
+  return -1;
+}
+
+static int targets_feed(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len, uptane_targets_t *out_targets,
+                        uint16_t *result) {
+  jsmntok_t *tokens = ctx->tokens;
+
   bool has_signed_begun = false;
   bool has_signed_ended = false;
   bool break_parsing = false;
@@ -317,270 +900,353 @@ int uptane_parse_targets_feed(const char *message, int16_t len, uptane_targets_t
   //   and consume both
 
   // If the state is ERROR, don't try to parse the feed
-  if (state == TARGETS_IN_ERROR) {
+  if (ctx->state == TARGETS_IN_ERROR) {
     *result = RESULT_ERROR;
     return -1;
   }
+  // the zero-initialized parser is ready for the first metadata, only the ECU to look for is missing
+  if (ctx->ecus == NULL) {
+    use_own_ecu(ctx);
+  }
 
-  // initialize primary parser
-  prepare_primary_parser();
+  if (ctx->max_bytes > 0 && (uint32_t)len > ctx->max_bytes - ctx->bytes_consumed) {
+    DEBUG_PRINTF("Targets metadata is over the budget of %u bytes\n", (unsigned int)ctx->max_bytes);
+    return over_budget(ctx, result);
+  }
 
-  jsmn_parse(&parser, message, len, token_pool, token_pool_size);
+  // Hashing of the previous part may still be going on
+  wait_signed_hashing(ctx);
 
-  int16_t idx;
-  for (idx = token_pos; idx < parser.toknext && !break_parsing && state != TARGETS_IN_ERROR;) {
-    switch (state) {
+  // A target that was incomplete on the last call has been scanned up to the end of that part already. Until its
+  // closing bracket comes, only the new bytes are scanned and nothing is tokenized again
+  if (ctx->pending_scan.skipdepth > 0) {
+    ctx->pending_scan.pos = ctx->tail_length;
+    if (jsmn_skip(&ctx->pending_scan, message, len) < 0) {
+      if (ctx->in_signed) {
+        hash_signed(ctx, message, ctx->tail_length, len);
+      }
+      *result = RESULT_IN_PROGRESS;
+      ctx->tail_length = len;
+      return 0;
+    }
+  }
+
+  // initialize primary parser
+  prepare_primary_parser(ctx);
+  ctx->tokens_exhausted = false;
+  jsmnint_t first_token = ctx->token_pos;
+
+  bool skip_ended = false;
+  bool target_too_large = false;  // a target is all in this part, but not in the tokens
+  jsmnint_t skipped_end = -1;  // end of the last target skipped in this call
+  if (ctx->parser.skipdepth > 0) {  // in the middle of an ignored object
+    if (jsmn_skip(&ctx->parser, message, len) == 0) {
+      parse_after_container(ctx, message, len, ctx->ignored_top_token_pos);
+      ctx->state = ctx->prev_state;
+      skip_ended = true;
+    }
+  } else {
+    tokenize(ctx, message, len);
+  }
+
+  jsmnint_t idx;
+  for (idx = ctx->token_pos; idx < ctx->parser.toknext && !break_parsing && ctx->state != TARGETS_IN_ERROR;) {
+    switch (ctx->state) {
       case TARGETS_BEGIN:
-        if (token_pool[idx].type != JSMN_OBJECT) {
+        if (tokens[idx].type != JSMN_OBJECT) {
           DEBUG_PRINTF("Object expected\n");
-          state = TARGETS_IN_ERROR;
+          ctx->state = TARGETS_IN_ERROR;
         } else {
-          state = TARGETS_IN_TOP;
+          ctx->state = TARGETS_IN_TOP;
           ++idx;  // consume object token
         }
         break;
       case TARGETS_IN_TOP:
-        if (json_str_equal(message, idx, "signatures")) {
-          if (idx == parser.toknext - 1 || token_pool[idx + 1].end < 0) {  // got "signatures", but not actual object
+        if (json_tok_lit_equal(tokens, message, idx, "signatures")) {
+          if (idx == ctx->parser.toknext - 1 || tokens[idx + 1].end < 0) {  // got "signatures", but not actual object
             // remove partially parsed object from the container
-            --token_pool[0].size;
+            --tokens[0].size;
             break_parsing = true;
             break;
           }
-          state = TARGETS_IN_SIGNATURES;
+          ctx->state = TARGETS_IN_SIGNATURES;
           ++idx;  // consume name token
 
           break;
-        } else if (json_str_equal(message, idx, "signed")) {
-          if (num_signatures == 0) {
+        } else if (json_tok_lit_equal(tokens, message, idx, "signed")) {
+          if (ctx->num_signatures == 0) {
             DEBUG_PRINTF("Signatures are not available for the signed part\n");
-            state = TARGETS_IN_ERROR;
+            ctx->state = TARGETS_IN_ERROR;
             break;
           }
 
-          state = TARGETS_BEFORE_SIGNED;
+          ctx->state = TARGETS_BEFORE_SIGNED;
           ++idx;  // consume name token
           break;
         } else {
-          prev_state = state;
-          state = TARGETS_IN_IGNORED;
+          ctx->prev_state = ctx->state;
+          ctx->state = TARGETS_IN_IGNORED;
+          UPTANE_STATS_COUNT(subtrees_skipped, 1);
           ++idx;                        // consume name token
-          ignored_top_token_pos = idx;  // remember value token number
+          ctx->ignored_top_token_pos = idx;  // remember value token number
           break;
         }
         break;
 
       case TARGETS_IN_IGNORED:
-        if (ignored_top_token_pos == idx) {  // the ignored object itself is obviously ignored
-          ++idx;
-        } else if (token_pool[ignored_top_token_pos].end < 0) {  // not yet reached the end of the top object
-          ++idx;  // *.end will never change in this call, so consume all the tokens read
-        } else {
-          while (idx < parser.toknext &&
-                 token_pool[idx].start < token_pool[ignored_top_token_pos].end) {  // consume the rest of ignored object
-                                                                                   // within this function call. On the
-                                                                                   // next call we should be in the
-                                                                                   // previous state
-            ++idx;  // token is under the ignored one, consume
+        // idx points to the ignored value. Objects and arrays are skipped without tokenizing their contents, so the
+        // value is the only token to consume
+        if (tokens[idx].type == JSMN_OBJECT || tokens[idx].type == JSMN_ARRAY) {
+          if (!skip_ignored(ctx, message, len)) {
+            break_parsing = true;  // the rest of the message part is inside the ignored object
           }
-
-          state = prev_state;  // don't consume the token, it will be done by the next state
+        } else {
+          ctx->state = ctx->prev_state;
         }
+        ++idx;
         break;
 
       case TARGETS_IN_SIGNATURES:
-        if (token_pool[idx].end < 0) {
+        if (tokens[idx].end < 0) {
           // everything before "signatures" has already been consumed in 'case TARGETS_IN_TOP'
           break_parsing = true;
           break;
         } else {
-          int parse_res = uptane_parse_signatures(ROLE_TARGETS, message, &idx, signature_pool, signature_pool_size,
-                                                  state_get_root());
+          int parse_res = uptane_parse_signatures_in(tokens, ctx->num_tokens, ROLE_TARGETS, message, &idx,
+                                                     ctx->signatures, ctx->max_signatures, root_of(ctx));
           if (parse_res <= 0) {
-            DEBUG_PRINTF("Failed to parse signatures : %d\n", num_signatures);
-            state = TARGETS_IN_ERROR;
+            DEBUG_PRINTF("Failed to parse signatures : %d\n", ctx->num_signatures);
+            ctx->state = TARGETS_IN_ERROR;
             break;
           } else {
-            num_signatures = (unsigned int)parse_res;
-            state = TARGETS_IN_TOP;
+            ctx->num_signatures = (unsigned int)parse_res;
+            UPTANE_POOL_PEAK(signatures, ctx->num_signatures);
+#ifdef UPTINY_TARGETS_CACHE
+            ctx->cache_candidate = signatures_cached(ctx);
+#endif
+            ctx->state = TARGETS_IN_TOP;
           }
         }
         break;
       case TARGETS_BEFORE_SIGNED:
-        if (token_pool[idx].type != JSMN_OBJECT) {
+        if (tokens[idx].type != JSMN_OBJECT) {
           DEBUG_PRINTF("Object expected\n");
-          state = TARGETS_IN_ERROR;
+          ctx->state = TARGETS_IN_ERROR;
           break;
         }
 
-        signed_top_token_pos = idx;
-        if (num_signatures > crypto_ctx_pool_size) {
-          num_signatures = crypto_ctx_pool_size;
+        ctx->signed_top_token_pos = idx;
+        if (!ctx->signed_buffered && ctx->num_signatures > ctx->num_verify_ctxs) {
+          ctx->num_signatures = ctx->num_verify_ctxs;
         }
 
-        begin_signed = token_pool[idx].start;
+        ctx->begin_signed = tokens[idx].start;
         has_signed_begun = true;  // local to the call
 
-        state = TARGETS_IN_SIGNED;
+        ctx->state = TARGETS_IN_SIGNED;
         ++idx;  // consume object token
         break;
 
       case TARGETS_IN_SIGNED:
-        if (token_pool[signed_top_token_pos].end >= 0 &&
-            signed_elems_read >=
-                token_pool[signed_top_token_pos].size) {  // should never be >, weaker condition for robustness
-          state = TARGETS_IN_TOP;
+        if (tokens[ctx->signed_top_token_pos].end >= 0 &&
+            ctx->signed_elems_read >=
+                tokens[ctx->signed_top_token_pos].size) {  // should never be >, weaker condition for robustness
+          ctx->state = TARGETS_IN_TOP;
           break;
         }
 
-        if (json_str_equal(message, idx, "_type")) {
-          if (idx == parser.toknext - 1) {  // got name, but not respective value
+        if (json_tok_lit_equal(tokens, message, idx, "_type")) {
+          if (idx == ctx->parser.toknext - 1) {  // got name, but not respective value
             // remove partially parsed object from the container
-            --token_pool[signed_top_token_pos].size;
+            --tokens[ctx->signed_top_token_pos].size;
             break_parsing = true;
             break;
           }
           ++idx;  // consume name token
-          ++signed_elems_read;
-          if (!json_str_equal(message, idx, "Targets")) {
-            DEBUG_PRINTF("Wrong type of targets metadata: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                         message + token_pool[idx].start);
-            state = TARGETS_IN_ERROR;
+          ++ctx->signed_elems_read;
+          if (!json_tok_lit_equal(tokens, message, idx, "Targets")) {
+            DEBUG_PRINTF("Wrong type of targets metadata: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]),
+                         message + tokens[idx].start);
+            ctx->state = TARGETS_IN_ERROR;
             break;
           }
           ++idx;  // consume value token
-        } else if (json_str_equal(message, idx, "expires")) {
-          if (idx == parser.toknext - 1) {  // got name, but not respective value
+        } else if (json_tok_lit_equal(tokens, message, idx, "expires")) {
+          if (idx == ctx->parser.toknext - 1) {  // got name, but not respective value
             // remove partially parsed object from the container
-            --token_pool[signed_top_token_pos].size;
+            --tokens[ctx->signed_top_token_pos].size;
             break_parsing = true;
             break;
           }
-          ++signed_elems_read;
+          ++ctx->signed_elems_read;
           ++idx;  // consume name token
 
           uptane_time_t expires;
-          if (!str2time(message + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &expires)) {
-            DEBUG_PRINTF("Invalid expiration date: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]),
-                         message + token_pool[idx].start);
-            state = TARGETS_IN_ERROR;
+          if (!str2time(message + tokens[idx].start, JSON_TOK_LEN(tokens[idx]), &expires)) {
+            DEBUG_PRINTF("Invalid expiration date: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]),
+                         message + tokens[idx].start);
+            ctx->state = TARGETS_IN_ERROR;
             break;
           } else {
             out_targets->expires = expires;
           }
           ++idx;  // consume value token
-        } else if (json_str_equal(message, idx, "version")) {
-          if (idx == parser.toknext - 1) {  // got name, but not respective value
+        } else if (json_tok_lit_equal(tokens, message, idx, "version")) {
+          if (idx == ctx->parser.toknext - 1) {  // got name, but not respective value
             // remove partially parsed object from the container
-            --token_pool[signed_top_token_pos].size;
+            --tokens[ctx->signed_top_token_pos].size;
             break_parsing = true;
             break;
           }
-          ++signed_elems_read;
+          ++ctx->signed_elems_read;
           ++idx;  // consume name token
 
           int32_t version_tmp;
-          if (!dec2int(message + token_pool[idx].start, JSON_TOK_LEN(token_pool[idx]), &version_tmp)) {
-            DEBUG_PRINTF("Invalid version: \"%.*s\"\n", JSON_TOK_LEN(token_pool[idx]), message + token_pool[idx].start);
-            state = TARGETS_IN_ERROR;
+          if (!dec2int(message + tokens[idx].start, JSON_TOK_LEN(tokens[idx]), &version_tmp)) {
+            DEBUG_PRINTF("Invalid version: \"%.*s\"\n", JSON_TOK_LEN(tokens[idx]), message + tokens[idx].start);
+            ctx->state = TARGETS_IN_ERROR;
             break;
           }
 
           if (version_tmp < state_get_targets()->version) {
-            state = TARGETS_IN_ERROR;
+            ctx->state = TARGETS_IN_ERROR;
             *result = RESULT_VERSION_FAILED;
             return -1;
           }
           out_targets->version = version_tmp;
           ++idx;  // consume value token
-        } else if (json_str_equal(message, idx, "targets")) {
-          if (idx == parser.toknext - 1) {  // got "targets", but not ': {'
+        } else if (json_tok_lit_equal(tokens, message, idx, "targets")) {
+          if (idx == ctx->parser.toknext - 1) {  // got "targets", but not ': {'
             // remove partially parsed object from the container
-            --token_pool[signed_top_token_pos].size;
+            --tokens[ctx->signed_top_token_pos].size;
             break_parsing = true;
             break;
           }
-          state = TARGETS_IN_TARGETS;
+          ctx->state = TARGETS_IN_TARGETS;
           ++idx;  // consume name token
-          targets_top_token_pos = idx;
+          ctx->targets_top_token_pos = idx;
 
-          if (token_pool[idx].type != JSMN_OBJECT) {
+          if (tokens[idx].type != JSMN_OBJECT) {
             DEBUG_PRINTF("Object expected\n");
-            state = TARGETS_IN_ERROR;
+            ctx->state = TARGETS_IN_ERROR;
           }
           ++idx;  // consume object token
           break;
         } else {
-          prev_state = state;
-          state = TARGETS_IN_IGNORED;
+          ctx->prev_state = ctx->state;
+          ctx->state = TARGETS_IN_IGNORED;
+          UPTANE_STATS_COUNT(subtrees_skipped, 1);
           ++idx;  // consume name token
-          ++signed_elems_read;
-          ignored_top_token_pos = idx;  // remember value token number
+          ++ctx->signed_elems_read;
+          ctx->ignored_top_token_pos = idx;  // remember value token number
           break;
         }
         break;
 
       case TARGETS_IN_TARGETS:
-        if (token_pool[targets_top_token_pos].end >= 0) {
-          if (targets_elems_read >=
-              token_pool[targets_top_token_pos].size) {  // should never be >, weaker condition for robustness
-            ++signed_elems_read;
-            state = TARGETS_IN_SIGNED;
+        if (tokens[ctx->targets_top_token_pos].end >= 0) {
+          if (ctx->targets_elems_read >=
+              tokens[ctx->targets_top_token_pos].size) {  // should never be >, weaker condition for robustness
+            ++ctx->signed_elems_read;
+            ctx->state = TARGETS_IN_SIGNED;
             break;
           }
         }
 
-        if (token_pool[idx].type != JSMN_STRING) {
+        if (tokens[idx].type != JSMN_STRING) {
           DEBUG_PRINTF("String expected\n");
-          state = TARGETS_IN_ERROR;
+          ctx->state = TARGETS_IN_ERROR;
           break;
         }
-        int16_t target_elem_idx = idx;
+        jsmnint_t target_elem_idx = idx;
         ++idx;  // consume target name token
 
-        if (idx < parser.toknext && token_pool[idx].end > 0) {  // target object parsed completely
-          static uptane_targets_t tmp_target;
-          parse_target_result_t res = parse_target(message, &target_elem_idx, &tmp_target);
+        if (idx < ctx->parser.toknext && tokens[idx].type == JSMN_OBJECT) {
+          // skip targets for other ECUs without walking or even tokenizing them
+          jsmnint_t target_end = tokens[idx].end;
+          if (target_end < 0) {
+            target_end = find_container_end(message, len, tokens[idx].start);
+          }
+          if (target_end > 0 &&
+              !target_may_be_for_me(ctx, message + tokens[idx].start, (jsmnint_t)(target_end - tokens[idx].start))) {
+            // the target leaves no tokens behind, not even its name. It counts as the two it would take
+            UPTANE_STATS_COUNT(targets_inspected, 1);
+            UPTANE_STATS_COUNT(subtrees_skipped, 1);
+            idx = target_elem_idx;
+            drop_tokens(ctx, idx, ctx->targets_top_token_pos);
+            ctx->tokens_used += 2;
+            ctx->parser.pos = target_end;
+            ctx->parser.toksuper = ctx->targets_top_token_pos;
+            tokenize(ctx, message, len);
+            skipped_end = target_end;
+            break;
+          }
+        }
+
+        if (idx < ctx->parser.toknext && tokens[idx].end > 0) {  // target object parsed completely
+          uint32_t for_ecus;
+          uptane_targets_t *target = NULL;
+          jsmnint_t target_name = target_elem_idx;
+          jsmnint_t target_end = tokens[idx].end;
+          parse_target_result_t res = target_ecus(ctx, message, idx, &for_ecus);
+          UPTANE_STATS_COUNT(targets_inspected, 1);
+          if (res == PARSE_TARGET_FORME) {
+            target = target_slot(ctx, for_ecus, out_targets);
+            res = (target != NULL) ? parse_target(ctx, message, &target_elem_idx, target) : PARSE_TARGET_ERROR;
+          }
           switch (res) {
             case PARSE_TARGET_ERROR:
               DEBUG_PRINTF("Error parsing target\n");
-              state = TARGETS_IN_ERROR;
+              ctx->state = TARGETS_IN_ERROR;
               break;
 
             case PARSE_TARGET_NOTFORME:
               break;
 
             case PARSE_TARGET_FORME:
-              if (target_found) {
-                DEBUG_PRINTF("Multiple targets for this ECU\n");
-                state = TARGETS_IN_ERROR;
-                break;
+              if (!target_found(ctx, target, for_ecus)) {
+                ctx->state = TARGETS_IN_ERROR;
               }
-
-              target_found = true;
-              out_targets->hashes_num = tmp_target.hashes_num;
-              memcpy(&out_targets->name, &tmp_target.name, sizeof(tmp_target.name));
-              memcpy(&out_targets->hashes, &tmp_target.hashes, sizeof(tmp_target.hashes));
-              out_targets->length = tmp_target.length;
               break;
 
             case PARSE_TARGET_WRONG_HW_ID:
-              state = TARGETS_IN_ERROR;
+              ctx->state = TARGETS_IN_ERROR;
               *result = RESULT_WRONG_HW_ID;
               return -1;
 
             default:
-              state = TARGETS_IN_ERROR;
+              ctx->state = TARGETS_IN_ERROR;
               *result = RESULT_ERROR;
               return -1;
           }
 
-          idx = target_elem_idx;  // target_elem_idx has been advanced by parse_target to point to the next target
-          ++targets_elems_read;
+          if (ctx->state == TARGETS_IN_ERROR) {
+            idx = target_elem_idx;  // target_elem_idx has been advanced by parse_target to point to the next target
+            break;
+          }
+
+          // what is needed of the target has been copied out. Its tokens make room for the next one, like those of a
+          // skipped target, so the targets of several ECUs or images don't add up. They still count for the budget
+          ctx->tokens_used += (uint32_t)(consume(ctx, (jsmnint_t)(target_name + 1)) - target_name);
+          idx = target_name;
+          drop_tokens(ctx, idx, ctx->targets_top_token_pos);
+          ctx->parser.pos = target_end;
+          ctx->parser.toksuper = ctx->targets_top_token_pos;
+          tokenize(ctx, message, len);
+          skipped_end = target_end;
         } else {
-          idx = (int16_t)(target_elem_idx - 1);  // rewind to the point before target name
-          --token_pool[targets_top_token_pos].size;
+          idx = target_elem_idx;  // rewind to the target name
+          --tokens[ctx->targets_top_token_pos].size;
           break_parsing = true;
+
+          // remember how far the target has been scanned, see the beginning of the function
+          jsmnint_t target_obj = (jsmnint_t)(target_elem_idx + 1);
+          if (target_obj < ctx->parser.toknext && tokens[target_obj].type == JSMN_OBJECT) {
+            ctx->pending_scan.pos = (jsmnint_t)(tokens[target_obj].start + 1);
+            jsmn_skip_init(&ctx->pending_scan);
+            // the next call tokenizes the target into the same tokens from the same one on
+            target_too_large = (jsmn_skip(&ctx->pending_scan, message, len) == 0) && ctx->tokens_exhausted;
+          }
           break;
         }
 
@@ -588,91 +1254,261 @@ int uptane_parse_targets_feed(const char *message, int16_t len, uptane_targets_t
 
       default:
         DEBUG_PRINTF("Unexpected state\n");
-        state = TARGETS_IN_ERROR;
+        ctx->state = TARGETS_IN_ERROR;
         break;
     }
   }
 
   /* Second check after processing tokens */
-  if (state == TARGETS_IN_ERROR) {
+  if (ctx->state == TARGETS_IN_ERROR) {
     *result = RESULT_ERROR;
     return -1;
   }
 
-  if ((signed_top_token_pos >= 0) && (end_signed < 0) &&
-      token_pool[signed_top_token_pos].end >= 0) {  // have read the whole "signed" object
-    end_signed = token_pool[signed_top_token_pos].end;
+  // Nothing could be consumed with all tokens in use, or a whole target didn't fit. More data won't change that, the
+  // same tokens come first
+  if (target_too_large ||
+      (ctx->tokens_exhausted && idx == ctx->token_pos && !skip_ended && ctx->parser.skipdepth == 0)) {
+    DEBUG_PRINTF("Out of tokens, %d are too few\n", (int)ctx->num_tokens);
+    ctx->state = TARGETS_IN_ERROR;
+    *result = RESULT_OUT_OF_TOKENS;
+    return -1;
+  }
+
+  if (ctx->max_tokens > 0 && ctx->tokens_used + (uint32_t)(idx - first_token) > ctx->max_tokens) {
+    DEBUG_PRINTF("Targets metadata is over the budget of %u tokens\n", (unsigned int)ctx->max_tokens);
+    return over_budget(ctx, result);
+  }
+
+  if ((ctx->signed_top_token_pos >= 0) && (ctx->end_signed < 0) &&
+      tokens[ctx->signed_top_token_pos].end >= 0) {  // have read the whole "signed" object
+    ctx->end_signed = tokens[ctx->signed_top_token_pos].end;
     has_signed_ended = true;  // local to the call
   }
 
   /* signature verification */
   if (has_signed_begun) {
-    in_signed = true;
-    for (unsigned int i = 0; i < num_signatures; i++) {
-      crypto_verify_init(crypto_ctx_pool[i], &signature_pool[i]);
-    }
+    begin_signed_hashing(ctx, message);
   }
 
-  if (in_signed) {
-    int16_t first_signed;
-    int16_t last_signed;
+  if (ctx->in_signed) {
+    jsmnint_t first_signed;
+    jsmnint_t last_signed;
     if (has_signed_begun) {
-      first_signed = begin_signed;  // once has_signed_begun is set, begin_signed >= 0
+      first_signed = ctx->begin_signed;  // once has_signed_begun is set, begin_signed >= 0
     } else {
-      first_signed = tail_length;
+      first_signed = ctx->tail_length;
     }
     if (has_signed_ended) {
-      last_signed = end_signed;  // once has_signed_begun is set, begin_signed >= 0
+      last_signed = ctx->end_signed;  // once has_signed_begun is set, begin_signed >= 0
     } else {
       last_signed = len;
     }
 
-    for (unsigned int i = 0; i < num_signatures; i++) {
-      crypto_verify_feed(crypto_ctx_pool[i], (const uint8_t *)message + first_signed,
-                         (size_t)(last_signed - first_signed));
-    }
+    hash_signed(ctx, message, first_signed, last_signed);
   }
 
   if (has_signed_ended) {
-    in_signed = false;
-    int num_valid_signatures = 0;
-    for (unsigned int i = 0; i < num_signatures; i++) {
-      if (crypto_verify_result(crypto_ctx_pool[i])) {
-        ++num_valid_signatures;
-      } else {
-        DEBUG_PRINTF("Signature verification failed for signature %d\n", i);
-      }
-    }
+    int num_valid_signatures = verify_signed(ctx, message + ctx->end_signed);
 
-    if (num_valid_signatures < state_get_root()->targets_threshold) {
+    if (num_valid_signatures < root_of(ctx)->targets_threshold) {
       DEBUG_PRINTF("Signature verification failed: only %d signatures are valid with threshold of %d\n",
-                   num_valid_signatures, state_get_root()->targets_threshold);
-      state = TARGETS_IN_ERROR;
+                   num_valid_signatures, root_of(ctx)->targets_threshold);
+      ctx->state = TARGETS_IN_ERROR;
       *result = RESULT_SIGNATURES_FAILED;
       return -1;
     }
   }
 
-  if ((idx > 0 && token_pool[0].end >= 0)) {
+  if ((idx > 0 && tokens[0].end >= 0)) {
     /* Processed the whole metadata, return result */
-    if (!target_found) {
+    UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_END);
+    if (ctx->found_mask == 0) {
       *result = RESULT_END_NOT_FOUND;
     } else {
       *result = RESULT_END_FOUND;
     }
+    for (unsigned int i = 0; ctx->ecu_targets != NULL && i < ctx->num_ecus; ++i) {
+      if (ctx->ecu_found[i]) {
+        ctx->ecu_targets[i].version = out_targets->version;
+        ctx->ecu_targets[i].expires = out_targets->expires;
+      }
+    }
+    for (unsigned int i = 0; ctx->images != NULL && i < *ctx->num_images; ++i) {
+      ctx->images[i].version = out_targets->version;
+      ctx->images[i].expires = out_targets->expires;
+    }
   } else {
     *result = RESULT_IN_PROGRESS;
   }
 
-  int16_t ret;
+  jsmnint_t ret;
   /* Advance token and character positions */
-  if (idx > token_pos) {
-    ret = consumed_chars_newtoken(message, len, idx);
-    token_pos = idx;  // start on the current idx next time
+  if (ctx->parser.skipdepth > 0) {
+    ret = len;  // everything after the ignored object's start has been skipped
+    ctx->token_pos = idx;
+  } else if (idx > ctx->token_pos || skip_ended) {
+    ret = consumed_chars_newtoken(ctx, message, len, idx);
+    ctx->token_pos = idx;  // start on the current idx next time
   } else {
-    ret = consumed_chars_nonewtoken(message, len);
+    ret = consumed_chars_nonewtoken(ctx, message, len);
+  }
+
+  if (skipped_end > ret) {  // the last tokens consumed are before a skipped target
+    ret = skip_separators(message, len, skipped_end);
+    ctx->token_pos = idx;
   }
 
-  tail_length = (int16_t)(len - ret);
+  ctx->tail_length = (jsmnint_t)(len - ret);
+  ctx->bytes_consumed += (uint32_t)ret;
+  ctx->tokens_used += (uint32_t)(ctx->token_pos - first_token);
   return (int)ret;
 }
+
+/*
+ * @return number of consumed characters. The rest of the message should be presented to the parser on the next call
+ */
+int uptane_targets_ctx_feed(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len,
+                            uptane_targets_t *out_targets, uint16_t *result) {
+  int consumed;
+
+  TRACE_BEGIN(TRACE_TARGETS_FEED, 0);
+  UPTANE_STATS_COUNT(bytes_fed, len);
+  consumed = targets_feed(ctx, message, len, out_targets, result);
+  TRACE_END(TRACE_TARGETS_FEED, 0);
+  return consumed;
+}
+
+int uptane_parse_targets_feed(const char *message, jsmnint_t len, uptane_targets_t *out_targets, uint16_t *result) {
+  return uptane_targets_ctx_feed(default_context(), message, len, out_targets, result);
+}
+
+int uptane_targets_ctx_feed_segments(uptane_targets_ctx_t *ctx, const uptane_segment_t *segments,
+                                     unsigned int num_segments, uptane_targets_t *out_targets, uint16_t *result) {
+  // unconsumed end of the previous segments joined with the next one. Nothing is left in it between calls, so the
+  // contexts can share it
+  static char carry[TARGETS_SEGMENT_CARRY_SIZE];
+  jsmnint_t carry_len = 0;
+  int consumed = 0;
+
+  *result = RESULT_IN_PROGRESS;
+  for (unsigned int s = 0; s < num_segments; ++s) {
+    const char *data = segments[s].data;
+    jsmnint_t len = segments[s].len;
+
+    // feed the carried bytes with as much of this segment as fits until the parser consumes past the boundary
+    while (carry_len > 0 && len > 0) {
+      jsmnint_t old_len = carry_len;
+      jsmnint_t n = (jsmnint_t)(TARGETS_SEGMENT_CARRY_SIZE - carry_len);
+      if (n > len) {
+        n = len;
+      }
+      if (n == 0) {
+        DEBUG_PRINTF("Element doesn't fit in the segment carry buffer\n");
+        ctx->state = TARGETS_IN_ERROR;
+        *result = RESULT_ERROR;
+        return -1;
+      }
+      wait_signed_hashing(ctx);
+      memcpy(carry + carry_len, data, (size_t)n);
+      carry_len = (jsmnint_t)(carry_len + n);
+
+      int ret = 0;
+      if (carry_len > ctx->tail_length) {  // the bytes fed before may not even be complete yet
+        ret = uptane_targets_ctx_feed(ctx, carry, carry_len, out_targets, result);
+        if (ret < 0) {
+          return -1;
+        }
+      }
+      consumed += ret;
+      if (ret >= old_len) {
+        // the unconsumed bytes are all from this segment, continue in place
+        data += ret - old_len;
+        len = (jsmnint_t)(len - (ret - old_len));
+        carry_len = 0;
+      } else {
+        data += n;
+        len = (jsmnint_t)(len - n);
+        wait_signed_hashing(ctx);
+        memmove(carry, carry + ret, (size_t)(carry_len - ret));
+        carry_len = (jsmnint_t)(carry_len - ret);
+      }
+    }
+
+    if (len > 0) {
+      int ret = 0;
+      if (len > ctx->tail_length) {
+        ret = uptane_targets_ctx_feed(ctx, data, len, out_targets, result);
+        if (ret < 0) {
+          return -1;
+        }
+      }
+      consumed += ret;
+      if (s + 1 < num_segments && ret < len) {
+        carry_len = (jsmnint_t)(len - ret);
+        if (carry_len > TARGETS_SEGMENT_CARRY_SIZE) {
+          DEBUG_PRINTF("Element doesn't fit in the segment carry buffer\n");
+          ctx->state = TARGETS_IN_ERROR;
+          *result = RESULT_ERROR;
+          return -1;
+        }
+        wait_signed_hashing(ctx);
+        memcpy(carry, data + ret, (size_t)carry_len);
+      }
+    }
+  }
+  return consumed;
+}
+
+int uptane_parse_targets_feed_segments(const uptane_segment_t *segments, unsigned int num_segments,
+                                       uptane_targets_t *out_targets, uint16_t *result) {
+  return uptane_targets_ctx_feed_segments(default_context(), segments, num_segments, out_targets, result);
+}
+
+bool uptane_targets_ctx_busy(const uptane_targets_ctx_t *ctx) {
+  for (unsigned int i = 0; ctx->in_signed && i < ctx->num_verifying; i++) {
+    if (crypto_verify_poll(ctx->verify_ctxs[i]) != CRYPTO_OP_DONE) {
+      return true;
+    }
+  }
+#ifdef UPTINY_TARGETS_CACHE
+  if (ctx->in_signed && crypto_hash_poll(ctx->hash) != CRYPTO_OP_DONE) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+bool uptane_parse_targets_busy(void) { return uptane_targets_ctx_busy(default_context()); }
+
+bool uptane_targets_ctx_signed_digest(const uptane_targets_ctx_t *ctx, crypto_hash_t *digest) {
+#ifdef UPTINY_TARGETS_CACHE
+  if (ctx->verified_cache.valid) {
+    *digest = ctx->verified_cache.signed_digest;
+    return true;
+  }
+#else
+  (void)ctx;
+  (void)digest;
+#endif
+  return false;
+}
+
+bool uptane_parse_targets_signed_digest(crypto_hash_t *digest) {
+  return uptane_targets_ctx_signed_digest(default_context(), digest);
+}
+
+void uptane_targets_ctx_trust_signatures(uptane_targets_ctx_t *ctx) { ctx->signatures_trusted = true; }
+
+void uptane_targets_ctx_signed_buffered(uptane_targets_ctx_t *ctx) { ctx->signed_buffered = true; }
+
+void uptane_parse_targets_signed_buffered(void) { uptane_targets_ctx_signed_buffered(default_context()); }
+
+void uptane_targets_ctx_set_budget(uptane_targets_ctx_t *ctx, uint32_t max_bytes, uint32_t max_tokens) {
+  ctx->max_bytes = max_bytes;
+  ctx->max_tokens = max_tokens;
+}
+
+void uptane_parse_targets_set_budget(uint32_t max_bytes, uint32_t max_tokens) {
+  uptane_targets_ctx_set_budget(default_context(), max_bytes, max_tokens);
+}
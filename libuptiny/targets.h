@@ -5,6 +5,8 @@
 extern "C" {
 #endif
 
+#include "crypto_api.h"
+#include "jsmn.h"
 #include "state_api.h"
 
 typedef enum {
@@ -12,13 +14,198 @@ typedef enum {
   RESULT_WRONG_HW_ID = 0xFFFE,
   RESULT_SIGNATURES_FAILED = 0xFFFD,
   RESULT_VERSION_FAILED = 0xFFFC,
+  RESULT_OUT_OF_TOKENS = 0xFFFB,  // the tokens can't hold an element of the metadata
+  RESULT_TOO_LARGE = 0xFFFA,      // the metadata is over the byte or token budget of the parse
   RESULT_IN_PROGRESS = 0x0000,
   RESULT_END_FOUND = 0x0001,
   RESULT_END_NOT_FOUND = 0x0002,
 } targets_result_t;
 
 void uptane_parse_targets_init(void);
-int uptane_parse_targets_feed(const char *message, int16_t len, uptane_targets_t *out_targets, uint16_t *result);
+
+#define TARGETS_MAX_ECUS 32
+
+/* An ECU to look for in the targets metadata */
+typedef struct {
+  const char *ecuid;
+  size_t ecuid_len;
+  const char *hwid;
+  size_t hwid_len;
+} uptane_ecu_t;
+
+typedef enum {
+  TARGETS_BEGIN,          // initial state
+  TARGETS_IN_TOP,         // pointer in the top object (above "signatures" and "signed")
+  TARGETS_IN_SIGNATURES,  // pointer in the "signatures" object
+  TARGETS_BEFORE_SIGNED,  // pointer consumed "signed" object name and waits for the object
+  TARGETS_IN_SIGNED,      // pointer in the "signed" object
+  TARGETS_IN_IGNORED,     // pointer inside ignored object/array
+  TARGETS_IN_TARGETS,     // pointer inside "signed"."targets" object
+  TARGETS_IN_ERROR        // encountered an error, sink state
+} targets_parsing_state_t;
+
+/* One targets metadata being verified. The functions without a context use a default one with the pools of
+ * common_data_api.h. A context with pools of its own can be fed interleaved with others, e.g. the director's and the
+ * image repository's metadata, or metadata for several secondaries. The members are private to targets.c.
+ */
+typedef struct {
+  // pools, from uptane_targets_ctx_setup()
+  jsmntok_t *tokens;
+  jsmnint_t num_tokens;
+  crypto_key_and_signature_t *signatures;
+  unsigned int max_signatures;
+  crypto_verify_ctx_t *const *verify_ctxs;
+  unsigned int num_verify_ctxs;
+  crypto_hash_ctx_t *hash;  // digests the metadata with UPTINY_TARGETS_CACHE
+  uptane_root_t *root;      // NULL for state_get_root()
+
+  jsmn_parser parser;               // jsmn parser
+  jsmn_parser pending_scan;         // bracket depth of an incomplete target at the start of the unconsumed tail
+  jsmnint_t token_pos;              // current position in jsmn token array
+  jsmnint_t ignored_top_token_pos;  // position of ignored object token in jsmn token array
+  jsmnint_t signed_top_token_pos;   // position of "signed" object token in jsmn token array
+  jsmnint_t targets_top_token_pos;  // position of "signed"."targets" object token in jsmn token array
+  targets_parsing_state_t state;
+  targets_parsing_state_t prev_state;  // state to return to from TARGETS_IN_IGNORED
+
+  uptane_ecu_t own_ecu;           // this ECU, the list of ECUs after uptane_targets_ctx_init()
+  const uptane_ecu_t *ecus;       // ECUs to look for
+  unsigned int num_ecus;
+  uptane_targets_t *ecu_targets;  // per-ECU output, NULL if the target goes to out_targets
+  bool *ecu_found;                // per-ECU found flags, NULL with ecu_targets
+  uint32_t found_mask;            // bit i is set if a target for ecus[i] has been found
+  uptane_targets_t *images;       // targets of the own ECU's partitions, NULL for a single target
+  unsigned int max_images;
+  unsigned int *num_images;
+
+  int signed_elems_read;   // number of elements of "signed" object already read
+  int targets_elems_read;  // number of elements of "signed".targets object already read
+
+  unsigned int num_signatures;  // number of signatures read
+  unsigned int num_verifying;   // number of contexts in verify_ctxs hashing the signed part
+  jsmnint_t begin_signed;       // position in incoming message part where signed object begins
+  jsmnint_t end_signed;         // position in incoming message part where signed object ends
+
+  bool in_signed;  // if the signature verification is in progress. Different from 'state == TARGETS_IN_SIGNED' in that
+                   // the state machine operates independently of signature verification and the two values can be out
+                   // of sync for a short time.
+  bool tokens_exhausted;     // the last jsmn_parse ran out of tokens
+  bool signatures_trusted;  // set by uptane_targets_ctx_trust_signatures()
+  bool signed_buffered;     // set by uptane_targets_ctx_signed_buffered()
+  const char *signed_data;  // beginning of the "signed" object in the caller's buffer, with signed_buffered
+  jsmnint_t tail_length;  // number of bytes fed, but not consumed on the last call. Used for signature verification
+
+  uint32_t max_bytes;       // budgets of the parse, see UPTINY_TARGETS_MAX_BYTES
+  uint32_t max_tokens;
+  uint32_t bytes_consumed;  // of the metadata, before the current message part
+  uint32_t tokens_used;     // consumed so far, a skipped target counts as two
+
+#ifdef UPTINY_TARGETS_CACHE
+  // The last metadata whose signatures met the threshold. When the same signatures come again, only the digest of the
+  // signed part is compared. Identical signatures can't be valid for different data without a SHA-512 collision
+  struct {
+    bool valid;
+    int32_t root_version;  // the root the signatures were checked against
+    crypto_hash_t signatures_digest;
+    crypto_hash_t signed_digest;
+  } verified_cache;
+  crypto_hash_t signatures_digest;  // of the signatures being parsed
+  bool cache_candidate;             // the signatures are the cached ones
+#endif
+} uptane_targets_ctx_t;
+
+/* Like uptane_parse_targets_init, but the feed looks for the targets of several ECUs in one pass with one signature
+ * check. targets[i] receives the target for ecus[i] and found[i] tells if there was one. The version and expiration
+ * date go to the out_targets of uptane_parse_targets_feed and to every targets[i] found. The result is
+ * RESULT_END_FOUND if any of the ECUs has a target. All arrays must stay valid until the parsing ends.
+ */
+bool uptane_parse_targets_init_ecus(const uptane_ecu_t *ecus, unsigned int num_ecus, uptane_targets_t *targets,
+                                    bool *found);
+int uptane_parse_targets_feed(const char *message, jsmnint_t len, uptane_targets_t *out_targets, uint16_t *result);
+
+/* Like uptane_parse_targets_init, but this ECU may have a target for each of its partitions, told apart by the
+ * "partition" string in the target's custom. They go to images[0] to images[*num_images - 1] in the order of the
+ * metadata, with one signature check for all of them, and out_targets of the feed only gets the version and
+ * expiration date. Two targets for the same partition, or more than max_images, fail with RESULT_ERROR. The arrays
+ * must stay valid until the parsing ends.
+ */
+bool uptane_parse_targets_init_images(uptane_targets_t *images, unsigned int max_images, unsigned int *num_images);
+
+/* One contiguous piece of a message part */
+typedef struct {
+  const char *data;
+  jsmnint_t len;
+} uptane_segment_t;
+
+/* Size of the buffer uptane_parse_targets_feed_segments joins segments in. It must hold the longest element (a
+ * target, the "signatures" object or a name/value pair) that can straddle a segment boundary.
+ */
+#ifndef TARGETS_SEGMENT_CARRY_SIZE
+#define TARGETS_SEGMENT_CARRY_SIZE 512
+#endif
+
+/* Same as uptane_parse_targets_feed, but the message part is the concatenation of the segments, e.g. the two halves
+ * of a wrapped ring buffer. The segments are parsed in place, only an element straddling a boundary is copied. The
+ * return value counts the consumed characters of the whole part, the rest has to be presented again at the start of
+ * the next call. Can be mixed with uptane_parse_targets_feed.
+ */
+int uptane_parse_targets_feed_segments(const uptane_segment_t *segments, unsigned int num_segments,
+                                       uptane_targets_t *out_targets, uint16_t *result);
+
+/* The signed part of a message may still be hashed in the background when uptane_parse_targets_feed returns. The
+ * message must stay untouched until this returns false. It is only read, by the root parser too, and may be in
+ * read-only memory like memory-mapped flash.
+ */
+bool uptane_parse_targets_busy(void);
+
+/* Gives ctx its pools: tokens, signatures and verify_ctxs work like token_pool, signature_pool and crypto_ctx_pool,
+ * hash like hash_context. Contexts fed interleaved must not share any of them. The signatures are checked with the
+ * keys of root, or of state_get_root() if it is NULL; root must stay valid while ctx is used.
+ */
+void uptane_targets_ctx_setup(uptane_targets_ctx_t *ctx, jsmntok_t *tokens, jsmnint_t num_tokens,
+                              crypto_key_and_signature_t *signatures, unsigned int max_signatures,
+                              crypto_verify_ctx_t *const *verify_ctxs, unsigned int num_verify_ctxs,
+                              crypto_hash_ctx_t *hash, uptane_root_t *root);
+
+/* The functions above on ctx instead of the default context */
+void uptane_targets_ctx_init(uptane_targets_ctx_t *ctx);
+bool uptane_targets_ctx_init_ecus(uptane_targets_ctx_t *ctx, const uptane_ecu_t *ecus, unsigned int num_ecus,
+                                  uptane_targets_t *targets, bool *found);
+bool uptane_targets_ctx_init_images(uptane_targets_ctx_t *ctx, uptane_targets_t *images, unsigned int max_images,
+                                    unsigned int *num_images);
+int uptane_targets_ctx_feed(uptane_targets_ctx_t *ctx, const char *message, jsmnint_t len,
+                            uptane_targets_t *out_targets, uint16_t *result);
+int uptane_targets_ctx_feed_segments(uptane_targets_ctx_t *ctx, const uptane_segment_t *segments,
+                                     unsigned int num_segments, uptane_targets_t *out_targets, uint16_t *result);
+bool uptane_targets_ctx_busy(const uptane_targets_ctx_t *ctx);
+
+/* Call after init: the signatures of the metadata are parsed, but taken as meeting the threshold without being
+ * checked. Only for a caller that has checked them over the very bytes fed to ctx, e.g. once for several contexts
+ * looking for the targets of different ECUs.
+ */
+void uptane_targets_ctx_trust_signatures(uptane_targets_ctx_t *ctx);
+
+/* Call after init: the caller keeps the metadata in one buffer, every message fed is a pointer into it, and nothing
+ * from the beginning of the "signed" object on is moved or overwritten until the feed returns the final result. The
+ * signatures are then checked one after another over the "signed" object in place, all in the first verify context,
+ * like uptane_parse_root_buffered. Not for uptane_targets_ctx_feed_segments.
+ */
+void uptane_targets_ctx_signed_buffered(uptane_targets_ctx_t *ctx);
+void uptane_parse_targets_signed_buffered(void);
+
+/* Call after init: replaces UPTINY_TARGETS_MAX_BYTES and UPTINY_TARGETS_MAX_TOKENS for this parse, 0 for no limit.
+ * The feed fails with RESULT_TOO_LARGE and sets ATTACK_TARGETS_LARGE as soon as a message part reaches past max_bytes
+ * from the start of the metadata, or more than max_tokens have been parsed, before it hashes the part.
+ */
+void uptane_targets_ctx_set_budget(uptane_targets_ctx_t *ctx, uint32_t max_bytes, uint32_t max_tokens);
+void uptane_parse_targets_set_budget(uint32_t max_bytes, uint32_t max_tokens);
+
+/* SHA-512 of the "signed" object of the last metadata fed to ctx whose signatures met the threshold, as it was fed.
+ * Right after a feed that found the end of the metadata, it identifies the metadata to a primary that has to decide
+ * whether to send it again. Returns false if there is none, or if built without UPTINY_TARGETS_CACHE, which keeps it.
+ */
+bool uptane_targets_ctx_signed_digest(const uptane_targets_ctx_t *ctx, crypto_hash_t *digest);
+bool uptane_parse_targets_signed_digest(crypto_hash_t *digest);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,941 @@
+#include "targets_cbor.h"
+
+#include "common_data_api.h"
+#include "crypto_api.h"
+#include "crypto_common.h"
+#include "debug.h"
+#include "signatures.h"
+#include "state_api.h"
+#include "stats.h"
+#include "utils.h"
+
+#include <string.h>
+
+// CBOR major types
+enum {
+  CBOR_UINT = 0,
+  CBOR_NEGINT = 1,
+  CBOR_BYTES = 2,
+  CBOR_TEXT = 3,
+  CBOR_ARRAY = 4,
+  CBOR_MAP = 5,
+  CBOR_TAG = 6,
+  CBOR_SIMPLE = 7,
+};
+
+/*
+ * State variables, initialized in uptane_parse_targets_cbor_init()
+ */
+typedef enum {
+  CBOR_TARGETS_BEGIN,           // initial state
+  CBOR_TARGETS_IN_TOP,          // waiting for a key of the top map
+  CBOR_TARGETS_IN_SIGNATURES,   // waiting for the whole "signatures" array
+  CBOR_TARGETS_BEFORE_SIGNED,   // waiting for the head of the "signed" map
+  CBOR_TARGETS_IN_SIGNED,       // waiting for a member of "signed"
+  CBOR_TARGETS_BEFORE_TARGETS,  // waiting for the head of the "signed"."targets" map
+  CBOR_TARGETS_IN_TARGETS,      // waiting for a whole target, name and value
+  CBOR_TARGETS_IN_IGNORED,      // skipping an unknown value
+  CBOR_TARGETS_DONE,            // the top map is complete
+  CBOR_TARGETS_IN_ERROR         // encountered an error, sink state
+} cbor_state_t;
+
+static cbor_state_t state;
+static cbor_state_t prev_state;  // state to return to from CBOR_TARGETS_IN_IGNORED
+
+static uint32_t top_left;      // members of the top map not read yet
+static uint32_t signed_left;   // members of "signed" not read yet
+static uint32_t targets_left;  // targets not read yet
+static uint32_t skip_items;    // items of the ignored value left to skip
+static uint32_t skip_bytes;    // bytes of a string inside the ignored value left to skip
+
+static unsigned int num_signatures;  // number of signatures read
+static bool in_signed;               // the signed part is being hashed
+static bool target_found;            // found a target for this ECU
+
+void uptane_parse_targets_cbor_init(void) {
+  state = CBOR_TARGETS_BEGIN;
+  top_left = signed_left = targets_left = 0;
+  skip_items = skip_bytes = 0;
+  num_signatures = 0;
+  in_signed = false;
+  target_found = false;
+  UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_BEGIN);
+}
+
+// decodes the head of the item at p. Returns its length, 0 if it doesn't end before 'end' and -1 for indefinite
+// lengths and 8 byte arguments
+static int cbor_head(const uint8_t *p, const uint8_t *end, uint8_t *major, uint32_t *arg) {
+  if (p >= end) {
+    return 0;
+  }
+  *major = (uint8_t)(p[0] >> 5);
+  uint8_t info = p[0] & 0x1f;
+  if (info < 24) {
+    *arg = info;
+    return 1;
+  }
+
+  int arg_len;
+  switch (info) {
+    case 24:
+      arg_len = 1;
+      break;
+    case 25:
+      arg_len = 2;
+      break;
+    case 26:
+      arg_len = 4;
+      break;
+    default:
+      DEBUG_PRINTF("Unsupported CBOR item: 0x%02x\n", p[0]);
+      return -1;
+  }
+  if (end - p <= arg_len) {
+    return 0;
+  }
+  uint32_t value = 0;
+  for (int i = 1; i <= arg_len; ++i) {
+    value = (value << 8) | p[i];
+  }
+  *arg = value;
+  return 1 + arg_len;
+}
+
+// length of the whole item at p, 0 if it doesn't end before 'end' and -1 if it can't be parsed
+static jsmnint_t cbor_item_len(const uint8_t *p, const uint8_t *end) {
+  const uint8_t *cur = p;
+  uint32_t pending = 1;  // items still to read, every one of them is at least one byte long
+
+  while (pending > 0) {
+    uint8_t major;
+    uint32_t arg;
+    int head_len = cbor_head(cur, end, &major, &arg);
+    if (head_len <= 0) {
+      return (jsmnint_t)head_len;
+    }
+    cur += head_len;
+    --pending;
+
+    uint32_t avail = (uint32_t)(end - cur);
+    switch (major) {
+      case CBOR_BYTES:
+      case CBOR_TEXT:
+        if (arg > avail) {
+          return 0;
+        }
+        cur += arg;
+        break;
+      case CBOR_MAP:
+        if (arg > avail / 2) {
+          return 0;
+        }
+        pending += 2 * arg;
+        break;
+      case CBOR_ARRAY:
+        if (arg > avail) {
+          return 0;
+        }
+        pending += arg;
+        break;
+      case CBOR_TAG:
+        ++pending;
+        break;
+      default:
+        break;
+    }
+    if (pending > (uint32_t)(end - cur)) {
+      return 0;
+    }
+  }
+  return (jsmnint_t)(cur - p);
+}
+
+/*
+ * Readers for items known to be complete, see cbor_item_len()
+ */
+static uint8_t read_head(const uint8_t **p, const uint8_t *end, uint32_t *arg) {
+  uint8_t major;
+  *p += cbor_head(*p, end, &major, arg);
+  return major;
+}
+
+static void skip_item(const uint8_t **p, const uint8_t *end) { *p += cbor_item_len(*p, end); }
+
+// reads a byte or text string, returns NULL and skips the item if it has another type
+static const uint8_t *read_string(const uint8_t **p, const uint8_t *end, uint8_t major, uint32_t *len) {
+  const uint8_t *item = *p;
+  if (read_head(p, end, len) != major) {
+    *p = item;
+    skip_item(p, end);
+    return NULL;
+  }
+  const uint8_t *str = *p;
+  *p += *len;
+  return str;
+}
+
+static inline bool cbor_strn_equal(const uint8_t *str, uint32_t len, const char *value, size_t value_len) {
+  return len == value_len && memcmp(str, value, value_len) == 0;
+}
+
+#define cbor_lit_equal(str, len, literal) cbor_strn_equal((str), (len), "" literal "", sizeof(literal) - 1)
+
+typedef enum {
+  PARSE_TARGET_ERROR,
+  PARSE_TARGET_NOTFORME,
+  PARSE_TARGET_FORME,
+  PARSE_TARGET_WRONG_HW_ID,
+} parse_target_result_t;
+
+// sets *for_me if this ECU is listed. Returns PARSE_TARGET_FORME if the identifiers are fine, regardless of that
+static parse_target_result_t parse_ecu_identifiers(const uint8_t **p, const uint8_t *end, bool *for_me) {
+  uint32_t size;
+  if (read_head(p, end, &size) != CBOR_MAP) {
+    DEBUG_PRINTF("Map expected\n");
+    return PARSE_TARGET_ERROR;
+  }
+
+  for (uint32_t i = 0; i < size; ++i) {
+    uint32_t ecuid_len;
+    const uint8_t *ecuid = read_string(p, end, CBOR_TEXT, &ecuid_len);
+    bool is_for_me = ecuid != NULL && cbor_strn_equal(ecuid, ecuid_len, state_get_ecuid(), state_get_ecuid_len());
+
+    uint32_t ecu_size;
+    if (read_head(p, end, &ecu_size) != CBOR_MAP) {
+      DEBUG_PRINTF("Map expected\n");
+      return PARSE_TARGET_ERROR;
+    }
+    for (uint32_t j = 0; j < ecu_size; ++j) {
+      uint32_t key_len;
+      const uint8_t *key = read_string(p, end, CBOR_TEXT, &key_len);
+      if (key != NULL && cbor_lit_equal(key, key_len, "hardwareId")) {
+        uint32_t hwid_len;
+        const uint8_t *hwid = read_string(p, end, CBOR_TEXT, &hwid_len);
+        if (is_for_me && (hwid == NULL || !cbor_strn_equal(hwid, hwid_len, state_get_hwid(), state_get_hwid_len()))) {
+          DEBUG_PRINTF("Invalid hardware identifier\n");
+          return PARSE_TARGET_WRONG_HW_ID;
+        }
+      } else {
+        skip_item(p, end);
+      }
+    }
+    if (is_for_me) {
+      *for_me = true;
+    }
+  }
+  return PARSE_TARGET_FORME;
+}
+
+static parse_target_result_t parse_hashes(const uint8_t **p, const uint8_t *end, uptane_targets_t *target) {
+  uint32_t size;
+  if (read_head(p, end, &size) != CBOR_MAP) {
+    DEBUG_PRINTF("Map expected\n");
+    return PARSE_TARGET_ERROR;
+  }
+
+  int hash_idx = 0;
+  for (uint32_t i = 0; i < size; ++i) {
+    uint32_t alg_len;
+    const uint8_t *alg_name = read_string(p, end, CBOR_TEXT, &alg_len);
+    crypto_hash_algorithm_t alg =
+        (alg_name != NULL) ? crypto_str_to_hashtype((const char *)alg_name, alg_len) : CRYPTO_HASH_UNKNOWN;
+#if UPTINY_TARGETS_ONE_HASH
+    // the one kept is the one the image is checked with, like in targets.c
+    if (hash_idx > 0 && alg == state_get_supported_hash() && target->hashes[0].alg != alg) {
+      hash_idx = 0;
+    }
+#endif
+    if (alg == CRYPTO_HASH_UNKNOWN || hash_idx >= TARGETS_MAX_HASHES) {
+      DEBUG_PRINTF("Hash skipped\n");
+      skip_item(p, end);
+      continue;
+    }
+
+    uint32_t hash_len;
+    const uint8_t *hash = read_string(p, end, CBOR_BYTES, &hash_len);
+    if (hash == NULL || hash_len != crypto_get_hashlen(alg)) {
+      DEBUG_PRINTF("Invalid hash\n");
+      return PARSE_TARGET_ERROR;
+    }
+    target->hashes[hash_idx].alg = alg;
+    memcpy(target->hashes[hash_idx].hash, hash, hash_len);
+    ++hash_idx;
+  }
+  target->hashes_num = hash_idx;
+  return PARSE_TARGET_FORME;
+}
+
+// "delta": {"from": {alg: bstr, ...}, "length": uint}. The base hash of the supported algorithm is kept if it is listed.
+static parse_target_result_t parse_delta(const uint8_t **p, const uint8_t *end, uptane_targets_t *target) {
+  uint32_t size;
+  if (read_head(p, end, &size) != CBOR_MAP) {
+    DEBUG_PRINTF("Map expected\n");
+    return PARSE_TARGET_ERROR;
+  }
+
+  bool have_base = false;
+  crypto_hash_algorithm_t supported = state_get_supported_hash();
+  for (uint32_t i = 0; i < size; ++i) {
+    uint32_t key_len;
+    const uint8_t *key = read_string(p, end, CBOR_TEXT, &key_len);
+    if (key != NULL && cbor_lit_equal(key, key_len, "from")) {
+      uint32_t from_size;
+      if (read_head(p, end, &from_size) != CBOR_MAP) {
+        DEBUG_PRINTF("Map expected\n");
+        return PARSE_TARGET_ERROR;
+      }
+      for (uint32_t j = 0; j < from_size; ++j) {
+        uint32_t alg_len;
+        const uint8_t *alg_name = read_string(p, end, CBOR_TEXT, &alg_len);
+        crypto_hash_algorithm_t alg =
+            (alg_name != NULL) ? crypto_str_to_hashtype((const char *)alg_name, alg_len) : CRYPTO_HASH_UNKNOWN;
+        if (alg == CRYPTO_HASH_UNKNOWN) {
+          skip_item(p, end);
+          continue;
+        }
+
+        uint32_t hash_len;
+        const uint8_t *hash = read_string(p, end, CBOR_BYTES, &hash_len);
+        if (hash == NULL || hash_len != crypto_get_hashlen(alg)) {
+          DEBUG_PRINTF("Invalid delta base hash\n");
+          return PARSE_TARGET_ERROR;
+        }
+        if (!have_base || alg == supported) {
+          target->delta_base.alg = alg;
+          memcpy(target->delta_base.hash, hash, hash_len);
+          have_base = true;
+        }
+      }
+    } else if (key != NULL && cbor_lit_equal(key, key_len, "length")) {
+      uint32_t length;
+      if (read_head(p, end, &length) != CBOR_UINT || length == 0) {
+        DEBUG_PRINTF("Invalid delta length\n");
+        return PARSE_TARGET_ERROR;
+      }
+      target->delta_length = length;
+    } else {
+      skip_item(p, end);
+    }
+  }
+
+  if (!have_base || target->delta_length == 0) {
+    DEBUG_PRINTF("Delta without length or base hash\n");
+    return PARSE_TARGET_ERROR;
+  }
+  return PARSE_TARGET_FORME;
+}
+
+// "compression": {"method": "heatshrink", "length": uint}
+static parse_target_result_t parse_compression(const uint8_t **p, const uint8_t *end, uptane_targets_t *target) {
+  uint32_t size;
+  if (read_head(p, end, &size) != CBOR_MAP) {
+    DEBUG_PRINTF("Map expected\n");
+    return PARSE_TARGET_ERROR;
+  }
+
+  bool method_found = false;
+  for (uint32_t i = 0; i < size; ++i) {
+    uint32_t key_len;
+    const uint8_t *key = read_string(p, end, CBOR_TEXT, &key_len);
+    if (key != NULL && cbor_lit_equal(key, key_len, "method")) {
+      uint32_t method_len;
+      const uint8_t *method = read_string(p, end, CBOR_TEXT, &method_len);
+      if (method == NULL || !cbor_lit_equal(method, method_len, "heatshrink")) {
+        DEBUG_PRINTF("Unsupported compression\n");
+        return PARSE_TARGET_ERROR;
+      }
+      method_found = true;
+    } else if (key != NULL && cbor_lit_equal(key, key_len, "length")) {
+      uint32_t length;
+      if (read_head(p, end, &length) != CBOR_UINT || length == 0) {
+        DEBUG_PRINTF("Invalid compressed length\n");
+        return PARSE_TARGET_ERROR;
+      }
+      target->compressed_length = length;
+    } else {
+      skip_item(p, end);
+    }
+  }
+
+  if (!method_found || target->compressed_length == 0) {
+    DEBUG_PRINTF("Compression without method or length\n");
+    return PARSE_TARGET_ERROR;
+  }
+  return PARSE_TARGET_FORME;
+}
+
+// "chunks": {"size": uint, "root": {alg: bstr, ...}}. The root of the supported algorithm is kept if it is listed.
+static parse_target_result_t parse_chunks(const uint8_t **p, const uint8_t *end, uptane_targets_t *target) {
+  uint32_t size;
+  if (read_head(p, end, &size) != CBOR_MAP) {
+    DEBUG_PRINTF("Map expected\n");
+    return PARSE_TARGET_ERROR;
+  }
+
+  bool have_root = false;
+  crypto_hash_algorithm_t supported = state_get_supported_hash();
+  for (uint32_t i = 0; i < size; ++i) {
+    uint32_t key_len;
+    const uint8_t *key = read_string(p, end, CBOR_TEXT, &key_len);
+    if (key != NULL && cbor_lit_equal(key, key_len, "root")) {
+      uint32_t root_size;
+      if (read_head(p, end, &root_size) != CBOR_MAP) {
+        DEBUG_PRINTF("Map expected\n");
+        return PARSE_TARGET_ERROR;
+      }
+      for (uint32_t j = 0; j < root_size; ++j) {
+        uint32_t alg_len;
+        const uint8_t *alg_name = read_string(p, end, CBOR_TEXT, &alg_len);
+        crypto_hash_algorithm_t alg =
+            (alg_name != NULL) ? crypto_str_to_hashtype((const char *)alg_name, alg_len) : CRYPTO_HASH_UNKNOWN;
+        if (alg == CRYPTO_HASH_UNKNOWN) {
+          skip_item(p, end);
+          continue;
+        }
+
+        uint32_t hash_len;
+        const uint8_t *hash = read_string(p, end, CBOR_BYTES, &hash_len);
+        if (hash == NULL || hash_len != crypto_get_hashlen(alg)) {
+          DEBUG_PRINTF("Invalid chunk root hash\n");
+          return PARSE_TARGET_ERROR;
+        }
+        if (!have_root || alg == supported) {
+          target->chunk_root.alg = alg;
+          memcpy(target->chunk_root.hash, hash, hash_len);
+          have_root = true;
+        }
+      }
+    } else if (key != NULL && cbor_lit_equal(key, key_len, "size")) {
+      uint32_t chunk_size;
+      if (read_head(p, end, &chunk_size) != CBOR_UINT || chunk_size == 0) {
+        DEBUG_PRINTF("Invalid chunk size\n");
+        return PARSE_TARGET_ERROR;
+      }
+      target->chunk_size = chunk_size;
+    } else {
+      skip_item(p, end);
+    }
+  }
+
+  if (!have_root || target->chunk_size == 0) {
+    DEBUG_PRINTF("Chunks without size or root hash\n");
+    return PARSE_TARGET_ERROR;
+  }
+  return PARSE_TARGET_FORME;
+}
+
+// parses the target name and value pair at *p, which is complete up to 'end'
+static parse_target_result_t parse_target(const uint8_t **p, const uint8_t *end, uptane_targets_t *target) {
+  uint32_t name_len;
+  const uint8_t *name = read_string(p, end, CBOR_TEXT, &name_len);
+  if (name != NULL && name_len > TARGETS_MAX_NAME_LENGTH && UPTINY_TARGETS_NAME_TRUNCATE) {
+    name_len = TARGETS_MAX_NAME_LENGTH;
+  }
+  if (name == NULL || name_len == 0 || name_len > TARGETS_MAX_NAME_LENGTH) {
+    DEBUG_PRINTF("Invalid target name\n");
+    return PARSE_TARGET_ERROR;
+  }
+  memcpy(target->name, name, name_len);
+  target->name[name_len] = '\0';
+  target->hashes_num = 0;
+  target->delta_length = 0;
+  target->compressed_length = 0;
+  target->chunk_size = 0;
+
+  uint32_t size;
+  if (read_head(p, end, &size) != CBOR_MAP) {
+    DEBUG_PRINTF("Map expected\n");
+    return PARSE_TARGET_ERROR;
+  }
+
+  bool target_for_me = false;
+  for (uint32_t i = 0; i < size; ++i) {
+    parse_target_result_t res = PARSE_TARGET_FORME;
+    uint32_t key_len;
+    const uint8_t *key = read_string(p, end, CBOR_TEXT, &key_len);
+
+    if (key == NULL) {
+      skip_item(p, end);
+    } else if (cbor_lit_equal(key, key_len, "custom")) {
+      uint32_t custom_size;
+      if (read_head(p, end, &custom_size) != CBOR_MAP) {
+        DEBUG_PRINTF("Map expected\n");
+        return PARSE_TARGET_ERROR;
+      }
+      for (uint32_t j = 0; j < custom_size && res == PARSE_TARGET_FORME; ++j) {
+        uint32_t custom_key_len;
+        const uint8_t *custom_key = read_string(p, end, CBOR_TEXT, &custom_key_len);
+        if (custom_key != NULL && cbor_lit_equal(custom_key, custom_key_len, "ecuIdentifiers")) {
+          res = parse_ecu_identifiers(p, end, &target_for_me);
+        } else if (custom_key != NULL && cbor_lit_equal(custom_key, custom_key_len, "delta")) {
+          res = parse_delta(p, end, target);
+        } else if (custom_key != NULL && cbor_lit_equal(custom_key, custom_key_len, "compression")) {
+          res = parse_compression(p, end, target);
+        } else if (custom_key != NULL && cbor_lit_equal(custom_key, custom_key_len, "chunks")) {
+          res = parse_chunks(p, end, target);
+        } else {
+          skip_item(p, end);
+        }
+      }
+    } else if (cbor_lit_equal(key, key_len, "hashes")) {
+      res = parse_hashes(p, end, target);
+    } else if (cbor_lit_equal(key, key_len, "length")) {
+      uint32_t length;
+      if (read_head(p, end, &length) != CBOR_UINT) {
+        DEBUG_PRINTF("Invalid target length\n");
+        return PARSE_TARGET_ERROR;
+      }
+      target->length = length;
+    } else {
+      skip_item(p, end);
+    }
+
+    if (res != PARSE_TARGET_FORME) {
+      return res;
+    }
+  }
+  return target_for_me ? PARSE_TARGET_FORME : PARSE_TARGET_NOTFORME;
+}
+
+// parses the "signatures" array at *p, which is complete up to 'end'. Returns the number of usable signatures
+static int parse_signatures(const uint8_t **p, const uint8_t *end) {
+  uptane_root_t *root = state_get_root();
+  unsigned int max_sigs = (signature_pool_size < crypto_ctx_pool_size) ? signature_pool_size : crypto_ctx_pool_size;
+  unsigned int sigs_read = 0;
+  if (max_sigs > uptane_signatures_wanted(root->targets_threshold)) {
+    max_sigs = uptane_signatures_wanted(root->targets_threshold);
+  }
+
+  uint32_t num;
+  if (read_head(p, end, &num) != CBOR_ARRAY) {
+    DEBUG_PRINTF("Array expected\n");
+    return -1;
+  }
+  for (uint32_t i = 0; i < num; ++i) {
+    uint32_t size;
+    if (read_head(p, end, &size) != CBOR_MAP) {
+      DEBUG_PRINTF("Map expected\n");
+      return -1;
+    }
+
+    const crypto_key_t *key = NULL;
+    const uint8_t *sig = NULL;
+    for (uint32_t j = 0; j < size; ++j) {
+      uint32_t name_len;
+      const uint8_t *name = read_string(p, end, CBOR_TEXT, &name_len);
+      uint32_t value_len;
+      if (name != NULL && cbor_lit_equal(name, name_len, "keyid")) {
+        const uint8_t *keyid = read_string(p, end, CBOR_BYTES, &value_len);
+        if (keyid != NULL && value_len == CRYPTO_KEYID_LEN) {
+          key = find_key_bin(keyid, root->targets_keys, root->targets_keys_num);
+        }
+      } else if (name != NULL && cbor_lit_equal(name, name_len, "sig")) {
+        sig = read_string(p, end, CBOR_BYTES, &value_len);
+        if (sig != NULL && value_len != CRYPTO_MAX_SIGNATURE_LEN) {
+          DEBUG_PRINTF("Unexpected signature size\n");
+          sig = NULL;
+        }
+      } else {
+        skip_item(p, end);  // method is ignored for now
+      }
+    }
+
+    if (key != NULL && sig != NULL) {
+      if (sigs_read >= max_sigs) {
+        DEBUG_PRINTF("Enough signatures, only %d are used\n", sigs_read);
+        continue;
+      }
+      if (uptane_signatures_have_key(signature_pool, sigs_read, key)) {
+        DEBUG_PRINTF("Another signature by the same key, ignored\n");
+        continue;
+      }
+      signature_pool[sigs_read].key = key;
+      memcpy(signature_pool[sigs_read].sig, sig, CRYPTO_MAX_SIGNATURE_LEN);
+      ++sigs_read;
+    }
+  }
+  return (int)sigs_read;
+}
+
+// parses the value of a member of "signed" other than "targets"
+static uint16_t parse_signed_member(const uint8_t *key, uint32_t key_len, const uint8_t *value, const uint8_t *end,
+                                    uptane_targets_t *out_targets) {
+  uint32_t str_len;
+  const uint8_t *str;
+
+  if (cbor_lit_equal(key, key_len, "_type")) {
+    str = read_string(&value, end, CBOR_TEXT, &str_len);
+    if (str == NULL || !cbor_lit_equal(str, str_len, "Targets")) {
+      DEBUG_PRINTF("Wrong type of targets metadata\n");
+      return RESULT_ERROR;
+    }
+  } else if (cbor_lit_equal(key, key_len, "expires")) {
+    str = read_string(&value, end, CBOR_TEXT, &str_len);
+    if (str == NULL || !str2time((const char *)str, (int)str_len, &out_targets->expires)) {
+      DEBUG_PRINTF("Invalid expiration date\n");
+      return RESULT_ERROR;
+    }
+  } else {  // "version"
+    uint32_t version;
+    if (read_head(&value, end, &version) != CBOR_UINT || version > INT32_MAX) {
+      DEBUG_PRINTF("Invalid version\n");
+      return RESULT_ERROR;
+    }
+    if ((int32_t)version < state_get_targets()->version) {
+      return RESULT_VERSION_FAILED;
+    }
+    out_targets->version = (int)version;
+  }
+  return RESULT_IN_PROGRESS;
+}
+
+// skips as much of the ignored value as this message part has. Returns 1 once it is skipped, 0 if it goes on in the
+// next part and -1 on error
+static int skip_ignored(const uint8_t **pos, const uint8_t *end) {
+  while (skip_items > 0 || skip_bytes > 0) {
+    if (skip_bytes > 0) {
+      uint32_t avail = (uint32_t)(end - *pos);
+      uint32_t n = (skip_bytes < avail) ? skip_bytes : avail;
+      *pos += n;
+      skip_bytes -= n;
+      if (skip_bytes > 0) {
+        return 0;
+      }
+      continue;
+    }
+
+    uint8_t major;
+    uint32_t arg;
+    int head_len = cbor_head(*pos, end, &major, &arg);
+    if (head_len <= 0) {
+      return head_len;
+    }
+    *pos += head_len;
+    --skip_items;
+
+    switch (major) {
+      case CBOR_BYTES:
+      case CBOR_TEXT:
+        skip_bytes = arg;
+        break;
+      case CBOR_MAP:
+        if (arg > UINT32_MAX - skip_items) {
+          return -1;
+        }
+        skip_items += arg;
+        // fall through
+      case CBOR_ARRAY:
+        if (arg > UINT32_MAX - skip_items) {
+          return -1;
+        }
+        skip_items += arg;
+        break;
+      case CBOR_TAG:
+        ++skip_items;
+        break;
+      default:
+        break;
+    }
+  }
+  return 1;
+}
+
+// the key at pos, NULL if it is not complete yet or invalid, the latter also sets the error state. *key_end is where
+// its value begins
+static const uint8_t *read_key(const uint8_t *pos, const uint8_t *end, uint32_t *key_len, const uint8_t **key_end) {
+  jsmnint_t len = cbor_item_len(pos, end);
+  if (len <= 0) {
+    if (len < 0) {
+      state = CBOR_TARGETS_IN_ERROR;
+    }
+    return NULL;
+  }
+  *key_end = pos + len;
+  const uint8_t *key = read_string(&pos, end, CBOR_TEXT, key_len);
+  if (key == NULL) {
+    DEBUG_PRINTF("Text key expected\n");
+    state = CBOR_TARGETS_IN_ERROR;
+  }
+  return key;
+}
+
+static void begin_ignored(cbor_state_t from) {
+  prev_state = from;
+  state = CBOR_TARGETS_IN_IGNORED;
+  skip_items = 1;
+  skip_bytes = 0;
+}
+
+/*
+ * @return number of consumed bytes. The rest of the message should be presented to the parser on the next call
+ */
+int uptane_parse_targets_cbor_feed(const uint8_t *message, jsmnint_t len, uptane_targets_t *out_targets,
+                                   uint16_t *result) {
+  const uint8_t *end = message + len;
+  const uint8_t *pos = message;  // start of the data not consumed yet
+  const uint8_t *signed_begin = in_signed ? message : NULL;  // signed data consumed in this call
+  const uint8_t *signed_end = NULL;
+  bool more_needed = false;
+
+  // If the state is ERROR, don't try to parse the feed
+  if (state == CBOR_TARGETS_IN_ERROR) {
+    *result = RESULT_ERROR;
+    return -1;
+  }
+  UPTANE_STATS_COUNT(bytes_fed, len);
+
+  // Hashing of the previous part may still be going on
+  if (in_signed) {
+    crypto_verify_wait(crypto_ctx_pool, num_signatures);
+  }
+
+  while (!more_needed && state != CBOR_TARGETS_IN_ERROR && state != CBOR_TARGETS_DONE) {
+    uint8_t major;
+    uint32_t arg;
+    int head_len;
+    uint32_t key_len;
+    const uint8_t *key;
+    const uint8_t *key_end;
+    jsmnint_t item_len;
+
+    switch (state) {
+      case CBOR_TARGETS_BEGIN:
+      case CBOR_TARGETS_BEFORE_SIGNED:
+      case CBOR_TARGETS_BEFORE_TARGETS:
+        head_len = cbor_head(pos, end, &major, &arg);
+        if (head_len == 0) {
+          more_needed = true;
+          break;
+        }
+        if (head_len < 0 || major != CBOR_MAP) {
+          DEBUG_PRINTF("Map expected\n");
+          state = CBOR_TARGETS_IN_ERROR;
+          break;
+        }
+
+        if (state == CBOR_TARGETS_BEGIN) {
+          top_left = arg;
+          state = CBOR_TARGETS_IN_TOP;
+        } else if (state == CBOR_TARGETS_BEFORE_SIGNED) {
+          signed_left = arg;
+          signed_begin = pos;
+          for (unsigned int i = 0; i < num_signatures; i++) {
+            crypto_verify_init(crypto_ctx_pool[i], &signature_pool[i]);
+          }
+          in_signed = true;
+          state = CBOR_TARGETS_IN_SIGNED;
+        } else {
+          targets_left = arg;
+          state = CBOR_TARGETS_IN_TARGETS;
+        }
+        pos += head_len;
+        break;
+
+      case CBOR_TARGETS_IN_TOP:
+        if (top_left == 0) {
+          state = CBOR_TARGETS_DONE;
+          break;
+        }
+        key = read_key(pos, end, &key_len, &key_end);
+        if (key == NULL) {
+          more_needed = true;
+          break;
+        }
+        pos = key_end;
+        --top_left;
+
+        if (cbor_lit_equal(key, key_len, "signatures")) {
+          state = CBOR_TARGETS_IN_SIGNATURES;
+        } else if (cbor_lit_equal(key, key_len, "signed")) {
+          if (num_signatures == 0) {
+            DEBUG_PRINTF("Signatures are not available for the signed part\n");
+            state = CBOR_TARGETS_IN_ERROR;
+            break;
+          }
+          state = CBOR_TARGETS_BEFORE_SIGNED;
+        } else {
+          begin_ignored(CBOR_TARGETS_IN_TOP);
+        }
+        break;
+
+      case CBOR_TARGETS_IN_SIGNATURES:
+        item_len = cbor_item_len(pos, end);
+        if (item_len == 0) {
+          more_needed = true;
+          break;
+        }
+        if (item_len > 0) {
+          const uint8_t *sigs = pos;
+          int parse_res = parse_signatures(&sigs, pos + item_len);
+          if (parse_res > 0) {
+            num_signatures = (unsigned int)parse_res;
+            pos += item_len;
+            state = CBOR_TARGETS_IN_TOP;
+            break;
+          }
+        }
+        DEBUG_PRINTF("Failed to parse signatures\n");
+        state = CBOR_TARGETS_IN_ERROR;
+        break;
+
+      case CBOR_TARGETS_IN_SIGNED:
+        if (signed_left == 0) {
+          signed_end = pos;
+          state = CBOR_TARGETS_IN_TOP;
+          break;
+        }
+        key = read_key(pos, end, &key_len, &key_end);
+        if (key == NULL) {
+          more_needed = true;
+          break;
+        }
+
+        if (cbor_lit_equal(key, key_len, "_type") || cbor_lit_equal(key, key_len, "expires") ||
+            cbor_lit_equal(key, key_len, "version")) {
+          item_len = cbor_item_len(key_end, end);
+          if (item_len == 0) {
+            more_needed = true;  // the key is consumed together with its value
+            break;
+          }
+          uint16_t res = (item_len > 0) ? parse_signed_member(key, key_len, key_end, end, out_targets) : RESULT_ERROR;
+          if (res != RESULT_IN_PROGRESS) {
+            state = CBOR_TARGETS_IN_ERROR;
+            *result = res;
+            return -1;
+          }
+          pos = key_end + item_len;
+        } else if (cbor_lit_equal(key, key_len, "targets")) {
+          pos = key_end;
+          state = CBOR_TARGETS_BEFORE_TARGETS;
+        } else {
+          pos = key_end;
+          begin_ignored(CBOR_TARGETS_IN_SIGNED);
+        }
+        --signed_left;
+        break;
+
+      case CBOR_TARGETS_IN_TARGETS:
+        if (targets_left == 0) {
+          state = CBOR_TARGETS_IN_SIGNED;
+          break;
+        }
+        item_len = cbor_item_len(pos, end);
+        if (item_len > 0) {
+          jsmnint_t value_len = cbor_item_len(pos + item_len, end);
+          item_len = (value_len > 0) ? (jsmnint_t)(item_len + value_len) : value_len;
+        }
+        if (item_len == 0) {
+          more_needed = true;
+          break;
+        }
+        if (item_len < 0) {
+          state = CBOR_TARGETS_IN_ERROR;
+          break;
+        }
+
+        {
+          static uptane_targets_t tmp_target;
+          const uint8_t *target = pos;
+          switch (parse_target(&target, pos + item_len, &tmp_target)) {
+            case PARSE_TARGET_NOTFORME:
+              break;
+
+            case PARSE_TARGET_FORME:
+              if (target_found) {
+                DEBUG_PRINTF("Multiple targets for this ECU\n");
+                state = CBOR_TARGETS_IN_ERROR;
+                break;
+              }
+              target_found = true;
+              out_targets->hashes_num = tmp_target.hashes_num;
+              memcpy(&out_targets->name, &tmp_target.name, sizeof(tmp_target.name));
+              memcpy(&out_targets->hashes, &tmp_target.hashes, sizeof(tmp_target.hashes));
+              out_targets->length = tmp_target.length;
+              out_targets->delta_length = tmp_target.delta_length;
+              out_targets->delta_base = tmp_target.delta_base;
+              out_targets->compressed_length = tmp_target.compressed_length;
+              out_targets->chunk_size = tmp_target.chunk_size;
+              out_targets->chunk_root = tmp_target.chunk_root;
+              out_targets->partition[0] = '\0';  // partitions are only in the JSON metadata
+              break;
+
+            case PARSE_TARGET_WRONG_HW_ID:
+              state = CBOR_TARGETS_IN_ERROR;
+              *result = RESULT_WRONG_HW_ID;
+              return -1;
+
+            default:
+              DEBUG_PRINTF("Error parsing target\n");
+              state = CBOR_TARGETS_IN_ERROR;
+              break;
+          }
+        }
+        pos += item_len;
+        --targets_left;
+        break;
+
+      case CBOR_TARGETS_IN_IGNORED:
+        switch (skip_ignored(&pos, end)) {
+          case 1:
+            state = prev_state;
+            break;
+          case 0:
+            more_needed = true;
+            break;
+          default:
+            state = CBOR_TARGETS_IN_ERROR;
+            break;
+        }
+        break;
+
+      default:
+        DEBUG_PRINTF("Unexpected state\n");
+        state = CBOR_TARGETS_IN_ERROR;
+        break;
+    }
+  }
+
+  if (state == CBOR_TARGETS_IN_ERROR) {
+    *result = RESULT_ERROR;
+    return -1;
+  }
+
+  /* signature verification, the signed part is hashed as it is consumed */
+  if (signed_begin != NULL) {
+    const uint8_t *last = (signed_end != NULL) ? signed_end : pos;
+    if (num_signatures > 0) {
+      crypto_verify_feed_multi_start(crypto_ctx_pool, num_signatures, signed_begin, (size_t)(last - signed_begin));
+    }
+  }
+
+  if (signed_end != NULL) {
+    in_signed = false;
+    int threshold = state_get_root()->targets_threshold;
+    int num_valid_signatures = uptane_verify_signatures_result(num_signatures, threshold);
+
+    if (num_valid_signatures < threshold) {
+      DEBUG_PRINTF("Signature verification failed: only %d signatures are valid with threshold of %d\n",
+                   num_valid_signatures, threshold);
+      state = CBOR_TARGETS_IN_ERROR;
+      *result = RESULT_SIGNATURES_FAILED;
+      return -1;
+    }
+  }
+
+  if (state == CBOR_TARGETS_DONE) {
+    UPTANE_STATS_STAGE(UPTANE_STAGE_TARGETS_END);
+    *result = target_found ? RESULT_END_FOUND : RESULT_END_NOT_FOUND;
+  } else {
+    *result = RESULT_IN_PROGRESS;
+  }
+  return (int)(pos - message);
+}
+
+bool uptane_parse_targets_cbor_busy(void) {
+  for (unsigned int i = 0; in_signed && i < num_signatures; i++) {
+    if (crypto_verify_poll(crypto_ctx_pool[i]) != CRYPTO_OP_DONE) {
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,41 @@
+#ifndef LIBUPTINY_TARGETS_CBOR_H
+#define LIBUPTINY_TARGETS_CBOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "jsmn.h"
+#include "state_api.h"
+#include "targets.h"
+
+/* Targets metadata in CBOR (RFC 7049). The layout is the one of the JSON metadata with binary values where JSON has
+ * hex or base64 strings:
+ *
+ *   {"signatures": [{"keyid": bstr(32), "method": tstr, "sig": bstr(64)}, ...],
+ *    "signed": {"_type": "Targets", "expires": tstr, "version": uint,
+ *               "targets": {name: {"length": uint, "hashes": {"sha256": bstr(32), "sha512": bstr(64)},
+ *                                  "custom": {"ecuIdentifiers": {ecu_id: {"hardwareId": tstr}},
+ *                                             "delta": {"from": {"sha256": bstr(32), ...}, "length": uint},
+ *                                             "compression": {"method": tstr, "length": uint},
+ *                                             "chunks": {"size": uint, "root": {"sha256": bstr(32), ...}}}}}}}
+ *
+ * Only definite lengths and arguments of up to 4 bytes are accepted. Map keys not listed here are skipped, the
+ * signatures are over the encoded "signed" map. "signatures" has to come before "signed".
+ *
+ * Used like uptane_parse_targets_feed: the return value is the number of consumed bytes, the rest of the message
+ * part has to be presented again at the start of the next one. The results are the ones of targets_result_t.
+ */
+void uptane_parse_targets_cbor_init(void);
+int uptane_parse_targets_cbor_feed(const uint8_t *message, jsmnint_t len, uptane_targets_t *out_targets,
+                                   uint16_t *result);
+
+/* The signed part of a message may still be hashed in the background when uptane_parse_targets_cbor_feed returns. The
+ * message must stay untouched until this returns false.
+ */
+bool uptane_parse_targets_cbor_busy(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif  // LIBUPTINY_TARGETS_CBOR_H
@@ -0,0 +1,33 @@
+#ifndef LIBUPTINY_TRACE_H
+#define LIBUPTINY_TRACE_H
+
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Probes around the hot paths, compiled in with UPTANE_TRACE. The platform provides uptane_trace(), which records
+ * that probe begins (end 0) or ends (end 1), arg tells apart the runs of a probe, e.g. the UDS service. */
+#define TRACE_ISOTP_DISPATCH 0
+#define TRACE_UDS_SERVICE 1
+#define TRACE_FLASH_WRITE 2
+#define TRACE_CRYPTO_VERIFY 3
+#define TRACE_TARGETS_FEED 4
+#define TRACE_PROBES 5
+
+#ifdef UPTANE_TRACE
+void uptane_trace(uint8_t probe, uint8_t end, uint8_t arg);
+#define TRACE_BEGIN(probe, arg) uptane_trace((probe), 0, (arg))
+#define TRACE_END(probe, arg) uptane_trace((probe), 1, (arg))
+#else
+#define TRACE_BEGIN(probe, arg) \
+  { ; }
+#define TRACE_END(probe, arg) \
+  { ; }
+#endif  // UPTANE_TRACE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // LIBUPTINY_TRACE_H
@@ -0,0 +1,102 @@
+#ifndef LIBUPTINY_UPTINY_CONFIG_H_
+#define LIBUPTINY_UPTINY_CONFIG_H_
+
+/* Build-time configuration of libuptiny: the algorithms metadata may use and the sizes of the pools in common_data.
+ * Every setting has a default here and can be overridden with -D, or in a header of the integrator named by
+ * UPTINY_CONFIG_FILE (the CMake cache variable of the same name), which is included first.
+ *
+ * Features that add code or RAM are switched by the CMake options of the same name: CRYPTO_KEY_CACHE,
+ * UPTINY_TARGETS_CACHE, UPTANE_POOL_STATS, UPTANE_STATS, UPTANE_STATS_STAGES, UPTINY_LARGE_OFFSETS, UPTINY_JSMN_SIMD,
+ * ED25519_REENTRANT and ED25519_BATCH_MAX.
+ */
+#ifdef UPTINY_CONFIG_FILE
+#include UPTINY_CONFIG_FILE
+#endif
+
+/* Algorithms, 1 to enable. A disabled one is unknown to the name lookups, so metadata using it is rejected (keys) or
+ * skipped (target hashes), and the code for it is left out. With one of a kind enabled, the lookup is a single
+ * comparison.
+ */
+#ifndef UPTINY_ALG_ED25519
+#define UPTINY_ALG_ED25519 1
+#endif
+
+#ifndef UPTINY_HASH_SHA512
+#define UPTINY_HASH_SHA512 1
+#endif
+
+/* Only needed if targets metadata gives sha256 hashes alone, or the ECU reports its firmware by one */
+#ifndef UPTINY_HASH_SHA256
+#define UPTINY_HASH_SHA256 1
+#endif
+
+#if !UPTINY_ALG_ED25519
+#error "uptiny_config.h: no signature algorithm enabled"
+#endif
+
+/* Signatures and the signed part of root and targets are hashed with sha512 whatever the target hashes are */
+#if !UPTINY_HASH_SHA512
+#error "uptiny_config.h: sha512 is needed for ed25519"
+#endif
+
+/* Pools of common_data. Tokens of one chunk of metadata, see verify_targets for the peak use; signatures of a role,
+ * at least its threshold plus UPTANE_SIGNATURES_EXTRA; verification contexts, as many as signatures unless metadata
+ * is verified buffered; keys of the root and targets roles of the current and the new root.
+ */
+#ifndef UPTINY_TOKEN_POOL_SIZE
+#define UPTINY_TOKEN_POOL_SIZE 50
+#endif
+
+#ifndef UPTINY_SIGNATURE_POOL_SIZE
+#define UPTINY_SIGNATURE_POOL_SIZE 4
+#endif
+
+#ifndef UPTINY_CRYPTO_CTX_POOL_SIZE
+#define UPTINY_CRYPTO_CTX_POOL_SIZE 4
+#endif
+
+#ifndef UPTINY_KEY_POOL_SIZE
+#define UPTINY_KEY_POOL_SIZE 16
+#endif
+
+/* Budgets of one parse, 0 for no limit. A feed that would take the metadata past the bytes, or has parsed more tokens
+ * of it, fails with RESULT_TOO_LARGE or ROOT_RESULT_TOO_LARGE and sets ATTACK_TARGETS_LARGE or ATTACK_ROOT_LARGE.
+ * The tokens are counted as the parser consumes them, whatever the chunks, and a target for other ECUs counts as two,
+ * so they bound the work on metadata that is small in bytes. Can be changed per parse with
+ * uptane_targets_ctx_set_budget() and uptane_parse_root_set_budget().
+ */
+#ifndef UPTINY_TARGETS_MAX_BYTES
+#define UPTINY_TARGETS_MAX_BYTES 0
+#endif
+
+#ifndef UPTINY_TARGETS_MAX_TOKENS
+#define UPTINY_TARGETS_MAX_TOKENS 0
+#endif
+
+#ifndef UPTINY_ROOT_MAX_BYTES
+#define UPTINY_ROOT_MAX_BYTES 0
+#endif
+
+/* What uptane_targets_t keeps of a target, and so the state persists of it. With UPTINY_TARGETS_ONE_HASH only the hash
+ * the image is checked with: the one of state_get_supported_hash() if the target lists it, the first known one
+ * otherwise. Names of up to TARGETS_MAX_NAME_LENGTH characters are kept, a target with a longer one fails the parse
+ * unless UPTINY_TARGETS_NAME_TRUNCATE cuts it, the name is then only what the manifest reports.
+ */
+#ifndef UPTINY_TARGETS_ONE_HASH
+#define UPTINY_TARGETS_ONE_HASH 0
+#endif
+
+#ifndef TARGETS_MAX_NAME_LENGTH
+#define TARGETS_MAX_NAME_LENGTH 63
+#endif
+
+#ifndef UPTINY_TARGETS_NAME_TRUNCATE
+#define UPTINY_TARGETS_NAME_TRUNCATE 0
+#endif
+
+/* Keys of a role in root metadata */
+#ifndef ROOT_MAX_KEYS
+#define ROOT_MAX_KEYS 16
+#endif
+
+#endif  // LIBUPTINY_UPTINY_CONFIG_H_
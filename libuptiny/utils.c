@@ -1,5 +1,124 @@
 #include "utils.h"
+#include "stats.h"
 
+#ifdef UPTINY_CODEC_TABLES
+#define HEX_INVALID 0xFF
+
+// Value of every hex digit, HEX_INVALID for other characters
+static const uint8_t hex_values[256] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const char hex_digits[] = "0123456789abcdef";
+
+#define from_hex(sym) (hex_values[(uint8_t)(sym)])
+#define to_hex(nibble) (hex_digits[(nibble)])
+
+bool hex2bin(const char *hex_string, int hex_len, uint8_t *bin_data) {
+  int i = 0;
+  UPTANE_STATS_COUNT(hex_decoded, hex_len);
+  // four digits at a time, one check for all of them
+  for (; i + 4 <= hex_len; i += 4) {
+    uint8_t d0 = from_hex(hex_string[i]);
+    uint8_t d1 = from_hex(hex_string[i + 1]);
+    uint8_t d2 = from_hex(hex_string[i + 2]);
+    uint8_t d3 = from_hex(hex_string[i + 3]);
+    if ((d0 | d1 | d2 | d3) == HEX_INVALID) {
+      return false;
+    }
+    bin_data[i >> 1] = (uint8_t)((d0 << 4) | d1);
+    bin_data[(i >> 1) + 1] = (uint8_t)((d2 << 4) | d3);
+  }
+
+  for (; i < hex_len; ++i) {
+    uint8_t digit = from_hex(hex_string[i]);
+    if (digit == HEX_INVALID) {
+      return false;
+    }
+
+    if (i & 1) {
+      bin_data[i >> 1] |= digit;
+    } else {
+      bin_data[i >> 1] = (uint8_t)(digit << 4);
+    }
+  }
+  return true;
+}
+
+void bin2hex(const uint8_t *bin_data, int bin_len, char *hex_string) {
+  int i = 0;
+  for (; i + 2 <= bin_len; i += 2) {
+    uint8_t b0 = bin_data[i];
+    uint8_t b1 = bin_data[i + 1];
+    hex_string[i << 1] = to_hex(b0 >> 4);
+    hex_string[(i << 1) + 1] = to_hex(b0 & 0x0F);
+    hex_string[(i << 1) + 2] = to_hex(b1 >> 4);
+    hex_string[(i << 1) + 3] = to_hex(b1 & 0x0F);
+  }
+  if (i < bin_len) {
+    hex_string[i << 1] = to_hex(bin_data[i] >> 4);
+    hex_string[(i << 1) + 1] = to_hex(bin_data[i] & 0x0F);
+  }
+  hex_string[bin_len << 1] = 0;
+}
+
+int hex_bin_cmp(const char *hex_string, int hex_len, const uint8_t *bin_data) {
+  // all the digits are checked first, a difference before an invalid one doesn't hide it
+  uint8_t digits = 0;
+  for (int j = 0; j < hex_len; ++j) {
+    digits |= from_hex(hex_string[j]);
+  }
+  if (digits == HEX_INVALID) {
+    return -1;  // Invalid string is "less" than anything
+  }
+
+  int i = 0;
+  for (; i + 4 <= hex_len; i += 4) {
+    uint8_t d0 = from_hex(hex_string[i]);
+    uint8_t d1 = from_hex(hex_string[i + 1]);
+    uint8_t d2 = from_hex(hex_string[i + 2]);
+    uint8_t d3 = from_hex(hex_string[i + 3]);
+
+    // both bytes at once, the first one is the most significant
+    uint16_t word = (uint16_t)((d0 << 12) | (d1 << 8) | (d2 << 4) | d3);
+    uint16_t bin_word = (uint16_t)((bin_data[i >> 1] << 8) | bin_data[(i >> 1) + 1]);
+    if (word != bin_word) {
+      return (word < bin_word) ? -1 : 1;
+    }
+  }
+
+  uint8_t byte = 0;
+  for (; i < hex_len; ++i) {
+    uint8_t digit = from_hex(hex_string[i]);
+    if (i & 1) {
+      byte |= digit;
+      if (byte < bin_data[i >> 1]) {
+        return -1;
+      } else if (byte > bin_data[i >> 1]) {
+        return 1;
+      }
+    } else {
+      byte = (uint8_t)(digit << 4);
+    }
+  }
+  return 0;
+}
+#else  // UPTINY_CODEC_TABLES
 static inline bool is_hex(char c) { return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f'); }
 
 static inline uint8_t from_hex(char sym) {
@@ -13,6 +132,7 @@ static inline uint8_t from_hex(char sym) {
 }
 
 bool hex2bin(const char *hex_string, int hex_len, uint8_t *bin_data) {
+  UPTANE_STATS_COUNT(hex_decoded, hex_len);
   for (int i = 0; i < hex_len; ++i) {
     char sym = hex_string[i];
     if (!is_hex(sym)) {
@@ -45,13 +165,16 @@ void bin2hex(const uint8_t *bin_data, int bin_len, char *hex_string) {
 }
 
 int hex_bin_cmp(const char *hex_string, int hex_len, const uint8_t *bin_data) {
-  uint8_t byte = 0;
+  // all the digits are checked first, a difference before an invalid one doesn't hide it
   for (int i = 0; i < hex_len; ++i) {
-    char sym = hex_string[i];
-    if (!is_hex(sym)) {
+    if (!is_hex(hex_string[i])) {
       return -1;  // Invalid string is "less" than anything
     }
+  }
 
+  uint8_t byte = 0;
+  for (int i = 0; i < hex_len; ++i) {
+    char sym = hex_string[i];
     if (i & 1) {
       byte |= from_hex(sym);
       if (byte < bin_data[i >> 1]) {
@@ -65,6 +188,7 @@ int hex_bin_cmp(const char *hex_string, int hex_len, const uint8_t *bin_data) {
   }
   return 0;
 }
+#endif  // UPTINY_CODEC_TABLES
 
 bool dec2int(const char *dec_string, int dec_len, int32_t *out) {
   int32_t res = 0;
@@ -0,0 +1,321 @@
+#include <string.h>
+#include "isotp_dispatch.h"
+
+#include "SKEAZ1284.h" /* include peripheral declarations SKEAZ128M4 */
+#include "can.h"
+#include "led.h"
+#include "systimer.h"
+#include "uds.h"
+#include "bench.h"
+
+#include "ed25519/edsign.h"
+#include "ed25519/f25519.h"
+#include "ed25519/sha512.h"
+#include "libuptiny/base64.h"
+#include "libuptiny/common_data_api.h"
+#include "libuptiny/state_api.h"
+#include "libuptiny/targets.h"
+#include "libuptiny/utils.h"
+
+#ifndef CAN_ID
+#    error "CAN_ID should be provided"
+#endif
+
+#define CAN_BAUD 125000
+
+/* RFC 8032, section 7.1, test 1 */
+static const uint8_t rfc8032_pub[EDSIGN_PUBLIC_KEY_SIZE] = {
+	0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+	0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a,
+};
+static const uint8_t rfc8032_sig[EDSIGN_SIGNATURE_SIZE] = {
+	0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72, 0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+	0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74, 0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+	0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac, 0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+	0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24, 0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b,
+};
+
+/* Director targets of the test repository (tests/repo), in canonical JSON */
+static const char targets_metadata[] =
+	"{\"signatures\":[{\"keyid\":\"a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2\","
+	"\"method\":\"ed25519\","
+	"\"sig\":\"zgz8Yy6+OytNj4GIySEhhYpK/l/ZmTfrm6vBfJ50BJWkKq/W1HVApPPk4AWpL8jOjZq5IAPFPKLzNwqmXOx8CQ==\"}],"
+	"\"signed\":{\"_type\":\"Targets\",\"expires\":\"3021-07-13T01:02:03Z\","
+	"\"targets\":{\"secondary_firmware.txt\":{\"custom\":{\"ecuIdentifiers\":{\"uptane_secondary_1\":"
+	"{\"hardwareId\":\"test_uptane_secondary\"}}},"
+	"\"hashes\":{\"sha256\":\"1bbb15aa921ffffd5079567d630f43298dbe5e7cbc1b14e0ccdd6718fde28e47\","
+	"\"sha512\":\"7dbae4c36a2494b731a9239911d3085d53d3e400886edb4ae2b9b78f40bda446649e83ba2d81653f614cc66f5dd5d4"
+	"dbd95afba854f148afbfae48d0ff4cc38a\"},\"length\":15}},\"version\":2}}";
+
+#define TARGETS_KEYID_HEX "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2"
+#define TARGETS_SIG_BASE64 "zgz8Yy6+OytNj4GIySEhhYpK/l/ZmTfrm6vBfJ50BJWkKq/W1HVApPPk4AWpL8jOjZq5IAPFPKLzNwqmXOx8CQ=="
+
+static const uint8_t targets_pub[CRYPTO_KEYVAL_LEN] = {
+	0xc1, 0x81, 0x43, 0xa7, 0x3b, 0xd7, 0xec, 0x00, 0xc0, 0xac, 0xc1, 0x94, 0xca, 0xd9, 0x73, 0x11,
+	0x8b, 0xde, 0x92, 0x0b, 0xf4, 0xc0, 0x62, 0x9f, 0x7f, 0x95, 0x20, 0x9d, 0x42, 0x28, 0x3c, 0xb6,
+};
+
+static crypto_key_t targets_key;
+static uptane_root_t root;
+static uptane_root_t* current_root = &root; /* worst_case_root() while a worst case runs */
+static uptane_targets_t installed;
+
+uptane_root_t* state_get_root(void) { return current_root; }
+uptane_targets_t* state_get_targets(void) { return &installed; }
+const char* state_get_ecuid(void) { return "uptane_secondary_1"; }
+size_t state_get_ecuid_len(void) { return strlen("uptane_secondary_1"); }
+const char* state_get_hwid(void) { return "test_uptane_secondary"; }
+size_t state_get_hwid_len(void) { return strlen("test_uptane_secondary"); }
+crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA512; }
+void state_set_root(const uptane_root_t* root) { (void)root; }
+void state_set_attack(uptane_attack_t attack) { (void)attack; }
+
+/* Inputs the kernels share, set up by bench_init() */
+static uint8_t fe_a[F25519_SIZE];
+static uint8_t fe_b[F25519_SIZE];
+static struct sha512_state sha_state;
+static uint8_t sha_block[SHA512_BLOCK_SIZE];
+static struct sha512_state rfc8032_hashed;
+static uint8_t rfc8032_unpacked[EDSIGN_UNPACKED_PUB_SIZE];
+static uint8_t scratch[EDSIGN_SIGNATURE_SIZE + 2];
+static uptane_targets_ctx_t targets_ctx;
+static char worst_window[BENCH_WORST_WINDOW];
+
+static uint32_t timer_overhead; /* cycles between two time_get_cycles() */
+
+/* A kernel does one op and returns 0 if it got a wrong result */
+static int op_f25519_mul(void) {
+	f25519_mul(fe_a, fe_a, fe_b);
+	return 1;
+}
+
+static int op_sha512_block(void) {
+	sha512_block(&sha_state, sha_block);
+	return 1;
+}
+
+static int op_edsign_verify(void) {
+	struct sha512_state s;
+
+	return edsign_verify_init(&s, rfc8032_sig, rfc8032_pub, (const uint8_t*) "", 0) != 0;
+}
+
+static int op_edsign_hashed(void) {
+	return edsign_verify_hashed(&rfc8032_hashed, rfc8032_sig, rfc8032_pub, rfc8032_unpacked) != 0;
+}
+
+static int op_hex2bin(void) {
+	return hex2bin(TARGETS_KEYID_HEX, 2 * CRYPTO_KEYID_LEN, scratch) && scratch[0] == 0xa7;
+}
+
+static int op_base64_decode(void) {
+	return base64_decode(TARGETS_SIG_BASE64, strlen(TARGETS_SIG_BASE64), scratch) == EDSIGN_SIGNATURE_SIZE;
+}
+
+/* Feeds the metadata like verify_targets does, from a context set up anew so that nothing is cached */
+static int feed_targets(int trust_signatures) {
+	uint16_t result = RESULT_IN_PROGRESS;
+	uptane_targets_t targets;
+	size_t len = sizeof(targets_metadata) - 1;
+	size_t offset = 0;
+	size_t avail = 0;
+	int consumed;
+
+	uptane_targets_ctx_setup(&targets_ctx, token_pool, token_pool_size, signature_pool, signature_pool_size,
+			crypto_ctx_pool, crypto_ctx_pool_size, &hash_context, NULL);
+	uptane_targets_ctx_init(&targets_ctx);
+	if(trust_signatures)
+		uptane_targets_ctx_trust_signatures(&targets_ctx);
+	while(result == RESULT_IN_PROGRESS && (avail < len || offset < avail)) {
+		avail = (len - avail > BENCH_CHUNK) ? avail + BENCH_CHUNK : len;
+		consumed = uptane_targets_ctx_feed(&targets_ctx, targets_metadata + offset, avail - offset, &targets, &result);
+		if(consumed < 0 || (avail == len && consumed == 0))
+			break;
+		offset += consumed;
+	}
+	while(uptane_targets_ctx_busy(&targets_ctx));
+	return result == RESULT_END_FOUND && targets.length == 15;
+}
+
+static int op_targets_verify(void) {
+	return feed_targets(0);
+}
+
+static int op_targets_parse(void) {
+	return feed_targets(1);
+}
+
+static const struct {
+	int (*op)(void);
+	uint16_t ops;
+} kernels[BENCH_WORST_CASE] = {
+	[BENCH_F25519_MUL] = {op_f25519_mul, BENCH_F25519_MUL_OPS},
+	[BENCH_SHA512_BLOCK] = {op_sha512_block, BENCH_SHA512_BLOCK_OPS},
+	[BENCH_EDSIGN_VERIFY] = {op_edsign_verify, BENCH_EDSIGN_OPS},
+	[BENCH_EDSIGN_HASHED] = {op_edsign_hashed, BENCH_EDSIGN_OPS},
+	[BENCH_HEX2BIN] = {op_hex2bin, BENCH_CODEC_OPS},
+	[BENCH_BASE64_DECODE] = {op_base64_decode, BENCH_CODEC_OPS},
+	[BENCH_TARGETS_VERIFY] = {op_targets_verify, BENCH_TARGETS_VERIFY_OPS},
+	[BENCH_TARGETS_PARSE] = {op_targets_parse, BENCH_TARGETS_PARSE_OPS},
+};
+
+static void bench_init(void) {
+	uint32_t ts;
+	int i;
+
+	for(i = 0; i < F25519_SIZE; i++) {
+		fe_a[i] = i * 7 + 3;
+		fe_b[i] = i * 13 + 5;
+	}
+	fe_a[F25519_SIZE - 1] &= 0x7f;
+	fe_b[F25519_SIZE - 1] &= 0x7f;
+	memset(sha_block, 'x', sizeof(sha_block));
+	sha512_init(&sha_state);
+	edsign_verify_hash_init(&rfc8032_hashed, rfc8032_sig, rfc8032_pub, (const uint8_t*) "", 0);
+	edsign_unpack_pub(rfc8032_unpacked, rfc8032_pub);
+
+	targets_key.key_type = CRYPTO_ALG_ED25519;
+	hex2bin(TARGETS_KEYID_HEX, 2 * CRYPTO_KEYID_LEN, targets_key.keyid);
+	memcpy(targets_key.keyval, targets_pub, sizeof(targets_pub));
+	crypto_key_prepare(&targets_key);
+	root.targets_keys[0] = &targets_key;
+	root.targets_keys_num = 1;
+	root.targets_threshold = 1;
+
+	ts = time_get_cycles();
+	timer_overhead = time_get_cycles() - ts;
+}
+
+static void put_32(uint8_t* p, uint32_t v) {
+	p[0] = v >> 24;
+	p[1] = (v >> 16) & 0xFF;
+	p[2] = (v >> 8) & 0xFF;
+	p[3] = v & 0xFF;
+}
+
+/* Runs the kernel and sends its result to the tester at ta */
+static void bench_run(uint16_t ta, uint8_t kernel) {
+	uint8_t status[8];
+	uint32_t cycles;
+	uint32_t ts;
+	int ok = 1;
+	int i;
+
+	send_uds_error(ta, 0x31, 0x78); /* Response pending */
+	can_flush_send();
+
+	led_set(0, 1);
+	ts = time_get_cycles();
+	for(i = 0; i < kernels[kernel].ops; i++)
+		ok &= kernels[kernel].op();
+	cycles = time_get_cycles() - ts - timer_overhead;
+	led_set(0, 0);
+
+	if(!ok) {
+		send_uds_error(ta, 0x31, 0x10); /* General Reject */
+		return;
+	}
+	status[0] = kernels[kernel].ops >> 8;
+	status[1] = kernels[kernel].ops & 0xFF;
+	put_32(status + 2, cycles / kernels[kernel].ops);
+	status[6] = (SystemCoreClock / 1000) >> 8;
+	status[7] = (SystemCoreClock / 1000) & 0xFF;
+	send_uds_positive_routinecontrol_status(ta, 0x01, BENCH_ROUTINE + kernel, status, sizeof(status));
+}
+
+/* Feeds a worst case once and sends the slowest feed call to the tester at ta */
+static void bench_worst_case(uint16_t ta, worst_case_t c, uint8_t first_chunk) {
+	worst_case_run_t run;
+	uint8_t status[12];
+	int ok;
+
+	send_uds_error(ta, 0x31, 0x78); /* Response pending */
+	can_flush_send();
+
+	led_set(0, 1);
+	current_root = worst_case_root();
+	ok = worst_case_run(c, worst_window, sizeof(worst_window), BENCH_CHUNK, first_chunk, time_get_cycles, &run);
+	current_root = &root;
+	led_set(0, 0);
+
+	if(!ok) {
+		send_uds_error(ta, 0x31, 0x10); /* General Reject */
+		return;
+	}
+	status[0] = run.feeds >> 8;
+	status[1] = run.feeds & 0xFF;
+	put_32(status + 2, (run.max_ticks > timer_overhead) ? run.max_ticks - timer_overhead : 0);
+	status[6] = (SystemCoreClock / 1000) >> 8;
+	status[7] = (SystemCoreClock / 1000) & 0xFF;
+	put_32(status + 8, run.max_ticks_at);
+	send_uds_positive_routinecontrol_status(ta, 0x01, BENCH_ROUTINE + BENCH_WORST_CASE + c, status, sizeof(status));
+}
+
+void message_received(const IsoTpMessage* message) {
+	uint16_t ta = (message->arbitration_id >> 5) & 0x01F;
+	uint16_t id;
+	uint8_t first_chunk;
+
+	switch (message->payload[0]) {
+		case 0x31: /* RoutineControl */
+			if(message->size != 4 && message->size != 5) {
+				send_uds_error(ta, 0x31, 0x13); /* Invalid Format */
+				break;
+			}
+			if(message->payload[1] != 0x01) { /* Start routine */
+				send_uds_error(ta, 0x31, 0x12); /* SFNS */
+				break;
+			}
+			id = (message->payload[2] << 8) | message->payload[3];
+			if(id < BENCH_ROUTINE || id >= BENCH_ROUTINE + BENCH_KERNELS) {
+				send_uds_error(ta, 0x31, 0x31); /* ROOR */
+				break;
+			}
+			if(id < BENCH_ROUTINE + BENCH_WORST_CASE) {
+				if(message->size != 4) {
+					send_uds_error(ta, 0x31, 0x13); /* Invalid Format */
+					break;
+				}
+				bench_run(ta, id - BENCH_ROUTINE);
+				break;
+			}
+			first_chunk = (message->size == 5) ? message->payload[4] : BENCH_CHUNK;
+			if(first_chunk == 0 || first_chunk > BENCH_CHUNK) {
+				send_uds_error(ta, 0x31, 0x31); /* ROOR */
+				break;
+			}
+			bench_worst_case(ta, (worst_case_t) (id - BENCH_ROUTINE - BENCH_WORST_CASE), first_chunk);
+			break;
+		default:
+			send_uds_error(ta, message->payload[0], 0x11); /* Service not supported */
+			break;
+	}
+}
+
+void main(void) {
+  struct can_filter can_routes[UDS_MAX_ROUTES];
+
+  IsoTpShims isotp_shims;
+
+  time_init();
+  led_init();
+
+  can_init_routes(CAN_BAUD, can_routes, uds_routes(can_routes, UDS_MAX_ROUTES));
+
+  __enable_irq();
+
+  bench_init();
+
+  isotp_shims = isotp_init_shims(NULL, send_can_isotp, NULL, NULL);
+
+  isotp_dispatch_init(message_received, NULL, isotp_shims);
+  for(;;) {
+	isotp_dispatch();
+
+	/* the kernels run from isotp_dispatch(), never across a sleep */
+	__disable_irq();
+	if(!can_recv_pending())
+		time_sleep(isotp_dispatch_busy() ? 1 : 1000);
+	__enable_irq();
+  }
+}
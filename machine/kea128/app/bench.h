@@ -0,0 +1,52 @@
+#ifndef ATS_BOOT_BENCH_H
+#define ATS_BOOT_BENCH_H
+
+#include <stdint.h>
+
+#include "benchmarks/worst_case.h"
+
+/* kea128_bench.elf times the hot paths of libuptiny and ed25519 on the device, on test vectors built into it, so that
+ * the numbers of two builds can be compared. It answers RoutineControl startRoutine (31 01 B0 kk) for the routine
+ * BENCH_ROUTINE + kernel with responsePending, runs the kernel BENCH_*_OPS times and sends the routineStatusRecord
+ *
+ *   ops (2 bytes) | cycles per op (4 bytes) | core clock in kHz (2 bytes)
+ *
+ * big endian. Cycles are counted with SysTick and include its own interrupt, the time of reading it is taken off. A
+ * kernel that gets a wrong result is answered with General Reject (0x10), an unknown one with ROOR (0x31).
+ *
+ * The worst-case kernels feed the hostile metadata of benchmarks/worst_case.h once, in chunks of BENCH_CHUNK bytes
+ * after a first one of the size in the byte that may follow the routine ID (1 to BENCH_CHUNK, a whole chunk without
+ * it). They answer with the feed calls instead of the runs and the cycles of the slowest call instead of an average,
+ * followed by the offset in the message the part fed to it began at (4 bytes). Starting them with every first chunk
+ * size puts the chunk boundaries on every offset, the worst of them is the one to budget for. General Reject means the
+ * parser gave up before the signatures were checked. */
+#define BENCH_ROUTINE 0xB000
+
+enum bench_kernel {
+	BENCH_F25519_MUL = 0x00,      /* f25519_mul() */
+	BENCH_SHA512_BLOCK = 0x01,    /* sha512_block() */
+	BENCH_EDSIGN_VERIFY = 0x02,   /* edsign_verify_init() of RFC 8032 test 1, the key unpacked every time */
+	BENCH_EDSIGN_HASHED = 0x03,   /* edsign_verify_hashed() with the key unpacked once, as with CRYPTO_KEY_CACHE */
+	BENCH_HEX2BIN = 0x04,         /* hex2bin() of a key ID */
+	BENCH_BASE64_DECODE = 0x05,   /* base64_decode() of a signature */
+	BENCH_TARGETS_VERIFY = 0x06,  /* director targets with one signature, fed in chunks of BENCH_CHUNK bytes */
+	BENCH_TARGETS_PARSE = 0x07,   /* the same without checking the signature */
+	BENCH_WORST_CASE = 0x08,      /* 0x08 + worst_case_t */
+	BENCH_KERNELS = BENCH_WORST_CASE + WORST_CASES
+};
+
+/* Times the kernels run for a result, each result is the average of them */
+#define BENCH_F25519_MUL_OPS 1000
+#define BENCH_SHA512_BLOCK_OPS 100
+#define BENCH_EDSIGN_OPS 1
+#define BENCH_CODEC_OPS 1000
+#define BENCH_TARGETS_VERIFY_OPS 1
+#define BENCH_TARGETS_PARSE_OPS 10
+
+/* The default chunk of verify_targets, to compare with the host */
+#define BENCH_CHUNK 64
+
+/* The worst cases are made in a window of this size at a time, it holds the largest part fed */
+#define BENCH_WORST_WINDOW 1024
+
+#endif /* ATS_BOOT_BENCH_H */
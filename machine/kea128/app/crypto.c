@@ -4,6 +4,7 @@
 typedef int wint_t;
 #include <strings.h>
 #include "debug.h"
+#include "trace.h"
 #include "ed25519/edsign.h"
 #include "utils.h"
 
@@ -66,6 +67,7 @@ void crypto_verify_init(crypto_verify_ctx_t* ctx, crypto_key_and_signature_t* si
 void crypto_verify_feed(crypto_verify_ctx_t* ctx, const uint8_t* data, int len) {
   int i;
 
+  TRACE_BEGIN(TRACE_CRYPTO_VERIFY, 0);
   for (i = 0; i < len; i++) {
     if (ctx->bytes_fed < SHA512_BLOCK_SIZE - 64) {
       ctx->block[ctx->bytes_fed++] = data[i];
@@ -85,14 +87,20 @@ void crypto_verify_feed(crypto_verify_ctx_t* ctx, const uint8_t* data, int len)
       ++ctx->bytes_fed;
     }
   }
+  TRACE_END(TRACE_CRYPTO_VERIFY, 0);
 }
 
 bool crypto_verify_result(crypto_verify_ctx_t* ctx) {
+  bool res;
+
+  TRACE_BEGIN(TRACE_CRYPTO_VERIFY, 1);
   if (ctx->bytes_fed < SHA512_BLOCK_SIZE) {
-    return edsign_verify_init(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
+    res = edsign_verify_init(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
   } else {
-    return edsign_verify_final(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
+    res = edsign_verify_final(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
   }
+  TRACE_END(TRACE_CRYPTO_VERIFY, 1);
+  return res;
 }
 
 int crypto_get_hashlen(crypto_hash_algorithm_t alg) { return hashtypes[alg].hash_len; }
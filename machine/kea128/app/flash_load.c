@@ -1,5 +1,10 @@
 #include "flash_load.h"
 #include "flash.h"
+#include "clock.h"
+#include "decompress.h"
+#include "delta.h"
+#include "firmware.h"
+#include "state_api.h"
 
 #include <string.h>
 
@@ -18,80 +23,393 @@ static uint32_t flash_load_size;
 extern uint32_t flash_start_address;
 
 
-int flash_load_erase(uint32_t start, uint32_t size) {
-	uint32_t end = start+size-1; /* The last address to be cleared */
-	uint32_t head = start & 0x1ff; /* modulo 512 */
-	uint32_t tail = (end+1) & 0x1ff; /* modulo 512 */
-	uint32_t startsec = start >> 9;
-	uint32_t endsec = end >> 9;
-	uint32_t i;
+#define SECTOR_UNCHANGED 0
+#define SECTOR_PROGRAM 1 /* the sector is blank, no erase needed */
+#define SECTOR_WRITE 2
 
-	if(head) {
-		memcpy(buf, (void*)((startsec << 9)+flash_start_address), head);
-		memset(buf+head, 0xFF, 512-head);
-	}
+/* What it takes to turn the current contents of a sector into data */
+static int sector_update(uint32_t addr, const uint8_t* data) {
+	const uint8_t* current = (const uint8_t*) (addr + flash_start_address);
+	int i;
 
-	if(startsec != endsec) {
-		/* Erase all sectors but the last one */
-		for(i = startsec; i < endsec; i++)
-			if(!flash_erase_sector(i << 9))
-				return 0;
+	if(!memcmp(data, current, FLASH_SECTOR_SIZE))
+		return SECTOR_UNCHANGED;
 
-		if(head)
-			if(!flash_write_sector(startsec << 9, buf))
-				return 0;
+	for(i = 0; i < FLASH_SECTOR_SIZE; i++)
+		if(current[i] != 0xFF)
+			return SECTOR_WRITE;
+	return SECTOR_PROGRAM;
+}
 
-		if(tail) {
-			memset(buf, 0xFF, tail);
-			memcpy(buf+tail, (void*)((endsec << 9) + tail + flash_start_address), 512-tail);
-		}
-	} else {
-		/* Tail is always greater than head in one-sector case, because end > start is a prerequisite*/
-		if(tail)
-			memcpy(buf+tail, (void*)((endsec << 9) + tail + flash_start_address), 512-tail);
+static int update_sector(uint32_t addr, const uint8_t* data) {
+	switch(sector_update(addr, data)) {
+		case SECTOR_UNCHANGED:
+			return 1;
+		case SECTOR_PROGRAM:
+			return flash_program_sector(addr, data);
+		default:
+			return flash_write_sector(addr, data); /* blank phrases of data are not programmed after the erase */
 	}
+}
 
-	/* Erase the last sector, keeping unaffected bytes */
-	if(!flash_erase_sector(endsec << 9))
-		return 0;
-	if(!flash_write_sector(endsec << 9, buf))
-		return 0;
+static uint32_t erase_start;
+static uint32_t erase_end; /* The first address after the range */
+static uint32_t erase_addr; /* sector to erase next */
+
+int flash_load_erase_begin(uint32_t start, uint32_t size) {
+	erase_start = start;
+	erase_end = start+size;
+	erase_addr = start & ~0x1FF;
 	return 1;
 }
 
-int flash_load_prepare(uint32_t addr, uint32_t size) {
-	uint32_t flash_load_head;
+int flash_load_erase_step(void) {
+	uint32_t addr = erase_addr;
+	uint32_t from, to;
+
+	if(addr >= erase_end)
+		return 1;
+
+	from = (addr < erase_start) ? erase_start-addr : 0;
+	to = (erase_end-addr < FLASH_SECTOR_SIZE) ? erase_end-addr : FLASH_SECTOR_SIZE;
+
+	/* Keep the bytes of the sector outside the range, sectors that are already blank are left alone */
+	memcpy(buf, (void*)(addr + flash_start_address), FLASH_SECTOR_SIZE);
+	memset(buf+from, 0xFF, to-from);
+	if(!update_sector(addr, buf))
+		return 0;
+
+	erase_addr += FLASH_SECTOR_SIZE;
+	return (erase_addr < erase_end) ? FLASH_LOAD_BUSY : 1;
+}
+
+int flash_load_erase(uint32_t start, uint32_t size) {
+	int res;
+
+	flash_load_erase_begin(start, size);
+	while((res = flash_load_erase_step()) == FLASH_LOAD_BUSY);
+	return res;
+}
+
+/* Sectors are assembled in two buffers that alternate: a full one is queued for programming unless the flash
+ * already holds it, and the next sector is received into the other one meanwhile, so flash_load_continue() only
+ * waits when both are still in flight. Blank sectors, e.g. after flash_load_erase(), are programmed without an erase.
+ * When installing, a full buffer is also handed to uptane_verify_firmware_feed() and is hashed in the background of
+ * its programming. uptane_verify_firmware_feed() waits for the previous part before starting the next one, so a
+ * buffer is never refilled while it is still being hashed. */
+
+static uint8_t sector_buf[2][FLASH_SECTOR_SIZE];
+static volatile int sector_pending[2];
+static volatile int load_failed;
+static int load_cur; /* buffer being filled */
+static int load_hashing;
+static uint32_t load_hash_from; /* first image byte in the buffer, the bytes before are kept from flash */
+
+static void sector_done(int ok, void* arg) {
+	if(!ok)
+		load_failed = 1;
+	*(volatile int*) arg = 0;
+}
+
+static void load_start(uint32_t addr, uint32_t size, int hashing) {
+	while(sector_pending[0] || sector_pending[1]);
 
 	flash_load_addr = flash_load_curaddr = addr;
 	flash_load_size = size;
-	
-	flash_load_head = flash_load_addr & 0x1FF;
-	memcpy(buf, (void*)((flash_load_addr & ~0x1FF) + flash_start_address), flash_load_head);
+	load_failed = 0;
+	load_cur = 0;
+	load_hashing = hashing;
+	load_hash_from = addr & 0x1FF;
+	memcpy(sector_buf[0], (void*)((addr & ~0x1FF) + flash_start_address), load_hash_from);
+}
 
+static int load_flush(uint32_t len) {
+	uint8_t* sector = sector_buf[load_cur];
+	uint32_t addr;
+	int queued;
+
+	if(load_hashing && !uptane_verify_firmware_feed(sector + load_hash_from, len - load_hash_from))
+		return 0; /* longer than the target, not programmed */
+
+	addr = (flash_load_curaddr - 1) & ~0x1FF;
+	switch(sector_update(addr, sector)) {
+		case SECTOR_UNCHANGED:
+			queued = 1;
+			break;
+		case SECTOR_PROGRAM:
+			sector_pending[load_cur] = 1;
+			queued = flash_program_sector_async(addr, sector, sector_done, (void*) &sector_pending[load_cur]);
+			break;
+		default:
+			sector_pending[load_cur] = 1;
+			queued = flash_write_sector_async(addr, sector, sector_done, (void*) &sector_pending[load_cur]);
+			break;
+	}
+	if(!queued) {
+		sector_pending[load_cur] = 0;
+		return 0;
+	}
+
+	load_cur ^= 1;
+	load_hash_from = 0;
+	while(sector_pending[load_cur]); /* the other buffer is still being programmed */
+	return !load_failed;
+}
+
+static int load_finish_res;
+
+/* Queues the last sector */
+static void load_finish_begin(void) {
+	uint32_t tail = flash_load_curaddr & 0x1FF;
+
+	load_finish_res = 1;
+	if(tail) {
+		memcpy(sector_buf[load_cur] + tail, (uint8_t*) (flash_load_curaddr + flash_start_address), 512-tail);
+		load_finish_res = load_flush(tail);
+	}
+}
+
+static int load_finish_step(void) {
+	if(sector_pending[0] || sector_pending[1])
+		return FLASH_LOAD_BUSY;
+	return load_finish_res && !load_failed;
+}
+
+static int load_finish(void) {
+	int res;
+
+	load_finish_begin();
+	while((res = load_finish_step()) == FLASH_LOAD_BUSY);
+	return res;
+}
+
+int flash_load_prepare(uint32_t addr, uint32_t size) {
+	load_start(addr, size, 0);
 	return 1;
 }
 
 int flash_load_continue(const uint8_t* data, uint32_t len) {
-	uint32_t i_buf = flash_load_curaddr & 0x1FF;
-	int i;
+	while(len) {
+		uint32_t i_buf = flash_load_curaddr & 0x1FF;
+		uint32_t n = FLASH_SECTOR_SIZE - i_buf;
+
+		if(n > len)
+			n = len;
+		memcpy(sector_buf[load_cur] + i_buf, data, n);
+		flash_load_curaddr += n;
+		data += n;
+		len -= n;
 
-	for(i = 0; i < len; i++) {
-		buf[i_buf] = data[i];
-		if(i_buf == 0x1FF) {
-			if(!flash_write_sector(flash_load_curaddr & ~0x1FF, buf))
+		if(i_buf + n == FLASH_SECTOR_SIZE)
+			if(!load_flush(FLASH_SECTOR_SIZE))
 				return 0;
-			i_buf = 0;
-		} else {
-			i_buf++;
+	}
+	return !load_failed;
+}
+
+int flash_load_finalize() {
+	return load_finish();
+}
+
+int flash_load_finalize_begin(void) {
+	load_finish_begin();
+	return 1;
+}
+
+int flash_load_finalize_step(void) {
+	return load_finish_step();
+}
+
+#ifdef FLASH_DUAL_BANK
+/* Bank records are phrases appended to one of the two record sectors, the valid one with the highest sequence number
+ * tells the active bank, A if there is none. A flip programs one phrase, so it either happens or it doesn't. When a
+ * sector is full, the other one is erased and continued, the full one is only erased after that. */
+#define BANK_RECORD_MAGIC 0xBA4C0000
+#define BANK_RECORDS_PER_SECTOR (FLASH_SECTOR_SIZE / sizeof(struct bank_record))
+
+struct bank_record {
+	uint32_t sequence;
+	uint32_t bank; /* BANK_RECORD_MAGIC | 0 for bank A, 1 for bank B */
+};
+
+static int bank_scanned;
+static uint32_t bank_active; /* 0 or 1 */
+static uint32_t bank_sequence;
+static int bank_sector; /* where the next record goes */
+static uint32_t bank_slot;
+
+static const struct bank_record* bank_records(int sector) {
+	return (const struct bank_record*) (BANK_RECORDS_BEGIN + sector*FLASH_SECTOR_SIZE + flash_start_address);
+}
+
+static void bank_scan(void) {
+	int found = 0;
+	int sector;
+	uint32_t i;
+
+	bank_active = 0;
+	bank_sequence = 0;
+	bank_sector = 0;
+	bank_slot = 0;
+	for(sector = 0; sector < 2; sector++) {
+		const struct bank_record* rec = bank_records(sector);
+
+		for(i = 0; i < BANK_RECORDS_PER_SECTOR && rec[i].sequence != 0xFFFFFFFF; i++) {
+			if((rec[i].bank & ~1) != BANK_RECORD_MAGIC || (found && rec[i].sequence <= bank_sequence))
+				continue;
+			found = 1;
+			bank_active = rec[i].bank & 1;
+			bank_sequence = rec[i].sequence;
+			bank_sector = sector;
+			bank_slot = i + 1;
 		}
-		flash_load_curaddr++;
 	}
+	bank_scanned = 1;
+}
+
+uint32_t flash_bank_active(void) {
+	if(!bank_scanned)
+		bank_scan();
+	return bank_active ? PROGRAM_BANK_B : PROGRAM_BANK_A;
+}
+
+uint32_t flash_bank_inactive(void) {
+	return (flash_bank_active() == PROGRAM_BANK_A) ? PROGRAM_BANK_B : PROGRAM_BANK_A;
+}
+
+int flash_bank_activate(uint32_t bank) {
+	const struct bank_record* slot;
+	struct bank_record rec;
+	uint32_t sector_addr;
+	int full;
+
+	if(bank != PROGRAM_BANK_A && bank != PROGRAM_BANK_B)
+		return 0;
+	if(bank == flash_bank_active())
+		return 1;
+
+	slot = bank_records(bank_sector) + bank_slot;
+	full = bank_slot == BANK_RECORDS_PER_SECTOR || slot->sequence != 0xFFFFFFFF || slot->bank != 0xFFFFFFFF;
+	if(full) {
+		bank_sector ^= 1;
+		bank_slot = 0;
+		if(!flash_erase_sector(BANK_RECORDS_BEGIN + bank_sector*FLASH_SECTOR_SIZE))
+			return 0;
+	}
+
+	rec.sequence = bank_sequence + 1;
+	rec.bank = BANK_RECORD_MAGIC | (bank == PROGRAM_BANK_B);
+	sector_addr = BANK_RECORDS_BEGIN + bank_sector*FLASH_SECTOR_SIZE;
+	memset(buf, 0xFF, FLASH_SECTOR_SIZE); /* blank phrases are not programmed */
+	memcpy(buf + bank_slot*sizeof(rec), &rec, sizeof(rec));
+	if(!flash_program_sector(sector_addr, buf) || memcmp(bank_records(bank_sector) + bank_slot, &rec, sizeof(rec)))
+		return 0;
+
+	bank_active = rec.bank & 1;
+	bank_sequence = rec.sequence;
+	bank_slot++;
+	if(full) /* the new record is in place, the older ones can go */
+		flash_erase_sector(BANK_RECORDS_BEGIN + (bank_sector^1)*FLASH_SECTOR_SIZE);
 	return 1;
 }
+#endif
 
-int flash_load_finalize() {
-	uint32_t tail = flash_load_curaddr & 0x1FF;
-	memcpy(buf+tail, (uint8_t*) (flash_load_curaddr + flash_start_address), 512-tail);
-	return flash_write_sector(flash_load_curaddr & ~0x1FF, buf);
+/* A delta target is rebuilt from the installed image, which has to be at addr, in place unless FLASH_DUAL_BANK puts
+ * the new image into the other bank. A compressed target is decompressed first, to the delta if it is one. The rebuilt image is hashed and programmed like a full one. */
+static int install_delta;
+static int install_compressed;
+static int install_boosted; /* the core runs at full clock while the image is hashed */
+
+static bool delta_output(const uint8_t* data, size_t len) {
+	return flash_load_continue(data, len);
+}
+
+static bool install_output(const uint8_t* data, size_t len) {
+	if(install_delta)
+		return uptane_delta_feed(data, len, delta_output);
+
+	return flash_load_continue(data, len);
+}
+
+int flash_install_prepare(uint32_t addr, uint32_t size) {
+	const uptane_targets_t* targets = state_get_targets();
+#ifdef FLASH_DUAL_BANK
+	/* the installed image stays untouched in the active bank */
+	uint32_t base = addr - PROGRAM_FLASH_BEGIN + flash_bank_active();
+	int in_place = 0;
+
+	addr = addr - PROGRAM_FLASH_BEGIN + flash_bank_inactive();
+#else
+	uint32_t base = addr;
+	int in_place = 1;
+#endif
+
+	if(!uptane_verify_firmware_init())
+		return 0;
+
+	if(!install_boosted) { /* still boosted if the previous install was never finalized */
+		clock_boost_begin();
+		install_boosted = 1;
+	}
+
+	install_delta = (targets->delta_length != 0);
+	if(install_delta) {
+		/* uptane_verify_firmware_init() made sure the installed image is the base */
+		uptane_delta_init((const uint8_t*) (base + flash_start_address), state_get_installation_state()->firmware_length,
+				targets->length, in_place);
+		size = targets->length;
+	}
+
+	install_compressed = (targets->compressed_length != 0);
+	if(install_compressed) {
+		uptane_decompress_init(install_delta ? targets->delta_length : targets->length);
+		size = targets->length;
+	}
+
+	load_start(addr, size, 1);
+	return 1;
 }
 
+int flash_install_continue(const uint8_t* data, uint32_t len) {
+	if(install_compressed)
+		return uptane_decompress_feed(data, len, install_output) && !load_failed;
+
+	return install_output(data, len) && !load_failed;
+}
+
+/* Programs the last partial sector and checks the hash, the new image must only be activated if this returns 1 */
+int flash_install_finalize_begin(void) {
+	load_finish_begin();
+	return 1;
+}
+
+int flash_install_finalize_step(void) {
+	int res = load_finish_step();
+
+	if(res == FLASH_LOAD_BUSY)
+		return res;
+
+	if(install_compressed && !uptane_decompress_finalize())
+		res = 0;
+	if(install_delta && !uptane_delta_finalize())
+		res = 0;
+
+	res = uptane_verify_firmware_finalize() && res;
+	if(install_boosted) {
+		clock_boost_end();
+		install_boosted = 0;
+	}
+#ifdef FLASH_DUAL_BANK
+	if(res)
+		res = flash_bank_activate(flash_bank_inactive());
+#endif
+	return res;
+}
+
+int flash_install_finalize(void) {
+	int res;
+
+	flash_install_finalize_begin();
+	while((res = flash_install_finalize_step()) == FLASH_LOAD_BUSY);
+	return res;
+}
@@ -6,9 +6,47 @@
 #define PROGRAM_FLASH_BEGIN 0x08000
 #define PROGRAM_FLASH_END 0x20000
 
+#ifdef FLASH_DUAL_BANK
+/* The program area holds two banks and the records of which one is active in its last two sectors. The script runs
+ * from the active bank while an update is written to the other one, activating it is a single flash phrase. Program
+ * addresses from PROGRAM_FLASH_BEGIN to PROGRAM_IMAGE_END are the ones of a bank, flash_bank_inactive() and
+ * flash_bank_active() tell where they are. */
+#define PROGRAM_BANK_SIZE 0xBE00
+#define PROGRAM_BANK_A PROGRAM_FLASH_BEGIN
+#define PROGRAM_BANK_B (PROGRAM_BANK_A + PROGRAM_BANK_SIZE)
+#define BANK_RECORDS_BEGIN (PROGRAM_BANK_B + PROGRAM_BANK_SIZE) /* 0x1FC00 */
+#define PROGRAM_IMAGE_END (PROGRAM_FLASH_BEGIN + PROGRAM_BANK_SIZE)
+
+uint32_t flash_bank_active(void);
+uint32_t flash_bank_inactive(void);
+/* bank is PROGRAM_BANK_A or PROGRAM_BANK_B, activating the inactive one after an update rolls it back */
+int flash_bank_activate(uint32_t bank);
+#else
+#define PROGRAM_IMAGE_END PROGRAM_FLASH_END
+#endif
+
 int flash_load_erase(uint32_t start, uint32_t size);
 int flash_load_prepare(uint32_t addr, uint32_t size);
 int flash_load_continue(const uint8_t* data, uint32_t len);
 int flash_load_finalize(void);
 
+/* flash_load_erase() and flash_load_finalize() in steps, so that the caller can serve the bus in between. A step
+ * returns FLASH_LOAD_BUSY until the operation is over, then 1, or 0 if it failed. An erase step takes one sector. */
+#define FLASH_LOAD_BUSY 2
+int flash_load_erase_begin(uint32_t start, uint32_t size);
+int flash_load_erase_step(void);
+int flash_load_finalize_begin(void);
+int flash_load_finalize_step(void);
+
+/* Like flash_load_*, with the image hashed against the Uptane targets while it is programmed. For a delta target the
+ * data is the delta, the installed image it applies to has to be at addr. For a compressed target it is compressed
+ * with heatshrink. With FLASH_DUAL_BANK addr is a bank address, the image goes to the inactive bank and the delta
+ * applies to the active one. The inactive bank is activated once the hash is verified. */
+int flash_install_prepare(uint32_t addr, uint32_t size);
+int flash_install_continue(const uint8_t* data, uint32_t len);
+int flash_install_finalize(void);
+/* In steps like flash_load_finalize_begin() and flash_load_finalize_step(), the last step checks the hash */
+int flash_install_finalize_begin(void);
+int flash_install_finalize_step(void);
+
 #endif /* ATS_BOOT_FLASH_LOADER_H */
@@ -1,28 +1,151 @@
 #include <isotp/isotp.h>
-#include <isotp/allocate.h>
+#include "isotp_allocate.h"
+#include "isotp_dispatch.h"
+#include "pool.h"
 
-#define NUM_ISOTP_BUFS 2
-uint8_t buffers[NUM_ISOTP_BUFS][OUR_MAX_ISO_TP_MESSAGE_SIZE];
+/* The RAM of a message being received and one being sent for every session at the largest size, shared by blocks of
+ * ISOTP_ALLOC_CLASSES sizes. A request gets a block of the smallest class it fits in, or of a larger one if those are
+ * all in use, so short UDS requests and responses don't take a whole message buffer each. */
+#define ISOTP_ARENA_BUDGET (2 * ISOTP_SESSIONS * OUR_MAX_ISO_TP_MESSAGE_SIZE)
 
-uint8_t buf_occupied;
+#define CLASS_0_SIZE 16
+#define CLASS_1_SIZE 64
+#define CLASS_2_SIZE 512
+#define CLASS_3_SIZE OUR_MAX_ISO_TP_MESSAGE_SIZE
+
+/* Blocks of the classes. The smaller ones are left out if OUR_MAX_ISO_TP_MESSAGE_SIZE is less than four times their size,
+ * the largest one takes what is left of the budget. */
+#define CLASS_BLOCKS(size, n) ((4 * (size) <= OUR_MAX_ISO_TP_MESSAGE_SIZE) ? (n) : 0)
+#ifndef ISOTP_CLASS_0_BLOCKS
+#define ISOTP_CLASS_0_BLOCKS CLASS_BLOCKS(CLASS_0_SIZE, 8)
+#endif
+#ifndef ISOTP_CLASS_1_BLOCKS
+#define ISOTP_CLASS_1_BLOCKS CLASS_BLOCKS(CLASS_1_SIZE, 4)
+#endif
+#ifndef ISOTP_CLASS_2_BLOCKS
+#define ISOTP_CLASS_2_BLOCKS CLASS_BLOCKS(CLASS_2_SIZE, 2)
+#endif
+#ifndef ISOTP_CLASS_3_BLOCKS
+#define ISOTP_CLASS_3_BLOCKS ((ISOTP_ARENA_BUDGET - CLASS_3_OFFSET) / CLASS_3_SIZE)
+#endif
+
+#define CLASS_0_OFFSET 0
+#define CLASS_1_OFFSET (CLASS_0_OFFSET + ISOTP_CLASS_0_BLOCKS * CLASS_0_SIZE)
+#define CLASS_2_OFFSET (CLASS_1_OFFSET + ISOTP_CLASS_1_BLOCKS * CLASS_1_SIZE)
+#define CLASS_3_OFFSET (CLASS_2_OFFSET + ISOTP_CLASS_2_BLOCKS * CLASS_2_SIZE)
+#define ISOTP_ARENA_SIZE (CLASS_3_OFFSET + ISOTP_CLASS_3_BLOCKS * CLASS_3_SIZE)
+
+#define NUM_ISOTP_BUFS (ISOTP_CLASS_0_BLOCKS + ISOTP_CLASS_1_BLOCKS + ISOTP_CLASS_2_BLOCKS + ISOTP_CLASS_3_BLOCKS)
+
+/* no larger than the buffers it replaces, with a block of the largest class for every session */
+static uint8_t arena[(ISOTP_ARENA_SIZE <= ISOTP_ARENA_BUDGET && ISOTP_CLASS_3_BLOCKS >= ISOTP_SESSIONS) ?
+		ISOTP_ARENA_SIZE : -1];
+
+static uptane_pool_t classes[ISOTP_ALLOC_CLASSES] = {
+	{UPTANE_POOL_ALL(ISOTP_CLASS_0_BLOCKS), arena + CLASS_0_OFFSET, CLASS_0_SIZE, ISOTP_CLASS_0_BLOCKS UPTANE_POOL_STATS_INIT},
+	{UPTANE_POOL_ALL(ISOTP_CLASS_1_BLOCKS), arena + CLASS_1_OFFSET, CLASS_1_SIZE, ISOTP_CLASS_1_BLOCKS UPTANE_POOL_STATS_INIT},
+	{UPTANE_POOL_ALL(ISOTP_CLASS_2_BLOCKS), arena + CLASS_2_OFFSET, CLASS_2_SIZE, ISOTP_CLASS_2_BLOCKS UPTANE_POOL_STATS_INIT},
+	{UPTANE_POOL_ALL(ISOTP_CLASS_3_BLOCKS), arena + CLASS_3_OFFSET, CLASS_3_SIZE, ISOTP_CLASS_3_BLOCKS UPTANE_POOL_STATS_INIT},
+};
+
+/* index of the first block of a class in buf_owner and buf_size */
+static const uint8_t class_first[ISOTP_ALLOC_CLASSES] = {
+	0,
+	ISOTP_CLASS_0_BLOCKS,
+	ISOTP_CLASS_0_BLOCKS + ISOTP_CLASS_1_BLOCKS,
+	ISOTP_CLASS_0_BLOCKS + ISOTP_CLASS_1_BLOCKS + ISOTP_CLASS_2_BLOCKS,
+};
+
+static int buf_owner[NUM_ISOTP_BUFS];
+static uint16_t buf_size[NUM_ISOTP_BUFS]; /* requested, 0 if the block is free */
+static int alloc_owner;
+
+static struct isotp_alloc_stats stats;
 
 uint8_t* allocate(size_t size) {
-        (void) size;
+	uint8_t* buf;
+	int fits = -1; /* the class of the request */
+	int c;
 	int i;
 
-	/* If NUM_ISOTP_BUFS gets large enough consider optimization with clz command */
-	for(i = 0; i < NUM_ISOTP_BUFS; i++) {
-		if(!(buf_occupied & (1 << i))) {
-			buf_occupied |= (1 << i);
-			return buffers[i];
-		}
+	if(size > OUR_MAX_ISO_TP_MESSAGE_SIZE) {
+		stats.failed++;
+		return NULL;
 	}
 
+	for(c = 0; c < ISOTP_ALLOC_CLASSES; c++) {
+		if(size > classes[c].block_size || !classes[c].num)
+			continue;
+		if(fits < 0)
+			fits = c;
+		buf = uptane_pool_alloc(&classes[c]);
+		if(!buf)
+			continue;
+
+		i = class_first[c] + uptane_pool_index(&classes[c], buf);
+		buf_owner[i] = alloc_owner;
+		buf_size[i] = size ? size : 1;
+		if(c != fits)
+			stats.spilled++;
+		if(++stats.used[c] > stats.high_water[c])
+			stats.high_water[c] = stats.used[c];
+		stats.bytes_used += buf_size[i];
+		if(stats.bytes_used > stats.bytes_high_water)
+			stats.bytes_high_water = stats.bytes_used;
+		return buf;
+	}
+
+	stats.failed++;
 	return NULL;
 }
 
+static void free_block(int c, int index) {
+	int i = class_first[c] + index;
+
+	if(!buf_size[i])
+		return;
+
+	uptane_pool_free(&classes[c], classes[c].blocks + index * classes[c].block_size);
+	stats.used[c]--;
+	stats.bytes_used -= buf_size[i];
+	buf_size[i] = 0;
+}
+
 void free_allocated(uint8_t* data) {
-	int i = ((uint32_t) data - (uint32_t)buffers)/(sizeof(uint8_t) * OUR_MAX_ISO_TP_MESSAGE_SIZE);
+	int index;
+	int c;
+
+	/* the classes lie in the arena one after the other */
+	for(c = ISOTP_ALLOC_CLASSES - 1; c >= 0; c--) {
+		if(data >= classes[c].blocks) {
+			index = uptane_pool_index(&classes[c], data);
+			if(index >= 0)
+				free_block(c, index);
+			return;
+		}
+	}
+}
+
+void isotp_allocate_owner(int owner) {
+	alloc_owner = owner;
+}
+
+void isotp_free_owned(int owner) {
+	int c;
+	int i;
 
-	buf_occupied &= ~(1 << i);
+	for(c = 0; c < ISOTP_ALLOC_CLASSES; c++)
+		for(i = 0; i < (int) classes[c].num; i++)
+			if(buf_owner[class_first[c] + i] == owner)
+				free_block(c, i);
+}
+
+void isotp_allocate_stats(struct isotp_alloc_stats* out) {
+	int c;
+
+	*out = stats;
+	for(c = 0; c < ISOTP_ALLOC_CLASSES; c++) {
+		out->block_size[c] = classes[c].block_size;
+		out->blocks[c] = classes[c].num;
+	}
 }
@@ -0,0 +1,28 @@
+#ifndef ATS_BOOT_ISOTP_ALLOCATE_H
+#define ATS_BOOT_ISOTP_ALLOCATE_H
+
+#include <stdint.h>
+#include <isotp/allocate.h>
+
+/* Buffers allocated from now on belong to owner, so that the ones of a stream that has been given up can be freed */
+void isotp_allocate_owner(int owner);
+void isotp_free_owned(int owner);
+
+/* Buffers come in blocks of 16, 64, 512 and OUR_MAX_ISO_TP_MESSAGE_SIZE bytes, see isotp_allocate.c */
+#define ISOTP_ALLOC_CLASSES 4
+
+/* Occupancy of the classes since start, e.g. to size them */
+struct isotp_alloc_stats {
+	uint16_t block_size[ISOTP_ALLOC_CLASSES];
+	uint8_t blocks[ISOTP_ALLOC_CLASSES];
+	uint8_t used[ISOTP_ALLOC_CLASSES];
+	uint8_t high_water[ISOTP_ALLOC_CLASSES];
+	uint16_t bytes_used; /* asked for by the buffers in use, the rest of their blocks is wasted */
+	uint16_t bytes_high_water;
+	uint32_t spilled; /* buffers that got a larger block as the class they fit in was full */
+	uint32_t failed; /* requests that got no buffer */
+};
+
+void isotp_allocate_stats(struct isotp_alloc_stats* stats);
+
+#endif // ATS_BOOT_ISOTP_ALLOCATE_H
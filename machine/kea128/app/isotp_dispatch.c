@@ -1,84 +1,411 @@
 #include "isotp_dispatch.h"
+#include "isotp_allocate.h"
 #include "can.h"
 #include "systimer.h"
 
-/* Simple dispatcher supporting only one sending and one receiving stream,
- * everything else will be dropped */
+#include <string.h>
 
-static IsoTpReceiveHandle receive_handle;
-static IsoTpSendHandle send_handle;
-static IsoTpMessage send_message;
+/* Dispatcher of up to ISOTP_SESSIONS receiving and as many sending streams, told apart by their arbitration IDs.
+ * Frames of further streams are dropped. Every session has its own timer and flow control, and its buffers come
+ * from the isotp_allocate.c pool. Messages taken as a stream bypass isotp-c and the pool, see isotp_dispatch.h.
+ *
+ * One message received at a time bypasses isotp-c as well: after its first frame the RX interrupt writes the data of
+ * the consecutive frames straight into the pool buffer (can_direct_begin()), instead of the ring, a struct can_pack
+ * and isotp-c copying each byte in turn. */
+
+struct receive_session {
+	int active;
+	uint32_t af;
+	uint32_t ts; /* last frame received */
+	IsoTpReceiveHandle handle;
+
+	/* Received by the RX interrupt */
+	int direct;
+	uint8_t* buf;
+	uint16_t size;
+	uint16_t received; /* by the last look, a change is a frame for the timer */
+};
+
+struct send_session {
+	int active;
+	uint32_t af;
+	uint32_t ts; /* last frame sent, or the first frame while waiting for flow control */
+	IsoTpSendHandle handle;
+	IsoTpMessage message;
+	uint8_t* buf; /* copy of the data, the caller's buffer is reused for the next message */
+
+	/* Flow control of the peer: consecutive frames in a block (0 for all of them), the ones left in the current
+	 * block and the gap between them in ms */
+	uint8_t block_size;
+	uint8_t block_left;
+	uint32_t stmin;
+};
+
+struct stream {
+	int active;
+	int broken; /* frames are still taken up to the end of the message, but not handed on */
+	uint32_t af;
+	uint32_t ts; /* last frame received */
+	uint16_t size;
+	uint16_t received;
+	uint8_t sn; /* sequence number of the next consecutive frame */
+};
+
+static struct receive_session receive_sessions[ISOTP_SESSIONS];
+static struct send_session send_sessions[ISOTP_SESSIONS];
+static struct receive_session* direct_session; /* the one of can_direct_begin(), NULL if there is none */
+
+/* owners of pool buffers, see isotp_allocate.h */
+#define RECEIVE_OWNER(i) (i)
+#define SEND_OWNER(i) (ISOTP_SESSIONS + (i))
 
 static IsoTpShims shims;
 
 static IsoTpMessageReceivedHandler received_callback = NULL;
 static IsoTpMessageSentHandler sent_callback = NULL;
 
-int receiving = 0;
-int sending = 0;
+static struct stream stream;
+static IsoTpStreamStart stream_start_callback = NULL;
+static IsoTpStreamData stream_data_callback = NULL;
+static IsoTpStreamEnd stream_end_callback = NULL;
 
-/* Timestamp to limit sending frequency by 100Hz*/
-uint32_t sending_ts;
+static uint32_t decode_stmin(uint8_t stmin) {
+	if(stmin <= 0x7F)
+		return stmin;
+	if(stmin >= 0xF1 && stmin <= 0xF9)
+		return 1; /* 100-900 us, the timer counts ms */
+	return 0x7F; /* reserved values mean the longest gap */
+}
 
 void isotp_dispatch_init(IsoTpMessageReceivedHandler received_cb, IsoTpMessageSentHandler sent_cb, IsoTpShims s) {
 	received_callback = received_cb;
 	sent_callback = sent_cb;
 	shims = s;
 
-	receiving = sending = 0;
+	memset(receive_sessions, 0, sizeof(receive_sessions));
+	memset(send_sessions, 0, sizeof(send_sessions));
+	memset(&stream, 0, sizeof(stream));
+	direct_session = NULL;
+	can_direct_end();
 }
 
-void isotp_dispatch() {
-	struct can_pack pack;
-
-	if(can_recv(&pack)) {
-		if((pack.data[0] >> 4) == 0x3) { /* Flow control */
-			/* TODO: make isotp-c work with SA and TA, not AF*/
-
-			if(sending && (pack.af == send_handle.receiving_arbitration_id))
-				isotp_receive_flowcontrol(&shims, &send_handle, pack.af, pack.data, pack.dlc);
-		} else {
-			if(!receiving) {
-				receive_handle = isotp_receive(&shims, pack.af, received_callback);
-				receiving = 1;
+void isotp_dispatch_stream(IsoTpStreamStart start_cb, IsoTpStreamData data_cb, IsoTpStreamEnd end_cb) {
+	stream_start_callback = start_cb;
+	stream_data_callback = data_cb;
+	stream_end_callback = end_cb;
+}
+
+/* The session receiving from af, a new one if there is none yet. NULL if all of them are busy. */
+static struct receive_session* receive_session(uint32_t af) {
+	struct receive_session* unused = NULL;
+	int i;
+
+	for(i = 0; i < ISOTP_SESSIONS; i++) {
+		if(receive_sessions[i].active && receive_sessions[i].af == af)
+			return &receive_sessions[i];
+		if(!receive_sessions[i].active && !unused)
+			unused = &receive_sessions[i];
+	}
+
+	if(unused) {
+		unused->active = 1;
+		unused->af = af;
+		unused->handle = isotp_receive(&shims, af, received_callback);
+	}
+	return unused;
+}
+
+/* Ends the message of direct_session, the pool buffer is freed with the other ones of the session */
+static void direct_stop(void) {
+	can_direct_end();
+	direct_session->direct = 0;
+	direct_session = NULL;
+}
+
+/* Hands on the message of direct_session once the RX interrupt has it all, gives it up if a frame broke it */
+static void direct_poll(void) {
+	struct receive_session* session = direct_session;
+	IsoTpMessage message;
+	uint16_t received;
+	int state;
+
+	if(!session)
+		return;
+
+	state = can_direct_state(&received);
+	if(received != session->received) {
+		session->received = received;
+		session->ts = time_get();
+	}
+	if(state == CAN_DIRECT_BUSY)
+		return;
+
+	direct_stop();
+	session->active = 0;
+	if(state == CAN_DIRECT_DONE && received_callback) {
+		message = isotp_new_send_message(session->af, session->buf, session->size);
+		message.completed = true;
+		received_callback(&message);
+	}
+	free_allocated(session->buf);
+}
+
+/* 1 if the frame is the first frame of a message received by the RX interrupt from now on */
+static int direct_first_frame(const struct can_pack* pack) {
+	static const uint8_t flow_control[3] = {0x30, 0x00, 0x00}; /* continue to send all of it */
+	struct receive_session* session;
+	uint16_t size;
+	int owner;
+
+	if(direct_session || pack->dlc != 8 || (pack->data[0] >> 4) != 0x1)
+		return 0;
+
+	size = ((pack->data[0] & 0x0F) << 8) | pack->data[1];
+	if(size <= 6 || size > OUR_MAX_ISO_TP_MESSAGE_SIZE) /* 0 is the escape to 32 bit lengths, isotp-c gets those */
+		return 0;
+
+	session = receive_session(pack->af);
+	if(!session)
+		return 0;
+
+	/* isotp-c may have been receiving an earlier message from the peer */
+	owner = RECEIVE_OWNER(session - receive_sessions);
+	isotp_free_owned(owner);
+	isotp_allocate_owner(owner);
+	session->buf = allocate(size);
+	if(!session->buf)
+		return 0;
+
+	memcpy(session->buf, pack->data + 2, 6);
+	session->direct = 1;
+	session->ts = time_get();
+	session->size = size;
+	session->received = 6;
+	direct_session = session;
+	/* before the flow control, the peer sends the consecutive frames right after it */
+	can_direct_begin(pack->af, session->buf, size, 6, 1);
+	shims.send_can_message(ISOTP_REPLY_AF(pack->af), flow_control, sizeof(flow_control), shims.private_data);
+	return 1;
+}
+
+static void stream_end(int ok) {
+	stream.active = 0;
+	stream_end_callback(stream.af, ok && !stream.broken);
+}
+
+/* 1 if the frame belongs to a stream */
+static int stream_frame(const struct can_pack* pack) {
+	static const uint8_t flow_control[3] = {0x30, 0x00, 0x00}; /* continue to send all of it */
+	uint16_t size;
+	uint8_t len;
+	int kind;
+	int i;
+
+	if(!stream_start_callback || pack->dlc < 2)
+		return 0;
+
+	if((pack->data[0] >> 4) == 0x1) { /* First frame */
+		size = ((pack->data[0] & 0x0F) << 8) | pack->data[1];
+		len = pack->dlc - 2;
+		if(size <= len) /* 0 is the escape to 32 bit lengths, isotp-c gets those */
+			return 0;
+		if(stream.active) {
+			if(stream.af != pack->af)
+				return 0;
+			stream_end(0); /* restarted by the peer */
+		}
+		kind = stream_start_callback(pack->af, pack->data + 2, len, size);
+		if(!kind)
+			return 0;
+
+		/* isotp-c may have been receiving an earlier message from the peer */
+		for(i = 0; i < ISOTP_SESSIONS; i++) {
+			if(receive_sessions[i].active && receive_sessions[i].af == pack->af) {
+				isotp_free_owned(RECEIVE_OWNER(i));
+				receive_sessions[i].active = 0;
 			}
+		}
+
+		stream.active = 1;
+		stream.broken = 0;
+		stream.af = pack->af;
+		stream.ts = time_get();
+		stream.size = size;
+		stream.received = len;
+		stream.sn = 1;
+		stream_data_callback(pack->data + 2, len);
+		if(kind != ISOTP_STREAM_SILENT)
+			shims.send_can_message(ISOTP_REPLY_AF(pack->af), flow_control, sizeof(flow_control), shims.private_data);
+		return 1;
+	}
+
+	if(!stream.active || stream.af != pack->af)
+		return 0;
+
+	if((pack->data[0] >> 4) != 0x2) /* a single frame instead, the message is given up */
+		return 0;
+
+	stream.ts = time_get();
+	if((pack->data[0] & 0x0F) != stream.sn) {
+		stream_end(0);
+		return 1;
+	}
+	stream.sn = (stream.sn + 1) & 0x0F;
+
+	len = pack->dlc - 1;
+	if(len > stream.size - stream.received)
+		len = stream.size - stream.received;
+	if(!stream.broken)
+		stream_data_callback(pack->data + 1, len);
+	stream.received += len;
 
-			if(pack.af == receive_handle.arbitration_id) {
-				IsoTpMessage message = isotp_continue_receive(&shims, &receive_handle, pack.af, pack.data, pack.dlc);
-				/* TODO: Fix error handling in isotp-c */
-				if(message.completed && receive_handle.completed)
-					receiving = 0 ;
+	if(stream.received == stream.size)
+		stream_end(1);
+	return 1;
+}
+
+static void receive_frame(const struct can_pack* pack) {
+	struct receive_session* session;
+	IsoTpMessage message;
+	int i;
+
+	if((pack->data[0] >> 4) == 0x3) { /* Flow control */
+		/* TODO: make isotp-c work with SA and TA, not AF*/
+		for(i = 0; i < ISOTP_SESSIONS; i++) {
+			struct send_session* s = &send_sessions[i];
+
+			if(!s->active || pack->af != s->handle.receiving_arbitration_id)
+				continue;
+			if((pack->data[0] & 0x0F) == 0x0 && pack->dlc >= 3) { /* continue to send */
+				s->block_size = pack->data[1];
+				s->block_left = pack->data[1];
+				s->stmin = decode_stmin(pack->data[2]);
 			}
+			isotp_receive_flowcontrol(&shims, &s->handle, pack->af, pack->data, pack->dlc);
 		}
+		return;
 	}
 
-	if(sending && (send_handle.to_send != 0) && (time_passed(sending_ts) > 10)) {
-		isotp_continue_send(&shims, &send_handle);
+	/* the message received by the RX interrupt ends before the next one from the peer starts */
+	if(direct_session && direct_session->af == pack->af) {
+		direct_poll();
+		if(direct_session)
+			return; /* dropped, came in before can_direct_begin() */
+	}
+
+	if(stream_frame(pack))
+		return;
+
+	if(stream.active && stream.af == pack->af)
+		stream_end(0);
+
+	if(direct_first_frame(pack))
+		return;
+
+	session = receive_session(pack->af);
+	if(!session)
+		return; /* dropped, all sessions are busy */
+
+	session->ts = time_get();
+	isotp_allocate_owner(RECEIVE_OWNER(session - receive_sessions));
+	message = isotp_continue_receive(&shims, &session->handle, pack->af, pack->data, pack->dlc);
+	/* TODO: Fix error handling in isotp-c */
+	if(message.completed && session->handle.completed)
+		session->active = 0;
+}
+
+static void send_session_end(struct send_session* s) {
+	free_allocated(s->buf);
+	s->active = 0;
+}
+
+static void send_frames(struct send_session* s) {
+	/* As many consecutive frames as the block and the CAN queue allow, with STmin between them if there is one */
+	while(s->active && (s->handle.to_send != 0) && (s->block_size == 0 || s->block_left != 0) &&
+			(s->stmin == 0 || time_passed(s->ts) > s->stmin) && can_send_free() > 0) {
+		isotp_continue_send(&shims, &s->handle);
+		if(s->block_left)
+			s->block_left--;
 
 		/* No error handling */
-		if(send_handle.completed)
-			sending = 0;
-		else
-			sending_ts = time_get();
+		if(s->handle.completed) {
+			send_session_end(s);
+			break;
+		}
+		s->ts = time_get();
+		if(s->stmin != 0)
+			break;
 	}
 
-	if(sending && time_passed(sending_ts) > 1000) {
-		sending = 0;
+	if(s->active && time_passed(s->ts) > ISOTP_TIMEOUT) {
+		send_session_end(s);
 		/* TODO: some error callback?*/
 	}
 }
 
+void isotp_dispatch() {
+	int i;
+
+	can_recv_batch(receive_frame);
+	direct_poll();
+
+	if(stream.active && time_passed(stream.ts) > ISOTP_TIMEOUT)
+		stream_end(0);
+
+	for(i = 0; i < ISOTP_SESSIONS; i++) {
+		if(receive_sessions[i].active && time_passed(receive_sessions[i].ts) > ISOTP_TIMEOUT) {
+			if(receive_sessions[i].direct)
+				direct_stop();
+			isotp_free_owned(RECEIVE_OWNER(i));
+			receive_sessions[i].active = 0;
+		}
+		send_frames(&send_sessions[i]);
+	}
+}
+
+int isotp_dispatch_busy(void) {
+	int i;
+
+	if(stream.active)
+		return 1;
+	for(i = 0; i < ISOTP_SESSIONS; i++)
+		if(receive_sessions[i].active || send_sessions[i].active)
+			return 1;
+	return 0;
+}
+
 int isotp_dispatch_send(const uint8_t* data, uint16_t size, uint32_t af) {
-	if(sending)
+	struct send_session* s = NULL;
+	int i;
+
+	for(i = 0; i < ISOTP_SESSIONS; i++) {
+		if(send_sessions[i].active && send_sessions[i].af == af)
+			return 0; /* one message at a time to a peer */
+		if(!send_sessions[i].active && !s)
+			s = &send_sessions[i];
+	}
+	if(!s)
 		return 0;
 
-	send_message = isotp_new_send_message(af, data, size);
-	send_handle = isotp_send(&shims, &send_message, sent_callback);
-	if(send_handle.completed)
-		return send_handle.success;
+	isotp_allocate_owner(SEND_OWNER(s - send_sessions));
+	s->buf = allocate(size);
+	if(!s->buf)
+		return 0;
+	memcpy(s->buf, data, size);
+
+	s->af = af;
+	s->message = isotp_new_send_message(af, s->buf, size);
+	s->handle = isotp_send(&shims, &s->message, sent_callback);
+	if(s->handle.completed) {
+		free_allocated(s->buf);
+		return s->handle.success;
+	}
 	/* else */
-	sending = 1;
-	sending_ts = time_get();
+	s->active = 1;
+	s->ts = time_get();
+	s->block_size = 0;
+	s->block_left = 0;
+	s->stmin = 0;
 
 	return 1;
 }
@@ -4,8 +4,33 @@
 #include <stdint.h>
 #include "isotp/isotp.h"
 
+/* Streams received and sent at a time, each one from or to its own arbitration ID */
+#ifndef ISOTP_SESSIONS
+#define ISOTP_SESSIONS 2
+#endif
+/* A stream without a frame for that long is given up */
+#define ISOTP_TIMEOUT 1000
+
+/* Messages taken as a stream are not assembled in a buffer, their data is handed on frame by frame as it comes in.
+ * start sees the data of the first frame, the message is a stream if it returns ISOTP_STREAM, or ISOTP_STREAM_SILENT
+ * for a stream to many receivers, e.g. on a functional address, that is sent without waiting for flow control and
+ * gets none from us. data gets all bytes of the
+ * message in order with the ones of the first frame, end is called once the message is complete (ok is 1) or broken
+ * off. One stream is received at a time. */
+#define ISOTP_STREAM 1
+#define ISOTP_STREAM_SILENT 2
+typedef int (*IsoTpStreamStart)(uint32_t af, const uint8_t* data, uint8_t len, uint16_t size);
+typedef void (*IsoTpStreamData)(const uint8_t* data, uint8_t len);
+typedef void (*IsoTpStreamEnd)(uint32_t af, int ok);
+
+/* Identifier of the replies to af, the source and target addresses swapped */
+#define ISOTP_REPLY_AF(af) ((((af) & 0x1F) << 5) | (((af) >> 5) & 0x1F))
+
 void isotp_dispatch_init(IsoTpMessageReceivedHandler received_cb, IsoTpMessageSentHandler sent_cb, IsoTpShims s);
 void isotp_dispatch(void);
+/* Whether a stream is under way, isotp_dispatch() has to run again within a millisecond even without new frames */
+int isotp_dispatch_busy(void);
 int isotp_dispatch_send(const uint8_t* data, uint16_t size, uint32_t af);
+void isotp_dispatch_stream(IsoTpStreamStart start_cb, IsoTpStreamData data_cb, IsoTpStreamEnd end_cb);
 
 #endif // ATS_BOOT_ISOTP_DISPATCH_H
@@ -0,0 +1,133 @@
+#include "metadata_stage.h"
+#include "flash_load.h"
+
+/* flash_start_address is 0 on real device, but can be overriden for testing*/
+extern uint32_t flash_start_address;
+
+#define STAGE_NONE 0
+#define STAGE_LOADING 1
+#define STAGE_FINALIZING 2
+#define STAGE_READY 3
+
+static int stage_state;
+static uint32_t stage_size;
+static uint32_t stage_len; /* bytes staged so far */
+
+int metadata_stage_begin(uint32_t size) {
+	stage_state = STAGE_NONE;
+	if(size == 0 || size > METADATA_STAGE_SIZE)
+		return 0;
+
+	/* sectors that aren't blank are erased as they are programmed */
+	if(!flash_load_prepare(METADATA_STAGE_BEGIN, size))
+		return 0;
+	stage_size = size;
+	stage_len = 0;
+	stage_state = STAGE_LOADING;
+	return 1;
+}
+
+int metadata_stage_continue(const uint8_t* data, uint32_t len) {
+	if(stage_state != STAGE_LOADING || len > stage_size - stage_len || !flash_load_continue(data, len)) {
+		stage_state = STAGE_NONE;
+		return 0;
+	}
+	stage_len += len;
+	return 1;
+}
+
+int metadata_stage_finalize_begin(void) {
+	if(stage_state != STAGE_LOADING || stage_len != stage_size) {
+		stage_state = STAGE_NONE;
+		return 0;
+	}
+	stage_state = STAGE_FINALIZING;
+	return flash_load_finalize_begin();
+}
+
+int metadata_stage_finalize_step(void) {
+	int res;
+
+	if(stage_state != STAGE_FINALIZING)
+		return stage_state == STAGE_READY;
+
+	res = flash_load_finalize_step();
+	if(res != FLASH_LOAD_BUSY)
+		stage_state = res ? STAGE_READY : STAGE_NONE;
+	return res;
+}
+
+int metadata_stage_finalize(void) {
+	int res;
+
+	if(!metadata_stage_finalize_begin())
+		return 0;
+	while((res = metadata_stage_finalize_step()) == FLASH_LOAD_BUSY);
+	return res;
+}
+
+const char* metadata_stage_data(uint32_t* len) {
+	if(stage_state != STAGE_READY)
+		return NULL;
+
+	*len = stage_len;
+	return (const char*) (METADATA_STAGE_BEGIN + flash_start_address);
+}
+
+/* The part fed at a time, the unconsumed rest of a window and the next one, fits a jsmnint_t of 16 bits */
+#define PART_MAX 0x4000
+
+int metadata_stage_parse_root(uptane_root_t* out_root) {
+	uint16_t result = ROOT_RESULT_IN_PROGRESS;
+	uint32_t offset = 0;
+	uint32_t end = 0; /* of the windows fed so far */
+	uint32_t len;
+	const char* message = metadata_stage_data(&len);
+	int consumed;
+
+	if(message == NULL)
+		return 0;
+
+	uptane_parse_root_init();
+	while(result == ROOT_RESULT_IN_PROGRESS && (end < len || offset < end)) {
+		end = (len - end > METADATA_STAGE_WINDOW) ? end + METADATA_STAGE_WINDOW : len;
+		if(end - offset > PART_MAX)
+			break;
+		consumed = uptane_parse_root_feed(message + offset, (jsmnint_t) (end - offset), out_root, &result);
+		if(consumed < 0 || (end == len && consumed == 0))
+			break;
+		offset += consumed;
+		if(result == ROOT_RESULT_FEED_AGAIN) {
+			/* the second pass starts over */
+			result = ROOT_RESULT_IN_PROGRESS;
+			offset = 0;
+			end = 0;
+		}
+	}
+	while(uptane_parse_root_busy());
+	return result == ROOT_RESULT_END;
+}
+
+uint16_t metadata_stage_parse_targets(uptane_targets_ctx_t* ctx, uptane_targets_t* out_targets) {
+	uint16_t result = RESULT_IN_PROGRESS;
+	uint32_t offset = 0;
+	uint32_t end = 0;
+	uint32_t len;
+	const char* message = metadata_stage_data(&len);
+	int consumed;
+
+	if(message == NULL)
+		return RESULT_ERROR;
+
+	while(result == RESULT_IN_PROGRESS && (end < len || offset < end)) {
+		end = (len - end > METADATA_STAGE_WINDOW) ? end + METADATA_STAGE_WINDOW : len;
+		if(end - offset > PART_MAX)
+			break;
+		consumed = uptane_targets_ctx_feed(ctx, message + offset, (jsmnint_t) (end - offset), out_targets, &result);
+		if(consumed < 0 || (end == len && consumed == 0))
+			break;
+		offset += consumed;
+	}
+	while(uptane_targets_ctx_busy(ctx));
+	return (result == RESULT_IN_PROGRESS) ? RESULT_ERROR : result;
+}
@@ -0,0 +1,45 @@
+#ifndef ATS_BOOT_METADATA_STAGE_H
+#define ATS_BOOT_METADATA_STAGE_H
+
+#include <stdint.h>
+#include "flash.h"
+#include "state_log.h"
+#include "root.h"
+#include "targets.h"
+
+/* Root and targets metadata staged in flash and parsed where it is, so that its size is limited by the staging area
+ * rather than by RAM. The chunks of a message are programmed as they come in, through the two sector buffers of
+ * flash_load_continue(), and the parsers are fed windows of the staged message through the memory map of the flash.
+ * They only read it, their writes go to the pools of common_data_api.h and to their own state. The area is below the
+ * state log, the program flash is left to the images. */
+#ifndef METADATA_STAGE_SIZE
+#define METADATA_STAGE_SIZE (8*FLASH_SECTOR_SIZE)
+#endif
+#define METADATA_STAGE_BEGIN (STATE_LOG_BEGIN - METADATA_STAGE_SIZE)
+
+/* The staged message is fed to a parser like chunks of this size received one by one: each part fed is the next
+ * window with the rest the parser didn't consume of the ones before in front of it. */
+#ifndef METADATA_STAGE_WINDOW
+#define METADATA_STAGE_WINDOW 512
+#endif
+
+/* A message of size bytes, 0 if it doesn't fit in the area. The load engine of flash_load.h is used until the message
+ * is finalized, not to be mixed with an image install. */
+int metadata_stage_begin(uint32_t size);
+int metadata_stage_continue(const uint8_t* data, uint32_t len);
+/* Programs the last sector, 0 unless all size bytes were staged. In steps like flash_load_finalize_begin() and
+ * flash_load_finalize_step(), the flash can't be read while it is programmed. */
+int metadata_stage_finalize(void);
+int metadata_stage_finalize_begin(void);
+int metadata_stage_finalize_step(void);
+
+/* The finalized message in flash, NULL if there is none. Staging the next one ends it. */
+const char* metadata_stage_data(uint32_t* len);
+
+/* uptane_parse_root and uptane_targets_ctx_feed over the finalized message. ctx is set up and initialized by the
+ * caller, with the message in one place uptane_targets_ctx_signed_buffered() may be called on it to check the
+ * signatures in a single verify context. The targets result is RESULT_ERROR if the message ends first. */
+int metadata_stage_parse_root(uptane_root_t* out_root);
+uint16_t metadata_stage_parse_targets(uptane_targets_ctx_t* ctx, uptane_targets_t* out_targets);
+
+#endif /* ATS_BOOT_METADATA_STAGE_H */
@@ -1,14 +1,26 @@
 #include <string.h>
 #include "isotp_dispatch.h"
+#include "isotp_allocate.h"
 
 #include "SKEAZ1284.h" /* include peripheral declarations SKEAZ128M4 */
 #include "can.h"
 #include "led.h"
 #include "systimer.h"
+#include "clock.h"
 #include "flash.h"
 #include "flash_load.h"
+#include "decompress.h"
+#include "crc32.h"
 #include "uds.h"
 #include "script.h"
+#include "trace_ring.h"
+#ifdef UDS_UPTANE
+#include "metadata_stage.h"
+#include "firmware.h"
+#include "state_api.h"
+#include "signatures.h"
+#include "common_data_api.h"
+#endif
 
 #ifndef CAN_ID
 #    error "CAN_ID should be provided"
@@ -23,10 +35,301 @@ uint32_t flash_load_curaddr = 0;
 uint32_t flash_load_size = 0;
 
 int uds_in_download = 0;
+int uds_compressed = 0; /* the download is compressed with heatshrink, flash_load_size is the decompressed size */
 int uds_in_programming = 0;
 
 uint32_t session_ts;
 
+/* Bitrate of normal operation. LinkControl switches the programming session to a faster one, it goes back when the
+ * session ends. */
+#define CAN_BAUD 125000
+
+static uint32_t link_baud = CAN_BAUD;
+static uint32_t link_verified; /* bitrate of the last verifyModeTransition, 0 if none */
+
+static uint8_t uds_seq_number;
+static uint8_t download_nrc; /* a multicast block failed, reported by RequestTransferExit */
+
+/* TransferData to UDS_FUNCTIONAL_TA programs all ECUs of a kind at once. They don't answer the blocks, each one tells
+ * at RequestTransferExit whether all of them went in, along with the CRC-32 of the programmed range. */
+#ifdef UDS_FUNCTIONAL_TA
+#define UDS_MULTICAST(af) (((af) & 0x1F) == UDS_FUNCTIONAL_TA)
+#else
+#define UDS_MULTICAST(af) 0
+#endif
+
+/* The TransferData being received: its sequence number, 1 for a repeated block that is acknowledged but not
+ * programmed, or the NRC it gets */
+static uint8_t transfer_seq;
+static int transfer_repeated;
+static uint8_t transfer_nrc;
+static uint8_t stream_header; /* bytes of the request in front of the data still to skip */
+
+/* A request that runs in the background of the main loop, see UDS_PENDING_INTERVAL. step is a flash_load_*_step(),
+ * other requests are refused until it is over. */
+struct uds_job {
+	int active;
+	uint8_t sid;
+	uint16_t ta;
+	uint8_t op; /* RoutineControl */
+	uint16_t id;
+	uint32_t ts; /* last responsePending */
+	int (*step)(void);
+};
+
+static struct uds_job uds_job;
+
+#ifdef UDS_UPTANE
+/* RequestDownload only takes the image of the Uptane targets stored for this ECU. It is hashed while it is programmed
+ * and checked at RequestTransferExit, the metadata comes before it by RequestFileTransfer, see UDS_FILE_ROOT. */
+#define TRANSFER_IMAGE 0
+#define TRANSFER_ROOT 1
+#define TRANSFER_TARGETS 2
+
+static uint8_t uds_file; /* TRANSFER_*, what the download is */
+static uint32_t file_size;
+static uint32_t file_fed; /* bytes of the file transferred so far */
+static int image_verified; /* the last image matched the targets, for checkProgrammingDependencies */
+
+static uptane_root_t file_root;
+static uptane_targets_t file_targets;
+static uptane_targets_ctx_t file_targets_ctx;
+#endif
+
+static void link_revert(void) {
+	link_verified = 0;
+	if(link_baud != CAN_BAUD) {
+		can_set_baud(CAN_BAUD);
+		link_baud = CAN_BAUD;
+	}
+}
+
+/* Bitrate of a linkControlModeIdentifier, 0 if it isn't supported */
+static uint32_t link_fixed_baud(uint8_t mode) {
+	switch(mode) {
+		case 0x10: return 125000;
+		case 0x11: return 250000;
+		case 0x12: return 500000;
+		case 0x13: return 1000000;
+		default: return 0;
+	}
+}
+
+#ifndef UDS_UPTANE
+static bool load_decompressed(const uint8_t* data, size_t len) {
+	return flash_load_continue(data, len);
+}
+#endif
+
+static void transfer_begin(uint8_t seq, uint32_t len) {
+	transfer_seq = seq;
+	transfer_repeated = 0;
+	transfer_nrc = 0;
+
+	if(!uds_in_download)
+		transfer_nrc = 0x24; /* Sequence Error */
+	else if(download_nrc)
+		transfer_nrc = download_nrc;
+	else if(seq == uds_seq_number) /* Repeated segment, acknowledge and ignore*/
+		transfer_repeated = 1;
+	else if(seq != (uint8_t) (uds_seq_number+1))
+		transfer_nrc = 0x24; /* Sequence Error */
+#ifdef UDS_UPTANE
+	/* the image can't get longer than the target, flash_install_continue() refuses the rest */
+	else if(uds_file != TRANSFER_IMAGE && len > file_size - file_fed)
+		transfer_nrc = 0x31; /* ROOR */
+#else
+	else if(!uds_compressed && flash_load_curaddr + len > flash_load_startaddr+flash_load_size)
+		transfer_nrc = 0x31; /* ROOR */
+#endif
+}
+
+static void transfer_data(const uint8_t* data, uint32_t len) {
+	int res;
+
+	if(transfer_nrc || transfer_repeated)
+		return;
+
+#ifdef UDS_UPTANE
+	if(uds_file != TRANSFER_IMAGE) {
+		res = metadata_stage_continue(data, len);
+		file_fed += len;
+	} else {
+		/* hashed as it is buffered, decompressed or patched first if the target is */
+		res = flash_install_continue(data, len);
+	}
+#else
+	if(uds_compressed) {
+		/* the decompressor refuses data beyond flash_load_size */
+		res = uptane_decompress_feed(data, len, load_decompressed);
+	} else {
+		/* returns as soon as the data is buffered, sectors are programmed in the background */
+		res = flash_load_continue(data, len);
+		flash_load_curaddr += len;
+	}
+#endif
+	if(!res) {
+		uds_in_download = 0;
+		transfer_nrc = 0x72; /* General Programming Failure */
+	}
+}
+
+static void transfer_end(uint16_t ta, int multicast) {
+	if(multicast) {
+		if(transfer_nrc && uds_in_download)
+			download_nrc = transfer_nrc;
+		else if(!transfer_nrc)
+			uds_seq_number = transfer_seq;
+		return;
+	}
+	if(transfer_nrc) {
+		send_uds_error(ta, 0x36, transfer_nrc);
+		return;
+	}
+	uds_seq_number = transfer_seq;
+	send_uds_positive_transferdata(ta, uds_seq_number);
+}
+
+static void job_start(uint16_t ta, uint8_t sid, int (*step)(void)) {
+	uds_job.active = 1;
+	uds_job.sid = sid;
+	uds_job.ta = ta;
+	uds_job.step = step;
+	uds_job.ts = time_get();
+	send_uds_error(ta, sid, 0x78); /* Response pending */
+}
+
+#ifdef UDS_UPTANE
+static int install_exit_step(void) {
+	int res = flash_install_finalize_step();
+
+	if(res == FLASH_LOAD_BUSY)
+		return res;
+	if(res) {
+		uptane_firmware_confirm();
+		image_verified = 1;
+	}
+#ifndef FLASH_DUAL_BANK
+	else
+		flash_erase_sector(PROGRAM_FLASH_BEGIN); /* with the script header, the image that failed never runs */
+#endif
+	return res;
+}
+
+/* Parses the staged file once it is programmed, the signatures are checked in slices of job_pending() */
+static int file_exit_step(void) {
+	uint16_t result;
+	int res = metadata_stage_finalize_step();
+
+	if(res != 1)
+		return res;
+
+	if(uds_file == TRANSFER_ROOT) {
+		if(!metadata_stage_parse_root(&file_root)) {
+			state_set_attack(ATTACK_ROOT_THRESHOLD);
+			return 0;
+		}
+		state_set_root(&file_root);
+		return 1;
+	}
+
+	uptane_targets_ctx_setup(&file_targets_ctx, token_pool, token_pool_size, signature_pool, signature_pool_size,
+			crypto_ctx_pool, crypto_ctx_pool_size, &hash_context, NULL);
+	uptane_targets_ctx_init(&file_targets_ctx);
+	result = metadata_stage_parse_targets(&file_targets_ctx, &file_targets);
+	if(result != RESULT_END_FOUND) {
+		if(result != RESULT_TOO_LARGE) /* the parser has set ATTACK_TARGETS_LARGE */
+			state_set_attack(ATTACK_TARGETS_THRESHOLD);
+		return 0;
+	}
+	state_set_targets(&file_targets);
+	return 1;
+}
+#else
+static int transferexit_step(void) {
+	int res = flash_load_finalize_step();
+
+	if(res == FLASH_LOAD_BUSY)
+		return res;
+	return res && (!uds_compressed || uptane_decompress_finalize());
+}
+#endif
+
+/* Keeps the tester waiting while the job takes longer than UDS_PENDING_INTERVAL */
+static void job_pending(void) {
+	if(uds_job.active && time_passed(uds_job.ts) >= UDS_PENDING_INTERVAL) {
+		uds_job.ts = time_get();
+		send_uds_error(uds_job.ta, uds_job.sid, 0x78); /* Response pending */
+	}
+}
+
+/* Takes a step of the job, sends its result once it is over */
+static void job_run(void) {
+	int res;
+
+	if(!uds_job.active)
+		return;
+
+	res = uds_job.step();
+	if(res == FLASH_LOAD_BUSY) {
+		job_pending();
+		return;
+	}
+
+	uds_job.active = 0;
+	session_ts = time_get();
+	switch(uds_job.sid) {
+		case 0x31: /* RoutineControl */
+			if(!res)
+				send_uds_error(uds_job.ta, 0x31, 0x10); /* General Error */
+			else
+				send_uds_positive_routinecontrol(uds_job.ta, uds_job.op, uds_job.id);
+			break;
+		case 0x37: /* RequestTransferExit */
+			if(!res)
+				send_uds_error(uds_job.ta, 0x37, 0x72); /* General Programming Failure */
+			else
+				send_uds_positive_transferexit(uds_job.ta,
+						uptane_crc32(0, (const uint8_t*) (flash_load_startaddr + flash_start_address), flash_load_size));
+			break;
+	}
+}
+
+/* TransferData blocks longer than a frame are programmed as they come in, see isotp_dispatch_stream() */
+static int stream_start(uint32_t af, const uint8_t* data, uint8_t len, uint16_t size) {
+	if(!uds_in_download || uds_job.active || len < 2 || data[0] != 0x36)
+		return 0;
+
+	session_ts = time_get();
+	transfer_begin(data[1], size - 2);
+	stream_header = 2;
+	return UDS_MULTICAST(af) ? ISOTP_STREAM_SILENT : ISOTP_STREAM;
+}
+
+static void stream_data(const uint8_t* data, uint8_t len) {
+	uint8_t n = (len < stream_header) ? len : stream_header;
+
+	stream_header -= n;
+	if(len > n)
+		transfer_data(data + n, len - n);
+}
+
+static void stream_end(uint32_t af, int ok) {
+	session_ts = time_get();
+
+	if(ok) {
+		transfer_end((af >> 5) & 0x01F, UDS_MULTICAST(af));
+		return;
+	}
+	/* part of the block may be programmed already, the tester has to start the download over */
+	if(!transfer_nrc && !transfer_repeated) {
+		if(UDS_MULTICAST(af))
+			download_nrc = 0x72; /* General Programming Failure */
+		else
+			uds_in_download = 0;
+	}
+}
+
 static uint32_t make_32(uint8_t hh, uint8_t hl, uint8_t lh, uint8_t ll) {
 	return (hh << 24) | (hl << 16) | (lh << 8) | ll;
 }
@@ -36,11 +339,23 @@ void message_received(const IsoTpMessage* message) {
 	uint32_t flash_size;
 	uint8_t addr_len;
 	uint8_t size_len;
-	uint8_t uds_seq_number = 0;
+	uint32_t baud;
+	uint16_t did;
+	struct isotp_alloc_stats alloc_stats;
 	uint16_t ta = (message->arbitration_id >> 5) & 0x01F; /* TODO: untangle session layer */
-	int res;
 	int i;
+#ifdef UDS_UPTANE
+	const uptane_targets_t* targets;
+	uint16_t name_len;
+	uint8_t file;
+	uint32_t size_compressed;
+#endif
 	/* Don't care about AF here, it should be filtered on CAN level */
+	if(uds_job.active) {
+		send_uds_error(ta, message->payload[0], 0x21); /* Busy, repeat request */
+		return;
+	}
+	TRACE_BEGIN(TRACE_UDS_SERVICE, message->payload[0]);
 	/* Switch over SID */
 	switch (message->payload[0]) {
 		case 0x10: /* DiagnosticSessionControl */
@@ -60,6 +375,65 @@ void message_received(const IsoTpMessage* message) {
 			}
 
 			send_uds_positive_sessioncontrol(ta, message->payload[1]);
+			if(!uds_in_programming)
+				link_revert(); /* after the response went out */
+			break;
+
+		case 0x87: /* LinkControl */
+			if(!uds_in_programming) {
+				send_uds_error(ta, 0x87, 0x22); /* Conditions not correct */
+				break;
+			}
+
+			session_ts = time_get();
+
+			if(message->size < 2) {
+				send_uds_error(ta, 0x87, 0x13); /* Invalid format */
+				break;
+			}
+			switch(message->payload[1] & 0x7F) {
+				case 0x01: /* verifyModeTransitionWithFixedParameter */
+					if(message->size != 3) {
+						send_uds_error(ta, 0x87, 0x13); /* Invalid format */
+						break;
+					}
+					baud = link_fixed_baud(message->payload[2]);
+					if(!baud) {
+						send_uds_error(ta, 0x87, 0x31); /* ROOR */
+						break;
+					}
+					link_verified = baud;
+					send_uds_positive_linkcontrol(ta, message->payload[1]);
+					break;
+				case 0x02: /* verifyModeTransitionWithSpecificParameter */
+					if(message->size != 5) {
+						send_uds_error(ta, 0x87, 0x13); /* Invalid format */
+						break;
+					}
+					baud = make_32(0, message->payload[2], message->payload[3], message->payload[4]);
+					if(baud != 125000 && baud != 250000 && baud != 500000 && baud != 1000000) {
+						send_uds_error(ta, 0x87, 0x31); /* ROOR */
+						break;
+					}
+					link_verified = baud;
+					send_uds_positive_linkcontrol(ta, message->payload[1]);
+					break;
+				case 0x03: /* transitionMode */
+					if(!link_verified) {
+						send_uds_error(ta, 0x87, 0x24); /* Sequence Error */
+						break;
+					}
+					if(!(message->payload[1] & 0x80)) /* suppressPosRspMsgIndicationBit */
+						send_uds_positive_linkcontrol(ta, message->payload[1]);
+					/* the response is sent at the old bitrate */
+					if(can_set_baud(link_verified))
+						link_baud = link_verified;
+					link_verified = 0;
+					break;
+				default:
+					send_uds_error(ta, 0x87, 0x12); /* Subfunction not supported */
+					break;
+			}
 			break;
 
 		case 0x31: /* RoutineControl*/
@@ -83,6 +457,28 @@ void message_received(const IsoTpMessage* message) {
 				send_uds_error(ta, 0x31, 0x12); /* SFNS */
 				break;
 			}
+#ifdef UDS_UPTANE
+			if(message->payload[2] == 0xff && message->payload[3] == 0x01) { /* checkProgrammingDependencies */
+				/* the image was checked against the targets at RequestTransferExit, with FLASH_DUAL_BANK its bank
+				 * is active already */
+				if(!image_verified)
+					send_uds_error(ta, 0x31, 0x22); /* Conditions not correct */
+				else
+					send_uds_positive_routinecontrol(ta, message->payload[1], 0xff01);
+				break;
+			}
+#elif defined(FLASH_DUAL_BANK)
+			if(message->payload[2] == 0xff && message->payload[3] == 0x01) { /* checkProgrammingDependencies */
+				/* activates the inactive bank: the update that was just programmed, or the previous image */
+				if(!script_present(flash_bank_inactive()))
+					send_uds_error(ta, 0x31, 0x22); /* Conditions not correct */
+				else if(!flash_bank_activate(flash_bank_inactive()))
+					send_uds_error(ta, 0x31, 0x10); /* General Error */
+				else
+					send_uds_positive_routinecontrol(ta, message->payload[1], 0xff01);
+				break;
+			}
+#endif
 			if(message->size != 12) {
 				send_uds_error(ta, 0x31, 0x13); /* Invalid Format */
 				break;
@@ -91,16 +487,18 @@ void message_received(const IsoTpMessage* message) {
 			flash_size = make_32(message->payload[8], message->payload[9], message->payload[10], message->payload[11]);
 
 			if((flash_addr < PROGRAM_FLASH_BEGIN) ||
-					(flash_addr + flash_size) >= PROGRAM_FLASH_END ||
+					(flash_addr + flash_size) > PROGRAM_IMAGE_END ||
 					(flash_addr + flash_size) < flash_addr) { /*overflow*/
 				send_uds_error(ta, 0x31, 0x31); /* ROOR */
 				break;
 			}
-			res = flash_load_erase(flash_addr, flash_size);
-			if(res)
-				send_uds_error(ta, 0x31, 0x10); /* General Error */
-			else
-				send_uds_positive_routinecontrol(ta, message->payload[1], (message->payload[2] << 8) | message->payload[3]);
+#ifdef FLASH_DUAL_BANK
+			flash_addr = flash_addr - PROGRAM_FLASH_BEGIN + flash_bank_inactive();
+#endif
+			flash_load_erase_begin(flash_addr, flash_size);
+			uds_job.op = message->payload[1];
+			uds_job.id = (message->payload[2] << 8) | message->payload[3];
+			job_start(ta, 0x31, flash_load_erase_step);
 			break;
 		case 0x11: /* ECUReset */
 			if(message->size < 2) {
@@ -129,7 +527,8 @@ void message_received(const IsoTpMessage* message) {
 				send_uds_error(ta, 0x34, 0x13); /* Invalid Format */
 				break;
 			}
-			if(message->payload[1] != 0x00) { /* Only support raw data */
+			/* dataFormatIdentifier: compressionMethod in the high nibble, no encryption is supported */
+			if(message->payload[1] != 0x00 && message->payload[1] != UDS_COMPRESSION_HEATSHRINK) {
 				send_uds_error(ta, 0x34, 0x31); /* ROOR */
 				break;
 			}
@@ -157,46 +556,130 @@ void message_received(const IsoTpMessage* message) {
 			}
 
 			if((flash_addr < PROGRAM_FLASH_BEGIN) ||
-					(flash_addr + flash_size) >= PROGRAM_FLASH_END ||
+					(flash_addr + flash_size) > PROGRAM_IMAGE_END ||
 					(flash_addr + flash_size) < flash_addr) { /*overflow*/
 				send_uds_error(ta, 0x34, 0x31); /* ROOR */
 				break;
 			}
+#ifdef UDS_UPTANE
+			/* the image of the targets, compressed if the target is */
+			targets = state_get_targets();
+			if(flash_size != targets->length ||
+					(message->payload[1] == UDS_COMPRESSION_HEATSHRINK) != (targets->compressed_length != 0)) {
+				send_uds_error(ta, 0x34, 0x31); /* ROOR */
+				break;
+			}
+			image_verified = 0;
+			/* takes the program address, with FLASH_DUAL_BANK it goes to the inactive bank as well */
+			if(!flash_install_prepare(flash_addr, flash_size)) {
+				send_uds_error(ta, 0x34, 0x22); /* Conditions not correct */
+				break;
+			}
+			uds_file = TRANSFER_IMAGE;
+#endif
+#ifdef FLASH_DUAL_BANK
+			/* the script keeps running from the active bank */
+			flash_addr = flash_addr - PROGRAM_FLASH_BEGIN + flash_bank_inactive();
+#endif
 
+#ifndef UDS_UPTANE
 			flash_load_prepare(flash_addr, flash_size);
+			uds_compressed = (message->payload[1] == UDS_COMPRESSION_HEATSHRINK);
+			if(uds_compressed)
+				uptane_decompress_init(flash_size);
+#endif
 			uds_seq_number = 0x00;
+			download_nrc = 0;
 			uds_in_download = 1;
 			flash_load_startaddr = flash_addr;
 			flash_load_curaddr = flash_addr;
 			flash_load_size = flash_size;
 			send_uds_positive_reqdownload(ta, UDS_MAX_BLOCK);
 			break;
-		case 0x36: /* TransferData */
+#ifdef UDS_UPTANE
+		case 0x38: /* RequestFileTransfer */
+			if(!uds_in_programming) {
+				send_uds_error(ta, 0x38, 0x70); /* Not accepted */
+				break;
+			}
+
 			session_ts = time_get();
 
-			if(!uds_in_download) {
-				send_uds_error(ta, 0x36, 0x24); /* Sequence Error */
+			if(message->size < 4) {
+				send_uds_error(ta, 0x38, 0x13); /* Invalid Format */
 				break;
 			}
-			if(message->size < 2) {
-				send_uds_error(ta, 0x36, 0x13); /* Invalid Format */
+			if(message->payload[1] != 0x01 && message->payload[1] != 0x03) { /* AddFile, ReplaceFile */
+				send_uds_error(ta, 0x38, 0x31); /* ROOR */
 				break;
 			}
-			if(message->payload[1] == uds_seq_number) { /* Repeated segment, acknowledge and ignore*/
-				send_uds_positive_transferdata(ta, uds_seq_number);
+			name_len = (message->payload[2] << 8) | message->payload[3];
+			i = 4 + name_len;
+			/* dataFormatIdentifier, fileSizeParameterLength and the sizes follow the name */
+			if(message->size < i+2) {
+				send_uds_error(ta, 0x38, 0x13); /* Invalid Format */
 				break;
-			} else if(message->payload[1] != (uint8_t) (uds_seq_number+1)) {
-				send_uds_error(ta, 0x36, 0x24); /* Sequence Error */
+			}
+
+			if(name_len == sizeof(UDS_FILE_ROOT)-1 && !memcmp(message->payload+4, UDS_FILE_ROOT, name_len))
+				file = TRANSFER_ROOT;
+			else if(name_len == sizeof(UDS_FILE_TARGETS)-1 && !memcmp(message->payload+4, UDS_FILE_TARGETS, name_len))
+				file = TRANSFER_TARGETS;
+			else
+				file = TRANSFER_IMAGE;
+			size_len = message->payload[i+1];
+			if(file == TRANSFER_IMAGE || message->payload[i] != 0x00 || size_len == 0 || size_len > 4) {
+				send_uds_error(ta, 0x38, 0x31); /* ROOR */
+				break;
+			}
+			if(message->size != i+2+2*size_len) {
+				send_uds_error(ta, 0x38, 0x13); /* Invalid Format */
 				break;
 			}
 
-			if(flash_load_curaddr +message->size - 2 > flash_load_startaddr+flash_load_size) {
-				send_uds_error(ta, 0x36, 0x31); /* ROOR */
+			/* fileSizeUncompressed, then fileSizeCompressed */
+			flash_size = 0;
+			for(i += 2; i < message->size-size_len; i++) {
+				flash_size <<= 8;
+				flash_size |= message->payload[i];
+			}
+			size_compressed = 0;
+			for(; i < message->size; i++) {
+				size_compressed <<= 8;
+				size_compressed |= message->payload[i];
+			}
+			if(size_compressed != flash_size || !metadata_stage_begin(flash_size)) {
+				send_uds_error(ta, 0x38, 0x31); /* ROOR */
 				break;
 			}
-			flash_load_continue(message->payload+2,message->size-2);
-			uds_seq_number = message->payload[1];
-			send_uds_positive_transferdata(ta, uds_seq_number);
+
+			image_verified = 0; /* checked against the targets there were */
+			uds_file = file;
+			file_size = flash_size;
+			file_fed = 0;
+			uds_seq_number = 0x00;
+			download_nrc = 0;
+			uds_in_download = 1;
+			/* for the CRC of RequestTransferExit */
+			flash_load_startaddr = METADATA_STAGE_BEGIN;
+			flash_load_size = flash_size;
+			send_uds_positive_reqfiletransfer(ta, message->payload[1], UDS_MAX_BLOCK);
+			break;
+#endif
+		case 0x36: /* TransferData */
+			session_ts = time_get();
+
+			if(!uds_in_download) {
+				send_uds_error(ta, 0x36, 0x24); /* Sequence Error */
+				break;
+			}
+			if(message->size < 2) {
+				send_uds_error(ta, 0x36, 0x13); /* Invalid Format */
+				break;
+			}
+			transfer_begin(message->payload[1], message->size-2);
+			transfer_data(message->payload+2, message->size-2);
+			transfer_end(ta, UDS_MULTICAST(message->arbitration_id));
 			break;
 
 		case 0x37: /* RequestTransferExit */
@@ -206,9 +689,23 @@ void message_received(const IsoTpMessage* message) {
 				send_uds_error(ta, 0x37, 0x24); /* Sequence Error */
 				break;
 			}
-			flash_load_finalize();
 			uds_in_download = 0;
-			send_uds_positive_transferexit(ta);
+			if(download_nrc) {
+				send_uds_error(ta, 0x37, download_nrc);
+				break;
+			}
+#ifdef UDS_UPTANE
+			if(uds_file != TRANSFER_IMAGE) {
+				metadata_stage_finalize_begin(); /* the step fails if the file isn't complete */
+				job_start(ta, 0x37, file_exit_step);
+			} else {
+				flash_install_finalize_begin();
+				job_start(ta, 0x37, install_exit_step);
+			}
+#else
+			flash_load_finalize_begin();
+			job_start(ta, 0x37, transferexit_step);
+#endif
 			break;
 
 		case 0x22: /* ReadDataByIdentifier */
@@ -223,14 +720,32 @@ void message_received(const IsoTpMessage* message) {
 				break;
 			}
 
-			switch((message->payload[1] << 8) | (message->payload[2])) {
+			did = (message->payload[1] << 8) | message->payload[2];
+			switch(did) {
 				case HW_ID_DID:
 					send_uds_positive_readdata(ta, HW_ID_DID, (const uint8_t* )UPTANE_HARDWARE_ID, strlen(UPTANE_HARDWARE_ID));
 					break;
 				case ECU_SERIAL_DID:
 					send_uds_positive_readdata(ta, ECU_SERIAL_DID, (const uint8_t*) UPTANE_ECU_SERIAL, strlen(UPTANE_ECU_SERIAL));
 					break;
+				case ISOTP_ALLOC_DID:
+					isotp_allocate_stats(&alloc_stats);
+					send_uds_positive_readdata(ta, ISOTP_ALLOC_DID, (const uint8_t*) &alloc_stats, sizeof(alloc_stats));
+					break;
+#ifdef UPTANE_TRACE
+				case TRACE_RING_DID:
+					if(!send_uds_positive_readdata(ta, TRACE_RING_DID, (const uint8_t*) trace_ring(), sizeof(struct trace_ring)))
+						send_uds_error(ta, 0x22, 0x14); /* Response too long */
+					break;
+#endif
 				default:
+#ifdef UPTANE_TRACE
+					if(did >= TRACE_STATS_DID && did < TRACE_STATS_DID + TRACE_PROBES) {
+						send_uds_positive_readdata(ta, did, (const uint8_t*) trace_stats(did - TRACE_STATS_DID),
+								sizeof(struct trace_stats));
+						break;
+					}
+#endif
 					send_uds_error(ta, 0x22, 0x31); /* ROOR */
 					break;
 			}
@@ -240,29 +755,27 @@ void message_received(const IsoTpMessage* message) {
 			break;
 
 	}
+	TRACE_END(TRACE_UDS_SERVICE, message->payload[0]);
 }
 
 void main(void) {
   int i;
-  struct can_filter can_filters[2];
+  struct can_filter can_routes[UDS_MAX_ROUTES];
 
   IsoTpShims isotp_shims;
 
   time_init();
+  clock_init();
   led_init();
   flash_init();
   
   script_init();
+#ifdef UDS_UPTANE
+  state_init();
+  uptane_set_verify_yield(job_pending);
+#endif
 
-  can_filters[0].filter = 0xffffffe0 | CAN_ID;
-  can_filters[0].mask = 0xffffffe0;
-  can_filters[0].ext = 0;
-
-  can_filters[1].filter = 0xffffffe0 | CAN_ID;
-  can_filters[1].mask = 0xffffffe0;
-  can_filters[1].ext = 0;
-
-  can_init(125000, can_filters);
+  can_init_routes(CAN_BAUD, can_routes, uds_routes(can_routes, UDS_MAX_ROUTES));
 
   __enable_irq();
 
@@ -277,19 +790,38 @@ void main(void) {
   isotp_shims = isotp_init_shims(NULL, send_can_isotp, NULL, NULL);
 
   isotp_dispatch_init(message_received, NULL, isotp_shims);
+  isotp_dispatch_stream(stream_start, stream_data, stream_end);
   for(;;) {
+	uint32_t idle = SCRIPT_IDLE; /* ms until there is something to do */
+
 	if(uds_in_programming) {
 		/* TODO: figure out real timeout (S3) */
 		if(time_passed(session_ts) > 60000) {
 			uds_in_download = 0;
 			uds_in_programming = 0;
+			link_revert();
 		}
 	}
 	
-	if(!uds_in_programming) {
-		script_execute();
-	}
+#ifdef FLASH_DUAL_BANK
+	idle = script_execute();
+#else
+	if(uds_in_programming)
+		script_reload(); /* the image may be programmed over it */
+	else
+		idle = script_execute();
+#endif
 
+	TRACE_BEGIN(TRACE_ISOTP_DISPATCH, 0);
 	isotp_dispatch();
+	TRACE_END(TRACE_ISOTP_DISPATCH, 0);
+	job_run();
+
+	/* Sleep until the next interrupt or the next step of the script. A frame that comes in after the check wakes
+	 * WFI up right away. Streams and the session timeout go by the systimer, a tick is enough for them. */
+	__disable_irq();
+	if(idle && !uds_job.active && !can_recv_pending())
+		time_sleep(isotp_dispatch_busy() ? 1 : idle);
+	__enable_irq();
   }
 }
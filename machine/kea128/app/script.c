@@ -1,3 +1,5 @@
+#include <stddef.h>
+
 #include "script.h"
 #include "systimer.h"
 #include "led.h"
@@ -11,76 +13,153 @@
 #define OP_WAIT  0x02
 #define OP_LOOP  0x03
 
-static uint32_t* script_addr = (uint32_t*) PROGRAM_FLASH_BEGIN;
+#define OP_CODE(op) (((op) >> 24) & 0xFF)
+#define OP_ARG(op) ((op) & 0xFFFFFF)
+
+/* The script is the magic number, the firmware version and the ops. It ends with an OP_LOOP, whose argument is the
+ * index of the op to go on with, or before the first word that isn't an op (the erased flash after it), which loops
+ * to the first op. */
+#define SCRIPT_HEADER_WORDS 2
+
+#ifdef FLASH_DUAL_BANK
+#define SCRIPT_BEGIN flash_bank_active()
+#define SCRIPT_END (flash_bank_active() + PROGRAM_BANK_SIZE)
+#else
+#define SCRIPT_BEGIN PROGRAM_FLASH_BEGIN
+#define SCRIPT_END PROGRAM_FLASH_END
+#endif
+
+static const uint32_t* script_ops; /* NULL if there is no valid script */
+static uint32_t script_len; /* ops up to the end of the script */
+static uint32_t script_pc;
+static uint32_t script_due; /* systimer deadline of the op at script_pc */
+static uint32_t script_base; /* SCRIPT_BEGIN the script was validated at */
+static int script_stale = 1;
+
+/* Checks the script at begin and returns the number of its ops, 0 if it isn't valid. Every loop has to go through a
+ * wait of at least a millisecond, so that script_execute() always gets to one. */
+static uint32_t script_validate(uint32_t begin, uint32_t end)
+{
+	const uint32_t* ops = (const uint32_t*) begin + SCRIPT_HEADER_WORDS;
+	uint32_t max = (end - begin) / sizeof(uint32_t) - SCRIPT_HEADER_WORDS;
+	int32_t last_wait = -1; /* index of the last wait that takes time */
+	uint32_t n;
+
+	if(*(const uint32_t*) begin != SCRIPT_MAGIC)
+		return 0;
+
+	for(n = 0; n < max; n++) {
+		switch(OP_CODE(ops[n])) {
+			case OP_LEDS:
+			case OP_LAMPS:
+				break;
+
+			case OP_WAIT:
+				if(OP_ARG(ops[n]) != 0)
+					last_wait = (int32_t) n;
+				break;
+
+			case OP_LOOP:
+				if(OP_ARG(ops[n]) > n || last_wait < (int32_t) OP_ARG(ops[n]))
+					return 0;
+				return n + 1;
+
+			default:
+				return (last_wait >= 0) ? n : 0;
+		}
+	}
+	return (last_wait >= 0) ? n : 0;
+}
+
+int script_present(uint32_t addr)
+{
+#ifdef FLASH_DUAL_BANK
+	return script_validate(addr, addr + PROGRAM_BANK_SIZE) != 0;
+#else
+	return script_validate(addr, PROGRAM_FLASH_END) != 0;
+#endif
+}
 
-void script_execute(void)
+static void script_load(void)
+{
+	script_base = SCRIPT_BEGIN;
+	script_len = script_validate(script_base, SCRIPT_END);
+	script_ops = script_len ? (const uint32_t*) script_base + SCRIPT_HEADER_WORDS : NULL;
+	script_pc = 0;
+	script_due = time_get();
+	script_stale = 0;
+}
+
+void script_reload(void)
+{
+	script_stale = 1;
+}
+
+uint32_t script_execute(void)
 {
 	uint32_t op;
-	static uint32_t ts = 0;
-	static uint32_t delay = 0;
-	static int in_wait = 0;
+	uint32_t delay;
+	int32_t left;
 	uint8_t leds;
 	int i;
 
-	if((uint32_t) script_addr < PROGRAM_FLASH_BEGIN || (uint32_t) script_addr >= PROGRAM_FLASH_END)
-		script_addr = (uint32_t*) PROGRAM_FLASH_BEGIN;
-	op = *script_addr;
+	/* also restarts the script when another bank is activated */
+	if(script_stale || script_base != SCRIPT_BEGIN)
+		script_load();
+	if(!script_ops)
+		return SCRIPT_IDLE;
 
-	if((uint32_t) script_addr == PROGRAM_FLASH_BEGIN) {
-		if(op != SCRIPT_MAGIC) {
-			return;
-		}
-		else {
-			script_addr += 2; // skip magic number and firmware version
-			op = *script_addr;
-		}
-	}
+	left = time_until(script_due);
+	if(left > 0)
+		return (uint32_t) left;
 
-	if (in_wait) {
-		if(time_passed(ts) > delay)
-			in_wait = 0;
-		else
-			return;
-	}
+	/* validation guarantees a wait before the script comes back to an op */
+	for(;;) {
+		op = script_ops[script_pc++];
+		if(script_pc >= script_len)
+			script_pc = 0;
 
-	switch((op >> 24) & 0xFF) {
-		case OP_LEDS:
-			leds = op & 0x0F;
-			for(i = 0; i < 4; i++) {
-				led_set(i, leds & 1);
-				leds >>= 1;
-			}
-			break;
-
-		case OP_LAMPS:
-			// no brightness regulation yet
-			leds = op & 0x0F;
-			for(i = 0; i < 4; i++) {
-				headlight_set(i, leds & 1);
-				leds >>= 1;
-			}
-			break;
-
-		case OP_WAIT:
-			in_wait = 1;
-			ts = time_get();
-			delay = op & 0xFFFFFF;
-			break;
-
-		case OP_LOOP:
-			// will be incremented after switch
-			script_addr = (uint32_t*) PROGRAM_FLASH_BEGIN;
-			break;
-		default:
-			break;
-	}
+		switch(OP_CODE(op)) {
+			case OP_LEDS:
+				leds = op & 0x0F;
+				for(i = 0; i < 4; i++) {
+					led_set(i, leds & 1);
+					leds >>= 1;
+				}
+				break;
+
+			case OP_LAMPS:
+				// no brightness regulation yet
+				leds = op & 0x0F;
+				for(i = 0; i < 4; i++) {
+					headlight_set(i, leds & 1);
+					leds >>= 1;
+				}
+				break;
 
-	script_addr++;
+			case OP_WAIT:
+				delay = OP_ARG(op);
+				if(delay == 0)
+					break;
+				/* from the deadline rather than from now, so that late steps don't add up. After falling behind by
+				 * more than the wait, start over from now instead of catching up. */
+				script_due += delay;
+				left = time_until(script_due);
+				if(left <= 0) {
+					script_due = time_get() + delay;
+					left = (int32_t) delay;
+				}
+				return (uint32_t) left;
+
+			case OP_LOOP:
+				script_pc = OP_ARG(op);
+				break;
+		}
+	}
 }
 
 void script_init(void)
 {
 	headlight_init();
-	script_addr = (uint32_t*) PROGRAM_FLASH_BEGIN;
+	script_reload();
 }
-
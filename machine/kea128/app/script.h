@@ -1,7 +1,17 @@
 #ifndef ATS_MS1_SCRIPT_H
 #define ATS_MS1_SCRIPT_H
 
+#include <stdint.h>
+
 void script_init(void);
-void script_execute(void);
+/* Runs the ops of the script that are due, up to the next wait. Returns the milliseconds until the script goes on,
+ * SCRIPT_IDLE if there is no valid script. The script is validated on the first call and again after
+ * script_reload() or the activation of another bank. */
+#define SCRIPT_IDLE 0xFFFFFFFF
+uint32_t script_execute(void);
+/* The script is validated again and starts over, for after it was programmed in place */
+void script_reload(void);
+/* Whether a valid script starts at addr */
+int script_present(uint32_t addr);
 
 #endif /* ATS_MS1_SCRIPT_H */
@@ -0,0 +1,360 @@
+#include "state_log.h"
+#include "crc32.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* flash_start_address is 0 on real device, but can be overriden for testing*/
+extern uint32_t flash_start_address;
+
+#define PHRASES(len) (((len) + FLASH_PHRASE_SIZE - 1) & ~(uint32_t)(FLASH_PHRASE_SIZE - 1))
+#define RECORD_SIZE(len) (sizeof(struct state_record) + PHRASES(len))
+
+static uint32_t log_area; /* the area in use, 0 before the first record */
+static uint32_t log_sequence;
+static uint32_t log_end; /* where the next record goes */
+static const struct state_record* latest[STATE_RECORD_TYPES];
+
+static uptane_root_t stored_root;
+
+static const void* flash_ptr(uint32_t addr) {
+	return (const void*) (addr + flash_start_address);
+}
+
+static const void* record_data(const struct state_record* rec) {
+	return rec + 1;
+}
+
+/* Pieces of the data of a record, the root is written from its keys where they are */
+struct piece {
+	const void* data;
+	uint32_t len;
+};
+
+static uint32_t record_crc(const struct state_record* rec, const struct piece* pieces, int num) {
+	uint32_t crc = uptane_crc32(0, (const uint8_t*) rec, offsetof(struct state_record, crc));
+	int i;
+
+	for(i = 0; i < num; i++)
+		crc = uptane_crc32(crc, pieces[i].data, pieces[i].len);
+	return crc;
+}
+
+/* Programs data of any length as whole phrases, the last one padded with 0xFF */
+struct phrase_writer {
+	uint32_t addr;
+	uint8_t phrase[FLASH_PHRASE_SIZE];
+	uint32_t fill;
+	int ok;
+};
+
+static void writer_put(struct phrase_writer* w, const uint8_t* data, uint32_t len) {
+	while(len) {
+		uint32_t n;
+
+		if(!w->fill && len >= FLASH_PHRASE_SIZE) {
+			n = len & ~(uint32_t)(FLASH_PHRASE_SIZE - 1);
+			w->ok = w->ok && flash_program(w->addr, data, n);
+			w->addr += n;
+		} else {
+			n = (len < FLASH_PHRASE_SIZE - w->fill) ? len : FLASH_PHRASE_SIZE - w->fill;
+			memcpy(w->phrase + w->fill, data, n);
+			w->fill += n;
+			if(w->fill == FLASH_PHRASE_SIZE) {
+				w->ok = w->ok && flash_program(w->addr, w->phrase, FLASH_PHRASE_SIZE);
+				w->addr += FLASH_PHRASE_SIZE;
+				w->fill = 0;
+			}
+		}
+		data += n;
+		len -= n;
+	}
+}
+
+static int writer_flush(struct phrase_writer* w) {
+	if(w->fill) {
+		memset(w->phrase + w->fill, 0xFF, FLASH_PHRASE_SIZE - w->fill);
+		w->ok = w->ok && flash_program(w->addr, w->phrase, FLASH_PHRASE_SIZE);
+	}
+	return w->ok;
+}
+
+/* The header goes first, a record cut off after it is stepped over by its length and dropped by its CRC */
+static int record_program(uint32_t addr, uint8_t type, const struct piece* pieces, int num) {
+	struct phrase_writer w;
+	struct state_record rec;
+	int i;
+
+	rec.type = type;
+	rec.reserved = 0xFF;
+	rec.len = 0;
+	for(i = 0; i < num; i++)
+		rec.len += pieces[i].len;
+	rec.crc = record_crc(&rec, pieces, num);
+
+	w.addr = addr;
+	w.fill = 0;
+	w.ok = 1;
+	writer_put(&w, (const uint8_t*) &rec, sizeof(rec));
+	for(i = 0; i < num; i++)
+		writer_put(&w, pieces[i].data, pieces[i].len);
+	if(!writer_flush(&w))
+		return 0;
+
+	/* read back */
+	{
+		const struct state_record* stored = flash_ptr(addr);
+		struct piece data = {record_data(stored), stored->len};
+
+		return !memcmp(stored, &rec, sizeof(rec)) && record_crc(stored, &data, 1) == rec.crc;
+	}
+}
+
+static int area_valid(uint32_t area) {
+	const struct state_area* header = flash_ptr(area);
+
+	return header->magic == STATE_AREA_MAGIC;
+}
+
+/* Records of the area from the first one on, the latest valid one of each type wins */
+static void log_scan(void) {
+	uint32_t end = log_area + STATE_LOG_AREA_SIZE;
+	uint32_t pos = log_area + sizeof(struct state_area);
+
+	memset(latest, 0, sizeof(latest));
+	while(pos + sizeof(struct state_record) <= end) {
+		const struct state_record* rec = flash_ptr(pos);
+		struct piece data = {record_data(rec), rec->len};
+
+		if(rec->type == 0xFF && rec->reserved == 0xFF && rec->len == 0xFFFF && rec->crc == 0xFFFFFFFF)
+			break; /* blank, the next record goes here */
+		if(RECORD_SIZE(rec->len) > end - pos) {
+			pos = end; /* a broken header, the next record goes to the other area */
+			break;
+		}
+		if(rec->type < STATE_RECORD_TYPES && record_crc(rec, &data, 1) == rec->crc)
+			latest[rec->type] = rec;
+		pos += RECORD_SIZE(rec->len);
+	}
+	log_end = pos;
+}
+
+/* Copies the latest records to the other area, with type replaced by pieces. The records are in place before the
+ * area header makes them the log, until then the old area stays in use. */
+static int log_compact(uint8_t type, const struct piece* pieces, int num) {
+	uint32_t area = (log_area == STATE_LOG_BEGIN) ? STATE_LOG_BEGIN + STATE_LOG_AREA_SIZE : STATE_LOG_BEGIN;
+	uint32_t pos = area + sizeof(struct state_area);
+	const struct state_record* moved[STATE_RECORD_TYPES];
+	struct state_area header;
+	uint32_t addr;
+	uint32_t len = 0;
+	uint32_t size;
+	int i;
+
+	for(addr = area; addr < area + STATE_LOG_AREA_SIZE; addr += FLASH_SECTOR_SIZE)
+		if(!flash_erase_sector(addr))
+			return 0;
+
+	for(i = 0; i < num; i++)
+		len += pieces[i].len;
+
+	for(i = 0; i < STATE_RECORD_TYPES; i++) {
+		const struct state_record* rec = latest[i];
+		struct piece data;
+
+		moved[i] = NULL;
+		if(i == type) {
+			if(!len)
+				continue; /* removed */
+			if(pos + RECORD_SIZE(len) > area + STATE_LOG_AREA_SIZE || !record_program(pos, i, pieces, num))
+				return 0;
+			size = RECORD_SIZE(len);
+		} else {
+			if(!rec || !rec->len)
+				continue;
+			data.data = record_data(rec);
+			data.len = rec->len;
+			if(pos + RECORD_SIZE(rec->len) > area + STATE_LOG_AREA_SIZE || !record_program(pos, i, &data, 1))
+				return 0;
+			size = RECORD_SIZE(rec->len);
+		}
+		moved[i] = flash_ptr(pos);
+		pos += size;
+	}
+
+	header.magic = STATE_AREA_MAGIC;
+	header.sequence = log_sequence + 1;
+	if(!flash_program(area, (const uint8_t*) &header, sizeof(header)))
+		return 0;
+
+	log_area = area;
+	log_sequence = header.sequence;
+	log_end = pos;
+	memcpy(latest, moved, sizeof(latest));
+	return 1;
+}
+
+static int log_append(uint8_t type, const struct piece* pieces, int num) {
+	uint32_t len = 0;
+	int i;
+
+	for(i = 0; i < num; i++)
+		len += pieces[i].len;
+
+	if(log_area && log_end + RECORD_SIZE(len) <= log_area + STATE_LOG_AREA_SIZE) {
+		if(record_program(log_end, type, pieces, num)) {
+			latest[type] = flash_ptr(log_end);
+			log_end += RECORD_SIZE(len);
+			return 1;
+		}
+		log_end = log_area + STATE_LOG_AREA_SIZE; /* a failed record is not written over */
+	}
+	return log_compact(type, pieces, num);
+}
+
+static void root_load(void) {
+	const struct state_record* rec = latest[STATE_RECORD_ROOT];
+	const struct state_stored_root* root;
+	const crypto_key_t* keys;
+	int i;
+
+	if(!rec) {
+		memcpy(&stored_root, &state_provisioned_root, sizeof(stored_root));
+		return;
+	}
+
+	root = record_data(rec);
+	keys = (const crypto_key_t*) (root + 1);
+	stored_root.version = root->version;
+	stored_root.expires = root->expires;
+	stored_root.root_threshold = root->root_threshold;
+	stored_root.root_keys_num = root->root_keys_num;
+	stored_root.targets_threshold = root->targets_threshold;
+	stored_root.targets_keys_num = root->targets_keys_num;
+	/* The keys are used in place, they were prepared when the root was stored */
+	for(i = 0; i < root->root_keys_num; i++)
+		stored_root.root_keys[i] = (crypto_key_t*) &keys[i];
+	for(i = 0; i < root->targets_keys_num; i++)
+		stored_root.targets_keys[i] = (crypto_key_t*) &keys[root->root_keys_num + i];
+}
+
+void state_init(void) {
+	const struct state_area* a = flash_ptr(STATE_LOG_BEGIN);
+	const struct state_area* b = flash_ptr(STATE_LOG_BEGIN + STATE_LOG_AREA_SIZE);
+
+	log_area = 0;
+	log_sequence = 0;
+	if(area_valid(STATE_LOG_BEGIN))
+		log_area = STATE_LOG_BEGIN;
+	if(area_valid(STATE_LOG_BEGIN + STATE_LOG_AREA_SIZE) && (!log_area || b->sequence > a->sequence))
+		log_area = STATE_LOG_BEGIN + STATE_LOG_AREA_SIZE;
+
+	if(log_area) {
+		log_sequence = ((const struct state_area*) flash_ptr(log_area))->sequence;
+		log_scan();
+	} else {
+		memset(latest, 0, sizeof(latest));
+	}
+	root_load();
+}
+
+uptane_root_t* state_get_root(void) { return &stored_root; }
+
+void state_set_root(const uptane_root_t* root) {
+	struct piece pieces[1 + 2*ROOT_MAX_KEYS];
+	struct state_stored_root head;
+	int num = 0;
+	int i;
+
+	memset(&head, 0, sizeof(head));
+	head.version = root->version;
+	head.expires = root->expires;
+	head.root_threshold = root->root_threshold;
+	head.targets_threshold = root->targets_threshold;
+	head.root_keys_num = root->root_keys_num;
+	head.targets_keys_num = root->targets_keys_num;
+	pieces[num].data = &head;
+	pieces[num++].len = sizeof(head);
+	for(i = 0; i < root->root_keys_num; i++) {
+		pieces[num].data = root->root_keys[i];
+		pieces[num++].len = sizeof(crypto_key_t);
+	}
+	for(i = 0; i < root->targets_keys_num; i++) {
+		pieces[num].data = root->targets_keys[i];
+		pieces[num++].len = sizeof(crypto_key_t);
+	}
+
+	/* Not stored, the old root stays */
+	if(log_append(STATE_RECORD_ROOT, pieces, num))
+		root_load();
+}
+
+/* The state read from flash as it is, NULL if there is no record */
+static const void* latest_data(int type) {
+	const struct state_record* rec = latest[type];
+
+	return (rec && rec->len) ? record_data(rec) : NULL;
+}
+
+uptane_targets_t* state_get_targets(void) {
+	static uptane_targets_t none;
+	const uptane_targets_t* targets = latest_data(STATE_RECORD_TARGETS);
+
+	return targets ? (uptane_targets_t*) targets : &none;
+}
+
+void state_set_targets(const uptane_targets_t* targets) {
+	struct piece data = {targets, sizeof(*targets)};
+
+	log_append(STATE_RECORD_TARGETS, &data, 1);
+}
+
+uptane_installation_state_t* state_get_installation_state(void) {
+	return (uptane_installation_state_t*) latest_data(STATE_RECORD_INSTALLATION);
+}
+
+void state_set_installation_state(const uptane_installation_state_t* state) {
+	struct piece data = {state, sizeof(*state)};
+
+	log_append(STATE_RECORD_INSTALLATION, &data, 1);
+}
+
+void state_set_attack(uptane_attack_t attack) {
+	const uptane_installation_state_t* current = state_get_installation_state();
+	uptane_installation_state_t state;
+
+	if(current)
+		memcpy(&state, current, sizeof(state));
+	else
+		memset(&state, 0, sizeof(state));
+	state.attack = attack;
+	state_set_installation_state(&state);
+}
+
+const uptane_transfer_checkpoint_t* state_get_transfer_checkpoint(void) {
+	return latest_data(STATE_RECORD_CHECKPOINT);
+}
+
+void state_set_transfer_checkpoint(const uptane_transfer_checkpoint_t* checkpoint) {
+	struct piece data = {checkpoint, checkpoint ? sizeof(*checkpoint) : 0};
+
+	if(!checkpoint && !state_get_transfer_checkpoint())
+		return;
+	log_append(STATE_RECORD_CHECKPOINT, &data, 1);
+}
+
+const char* state_get_ecuid(void) { return UPTANE_ECU_SERIAL; }
+
+size_t state_get_ecuid_len(void) { return sizeof(UPTANE_ECU_SERIAL) - 1; }
+
+const char* state_get_hwid(void) { return UPTANE_HARDWARE_ID; }
+
+size_t state_get_hwid_len(void) { return sizeof(UPTANE_HARDWARE_ID) - 1; }
+
+void state_get_device_key(const crypto_key_t** pub, const uint8_t** priv) {
+	*pub = &state_device_public_key;
+	*priv = state_device_private_key;
+}
+
+/* SHA-256 is about twice as fast as SHA-512 on a 32-bit core */
+crypto_hash_algorithm_t state_get_supported_hash(void) { return CRYPTO_HASH_SHA256; }
@@ -0,0 +1,57 @@
+#ifndef ATS_BOOT_STATE_LOG_H
+#define ATS_BOOT_STATE_LOG_H
+
+#include <stdint.h>
+#include "flash.h"
+#include "flash_load.h"
+#include "state_api.h"
+
+/* The state API of libuptiny on flash. The root, the targets, the installation state and the transfer checkpoint are
+ * records appended to a log in one of two areas, the latest valid record of a kind is the current one. An update
+ * programs a record, only when the area is full the latest records are copied to the other area, which is erased for
+ * that. The areas are at the top of the bootloader's flash, below the program. */
+#ifndef STATE_LOG_AREA_SIZE
+#define STATE_LOG_AREA_SIZE (4*FLASH_SECTOR_SIZE)
+#endif
+#define STATE_LOG_BEGIN (PROGRAM_FLASH_BEGIN - 2*STATE_LOG_AREA_SIZE)
+
+#define STATE_AREA_MAGIC 0x5354A7E0
+
+/* First phrase of an area, programmed once the records copied there are in place. The valid one with the higher
+ * sequence number is the log. */
+struct state_area {
+	uint32_t magic;
+	uint32_t sequence;
+};
+
+#define STATE_RECORD_ROOT 0
+#define STATE_RECORD_TARGETS 1
+#define STATE_RECORD_INSTALLATION 2
+#define STATE_RECORD_CHECKPOINT 3 /* without data if there is none */
+#define STATE_RECORD_TYPES 4
+
+/* Header of a record, its data follows padded to a phrase */
+struct state_record {
+	uint8_t type;
+	uint8_t reserved; /* 0xFF */
+	uint16_t len; /* of the data */
+	uint32_t crc; /* CRC-32 of the four bytes above and the data */
+};
+
+/* Data of a root record, followed by the root keys and the targets keys as crypto_key_t, which the root points to */
+struct state_stored_root {
+	int32_t version;
+	uptane_time_t expires;
+	int32_t root_threshold;
+	int32_t targets_threshold;
+	uint8_t root_keys_num;
+	uint8_t targets_keys_num;
+	uint16_t reserved;
+};
+
+/* Provisioned by the board: the root trusted until one is stored and the key of the device */
+extern const uptane_root_t state_provisioned_root;
+extern const crypto_key_t state_device_public_key;
+extern const uint8_t state_device_private_key[];
+
+#endif /* ATS_BOOT_STATE_LOG_H */
@@ -0,0 +1,50 @@
+#include "trace_ring.h"
+#include "systimer.h"
+
+#include <stddef.h>
+
+#ifdef UPTANE_TRACE
+
+static struct trace_ring ring;
+static struct trace_stats stats[TRACE_PROBES];
+static uint32_t begin_us[TRACE_PROBES];
+
+void uptane_trace(uint8_t probe, uint8_t end, uint8_t arg) {
+	uint32_t now = time_get_us();
+	struct trace_record* rec = &ring.rec[ring.next];
+	uint32_t d;
+	int i;
+
+	rec->ts = now;
+	rec->probe = probe;
+	rec->end = end;
+	rec->arg = arg;
+	if(++ring.next == TRACE_RING_SIZE)
+		ring.next = 0;
+	if(ring.count < TRACE_RING_SIZE)
+		ring.count++;
+
+	if(probe >= TRACE_PROBES)
+		return;
+	if(!end) {
+		begin_us[probe] = now;
+		return;
+	}
+
+	d = now - begin_us[probe];
+	if(d > stats[probe].max_us)
+		stats[probe].max_us = d;
+	for(i = 0; i < TRACE_BUCKETS - 1 && (d >> (i + 1)); i++);
+	if(stats[probe].hist[i] != 0xFFFF)
+		stats[probe].hist[i]++;
+}
+
+const struct trace_ring* trace_ring(void) {
+	return &ring;
+}
+
+const struct trace_stats* trace_stats(uint8_t probe) {
+	return (probe < TRACE_PROBES) ? &stats[probe] : NULL;
+}
+
+#endif /* UPTANE_TRACE */
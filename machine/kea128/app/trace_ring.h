@@ -0,0 +1,39 @@
+#ifndef ATS_BOOT_TRACE_RING_H
+#define ATS_BOOT_TRACE_RING_H
+
+#include <stdint.h>
+#include "trace.h"
+
+/* The probes of libuptiny/trace.h go to a ring of the last records and to histograms of their durations, both read
+ * out over ReadDataByIdentifier as they are in RAM, little endian. A ring fits one response of 127 bytes. */
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 14
+#endif
+#define TRACE_BUCKETS 16
+
+struct trace_record {
+	uint32_t ts; /* time_get_us() */
+	uint8_t probe;
+	uint8_t end;
+	uint8_t arg;
+	uint8_t reserved;
+};
+
+struct trace_ring {
+	uint8_t next; /* record written next, the oldest one once the ring is full */
+	uint8_t count;
+	uint16_t reserved;
+	struct trace_record rec[TRACE_RING_SIZE];
+};
+
+/* hist[i] counts the runs of 2^i to 2^(i+1) - 1 microseconds, the last bucket also the longer ones */
+struct trace_stats {
+	uint32_t max_us;
+	uint16_t hist[TRACE_BUCKETS];
+};
+
+const struct trace_ring* trace_ring(void);
+/* NULL if there is no such probe */
+const struct trace_stats* trace_stats(uint8_t probe);
+
+#endif /* ATS_BOOT_TRACE_RING_H */
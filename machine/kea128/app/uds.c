@@ -8,16 +8,57 @@
 
 static uint8_t payload[OUR_MAX_ISO_TP_MESSAGE_SIZE];
 
+static int add_route(struct can_filter* routes, int n, int max, uint32_t filter, uint32_t mask) {
+	if(n >= max)
+		return n;
+	routes[n].filter = filter;
+	routes[n].mask = mask;
+	routes[n].ext = 0;
+	return n + 1;
+}
+
+int uds_routes(struct can_filter* routes, int max) {
+	int n = 0;
+#ifdef UDS_TESTERS
+	static const uint8_t testers[] = {UDS_TESTERS};
+	unsigned int i;
+
+	for(i = 0; i < sizeof(testers); i++) {
+		n = add_route(routes, n, max, (testers[i] << 5) | CAN_ID, 0);
+#ifdef UDS_FUNCTIONAL_TA
+		n = add_route(routes, n, max, (testers[i] << 5) | UDS_FUNCTIONAL_TA, 0);
+#endif
+	}
+#else
+	n = add_route(routes, n, max, CAN_ID, 0x7E0);
+#ifdef UDS_FUNCTIONAL_TA
+	n = add_route(routes, n, max, UDS_FUNCTIONAL_TA, 0x7E0);
+#endif
+#endif
+	return n;
+}
+
 int send_can_isotp(uint32_t arbitration_id, const uint8_t* data, uint8_t size, void* private_data) {
 	(void) private_data;
         struct can_pack pack;
 
-        if(size > 8)
+        if(size > CAN_MAX_DATA_LEN)
                 return 0;
         pack.af = arbitration_id;
-        pack.dlc = size;
         memcpy(pack.data, data, size);
-        can_send(&pack);
+        /* our flow control, the block size stays 0 as isotp-c only sends one flow control per message */
+        if(size >= 3 && pack.data[0] == 0x30) {
+                pack.data[1] = 0;
+                pack.data[2] = ISOTP_RX_STMIN;
+        }
+        /* FD frames have no lengths in between, pad up to the next one */
+        pack.dlc = can_dlc_to_len(can_len_to_dlc(size));
+        memset(pack.data + size, 0xCC, pack.dlc - size);
+        /* single frames and our flow control overtake the consecutive frames of long messages */
+        if((pack.data[0] >> 4) == 0x0 || (pack.data[0] >> 4) == 0x3)
+                can_send_urgent(&pack);
+        else
+                can_send(&pack);
         return 1;
 }
 
@@ -38,6 +79,19 @@ int send_uds_positive_routinecontrol(uint16_t sa, uint8_t op, uint16_t id) {
 	return isotp_dispatch_send(payload, 4, (CAN_ID << 5) | sa);
 }
 
+int send_uds_positive_routinecontrol_status(uint16_t sa, uint8_t op, uint16_t id, const uint8_t* status, uint16_t size) {
+	if(size+4 > OUR_MAX_ISO_TP_MESSAGE_SIZE)
+		return 0;
+
+	payload[0] = 0x31 | 0x40; /* RoutineControl */
+	payload[1] = op;
+	payload[2] = id >> 8;
+	payload[3] = id & 0xFF;
+	memcpy(payload+4, status, size); /* routineStatusRecord */
+
+	return isotp_dispatch_send(payload, size+4, (CAN_ID << 5) | sa);
+}
+
 int send_uds_positive_sessioncontrol(uint16_t sa, uint8_t type) {
 	payload[0] = 0x10 | 0x40; /* SessionControl */
 	payload[1] = type;
@@ -60,6 +114,13 @@ int send_uds_positive_ecureset(uint16_t sa, uint8_t rtype) {
 	return isotp_dispatch_send(payload, 3, (CAN_ID << 5) | sa);
 }
 
+int send_uds_positive_linkcontrol(uint16_t sa, uint8_t type) {
+	payload[0] = 0x87 | 0x40; /* LinkControl */
+	payload[1] = type;
+
+	return isotp_dispatch_send(payload, 2, (CAN_ID << 5) | sa);
+}
+
 int send_uds_positive_reqdownload(uint16_t sa, uint16_t maxblock) {
 	payload[0] = 0x34 | 0x40; /* RequestDownload */
 	payload[1] = 0x20; /* 2 bytes for maximum block size */
@@ -69,6 +130,17 @@ int send_uds_positive_reqdownload(uint16_t sa, uint16_t maxblock) {
 	return isotp_dispatch_send(payload, 4, (CAN_ID << 5) | sa);
 }
 
+int send_uds_positive_reqfiletransfer(uint16_t sa, uint8_t mode, uint16_t maxblock) {
+	payload[0] = 0x38 | 0x40; /* RequestFileTransfer */
+	payload[1] = mode;
+	payload[2] = 0x02; /* 2 bytes for maximum block size */
+	payload[3] = maxblock >> 8;
+	payload[4] = maxblock & 0xFF;
+	payload[5] = 0x00; /* dataFormatIdentifier, neither compressed nor encrypted */
+
+	return isotp_dispatch_send(payload, 6, (CAN_ID << 5) | sa);
+}
+
 int send_uds_positive_transferdata(uint16_t sa, uint8_t seqn) {
 	payload[0] = 0x36 | 0x40; /* TransferData */
 	payload[1] = seqn;
@@ -76,10 +148,14 @@ int send_uds_positive_transferdata(uint16_t sa, uint8_t seqn) {
 	return isotp_dispatch_send(payload, 2, (CAN_ID << 5) | sa);
 }
 
-int send_uds_positive_transferexit(uint16_t sa) {
+int send_uds_positive_transferexit(uint16_t sa, uint32_t crc) {
 	payload[0] = 0x37 | 0x40; /* RequestTransferExit */
+	payload[1] = crc >> 24; /* transferResponseParameterRecord */
+	payload[2] = (crc >> 16) & 0xFF;
+	payload[3] = (crc >> 8) & 0xFF;
+	payload[4] = crc & 0xFF;
 
-	return isotp_dispatch_send(payload, 1, (CAN_ID << 5) | sa);
+	return isotp_dispatch_send(payload, 5, (CAN_ID << 5) | sa);
 }
 
 int send_uds_positive_readdata(uint16_t sa, uint16_t did, const uint8_t* data, uint16_t size) {
@@ -2,20 +2,63 @@
 #define ATS_BOOT_UDS_H
 
 #include <stdint.h>
+#include "can.h"
 
-#define UDS_MAX_BLOCK 64
+/* maxNumberOfBlockLength of TransferData, the largest ISO-TP message with a 12 bit length. Blocks are programmed
+ * while they are received and need no buffer of that size. */
+#define UDS_MAX_BLOCK 4095
+
+/* RequestDownload dataFormatIdentifier of heatshrink compressed data (libuptiny/decompress.h), memorySize is the
+ * decompressed size */
+#define UDS_COMPRESSION_HEATSHRINK 0x10
+
+/* With UDS_UPTANE, images are only programmed if the Uptane targets stored for this ECU have them, and the tester
+ * puts the metadata first with RequestFileTransfer (addFile or replaceFile) of these names. The file is staged in
+ * flash by TransferData and verified at RequestTransferExit, which fails if it isn't. */
+#define UDS_FILE_ROOT "root.json"
+#define UDS_FILE_TARGETS "targets.json"
+
+/* STmin we ask the tester for in our flow control frames. Frames are taken from the CAN queue as fast as they come
+ * in, the queue covers the programming of a sector. */
+#ifndef ISOTP_RX_STMIN
+#define ISOTP_RX_STMIN 0
+#endif
+
+/* Identifiers are (source address << 5) | target address, the tester's flow control comes on the one of its
+ * requests. UDS_TESTERS lists the source addresses of the testers served, e.g. -DUDS_TESTERS=0x01,0x1E, all of them
+ * if it is not defined. Requests to UDS_FUNCTIONAL_TA are taken too if it is defined. */
+#define UDS_MAX_ROUTES CAN_MAX_ROUTES
+
+/* Requests that take long are answered with responsePending (NRC 0x78) right away and again every
+ * UDS_PENDING_INTERVAL ms until their result is sent, within the P2* of 5 s */
+#ifndef UDS_PENDING_INTERVAL
+#define UDS_PENDING_INTERVAL 2000
+#endif
 
 #define HW_ID_DID 0x0001
 #define ECU_SERIAL_DID 0x0002
+/* With UPTANE_TRACE, see trace_ring.h. The histograms of the probes are TRACE_STATS_DID + probe. */
+#define TRACE_RING_DID 0x0003
+#define TRACE_STATS_DID 0x0010
+/* struct isotp_alloc_stats, see isotp_allocate.h */
+#define ISOTP_ALLOC_DID 0x0004
+
+/* The identifiers of the requests to us, for can_init_routes() */
+int uds_routes(struct can_filter* routes, int max);
 
 int send_can_isotp(uint32_t arbitration_id, const uint8_t* data, uint8_t size, void* private_data);
 int send_uds_error(uint16_t sa, uint8_t sid, uint8_t nrc);
 int send_uds_positive_routinecontrol(uint16_t sa, uint8_t op, uint16_t id);
+/* status is the routineStatusRecord */
+int send_uds_positive_routinecontrol_status(uint16_t sa, uint8_t op, uint16_t id, const uint8_t* status, uint16_t size);
 int send_uds_positive_sessioncontrol(uint16_t sa, uint8_t session);
 int send_uds_positive_ecureset(uint16_t sa, uint8_t rtype);
+int send_uds_positive_linkcontrol(uint16_t sa, uint8_t type);
 int send_uds_positive_reqdownload(uint16_t sa, uint16_t maxblock);
+int send_uds_positive_reqfiletransfer(uint16_t sa, uint8_t mode, uint16_t maxblock);
 int send_uds_positive_transferdata(uint16_t sa, uint8_t seqn);
-int send_uds_positive_transferexit(uint16_t sa);
+/* crc is the CRC-32 of the programmed range */
+int send_uds_positive_transferexit(uint16_t sa, uint32_t crc);
 int send_uds_positive_readdata(uint16_t sa, uint16_t did, const uint8_t* data, uint16_t size);
 
 #endif /* ATS_BOOT_UDS_H */
@@ -3,21 +3,81 @@
 
 #include <stdint.h>
 
+/* With CAN_FD frames carry up to 64 bytes. MSCAN of the KEA128 only sends and receives classic frames, the larger
+ * ones are for a controller with FD. */
+#ifdef CAN_FD
+#define CAN_MAX_DATA_LEN 64
+#else
+#define CAN_MAX_DATA_LEN 8
+#endif
+
 struct can_pack {
 	uint32_t af;
-	uint8_t dlc;
-	uint8_t data[8];
+	uint8_t dlc; /* number of data bytes, not the DLC code */
+	uint8_t data[CAN_MAX_DATA_LEN];
+};
+
+/* Counters of the driver since start */
+struct can_stats {
+	uint32_t rx_dropped; /* received while the ring was full */
+	uint32_t rx_overruns; /* lost by the controller before the interrupt took them */
+	uint32_t rx_filtered; /* let in by the acceptance filters but not on a route */
+	uint32_t tx_dropped; /* given to can_send() while the ring was full */
+	uint32_t rx_high_water; /* most frames ever waiting in the receiving ring */
+	uint32_t tx_high_water; /* most frames ever waiting in the sending ring */
+	uint32_t rx_direct; /* consecutive frames written straight into a buffer by can_direct_begin() */
 };
 
+/* Identifiers with the bits of filter where mask is 0, mask bits set are "don't care" */
 struct can_filter {
 	uint32_t filter;
 	uint32_t mask;
 	int ext;
 };
 
+#define CAN_MAX_ROUTES 12
+
 int can_init(uint32_t baud, struct can_filter acc_filter[2]);
+/* can_init() with the two acceptance filters taking the fewest identifiers on top of the n routes, the frames they
+ * let in that are not on a route are dropped by the RX interrupt */
+int can_init_routes(uint32_t baud, const struct can_filter* routes, int n);
+/* The acceptance filters of can_init_routes(), 0 if there are no or too many routes */
+int can_filters_derive(const struct can_filter* routes, int n, struct can_filter out[2]);
+/* Switches to another bitrate after the frames queued are sent, the filters, routes and received frames stay. 0 if
+ * the bus clock can't give baud exactly. */
+int can_set_baud(uint32_t baud);
 void can_send(const struct can_pack* pack);
+/* Sends pack before the frames can_send() has queued and not put on the bus yet */
+void can_send_urgent(const struct can_pack* pack);
 void can_flush_send();
+/* Number of frames can_send() can still queue */
+int can_send_free(void);
 int can_recv(struct can_pack* pack);
+/* Whether frames are waiting for can_recv() */
+int can_recv_pending(void);
+/* Runs handler on every frame received by now, returns their number. The frame stays valid until handler returns. */
+int can_recv_batch(void (*handler)(const struct can_pack* pack));
+void can_get_stats(struct can_stats* stats);
+
+/* Consecutive frames of one ISO-TP message are written by the RX interrupt straight from the data registers to their
+ * place in buf, they don't go through the ring. The frames from af have to come in order from sn on, the next one at
+ * offset received of a message of size bytes. Any other frame from af ends it, CAN_DIRECT_BROKEN, and goes to the
+ * ring, so does every frame from af after the message is complete, CAN_DIRECT_DONE. One message at a time, a new
+ * can_direct_begin() gives up the one before. */
+#define CAN_DIRECT_IDLE 0
+#define CAN_DIRECT_BUSY 1
+#define CAN_DIRECT_DONE 2
+#define CAN_DIRECT_BROKEN 3
+void can_direct_begin(uint32_t af, uint8_t* buf, uint16_t size, uint16_t received, uint8_t sn);
+/* State of the message, the bytes of it in buf by now in received. The frame that broke it is in the ring before BROKEN
+ * is seen. can_recv_pending() tells about DONE and BROKEN as well, until can_direct_end(). */
+int can_direct_state(uint16_t* received);
+/* Stops taking frames, buf is free again once it returns */
+void can_direct_end(void);
+
+/* Data length of a DLC code and the other way round. Above 8 bytes FD frames come in 12, 16, 20, 24, 32, 48 and 64,
+ * can_len_to_dlc() rounds up to those, the sender pads. */
+uint8_t can_dlc_to_len(uint8_t dlc);
+uint8_t can_len_to_dlc(uint8_t len);
 
 #endif
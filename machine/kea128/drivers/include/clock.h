@@ -0,0 +1,28 @@
+#ifndef ATS_DRIVERS_CLOCK_H
+#define ATS_DRIVERS_CLOCK_H
+
+#include <stdint.h>
+
+/* Core clock profiles. SystemInit() leaves the FLL at its maximum (40 MHz from the 8 MHz crystal) and the core on
+ * it. The profiles only move the divide by two between the core (OUTDIV1) and the bus (OUTDIV2) in one write of
+ * SIM_CLKDIV, so the FLL stays locked and the bus clock, and with it FCLKDIV of the flash and the MSCAN bit timing,
+ * is the same in both. SysTick counts core clocks and is rescaled, the systimer keeps its milliseconds.
+ *
+ * CLOCK_PROFILE_LOW: core and bus at 20 MHz, for normal operation.
+ * CLOCK_PROFILE_FULL: core at 40 MHz, bus at 20 MHz, for signatures and hashes. */
+typedef enum {
+	CLOCK_PROFILE_LOW,
+	CLOCK_PROFILE_FULL,
+} clock_profile_t;
+
+/* Call after time_init(), switches to CLOCK_PROFILE_LOW */
+void clock_init(void);
+void clock_set_profile(clock_profile_t profile);
+clock_profile_t clock_get_profile(void);
+uint32_t clock_bus_hz(void);
+
+/* CLOCK_PROFILE_FULL from the first clock_boost_begin() to the matching clock_boost_end(), they nest */
+void clock_boost_begin(void);
+void clock_boost_end(void);
+
+#endif /* ATS_DRIVERS_CLOCK_H */
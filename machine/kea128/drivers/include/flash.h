@@ -4,11 +4,27 @@
 #include <stdint.h>
 
 #define FLASH_SECTOR_SIZE 512
+#define FLASH_PHRASE_SIZE 8 /* the unit of programming */
 #define FLASH_SIZE 0x20000
 
 void flash_init(void);
 int flash_erase_sector(uint32_t addr);
 int flash_write_sector(uint32_t addr, const uint8_t* data);
+/* Programs an erased sector without erasing it first */
+int flash_program_sector(uint32_t addr, const uint8_t* data);
+/* Programs len bytes of erased flash, addr and len are multiples of FLASH_PHRASE_SIZE. data may be in flash. */
+int flash_program(uint32_t addr, const uint8_t* data, uint32_t len);
+
+/* Queued operations, run one after another from the FTMRE command complete interrupt. They return 0 if the address
+ * is wrong or the queue is full. cb is called from the interrupt, ok is 0 if the operation failed. Sector data must
+ * stay untouched until then. The synchronous calls above wait for the queue to drain first. */
+typedef void (*flash_callback_t)(int ok, void* arg);
+
+int flash_erase_sector_async(uint32_t addr, flash_callback_t cb, void* arg);
+int flash_write_sector_async(uint32_t addr, const uint8_t* data, flash_callback_t cb, void* arg);
+int flash_program_sector_async(uint32_t addr, const uint8_t* data, flash_callback_t cb, void* arg);
+int flash_busy(void);
+void flash_wait(void);
 
 #endif /* ATS_DRIVERS_FLASH_H */
 
@@ -8,7 +8,19 @@ extern volatile uint32_t SystemTime;
 static inline uint32_t time_get() {return SystemTime;}
 
 void time_init(void);
+/* Microseconds since start, wrapping around after 71 minutes */
+uint32_t time_get_us(void);
+/* Core clock cycles since start, as counted by SysTick, wrapping around after 2^32 of them. Differences of two
+ * readings are exact while no time_sleep() or change of the core clock runs in between. */
+uint32_t time_get_cycles(void);
 static inline uint32_t time_passed(uint32_t ts) { return SystemTime - ts; }
+/* Milliseconds until the deadline, 0 or less once it has come, for deadlines less than 24 days away */
+static inline int32_t time_until(uint32_t deadline) { return (int32_t)(deadline - SystemTime); }
 void time_delay(uint32_t ms);
+/* Sleeps with WFI until an interrupt comes or ms milliseconds have passed, no ticks wake it up in between. Call it
+ * with interrupts disabled (PRIMASK), the one that wakes it up is taken once they are enabled again. */
+void time_sleep(uint32_t ms);
+/* Rescales SysTick after SystemCoreClock changed, with interrupts disabled */
+void time_clock_changed(void);
 
 #endif
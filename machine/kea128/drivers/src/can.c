@@ -1,35 +1,104 @@
 #include "can.h"
 #include "SKEAZ1284.h"
+#include "clock.h"
 
-#define CAN_IN_BUF_SIZE 16
+/* Sizes of the rings, powers of two */
+#ifndef CAN_IN_BUF_SIZE
+#define CAN_IN_BUF_SIZE 32
+#endif
+#ifndef CAN_OUT_BUF_SIZE
 #define CAN_OUT_BUF_SIZE 16
-
-// divide cycle into 20 TQ (1 + 13 + 6)
-#define CAN_TSEG1 (13 - 1)
-#define CAN_TSEG2 (6 - 1)
-#define CAN_SJW (3 - 1)
-
-#define can_out_crit_beg() {NVIC_DisableIRQ(MSCAN_TX_IRQn);}
-#define can_out_crit_end() {NVIC_EnableIRQ(MSCAN_TX_IRQn);}
-#define can_in_crit_beg() {NVIC_DisableIRQ(MSCAN_RX_IRQn);}
-#define can_in_crit_end() {NVIC_EnableIRQ(MSCAN_RX_IRQn);}
+#endif
+#ifndef CAN_URGENT_BUF_SIZE
+#define CAN_URGENT_BUF_SIZE 4
+#endif
+#if (CAN_IN_BUF_SIZE & (CAN_IN_BUF_SIZE - 1)) || (CAN_OUT_BUF_SIZE & (CAN_OUT_BUF_SIZE - 1)) || \
+    (CAN_URGENT_BUF_SIZE & (CAN_URGENT_BUF_SIZE - 1))
+#error "CAN ring sizes must be powers of two"
+#endif
+
+/* A bit is divided into CAN_TQ_MAX down to CAN_TQ_MIN time quanta, the most that give baud exactly from the bus
+ * clock. TSEG2 is 30% of them, e.g. 20 TQ are 1 + 13 + 6. */
+#define CAN_TQ_MAX 25
+#define CAN_TQ_MIN 8
+#define CAN_TSEG1_MAX 16
+#define CAN_TSEG2_MAX 8
+#define CAN_SJW_MAX 4
 
 #define CAN_ID_ADDR 0x1FFFF
+
+/* Single producer, single consumer rings. The producer only writes head, the consumer only writes tail, both run
+ * freely and wrap by themselves, head - tail is the number of frames in the ring. The receiving one is filled by
+ * MSCAN_RX_IRQHandler(), the sending ones are emptied by MSCAN_TX_IRQHandler(), so no interrupts are masked. A frame is
+ * written before the head unveils it and read before the tail gives it back. */
 static struct {
 	struct can_pack buf[CAN_IN_BUF_SIZE];
-	int beg;
-	int end;
-	int len;
+	volatile unsigned int head;
+	volatile unsigned int tail;
 } can_in_buf;
 
+struct out_ring {
+	struct can_pack* buf;
+	unsigned int mask; /* size - 1 */
+	volatile unsigned int head;
+	volatile unsigned int tail;
+};
+
+static struct can_pack urgent_frames[CAN_URGENT_BUF_SIZE];
+static struct can_pack bulk_frames[CAN_OUT_BUF_SIZE];
+
+/* Urgent frames go before the bulk ones queued or loaded into the hardware but not on the bus yet */
+#define OUT_URGENT 0
+#define OUT_BULK 1
+static struct out_ring can_out_buf[2] = {
+	{urgent_frames, CAN_URGENT_BUF_SIZE - 1, 0, 0},
+	{bulk_frames, CAN_OUT_BUF_SIZE - 1, 0, 0},
+};
+
+/* The controller sends the loaded buffer with the lowest local priority (TBPR) first. Every ring has half of the
+ * range, a frame gets one more than the last one of its ring still loaded, so each ring stays in order. */
+#define PRIO_RANGE 0x80
+static uint8_t buf_prio[3];
+
+static volatile struct can_stats stats;
+
+/* The message of can_direct_begin(). The main loop only writes it while state isn't CAN_DIRECT_BUSY, the RX interrupt
+ * only while it is, and the data is in buf before received and state show it. */
 static struct {
-	struct can_pack buf[CAN_OUT_BUF_SIZE];
-	int beg;
-	int end;
-	int len;
-} can_out_buf;
+	volatile int state;
+	uint32_t af;
+	uint8_t* buf;
+	uint16_t size;
+	volatile uint16_t received;
+	uint8_t sn; /* sequence number of the next consecutive frame */
+} direct;
+
+/* Identifiers taken, checked in software after the acceptance filters that may let more in */
+static struct can_filter routes[CAN_MAX_ROUTES];
+static int routes_num;
+
+static void can_send_low(const struct can_pack* pack, uint8_t prio);
+
+#ifdef CAN_FD
+static const uint8_t dlc_len[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+#else
+/* codes above 8 mean 8 bytes in classic CAN */
+static const uint8_t dlc_len[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 8, 8, 8, 8, 8, 8};
+#endif
+
+uint8_t can_dlc_to_len(uint8_t dlc)
+{
+	return dlc_len[dlc & 0x0F];
+}
 
-static void can_send_low(const struct can_pack* pack);
+uint8_t can_len_to_dlc(uint8_t len)
+{
+	uint8_t dlc = 0;
+
+	while(dlc < 15 && dlc_len[dlc] < len)
+		dlc++;
+	return dlc;
+}
 
 // leaves only least significant set bit. Mostly used for CANTFLG
 static inline uint8_t least_set(uint8_t reg)
@@ -37,83 +106,370 @@ static inline uint8_t least_set(uint8_t reg)
 	return reg & (-reg);
 }
 
-static volatile int transmitting = 1;
+static int out_ring_empty(const struct out_ring* ring)
+{
+	return ring->head == ring->tail;
+}
 
 void can_flush_send() {
-	while(transmitting);
+	while(!out_ring_empty(&can_out_buf[OUT_URGENT]) || !out_ring_empty(&can_out_buf[OUT_BULK]) ||
+	      (MSCAN->CANTFLG & 0x07) != 0x07);
+}
+
+int can_send_free(void) {
+	return CAN_OUT_BUF_SIZE - (can_out_buf[OUT_BULK].head - can_out_buf[OUT_BULK].tail);
+}
+
+void can_get_stats(struct can_stats* out) {
+	out->rx_dropped = stats.rx_dropped;
+	out->rx_overruns = stats.rx_overruns;
+	out->rx_filtered = stats.rx_filtered;
+	out->tx_dropped = stats.tx_dropped;
+	out->rx_high_water = stats.rx_high_water;
+	out->tx_high_water = stats.tx_high_water;
+	out->rx_direct = stats.rx_direct;
+}
+
+static uint32_t id_bits(int ext)
+{
+	return ext ? 0x1FFFFFFF : 0x7FF;
+}
+
+static int filter_match(const struct can_filter* f, uint32_t af)
+{
+	int ext = !!(af & 0x80000000);
+
+	return f->ext == ext && !((af ^ f->filter) & ~f->mask & id_bits(ext));
+}
+
+static int route_match(uint32_t af)
+{
+	int i;
+
+	if(!routes_num) /* set up with can_init(), the filters are all there is */
+		return 1;
+	for(i = 0; i < routes_num; i++)
+		if(filter_match(&routes[i], af))
+			return 1;
+	return 0;
+}
+
+/* Takes the frame in the receive registers if it is the next consecutive frame of the direct message, its data is
+ * copied once, from REDSR to where it belongs in the message. 0 if it goes to the ring. */
+static int direct_frame(uint32_t af)
+{
+	uint8_t pci;
+	uint8_t len;
+	uint16_t received;
+	uint8_t* to;
+	int i;
+
+	if(direct.state != CAN_DIRECT_BUSY || af != direct.af)
+		return 0;
+
+	len = can_dlc_to_len(MSCAN->RDLR);
+	pci = MSCAN->REDSR[0];
+	if((pci >> 4) == 0x3) /* flow control for a message sent to the peer */
+		return 0;
+	if(len < 2 || pci != (0x20 | direct.sn)) { /* not the one expected, the dispatcher sorts it out */
+		direct.state = CAN_DIRECT_BROKEN;
+		return 0;
+	}
+	if(len > 8)
+		len = 8;
+
+	received = direct.received;
+	len--;
+	if(len > direct.size - received)
+		len = direct.size - received;
+	to = direct.buf + received;
+	for(i = 0; i < len; i++)
+		to[i] = MSCAN->REDSR[1 + i];
+	direct.sn = (direct.sn + 1) & 0x0F;
+	stats.rx_direct++;
+
+	__DMB();
+	direct.received = received + len;
+	if(received + len == direct.size)
+		direct.state = CAN_DIRECT_DONE;
+	return 1;
 }
 
 void MSCAN_RX_IRQHandler(void)
 {
 	struct can_pack* pack;
+	unsigned int head = can_in_buf.head;
+	unsigned int used;
+	uint32_t af;
 	int i;
 
 	if(MSCAN->CANRFLG & 1) { //packet received
-		if(can_in_buf.len < CAN_IN_BUF_SIZE) {
-			pack = &can_in_buf.buf[can_in_buf.beg];
-			if(MSCAN->REIDR1 & 0x08) {
-				// extended ID
-				pack->af = (1UL << 31) |
-					   (MSCAN->REIDR3 >> 1) |
-					   ((MSCAN->REIDR2) << 7) |
-					   ((MSCAN->REIDR1 & 0x07) << 15) |
-					   ((MSCAN->REIDR1 >> 5) << 18) |
-					   (MSCAN->REIDR0 << 21);
-			}
-			else {
-				// standard ID
-				pack->af = MSCAN->RSIDR1 >> 5 | 
-					   MSCAN->RSIDR0 << 3;
-			}
-			pack->dlc = MSCAN->RDLR & 0x0F;
+		if(MSCAN->REIDR1 & 0x08) {
+			// extended ID
+			af = (1UL << 31) |
+			     (MSCAN->REIDR3 >> 1) |
+			     ((MSCAN->REIDR2) << 7) |
+			     ((MSCAN->REIDR1 & 0x07) << 15) |
+			     ((MSCAN->REIDR1 >> 5) << 18) |
+			     (MSCAN->REIDR0 << 21);
+		}
+		else {
+			// standard ID
+			af = MSCAN->RSIDR1 >> 5 |
+			     MSCAN->RSIDR0 << 3;
+		}
+
+		used = head - can_in_buf.tail;
+		if(!route_match(af)) {
+			stats.rx_filtered++;
+		} else if(direct_frame(af)) {
+			/* in the message buffer already */
+		} else if(used < CAN_IN_BUF_SIZE) {
+			pack = &can_in_buf.buf[head & (CAN_IN_BUF_SIZE - 1)];
+			pack->af = af;
+			pack->dlc = can_dlc_to_len(MSCAN->RDLR);
+			if(pack->dlc > 8) /* MSCAN has 8 data registers */
+				pack->dlc = 8;
 			for(i = 0; i < pack->dlc; i++)
 				pack->data[i] = MSCAN->REDSR[i];
 
-			can_in_buf.len++;
-			if(++can_in_buf.beg >= CAN_IN_BUF_SIZE)
-				can_in_buf.beg = 0;
+			__DMB();
+			can_in_buf.head = head + 1;
+			if(used + 1 > stats.rx_high_water)
+				stats.rx_high_water = used + 1;
+		} else {
+			stats.rx_dropped++;
 		}
 		//acknowledge;
 		MSCAN->CANRFLG |= 1;
 	}
 }
 
-void MSCAN_TX_IRQHandler(void)
+/* Priority for the next frame of ring r, -1 if it has to wait for its loaded frames to go out */
+static int next_prio(int r)
 {
-	uint8_t bufmask = MSCAN->CANTFLG & MSCAN->CANTIER & 0x07; // three hardware buffers
+	uint8_t busy = ~MSCAN->CANTFLG & 0x07;
+	int base = r * PRIO_RANGE;
+	int prio = -1;
 	int i;
 
+	for(i = 0; i < 3; i++)
+		if((busy & (1 << i)) && buf_prio[i] >= base && buf_prio[i] < base + PRIO_RANGE && buf_prio[i] > prio)
+			prio = buf_prio[i];
+
+	if(prio < 0)
+		return base;
+	if(prio == base + PRIO_RANGE - 1)
+		return -1;
+	return prio + 1;
+}
+
+/* Loads the next frame into a free hardware buffer, 0 if there is no free buffer or nothing to load */
+static int can_load(void)
+{
+	struct out_ring* ring;
+	int prio;
+	int r;
+
+	if(!(MSCAN->CANTFLG & 0x07))
+		return 0;
+
+	for(r = OUT_URGENT; r <= OUT_BULK; r++) {
+		ring = &can_out_buf[r];
+		if(out_ring_empty(ring))
+			continue;
+		prio = next_prio(r);
+		if(prio < 0)
+			continue;
+
+		can_send_low(&ring->buf[ring->tail & ring->mask], prio);
+		__DMB();
+		ring->tail++;
+		return 1;
+	}
+	return 0;
+}
+
+void MSCAN_TX_IRQHandler(void)
+{
 	if(MSCAN->CANRFLG & (1 << 6)) { //status change
 		//no action now, just acknowledge;
 		MSCAN->CANRFLG |= (1 << 6);
 	}
 
-	if(MSCAN->CANRFLG & (1 << 1)) { //overrun
-		//no action now, just acknowledge;
+	if(MSCAN->CANRFLG & (1 << 1)) { //overrun, the hardware lost a frame
+		stats.rx_overruns++;
 		MSCAN->CANRFLG |= (1 << 1);
 	}
 
-	for(i = 0; i < 3; i++) {
-		if(bufmask & (1 << i)) {
-			if(can_out_buf.len) {
-				MSCAN->CANTIER &= ~(1 << i);
-				can_send_low(&can_out_buf.buf[can_out_buf.beg]);
-				// can_send_low() sets CANTFLG acknowledging the interrupt
-				can_out_buf.len--;
-				if(++can_out_buf.beg >= CAN_OUT_BUF_SIZE)
-					can_out_buf.beg = 0;
+	/* Fill all free buffers, so the controller has the next frames at hand while this one is on the bus.
+	 * can_send_low() clears CANTFLG of a loaded buffer acknowledging the interrupt. */
+	while(can_load());
+
+	// nothing to transmit in the buffers left, turn their interrupts off
+	MSCAN->CANTIER &= ~(MSCAN->CANTFLG & 0x07);
+}
+
+/* Accepts the identifiers of both filters */
+static void filter_merge(struct can_filter* to, const struct can_filter* from)
+{
+	uint32_t bits = id_bits(to->ext);
+	uint32_t dont_care = (to->mask | from->mask | (to->filter ^ from->filter)) & bits;
+
+	to->mask = dont_care;
+	to->filter &= ~dont_care & bits;
+}
+
+/* Number of identifiers the filter accepts */
+static uint32_t filter_size(const struct can_filter* f)
+{
+	uint32_t dont_care = f->mask & id_bits(f->ext);
+	uint32_t size = 1;
+
+	for(; dont_care; dont_care &= dont_care - 1)
+		size <<= 1;
+	return size;
+}
+
+int can_filters_derive(const struct can_filter* r, int n, struct can_filter out[2])
+{
+	struct can_filter group[2];
+	uint32_t best = 0xFFFFFFFF;
+	uint32_t size;
+	uint32_t split;
+	int used[2];
+	int g;
+	int i;
+
+	if(n <= 0 || n > CAN_MAX_ROUTES)
+		return 0;
+
+	/* every split of the routes into two filters, route 0 always goes to the first one */
+	for(split = 0; split < (1UL << (n - 1)); split++) {
+		used[0] = used[1] = 0;
+		for(i = 0; i < n; i++) {
+			g = i ? (split >> (i - 1)) & 1 : 0;
+			if(!used[g]) {
+				group[g] = r[i];
+				group[g].mask &= id_bits(group[g].ext);
+				group[g].filter &= ~group[g].mask & id_bits(group[g].ext);
+				used[g] = 1;
+			} else if(group[g].ext != r[i].ext) {
+				break; /* a filter is either for standard or for extended identifiers */
 			} else {
-				// nothing to transmit, turn the interrupt off
-				MSCAN->CANTIER &= ~(1 << i);
-				transmitting = 0;
+				filter_merge(&group[g], &r[i]);
 			}
 		}
+		if(i < n)
+			continue;
+
+		size = filter_size(&group[0]) + (used[1] ? filter_size(&group[1]) : 0);
+		if(size < best) {
+			best = size;
+			out[0] = group[0];
+			out[1] = used[1] ? group[1] : group[0];
+		}
 	}
+	return best != 0xFFFFFFFF;
+}
+
+int can_init_routes(uint32_t baud, const struct can_filter* r, int n)
+{
+	struct can_filter acc_filter[2];
+	int i;
+
+	if(!can_filters_derive(r, n, acc_filter))
+		return 0;
+
+	if(!can_init(baud, acc_filter))
+		return 0;
+
+	/* until routes_num is set the RX interrupt goes by the acceptance filters alone */
+	for(i = 0; i < n; i++)
+		routes[i] = r[i];
+	__DMB();
+	routes_num = n;
+	return 1;
+}
+
+/* CANBTR0 and CANBTR1 for baud, 0 if the bus clock can't give it */
+static int bit_timing(uint32_t baud, uint8_t* btr0, uint8_t* btr1)
+{
+	uint32_t bus_clock = clock_bus_hz(); // the same in all clock profiles
+	uint32_t tq;
+	uint32_t brp;
+	uint32_t tseg1;
+	uint32_t tseg2;
+	uint32_t sjw;
+
+	if(!baud)
+		return 0;
+
+	for(tq = CAN_TQ_MAX; tq >= CAN_TQ_MIN; tq--) {
+		if(bus_clock % (tq*baud))
+			continue;
+		brp = bus_clock/(tq*baud);
+		if(brp < 1 || brp > 64)
+			continue;
+
+		tseg2 = (tq*3 + 9)/10;
+		if(tseg2 > CAN_TSEG2_MAX)
+			tseg2 = CAN_TSEG2_MAX;
+		tseg1 = tq - 1 - tseg2;
+		if(tseg1 > CAN_TSEG1_MAX)
+			continue;
+		sjw = (tseg2 < CAN_SJW_MAX) ? tseg2 : CAN_SJW_MAX;
+
+		*btr0 = (brp - 1) | ((sjw - 1) << 6);
+		*btr1 = (tseg1 - 1) | ((tseg2 - 1) << 4);
+		return 1;
+	}
+	return 0;
+}
+
+static void enable_interrupts(void)
+{
+	MSCAN->CANRIER = 	 1  | // RX interrupt
+			 (0x3 << 2) | // All receive status changes
+			 (0x3 << 4) | // All tranmit status changes
+			 (0x1 << 6);  // Status interrupt
+}
+
+int can_set_baud(uint32_t baud)
+{
+	uint8_t btr0;
+	uint8_t btr1;
+
+	if(!bit_timing(baud, &btr0, &btr1))
+		return 0;
+
+	can_flush_send();
+
+	NVIC_DisableIRQ(MSCAN_RX_IRQn);
+	NVIC_DisableIRQ(MSCAN_TX_IRQn);
+
+	MSCAN->CANCTL0 |= (1 << 1); // request transition into sleep mode, the frame on the bus is finished first
+	while(!(MSCAN->CANCTL1 & (1 << 1)));
+	MSCAN->CANCTL0 |= 1; // request transition into init mode
+	while(!(MSCAN->CANCTL1 & 1)); // initialization is acknowledged
+	MSCAN->CANCTL0 &= ~(1 << 1);
+
+	MSCAN->CANBTR0 = btr0;
+	MSCAN->CANBTR1 = btr1;
+
+	MSCAN->CANCTL0 &= ~(1); // exit initialization mode
+	while(MSCAN->CANCTL1 & 1); // initialization is acknowledged
+
+	enable_interrupts(); // reset by init mode
+	NVIC_EnableIRQ(MSCAN_RX_IRQn);
+	NVIC_EnableIRQ(MSCAN_TX_IRQn);
+	return 1;
 }
 
 int can_init(uint32_t baud, struct can_filter acc_filter[2])
 {
-	int brp;
+	uint8_t btr0;
+	uint8_t btr1;
 	uint32_t filter;
 	uint32_t mask;
 	int ext;
@@ -121,9 +477,7 @@ int can_init(uint32_t baud, struct can_filter acc_filter[2])
 	NVIC_DisableIRQ(MSCAN_RX_IRQn);
 	NVIC_DisableIRQ(MSCAN_TX_IRQn);
 
-	// 20 TQ and BusClock = SystemCoreClock/2
-	brp = SystemCoreClock/(20*2*baud) - 1;
-	if(brp < 0 || brp > 63)
+	if(!bit_timing(baud, &btr0, &btr1))
 		return 0;
 
 	SIM->SCGC |= SIM_SCGC_MSCAN_MASK;
@@ -140,8 +494,8 @@ int can_init(uint32_t baud, struct can_filter acc_filter[2])
 		while(!(MSCAN->CANCTL1 & 1)); // initialization is acknowledged
 	}
 
-	MSCAN->CANBTR0 = (brp & 0x3F) | (CAN_SJW << 6);
-	MSCAN->CANBTR1 = CAN_TSEG1 | (CAN_TSEG2 << 4);
+	MSCAN->CANBTR0 = btr0;
+	MSCAN->CANBTR1 = btr1;
 
 	filter = acc_filter[0].filter;
 	mask = acc_filter[0].mask;
@@ -196,17 +550,17 @@ int can_init(uint32_t baud, struct can_filter acc_filter[2])
 					   0x07; //ignoring reserved
 	}
 
-	can_out_buf.beg = can_out_buf.end = can_out_buf.len = 0;
-	can_in_buf.beg = can_in_buf.end = can_in_buf.len = 0;
+	routes_num = 0;
+	can_out_buf[OUT_URGENT].head = can_out_buf[OUT_URGENT].tail = 0;
+	can_out_buf[OUT_BULK].head = can_out_buf[OUT_BULK].tail = 0;
+	can_in_buf.head = can_in_buf.tail = 0;
+	direct.state = CAN_DIRECT_IDLE;
 
 	MSCAN->CANCTL1 &= ~(1 << 4); // exit listen mode
 	MSCAN->CANCTL0 &= ~(1); // exit initialization mode
 	while(MSCAN->CANCTL1 & 1); // initialization is acknowledged
 
-	MSCAN->CANRIER = 	 1  | // RX interrupt
-			 (0x3 << 2) | // All receive status changes
-			 (0x3 << 4) | // All tranmit status changes
-			 (0x1 << 6);  // Status interrupt
+	enable_interrupts();
 
 	// switch tranciever to normal mode
 	GPIOA_PDDR |= (1 << 24);
@@ -222,58 +576,108 @@ static void copy_pack(const struct can_pack* from, struct can_pack* to)
 
 	to->af = from->af;
 	to->dlc = from->dlc;
-	for(i = 0; i < 8; i++)
+	for(i = 0; i < from->dlc; i++)
 		to->data[i] = from->data[i];
 }
 
 int can_recv(struct can_pack* pack)
 {
-	int idx;
-	int i;
+	unsigned int tail = can_in_buf.tail;
 
-	can_in_crit_beg();
-	if(can_in_buf.len == 0) {
-		can_in_crit_end();
+	if(can_in_buf.head == tail)
 		return 0;
-	}
 
-	idx = can_in_buf.end;
-	pack->af = can_in_buf.buf[idx].af;
-	pack->dlc = can_in_buf.buf[idx].dlc;
-	for(i = 0; i < can_in_buf.buf[idx].dlc; i++)
-		pack->data[i] = can_in_buf.buf[idx].data[i];
+	__DMB();
+	copy_pack(&can_in_buf.buf[tail & (CAN_IN_BUF_SIZE - 1)], pack);
+	__DMB();
+	can_in_buf.tail = tail + 1;
+	return 1;
+}
 
-	can_in_buf.len--;
-	if(++can_in_buf.end >= CAN_IN_BUF_SIZE)
-		can_in_buf.end = 0;
+int can_recv_pending(void)
+{
+	return can_in_buf.head != can_in_buf.tail || direct.state == CAN_DIRECT_DONE || direct.state == CAN_DIRECT_BROKEN;
+}
 
-	can_in_crit_end();
-	return 1;
+void can_direct_begin(uint32_t af, uint8_t* buf, uint16_t size, uint16_t received, uint8_t sn)
+{
+	direct.state = CAN_DIRECT_IDLE;
+	__DMB();
+	direct.af = af;
+	direct.buf = buf;
+	direct.size = size;
+	direct.received = received;
+	direct.sn = sn & 0x0F;
+	__DMB();
+	direct.state = (received < size) ? CAN_DIRECT_BUSY : CAN_DIRECT_DONE;
 }
 
-void can_send(const struct can_pack* pack)
+int can_direct_state(uint16_t* received)
 {
-	can_out_crit_beg();
-	if(can_out_buf.len >= CAN_OUT_BUF_SIZE)
-		goto out;
-
-	transmitting = 1;
-	if(can_out_buf.len == 0 && (MSCAN->CANTFLG & 0x07)) {
-		can_send_low(pack);
-		goto out;
+	int state = direct.state;
+
+	__DMB();
+	if(received)
+		*received = direct.received;
+	return state;
+}
+
+void can_direct_end(void)
+{
+	direct.state = CAN_DIRECT_IDLE;
+	__DMB();
+}
+
+int can_recv_batch(void (*handler)(const struct can_pack* pack))
+{
+	unsigned int tail = can_in_buf.tail;
+	unsigned int head = can_in_buf.head;
+	int n = 0;
+
+	__DMB();
+	/* only the frames there already, the handler may take its time */
+	for(; tail != head; tail++, n++) {
+		handler(&can_in_buf.buf[tail & (CAN_IN_BUF_SIZE - 1)]);
+		__DMB();
+		can_in_buf.tail = tail + 1;
+	}
+	return n;
+}
+
+static void out_ring_put(struct out_ring* ring, const struct can_pack* pack)
+{
+	unsigned int head = ring->head;
+	unsigned int used = head - ring->tail;
+
+	if(used > ring->mask) {
+		stats.tx_dropped++;
+		return;
 	}
 
-	copy_pack(pack, &can_out_buf.buf[can_out_buf.end]);
-	can_out_buf.len++;
-	if(++can_out_buf.end >= CAN_OUT_BUF_SIZE)
-		can_out_buf.end = 0;
+	copy_pack(pack, &ring->buf[head & ring->mask]);
+	__DMB();
+	ring->head = head + 1;
+	if(used + 1 > stats.tx_high_water)
+		stats.tx_high_water = used + 1;
 
-out:
-	can_out_crit_end();
+	/* Free hardware buffers raise the interrupt right away and take the frame, busy ones when they are done. Setting
+	 * bits only here can't lose a completion, MSCAN_TX_IRQHandler() turns off the free ones again if the ring is
+	 * empty. */
+	MSCAN->CANTIER |= 0x07;
+}
+
+void can_send(const struct can_pack* pack)
+{
+	out_ring_put(&can_out_buf[OUT_BULK], pack);
+}
+
+void can_send_urgent(const struct can_pack* pack)
+{
+	out_ring_put(&can_out_buf[OUT_URGENT], pack);
 }
 
 
-static void can_send_low(const struct can_pack* pack)
+static void can_send_low(const struct can_pack* pack, uint8_t prio)
 {
 	uint8_t bufmask = least_set(MSCAN->CANTFLG & 0x07); // three hardware buffers.
 	uint32_t af = pack->af;
@@ -283,10 +687,12 @@ static void can_send_low(const struct can_pack* pack)
 	if(!bufmask) // free buffer wasn't found. It should never happen.
 		return;
 
-	if(pack->dlc > 8)
+	if(pack->dlc > 8) /* no FD frames on MSCAN */
 		return;
 
 	MSCAN->CANTBSEL |= bufmask;
+	MSCAN->TBPR = prio;
+	buf_prio[bufmask >> 1] = prio; /* 1, 2, 4 to 0, 1, 2 */
 
 	if(ext) {
 		MSCAN->TEIDR3 = (af << 1) & 0xFF;
@@ -300,7 +706,7 @@ static void can_send_low(const struct can_pack* pack)
 		MSCAN->TSIDR0 = (af >> 3) & 0xFF;
 	}
 
-	MSCAN->TDLR = pack->dlc & 0x0F;
+	MSCAN->TDLR = can_len_to_dlc(pack->dlc);
 	for(i = 0; i < pack->dlc; i++)
 		MSCAN->TEDSR[i] = pack->data[i];
 
@@ -0,0 +1,52 @@
+#include "clock.h"
+#include "SKEAZ1284.h"
+#include "systimer.h"
+
+#define CLKDIV_PROFILE_MASK (SIM_CLKDIV_OUTDIV1_MASK | SIM_CLKDIV_OUTDIV2_MASK)
+#define CLKDIV_LOW (SIM_CLKDIV_OUTDIV1(1) | SIM_CLKDIV_OUTDIV2(0))
+#define CLKDIV_FULL (SIM_CLKDIV_OUTDIV1(0) | SIM_CLKDIV_OUTDIV2(1))
+
+static clock_profile_t profile = CLOCK_PROFILE_FULL;
+static int boost_depth;
+
+void clock_init(void)
+{
+	boost_depth = 0;
+	clock_set_profile(CLOCK_PROFILE_LOW);
+}
+
+void clock_set_profile(clock_profile_t p)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t clkdiv = (p == CLOCK_PROFILE_FULL) ? CLKDIV_FULL : CLKDIV_LOW;
+
+	__disable_irq(); // SysTick_Handler() must not see the old reload with the new clock
+	SIM->CLKDIV = (SIM->CLKDIV & ~CLKDIV_PROFILE_MASK) | clkdiv;
+	SystemCoreClockUpdate();
+	time_clock_changed();
+	profile = p;
+	if(!primask)
+		__enable_irq();
+}
+
+clock_profile_t clock_get_profile(void)
+{
+	return profile;
+}
+
+uint32_t clock_bus_hz(void)
+{
+	return SystemCoreClock >> ((SIM->CLKDIV & SIM_CLKDIV_OUTDIV2_MASK) >> SIM_CLKDIV_OUTDIV2_SHIFT);
+}
+
+void clock_boost_begin(void)
+{
+	if(boost_depth++ == 0)
+		clock_set_profile(CLOCK_PROFILE_FULL);
+}
+
+void clock_boost_end(void)
+{
+	if(boost_depth > 0 && --boost_depth == 0)
+		clock_set_profile(CLOCK_PROFILE_LOW);
+}
@@ -1,14 +1,42 @@
 #include "flash.h"
 #include "SKEAZ1284.h"
+#include "clock.h"
+#include "trace.h"
 
-static void command(int len, const uint8_t* cmd)
-{
-	volatile int i;
+#include <stddef.h>
 
-	if(len <= 0 || len > 12)
-		return;
+#define FLASH_QUEUE_SIZE 4
 
-	while(!(FTMRE->FSTAT & (1 << 7))); // wait for CCIF
+#define FLASH_OP_ERASE 0
+#define FLASH_OP_WRITE 1 /* erase, then program */
+#define FLASH_OP_PROGRAM 2
+
+struct flash_op {
+	int type;
+	uint32_t addr;
+	const uint8_t* data;
+	flash_callback_t cb;
+	void* arg;
+};
+
+static struct {
+	struct flash_op buf[FLASH_QUEUE_SIZE];
+	int beg;
+	volatile int len;
+	int step; /* of the first operation, see next_step() */
+} flash_queue;
+
+/* Code that runs while the flash is busy. Startup copies section .ramfunc into SRAM (see SKEAZ_flash.ld), which is
+ * out of branch range of flash, hence the long calls */
+#define RAMFUNC __attribute__((section(".ramfunc"), long_call, noinline))
+
+#define flash_crit_beg() {NVIC_DisableIRQ(FTMRE_IRQn);}
+#define flash_crit_end() {NVIC_EnableIRQ(FTMRE_IRQn);}
+
+// clears errors of the previous command and loads the new one
+RAMFUNC static void command_load(int len, const uint8_t* cmd)
+{
+	int i;
 
 	if(FTMRE->FSTAT & (1 << 4)) // FPVIOL
 		FTMRE->FSTAT = (1 << 4); // Clear
@@ -23,42 +51,45 @@ static void command(int len, const uint8_t* cmd)
 			FTMRE->FCCOBLO = cmd[i];
 		}
 	}
+}
+
+// runs the command from SRAM, only interrupt handlers in flash stall until it is done
+RAMFUNC static void command_run(int len, const uint8_t* cmd)
+{
+	command_load(len, cmd);
 
 	// enable stalls
 	MCM->PLACR |= (1 << 16);
 	FTMRE->FSTAT = 0x80;
 	while(!(FTMRE->FSTAT & 0x80)); // wait for CCIF
 	// disable stalls (p. 202 of reference manual)
-	MCM->PLACR &= (1 << 16);
+	MCM->PLACR &= ~(1 << 16);
 }
 
-int flash_erase_sector(uint32_t addr)
+static void command(int len, const uint8_t* cmd)
 {
-	uint8_t cmd[4];
+	if(len <= 0 || len > 12)
+		return;
 
-	// address is not aligned
-	if(addr % FLASH_SECTOR_SIZE)
-		return 0;
+	flash_wait(); // queued operations go first
 
-	//out of range
-	if(addr >= FLASH_SIZE)
-		return 0;
+	while(!(FTMRE->FSTAT & (1 << 7))); // wait for CCIF
 
+	command_run(len, cmd);
+}
 
+static int erase_cmd(uint8_t* cmd, uint32_t addr)
+{
 	cmd[0] = 0x0A;
 	cmd[1] = (addr >> 16) & 0xFF;
 	cmd[2] = (addr >> 8) & 0xFF;
 	cmd[3] = addr & 0xFF;
-
-	command(4, cmd);
-
-	return !(FTMRE->FSTAT & 0x33); // ACCERR, FPVIOL and MSGSTAT are cleared
+	return 4;
 }
 
 // programs exactly 8 bytes of flash. Address should be aligned by 8.
-static int program_flash(uint32_t addr, const uint8_t* data)
+static int program_cmd(uint8_t* cmd, uint32_t addr, const uint8_t* data)
 {
-	uint8_t cmd[12];
 	int i;
 
 	cmd[0] = 0x06;
@@ -72,21 +103,58 @@ static int program_flash(uint32_t addr, const uint8_t* data)
 		else
 			cmd[4+i+1] = data[i];
 	}
+	return 12;
+}
 
-	command(12, cmd);
+int flash_erase_sector(uint32_t addr)
+{
+	uint8_t cmd[4];
+
+	// address is not aligned
+	if(addr % FLASH_SECTOR_SIZE)
+		return 0;
+
+	//out of range
+	if(addr >= FLASH_SIZE)
+		return 0;
+
+
+	command(erase_cmd(cmd, addr), cmd);
+
+	return !(FTMRE->FSTAT & 0x33); // ACCERR, FPVIOL and MSGSTAT are cleared
+}
+
+static int program_flash(uint32_t addr, const uint8_t* data)
+{
+	uint8_t cmd[12];
+
+	command(program_cmd(cmd, addr, data), cmd);
 
 	return !(FTMRE->FSTAT & 0x33); // ACCERR, FPVIOL and MSGSTAT are cleared
 }
 
 void flash_init(void)
 {
-	uint8_t fclk = (SystemCoreClock/2)/1000000 - 1;
+	uint8_t fclk = clock_bus_hz()/1000000 - 1; // the same in all clock profiles
 
 	if((FTMRE->FCLKDIV & 0x3F) != fclk)
 		FTMRE->FCLKDIV = fclk;
+
+	NVIC_EnableIRQ(FTMRE_IRQn);
 }
 
-int flash_write_sector(uint32_t addr, const uint8_t* data)
+// erased flash reads as 0xFF, programming such a phrase changes nothing
+static int phrase_blank(const uint8_t* data)
+{
+	int i;
+
+	for(i = 0; i < 8; i++)
+		if(data[i] != 0xFF)
+			return 0;
+	return 1;
+}
+
+int flash_program_sector(uint32_t addr, const uint8_t* data)
 {
 	int i;
 	// address is not aligned
@@ -97,12 +165,175 @@ int flash_write_sector(uint32_t addr, const uint8_t* data)
 	if(addr >= FLASH_SIZE)
 		return 0;
 
-	if(!flash_erase_sector(addr))
+	for(i = 0; i < FLASH_SECTOR_SIZE; i += 8)
+		if(!phrase_blank(data+i) && !program_flash(addr+i, data+i))
+			return 0;
+
+	return 1;
+}
+
+int flash_program(uint32_t addr, const uint8_t* data, uint32_t len)
+{
+	uint32_t i;
+
+	// address or length is not aligned
+	if(addr % FLASH_PHRASE_SIZE || len % FLASH_PHRASE_SIZE)
 		return 0;
 
-	for(i = 0; i < FLASH_SECTOR_SIZE; i += 8)
-		if(!program_flash(addr+i, data+i))
+	//out of range
+	if(addr >= FLASH_SIZE || len > FLASH_SIZE - addr)
+		return 0;
+
+	for(i = 0; i < len; i += FLASH_PHRASE_SIZE)
+		if(!phrase_blank(data+i) && !program_flash(addr+i, data+i))
 			return 0;
 
 	return 1;
 }
+
+int flash_write_sector(uint32_t addr, const uint8_t* data)
+{
+	int res;
+
+	TRACE_BEGIN(TRACE_FLASH_WRITE, 0);
+	res = flash_erase_sector(addr) && flash_program_sector(addr, data);
+	TRACE_END(TRACE_FLASH_WRITE, 0);
+	return res;
+}
+
+// the step after the given one: 0 is the erase, then one per 8-byte phrase that is not blank. 0 when there is none.
+static int next_step(const struct flash_op* op, int step)
+{
+	if(op->type == FLASH_OP_ERASE)
+		return 0;
+
+	while(step < FLASH_SECTOR_SIZE/8)
+		if(!phrase_blank(op->data + 8*step++))
+			return step;
+	return 0;
+}
+
+static int first_step(const struct flash_op* op)
+{
+	return (op->type == FLASH_OP_PROGRAM) ? next_step(op, 0) : 0;
+}
+
+// starts a step of an operation, CCIF raises the interrupt when it is done
+static void op_launch(const struct flash_op* op, int step)
+{
+	uint8_t cmd[12];
+	int len;
+
+	if(step == 0)
+		len = erase_cmd(cmd, op->addr);
+	else
+		len = program_cmd(cmd, op->addr + (step-1)*8, op->data + (step-1)*8);
+
+	command_load(len, cmd);
+	FTMRE->FSTAT = 0x80;
+}
+
+void FTMRE_IRQHandler(void)
+{
+	const struct flash_op* op = &flash_queue.buf[flash_queue.beg];
+	int ok = !(FTMRE->FSTAT & 0x33); // ACCERR, FPVIOL and MSGSTAT are cleared
+	flash_callback_t cb;
+	void* arg;
+
+	if(ok && (flash_queue.step = next_step(op, flash_queue.step)) != 0) {
+		op_launch(op, flash_queue.step);
+		return;
+	}
+
+	// the operation is over, the callback may already queue the next one
+	cb = op->cb;
+	arg = op->arg;
+	flash_queue.len--;
+	if(++flash_queue.beg >= FLASH_QUEUE_SIZE)
+		flash_queue.beg = 0;
+
+	if(flash_queue.len) {
+		op = &flash_queue.buf[flash_queue.beg];
+		flash_queue.step = first_step(op);
+		op_launch(op, flash_queue.step);
+	} else {
+		FTMRE->FCNFG &= ~FTMRE_FCNFG_CCIE_MASK;
+		MCM->PLACR &= ~(1 << 16);
+	}
+
+	if(cb)
+		cb(ok, arg);
+}
+
+static int flash_queue_op(int type, uint32_t addr, const uint8_t* data, flash_callback_t cb, void* arg)
+{
+	struct flash_op* op;
+	int ret = 0;
+	int i;
+
+	// address is not aligned
+	if(addr % FLASH_SECTOR_SIZE)
+		return 0;
+
+	//out of range
+	if(addr >= FLASH_SIZE)
+		return 0;
+
+	// nothing to program
+	if(type == FLASH_OP_PROGRAM) {
+		for(i = 0; i < FLASH_SECTOR_SIZE; i += 8)
+			if(!phrase_blank(data+i))
+				break;
+		if(i == FLASH_SECTOR_SIZE) {
+			if(cb)
+				cb(1, arg);
+			return 1;
+		}
+	}
+
+	flash_crit_beg();
+	if(flash_queue.len < FLASH_QUEUE_SIZE) {
+		op = &flash_queue.buf[(flash_queue.beg + flash_queue.len) % FLASH_QUEUE_SIZE];
+		op->type = type;
+		op->addr = addr;
+		op->data = data;
+		op->cb = cb;
+		op->arg = arg;
+
+		if(flash_queue.len++ == 0) {
+			while(!(FTMRE->FSTAT & (1 << 7))); // a synchronous command may still finish
+			MCM->PLACR |= (1 << 16);
+			flash_queue.step = first_step(op);
+			op_launch(op, flash_queue.step);
+			FTMRE->FCNFG |= FTMRE_FCNFG_CCIE_MASK;
+		}
+		ret = 1;
+	}
+	flash_crit_end();
+	return ret;
+}
+
+int flash_erase_sector_async(uint32_t addr, flash_callback_t cb, void* arg)
+{
+	return flash_queue_op(FLASH_OP_ERASE, addr, NULL, cb, arg);
+}
+
+int flash_write_sector_async(uint32_t addr, const uint8_t* data, flash_callback_t cb, void* arg)
+{
+	return flash_queue_op(FLASH_OP_WRITE, addr, data, cb, arg);
+}
+
+int flash_program_sector_async(uint32_t addr, const uint8_t* data, flash_callback_t cb, void* arg)
+{
+	return flash_queue_op(FLASH_OP_PROGRAM, addr, data, cb, arg);
+}
+
+int flash_busy(void)
+{
+	return flash_queue.len != 0;
+}
+
+void flash_wait(void)
+{
+	while(flash_queue.len);
+}
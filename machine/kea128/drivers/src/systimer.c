@@ -3,9 +3,44 @@
 
 volatile uint32_t SystemTime = 0;
 
+/* SysTick fires once in a millisecond. time_sleep() stretches its period over the whole sleep, tick_ms is the number
+ * of milliseconds the running period stands for. */
+static uint32_t ticks_per_ms;
+static volatile uint32_t tick_ms = 1;
+
 void time_init(void)
 {
-	SysTick_Config(SystemCoreClock/1000); // once in a millisecond
+	ticks_per_ms = SystemCoreClock/1000;
+	SysTick_Config(ticks_per_ms); // once in a millisecond
+}
+
+uint32_t time_get_us(void)
+{
+	uint32_t ms;
+	uint32_t val;
+
+	/* VAL + 1 is the number of ticks to the next millisecond, also after time_sleep() cut a period short */
+	do {
+		ms = SystemTime;
+		val = SysTick->VAL;
+	} while(ms != SystemTime);
+	if(val >= ticks_per_ms)
+		val = ticks_per_ms - 1;
+	return ms * 1000 + (ticks_per_ms - 1 - val) / (ticks_per_ms / 1000);
+}
+
+uint32_t time_get_cycles(void)
+{
+	uint32_t ms;
+	uint32_t val;
+
+	do {
+		ms = SystemTime;
+		val = SysTick->VAL;
+	} while(ms != SystemTime);
+	if(val >= ticks_per_ms)
+		val = ticks_per_ms - 1;
+	return ms * ticks_per_ms + (ticks_per_ms - 1 - val);
 }
 
 void time_delay(uint32_t ms)
@@ -14,8 +49,88 @@ void time_delay(uint32_t ms)
 	while(time_passed(ts) < ms);
 }
 
-void SysTick_Handler(void)
+void time_sleep(uint32_t ms)
 {
-	SystemTime++;
+	uint32_t max_ms = SysTick_LOAD_RELOAD_Msk / ticks_per_ms;
+	uint32_t next; /* ticks to the next millisecond */
+	uint32_t load;
+	uint32_t elapsed;
+	uint32_t passed;
+
+	if(ms < 2 || (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)) {
+		__WFI(); // the next tick wakes up anyway
+		return;
+	}
+	if(ms > max_ms)
+		ms = max_ms;
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	next = SysTick->VAL;
+	if(!next)
+		next = ticks_per_ms;
+	load = next + (ms - 1) * ticks_per_ms;
+	SysTick->LOAD = load - 1;
+	SysTick->VAL = 0; // reloads from LOAD on the next clock
+	tick_ms = ms;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+	__WFI();
+
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+		/* slept it all, SysTick_Handler() adds it up */
+		SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+		return;
+	}
+
+	/* woken up by another interrupt, count the milliseconds that passed and go on to the next one */
+	elapsed = load - 1 - SysTick->VAL;
+	if(elapsed < next) {
+		passed = 0;
+		next -= elapsed;
+	} else {
+		passed = 1 + (elapsed - next) / ticks_per_ms;
+		next = ticks_per_ms - (elapsed - next) % ticks_per_ms;
+	}
+	if(next < 2) { // LOAD can't be 0
+		passed++;
+		next = ticks_per_ms;
+	}
+	SystemTime += passed;
+	tick_ms = 1;
+	SysTick->LOAD = next - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
 }
 
+void time_clock_changed(void)
+{
+	uint32_t old_ticks = ticks_per_ms;
+	uint32_t next;
+
+	ticks_per_ms = SystemCoreClock/1000;
+	if(ticks_per_ms == old_ticks)
+		return;
+
+	/* the rest of the running period in the new clock, SysTick_Handler() goes back to whole milliseconds */
+	SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+	next = SysTick->VAL;
+	if(!next)
+		next = old_ticks;
+	next = next * ticks_per_ms / old_ticks; // outside time_sleep() the period is a millisecond, no overflow
+	if(next < 2) // LOAD can't be 0
+		next = 2;
+	SysTick->LOAD = next - 1;
+	SysTick->VAL = 0;
+	SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+}
+
+void SysTick_Handler(void)
+{
+	SystemTime += tick_ms;
+	if(SysTick->LOAD != ticks_per_ms - 1) { // the period was stretched or cut short by time_sleep()
+		SysTick->LOAD = ticks_per_ms - 1;
+		SysTick->VAL = 0;
+		tick_ms = 1;
+	}
+}
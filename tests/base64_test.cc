@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include "libuptiny/base64.h"
+#include "libuptiny/utils.h"
 #include "utilities/utils.h"
 #include "logging/logging.h"
 
@@ -59,6 +60,23 @@ TEST(tinybase64, decode) {
   EXPECT_EQ(base64_decode(Utils::toBase64(len0).c_str(), (unsigned int)(Utils::toBase64(len0).length()), decoded_buf), 0);
 }
 
+TEST(tinyhex, cmp) {
+  const uint8_t bin[] = {0x12, 0x34, 0xab, 0xcd, 0xef};
+
+  EXPECT_EQ(hex_bin_cmp("1234abcdef", 10, bin), 0);
+  EXPECT_EQ(hex_bin_cmp("1234ABCDEF", 10, bin), 0);
+  EXPECT_EQ(hex_bin_cmp("1234abcdee", 10, bin), -1);
+  EXPECT_EQ(hex_bin_cmp("1234abcdf0", 10, bin), 1);
+  EXPECT_EQ(hex_bin_cmp("0234abcdef", 10, bin), -1);
+  EXPECT_EQ(hex_bin_cmp("2234abcdef", 10, bin), 1);
+
+  // an invalid digit after a difference, in the same group of four digits and in a later one
+  EXPECT_EQ(hex_bin_cmp("22x4abcdef", 10, bin), -1);
+  EXPECT_EQ(hex_bin_cmp("2234abcdeg", 10, bin), -1);
+  EXPECT_EQ(hex_bin_cmp("2234abcd-f", 10, bin), -1);
+  EXPECT_EQ(hex_bin_cmp("1234abcdeg", 10, bin), -1);
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "libuptiny/chunks.h"
+#include "libuptiny/common_data_api.h"
+#include "libuptiny/state_api.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+// the tree as RFC 6962 defines it, hashed with hash_context
+static std::string hash(const std::string& data) {
+  crypto_hash_t res;
+  crypto_hash_init(&hash_context, CRYPTO_HASH_SHA256);
+  crypto_hash_feed(&hash_context, reinterpret_cast<const uint8_t*>(data.c_str()), data.length());
+  crypto_hash_result(&hash_context, &res);
+  return std::string(reinterpret_cast<const char*>(res.hash), 32);
+}
+
+static size_t split(size_t n) {
+  size_t k = 1;
+  while (k * 2 < n) {
+    k *= 2;
+  }
+  return k;
+}
+
+static std::string tree_hash(const std::vector<std::string>& chunks, size_t begin, size_t end) {
+  if (end - begin == 1) {
+    return hash(std::string(1, '\0') + chunks[begin]);
+  }
+  size_t k = split(end - begin);
+  return hash("\x01" + tree_hash(chunks, begin, begin + k) + tree_hash(chunks, begin + k, end));
+}
+
+static std::string audit_path(const std::vector<std::string>& chunks, size_t index, size_t begin, size_t end) {
+  if (end - begin == 1) {
+    return "";
+  }
+  size_t k = split(end - begin);
+  if (index < begin + k) {
+    return audit_path(chunks, index, begin, begin + k) + tree_hash(chunks, begin + k, end);
+  }
+  return audit_path(chunks, index, begin + k, end) + tree_hash(chunks, begin, begin + k);
+}
+
+static std::vector<std::string> split_image(const std::string& image, uint32_t chunk_size) {
+  std::vector<std::string> chunks;
+  for (size_t i = 0; i < image.length(); i += chunk_size) {
+    chunks.push_back(image.substr(i, chunk_size));
+  }
+  return chunks;
+}
+
+static uptane_targets_t targets;
+
+static void set_targets(const std::string& image, uint32_t chunk_size, const std::string& root) {
+  memset(&targets, 0, sizeof(targets));
+  targets.length = static_cast<uint32_t>(image.length());
+  targets.chunk_size = chunk_size;
+  targets.chunk_root.alg = CRYPTO_HASH_SHA256;
+  memcpy(targets.chunk_root.hash, root.c_str(), root.length());
+  state_set_targets(&targets);
+}
+
+static bool verify(uint32_t index, const std::string& chunk, const std::string& path) {
+  return uptane_verify_chunk(index, reinterpret_cast<const uint8_t*>(chunk.c_str()), chunk.length(),
+                             reinterpret_cast<const uint8_t*>(path.c_str()));
+}
+
+static const std::string image = "The quick brown fox jumps over the lazy dog";
+
+TEST(tiny_chunks, verify) {
+  for (uint32_t chunk_size = 1; chunk_size <= image.length() + 1; ++chunk_size) {
+    std::vector<std::string> chunks = split_image(image, chunk_size);
+    set_targets(image, chunk_size, tree_hash(chunks, 0, chunks.size()));
+    ASSERT_EQ(uptane_chunks_num(), chunks.size());
+
+    // in reverse, the order does not matter
+    for (size_t i = chunks.size(); i-- > 0;) {
+      std::string path = audit_path(chunks, i, 0, chunks.size());
+      EXPECT_EQ(uptane_chunk_path_len(i), path.length());
+      EXPECT_TRUE(verify(i, chunks[i], path));
+    }
+  }
+}
+
+TEST(tiny_chunks, reject) {
+  std::vector<std::string> chunks = split_image(image, 5);
+  set_targets(image, 5, tree_hash(chunks, 0, chunks.size()));
+
+  std::string path = audit_path(chunks, 3, 0, chunks.size());
+  ASSERT_TRUE(verify(3, chunks[3], path));
+
+  std::string tampered = chunks[3];
+  tampered[0] ^= 1;
+  EXPECT_FALSE(verify(3, tampered, path));
+  EXPECT_FALSE(verify(2, chunks[3], path));
+  EXPECT_FALSE(verify(3, chunks[3].substr(1), path));
+  EXPECT_FALSE(verify(static_cast<uint32_t>(chunks.size()), chunks[3], path));
+  path[path.length() - 1] ^= 1;
+  EXPECT_FALSE(verify(3, chunks[3], path));
+
+  // the last chunk is the shorter rest
+  path = audit_path(chunks, chunks.size() - 1, 0, chunks.size());
+  EXPECT_TRUE(verify(static_cast<uint32_t>(chunks.size() - 1), chunks.back(), path));
+  EXPECT_FALSE(verify(static_cast<uint32_t>(chunks.size() - 1), chunks.back() + "!", path));
+
+  // a leaf is not a node: the hashes of two chunks pass for neither
+  EXPECT_FALSE(verify(0, tree_hash(chunks, 0, 1) + tree_hash(chunks, 1, 2), ""));
+
+  // no tree
+  targets.chunk_size = 0;
+  state_set_targets(&targets);
+  EXPECT_EQ(uptane_chunks_num(), 0);
+  EXPECT_FALSE(verify(0, chunks[0], ""));
+}
+
+TEST(tiny_chunks, sent_data) {
+  // the chunks are the compressed data if there is some
+  std::string compressed = "compressed";
+  std::vector<std::string> chunks = split_image(compressed, 4);
+  set_targets(image, 4, tree_hash(chunks, 0, chunks.size()));
+  targets.compressed_length = static_cast<uint32_t>(compressed.length());
+  state_set_targets(&targets);
+
+  EXPECT_EQ(uptane_chunks_num(), 3);
+  EXPECT_TRUE(verify(2, chunks[2], audit_path(chunks, 2, 0, chunks.size())));
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "libuptiny/decompress.h"
+#include "logging/logging.h"
+
+class BitWriter {
+ public:
+  BitWriter& literal(char c) {
+    put(1, 1);
+    put(static_cast<uint8_t>(c), 8);
+    return *this;
+  }
+  BitWriter& backref(unsigned int offset, unsigned int count) {
+    put(0, 1);
+    put(offset - 1, HEATSHRINK_WINDOW_BITS);
+    put(count - 1, HEATSHRINK_LOOKAHEAD_BITS);
+    return *this;
+  }
+  std::string finish() {
+    std::string res = out_;
+    if (bits_ != 0) {
+      res += static_cast<char>(acc_ << (8 - bits_));
+    }
+    return res;
+  }
+
+ private:
+  void put(unsigned int value, int bits) {
+    for (int i = bits - 1; i >= 0; --i) {
+      acc_ = (acc_ << 1) | ((value >> i) & 1);
+      if (++bits_ == 8) {
+        out_ += static_cast<char>(acc_);
+        acc_ = 0;
+        bits_ = 0;
+      }
+    }
+  }
+
+  std::string out_;
+  unsigned int acc_{0};
+  int bits_{0};
+};
+
+static std::string decompressed;
+
+static bool collect(const uint8_t* data, size_t len) {
+  decompressed.append(reinterpret_cast<const char*>(data), len);
+  return true;
+}
+
+static bool refuse(const uint8_t* data, size_t len) {
+  (void)data;
+  (void)len;
+  return false;
+}
+
+// decompresses in chunks of chunk_size, returns false if the data is refused
+static bool decompress(const std::string& data, size_t out_len, size_t chunk_size) {
+  decompressed.clear();
+  uptane_decompress_init(out_len);
+  for (size_t i = 0; i < data.length(); i += chunk_size) {
+    std::string chunk = data.substr(i, chunk_size);
+    if (!uptane_decompress_feed(reinterpret_cast<const uint8_t*>(chunk.c_str()), chunk.length(), collect)) {
+      return false;
+    }
+  }
+  return uptane_decompress_finalize();
+}
+
+TEST(tiny_decompress, literals_and_backrefs) {
+  // the last back reference overlaps its own output
+  std::string data = BitWriter().literal('a').literal('b').literal('c').backref(3, 9).literal('!').finish();
+
+  for (size_t chunk_size : {1, 2, 3, 64}) {
+    EXPECT_TRUE(decompress(data, 13, chunk_size));
+    EXPECT_EQ(decompressed, "abcabcabcabc!");
+  }
+}
+
+TEST(tiny_decompress, window) {
+  const unsigned int window_size = 1U << HEATSHRINK_WINDOW_BITS;
+  const unsigned int max_count = 1U << HEATSHRINK_LOOKAHEAD_BITS;
+
+  // the window starts out as zeros
+  EXPECT_TRUE(decompress(BitWriter().backref(window_size, 4).finish(), 4, 1));
+  EXPECT_EQ(decompressed, std::string(4, '\0'));
+
+  // copies from the oldest byte of the window while it wraps around several times
+  BitWriter writer;
+  std::string expected;
+  for (unsigned int i = 0; i < window_size; ++i) {
+    writer.literal(static_cast<char>(i * 7));
+    expected += static_cast<char>(i * 7);
+  }
+  for (unsigned int n = 0; n < 3 * window_size; n += max_count) {
+    writer.backref(window_size, max_count);
+    expected += expected.substr(expected.length() - window_size, max_count);
+  }
+  std::string data = writer.finish();
+
+  for (size_t chunk_size : {1, 5, 64, 1000}) {
+    EXPECT_TRUE(decompress(data, expected.length(), chunk_size));
+    EXPECT_EQ(decompressed, expected);
+  }
+}
+
+TEST(tiny_decompress, malformed) {
+  std::string data = BitWriter().literal('a').literal('b').backref(2, 4).finish();
+  EXPECT_TRUE(decompress(data, 6, 1));
+
+  // longer and shorter than expected
+  EXPECT_FALSE(decompress(data, 5, 1));
+  EXPECT_FALSE(decompress(data, 7, 1));
+  EXPECT_FALSE(decompress(data + '\0', 6, 1));
+
+  // nothing is accepted after output failed
+  uptane_decompress_init(6);
+  EXPECT_FALSE(uptane_decompress_feed(reinterpret_cast<const uint8_t*>(data.c_str()), data.length(), refuse));
+  EXPECT_FALSE(uptane_decompress_feed(reinterpret_cast<const uint8_t*>(data.c_str()), data.length(), collect));
+  EXPECT_FALSE(uptane_decompress_finalize());
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "libuptiny/delta.h"
+#include "libuptiny/firmware.h"
+#include "libuptiny/state_api.h"
+#include "libuptiny/targets.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+static std::string copy_op(uint32_t offset, uint16_t len) {
+  std::string op;
+  op += static_cast<char>(0x80 | (len >> 8));
+  op += static_cast<char>(len);
+  op += static_cast<char>(offset >> 16);
+  op += static_cast<char>(offset >> 8);
+  op += static_cast<char>(offset);
+  return op;
+}
+
+static std::string insert_op(const std::string& data) {
+  std::string op;
+  op += static_cast<char>(data.length() >> 8);
+  op += static_cast<char>(data.length());
+  return op + data;
+}
+
+static std::string rebuilt;
+
+static bool collect(const uint8_t* data, size_t len) {
+  rebuilt.append(reinterpret_cast<const char*>(data), len);
+  return true;
+}
+
+// applies the delta in chunks of chunk_size, returns false if the delta is refused
+static bool apply(const std::string& base, const std::string& delta, size_t image_len, bool in_place,
+                  size_t chunk_size) {
+  rebuilt.clear();
+  uptane_delta_init(reinterpret_cast<const uint8_t*>(base.c_str()), base.length(), image_len, in_place);
+  for (size_t i = 0; i < delta.length(); i += chunk_size) {
+    std::string chunk = delta.substr(i, chunk_size);
+    if (!uptane_delta_feed(reinterpret_cast<const uint8_t*>(chunk.c_str()), chunk.length(), collect)) {
+      return false;
+    }
+  }
+  return uptane_delta_finalize();
+}
+
+static const std::string base = "The quick brown fox jumps over the lazy dog";
+
+TEST(tiny_delta, apply) {
+  std::string image = "The quick red fox jumps over the lazy dog!";
+  std::string delta = copy_op(0, 10) + insert_op("red") + copy_op(15, 28) + insert_op("!");
+
+  for (size_t chunk_size : {1, 2, 3, 5, 7, 64}) {
+    EXPECT_TRUE(apply(base, delta, image.length(), false, chunk_size));
+    EXPECT_EQ(rebuilt, image);
+  }
+}
+
+TEST(tiny_delta, in_place) {
+  // "red" is shorter than "brown", the rest of the base moves backwards: fine in place
+  std::string image = "The quick red fox jumps over the lazy dog";
+  std::string delta = copy_op(0, 10) + insert_op("red") + copy_op(15, 28);
+  EXPECT_TRUE(apply(base, delta, image.length(), true, 3));
+  EXPECT_EQ(rebuilt, image);
+
+  // a copy from before the output position reads what has been overwritten already
+  std::string moved = "The quick The quick";
+  delta = copy_op(0, 10) + copy_op(0, 9);
+  EXPECT_TRUE(apply(base, delta, moved.length(), false, 3));
+  EXPECT_EQ(rebuilt, moved);
+  EXPECT_FALSE(apply(base, delta, moved.length(), true, 3));
+}
+
+TEST(tiny_delta, malformed) {
+  // copy from outside of the base
+  EXPECT_FALSE(apply(base, copy_op(40, 4), 4, false, 64));
+  EXPECT_FALSE(apply(base, copy_op(0x800000, 1), 1, false, 64));
+  // more bytes than the image has
+  EXPECT_FALSE(apply(base, copy_op(0, 10) + insert_op("xyz"), 12, false, 1));
+  // fewer bytes than the image has
+  EXPECT_FALSE(apply(base, copy_op(0, 10), 11, false, 64));
+  // truncated operations
+  EXPECT_FALSE(apply(base, copy_op(0, 10).substr(0, 3), 10, false, 64));
+  EXPECT_FALSE(apply(base, insert_op("xyz").substr(0, 4), 3, false, 64));
+  // empty operation
+  EXPECT_FALSE(apply(base, insert_op(""), 0, false, 64));
+  // nothing more is taken after an error
+  EXPECT_FALSE(apply(base, copy_op(40, 4) + insert_op("abcd"), 4, false, 5));
+  EXPECT_TRUE(rebuilt.empty());
+}
+
+TEST(tiny_delta, firmware_base) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  uint16_t result = 0x0000;
+  uptane_targets_t targets;
+  uptane_parse_targets_init();
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t)targets_str.length(), &targets, &result);
+  ASSERT_EQ(result, RESULT_END_FOUND);
+  EXPECT_EQ(targets.delta_length, 0);
+
+  uptane_installation_state_t installed;
+  memset(&installed, 0, sizeof(installed));
+  installed.firmware_hash.alg = CRYPTO_HASH_SHA512;
+  memset(installed.firmware_hash.hash, 0x5a, sizeof(installed.firmware_hash.hash));
+  installed.firmware_length = 100;
+  state_set_installation_state(&installed);
+
+  targets.delta_length = 20;
+  targets.delta_base = installed.firmware_hash;
+  state_set_targets(&targets);
+  EXPECT_TRUE(uptane_verify_firmware_init());
+
+  // the image hash of the target is the one of the rebuilt image
+  std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), firmware.length());
+  EXPECT_TRUE(uptane_verify_firmware_finalize());
+
+  // a delta against another image
+  targets.delta_base.hash[0] ^= 1;
+  state_set_targets(&targets);
+  EXPECT_FALSE(uptane_verify_firmware_init());
+
+  targets.delta_base = installed.firmware_hash;
+  targets.delta_base.alg = CRYPTO_HASH_SHA256;
+  state_set_targets(&targets);
+  EXPECT_FALSE(uptane_verify_firmware_init());
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -0,0 +1,443 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/algorithm/hex.hpp>
+
+#include "ed25519/ed25519.h"
+#include "ed25519/edsign.h"
+#include "ed25519/fprime.h"
+#include "logging/logging.h"
+
+struct rfc8032_vector {
+  const char* secret;
+  const char* pub;
+  const char* message;
+  const char* signature;
+};
+
+// RFC 8032, section 7.1, tests 1-3
+static const rfc8032_vector vectors[] = {
+    {"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60",
+     "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+     "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655"
+     "141438e7a100b"},
+    {"4ccd089b28ff96da9db6c346ec114e0f5b8a319f35aba624da8cf6ed4fb8a6fb",
+     "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+     "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00"
+     "d291612bb0c00"},
+    {"c5aa8df43f9f837bedb7442f31dcb7b166d38535076f094b85ce3a2e0b4458f7",
+     "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025", "af82",
+     "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc02"
+     "7beceea1ec40a"},
+};
+
+static std::string unhex(const char* hex) { return boost::algorithm::unhex(std::string(hex)); }
+
+static bool verify(const std::string& sig, const std::string& pub, const std::string& msg) {
+  struct sha512_state s;
+  return edsign_verify_init(&s, reinterpret_cast<const uint8_t*>(sig.c_str()),
+                            reinterpret_cast<const uint8_t*>(pub.c_str()),
+                            reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length()) != 0;
+}
+
+TEST(tiny_ed25519, rfc8032_sign) {
+  for (const auto& v : vectors) {
+    std::string secret = unhex(v.secret);
+    std::string msg = unhex(v.message);
+    uint8_t pub[EDSIGN_PUBLIC_KEY_SIZE];
+    uint8_t sig[EDSIGN_SIGNATURE_SIZE];
+
+    edsign_sec_to_pub(pub, reinterpret_cast<const uint8_t*>(secret.c_str()));
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(pub), sizeof(pub)), unhex(v.pub));
+
+    edsign_sign(sig, pub, reinterpret_cast<const uint8_t*>(secret.c_str()),
+                reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length());
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(sig), sizeof(sig)), unhex(v.signature));
+  }
+}
+
+TEST(tiny_ed25519, rfc8032_verify) {
+  for (const auto& v : vectors) {
+    std::string sig = unhex(v.signature);
+    std::string pub = unhex(v.pub);
+    std::string msg = unhex(v.message);
+
+    EXPECT_TRUE(verify(sig, pub, msg));
+
+    std::string bad_r = sig;
+    bad_r[3] ^= 0x10;
+    EXPECT_FALSE(verify(bad_r, pub, msg));
+
+    std::string bad_s = sig;
+    bad_s[40] ^= 0x01;
+    EXPECT_FALSE(verify(bad_s, pub, msg));
+
+    EXPECT_FALSE(verify(sig, pub, msg + "x"));
+  }
+}
+
+TEST(tiny_ed25519, batch_verify) {
+  const int num = 3;
+  if (ED25519_BATCH_MAX < num) {
+    return;
+  }
+
+  std::string msgs[num] = {"", "root metadata", "targets metadata, somewhat longer than the others"};
+  uint8_t pubs[num][EDSIGN_PUBLIC_KEY_SIZE];
+  uint8_t sigs[num][EDSIGN_SIGNATURE_SIZE];
+  struct sha512_state states[num];
+  struct edsign_batch_item items[num];
+
+  for (int i = 0; i < num; i++) {
+    uint8_t secret[EDSIGN_SECRET_KEY_SIZE];
+    memset(secret, i + 1, sizeof(secret));
+    edsign_sec_to_pub(pubs[i], secret);
+    edsign_sign(sigs[i], pubs[i], secret, reinterpret_cast<const uint8_t*>(msgs[i].c_str()), msgs[i].length());
+
+    items[i].s = &states[i];
+    items[i].signature = sigs[i];
+    items[i].pub = pubs[i];
+    items[i].unpacked = NULL;
+  }
+
+  auto hash_all = [&]() {
+    for (int i = 0; i < num; i++) {
+      edsign_verify_hash_init(&states[i], sigs[i], pubs[i], reinterpret_cast<const uint8_t*>(msgs[i].c_str()),
+                              msgs[i].length());
+    }
+  };
+
+  hash_all();
+  EXPECT_TRUE(edsign_verify_batch(items, num));
+  EXPECT_FALSE(edsign_verify_batch(items, 0));
+
+  // one bad signature fails the batch, the single checks find it
+  sigs[1][40] ^= 0x01;
+  hash_all();
+  EXPECT_FALSE(edsign_verify_batch(items, num));
+  EXPECT_TRUE(edsign_verify_hashed(&states[0], sigs[0], pubs[0], NULL));
+  EXPECT_FALSE(edsign_verify_hashed(&states[1], sigs[1], pubs[1], NULL));
+  EXPECT_TRUE(edsign_verify_hashed(&states[2], sigs[2], pubs[2], NULL));
+  sigs[1][40] ^= 0x01;
+
+  // same with unpacked keys
+  uint8_t unpacked[num][EDSIGN_UNPACKED_PUB_SIZE];
+  for (int i = 0; i < num; i++) {
+    EXPECT_TRUE(edsign_unpack_pub(unpacked[i], pubs[i]));
+    items[i].unpacked = unpacked[i];
+  }
+  hash_all();
+  EXPECT_TRUE(edsign_verify_batch(items, num));
+
+  // swapped signatures
+  std::swap(items[0].signature, items[2].signature);
+  EXPECT_FALSE(edsign_verify_batch(items, num));
+}
+
+// S + l instead of S, a second signature that the group law alone would accept
+static std::string add_order(const std::string& sig) {
+  const std::string l = unhex("edd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010");
+  std::string res = sig;
+  unsigned int carry = 0;
+  for (int i = 0; i < 32; i++) {
+    carry += static_cast<uint8_t>(sig[32 + i]) + static_cast<uint8_t>(l[i]);
+    res[32 + i] = static_cast<char>(carry);
+    carry >>= 8;
+  }
+  return res;
+}
+
+TEST(tiny_ed25519, non_canonical_s) {
+  struct edsign_verify_ws ws;
+
+  for (const auto& v : vectors) {
+    std::string sig = add_order(unhex(v.signature));
+    std::string pub = unhex(v.pub);
+    std::string msg = unhex(v.message);
+    const uint8_t* sig_p = reinterpret_cast<const uint8_t*>(sig.c_str());
+    const uint8_t* pub_p = reinterpret_cast<const uint8_t*>(pub.c_str());
+    struct sha512_state s;
+
+    EXPECT_FALSE(verify(sig, pub, msg));
+    edsign_verify_hash_init(&s, sig_p, pub_p, reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length());
+    EXPECT_FALSE(edsign_verify_hashed(&s, sig_p, pub_p, NULL));
+    EXPECT_FALSE(edsign_verify_hashed_ws(&ws, &s, sig_p, pub_p, NULL));
+#if ED25519_BATCH_MAX > 0
+    struct edsign_batch_item item = {&s, sig_p, pub_p, NULL};
+    EXPECT_FALSE(edsign_verify_batch(&item, 1));
+#endif
+  }
+}
+
+TEST(tiny_ed25519, unpacked_pub) {
+  for (const auto& v : vectors) {
+    std::string sig = unhex(v.signature);
+    std::string pub = unhex(v.pub);
+    std::string msg = unhex(v.message);
+    const uint8_t* sig_p = reinterpret_cast<const uint8_t*>(sig.c_str());
+    const uint8_t* pub_p = reinterpret_cast<const uint8_t*>(pub.c_str());
+    uint8_t unpacked[EDSIGN_UNPACKED_PUB_SIZE];
+    struct sha512_state s;
+
+    EXPECT_TRUE(edsign_unpack_pub(unpacked, pub_p));
+    edsign_verify_hash_init(&s, sig_p, pub_p, reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length());
+    EXPECT_TRUE(edsign_verify_hashed(&s, sig_p, pub_p, unpacked));
+    EXPECT_TRUE(edsign_verify_hashed(&s, sig_p, pub_p, NULL));
+
+    // the cached point is what is checked against
+    uint8_t other[EDSIGN_UNPACKED_PUB_SIZE];
+    EXPECT_TRUE(edsign_unpack_pub(other, reinterpret_cast<const uint8_t*>(unhex(vectors[0].pub).c_str())));
+    if (pub != unhex(vectors[0].pub)) {
+      EXPECT_FALSE(edsign_verify_hashed(&s, sig_p, pub_p, other));
+    }
+  }
+
+  // y = 2 is not on the curve
+  uint8_t bad_pub[EDSIGN_PUBLIC_KEY_SIZE] = {2};
+  uint8_t unpacked[EDSIGN_UNPACKED_PUB_SIZE];
+  EXPECT_FALSE(edsign_unpack_pub(unpacked, bad_pub));
+}
+
+TEST(tiny_ed25519, verify_workspace) {
+  struct edsign_verify_ws ws[2];
+
+  for (const auto& v : vectors) {
+    std::string sig = unhex(v.signature);
+    std::string pub = unhex(v.pub);
+    std::string msg = unhex(v.message);
+    const uint8_t* sig_p = reinterpret_cast<const uint8_t*>(sig.c_str());
+    const uint8_t* pub_p = reinterpret_cast<const uint8_t*>(pub.c_str());
+    struct sha512_state s;
+
+    edsign_verify_hash_init(&s, sig_p, pub_p, reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length());
+    EXPECT_TRUE(edsign_verify_hashed_ws(&ws[0], &s, sig_p, pub_p, NULL));
+
+    // leftovers of another check make no difference
+    memset(&ws[1], 0xa5, EDSIGN_VERIFY_WS_SIZE);
+    EXPECT_TRUE(edsign_verify_hashed_ws(&ws[1], &s, sig_p, pub_p, NULL));
+
+    std::string bad_s = sig;
+    bad_s[40] ^= 0x01;
+    EXPECT_FALSE(edsign_verify_hashed_ws(&ws[0], &s, reinterpret_cast<const uint8_t*>(bad_s.c_str()), pub_p, NULL));
+  }
+}
+
+TEST(tiny_ed25519, verify_steps) {
+  struct edsign_batch_item items[3];
+  struct sha512_state s[3];
+  std::string sigs[3];
+  std::string pubs[3];
+
+  for (int i = 0; i < 3; i++) {
+    sigs[i] = unhex(vectors[i].signature);
+    pubs[i] = unhex(vectors[i].pub);
+    std::string msg = unhex(vectors[i].message);
+    const uint8_t* sig_p = reinterpret_cast<const uint8_t*>(sigs[i].c_str());
+    const uint8_t* pub_p = reinterpret_cast<const uint8_t*>(pubs[i].c_str());
+
+    edsign_verify_hash_init(&s[i], sig_p, pub_p, reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length());
+    items[i].s = &s[i];
+    items[i].signature = sig_p;
+    items[i].pub = pub_p;
+    items[i].unpacked = NULL;
+
+    int res;
+    int steps = 0;
+    edsign_verify_start(&s[i], sig_p, pub_p, NULL);
+    while ((res = edsign_verify_step()) == EDSIGN_STEP_PENDING) {
+      ++steps;
+    }
+    EXPECT_EQ(res, 1);
+    EXPECT_GT(steps, 200);
+    EXPECT_LT(steps, 300);
+
+    // nothing in progress
+    EXPECT_EQ(edsign_verify_step(), 0);
+  }
+
+#if ED25519_BATCH_MAX >= 3
+  int res;
+  ASSERT_TRUE(edsign_verify_batch_start(items, 3));
+  while ((res = edsign_verify_step()) == EDSIGN_STEP_PENDING) {
+  }
+  EXPECT_EQ(res, 1);
+
+  std::swap(items[0].signature, items[2].signature);
+  ASSERT_TRUE(edsign_verify_batch_start(items, 3));
+  while ((res = edsign_verify_step()) == EDSIGN_STEP_PENDING) {
+  }
+  EXPECT_EQ(res, 0);
+#endif
+  EXPECT_FALSE(edsign_verify_batch_start(items, ED25519_BATCH_MAX + 1));
+}
+
+#ifdef ED25519_REENTRANT
+TEST(tiny_ed25519, verify_threads) {
+  std::vector<std::thread> threads;
+  std::atomic<int> failures(0);
+
+  for (const auto& v : vectors) {
+    threads.emplace_back([&v, &failures]() {
+      std::string sig = unhex(v.signature);
+      std::string pub = unhex(v.pub);
+      std::string msg = unhex(v.message);
+      const uint8_t* sig_p = reinterpret_cast<const uint8_t*>(sig.c_str());
+      const uint8_t* pub_p = reinterpret_cast<const uint8_t*>(pub.c_str());
+      struct edsign_verify_ws ws;
+      struct sha512_state s;
+
+      for (int i = 0; i < 50; i++) {
+        edsign_verify_hash_init(&s, sig_p, pub_p, reinterpret_cast<const uint8_t*>(msg.c_str()), msg.length());
+        if (!edsign_verify_hashed_ws(&ws, &s, sig_p, pub_p, NULL)) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  EXPECT_EQ(failures, 0);
+}
+#endif
+
+TEST(tiny_ed25519, fprime_order) {
+  // ed25519 group order l, reduced with the Barrett path
+  const std::string l = unhex("edd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010");
+  const uint8_t* order = reinterpret_cast<const uint8_t*>(l.c_str());
+  uint8_t x[64];
+  uint8_t a[FPRIME_SIZE], b[FPRIME_SIZE], r[FPRIME_SIZE];
+
+  memset(x, 0xff, sizeof(x));
+  fprime_from_bytes(a, x, sizeof(x), order);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(a), FPRIME_SIZE),
+            unhex("000f9c44e31106a447938568a71b0ed065bef517d273ecce3d9a307c1b419903"));
+
+  for (int i = 0; i < FPRIME_SIZE; i++) {
+    x[i] = (uint8_t)(i + 1);
+  }
+  fprime_from_bytes(b, x, FPRIME_SIZE, order);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(b), FPRIME_SIZE),
+            unhex("275a174ad03fe2575cd01bc64f1a51e61012131415161718191a1b1c1d1e1f00"));
+
+  fprime_mul(r, a, b, order);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(r), FPRIME_SIZE),
+            unhex("50326830114156ebc7541bf2ce7b266dbfd7dade6577e148432033136462b402"));
+
+  // (l - 1)^2 = 1
+  memcpy(a, order, FPRIME_SIZE);
+  a[0]--;
+  fprime_mul(r, a, a, order);
+  EXPECT_EQ(0, memcmp(r, fprime_one, FPRIME_SIZE));
+}
+
+TEST(tiny_ed25519, smult_base) {
+  for (int n = 0; n < 8; n++) {
+    uint8_t e[ED25519_EXPONENT_SIZE];
+
+    for (int i = 0; i < ED25519_EXPONENT_SIZE; i++) {
+      e[i] = (uint8_t)(n * 53 + i * 7 + 3);
+    }
+    if (n == 0) {
+      memset(e, 0xff, sizeof(e));
+    }
+
+    struct ed25519_pt expected;
+    struct ed25519_pt result;
+    ed25519_smult(&expected, &ed25519_base, e);
+    ed25519_smult_base(&result, e);
+
+    uint8_t ex[F25519_SIZE], ey[F25519_SIZE], rx[F25519_SIZE], ry[F25519_SIZE];
+    ed25519_unproject(ex, ey, &expected);
+    ed25519_unproject(rx, ry, &result);
+    EXPECT_EQ(0, memcmp(ex, rx, F25519_SIZE));
+    EXPECT_EQ(0, memcmp(ey, ry, F25519_SIZE));
+  }
+}
+
+TEST(tiny_ed25519, double_smult) {
+  uint8_t k[ED25519_EXPONENT_SIZE];
+  struct ed25519_pt a;
+
+  for (int i = 0; i < ED25519_EXPONENT_SIZE; i++) {
+    k[i] = (uint8_t)(i * 37 + 11);
+  }
+  ed25519_smult(&a, &ed25519_base, k);
+
+  for (int n = 0; n < 8; n++) {
+    uint8_t e1[ED25519_EXPONENT_SIZE];
+    uint8_t e2[ED25519_EXPONENT_SIZE];
+
+    for (int i = 0; i < ED25519_EXPONENT_SIZE; i++) {
+      e1[i] = (uint8_t)(n * 91 + i * 13);
+      e2[i] = (uint8_t)(n * 17 + i * 29 + 5);
+    }
+    // all-ones exponents need an extra NAF digit
+    if (n == 0) {
+      memset(e1, 0xff, sizeof(e1));
+      memset(e2, 0xff, sizeof(e2));
+    }
+
+    struct ed25519_pt expected;
+    struct ed25519_pt tmp;
+    ed25519_smult(&expected, &ed25519_base, e1);
+    ed25519_smult(&tmp, &a, e2);
+    ed25519_add(&expected, &expected, &tmp);
+
+    struct ed25519_pt result;
+    ed25519_double_smult(&result, e1, &ed25519_base, e2, &a);
+
+    uint8_t ex[F25519_SIZE], ey[F25519_SIZE], rx[F25519_SIZE], ry[F25519_SIZE];
+    ed25519_unproject(ex, ey, &expected);
+    ed25519_unproject(rx, ry, &result);
+    EXPECT_EQ(0, memcmp(ex, rx, F25519_SIZE));
+    EXPECT_EQ(0, memcmp(ey, ry, F25519_SIZE));
+  }
+}
+
+TEST(tiny_ed25519, multi_smult_chunked) {
+  // more points than there are tables for, so they are summed in several passes
+  const unsigned int n = 2 * ED25519_MSM_MAX + 1;
+  uint8_t e[n][ED25519_EXPONENT_SIZE];
+  struct ed25519_pt p[n];
+  const uint8_t* ep[n];
+  const struct ed25519_pt* pp[n];
+
+  struct ed25519_pt expected;
+  ed25519_copy(&expected, &ed25519_neutral);
+  for (unsigned int j = 0; j < n; j++) {
+    uint8_t k[ED25519_EXPONENT_SIZE];
+    for (int i = 0; i < ED25519_EXPONENT_SIZE; i++) {
+      k[i] = (uint8_t)(j * 53 + i * 37 + 11);
+      e[j][i] = (uint8_t)(j * 91 + i * 13 + 7);
+    }
+    ed25519_smult(&p[j], &ed25519_base, k);
+    ep[j] = e[j];
+    pp[j] = &p[j];
+
+    struct ed25519_pt tmp;
+    ed25519_smult(&tmp, &p[j], e[j]);
+    ed25519_add(&expected, &expected, &tmp);
+  }
+
+  // the result may overwrite a point it is computed from, here one that only the last pass reads
+  ed25519_multi_smult(&p[n - 1], ep, pp, n);
+
+  uint8_t ex[F25519_SIZE], ey[F25519_SIZE], rx[F25519_SIZE], ry[F25519_SIZE];
+  ed25519_unproject(ex, ey, &expected);
+  ed25519_unproject(rx, ry, &p[n - 1]);
+  EXPECT_EQ(0, memcmp(ex, rx, F25519_SIZE));
+  EXPECT_EQ(0, memcmp(ey, ry, F25519_SIZE));
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
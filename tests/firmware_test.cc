@@ -13,16 +13,165 @@ TEST(firmware, verify_nostate) {
   uint16_t result = 0x0000;
   uptane_targets_t targets;
 
-  uptane_parse_targets_feed(targets_str.c_str(), (int16_t) targets_str.length(), &targets, &result);
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t) targets_str.length(), &targets, &result);
   ASSERT_EQ(result, RESULT_END_FOUND);
   state_set_targets(&targets);
 
   std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
   ASSERT_TRUE(uptane_verify_firmware_init());
   uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), firmware.length());
+  EXPECT_FALSE(uptane_verify_firmware_busy());  // the software backend hashes synchronously
   EXPECT_TRUE(uptane_verify_firmware_finalize());
 }
 
+extern "C" crypto_hash_algorithm_t test_supported_hash;
+
+TEST(firmware, verify_sha256) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  uint16_t result = 0x0000;
+  uptane_targets_t targets;
+
+  uptane_parse_targets_init();
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t) targets_str.length(), &targets, &result);
+  ASSERT_EQ(result, RESULT_END_FOUND);
+  state_set_targets(&targets);
+
+  test_supported_hash = CRYPTO_HASH_SHA256;
+  std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), 3);
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()) + 3, firmware.length() - 3);
+  EXPECT_TRUE(uptane_verify_firmware_finalize());
+
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  std::string bad = firmware;
+  bad[0] ^= 0x01;
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(bad.c_str()), bad.length());
+  EXPECT_FALSE(uptane_verify_firmware_finalize());
+  test_supported_hash = CRYPTO_HASH_SHA512;
+}
+
+TEST(firmware, resume) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  uint16_t result = 0x0000;
+  uptane_targets_t targets;
+
+  uptane_parse_targets_init();
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t) targets_str.length(), &targets, &result);
+  ASSERT_EQ(result, RESULT_END_FOUND);
+  state_set_targets(&targets);
+
+  std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
+  EXPECT_FALSE(uptane_verify_firmware_resume());
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), 5);
+  uptane_verify_firmware_checkpoint(5, 1);
+
+  // the transfer breaks off, the hash goes on with other data meanwhile
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>("garbage"), 7);
+
+  const uptane_transfer_checkpoint_t* checkpoint = uptane_firmware_checkpoint();
+  ASSERT_NE(checkpoint, nullptr);
+  EXPECT_EQ(checkpoint->offset, 5);
+  EXPECT_EQ(checkpoint->chunks, 1);
+  ASSERT_TRUE(uptane_verify_firmware_resume());
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()) + 5, firmware.length() - 5);
+  EXPECT_TRUE(uptane_verify_firmware_finalize());
+
+  // the checkpoint is for the target it was made for only
+  uptane_targets_t other = targets;
+  other.hashes[0].hash[0] ^= 0x01;
+  other.hashes[1].hash[0] ^= 0x01;
+  state_set_targets(&other);
+  EXPECT_EQ(uptane_firmware_checkpoint(), nullptr);
+  EXPECT_FALSE(uptane_verify_firmware_resume());
+
+  state_set_targets(&targets);
+  uptane_firmware_confirm();
+  EXPECT_EQ(uptane_firmware_checkpoint(), nullptr);
+}
+
+TEST(firmware, too_large) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  uint16_t result = 0x0000;
+  uptane_targets_t targets;
+
+  uptane_parse_targets_init();
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t) targets_str.length(), &targets, &result);
+  ASSERT_EQ(result, RESULT_END_FOUND);
+  state_set_targets(&targets);
+
+  uptane_installation_state_t installed;
+  memset(&installed, 0, sizeof(installed));
+  state_set_installation_state(&installed);
+
+  std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
+  uint32_t received, expected;
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  EXPECT_TRUE(uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), 10));
+  uptane_verify_firmware_progress(&received, &expected);
+  EXPECT_EQ(received, 10);
+  EXPECT_EQ(expected, firmware.length());
+
+  // one byte too many is refused at once, and so is everything after it
+  std::string longer = firmware + "x";
+  EXPECT_FALSE(uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(longer.c_str()) + 10, 6));
+  EXPECT_EQ(state_get_installation_state()->attack, ATTACK_IMAGE_LARGE);
+  EXPECT_FALSE(uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()) + 10, 5));
+  uptane_verify_firmware_progress(&received, &expected);
+  EXPECT_EQ(received, 10);
+  EXPECT_FALSE(uptane_verify_firmware_finalize());
+
+  // a short image fails too
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  EXPECT_TRUE(uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), 14));
+  EXPECT_FALSE(uptane_verify_firmware_finalize());
+}
+
+TEST(firmware, boot_check) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  uint16_t result = 0x0000;
+  uptane_targets_t targets;
+
+  uptane_parse_targets_init();
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t) targets_str.length(), &targets, &result);
+  ASSERT_EQ(result, RESULT_END_FOUND);
+  state_set_targets(&targets);
+  // nothing installed yet
+  uptane_installation_state_t installed;
+  memset(&installed, 0, sizeof(installed));
+  state_set_installation_state(&installed);
+  EXPECT_TRUE(uptane_verify_installed_image(nullptr));
+
+  std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), 4);
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()) + 4, firmware.length() - 4);
+  ASSERT_TRUE(uptane_verify_firmware_finalize());
+  uptane_firmware_confirm();
+  EXPECT_EQ(state_get_installation_state()->image_crc, 0x4e9f42e7);
+  EXPECT_TRUE(uptane_verify_installed_image(reinterpret_cast<const uint8_t*>(firmware.c_str())));
+
+  std::string bad = firmware;
+  bad[3] ^= 0x01;
+  EXPECT_FALSE(uptane_verify_installed_image(reinterpret_cast<const uint8_t*>(bad.c_str())));
+
+  // a wrong CRC-32 alone falls back to the hash, which puts the right one in place
+  installed = *state_get_installation_state();
+  installed.image_crc = 0;
+  state_set_installation_state(&installed);
+  EXPECT_TRUE(uptane_verify_installed_image(reinterpret_cast<const uint8_t*>(firmware.c_str())));
+  EXPECT_EQ(state_get_installation_state()->image_crc, 0x4e9f42e7);
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
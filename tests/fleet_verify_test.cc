@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "libuptiny-primary/fleet_verify.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+#define NUM_SECONDARIES 40
+
+// secondary i is uptane_secondary_1 for i == own, with hwid, the others have no target; every tenth trusts bad_root
+static std::vector<uptane_fleet_result_t> verify_for_fleet(const std::string& targets_str, unsigned int own,
+                                                           const char* hwid, uptane_root_t* bad_root) {
+  static std::vector<std::string> ecuids;
+  std::vector<uptane_fleet_secondary_t> secondaries(NUM_SECONDARIES);
+  std::vector<uptane_fleet_result_t> results(NUM_SECONDARIES);
+
+  ecuids.clear();
+  for (unsigned int i = 0; i < NUM_SECONDARIES; ++i) {
+    ecuids.push_back((i == own) ? "uptane_secondary_1" : "secondary_" + std::to_string(i));
+  }
+  for (unsigned int i = 0; i < NUM_SECONDARIES; ++i) {
+    secondaries[i].ecu = {ecuids[i].c_str(), ecuids[i].length(), hwid, strlen(hwid)};
+    secondaries[i].root = (i % 10 == 9) ? bad_root : nullptr;
+  }
+  EXPECT_TRUE(uptane_fleet_verify_targets(targets_str.c_str(), targets_str.length(), secondaries.data(),
+                                          NUM_SECONDARIES, results.data(), 4));
+  return results;
+}
+
+TEST(tiny_fleet_verify, results_per_secondary) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  // the same key ID with another key
+  uptane_root_t bad_root = *state_get_root();
+  crypto_key_t bad_key = *bad_root.targets_keys[0];
+  bad_key.keyval[0] ^= 1;
+  crypto_key_prepare(&bad_key);
+  bad_root.targets_keys[0] = &bad_key;
+
+  std::vector<uptane_fleet_result_t> results = verify_for_fleet(targets_str, 0, "test_uptane_secondary", &bad_root);
+  EXPECT_EQ(results[0].result, RESULT_END_FOUND);
+  EXPECT_EQ(std::string(results[0].targets.name), std::string("secondary_firmware.txt"));
+  EXPECT_EQ(results[0].targets.length, 15);
+  for (unsigned int i = 1; i < NUM_SECONDARIES; ++i) {
+    if (i % 10 == 9) {
+      EXPECT_EQ(results[i].result, RESULT_SIGNATURES_FAILED);
+    } else {
+      EXPECT_EQ(results[i].result, RESULT_END_NOT_FOUND);
+      EXPECT_EQ(results[i].targets.version, 2);
+      EXPECT_EQ(results[i].targets.expires.year, 3021);
+    }
+  }
+
+  // a wrong hardware ID only fails the secondary it is for
+  results = verify_for_fleet(targets_str, 13, "another_test_uptane_secondary", &bad_root);
+  EXPECT_EQ(results[13].result, RESULT_WRONG_HW_ID);
+  EXPECT_EQ(results[12].result, RESULT_END_NOT_FOUND);
+  EXPECT_EQ(results[14].result, RESULT_END_NOT_FOUND);
+  EXPECT_EQ(results[19].result, RESULT_SIGNATURES_FAILED);
+}
+
+TEST(tiny_fleet_verify, forged) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  targets_json["signed"]["targets"]["secondary_firmware.txt"]["length"] = 16;
+
+  std::vector<uptane_fleet_result_t> results =
+      verify_for_fleet(Utils::jsonToCanonicalStr(targets_json), 0, "test_uptane_secondary", nullptr);
+  for (unsigned int i = 0; i < NUM_SECONDARIES; ++i) {
+    EXPECT_EQ(results[i].result, RESULT_SIGNATURES_FAILED);
+  }
+
+  results = verify_for_fleet("{\"signed\":{}}", 0, "test_uptane_secondary", nullptr);
+  for (unsigned int i = 0; i < NUM_SECONDARIES; ++i) {
+    EXPECT_EQ(results[i].result, RESULT_ERROR);
+  }
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -0,0 +1,89 @@
+// Replays a corpus of metadata through the parsers and prints the smallest pool sizes that would have done, as the
+// settings of libuptiny/uptiny_config.h. Built with UPTANE_POOL_STATS, on the test environment with its own pools as
+// the upper limit:
+//
+//   uptiny_pool_sizing [--chunk <bytes>] <metadata.json>...
+//
+// Roots are parsed whole, in order, and become the trusted root for the files that follow. Targets are fed in chunks
+// like on an ECU. Failed signature checks don't matter for the sizes, running out of a pool does. The keys of all roots
+// stay allocated, so give the old and the new root of a rotation to size the key pool for it.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "libuptiny/common_data_api.h"
+#include "libuptiny/pool.h"
+#include "libuptiny/root.h"
+#include "libuptiny/targets.h"
+#include "utilities/utils.h"
+
+static bool replay_targets(const std::string& targets_str, unsigned int chunk_size) {
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+  std::string buf;
+
+  uptane_parse_targets_init();
+  for (size_t i = 0; i < targets_str.length() && result == RESULT_IN_PROGRESS; i += chunk_size) {
+    buf += targets_str.substr(i, chunk_size);
+    int consumed = uptane_parse_targets_feed(buf.c_str(), buf.length(), &targets, &result);
+    if (consumed > 0) {
+      buf = buf.substr(consumed);
+    }
+  }
+  while (uptane_parse_targets_busy()) {
+  }
+  return result != RESULT_OUT_OF_TOKENS;
+}
+
+static void replay_root(const std::string& root_str) {
+  static uptane_root_t root;
+
+  if (uptane_parse_root(root_str.c_str(), root_str.length(), &root)) {
+    state_set_root(&root);
+  }
+}
+
+static void recommend(const char* name, unsigned int peak, unsigned int size, bool exhausted) {
+  std::cout << name << " " << peak;
+  if (exhausted || peak >= size) {
+    std::cout << " (the test pool of " << size << " ran out, this is a lower bound)";
+  }
+  std::cout << std::endl;
+}
+
+int main(int argc, char** argv) {
+  unsigned int chunk_size = 64;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "--chunk" && i + 1 < argc) {
+      chunk_size = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else {
+      files.emplace_back(argv[i]);
+    }
+  }
+  if (files.empty() || chunk_size == 0) {
+    std::cerr << "Usage: " << argv[0] << " [--chunk <bytes>] <metadata.json>..." << std::endl;
+    return 1;
+  }
+
+  bool out_of_tokens = false;
+  uptane_pool_reset_peaks();
+  for (const auto& file : files) {
+    Json::Value json = Utils::parseJSONFile(file);
+    std::string str = Utils::jsonToCanonicalStr(json);
+    if (json["signed"]["_type"].asString() == "Root") {
+      replay_root(str);
+    } else if (!replay_targets(str, chunk_size)) {
+      std::cerr << file << ": out of tokens" << std::endl;
+      out_of_tokens = true;
+    }
+  }
+
+  recommend("UPTINY_TOKEN_POOL_SIZE", uptane_pool_peaks.tokens, token_pool_size, out_of_tokens);
+  recommend("UPTINY_SIGNATURE_POOL_SIZE", uptane_pool_peaks.signatures, signature_pool_size, false);
+  recommend("UPTINY_CRYPTO_CTX_POOL_SIZE", uptane_pool_peaks.crypto_ctxs, crypto_ctx_pool_size, false);
+  std::cout << "UPTINY_KEY_POOL_SIZE " << uptane_pool_peaks.keys << std::endl;
+  return out_of_tokens ? 2 : 0;
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include "libuptiny/pool.h"
+
+struct block {
+  uint32_t data[3];
+};
+
+UPTANE_POOL(test_pool, struct block, 5);
+
+TEST(tinypool, alloc_free) {
+  uptane_pool_free_all(&test_pool);
+
+  void* blocks[5];
+  for (int i = 0; i < 5; ++i) {
+    blocks[i] = uptane_pool_alloc(&test_pool);
+    ASSERT_NE(blocks[i], nullptr);
+    EXPECT_EQ(blocks[i], &test_pool_blocks[i]);
+    EXPECT_EQ(uptane_pool_index(&test_pool, blocks[i]), i);
+  }
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), nullptr);
+
+  uptane_pool_free(&test_pool, blocks[3]);
+  uptane_pool_free(&test_pool, blocks[1]);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), blocks[1]);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), blocks[3]);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), nullptr);
+
+  uptane_pool_free_all(&test_pool);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), blocks[0]);
+}
+
+TEST(tinypool, foreign_blocks) {
+  uptane_pool_free_all(&test_pool);
+
+  struct block other;
+  void* first = uptane_pool_alloc(&test_pool);
+  EXPECT_EQ(uptane_pool_index(&test_pool, &other), -1);
+  EXPECT_EQ(uptane_pool_index(&test_pool, reinterpret_cast<uint8_t*>(first) + 1), -1);
+
+  // neither frees anything
+  uptane_pool_free(&test_pool, &other);
+  uptane_pool_free(&test_pool, reinterpret_cast<uint8_t*>(first) + 1);
+  EXPECT_NE(uptane_pool_alloc(&test_pool), first);
+}
+
+TEST(tinypool, free_mask) {
+  uptane_pool_free_all(&test_pool);
+
+  void* blocks[5];
+  for (int i = 0; i < 5; ++i) {
+    blocks[i] = uptane_pool_alloc(&test_pool);
+  }
+  uptane_pool_free(&test_pool, blocks[2]);
+
+  // block 2 is free already, bits past the pool are ignored
+  uptane_pool_free_mask(&test_pool, (1u << 0) | (1u << 2) | (1u << 4) | (1u << 7));
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), blocks[0]);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), blocks[2]);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), blocks[4]);
+  EXPECT_EQ(uptane_pool_alloc(&test_pool), nullptr);
+#ifdef UPTANE_POOL_STATS
+  EXPECT_EQ(test_pool.used, 5);
+#endif
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+#endif
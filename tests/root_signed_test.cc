@@ -1,10 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <cstring>
 #include <string>
 
 #include "jsmn.h"
 #include "libuptiny/root_signed.h"
 #include "libuptiny/common_data_api.h"
+#include "libuptiny/crypto_common.h"
 #include "logging/logging.h"
 #include "utilities/utils.h"
 
@@ -36,7 +38,7 @@ TEST(tiny_root_signed, parse_simple) {
   int parsed = jsmn_parse(&parser, signed_root_str.c_str(), signed_root_str.length(), token_pool, token_pool_size);
 
   EXPECT_GT(parsed, 0);
-  int16_t idx = 0;
+  jsmnint_t idx = 0;
   uptane_root_t root;
   EXPECT_TRUE(uptane_parse_root_signed (signed_root_str.c_str(), &idx, &root));
   check_root(root);
@@ -59,12 +61,57 @@ TEST(tiny_root_signed, parse_with_garbage) {
   int parsed = jsmn_parse(&parser, signed_root_str.c_str(), signed_root_str.length(), token_pool, token_pool_size);
 
   EXPECT_GT(parsed, 0);
-  int16_t idx = 0;
+  jsmnint_t idx = 0;
   uptane_root_t root;
   EXPECT_TRUE(uptane_parse_root_signed (signed_root_str.c_str(), &idx, &root));
   check_root(root);
 }
 
+TEST(tiny_root_signed, parse_many_keys) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  Json::Value signed_root = root_json["signed"];
+  const std::string orig_id = "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  Json::Value key = signed_root["keys"][orig_id];
+  static const char *extra_ids[] = {
+      "ff0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2",
+      "000a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2",
+      "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c1",
+      "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c3",
+  };
+  Json::Value keyids(Json::arrayValue);
+  for (const char *id : extra_ids) {
+    signed_root["keys"][id] = key;
+    keyids.append(id);
+  }
+  keyids.append(orig_id);
+  keyids.append(orig_id);  // listed twice, counted once
+  keyids.append("1111111111111111111111111111111111111111111111111111111111111111");  // unknown
+  signed_root["roles"]["targets"]["keyids"] = keyids;
+  std::string signed_root_str = Utils::jsonToStr(signed_root);
+
+  jsmn_parser parser;
+  jsmn_init(&parser);
+
+  int parsed = jsmn_parse(&parser, signed_root_str.c_str(), signed_root_str.length(), token_pool, token_pool_size);
+
+  EXPECT_GT(parsed, 0);
+  jsmnint_t idx = 0;
+  uptane_root_t root;
+  EXPECT_TRUE(uptane_parse_root_signed(signed_root_str.c_str(), &idx, &root));
+  EXPECT_EQ(root.root_keys_num, 1);
+  ASSERT_EQ(root.targets_keys_num, 5);
+  for (int i = 1; i < root.targets_keys_num; ++i) {
+    EXPECT_LT(memcmp(root.targets_keys[i - 1]->keyid, root.targets_keys[i]->keyid, CRYPTO_KEYID_LEN), 0);
+  }
+  for (const char *id : extra_ids) {
+    crypto_key_t *found = find_key(id, 2 * CRYPTO_KEYID_LEN, root.targets_keys, root.targets_keys_num);
+    ASSERT_TRUE(found != nullptr);
+    EXPECT_EQ(found->key_type, CRYPTO_ALG_ED25519);
+  }
+  EXPECT_TRUE(find_key(orig_id.c_str(), 2 * CRYPTO_KEYID_LEN, root.root_keys, root.root_keys_num) != nullptr);
+  EXPECT_TRUE(find_key(extra_ids[0], 2 * CRYPTO_KEYID_LEN, root.root_keys, root.root_keys_num) == nullptr);
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
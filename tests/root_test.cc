@@ -1,5 +1,11 @@
 #include <gtest/gtest.h>
+
+#include <boost/algorithm/hex.hpp>
+
+#include "libuptiny/base64.h"
+#include "libuptiny/crypto_api.h"
 #include "libuptiny/root.h"
+#include "libuptiny/signatures.h"
 
 #include "logging/logging.h"
 #include "utilities/utils.h"
@@ -31,6 +37,266 @@ TEST(tiny_root, parse_simple) {
   check_root(root);
 }
 
+// feeds the message in chunks of chunk_size, keeping the unconsumed part in front of the next chunk
+static uint16_t feed_root(const std::string& message, size_t chunk_size, uptane_root_t* root) {
+  std::string buf;
+  uint16_t result = ROOT_RESULT_IN_PROGRESS;
+  for (size_t i = 0; i < message.length(); i += chunk_size) {
+    buf += message.substr(i, chunk_size);
+    int consumed = uptane_parse_root_feed(buf.c_str(), buf.length(), root, &result);
+    if (result != ROOT_RESULT_IN_PROGRESS) {
+      break;
+    }
+    EXPECT_GE(consumed, 0);
+    buf.erase(0, consumed);
+  }
+  return result;
+}
+
+TEST(tiny_root, parse_chunked) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  std::string root_str = Utils::jsonToCanonicalStr(root_json);
+
+  for (size_t chunk_size : {1, 7, 64, 255}) {
+    static uptane_root_t root;
+    uptane_parse_root_init();
+    // the signing key stays in the new root, so its signature counts for both and one pass is enough
+    ASSERT_EQ(feed_root(root_str, chunk_size, &root), ROOT_RESULT_END);
+    check_root(root);
+  }
+}
+
+TEST(tiny_root, over_budget) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  std::string root_str = Utils::jsonToCanonicalStr(root_json);
+
+  for (size_t chunk_size : {1, 64, 255}) {
+    static uptane_root_t root;
+    uptane_parse_root_init();
+    uptane_parse_root_set_budget(root_str.length());
+    EXPECT_EQ(feed_root(root_str, chunk_size, &root), ROOT_RESULT_END);
+
+    state_set_attack(ATTACK_NONE);
+    uptane_parse_root_init();
+    uptane_parse_root_set_budget(root_str.length() - 1);
+    EXPECT_EQ(feed_root(root_str, chunk_size, &root), ROOT_RESULT_TOO_LARGE);
+    EXPECT_EQ(state_get_installation_state()->attack, ATTACK_ROOT_LARGE);
+  }
+}
+
+static Json::Value sign_root(const Json::Value& signed_root, const std::string& keyid, const std::string& key_dir) {
+  std::string priv = boost::algorithm::unhex(Utils::readFile(key_dir + "/private.key"));
+  std::string pub = boost::algorithm::unhex(Utils::readFile(key_dir + "/public.key"));
+  crypto_key_t key;
+  memcpy(key.keyval, pub.c_str(), CRYPTO_KEYVAL_LEN);
+  crypto_key_and_signature_t sig;
+  sig.key = &key;
+  std::string signed_str = Utils::jsonToCanonicalStr(signed_root);
+  crypto_sign_data(signed_str.c_str(), signed_str.length(), &sig, reinterpret_cast<const uint8_t*>(priv.c_str()));
+
+  char sig_b64[BASE64_ENCODED_BUF_SIZE(CRYPTO_MAX_SIGNATURE_LEN)];
+  base64_encode(sig.sig, CRYPTO_MAX_SIGNATURE_LEN, sig_b64);
+  Json::Value res;
+  res["keyid"] = keyid;
+  res["method"] = "ed25519";
+  res["sig"] = sig_b64;
+  return res;
+}
+
+TEST(tiny_root, parse_rotated) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  const std::string old_id = "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string new_id = "ff0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  Json::Value signed_root = root_json["signed"];
+  signed_root["keys"][new_id]["keytype"] = "ED25519";
+  signed_root["keys"][new_id]["keyval"]["public"] = Utils::readFile("tests/repo/keys/image/public.key");
+  signed_root["roles"]["root"]["keyids"].append(new_id);
+  signed_root["roles"]["root"]["threshold"] = 2;
+  signed_root["version"] = 2;
+
+  root_json["signed"] = signed_root;
+  root_json["signatures"][0] = sign_root(signed_root, old_id, "tests/repo/keys/director");
+  root_json["signatures"][1] = sign_root(signed_root, new_id, "tests/repo/keys/image");
+  std::string root_str = Utils::jsonToCanonicalStr(root_json);
+
+  static uptane_root_t root;
+  uptane_parse_root_init();
+  ASSERT_EQ(feed_root(root_str, 64, &root), ROOT_RESULT_FEED_AGAIN);
+  ASSERT_EQ(feed_root(root_str, 64, &root), ROOT_RESULT_END);
+  // the signature by the old key was checked on the first pass and counted for the new root too
+  EXPECT_EQ(uptane_get_signatures_report()->num_signatures, 1);
+  EXPECT_EQ(root.root_keys_num, 2);
+  EXPECT_EQ(root.root_threshold, 2);
+
+  // the second pass has to see the same signed object
+  root_json["signed"]["version"] = 3;
+  std::string changed_str = Utils::jsonToCanonicalStr(root_json);
+  uptane_parse_root_init();
+  ASSERT_EQ(feed_root(root_str, 64, &root), ROOT_RESULT_FEED_AGAIN);
+  EXPECT_EQ(feed_root(changed_str, 64, &root), ROOT_RESULT_SIGNATURES_FAILED);
+
+  // without the new key's signature the new threshold isn't met
+  root_json = Json::Value();
+  root_json["signed"] = signed_root;
+  root_json["signatures"][0] = sign_root(signed_root, old_id, "tests/repo/keys/director");
+  EXPECT_FALSE(uptane_parse_root(Utils::jsonToCanonicalStr(root_json).c_str(),
+                                 Utils::jsonToCanonicalStr(root_json).length(), &root));
+
+  // nor with the old key's signature twice, the copy with S + l in place of S so that its bytes differ
+  std::string sig = Utils::fromBase64(root_json["signatures"][0]["sig"].asString());
+  const std::string l = boost::algorithm::unhex(std::string("edd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010"));
+  unsigned int carry = 0;
+  for (int i = 0; i < 32; i++) {
+    carry += (uint8_t)sig[32 + i] + (uint8_t)l[i];
+    sig[32 + i] = (char)carry;
+    carry >>= 8;
+  }
+  root_json["signatures"][1] = root_json["signatures"][0];
+  root_json["signatures"][1]["sig"] = Utils::toBase64(sig);
+  root_str = Utils::jsonToCanonicalStr(root_json);
+  EXPECT_FALSE(uptane_parse_root(root_str.c_str(), root_str.length(), &root));
+  EXPECT_FALSE(uptane_parse_root_buffered(root_str.c_str(), root_str.length(), &root));
+}
+
+// keys of an unknown type or with a public value of the wrong length are left out of the roles
+TEST(tiny_root, parse_bad_keys) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  const std::string old_id = "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string long_id = "ee0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string prefix_id = "ff0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string pub = Utils::readFile("tests/repo/keys/image/public.key");
+  Json::Value signed_root = root_json["signed"];
+  signed_root["keys"][long_id]["keytype"] = "ed25519";
+  signed_root["keys"][long_id]["keyval"]["public"] = pub + pub;
+  signed_root["keys"][prefix_id]["keytype"] = "ed";
+  signed_root["keys"][prefix_id]["keyval"]["public"] = pub;
+  signed_root["roles"]["targets"]["keyids"].append(long_id);
+  signed_root["roles"]["targets"]["keyids"].append(prefix_id);
+
+  root_json["signed"] = signed_root;
+  root_json["signatures"][0] = sign_root(signed_root, old_id, "tests/repo/keys/director");
+  std::string root_str = Utils::jsonToCanonicalStr(root_json);
+
+  static uptane_root_t root;
+  ASSERT_TRUE(uptane_parse_root(root_str.c_str(), root_str.length(), &root));
+  check_root(root);
+}
+
+// the same checks with the signatures verified one after another in crypto_ctx_pool[0]
+TEST(tiny_root, parse_buffered) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  std::string root_str = Utils::jsonToCanonicalStr(root_json);
+  static uptane_root_t root;
+  ASSERT_TRUE(uptane_parse_root_buffered(root_str.c_str(), root_str.length(), &root));
+  check_root(root);
+
+  const std::string old_id = "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string new_id = "ff0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  Json::Value signed_root = root_json["signed"];
+  signed_root["keys"][new_id]["keytype"] = "ED25519";
+  signed_root["keys"][new_id]["keyval"]["public"] = Utils::readFile("tests/repo/keys/image/public.key");
+  signed_root["roles"]["root"]["keyids"].append(new_id);
+  signed_root["roles"]["root"]["threshold"] = 2;
+  signed_root["version"] = 2;
+  root_json["signed"] = signed_root;
+  root_json["signatures"][0] = sign_root(signed_root, new_id, "tests/repo/keys/image");
+  root_json["signatures"][1] = sign_root(signed_root, old_id, "tests/repo/keys/director");
+  root_str = Utils::jsonToCanonicalStr(root_json);
+  ASSERT_TRUE(uptane_parse_root_buffered(root_str.c_str(), root_str.length(), &root));
+  EXPECT_EQ(root.root_keys_num, 2);
+  EXPECT_EQ(root.root_threshold, 2);
+
+  // a bad signature by the new key fails the second pass
+  root_json["signatures"][0]["sig"] = root_json["signatures"][1]["sig"];
+  root_str = Utils::jsonToCanonicalStr(root_json);
+  EXPECT_FALSE(uptane_parse_root_buffered(root_str.c_str(), root_str.length(), &root));
+}
+
+// N+1.root.json to N+k.root.json, each checked against the one before, the last one stored
+TEST(tiny_root, parse_chain) {
+  const uptane_root_t saved = *state_get_root();
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  const std::string first_str = Utils::jsonToCanonicalStr(root_json);
+  const std::string old_id = "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string new_id = "ff0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  Json::Value signed_root = root_json["signed"];
+  signed_root["keys"][new_id]["keytype"] = "ED25519";
+  signed_root["keys"][new_id]["keyval"]["public"] = Utils::readFile("tests/repo/keys/image/public.key");
+  signed_root["roles"]["root"]["keyids"].append(new_id);
+  signed_root["roles"]["root"]["threshold"] = 2;
+  signed_root["version"] = 2;
+  root_json["signed"] = signed_root;
+  root_json["signatures"][0] = sign_root(signed_root, old_id, "tests/repo/keys/director");
+  root_json["signatures"][1] = sign_root(signed_root, new_id, "tests/repo/keys/image");
+  const std::string second_str = Utils::jsonToCanonicalStr(root_json);
+
+  // version 2 doesn't follow the stored version 0
+  static uptane_root_t root;
+  uptane_root_chain_begin();
+  ASSERT_TRUE(uptane_parse_root(second_str.c_str(), second_str.length(), &root));
+  EXPECT_FALSE(uptane_root_chain_next(&root));
+  EXPECT_FALSE(uptane_root_chain_end(false));
+  EXPECT_EQ(state_get_root()->version, 0);
+
+  uptane_root_chain_begin();
+  ASSERT_TRUE(uptane_parse_root(first_str.c_str(), first_str.length(), &root));
+  ASSERT_TRUE(uptane_root_chain_next(&root));
+  // the stored root's key is taken over rather than prepared again
+  EXPECT_EQ(root.root_keys[0], saved.root_keys[0]);
+  ASSERT_TRUE(uptane_parse_root(second_str.c_str(), second_str.length(), &root));
+  ASSERT_TRUE(uptane_root_chain_next(&root));
+  EXPECT_EQ(root.root_keys_num, 2);
+  EXPECT_EQ(state_get_root()->version, 0);
+  EXPECT_TRUE(uptane_root_chain_end(true));
+  EXPECT_EQ(state_get_root()->version, 2);
+  EXPECT_EQ(state_get_root()->root_threshold, 2);
+
+  state_set_root(&saved);
+}
+
+// a root that is only parsed frees none of the stored root's keys, and the keys both roots have are shared rather
+// than prepared again
+TEST(tiny_root, key_generations) {
+  const uptane_root_t saved = *state_get_root();
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  const std::string old_id = "a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  const std::string new_id = "ff0a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2";
+  Json::Value signed_root = root_json["signed"];
+  signed_root["keys"][new_id]["keytype"] = "ED25519";
+  signed_root["keys"][new_id]["keyval"]["public"] = Utils::readFile("tests/repo/keys/image/public.key");
+  signed_root["roles"]["root"]["keyids"].append(new_id);
+  signed_root["roles"]["root"]["threshold"] = 2;
+  std::string root_str[2];
+  for (int i = 0; i < 2; ++i) {
+    signed_root["version"] = 2 + i;
+    root_json["signed"] = signed_root;
+    root_json["signatures"][0] = sign_root(signed_root, old_id, "tests/repo/keys/director");
+    root_json["signatures"][1] = sign_root(signed_root, new_id, "tests/repo/keys/image");
+    root_str[i] = Utils::jsonToCanonicalStr(root_json);
+  }
+
+  static uptane_root_t root;
+  ASSERT_TRUE(uptane_parse_root(root_str[0].c_str(), root_str[0].length(), &root));
+  ASSERT_EQ(root.root_keys_num, 2);
+  EXPECT_EQ(root.root_keys[0], saved.root_keys[0]);
+  state_set_root(&root);
+  crypto_key_t *const new_key = state_get_root()->root_keys[1];
+  crypto_key_t new_copy = *new_key;
+
+  ASSERT_TRUE(uptane_parse_root(root_str[1].c_str(), root_str[1].length(), &root));
+  EXPECT_EQ(root.root_keys[1], new_key);
+  // version 3 isn't stored, the next parse drops it
+  uptane_parse_root_init();
+  ASSERT_EQ(state_get_root()->root_keys[1], new_key);
+  EXPECT_EQ(memcmp(new_key, &new_copy, sizeof(new_copy)), 0);
+  ASSERT_TRUE(uptane_parse_root(root_str[1].c_str(), root_str[1].length(), &root));
+  EXPECT_EQ(root.root_keys[1], new_key);
+  state_set_root(&root);
+  EXPECT_EQ(state_get_root()->version, 3);
+  EXPECT_EQ(state_get_root()->root_keys[1], new_key);
+
+  state_set_root(&saved);
+}
 
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
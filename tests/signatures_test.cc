@@ -19,7 +19,7 @@ TEST(tiny_signatures, parse_simple) {
   int parsed = jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size);
   EXPECT_GT(parsed, 0);
 
-  int16_t token_idx = 0;
+  jsmnint_t token_idx = 0;
   EXPECT_EQ(uptane_parse_signatures(ROLE_ROOT, signatures_str.c_str(), &token_idx, sigs, 10, state_get_root()), 1);
   EXPECT_TRUE(sigs[0].key != nullptr);
   EXPECT_EQ(sigs[0].key->key_type, CRYPTO_ALG_ED25519);
@@ -44,7 +44,7 @@ TEST(tiny_signatures, parse_one_of_two) {
   int parsed = jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size);
   EXPECT_GT(parsed, 0);
 
-  int16_t token_idx = 0;
+  jsmnint_t token_idx = 0;
   EXPECT_EQ(uptane_parse_signatures(ROLE_ROOT, signatures_str.c_str(), &token_idx, sigs, 10, state_get_root()), 1);
   EXPECT_TRUE(sigs[0].key != nullptr);
   EXPECT_TRUE(sigs[0].key->key_type == CRYPTO_ALG_ED25519);
@@ -75,7 +75,7 @@ TEST(tiny_signatures, parse_plus_garbage) {
   int parsed = jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size);
   EXPECT_GT(parsed, 0);
 
-  int16_t token_idx = 0;
+  jsmnint_t token_idx = 0;
   EXPECT_EQ(uptane_parse_signatures(ROLE_ROOT, signatures_str.c_str(), &token_idx, sigs, 10, state_get_root()), 1);
   EXPECT_TRUE(sigs[0].key != nullptr);
   EXPECT_TRUE(sigs[0].key->key_type == CRYPTO_ALG_ED25519);
@@ -84,6 +84,117 @@ TEST(tiny_signatures, parse_plus_garbage) {
   EXPECT_EQ(sig_in_str, sig_parsed);
 }
 
+// a key's signature counts once however often it is repeated, the repeats are not even decoded
+TEST(tiny_signatures, parse_repeated_key) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  Json::Value signatures = root_json["signatures"];
+  signatures.append(signatures[0]);
+  signatures.append(signatures[0]);
+  signatures[2]["sig"] = "not even base64";
+  std::string signatures_str = Utils::jsonToStr(signatures);
+  crypto_key_and_signature_t sigs[10];
+
+  jsmn_parser parser;
+  jsmn_init(&parser);
+  int parsed = jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size);
+  EXPECT_GT(parsed, 0);
+
+  jsmnint_t token_idx = 0;
+  EXPECT_EQ(uptane_parse_signatures(ROLE_ROOT, signatures_str.c_str(), &token_idx, sigs, 10, state_get_root()), 1);
+  EXPECT_EQ(token_idx, static_cast<jsmnint_t>(parsed));
+  std::string sig_in_str = Utils::fromBase64("wfL5Ydvn83bKK1byanOYcTC9+4TK4EVnK+GadhgFJ3VxjO//jY/zIz4ChiiR9DBU59ZUiTF3IICvZVFUt4DTAg==");
+  EXPECT_EQ(sig_in_str, std::string(reinterpret_cast<char*>(sigs[0].sig), CRYPTO_MAX_SIGNATURE_LEN));
+
+  // a signature by a key already taken is not usable on its own either
+  jsmn_init(&parser);
+  parsed = jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size);
+  token_idx = 1;
+  crypto_key_and_signature_t sig;
+  EXPECT_EQ(uptane_parse_signature(ROLE_ROOT, signatures_str.c_str(), &token_idx, &sig, sigs, 1, state_get_root()), 0);
+  token_idx = 1;
+  EXPECT_EQ(uptane_parse_signature(ROLE_ROOT, signatures_str.c_str(), &token_idx, &sig, sigs, 0, state_get_root()), 1);
+}
+
+static void feed_signatures(const std::string& signed_str, const crypto_key_and_signature_t* sigs, int num) {
+  for (int i = 0; i < num; ++i) {
+    signature_pool[i] = sigs[i];
+    crypto_verify_init(crypto_ctx_pool[i], &signature_pool[i]);
+    crypto_verify_feed(crypto_ctx_pool[i], reinterpret_cast<const uint8_t*>(signed_str.c_str()), signed_str.length());
+  }
+}
+
+TEST(tiny_signatures, verify_threshold) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  std::string signatures_str = Utils::jsonToStr(root_json["signatures"]);
+  std::string signed_str = Utils::jsonToCanonicalStr(root_json["signed"]);
+  crypto_key_and_signature_t sigs[3];
+
+  jsmn_parser parser;
+  jsmn_init(&parser);
+  EXPECT_GT(jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size), 0);
+  jsmnint_t token_idx = 0;
+  ASSERT_EQ(uptane_parse_signatures(ROLE_ROOT, signatures_str.c_str(), &token_idx, sigs, 1, state_get_root()), 1);
+  ASSERT_GE(signature_pool_size, 3u);
+  ASSERT_GE(crypto_ctx_pool_size, 3u);
+
+  crypto_key_and_signature_t bad = sigs[0];
+  bad.sig[40] ^= 0x01;
+
+  // threshold is met by the first signature, the rest is not checked
+  sigs[1] = sigs[0];
+  sigs[2] = sigs[0];
+  feed_signatures(signed_str, sigs, 3);
+  EXPECT_EQ(uptane_verify_signatures_result(3, 1), 1);
+  EXPECT_EQ(uptane_get_signatures_report()->num_checked, 1);
+  EXPECT_EQ(uptane_get_signatures_report()->num_signatures, 3);
+
+  feed_signatures(signed_str, sigs, 3);
+  EXPECT_EQ(uptane_verify_signatures_result(3, 3), 3);
+  EXPECT_EQ(uptane_get_signatures_report()->num_checked, 3);
+
+  // two bad signatures out of three make a threshold of 2 unreachable
+  sigs[0] = bad;
+  sigs[1] = bad;
+  feed_signatures(signed_str, sigs, 3);
+  EXPECT_LT(uptane_verify_signatures_result(3, 2), 2);
+  EXPECT_EQ(uptane_get_signatures_report()->num_checked, 2);
+
+  // threshold larger than number of signatures, nothing to check
+  feed_signatures(signed_str, sigs, 3);
+  EXPECT_EQ(uptane_verify_signatures_result(3, 4), 0);
+  EXPECT_EQ(uptane_get_signatures_report()->num_checked, 0);
+}
+
+static int yields;
+static void count_yield(void) { ++yields; }
+
+TEST(tiny_signatures, verify_yield) {
+  Json::Value root_json = Utils::parseJSONFile("tests/repo/repo/director/1.root.json");
+  std::string signatures_str = Utils::jsonToStr(root_json["signatures"]);
+  std::string signed_str = Utils::jsonToCanonicalStr(root_json["signed"]);
+  crypto_key_and_signature_t sigs[2];
+
+  jsmn_parser parser;
+  jsmn_init(&parser);
+  EXPECT_GT(jsmn_parse(&parser, signatures_str.c_str(), signatures_str.length(), token_pool, token_pool_size), 0);
+  jsmnint_t token_idx = 0;
+  ASSERT_EQ(uptane_parse_signatures(ROLE_ROOT, signatures_str.c_str(), &token_idx, sigs, 1, state_get_root()), 1);
+  sigs[1] = sigs[0];
+
+  // a signature takes a few hundred steps, the hook is called between slices of them
+  yields = 0;
+  uptane_set_verify_yield(count_yield);
+  feed_signatures(signed_str, sigs, 2);
+  EXPECT_EQ(uptane_verify_signatures_result(2, 2), 2);
+  EXPECT_GT(yields, 200 / UPTANE_VERIFY_SLICE);
+
+  uptane_set_verify_yield(NULL);
+  yields = 0;
+  feed_signatures(signed_str, sigs, 2);
+  EXPECT_EQ(uptane_verify_signatures_result(2, 2), 2);
+  EXPECT_EQ(yields, 0);
+}
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "ed25519/edsign.h"
+#include "libuptiny/firmware.h"
+#include "libuptiny/manifest.h"
+#include "libuptiny/root.h"
+#include "libuptiny/stack_peak.h"
+#include "libuptiny/state_api.h"
+#include "libuptiny/targets.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+// Worst-case stack depth of the public entry points on the test metadata, recorded as test properties
+// (--gtest_output=xml) to size the stack of an ECU. The numbers are of the host build, on the ECU they differ with the
+// compiler and the word size but keep their proportions.
+
+// Painted below every entry point, more than any of them takes
+static const size_t kPaintSize = 64 * 1024;
+
+static void record(const char* name, size_t peak) {
+  ::testing::Test::RecordProperty(name, static_cast<int>(peak));
+  EXPECT_GT(peak, 0U);
+  EXPECT_LT(peak, kPaintSize);
+}
+
+TEST(tiny_stack, parse_root) {
+  std::string root_str = Utils::jsonToCanonicalStr(Utils::parseJSONFile("tests/repo/repo/director/1.root.json"));
+  static uptane_root_t root;
+
+  uptane_stack_paint(kPaintSize);
+  bool valid = uptane_parse_root(root_str.c_str(), static_cast<jsmnint_t>(root_str.length()), &root);
+  size_t peak = uptane_stack_peak();
+
+  EXPECT_TRUE(valid);
+  record("uptane_parse_root", peak);
+}
+
+TEST(tiny_stack, parse_targets) {
+  std::string targets_str =
+      Utils::jsonToCanonicalStr(Utils::parseJSONFile("tests/repo/repo/director/targets.json"));
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+
+  uptane_parse_targets_init();
+  uptane_stack_paint(kPaintSize);
+  uptane_parse_targets_feed(targets_str.c_str(), static_cast<jsmnint_t>(targets_str.length()), &targets, &result);
+  while (uptane_parse_targets_busy()) {
+  }
+  size_t peak = uptane_stack_peak();
+
+  EXPECT_EQ(result, RESULT_END_FOUND);
+  record("uptane_parse_targets_feed", peak);
+  state_set_targets(&targets);
+}
+
+// in chunks like on an ECU, the parser state is kept between the calls
+TEST(tiny_stack, parse_targets_chunked) {
+  std::string targets_str =
+      Utils::jsonToCanonicalStr(Utils::parseJSONFile("tests/repo/repo/director/targets.json"));
+  const char* message = targets_str.c_str();
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+  size_t offset = 0;
+  size_t avail = 0;
+
+  uptane_parse_targets_init();
+  uptane_stack_paint(kPaintSize);
+  while (result == RESULT_IN_PROGRESS && avail < targets_str.length()) {
+    avail = std::min(avail + 64, targets_str.length());
+    int consumed =
+        uptane_parse_targets_feed(message + offset, static_cast<jsmnint_t>(avail - offset), &targets, &result);
+    if (consumed > 0) {
+      offset += static_cast<size_t>(consumed);
+    }
+  }
+  while (uptane_parse_targets_busy()) {
+  }
+  size_t peak = uptane_stack_peak();
+
+  EXPECT_EQ(result, RESULT_END_FOUND);
+  record("uptane_parse_targets_feed_chunked", peak);
+}
+
+TEST(tiny_stack, verify_firmware) {
+  std::string firmware = Utils::readFile("tests/repo/repo/image/targets/secondary_firmware.txt");
+
+  ASSERT_TRUE(uptane_verify_firmware_init());
+  uptane_stack_paint(kPaintSize);
+  uptane_verify_firmware_feed(reinterpret_cast<const uint8_t*>(firmware.c_str()), firmware.length());
+  bool valid = uptane_verify_firmware_finalize();
+  size_t peak = uptane_stack_peak();
+
+  EXPECT_TRUE(valid);
+  record("uptane_verify_firmware", peak);
+}
+
+TEST(tiny_stack, write_manifest) {
+  static char signatures_buf[1000];
+  static char signed_buf[1000];
+
+  uptane_stack_paint(kPaintSize);
+  uptane_write_manifest(signed_buf, signatures_buf);
+  size_t peak = uptane_stack_peak();
+
+  record("uptane_write_manifest", peak);
+}
+
+TEST(tiny_stack, edsign) {
+  static const uint8_t message[] = "stack depth of ed25519";
+  uint8_t secret[EDSIGN_SECRET_KEY_SIZE];
+  uint8_t pub[EDSIGN_PUBLIC_KEY_SIZE];
+  uint8_t signature[EDSIGN_SIGNATURE_SIZE];
+  struct sha512_state s;
+
+  memset(secret, 0x5a, sizeof(secret));
+  uptane_stack_paint(kPaintSize);
+  edsign_sec_to_pub(pub, secret);
+  size_t peak = uptane_stack_peak();
+  record("edsign_sec_to_pub", peak);
+
+  uptane_stack_paint(kPaintSize);
+  edsign_sign(signature, pub, secret, message, sizeof(message));
+  peak = uptane_stack_peak();
+  record("edsign_sign", peak);
+
+  uptane_stack_paint(kPaintSize);
+  uint8_t valid = edsign_verify_init(&s, signature, pub, message, sizeof(message));
+  peak = uptane_stack_peak();
+  EXPECT_TRUE(valid);
+  record("edsign_verify", peak);
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
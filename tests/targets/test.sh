@@ -9,9 +9,9 @@ PRIVATE=$(echo ${PAIR} | cut -d : -f1)
 PUBLIC=$(echo ${PAIR} | cut -d : -f2)
 KEYID=$(echo -n "{\"keytype\":\"ed25519\",\"keyval\":\"${PUBLIC}\"}" | sha256sum | cut -d " " -f1)
 if [ "$1" = "pass" ]; then
-	SIGNATURE=$(./sign ${PUBLIC} ${PRIVATE} $2)
+	SIGNATURE=$(./sign ${PUBLIC} ${PRIVATE} $2 | xxd -r -p | base64 -w 0)
 else
-	SIGNATURE=$(xxd -l 64 -c 64 -p /dev/urandom)
+	SIGNATURE=$(head -c 64 /dev/urandom | base64 -w 0)
 fi
 
 DATA=$(cat $2)
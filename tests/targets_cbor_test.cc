@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <boost/algorithm/hex.hpp>
+
+#include "libuptiny/targets_cbor.h"
+#include "libuptiny/common_data_api.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+static void put_head(std::string& out, unsigned int major, uint32_t arg) {
+  uint8_t initial = static_cast<uint8_t>(major << 5);
+  if (arg < 24) {
+    out += static_cast<char>(initial | arg);
+  } else if (arg <= 0xff) {
+    out += static_cast<char>(initial | 24);
+    out += static_cast<char>(arg);
+  } else if (arg <= 0xffff) {
+    out += static_cast<char>(initial | 25);
+    out += static_cast<char>(arg >> 8);
+    out += static_cast<char>(arg);
+  } else {
+    out += static_cast<char>(initial | 26);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      out += static_cast<char>(arg >> shift);
+    }
+  }
+}
+
+static void put_string(std::string& out, unsigned int major, const std::string& str) {
+  put_head(out, major, str.length());
+  out += str;
+}
+
+// encodes JSON as CBOR, the strings in "hashes", "from" and "root" objects become the binary hashes
+static std::string to_cbor(const Json::Value& value, bool hex = false) {
+  std::string out;
+  if (value.isObject()) {
+    put_head(out, 5, value.size());
+    for (const std::string& name : value.getMemberNames()) {
+      put_string(out, 3, name);
+      out += to_cbor(value[name], hex || name == "hashes" || name == "from" || name == "root");
+    }
+  } else if (value.isArray()) {
+    put_head(out, 4, value.size());
+    for (const Json::Value& elem : value) {
+      out += to_cbor(elem);
+    }
+  } else if (value.isString()) {
+    if (hex) {
+      put_string(out, 2, boost::algorithm::unhex(value.asString()));
+    } else {
+      put_string(out, 3, value.asString());
+    }
+  } else if (value.isBool()) {
+    out += static_cast<char>(value.asBool() ? 0xf5 : 0xf4);
+  } else {
+    put_head(out, 0, value.asUInt());
+  }
+  return out;
+}
+
+// targets metadata with the CBOR encoding of signed_json as the signed part, signed with the director key
+static std::string make_targets(const Json::Value& signed_json, const std::string& before_signed = "") {
+  std::string signed_cbor = to_cbor(signed_json);
+  std::string priv = boost::algorithm::unhex(Utils::readFile("tests/repo/keys/director/private.key"));
+  std::string pub = boost::algorithm::unhex(Utils::readFile("tests/repo/keys/director/public.key"));
+  crypto_key_t key;
+  memcpy(key.keyval, pub.c_str(), CRYPTO_KEYVAL_LEN);
+  crypto_key_and_signature_t sig;
+  sig.key = &key;
+  crypto_sign_data(signed_cbor.c_str(), signed_cbor.length(), &sig, reinterpret_cast<const uint8_t*>(priv.c_str()));
+
+  std::string out;
+  put_head(out, 5, before_signed.empty() ? 2 : 3);
+  if (!before_signed.empty()) {
+    out += before_signed;
+  }
+  put_string(out, 3, "signatures");
+  put_head(out, 4, 1);
+  put_head(out, 5, 3);
+  put_string(out, 3, "keyid");
+  put_string(out, 2, boost::algorithm::unhex(std::string("a70a72561409b9e0bc67b7625865fed801a57771102514b6de5f3b85f1bf27c2")));
+  put_string(out, 3, "method");
+  put_string(out, 3, "ed25519");
+  put_string(out, 3, "sig");
+  put_string(out, 2, std::string(reinterpret_cast<const char*>(sig.sig), CRYPTO_MAX_SIGNATURE_LEN));
+  put_string(out, 3, "signed");
+  out += signed_cbor;
+  return out;
+}
+
+static uint16_t parse_with_chunk_size(const std::string& targets_cbor, unsigned int chunk_size,
+                                      uptane_targets_t* targets) {
+  uptane_parse_targets_cbor_init();
+  memset(targets, 0, sizeof(*targets));
+
+  std::string buf;
+  uint16_t result = RESULT_IN_PROGRESS;
+  for (unsigned int i = 0; i < targets_cbor.length() && result == RESULT_IN_PROGRESS; i += chunk_size) {
+    buf += targets_cbor.substr(i, chunk_size);
+    int consumed = uptane_parse_targets_cbor_feed(reinterpret_cast<const uint8_t*>(buf.c_str()), buf.length(),
+                                                  targets, &result);
+    if (consumed > 0) {
+      buf = buf.substr(consumed);
+    }
+  }
+  return result;
+}
+
+static void verify_targets(const std::string& targets_cbor) {
+  for (unsigned int chunk_size : {1U, 3U, 7U, 64U, static_cast<unsigned int>(targets_cbor.length())}) {
+    uptane_targets_t targets;
+    EXPECT_EQ(parse_with_chunk_size(targets_cbor, chunk_size, &targets), RESULT_END_FOUND);
+
+    EXPECT_EQ(targets.version, 2);
+    EXPECT_EQ(std::string(targets.name), std::string("secondary_firmware.txt"));
+    EXPECT_EQ(targets.hashes_num, 2);
+    EXPECT_EQ(targets.hashes[0].alg, CRYPTO_HASH_SHA256);
+    EXPECT_EQ(boost::algorithm::hex(std::string((const char*)targets.hashes[0].hash, 32)),
+              "1BBB15AA921FFFFD5079567D630F43298DBE5E7CBC1B14E0CCDD6718FDE28E47");
+    EXPECT_EQ(targets.hashes[1].alg, CRYPTO_HASH_SHA512);
+    EXPECT_EQ(targets.length, 15);
+    EXPECT_EQ(targets.expires.year, 3021);
+    EXPECT_EQ(targets.expires.month, 7);
+    EXPECT_EQ(targets.expires.day, 13);
+  }
+}
+
+TEST(tiny_targets_cbor, parse_simple) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_cbor = make_targets(targets_json["signed"]);
+  EXPECT_LT(targets_cbor.length(), Utils::jsonToCanonicalStr(targets_json).length() * 3 / 4);
+
+  verify_targets(targets_cbor);
+}
+
+TEST(tiny_targets_cbor, parse_with_garbage) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value signed_json = targets_json["signed"];
+  Json::Value large(Json::arrayValue);
+  for (int i = 0; i < 40; ++i) {
+    large[i]["name"] = std::string(i * 7, 'x');
+    large[i]["values"][0] = i * 1000;
+    large[i]["values"][1] = true;
+  }
+  signed_json["newsignedfield"]["large"] = large;
+  signed_json["targets"]["secondary_firmware.txt"]["custom"]["morecustom"]["key"] = "value";
+  signed_json["targets"]["secondary_firmware.txt"]["custom"]["ecuIdentifiers"]["uptane_secondary_1"]["key"] = "value";
+  Json::Value other = signed_json["targets"]["secondary_firmware.txt"];
+  other["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+  other["custom"]["ecuIdentifiers"]["uptane_secondary_2"]["hardwareId"] = "another_hardware";
+  signed_json["targets"]["other_firmware.txt"] = other;
+
+  std::string top_garbage;
+  put_string(top_garbage, 3, "newtopfield");
+  top_garbage += to_cbor(large);
+
+  verify_targets(make_targets(signed_json, top_garbage));
+}
+
+TEST(tiny_targets_cbor, parse_tampered) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_cbor = make_targets(targets_json["signed"]);
+  size_t length_pos = targets_cbor.find("length");
+  ASSERT_NE(length_pos, std::string::npos);
+  targets_cbor[length_pos + 6] = 16;  // "length": 16
+
+  uptane_targets_t targets;
+  EXPECT_EQ(parse_with_chunk_size(targets_cbor, 7, &targets), RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(parse_with_chunk_size(targets_cbor, targets_cbor.length(), &targets), RESULT_SIGNATURES_FAILED);
+}
+
+TEST(tiny_targets_cbor, parse_wrong_hwid) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value signed_json = targets_json["signed"];
+  signed_json["targets"]["secondary_firmware.txt"]["custom"]["ecuIdentifiers"]["uptane_secondary_1"]["hardwareId"] =
+      "another_hardware";
+
+  uptane_targets_t targets;
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_WRONG_HW_ID);
+}
+
+TEST(tiny_targets_cbor, parse_not_for_me) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value signed_json = targets_json["signed"];
+  signed_json["targets"]["secondary_firmware.txt"]["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+
+  uptane_targets_t targets;
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_END_NOT_FOUND);
+}
+
+TEST(tiny_targets_cbor, parse_delta) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value signed_json = targets_json["signed"];
+  Json::Value& delta = signed_json["targets"]["secondary_firmware.txt"]["custom"]["delta"];
+  delta["from"]["sha256"] = std::string(64, 'a');
+  delta["from"]["sha512"] = std::string(128, 'b');
+  delta["length"] = 7;
+
+  uptane_targets_t targets;
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_END_FOUND);
+  EXPECT_EQ(targets.length, 15);
+  EXPECT_EQ(targets.delta_length, 7);
+  EXPECT_EQ(targets.delta_base.alg, CRYPTO_HASH_SHA512);
+  EXPECT_EQ(targets.delta_base.hash[0], 0xbb);
+
+  delta.removeMember("length");
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_ERROR);
+}
+
+TEST(tiny_targets_cbor, parse_compression) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value signed_json = targets_json["signed"];
+  Json::Value& compression = signed_json["targets"]["secondary_firmware.txt"]["custom"]["compression"];
+  compression["method"] = "heatshrink";
+  compression["length"] = 11;
+
+  uptane_targets_t targets;
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_END_FOUND);
+  EXPECT_EQ(targets.compressed_length, 11);
+
+  compression["method"] = "lz4";
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_ERROR);
+}
+
+TEST(tiny_targets_cbor, parse_chunks) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value signed_json = targets_json["signed"];
+  Json::Value& chunks = signed_json["targets"]["secondary_firmware.txt"]["custom"]["chunks"];
+  chunks["size"] = 4;
+  chunks["root"]["sha512"] = std::string(128, 'd');
+
+  uptane_targets_t targets;
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_END_FOUND);
+  EXPECT_EQ(targets.chunk_size, 4);
+  EXPECT_EQ(targets.chunk_root.alg, CRYPTO_HASH_SHA512);
+  EXPECT_EQ(targets.chunk_root.hash[63], 0xdd);
+
+  chunks.removeMember("size");
+  EXPECT_EQ(parse_with_chunk_size(make_targets(signed_json), 7, &targets), RESULT_ERROR);
+}
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "libuptiny-primary/targets_stream.h"
+#include "libuptiny/common_data_api.h"
+#include "logging/logging.h"
+#include "utilities/utils.h"
+
+static uptane_targets_ctx_t ctx;
+
+static void init_ctx() {
+  uptane_targets_ctx_setup(&ctx, token_pool, token_pool_size, signature_pool, signature_pool_size, crypto_ctx_pool, 1,
+                           &hash_context, NULL);
+  uptane_targets_ctx_init(&ctx);
+}
+
+static std::string director_targets() {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  return Utils::jsonToCanonicalStr(targets_json);
+}
+
+TEST(tiny_targets_stream, parts_of_any_size) {
+  std::string targets_str = director_targets();
+
+  for (size_t part_size : {1, 7, 64, 1021, 65536}) {
+    init_ctx();
+    uptane_targets_t targets;
+    memset(&targets, 0, sizeof(targets));
+    uptiny::TargetsStream stream(ctx, targets);
+
+    for (size_t i = 0; i < targets_str.length() && !stream.done(); i += part_size) {
+      // a part of its own, gone after the feed
+      std::string part = targets_str.substr(i, part_size);
+      stream.feed(part);
+      EXPECT_LE(stream.carried(), TARGETS_SEGMENT_CARRY_SIZE);
+    }
+    EXPECT_EQ(stream.finish(), RESULT_END_FOUND) << part_size;
+    EXPECT_EQ(std::string(targets.name), "secondary_firmware.txt");
+    EXPECT_EQ(targets.length, 15);
+  }
+}
+
+TEST(tiny_targets_stream, truncated) {
+  std::string targets_str = director_targets();
+
+  init_ctx();
+  uptane_targets_t targets;
+  uptiny::TargetsStream stream(ctx, targets);
+  EXPECT_EQ(stream.feed(std::string_view(targets_str).substr(0, targets_str.length() / 2)), RESULT_IN_PROGRESS);
+  EXPECT_EQ(stream.finish(), RESULT_ERROR);
+}
+
+TEST(tiny_targets_stream, carry_too_small) {
+  std::string targets_str = director_targets();
+
+  // a target doesn't fit in 16 bytes
+  init_ctx();
+  uptane_targets_t targets;
+  uptiny::BasicTargetsStream<16> stream(ctx, targets);
+  for (size_t i = 0; i < targets_str.length() && !stream.done(); i += 8) {
+    stream.feed(std::string_view(targets_str).substr(i, 8));
+  }
+  EXPECT_EQ(stream.result(), RESULT_ERROR);
+}
+
+#ifdef UPTINY_TARGETS_STREAM_COROUTINES
+// A read that completes at once, or only when the test resumes the parse, like one waiting for a socket
+class PartSource {
+ public:
+  PartSource(std::string_view data, size_t part_size, bool suspend, std::coroutine_handle<>* waiting)
+      : data_(data), part_size_(part_size), suspend_(suspend), waiting_(waiting) {}
+
+  struct Read {
+    PartSource* source;
+    bool await_ready() const noexcept { return !source->suspend_; }
+    void await_suspend(std::coroutine_handle<> handle) const noexcept { *source->waiting_ = handle; }
+    uptiny::ByteSpan await_resume() const noexcept {
+      std::string_view part = source->data_.substr(0, source->part_size_);
+      source->data_.remove_prefix(part.length());
+      return uptiny::as_byte_span(part);
+    }
+  };
+  Read operator()() { return Read{this}; }
+
+ private:
+  std::string_view data_;
+  size_t part_size_;
+  bool suspend_;
+  std::coroutine_handle<>* waiting_;
+};
+
+static uptiny::TargetsParse await_parse(uptiny::TargetsStream& stream, PartSource source) {
+  co_return co_await uptiny::parse_targets(stream, source);
+}
+
+TEST(tiny_targets_stream, coroutine) {
+  std::string targets_str = director_targets();
+
+  for (bool suspend : {false, true}) {
+    init_ctx();
+    uptane_targets_t targets;
+    memset(&targets, 0, sizeof(targets));
+    uptiny::TargetsStream stream(ctx, targets);
+    std::coroutine_handle<> waiting;
+
+    uptiny::TargetsParse parse = await_parse(stream, PartSource(targets_str, 64, suspend, &waiting));
+    parse.resume();
+    unsigned int reads = 0;
+    while (!parse.done()) {
+      ASSERT_TRUE(suspend);
+      ++reads;
+      waiting.resume();
+    }
+    EXPECT_EQ(parse.await_resume(), RESULT_END_FOUND);
+    EXPECT_EQ(std::string(targets.name), "secondary_firmware.txt");
+    if (suspend) {
+      EXPECT_GE(reads, targets_str.length() / 64);
+    }
+  }
+
+  // the end of the data before the end of the metadata
+  init_ctx();
+  uptane_targets_t targets;
+  uptiny::TargetsStream stream(ctx, targets);
+  std::coroutine_handle<> waiting;
+  uptiny::TargetsParse parse =
+      uptiny::parse_targets(stream, PartSource(std::string_view(targets_str).substr(0, 100), 64, false, &waiting));
+  parse.resume();
+  ASSERT_TRUE(parse.done());
+  EXPECT_EQ(parse.await_resume(), RESULT_ERROR);
+}
+#endif
+
+#ifndef __NO_MAIN__
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  logger_init();
+  logger_set_threshold(boost::log::trivial::trace);
+  return RUN_ALL_TESTS();
+}
+#endif
@@ -1,28 +1,51 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
+#include <vector>
 #include <boost/algorithm/hex.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/case_conv.hpp>
 
 #include "libuptiny/targets.h"
 #include "libuptiny/common_data_api.h"
+#include "libuptiny/signatures.h"
+#include "libuptiny/state_api.h"
 #include "logging/logging.h"
 #include "utilities/utils.h"
 
 
-static void verify_targets_with_chunk_size(const std::string& targets_str, bool check_signatures, unsigned int chunk_size) {
+// ring_size > 0 keeps the unconsumed data in a ring buffer of that size and feeds it as segments instead
+static void verify_targets_with_chunk_size(const std::string& targets_str, bool check_signatures, unsigned int chunk_size,
+                                           unsigned int ring_size = 0) {
   uptane_parse_targets_init();
 
   uptane_targets_t targets;
   memset(&targets, 0, sizeof(targets));
 
   std::string buf;
+  std::vector<char> ring(ring_size);
+  unsigned int ring_head = 0;
+  unsigned int ring_count = 0;
   uint16_t result = 0x0000;
   for(unsigned int i = 0; i < targets_str.length(); i += chunk_size) {
-    buf += targets_str.substr(i, chunk_size); 
-
-    int consumed = uptane_parse_targets_feed(buf.c_str(), buf.length(), &targets, &result);
+    int consumed;
+    if (ring_size == 0) {
+      buf += targets_str.substr(i, chunk_size);
+      consumed = uptane_parse_targets_feed(buf.c_str(), buf.length(), &targets, &result);
+    } else {
+      std::string chunk = targets_str.substr(i, chunk_size);
+      ASSERT_LE(ring_count + chunk.length(), ring_size);
+      for (char c : chunk) {
+        ring[(ring_head + ring_count++) % ring_size] = c;
+      }
+      uptane_segment_t segments[2];
+      unsigned int first_len = std::min(ring_count, ring_size - ring_head);
+      segments[0] = {ring.data() + ring_head, (jsmnint_t)first_len};
+      segments[1] = {ring.data(), (jsmnint_t)(ring_count - first_len)};
+      consumed = uptane_parse_targets_feed_segments(segments, (ring_count > first_len) ? 2 : 1, &targets, &result);
+    }
 
     if (result == RESULT_ERROR) {
         LOG_ERROR << "uptane_parse_targets_feed returned error";
@@ -55,7 +78,12 @@ static void verify_targets_with_chunk_size(const std::string& targets_str, bool
       }
     }
     if(consumed > 0) {
-      buf = buf.substr(consumed);
+      if (ring_size == 0) {
+        buf = buf.substr(consumed);
+      } else {
+        ring_head = (ring_head + consumed) % ring_size;
+        ring_count -= consumed;
+      }
     }
   }
 
@@ -67,9 +95,11 @@ static void verify_targets_with_chunk_size(const std::string& targets_str, bool
 
   EXPECT_EQ(targets.version, 2);
   EXPECT_EQ(std::string(targets.name), std::string("secondary_firmware.txt"));
-  EXPECT_EQ(targets.hashes_num, 1);
-  EXPECT_EQ(targets.hashes[0].alg, CRYPTO_HASH_SHA512);
-  EXPECT_EQ(boost::algorithm::to_lower_copy(boost::algorithm::hex(std::string((const char*)targets.hashes[0].hash, 64))), "7dbae4c36a2494b731a9239911d3085d53d3e400886edb4ae2b9b78f40bda446649e83ba2d81653f614cc66f5dd5d4dbd95afba854f148afbfae48d0ff4cc38a");
+  EXPECT_EQ(targets.hashes_num, 2);
+  EXPECT_EQ(targets.hashes[0].alg, CRYPTO_HASH_SHA256);
+  EXPECT_EQ(boost::algorithm::to_lower_copy(boost::algorithm::hex(std::string((const char*)targets.hashes[0].hash, 32))), "1bbb15aa921ffffd5079567d630f43298dbe5e7cbc1b14e0ccdd6718fde28e47");
+  EXPECT_EQ(targets.hashes[1].alg, CRYPTO_HASH_SHA512);
+  EXPECT_EQ(boost::algorithm::to_lower_copy(boost::algorithm::hex(std::string((const char*)targets.hashes[1].hash, 64))), "7dbae4c36a2494b731a9239911d3085d53d3e400886edb4ae2b9b78f40bda446649e83ba2d81653f614cc66f5dd5d4dbd95afba854f148afbfae48d0ff4cc38a");
   EXPECT_EQ(targets.length, 15);
   EXPECT_EQ(targets.expires.year, 3021);
   EXPECT_EQ(targets.expires.month, 7);
@@ -87,6 +117,8 @@ static void verify_targets(const std::string& targets_str, bool check_signatures
   verify_targets_with_chunk_size(targets_str, check_signatures, 10);
   verify_targets_with_chunk_size(targets_str, check_signatures, 20);
   verify_targets_with_chunk_size(targets_str, check_signatures, (unsigned int) targets_str.length());
+  verify_targets_with_chunk_size(targets_str, check_signatures, 7, 1000);
+  verify_targets_with_chunk_size(targets_str, check_signatures, 64, 1021);
 }
 
 TEST(tiny_targets, parse_simple) {
@@ -96,6 +128,44 @@ TEST(tiny_targets, parse_simple) {
   verify_targets(targets_str, true);
 }
 
+// the signatures checked one after another over the signed part in the message, in a single verify context
+TEST(tiny_targets, parse_buffered) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  for (size_t chunk_size : {1, 7, 64, 4096}) {
+    static uptane_targets_ctx_t ctx;
+    uptane_targets_ctx_setup(&ctx, token_pool, token_pool_size, signature_pool, signature_pool_size, crypto_ctx_pool, 1,
+                             &hash_context, NULL);
+    uptane_targets_ctx_init(&ctx);
+    uptane_targets_ctx_signed_buffered(&ctx);
+
+    uptane_targets_t targets;
+    uint16_t result = RESULT_IN_PROGRESS;
+    size_t offset = 0;
+    size_t avail = 0;
+    while (result == RESULT_IN_PROGRESS && avail < targets_str.length()) {
+      avail = std::min(avail + chunk_size, targets_str.length());
+      int consumed = uptane_targets_ctx_feed(&ctx, targets_str.c_str() + offset, avail - offset, &targets, &result);
+      ASSERT_GE(consumed, 0);
+      offset += consumed;
+    }
+    EXPECT_EQ(result, RESULT_END_FOUND);
+    EXPECT_EQ(std::string(targets.name), "secondary_firmware.txt");
+    EXPECT_EQ(uptane_get_signatures_report()->num_checked, 1);
+  }
+
+  // a changed signed part fails
+  targets_json["signed"]["version"] = 3;
+  targets_str = Utils::jsonToCanonicalStr(targets_json);
+  uptane_parse_targets_init();
+  uptane_parse_targets_signed_buffered();
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+  uptane_parse_targets_feed(targets_str.c_str(), targets_str.length(), &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+}
+
 TEST(tiny_targets, parse_with_garbage) {
   Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
   targets_json["newtopfield"]["key"] = "value";
@@ -111,6 +181,472 @@ TEST(tiny_targets, parse_with_garbage) {
   verify_targets(targets_str, false);
 }
 
+TEST(tiny_targets, parse_large_ignored) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  // many more tokens than token_pool can hold, with brackets and escaped quotes inside strings
+  Json::Value large(Json::arrayValue);
+  for (int i = 0; i < 200; ++i) {
+    large[i]["name"] = "v}]\"{[" + std::to_string(i);
+    large[i]["values"][0] = i;
+    large[i]["values"][1] = true;
+    large[i]["values"][2]["nested"] = "\\";
+  }
+  targets_json["newtopfield"] = large;
+  targets_json["signed"]["newsignedfield"]["large"] = large;
+  targets_json["signed"]["newsignedprimitive"] = "value";
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  verify_targets(targets_str, false);
+}
+
+TEST(tiny_targets, parse_other_ecus) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value other = targets_json["signed"]["targets"]["secondary_firmware.txt"];
+  other["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+  other["custom"]["ecuIdentifiers"]["uptane_secondary_10"]["hardwareId"] = "test_uptane_secondary";
+  other["hashes"]["sha256"] = "not a hash";  // never looked at, the target is not for this ECU
+  for (int i = 0; i < 40; ++i) {
+    targets_json["signed"]["targets"]["other_firmware_" + std::to_string(i)] = other;
+  }
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  verify_targets(targets_str, false);
+}
+
+TEST(tiny_targets, parse_foreign_hashes_not_decoded) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value other = targets_json["signed"]["targets"]["secondary_firmware.txt"];
+  other["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+  other["custom"]["ecuIdentifiers"]["uptane_secondary_2"]["hardwareId"] = "test_uptane_secondary";
+  other["custom"]["note"] = "uptane_secondary_1";  // defeats the raw pre-scan, the target is walked
+  other["hashes"]["sha256"] = std::string(64, 'x');
+  targets_json["signed"]["targets"]["other_firmware"] = other;
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  verify_targets(targets_str, false);
+}
+
+static const uptane_ecu_t test_ecus[] = {
+    {"uptane_secondary_1", 18, "test_uptane_secondary", 21},
+    {"uptane_secondary_2", 18, "another_test_uptane_secondary", 29},
+    {"uptane_secondary_3", 18, "test_uptane_secondary", 21},
+};
+
+static uint16_t parse_for_ecus(const std::string& targets_str, uptane_targets_t* ecu_targets, bool* found) {
+  EXPECT_TRUE(uptane_parse_targets_init_ecus(test_ecus, 3, ecu_targets, found));
+  uptane_targets_t targets;
+  memset(&targets, 0, sizeof(targets));
+  uint16_t result = 0x0000;
+  uptane_parse_targets_feed(targets_str.c_str(), targets_str.length(), &targets, &result);
+  return result;
+}
+
+TEST(tiny_targets, parse_multiple_ecus) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  uptane_targets_t ecu_targets[3];
+  bool found[3];
+
+  EXPECT_EQ(parse_for_ecus(Utils::jsonToCanonicalStr(targets_json), ecu_targets, found), RESULT_END_FOUND);
+  EXPECT_TRUE(found[0]);
+  EXPECT_FALSE(found[1]);
+  EXPECT_FALSE(found[2]);
+  EXPECT_EQ(std::string(ecu_targets[0].name), std::string("secondary_firmware.txt"));
+  EXPECT_EQ(ecu_targets[0].version, 2);
+  EXPECT_EQ(ecu_targets[0].expires.year, 3021);
+  EXPECT_EQ(ecu_targets[0].length, 15);
+
+  Json::Value other = targets_json["signed"]["targets"]["secondary_firmware.txt"];
+  other["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+  other["custom"]["ecuIdentifiers"]["uptane_secondary_2"]["hardwareId"] = "another_test_uptane_secondary";
+  other["length"] = 42;
+  targets_json["signed"]["targets"]["other_firmware.txt"] = other;
+
+  // the signatures don't match anymore, but the targets are read before they are checked
+  EXPECT_EQ(parse_for_ecus(Utils::jsonToCanonicalStr(targets_json), ecu_targets, found), RESULT_SIGNATURES_FAILED);
+  EXPECT_TRUE(found[0]);
+  EXPECT_TRUE(found[1]);
+  EXPECT_FALSE(found[2]);
+  EXPECT_EQ(std::string(ecu_targets[0].name), std::string("secondary_firmware.txt"));
+  EXPECT_EQ(ecu_targets[0].length, 15);
+  EXPECT_EQ(std::string(ecu_targets[1].name), std::string("other_firmware.txt"));
+  EXPECT_EQ(ecu_targets[1].length, 42);
+
+  // two targets for the same ECU
+  other["custom"]["ecuIdentifiers"]["uptane_secondary_1"]["hardwareId"] = "test_uptane_secondary";
+  targets_json["signed"]["targets"]["other_firmware.txt"] = other;
+  EXPECT_EQ(parse_for_ecus(Utils::jsonToCanonicalStr(targets_json), ecu_targets, found), RESULT_ERROR);
+}
+
+static void parse_unsigned(const Json::Value& targets_json, uptane_targets_t* targets, uint16_t* result) {
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+  uptane_parse_targets_init();
+  memset(targets, 0, sizeof(*targets));
+  *result = 0x0000;
+  uptane_parse_targets_feed(targets_str.c_str(), targets_str.length(), targets, result);
+}
+
+static uint16_t parse_images(const Json::Value& targets_json, unsigned int chunk_size, uptane_targets_t* images,
+                             unsigned int max_images, unsigned int* num_images) {
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+  EXPECT_TRUE(uptane_parse_targets_init_images(images, max_images, num_images));
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+  std::string buf;
+  for (size_t i = 0; i < targets_str.length() && result == RESULT_IN_PROGRESS; i += chunk_size) {
+    buf += targets_str.substr(i, chunk_size);
+    int consumed = uptane_parse_targets_feed(buf.c_str(), buf.length(), &targets, &result);
+    if (consumed > 0) {
+      buf.erase(0, consumed);
+    }
+  }
+  return result;
+}
+
+TEST(tiny_targets, parse_images) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  uptane_targets_t images[3];
+  unsigned int num_images;
+
+  EXPECT_EQ(parse_images(targets_json, 64, images, 3, &num_images), RESULT_END_FOUND);
+  EXPECT_EQ(num_images, 1);
+  EXPECT_EQ(std::string(images[0].partition), std::string());
+  EXPECT_EQ(images[0].version, 2);
+
+  Json::Value script = targets_json["signed"]["targets"]["secondary_firmware.txt"];
+  script["custom"]["partition"] = "script";
+  script["length"] = 42;
+  Json::Value calibration = script;
+  calibration["custom"]["partition"] = "calibration";
+  calibration["length"] = 43;
+  targets_json["signed"]["targets"]["script.bin"] = script;
+  targets_json["signed"]["targets"]["calibration.bin"] = calibration;
+
+  // the signatures don't match anymore, but the targets are read before they are checked. The tokens of a target
+  // are released once it is read, so all of them are found with the default pool, whatever the chunks
+  for (unsigned int chunk_size : {7, 64, 4096}) {
+    EXPECT_EQ(parse_images(targets_json, chunk_size, images, 3, &num_images), RESULT_SIGNATURES_FAILED);
+    ASSERT_EQ(num_images, 3);
+    EXPECT_EQ(std::string(images[0].name), std::string("calibration.bin"));
+    EXPECT_EQ(std::string(images[0].partition), std::string("calibration"));
+    EXPECT_EQ(images[0].length, 43);
+    EXPECT_EQ(std::string(images[1].name), std::string("script.bin"));
+    EXPECT_EQ(std::string(images[1].partition), std::string("script"));
+    EXPECT_EQ(images[1].length, 42);
+    EXPECT_EQ(std::string(images[2].name), std::string("secondary_firmware.txt"));
+    EXPECT_EQ(std::string(images[2].partition), std::string());
+  }
+
+  // more targets than room for them
+  EXPECT_EQ(parse_images(targets_json, 64, images, 2, &num_images), RESULT_ERROR);
+
+  // two targets for one partition
+  targets_json["signed"]["targets"]["script2.bin"] = script;
+  EXPECT_EQ(parse_images(targets_json, 64, images, 3, &num_images), RESULT_ERROR);
+
+  // without images, more than one target for the ECU is still an error
+  targets_json["signed"]["targets"].removeMember("script2.bin");
+  uptane_targets_t targets;
+  uint16_t result;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+}
+
+TEST(tiny_targets, parse_long_name) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value target = targets_json["signed"]["targets"]["secondary_firmware.txt"];
+  targets_json["signed"]["targets"].removeMember("secondary_firmware.txt");
+  const std::string long_name(TARGETS_MAX_NAME_LENGTH + 1, 'f');
+  targets_json["signed"]["targets"][long_name] = target;
+
+  uptane_targets_t targets;
+  uint16_t result;
+  parse_unsigned(targets_json, &targets, &result);
+#if UPTINY_TARGETS_NAME_TRUNCATE
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(std::string(targets.name), long_name.substr(0, TARGETS_MAX_NAME_LENGTH));
+#else
+  EXPECT_EQ(result, RESULT_ERROR);
+#endif
+
+  // only the ecuIdentifiers of a target for other ECUs are looked at
+  target["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+  target["custom"]["ecuIdentifiers"]["uptane_secondary_2"]["hardwareId"] = "test_uptane_secondary";
+  targets_json["signed"]["targets"][long_name] = target;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+}
+
+TEST(tiny_targets, parse_interleaved_contexts) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string good_str = Utils::jsonToCanonicalStr(targets_json);
+  targets_json["signed"]["targets"]["secondary_firmware.txt"]["length"] = 16;
+  std::string forged_str = Utils::jsonToCanonicalStr(targets_json);
+
+  // a context with pools of its own next to the default one, verify contexts with a block of their own included, as
+  // those of crypto_ctx_pool share theirs
+  static jsmntok_t tokens[100];
+  static crypto_key_and_signature_t signatures[2];
+  static uptane_targets_ctx_t ctx;
+  size_t stride = (crypto_verify_ctx_size() + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+  static std::vector<std::max_align_t> verify_storage(2 * stride);
+  static uint8_t verify_block[CRYPTO_VERIFY_BLOCK_LEN];
+  static crypto_verify_ctx_t* verify_ctxs[2];
+  for (unsigned int i = 0; i < 2; ++i) {
+    verify_ctxs[i] = reinterpret_cast<crypto_verify_ctx_t*>(&verify_storage[i * stride]);
+    crypto_verify_set_block(verify_ctxs[i], verify_block);
+  }
+  uptane_targets_ctx_setup(&ctx, tokens, 100, signatures, 2, verify_ctxs, 2, &chunk_hash_context, nullptr);
+  uptane_targets_ctx_init(&ctx);
+  uptane_parse_targets_init();
+
+  uptane_targets_t good_targets;
+  uptane_targets_t forged_targets;
+  uint16_t good_result = RESULT_IN_PROGRESS;
+  uint16_t forged_result = RESULT_IN_PROGRESS;
+  std::string good_buf;
+  std::string forged_buf;
+  for (size_t i = 0; i < std::max(good_str.length(), forged_str.length()); i += 7) {
+    if (good_result == RESULT_IN_PROGRESS) {
+      good_buf += good_str.substr(std::min(i, good_str.length()), 7);
+      int consumed = uptane_targets_ctx_feed(&ctx, good_buf.c_str(), good_buf.length(), &good_targets, &good_result);
+      ASSERT_GE(consumed, 0);
+      good_buf = good_buf.substr(consumed);
+    }
+    if (forged_result == RESULT_IN_PROGRESS) {
+      forged_buf += forged_str.substr(std::min(i, forged_str.length()), 7);
+      int consumed = uptane_parse_targets_feed(forged_buf.c_str(), forged_buf.length(), &forged_targets, &forged_result);
+      if (consumed > 0) {
+        forged_buf = forged_buf.substr(consumed);
+      }
+    }
+  }
+  EXPECT_EQ(good_result, RESULT_END_FOUND);
+  EXPECT_EQ(good_targets.length, 15);
+  EXPECT_EQ(forged_result, RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(forged_targets.length, 16);
+}
+
+TEST(tiny_targets, parse_delta) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value& custom = targets_json["signed"]["targets"]["secondary_firmware.txt"]["custom"];
+  const std::string base256(64, 'a');
+  const std::string base512(128, 'b');
+  custom["delta"]["from"]["sha256"] = base256;
+  custom["delta"]["from"]["sha512"] = base512;
+  custom["delta"]["from"]["md5"] = "ignored";
+  custom["delta"]["length"] = 7;
+
+  // the signatures don't match anymore, but the target is read before they are checked
+  uptane_targets_t targets;
+  uint16_t result;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(targets.length, 15);
+  EXPECT_EQ(targets.delta_length, 7);
+  EXPECT_EQ(targets.delta_base.alg, CRYPTO_HASH_SHA512);  // the supported one
+  EXPECT_EQ(boost::algorithm::to_lower_copy(boost::algorithm::hex(std::string((const char*)targets.delta_base.hash, 64))),
+            base512);
+
+  custom["delta"]["from"].removeMember("sha512");
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(targets.delta_base.alg, CRYPTO_HASH_SHA256);
+
+  custom["delta"].removeMember("length");
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+
+  custom["delta"]["length"] = 7;
+  custom["delta"]["from"]["sha256"] = "not a hash";
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+}
+
+TEST(tiny_targets, out_of_tokens) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value& custom = targets_json["signed"]["targets"]["secondary_firmware.txt"]["custom"];
+  for (int i = 0; i < 2 * token_pool_size; ++i) {
+    custom["padding"].append(i);
+  }
+
+  // the target needs more tokens than there are, which is not the same as bad input
+  uptane_targets_t targets;
+  uint16_t result;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_OUT_OF_TOKENS);
+}
+
+// feeds the message in chunks with the given budget, returns the last result
+static uint16_t feed_with_budget(const std::string& message, unsigned int chunk_size, uint32_t max_bytes,
+                                 uint32_t max_tokens) {
+  uptane_parse_targets_init();
+  uptane_parse_targets_set_budget(max_bytes, max_tokens);
+  uptane_targets_t targets;
+  uint16_t result = RESULT_IN_PROGRESS;
+  std::string buf;
+  for (unsigned int i = 0; i < message.length() && result == RESULT_IN_PROGRESS; i += chunk_size) {
+    buf += message.substr(i, chunk_size);
+    int consumed = uptane_parse_targets_feed(buf.c_str(), buf.length(), &targets, &result);
+    if (consumed > 0) {
+      buf.erase(0, consumed);
+    }
+  }
+  return result;
+}
+
+TEST(tiny_targets, over_budget) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+  uint32_t len = targets_str.length();
+
+  for (unsigned int chunk_size : {7u, 64u, len}) {
+    EXPECT_EQ(feed_with_budget(targets_str, chunk_size, len, 0), RESULT_END_FOUND);
+    state_set_attack(ATTACK_NONE);
+    EXPECT_EQ(feed_with_budget(targets_str, chunk_size, len - 1, 0), RESULT_TOO_LARGE);
+    EXPECT_EQ(state_get_installation_state()->attack, ATTACK_TARGETS_LARGE);
+  }
+
+  // small in bytes for each ECU's target, but every skipped target counts
+  Json::Value other = targets_json["signed"]["targets"]["secondary_firmware.txt"];
+  other["custom"]["ecuIdentifiers"].removeMember("uptane_secondary_1");
+  other["custom"]["ecuIdentifiers"]["uptane_secondary_10"]["hardwareId"] = "test_uptane_secondary";
+  for (int i = 0; i < 40; ++i) {
+    targets_json["signed"]["targets"]["other_firmware_" + std::to_string(i)] = other;
+  }
+  targets_str = Utils::jsonToCanonicalStr(targets_json);
+  for (unsigned int chunk_size : {7u, 64u, (unsigned int)targets_str.length()}) {
+    state_set_attack(ATTACK_NONE);
+    EXPECT_EQ(feed_with_budget(targets_str, chunk_size, 0, 60), RESULT_TOO_LARGE);
+    EXPECT_EQ(state_get_installation_state()->attack, ATTACK_TARGETS_LARGE);
+    EXPECT_EQ(feed_with_budget(targets_str, chunk_size, 0, 200), RESULT_SIGNATURES_FAILED);
+  }
+
+  // the budget is per parse, init restores the default
+  uptane_parse_targets_init();
+  uptane_targets_t targets;
+  uint16_t result;
+  uptane_parse_targets_feed(targets_str.c_str(), targets_str.length(), &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+}
+
+TEST(tiny_targets, out_of_tokens_in_parts) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value& custom = targets_json["signed"]["targets"]["secondary_firmware.txt"]["custom"];
+  for (int i = 0; i < 2 * token_pool_size; ++i) {
+    custom["padding"].append(i);
+  }
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+
+  // reported once the whole target is there, whether it comes in one part with what is before it or in many
+  for (unsigned int chunk_size : {7u, 64u, (unsigned int)targets_str.length()}) {
+    EXPECT_EQ(feed_with_budget(targets_str, chunk_size, 0, 0), RESULT_OUT_OF_TOKENS) << chunk_size;
+  }
+}
+
+TEST(tiny_targets, parse_compression) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value& custom = targets_json["signed"]["targets"]["secondary_firmware.txt"]["custom"];
+  custom["compression"]["method"] = "heatshrink";
+  custom["compression"]["length"] = 11;
+
+  uptane_targets_t targets;
+  uint16_t result;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(targets.length, 15);
+  EXPECT_EQ(targets.compressed_length, 11);
+
+  custom["compression"]["method"] = "lz4";
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+
+  custom["compression"].removeMember("method");
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+}
+
+TEST(tiny_targets, parse_chunks) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  Json::Value& custom = targets_json["signed"]["targets"]["secondary_firmware.txt"]["custom"];
+  custom["chunks"]["size"] = 4;
+  custom["chunks"]["root"]["sha256"] = std::string(64, 'c');
+  custom["chunks"]["root"]["sha1"] = std::string(40, '0');
+
+  uptane_targets_t targets;
+  uint16_t result;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(targets.chunk_size, 4);
+  EXPECT_EQ(targets.chunk_root.alg, CRYPTO_HASH_SHA256);
+  EXPECT_EQ(targets.chunk_root.hash[31], 0xcc);
+
+  custom["chunks"]["size"] = 0;
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+
+  custom["chunks"]["size"] = 4;
+  custom["chunks"].removeMember("root");
+  parse_unsigned(targets_json, &targets, &result);
+  EXPECT_EQ(result, RESULT_ERROR);
+}
+
+#ifdef UPTINY_TARGETS_CACHE
+static uint16_t parse_once(const std::string& targets_str) {
+  uptane_parse_targets_init();
+  uptane_targets_t targets;
+  uint16_t result = 0x0000;
+  uptane_parse_targets_feed(targets_str.c_str(), targets_str.length(), &targets, &result);
+  return result;
+}
+
+TEST(tiny_targets, parse_cached) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+  Json::Value forged_json = targets_json;
+  forged_json["signatures"][0]["sig"] = "7dLjrMXMCbiT3X0DTAMDoznrf/9d3Z1myK3Z1ha0T7IR1a1XslKMd1MvLTvm9r7jS+9ynVpUmUCyzjCNP3PfCg==";
+  std::string forged_str = Utils::jsonToCanonicalStr(forged_json);
+  Json::Value other_json = targets_json;
+  other_json["signed"]["version"] = 3;
+  std::string other_str = Utils::jsonToCanonicalStr(other_json);
+
+  EXPECT_EQ(parse_once(targets_str), RESULT_END_FOUND);
+  EXPECT_EQ(parse_once(forged_str), RESULT_SIGNATURES_FAILED);
+  EXPECT_EQ(uptane_get_signatures_report()->num_valid, 0);
+
+  // re-sent as is: the signatures are not checked, the report still shows the forged one
+  EXPECT_EQ(parse_once(targets_str), RESULT_END_FOUND);
+  EXPECT_EQ(uptane_get_signatures_report()->num_valid, 0);
+  verify_targets(targets_str, true);
+  EXPECT_EQ(uptane_get_signatures_report()->num_valid, 0);
+
+  // the same signatures over a different signed part
+  EXPECT_EQ(parse_once(other_str), RESULT_SIGNATURES_FAILED);
+}
+
+TEST(tiny_targets, signed_digest) {
+  Json::Value targets_json = Utils::parseJSONFile("tests/repo/repo/director/targets.json");
+  std::string targets_str = Utils::jsonToCanonicalStr(targets_json);
+  std::string signed_str = Utils::jsonToCanonicalStr(targets_json["signed"]);
+  Json::Value other_json = targets_json;
+  other_json["signed"]["version"] = 3;
+
+  crypto_hash_t expected;
+  crypto_hash_init(&hash_context, CRYPTO_HASH_SHA512);
+  crypto_hash_feed(&hash_context, (const uint8_t*)signed_str.c_str(), signed_str.length());
+  crypto_hash_result(&hash_context, &expected);
+
+  crypto_hash_t digest;
+  EXPECT_EQ(parse_once(targets_str), RESULT_END_FOUND);
+  ASSERT_TRUE(uptane_parse_targets_signed_digest(&digest));
+  EXPECT_EQ(0, memcmp(digest.hash, expected.hash, CRYPTO_MAX_HASH_LEN));
+
+  // metadata that fails doesn't replace it
+  EXPECT_EQ(parse_once(Utils::jsonToCanonicalStr(other_json)), RESULT_SIGNATURES_FAILED);
+  ASSERT_TRUE(uptane_parse_targets_signed_digest(&digest));
+  EXPECT_EQ(0, memcmp(digest.hash, expected.hash, CRYPTO_MAX_HASH_LEN));
+}
+#endif
+
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -2,29 +2,30 @@
 
 #include <set>
 
+#include "ed25519/sha256.h"
 #include "ed25519/sha512.h"
+#include "pool.h"
+#include "test_crypto.h"
 
 #define TOKEN_POOL_SIZE 100
 
 extern "C" {
 jsmntok_t token_pool[TOKEN_POOL_SIZE];
-const int16_t token_pool_size = TOKEN_POOL_SIZE;
+const jsmnint_t token_pool_size = TOKEN_POOL_SIZE;
 
 #define SIGNATURE_POOL_SIZE 16
 crypto_key_and_signature_t signature_pool[SIGNATURE_POOL_SIZE];
 const unsigned int signature_pool_size = SIGNATURE_POOL_SIZE;
 
-/* TODO: Duplicated from test_crypto.cc, something needs to be done about it */
-struct crypto_verify_ctx {
-  size_t bytes_fed;
-  uint8_t block[SHA512_BLOCK_SIZE];
-  struct sha512_state sha_state;
-  const uint8_t* signature;
-  const uint8_t* pub;
-};
-
 #define CRYPTO_CONTEXT_POOL_SIZE 4
-crypto_verify_ctx_t crypto_ctx_pool_data[CRYPTO_CONTEXT_POOL_SIZE];
+// fed the same message together, the contexts share its partial block
+static uint8_t crypto_ctx_pool_block[CRYPTO_VERIFY_BLOCK_LEN];
+crypto_verify_ctx_t crypto_ctx_pool_data[CRYPTO_CONTEXT_POOL_SIZE] = {
+  {0, crypto_ctx_pool_block},
+  {0, crypto_ctx_pool_block},
+  {0, crypto_ctx_pool_block},
+  {0, crypto_ctx_pool_block},
+};
 crypto_verify_ctx_t* crypto_ctx_pool[] = {
   &crypto_ctx_pool_data[0],
   &crypto_ctx_pool_data[1],
@@ -37,31 +38,54 @@ const unsigned int crypto_ctx_pool_size = CRYPTO_CONTEXT_POOL_SIZE;
 #define KEY_POOL_SIZE 16
 crypto_key_t key_pool[KEY_POOL_SIZE];
 
-std::set<crypto_key_t*> allocated_keys;
+// the generations of common_data_api.h, a shared key is in both
+std::set<crypto_key_t*> stored_keys;
+std::set<crypto_key_t*> candidate_keys;
+
+static void count_keys() {
+  std::set<crypto_key_t*> allocated_keys(stored_keys);
+  allocated_keys.insert(candidate_keys.begin(), candidate_keys.end());
+  UPTANE_POOL_PEAK(keys, allocated_keys.size());
+}
 
 crypto_key_t* alloc_crypto_key(void) {
   crypto_key_t *res = new crypto_key_t;
-  allocated_keys.insert(res);
+  candidate_keys.insert(res);
+  count_keys();
   return res;
 }
 void free_crypto_key(crypto_key_t* key) {
-  allocated_keys.erase(key);
-  delete key;
+  if (candidate_keys.erase(key) != 0 && stored_keys.count(key) == 0) {
+    delete key;
+  }
+}
+void share_crypto_key(crypto_key_t* key) {
+  if (stored_keys.count(key) != 0) {
+    candidate_keys.insert(key);
+  }
 }
 void free_all_crypto_keys() {
-  for(auto key : allocated_keys) {
-    delete key;
+  for(auto key : candidate_keys) {
+    if (stored_keys.count(key) == 0) {
+      delete key;
+    }
   }
 
-  allocated_keys.clear();
+  candidate_keys.clear();
 }
+void commit_crypto_keys() {
+  for(auto key : stored_keys) {
+    if (candidate_keys.count(key) == 0) {
+      delete key;
+    }
+  }
 
-struct crypto_hash_ctx {
-  size_t bytes_fed;
-  uint8_t block[SHA512_BLOCK_SIZE];
-  struct sha512_state sha_state;
-};
+  stored_keys.swap(candidate_keys);
+  candidate_keys.clear();
+}
 
 crypto_hash_ctx_t hash_context;
+crypto_hash_ctx_t chunk_hash_context;
+crypto_sign_ctx_t sign_context;
 
 }
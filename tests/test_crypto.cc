@@ -1,11 +1,15 @@
 #include "crypto_api.h"
+#include <algorithm>
 #include <stdlib.h>
 #include <string.h>
 //typedef int wint_t;
 #include <strings.h>
 #include "debug.h"
+#include "ed25519/ed25519.h"
 #include "ed25519/edsign.h"
+#include "ed25519/sha256.h"
 #include "ed25519/sha512.h"
+#include "test_crypto.h"
 #include "utils.h"
 
 #include "logging/logging.h"
@@ -22,27 +26,16 @@ typedef struct {
   const char* str;
 } hash_match_t;
 
-struct crypto_verify_ctx {
-  size_t bytes_fed;
-  uint8_t block[SHA512_BLOCK_SIZE];
-  struct sha512_state sha_state;
-  const uint8_t* signature;
-  const uint8_t* pub;
-};
-
-struct crypto_hash_ctx {
-  size_t bytes_fed;
-  uint8_t block[SHA512_BLOCK_SIZE];
-  struct sha512_state sha_state;
-};
+/* Steps of signature verification done by every crypto_verify_result_poll */
+#define VERIFY_POLL_STEPS 16
 
 static alg_match_t keytypes[] = {{64, 32, "ed25519"}};
 
-static hash_match_t hashtypes[] = {{64, "sha512"}};
+static hash_match_t hashtypes[] = {{64, "sha512"}, {32, "sha256"}};
 
 crypto_algorithm_t crypto_str_to_keytype(const char* keytype, size_t len) {
   for (unsigned int i = 0; i < sizeof(keytypes) / sizeof(keytypes[0]); i++) {
-    if (!strncasecmp(keytype, keytypes[i].str, len)) {
+    if (strlen(keytypes[i].str) == len && !strncasecmp(keytype, keytypes[i].str, len)) {
       return (crypto_algorithm_t) i;
     }
   }
@@ -52,7 +45,7 @@ crypto_algorithm_t crypto_str_to_keytype(const char* keytype, size_t len) {
 
 crypto_hash_algorithm_t crypto_str_to_hashtype(const char* hashtype, size_t len) {
   for (unsigned int i = 0; i < sizeof(hashtypes) / sizeof(hashtypes[0]); i++) {
-    if (!strncasecmp(hashtype, hashtypes[i].str, len)) {
+    if (strlen(hashtypes[i].str) == len && !strncasecmp(hashtype, hashtypes[i].str, len)) {
       return (crypto_hash_algorithm_t) i;
     }
   }
@@ -60,67 +53,399 @@ crypto_hash_algorithm_t crypto_str_to_hashtype(const char* hashtype, size_t len)
   return CRYPTO_HASH_UNKNOWN;
 }
 
-void crypto_hash_init(crypto_hash_ctx_t* ctx) {
+void crypto_hash_init(crypto_hash_ctx_t* ctx, crypto_hash_algorithm_t alg) {
+  ctx->alg = alg;
   ctx->bytes_fed = 0;
-  sha512_init(&ctx->sha_state);
+  if (alg == CRYPTO_HASH_SHA256) {
+    sha256_init(&ctx->state.sha256);
+  } else {
+    sha512_init(&ctx->state.sha512);
+  }
 }
 
-void crypto_hash_feed(crypto_hash_ctx_t* ctx, const uint8_t* data, size_t len) {
-  unsigned int i;
+static void sha512_block_fn(void* s, const uint8_t* blk) { sha512_block((struct sha512_state*)s, blk); }
+static void sha256_block_fn(void* s, const uint8_t* blk) { sha256_block((struct sha256_state*)s, blk); }
+static void verify_block_fn(void* s, const uint8_t* blk) { edsign_verify_block((struct sha512_state*)s, blk); }
 
-  for (i = 0; i < len; i++) {
-    /* Trust compiler to use masking instead of actual division */
-    int ind = ctx->bytes_fed % SHA512_BLOCK_SIZE;
-    ctx->block[ind] = data[i];
+/* Hash len bytes of data with ind bytes already buffered in block. Full blocks of block_size are hashed straight from
+ * data, only the partial head and tail are copied.
+ */
+static void feed_blocks(void* s, size_t block_size, uint8_t* block, size_t ind, const uint8_t* data, size_t len,
+                        void (*hash_block)(void*, const uint8_t*)) {
+  if (ind > 0) {
+    size_t head = block_size - ind;
 
-    if (ind == SHA512_BLOCK_SIZE - 1) {
-      sha512_block(&ctx->sha_state, ctx->block);
+    if (len < head) {
+      memcpy(block + ind, data, len);
+      return;
     }
-    ++ctx->bytes_fed;
+    memcpy(block + ind, data, head);
+    hash_block(s, block);
+    data += head;
+    len -= head;
+  }
+
+  for (; len >= block_size; data += block_size, len -= block_size) {
+    hash_block(s, data);
+  }
+
+  memcpy(block, data, len);
+}
+
+void crypto_hash_feed(crypto_hash_ctx_t* ctx, const uint8_t* data, size_t len) {
+  /* Block sizes are powers of two, trust compiler to use masking instead of actual division */
+  if (ctx->alg == CRYPTO_HASH_SHA256) {
+    size_t ind = ctx->bytes_fed % SHA256_BLOCK_SIZE;
+
+    ctx->bytes_fed += len;
+    feed_blocks(&ctx->state.sha256, SHA256_BLOCK_SIZE, ctx->block, ind, data, len, sha256_block_fn);
+  } else {
+    size_t ind = ctx->bytes_fed % SHA512_BLOCK_SIZE;
+
+    ctx->bytes_fed += len;
+    feed_blocks(&ctx->state.sha512, SHA512_BLOCK_SIZE, ctx->block, ind, data, len, sha512_block_fn);
   }
 }
 
 void crypto_hash_result(crypto_hash_ctx_t* ctx, crypto_hash_t* hash) {
-  sha512_final(&ctx->sha_state, ctx->block, ctx->bytes_fed);
-  sha512_get(&ctx->sha_state, hash->hash, 0, SHA512_HASH_SIZE);
+  hash->alg = ctx->alg;
+  if (ctx->alg == CRYPTO_HASH_SHA256) {
+    sha256_final(&ctx->state.sha256, ctx->block, ctx->bytes_fed);
+    sha256_get(&ctx->state.sha256, hash->hash, 0, SHA256_HASH_SIZE);
+  } else {
+    sha512_final(&ctx->state.sha512, ctx->block, ctx->bytes_fed);
+    sha512_get(&ctx->state.sha512, hash->hash, 0, SHA512_HASH_SIZE);
+  }
+}
+
+/* The context holds no pointers, so it is saved as it is */
+static_assert(sizeof(struct crypto_hash_ctx) <= CRYPTO_HASH_CHECKPOINT_LEN, "hash context doesn't fit a checkpoint");
+
+void crypto_hash_save(const crypto_hash_ctx_t* ctx, crypto_hash_checkpoint_t* checkpoint) {
+  memcpy(checkpoint->data, ctx, sizeof(*ctx));
 }
 
+void crypto_hash_restore(crypto_hash_ctx_t* ctx, const crypto_hash_checkpoint_t* checkpoint) {
+  memcpy(ctx, checkpoint->data, sizeof(*ctx));
+}
+
+void crypto_key_prepare(crypto_key_t* key) {
+#ifdef CRYPTO_KEY_CACHE
+  key->cached = (key->key_type == CRYPTO_ALG_ED25519) && edsign_unpack_pub(key->cache, key->keyval);
+#else
+  (void)key;
+#endif
+}
+
+void crypto_verify_set_block(crypto_verify_ctx_t* ctx, uint8_t* block) { ctx->block = block; }
+
 void crypto_verify_init(crypto_verify_ctx_t* ctx, crypto_key_and_signature_t* sig) {
   ctx->bytes_fed = 0;
   ctx->signature = sig->sig;
   ctx->pub = sig->key->keyval;
+#ifdef CRYPTO_KEY_CACHE
+  ctx->unpacked = sig->key->cached ? sig->key->cache : NULL;
+#else
+  ctx->unpacked = NULL;
+#endif
 }
 
 void crypto_verify_feed(crypto_verify_ctx_t* ctx, const uint8_t* data, size_t len) {
+  /* The first block holds R and A before the message */
+  if (ctx->bytes_fed < SHA512_BLOCK_SIZE - 64) {
+    size_t head = SHA512_BLOCK_SIZE - 64 - ctx->bytes_fed;
+
+    if (len < head) {
+      memcpy(ctx->block + ctx->bytes_fed, data, len);
+      ctx->bytes_fed += len;
+      return;
+    }
+    memcpy(ctx->block + ctx->bytes_fed, data, head);
+    ctx->bytes_fed += head;
+    data += head;
+    len -= head;
+
+    /* First block is ready */
+    edsign_verify_init(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, SHA512_BLOCK_SIZE - 64);
+  }
+
+  /* Trust compiler to use masking instead of actual division */
+  size_t ind = (ctx->bytes_fed - (SHA512_BLOCK_SIZE - 64)) % SHA512_BLOCK_SIZE;
+
+  ctx->bytes_fed += len;
+  feed_blocks(&ctx->sha_state, SHA512_BLOCK_SIZE, ctx->block, ind, data, len, verify_block_fn);
+}
+
+/* Complete H(R, A, M), whatever amount of data was fed */
+static void verify_hash_complete(crypto_verify_ctx_t* ctx) {
+  if (ctx->bytes_fed < SHA512_BLOCK_SIZE - 64) {
+    edsign_verify_hash_init(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
+  } else {
+    edsign_verify_hash_final(&ctx->sha_state, ctx->block, ctx->bytes_fed);
+  }
+}
+
+bool crypto_verify_result(crypto_verify_ctx_t* ctx) {
+  verify_hash_complete(ctx);
+#ifdef ED25519_REENTRANT
+  struct edsign_verify_ws ws;
+  return edsign_verify_hashed_ws(&ws, &ctx->sha_state, ctx->signature, ctx->pub, ctx->unpacked);
+#else
+  return edsign_verify_hashed(&ctx->sha_state, ctx->signature, ctx->pub, ctx->unpacked);
+#endif
+}
+
+size_t crypto_verify_ctx_size(void) { return sizeof(struct crypto_verify_ctx); }
+
+static_assert(SHA512_BLOCK_SIZE <= CRYPTO_VERIFY_BLOCK_LEN, "a verify block doesn't fit the buffer");
+
+size_t crypto_hash_ctx_size(void) { return sizeof(struct crypto_hash_ctx); }
+
+int crypto_verify_result_batch(crypto_verify_ctx_t* const* ctx, unsigned int num, bool* valid) {
+  struct edsign_batch_item items[ED25519_BATCH_MAX > 0 ? ED25519_BATCH_MAX : 1];
   unsigned int i;
+  int num_valid = 0;
+
+  for (i = 0; i < num; i++) {
+    verify_hash_complete(ctx[i]);
+  }
 
-  for (i = 0; i < len; i++) {
-    if (ctx->bytes_fed < SHA512_BLOCK_SIZE - 64) {
-      ctx->block[ctx->bytes_fed++] = data[i];
+  if (num > 1 && num <= ED25519_BATCH_MAX) {
+    for (i = 0; i < num; i++) {
+      items[i].s = &ctx[i]->sha_state;
+      items[i].signature = ctx[i]->signature;
+      items[i].pub = ctx[i]->pub;
+      items[i].unpacked = ctx[i]->unpacked;
+    }
 
-      /* First block is ready */
-      if (ctx->bytes_fed == SHA512_BLOCK_SIZE - 64) {
-        edsign_verify_init(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, SHA512_BLOCK_SIZE - 64);
+    if (edsign_verify_batch(items, num)) {
+      for (i = 0; valid && i < num; i++) {
+        valid[i] = true;
       }
-    } else {
-      /* Trust compiler to use masking instead of actual division */
-      int ind = (ctx->bytes_fed - (SHA512_BLOCK_SIZE - 64)) % SHA512_BLOCK_SIZE;
-      ctx->block[ind] = data[i];
+      return (int)num;
+    }
+  }
+
+  /* Batch failed, find out which signatures are valid */
+  for (i = 0; i < num; i++) {
+    bool res = edsign_verify_hashed(&ctx[i]->sha_state, ctx[i]->signature, ctx[i]->pub, ctx[i]->unpacked);
+    if (valid) {
+      valid[i] = res;
+    }
+    if (res) {
+      ++num_valid;
+    }
+  }
+  return num_valid;
+}
+
+/* Software backend, hashing completes in *_start and signatures are checked in steps of crypto_verify_result_step */
+crypto_op_status_t crypto_hash_feed_start(crypto_hash_ctx_t* ctx, const uint8_t* data, size_t len) {
+  crypto_hash_feed(ctx, data, len);
+  return CRYPTO_OP_DONE;
+}
+
+crypto_op_status_t crypto_hash_poll(crypto_hash_ctx_t* ctx) {
+  (void)ctx;
+  return CRYPTO_OP_DONE;
+}
+
+crypto_op_status_t crypto_verify_feed_start(crypto_verify_ctx_t* ctx, const uint8_t* data, size_t len) {
+  crypto_verify_feed(ctx, data, len);
+  return CRYPTO_OP_DONE;
+}
+
+/* Copy len bytes of data to offset ind of the partial blocks of num contexts, once to a block they share */
+static void copy_to_blocks(crypto_verify_ctx_t* const* ctx, unsigned int num, size_t ind, const uint8_t* data,
+                           size_t len) {
+  for (unsigned int i = 0; i < num; i++) {
+    if (i == 0 || ctx[i]->block != ctx[i - 1]->block) {
+      memcpy(ctx[i]->block + ind, data, len);
+    }
+  }
+}
 
-      if (ind == SHA512_BLOCK_SIZE - 1) {
-        edsign_verify_block(&ctx->sha_state, ctx->block);
+/* The contexts have been fed the same amount and may share their partial block, so it is filled once for all of them
+ * before any of them hashes it
+ */
+crypto_op_status_t crypto_verify_feed_multi_start(crypto_verify_ctx_t* const* ctx, unsigned int num,
+                                                  const uint8_t* data, size_t len) {
+  if (num == 0) {
+    return CRYPTO_OP_DONE;
+  }
+
+  /* The first block holds R and A before the message */
+  if (ctx[0]->bytes_fed < SHA512_BLOCK_SIZE - 64) {
+    size_t first = std::min(SHA512_BLOCK_SIZE - 64 - ctx[0]->bytes_fed, len);
+
+    copy_to_blocks(ctx, num, ctx[0]->bytes_fed, data, first);
+    for (unsigned int i = 0; i < num; i++) {
+      ctx[i]->bytes_fed += first;
+      if (ctx[i]->bytes_fed == SHA512_BLOCK_SIZE - 64) {
+        edsign_verify_init(&ctx[i]->sha_state, ctx[i]->signature, ctx[i]->pub, ctx[i]->block, SHA512_BLOCK_SIZE - 64);
       }
-      ++ctx->bytes_fed;
     }
+    data += first;
+    len -= first;
+  }
+  if (len == 0) {
+    return CRYPTO_OP_DONE;
+  }
+
+  size_t ind = (ctx[0]->bytes_fed - (SHA512_BLOCK_SIZE - 64)) % SHA512_BLOCK_SIZE;
+  size_t head = (ind > 0) ? SHA512_BLOCK_SIZE - ind : 0;
+
+  for (unsigned int i = 0; i < num; i++) {
+    ctx[i]->bytes_fed += len;
+  }
+  if (len < head) {
+    copy_to_blocks(ctx, num, ind, data, len);
+    return CRYPTO_OP_DONE;
   }
+  if (head > 0) {
+    copy_to_blocks(ctx, num, ind, data, head);
+    for (unsigned int i = 0; i < num; i++) {
+      edsign_verify_block(&ctx[i]->sha_state, ctx[i]->block);
+    }
+    data += head;
+    len -= head;
+  }
+  for (; len >= SHA512_BLOCK_SIZE; data += SHA512_BLOCK_SIZE, len -= SHA512_BLOCK_SIZE) {
+    for (unsigned int i = 0; i < num; i++) {
+      edsign_verify_block(&ctx[i]->sha_state, data);
+    }
+  }
+  copy_to_blocks(ctx, num, 0, data, len);
+  return CRYPTO_OP_DONE;
 }
 
-bool crypto_verify_result(crypto_verify_ctx_t* ctx) {
-  if (ctx->bytes_fed < SHA512_BLOCK_SIZE) {
-    return edsign_verify_init(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
-  } else {
-    return edsign_verify_final(&ctx->sha_state, ctx->signature, ctx->pub, ctx->block, ctx->bytes_fed);
+crypto_op_status_t crypto_verify_poll(crypto_verify_ctx_t* ctx) {
+  (void)ctx;
+  return CRYPTO_OP_DONE;
+}
+
+/* Threshold verification in progress. The batch of the first 'threshold' signatures is tried first, as signatures
+ * are usually all valid, then the signatures are checked one by one until the outcome is known.
+ */
+typedef enum { THRESHOLD_DONE, THRESHOLD_BATCH, THRESHOLD_NEXT, THRESHOLD_SINGLE } threshold_phase_t;
+
+static struct {
+  crypto_verify_ctx_t* const* ctx;
+  unsigned int num;
+  int threshold;
+  unsigned int hashed;
+  unsigned int next;
+  unsigned int num_checked;
+  int num_valid;
+  threshold_phase_t phase;
+} job;
+
+static struct edsign_batch_item job_items[ED25519_BATCH_MAX > 0 ? ED25519_BATCH_MAX : 1];
+
+crypto_op_status_t crypto_verify_result_start(crypto_verify_ctx_t* const* ctx, unsigned int num, int threshold) {
+  unsigned int need = (threshold > 0) ? (unsigned int)threshold : 0;
+
+  job.ctx = ctx;
+  job.num = num;
+  job.threshold = threshold;
+  job.hashed = 0;
+  job.next = 0;
+  job.num_checked = 0;
+  job.num_valid = 0;
+  job.phase = THRESHOLD_NEXT;
+
+  if (need == 0 || need > num) {
+    job.phase = THRESHOLD_DONE;
+  } else if (need > 1 && need <= ED25519_BATCH_MAX) {
+    for (; job.hashed < need; job.hashed++) {
+      crypto_verify_ctx_t* c = ctx[job.hashed];
+
+      verify_hash_complete(c);
+      job_items[job.hashed].s = &c->sha_state;
+      job_items[job.hashed].signature = c->signature;
+      job_items[job.hashed].pub = c->pub;
+      job_items[job.hashed].unpacked = c->unpacked;
+    }
+
+    job.num_checked = need;
+    if (edsign_verify_batch_start(job_items, need)) {
+      job.phase = THRESHOLD_BATCH;
+    }
+  }
+  return (job.phase == THRESHOLD_DONE) ? CRYPTO_OP_DONE : CRYPTO_OP_IN_PROGRESS;
+}
+
+crypto_op_status_t crypto_verify_result_step(unsigned int budget) {
+  for (; budget > 0 && job.phase != THRESHOLD_DONE; budget--) {
+    int res;
+
+    switch (job.phase) {
+      case THRESHOLD_BATCH:
+        res = edsign_verify_step();
+        if (res != EDSIGN_STEP_PENDING) {
+          if (res) {
+            job.num_valid = job.threshold;
+            job.phase = THRESHOLD_DONE;
+          } else {
+            job.phase = THRESHOLD_NEXT;
+          }
+        }
+        break;
+
+      case THRESHOLD_NEXT:
+        if (job.next < job.num && job.num_valid < job.threshold &&
+            job.num_valid + (int)(job.num - job.next) >= job.threshold) {
+          crypto_verify_ctx_t* c = job.ctx[job.next];
+
+          if (job.next >= job.hashed) {
+            verify_hash_complete(c);
+            ++job.hashed;
+          }
+          edsign_verify_start(&c->sha_state, c->signature, c->pub, c->unpacked);
+          job.phase = THRESHOLD_SINGLE;
+        } else {
+          if (job.next > job.num_checked) {
+            job.num_checked = job.next;
+          }
+          job.phase = THRESHOLD_DONE;
+        }
+        break;
+
+      case THRESHOLD_SINGLE:
+        res = edsign_verify_step();
+        if (res != EDSIGN_STEP_PENDING) {
+          if (res) {
+            ++job.num_valid;
+          }
+          ++job.next;
+          job.phase = THRESHOLD_NEXT;
+        }
+        break;
+
+      default:
+        break;
+    }
+  }
+  return (job.phase == THRESHOLD_DONE) ? CRYPTO_OP_DONE : CRYPTO_OP_IN_PROGRESS;
+}
+
+crypto_op_status_t crypto_verify_result_poll(int* num_valid, unsigned int* num_checked) {
+  if (crypto_verify_result_step(VERIFY_POLL_STEPS) != CRYPTO_OP_DONE) {
+    return CRYPTO_OP_IN_PROGRESS;
   }
+  *num_valid = job.num_valid;
+  *num_checked = job.num_checked;
+  return CRYPTO_OP_DONE;
+}
+
+int crypto_verify_result_threshold(crypto_verify_ctx_t* const* ctx, unsigned int num, int threshold,
+                                   unsigned int* num_checked) {
+  int num_valid;
+
+  crypto_verify_result_start(ctx, num, threshold);
+  while (crypto_verify_result_poll(&num_valid, num_checked) != CRYPTO_OP_DONE) {
+  }
+  return num_valid;
 }
 
 size_t crypto_get_hashlen(crypto_hash_algorithm_t alg) { return hashtypes[alg].hash_len; }
@@ -134,4 +459,36 @@ void crypto_sign_data(const char* data, size_t len, crypto_key_and_signature_t*
   edsign_sign(out_sig->sig, out_sig->key->keyval, private_key, (const uint8_t*) data, len);
 }
 
+void crypto_sign_init(crypto_sign_ctx_t* ctx, crypto_key_and_signature_t* out_sig, const uint8_t* private_key) {
+  ctx->sig = out_sig;
+  ctx->priv = private_key;
+  ctx->pass = 0;
+  sha512_init(&ctx->sha_state);
+  edsign_sign_nonce_prefix(ctx->block, private_key);
+  ctx->bytes_fed = EDSIGN_NONCE_PREFIX_SIZE;
+}
+
+void crypto_sign_feed(crypto_sign_ctx_t* ctx, const uint8_t* data, size_t len) {
+  size_t ind = ctx->bytes_fed % SHA512_BLOCK_SIZE;
+
+  ctx->bytes_fed += len;
+  feed_blocks(&ctx->sha_state, SHA512_BLOCK_SIZE, ctx->block, ind, data, len, sha512_block_fn);
+}
+
+/* The first pass gives the nonce and R, the second one H(R, A, M) */
+bool crypto_sign_result(crypto_sign_ctx_t* ctx) {
+  sha512_final(&ctx->sha_state, ctx->block, ctx->bytes_fed);
+  if (ctx->pass == 0) {
+    edsign_sign_nonce(ctx->sig->sig, ctx->k, &ctx->sha_state);
+    ctx->pass = 1;
+    sha512_init(&ctx->sha_state);
+    edsign_sign_hash_prefix(ctx->block, ctx->sig->sig, ctx->sig->key->keyval);
+    ctx->bytes_fed = EDSIGN_HASH_PREFIX_SIZE;
+    return false;
+  }
+  edsign_sign_finish(ctx->sig->sig, ctx->priv, ctx->k, &ctx->sha_state);
+  memset(ctx->k, 0, sizeof(ctx->k));
+  return true;
+}
+
 }
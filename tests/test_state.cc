@@ -1,4 +1,5 @@
 #include "state_api.h"
+#include "common_data_api.h"
 #include "crypto/crypto.h"
 #include <iostream>
 #include "utilities/utils.h"
@@ -14,6 +15,7 @@ class TestKeyReader {
     std::string keyval_bin = boost::algorithm::unhex(public_key.Value());
     std::copy(keyid_bin.cbegin(), keyid_bin.cend(), res.keyid);
     std::copy(keyval_bin.cbegin(), keyval_bin.cend(), res.keyval);
+    crypto_key_prepare(&res);
     return res;
   }
 
@@ -33,6 +35,8 @@ uptane_targets_t out_stored_targets;
 
 std::unique_ptr<uptane_installation_state_t> stored_installation_state;
 
+std::unique_ptr<uptane_transfer_checkpoint_t> stored_checkpoint;
+
 extern "C" {
   uptane_root_t* state_get_root(void) {
     if( !stored_root ) {
@@ -63,6 +67,7 @@ extern "C" {
     for(int i = 0; i < root->targets_keys_num; ++i) { 
       stored_root->targets_keys[i] = root->targets_keys[i];
     }
+    commit_crypto_keys();
   }
 
   uptane_targets_t* state_get_targets(void) {
@@ -73,12 +78,19 @@ extern "C" {
       stored_targets->name[0] = '\0';
       stored_targets->hashes_num = 0;
       stored_targets->length = 0;
+      stored_targets->delta_length = 0;
+      stored_targets->compressed_length = 0;
+      stored_targets->chunk_size = 0;
+      stored_targets->partition[0] = '\0';
     }
     memcpy(&out_stored_targets, stored_targets.get(), sizeof(uptane_targets_t));
     return &out_stored_targets;
   }
 
   void state_set_targets(const uptane_targets_t* targets) {
+    if (!stored_targets) {
+      state_get_targets();
+    }
     stored_targets->version = targets->version;
     stored_targets->expires = targets->expires;
     strncpy(stored_targets->name, targets->name, TARGETS_MAX_NAME_LENGTH);
@@ -89,19 +101,37 @@ extern "C" {
     }
 
     stored_targets->length = targets->length;
+    stored_targets->delta_length = targets->delta_length;
+    stored_targets->delta_base = targets->delta_base;
+    stored_targets->compressed_length = targets->compressed_length;
+    stored_targets->chunk_size = targets->chunk_size;
+    stored_targets->chunk_root = targets->chunk_root;
+    memcpy(stored_targets->partition, targets->partition, sizeof(targets->partition));
   }
 
 
+  static const char ecuid[] = "uptane_secondary_1";
+  static const char hwid[] = "test_uptane_secondary";
+
   const char* state_get_ecuid(void) {
-    return "uptane_secondary_1";
+    return ecuid;
+  }
+
+  size_t state_get_ecuid_len(void) {
+    return sizeof(ecuid) - 1;
   }
 
   const char* state_get_hwid(void) {
-    return "test_uptane_secondary";
+    return hwid;
+  }
+
+  size_t state_get_hwid_len(void) {
+    return sizeof(hwid) - 1;
   }
 
+  crypto_hash_algorithm_t test_supported_hash = CRYPTO_HASH_SHA512;
   crypto_hash_algorithm_t state_get_supported_hash(void) {
-    return CRYPTO_HASH_SHA512;
+    return test_supported_hash;
   }
 
   uptane_installation_state_t* state_get_installation_state(void) {
@@ -114,9 +144,29 @@ extern "C" {
     memcpy(stored_installation_state->firmware_name, state->firmware_name, sizeof(state->firmware_name));
     stored_installation_state->firmware_hash = state->firmware_hash;
     stored_installation_state->firmware_length = state->firmware_length;
+    stored_installation_state->image_crc = state->image_crc;
     stored_installation_state->attack = state->attack;
   }
 
+  void state_set_attack(uptane_attack_t attack) {
+    if (!stored_installation_state) {
+      stored_installation_state = std_::make_unique<uptane_installation_state_t>();
+    }
+    stored_installation_state->attack = attack;
+  }
+
+  const uptane_transfer_checkpoint_t* state_get_transfer_checkpoint(void) {
+    return stored_checkpoint.get();
+  }
+
+  void state_set_transfer_checkpoint(const uptane_transfer_checkpoint_t* checkpoint) {
+    if (checkpoint == nullptr) {
+      stored_checkpoint.reset();
+    } else {
+      stored_checkpoint = std_::make_unique<uptane_transfer_checkpoint_t>(*checkpoint);
+    }
+  }
+
   void state_get_device_key(const crypto_key_t** pub, const uint8_t** priv) {
     static std::string private_key = boost::algorithm::unhex(Utils::readFile("tests/repo/keys/director/private.key"));
     *priv = reinterpret_cast<const uint8_t*>(private_key.c_str());
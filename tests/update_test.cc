@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 
+#include "ed25519/edsign.h"
 #include "libuptiny/targets.h"
 #include "libuptiny/firmware.h"
 #include "libuptiny/manifest.h"
 #include "libuptiny/state_api.h"
+#include "libuptiny/stats.h"
 #include "logging/logging.h"
 #include "utilities/utils.h"
 #include "crypto/crypto.h"
@@ -15,7 +17,7 @@ TEST(update, full) {
   uint16_t result = 0x0000;
   uptane_targets_t targets;
 
-  uptane_parse_targets_feed(targets_str.c_str(), (int16_t) targets_str.length(), &targets, &result);
+  uptane_parse_targets_feed(targets_str.c_str(), (jsmnint_t) targets_str.length(), &targets, &result);
   ASSERT_EQ(result, RESULT_END_FOUND);
   state_set_targets(&targets);
 
@@ -45,6 +47,82 @@ TEST(update, full) {
   EXPECT_EQ(manifest_json["signed"]["installed_image"]["fileinfo"]["length"].asInt(), 15);
   EXPECT_EQ(manifest_json["signed"]["installed_image"]["fileinfo"]["hashes"]["sha512"].asString(), "7dbae4c36a2494b731a9239911d3085d53d3e400886edb4ae2b9b78f40bda446649e83ba2d81653f614cc66f5dd5d4dbd95afba854f148afbfae48d0ff4cc38a");
 }
+
+TEST(update, manifest_cache) {
+  size_t len;
+  const char* manifest = uptane_manifest(&len);
+  ASSERT_NE(manifest, nullptr);
+  EXPECT_EQ(strlen(manifest), len);
+  std::string first(manifest, len);
+
+  Json::Value manifest_json = Utils::parseJSON(first);
+  ASSERT_TRUE(manifest_json.isMember("signatures"));
+  ASSERT_TRUE(manifest_json.isMember("signed"));
+
+  char signatures_buf[1000];
+  char signed_buf[1000];
+  uptane_write_manifest(signed_buf, signatures_buf);
+  EXPECT_EQ(first, std::string("{\"signatures\":") + signatures_buf + ",\"signed\":" + signed_buf + "}");
+
+  manifest = uptane_manifest(&len);
+  EXPECT_EQ(std::string(manifest, len), first);
+}
+
+#ifdef UPTANE_STATS
+TEST(update, manifest_cache_stats) {
+  size_t len;
+  const char* manifest = uptane_manifest(&len);
+  ASSERT_NE(manifest, nullptr);
+  std::string first(manifest, len);
+
+  // The cached manifest has to follow the counters in its diagnostics
+  UPTANE_STATS_COUNT(tokens, 1);
+  manifest = uptane_manifest(&len);
+  ASSERT_NE(manifest, nullptr);
+  EXPECT_NE(std::string(manifest, len), first);
+  Json::Value manifest_json = Utils::parseJSON(std::string(manifest, len));
+  EXPECT_EQ(manifest_json["signed"]["diagnostics"]["tokens"].asUInt(), uptane_stats_get()->tokens);
+}
+#endif
+
+TEST(update, manifest_writer) {
+  size_t len;
+  const char* manifest = uptane_manifest(&len);
+  ASSERT_NE(manifest, nullptr);
+
+  // Frame sized pieces and odd ones that split fields
+  for (size_t piece : {1, 6, 7, 13, 64}) {
+    uptane_manifest_writer_t writer;
+    ASSERT_EQ(uptane_manifest_writer_init(&writer), len);
+
+    std::string written;
+    char buf[64];
+    size_t n;
+    while ((n = uptane_manifest_writer_read(&writer, buf, piece)) > 0) {
+      written.append(buf, n);
+    }
+    EXPECT_EQ(written, std::string(manifest, len)) << "piece of " << piece;
+
+    // The signature made while the signed part was fed in pieces matches a one-shot one over the same bytes
+    const std::string signed_tag = ",\"signed\":";
+    size_t signed_begin = written.find(signed_tag);
+    ASSERT_NE(signed_begin, std::string::npos);
+    signed_begin += signed_tag.length();
+    std::string signed_part = written.substr(signed_begin, written.length() - 1 - signed_begin);
+
+    const crypto_key_t* public_key;
+    const uint8_t* private_key;
+    state_get_device_key(&public_key, &private_key);
+    uint8_t expected_sig[EDSIGN_SIGNATURE_SIZE];
+    edsign_sign(expected_sig, public_key->keyval, private_key, reinterpret_cast<const uint8_t*>(signed_part.data()),
+                signed_part.length());
+
+    Json::Value written_json = Utils::parseJSON(written);
+    EXPECT_EQ(Utils::fromBase64(written_json["signatures"][0]["sig"].asString()),
+              std::string(reinterpret_cast<const char*>(expected_sig), sizeof(expected_sig)))
+        << "piece of " << piece;
+  }
+}
 #ifndef __NO_MAIN__
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
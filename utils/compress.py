@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""Compress an image for libuptiny/decompress.c.
+
+The output is the heatshrink format with an 8 bit window and a 4 bit
+lookahead, the one of `heatshrink -e -w 8 -l 4`. See libuptiny/decompress.h.
+The "compression" object for the target's custom metadata is printed to
+stdout, the target's hashes and length stay the ones of the uncompressed
+image (or delta, see makedelta.py).
+
+Usage: compress.py IN OUT
+"""
+
+import argparse
+import json
+
+WINDOW_BITS = 8
+LOOKAHEAD_BITS = 4
+WINDOW = 1 << WINDOW_BITS
+LOOKAHEAD = 1 << LOOKAHEAD_BITS
+MIN_MATCH = 2  # a back reference costs 13 bits, a literal 9
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.bits = 0
+
+    def put(self, value, bits):
+        self.acc = (self.acc << bits) | value
+        self.bits += bits
+        while self.bits >= 8:
+            self.bits -= 8
+            self.out.append((self.acc >> self.bits) & 0xFF)
+        self.acc &= (1 << self.bits) - 1
+
+    def finish(self):
+        if self.bits:
+            self.out.append((self.acc << (8 - self.bits)) & 0xFF)
+        return bytes(self.out)
+
+
+def compress(data):
+    positions = {}  # last positions of each byte pair
+    writer = BitWriter()
+    pos = 0
+    while pos < len(data):
+        best_off, best_len = 0, 0
+        for cand in reversed(positions.get(data[pos:pos + 2], ())):
+            if pos - cand > WINDOW:
+                break
+            length = 0
+            limit = min(LOOKAHEAD, len(data) - pos)
+            while length < limit and data[cand + length] == data[pos + length]:
+                length += 1
+            if length > best_len:
+                best_off, best_len = pos - cand, length
+                if length == limit:
+                    break
+
+        if best_len >= MIN_MATCH:
+            writer.put(0, 1)
+            writer.put(best_off - 1, WINDOW_BITS)
+            writer.put(best_len - 1, LOOKAHEAD_BITS)
+            step = best_len
+        else:
+            writer.put(1, 1)
+            writer.put(data[pos], 8)
+            step = 1
+
+        for p in range(pos, pos + step):
+            positions.setdefault(data[p:p + 2], []).append(p)
+        pos += step
+    return writer.finish()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('input')
+    parser.add_argument('output')
+    args = parser.parse_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    compressed = compress(data)
+    with open(args.output, 'wb') as f:
+        f.write(compressed)
+
+    print(json.dumps({'compression': {'method': 'heatshrink', 'length': len(compressed)}}, indent=2))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+"""Split the data of a target into chunks for libuptiny/chunks.c.
+
+DATA is the data as it is sent: the image, or the delta or compressed data
+if the target has them. The hash tree over the chunks is the one of RFC 6962,
+see libuptiny/chunks.h. For every chunk OUTDIR/NNNN.bin gets what is sent for
+it, its audit path followed by the chunk. The "chunks" object for the target's
+custom metadata is printed to stdout.
+
+Usage: makechunks.py [--size N] [--alg sha256|sha512] DATA OUTDIR
+"""
+
+import argparse
+import hashlib
+import json
+import os
+
+
+def largest_split(n):
+    k = 1
+    while k * 2 < n:
+        k *= 2
+    return k
+
+
+def tree_hash(h, chunks):
+    if len(chunks) == 1:
+        return h(b'\x00' + chunks[0]).digest()
+    k = largest_split(len(chunks))
+    return h(b'\x01' + tree_hash(h, chunks[:k]) + tree_hash(h, chunks[k:])).digest()
+
+
+def audit_path(h, chunks, index):
+    if len(chunks) == 1:
+        return b''
+    k = largest_split(len(chunks))
+    if index < k:
+        return audit_path(h, chunks[:k], index) + tree_hash(h, chunks[k:])
+    return audit_path(h, chunks[k:], index - k) + tree_hash(h, chunks[:k])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--size', type=int, default=512, help='chunk size in bytes')
+    parser.add_argument('--alg', choices=('sha256', 'sha512'), default='sha256')
+    parser.add_argument('data')
+    parser.add_argument('outdir')
+    args = parser.parse_args()
+
+    with open(args.data, 'rb') as f:
+        data = f.read()
+    if not data or args.size <= 0:
+        parser.error('nothing to split')
+
+    h = getattr(hashlib, args.alg)
+    chunks = [data[i:i + args.size] for i in range(0, len(data), args.size)]
+    os.makedirs(args.outdir, exist_ok=True)
+    for index, chunk in enumerate(chunks):
+        with open(os.path.join(args.outdir, '%04d.bin' % index), 'wb') as f:
+            f.write(audit_path(h, chunks, index) + chunk)
+
+    print(json.dumps({'chunks': {'size': args.size, 'root': {args.alg: tree_hash(h, chunks).hex()}}}, indent=2))
+
+
+if __name__ == '__main__':
+    main()
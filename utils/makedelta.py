@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""Create a delta for libuptiny/delta.c that rebuilds NEW from BASE.
+
+The delta is a sequence of copies from the base and inserted bytes, see
+libuptiny/delta.h for the format. By default the delta can be applied in
+place, i.e. while the new image overwrites the base: copies never read the
+base before the offset they write to. The "delta" object for the target's
+custom metadata is printed to stdout.
+
+Usage: makedelta.py [--not-in-place] BASE NEW DELTA
+"""
+
+import argparse
+import hashlib
+import json
+
+MAX_OP_LEN = 0x7FFF
+BLOCK = 8  # a copy costs 5 bytes, shorter matches are inserted
+COPY_HEAD = 5
+INSERT_HEAD = 2
+
+
+def index_blocks(base):
+    index = {}
+    for off in range(len(base) - BLOCK + 1):
+        index.setdefault(base[off:off + BLOCK], []).append(off)
+    return index
+
+
+def longest_match(base, new, pos, candidates, in_place):
+    best_off, best_len = 0, 0
+    for off in candidates:
+        if in_place and off < pos:
+            continue
+        length = 0
+        limit = min(len(base) - off, len(new) - pos, MAX_OP_LEN)
+        while length < limit and base[off + length] == new[pos + length]:
+            length += 1
+        if length > best_len:
+            best_off, best_len = off, length
+    return best_off, best_len
+
+
+def make_delta(base, new, in_place):
+    index = index_blocks(base)
+    out = bytearray()
+    insert = bytearray()
+
+    def flush_insert():
+        for i in range(0, len(insert), MAX_OP_LEN):
+            part = insert[i:i + MAX_OP_LEN]
+            out.extend(len(part).to_bytes(INSERT_HEAD, 'big'))
+            out.extend(part)
+        insert.clear()
+
+    pos = 0
+    while pos < len(new):
+        off, length = longest_match(base, new, pos, index.get(bytes(new[pos:pos + BLOCK]), ()), in_place)
+        if length >= BLOCK:
+            flush_insert()
+            out.extend((0x8000 | length).to_bytes(2, 'big'))
+            out.extend(off.to_bytes(COPY_HEAD - 2, 'big'))
+            pos += length
+        else:
+            insert.append(new[pos])
+            pos += 1
+    flush_insert()
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('--not-in-place', action='store_true', help='the base stays untouched while the image is rebuilt')
+    parser.add_argument('base')
+    parser.add_argument('new')
+    parser.add_argument('delta')
+    args = parser.parse_args()
+
+    with open(args.base, 'rb') as f:
+        base = f.read()
+    with open(args.new, 'rb') as f:
+        new = f.read()
+    if len(base) >= 1 << 24:
+        parser.error('bases are limited to 16 MB')
+
+    delta = make_delta(base, new, not args.not_in_place)
+    with open(args.delta, 'wb') as f:
+        f.write(delta)
+
+    print(json.dumps({'delta': {'from': {'sha256': hashlib.sha256(base).hexdigest(),
+                                         'sha512': hashlib.sha512(base).hexdigest()},
+                                'length': len(delta)}}, indent=2))
+
+
+if __name__ == '__main__':
+    main()